@@ -0,0 +1,774 @@
+/**
+ * @file gateway.c
+ * @brief Neural Load Ring Host Ingest Gateway - Many Rings, One Hub
+ *
+ * Daemon for bedside / clinic hubs: accepts the Wellness Service streams of
+ * many rings over the nlr_wire.h transport (UDP, the BLE stand-in used by
+ * nlr_sim and nlr_loadgen) or the same framing over TCP (a bridge from a
+ * real BLE central), re-runs the on-ring biometrics per device and writes
+ * aggregated metrics to disk.
+ *
+ * Sharding: one thread per shard, pinned to a core, each with its own epoll
+ * set, its own SO_REUSEPORT UDP socket and TCP listener on the same port, and
+ * its own device table. The kernel hashes a ring's address to one shard, so
+ * a device is only ever touched by one thread and nothing is locked.
+ *
+ * Zero-copy: datagrams land in the shard's recvmmsg buffers (TCP bytes in
+ * the connection's buffer) and frames are decoded in place; RR values are
+ * read as little-endian u16 straight from the payload and the coherence and
+ * device-state packets are read through their packed ble_stack.h types.
+ *
+ * Handshake: an ADVERTISE from an unknown ring is answered with CONNECT
+ * (MTU 247) and SUBSCRIBE; a ring already streaming (--auto-connect) is
+ * adopted. Rings silent for the supervision timeout are dropped.
+ *
+ * Output: every --interval seconds each shard appends one CSV row per device
+ * with a single O_APPEND write:
+ *
+ *   t_s,shard,device,transport,rr_total,rr_window,mean_rr_ms,rmssd_ms,
+ *   sdnn_ms,stress,quality_pct,dfa_alpha1,ring_stress,ring_coherence,
+ *   ring_rmssd_ms,battery_pct,skin_c
+ *
+ * Usage: nlr_gateway [options]
+ *   --port N          UDP and TCP port (default 47100)
+ *   --shards N        Shard threads (default: online CPUs)
+ *   --out FILE        Aggregate CSV (default nlr_gateway.csv)
+ *   --interval S      Aggregate period (default 10)
+ *   --duration S      Exit after S seconds (default 0 = until SIGINT/SIGTERM)
+ *   --max-devices N   Device table size per shard (default 4096)
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#define _GNU_SOURCE
+
+#include "nlr_wire.h"
+#include "core/biometric_algorithms.h"
+#include "core/hrv_nonlinear.h"
+#include "bluetooth/ble_stack.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+
+/*******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
+
+#define GW_RX_BATCH             64U     /**< Datagrams per recvmmsg() */
+#define GW_EPOLL_EVENTS         64
+#define GW_TICK_MS              1000U   /**< Housekeeping period */
+#define GW_DFA_STEPS_PER_TICK   16U     /**< Covers one full DFA pass */
+#define GW_LINK_MTU             247U
+#define GW_TCP_BUF              (2U * NLR_WIRE_MAX_FRAME)
+#define GW_ROW_MAX              256U
+
+static struct {
+    uint16_t port;
+    uint32_t shards;
+    const char *out_file;
+    uint32_t interval_s;
+    uint32_t duration_s;
+    uint32_t max_devices;
+} m_cfg = {
+    .port = NLR_WIRE_PORT_DEFAULT,
+    .out_file = "nlr_gateway.csv",
+    .interval_s = 10,
+    .max_devices = 4096,
+};
+
+/*******************************************************************************
+ * TYPES
+ ******************************************************************************/
+
+typedef enum {
+    GW_EV_UDP,
+    GW_EV_LISTEN,
+    GW_EV_TIMER,
+    GW_EV_STOP,
+    GW_EV_TCP,      /**< Index of the device in the low 32 bits */
+} gw_ev_t;
+
+typedef struct {
+    uint64_t key;                   /**< 0 = free slot */
+    bool tcp;
+    int fd;                         /**< TCP connection, -1 for UDP */
+    struct sockaddr_in peer;
+    uint8_t dev_addr[6];
+    bool have_dev_addr;
+    bool streaming;
+    uint32_t last_seen_ms;
+
+    /* On-ring-equivalent biometrics */
+    hr_metrics_t metrics;
+    hrv_nonlinear_t nonlinear;
+    uint32_t rr_total;
+    uint32_t rr_window;
+
+    /* Latest packets as the ring reported them */
+    nlr_coherence_packet_t ring_coherence;
+    nlr_device_state_t ring_state;
+    bool have_coherence;
+    bool have_state;
+
+    /* TCP reassembly */
+    uint8_t rx[GW_TCP_BUF];
+    uint16_t rx_len;
+} gw_device_t;
+
+typedef struct {
+    uint64_t frames;
+    uint64_t rr;
+    uint64_t bad_frames;
+    uint64_t connects;
+    uint64_t timeouts;
+    uint64_t table_full;
+} gw_stats_t;
+
+typedef struct {
+    uint32_t index;
+    pthread_t thread;
+    int epfd;
+    int udp_fd;
+    int listen_fd;
+    int timer_fd;
+    int stop_fd;
+
+    /* Device table: open addressing on key, values are pool indices */
+    uint64_t *p_keys;
+    uint32_t *p_slots;
+    uint32_t table_mask;
+    gw_device_t *p_pool;
+    uint32_t *p_free;
+    uint32_t n_free;
+    uint32_t n_devices;
+
+    uint32_t ticks;
+    gw_stats_t stats;
+
+    /* recvmmsg buffers */
+    uint8_t rx[GW_RX_BATCH][NLR_WIRE_MAX_FRAME];
+    struct mmsghdr msgs[GW_RX_BATCH];
+    struct iovec iov[GW_RX_BATCH];
+    struct sockaddr_in from[GW_RX_BATCH];
+} gw_shard_t;
+
+static struct timespec m_start;
+static int m_out_fd = -1;
+
+/*******************************************************************************
+ * HELPERS
+ ******************************************************************************/
+
+static uint32_t gw_now_ms(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint32_t)((t.tv_sec - m_start.tv_sec) * 1000 +
+                      (t.tv_nsec - m_start.tv_nsec) / 1000000);
+}
+
+static inline uint64_t gw_ev(gw_ev_t type, uint32_t index)
+{
+    return ((uint64_t)type << 32) | index;
+}
+
+static inline uint64_t gw_key_udp(const struct sockaddr_in *p_addr)
+{
+    return (1ULL << 48) | ((uint64_t)ntohl(p_addr->sin_addr.s_addr) << 16) | ntohs(p_addr->sin_port);
+}
+
+static inline uint64_t gw_key_tcp(int fd)
+{
+    return (2ULL << 48) | (uint32_t)fd;
+}
+
+static inline uint32_t gw_hash(uint64_t key)
+{
+    key ^= key >> 33;
+    key *= 0xFF51AFD7ED558CCDULL;
+    key ^= key >> 33;
+    return (uint32_t)key;
+}
+
+static inline uint16_t gw_le16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+/*******************************************************************************
+ * DEVICE TABLE
+ ******************************************************************************/
+
+static gw_device_t *gw_device_find(gw_shard_t *p_shard, uint64_t key)
+{
+    for (uint32_t i = gw_hash(key) & p_shard->table_mask;; i = (i + 1U) & p_shard->table_mask) {
+        if (p_shard->p_keys[i] == 0U) return NULL;
+        if (p_shard->p_keys[i] == key) return &p_shard->p_pool[p_shard->p_slots[i]];
+    }
+}
+
+static gw_device_t *gw_device_add(gw_shard_t *p_shard, uint64_t key)
+{
+    if (p_shard->n_free == 0U) {
+        p_shard->stats.table_full++;
+        return NULL;
+    }
+
+    uint32_t idx = p_shard->p_free[--p_shard->n_free];
+    uint32_t i = gw_hash(key) & p_shard->table_mask;
+    while (p_shard->p_keys[i] != 0U) {
+        i = (i + 1U) & p_shard->table_mask;
+    }
+    p_shard->p_keys[i] = key;
+    p_shard->p_slots[i] = idx;
+    p_shard->n_devices++;
+
+    gw_device_t *p_dev = &p_shard->p_pool[idx];
+    memset(p_dev, 0, offsetof(gw_device_t, rx));
+    p_dev->key = key;
+    p_dev->fd = -1;
+    p_dev->rx_len = 0;
+    biometrics_reset(&p_dev->metrics);
+    hrv_nonlinear_reset(&p_dev->nonlinear);
+    return p_dev;
+}
+
+/** Linear probing removal with backward shift (no tombstones) */
+static void gw_device_remove(gw_shard_t *p_shard, gw_device_t *p_dev)
+{
+    uint32_t mask = p_shard->table_mask;
+    uint32_t i = gw_hash(p_dev->key) & mask;
+
+    while (p_shard->p_keys[i] != p_dev->key) {
+        i = (i + 1U) & mask;
+    }
+    for (uint32_t j = (i + 1U) & mask; p_shard->p_keys[j] != 0U; j = (j + 1U) & mask) {
+        uint32_t home = gw_hash(p_shard->p_keys[j]) & mask;
+        /* Move j into the hole unless its home lies cyclically in (i, j] */
+        if (((j - home) & mask) >= ((j - i) & mask)) {
+            p_shard->p_keys[i] = p_shard->p_keys[j];
+            p_shard->p_slots[i] = p_shard->p_slots[j];
+            i = j;
+        }
+    }
+    p_shard->p_keys[i] = 0U;
+
+    if (p_dev->fd >= 0) {
+        close(p_dev->fd);   /* Also leaves the epoll set */
+    }
+    p_dev->key = 0U;
+    p_shard->p_free[p_shard->n_free++] = (uint32_t)(p_dev - p_shard->p_pool);
+    p_shard->n_devices--;
+}
+
+/*******************************************************************************
+ * FRAME HANDLING
+ ******************************************************************************/
+
+static void gw_send(gw_shard_t *p_shard, gw_device_t *p_dev, uint8_t type, const void *p_payload, uint16_t len)
+{
+    uint8_t frame[NLR_WIRE_HDR_BYTES + 4U];
+    uint16_t n = nlr_wire_encode(frame, type, p_payload, len);
+
+    if (p_dev->tcp) {
+        (void)send(p_dev->fd, frame, n, MSG_NOSIGNAL);
+    } else {
+        (void)sendto(p_shard->udp_fd, frame, n, 0, (const struct sockaddr *)&p_dev->peer, sizeof(p_dev->peer));
+    }
+}
+
+static void gw_on_rr(gw_shard_t *p_shard, gw_device_t *p_dev, const uint8_t *p_payload, uint16_t len)
+{
+    for (uint16_t i = 0; i + 1U < len; i += 2U) {
+        float rr_ms = (float)gw_le16(&p_payload[i]);
+        if (biometrics_process_rr(&p_dev->metrics, rr_ms)) {
+            hrv_nonlinear_add_rr(&p_dev->nonlinear, rr_ms);
+        }
+        p_dev->rr_total++;
+        p_dev->rr_window++;
+        p_shard->stats.rr++;
+    }
+}
+
+/** One frame, decoded where it lies. Returns false if the device went away. */
+static bool gw_on_frame(gw_shard_t *p_shard, gw_device_t *p_dev, const uint8_t *p_frame, uint16_t n,
+                        uint32_t now_ms)
+{
+    uint8_t type;
+    const uint8_t *p_payload;
+    uint16_t len;
+
+    if (nlr_wire_decode(p_frame, n, &type, &p_payload, &len) != 0) {
+        p_shard->stats.bad_frames++;
+        return true;
+    }
+    p_shard->stats.frames++;
+    p_dev->last_seen_ms = now_ms;
+
+    switch (type) {
+        case NLR_WIRE_ADVERTISE:
+            if (len == sizeof(p_dev->dev_addr)) {
+                memcpy(p_dev->dev_addr, p_payload, sizeof(p_dev->dev_addr));
+                p_dev->have_dev_addr = true;
+            }
+            if (!p_dev->streaming) {
+                const uint8_t mtu[2] = { (uint8_t)GW_LINK_MTU, (uint8_t)(GW_LINK_MTU >> 8) };
+                const uint8_t enable = 1;
+                gw_send(p_shard, p_dev, NLR_WIRE_CONNECT, mtu, sizeof(mtu));
+                gw_send(p_shard, p_dev, NLR_WIRE_SUBSCRIBE, &enable, 1);
+                p_dev->streaming = true;
+                p_shard->stats.connects++;
+            }
+            break;
+
+        case NLR_WIRE_RR:
+            p_dev->streaming = true;
+            gw_on_rr(p_shard, p_dev, p_payload, len);
+            break;
+
+        case NLR_WIRE_COHERENCE:
+            if (len != sizeof(nlr_coherence_packet_t)) {
+                p_shard->stats.bad_frames++;
+                break;
+            }
+            p_dev->ring_coherence = *(const nlr_coherence_packet_t *)p_payload;
+            p_dev->have_coherence = true;
+            break;
+
+        case NLR_WIRE_DEVICE_STATE:
+            if (len != sizeof(nlr_device_state_t)) {
+                p_shard->stats.bad_frames++;
+                break;
+            }
+            p_dev->ring_state = *(const nlr_device_state_t *)p_payload;
+            p_dev->have_state = true;
+            break;
+
+        case NLR_WIRE_DISCONNECT:
+            gw_device_remove(p_shard, p_dev);
+            return false;
+
+        default:
+            p_shard->stats.bad_frames++;
+            break;
+    }
+    return true;
+}
+
+static void gw_on_udp(gw_shard_t *p_shard, uint32_t now_ms)
+{
+    for (;;) {
+        for (uint32_t i = 0; i < GW_RX_BATCH; i++) {
+            p_shard->msgs[i].msg_hdr.msg_namelen = sizeof(p_shard->from[i]);
+        }
+        int n = recvmmsg(p_shard->udp_fd, p_shard->msgs, GW_RX_BATCH, MSG_DONTWAIT, NULL);
+        if (n <= 0) return;
+
+        for (int i = 0; i < n; i++) {
+            const struct sockaddr_in *p_from = &p_shard->from[i];
+            uint64_t key = gw_key_udp(p_from);
+            gw_device_t *p_dev = gw_device_find(p_shard, key);
+
+            if (!p_dev) {
+                p_dev = gw_device_add(p_shard, key);
+                if (!p_dev) continue;
+                p_dev->peer = *p_from;
+            }
+            (void)gw_on_frame(p_shard, p_dev, p_shard->rx[i], (uint16_t)p_shard->msgs[i].msg_len, now_ms);
+        }
+        if ((uint32_t)n < GW_RX_BATCH) return;
+    }
+}
+
+static void gw_on_accept(gw_shard_t *p_shard, uint32_t now_ms)
+{
+    for (;;) {
+        struct sockaddr_in peer;
+        socklen_t peer_len = sizeof(peer);
+        int fd = accept4(p_shard->listen_fd, (struct sockaddr *)&peer, &peer_len, SOCK_NONBLOCK);
+        if (fd < 0) return;
+
+        gw_device_t *p_dev = gw_device_add(p_shard, gw_key_tcp(fd));
+        if (!p_dev) {
+            close(fd);
+            continue;
+        }
+        p_dev->tcp = true;
+        p_dev->fd = fd;
+        p_dev->peer = peer;
+        p_dev->last_seen_ms = now_ms;
+
+        struct epoll_event ev = {
+            .events = EPOLLIN | EPOLLRDHUP,
+            .data.u64 = gw_ev(GW_EV_TCP, (uint32_t)(p_dev - p_shard->p_pool)),
+        };
+        if (epoll_ctl(p_shard->epfd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+            gw_device_remove(p_shard, p_dev);
+        }
+    }
+}
+
+/** TCP bytes into the connection buffer; whole frames are decoded in place */
+static void gw_on_tcp(gw_shard_t *p_shard, gw_device_t *p_dev, uint32_t now_ms)
+{
+    for (;;) {
+        ssize_t n = recv(p_dev->fd, &p_dev->rx[p_dev->rx_len], GW_TCP_BUF - p_dev->rx_len, 0);
+        if (n == 0 || (n < 0 && errno != EAGAIN && errno != EINTR)) {
+            gw_device_remove(p_shard, p_dev);
+            return;
+        }
+        if (n < 0) return;
+        p_dev->rx_len = (uint16_t)(p_dev->rx_len + n);
+
+        uint16_t off = 0;
+        while ((uint16_t)(p_dev->rx_len - off) >= NLR_WIRE_HDR_BYTES) {
+            uint16_t frame_len = (uint16_t)(NLR_WIRE_HDR_BYTES + p_dev->rx[off + 1U]);
+            if ((uint16_t)(p_dev->rx_len - off) < frame_len) break;
+            if (!gw_on_frame(p_shard, p_dev, &p_dev->rx[off], frame_len, now_ms)) return;
+            off = (uint16_t)(off + frame_len);
+        }
+        if (off > 0U) {
+            memmove(p_dev->rx, &p_dev->rx[off], p_dev->rx_len - off);
+            p_dev->rx_len = (uint16_t)(p_dev->rx_len - off);
+        }
+    }
+}
+
+/*******************************************************************************
+ * AGGREGATES
+ ******************************************************************************/
+
+static int gw_format_row(char *p_row, const gw_shard_t *p_shard, const gw_device_t *p_dev, double t_s)
+{
+    char id[24];
+    const hr_metrics_t *m = &p_dev->metrics;
+    hr_readout_t readout;
+
+    biometrics_readout(m, &readout);
+    if (p_dev->have_dev_addr) {
+        const uint8_t *a = p_dev->dev_addr;
+        snprintf(id, sizeof(id), "%02X%02X%02X%02X%02X%02X", a[0], a[1], a[2], a[3], a[4], a[5]);
+    } else {
+        snprintf(id, sizeof(id), "%s:%u", inet_ntoa(p_dev->peer.sin_addr), (unsigned)ntohs(p_dev->peer.sin_port));
+    }
+
+    return snprintf(p_row, GW_ROW_MAX,
+                    "%.1f,%u,%s,%s,%u,%u,%.1f,%.1f,%.1f,%.3f,%u,%.3f,%d,%d,%d,%d,%d\n",
+                    t_s, (unsigned)p_shard->index, id, p_dev->tcp ? "tcp" : "udp",
+                    (unsigned)p_dev->rr_total, (unsigned)p_dev->rr_window,
+                    (double)readout.mean_rr_ms, (double)readout.rmssd_ms, (double)readout.sdnn_ms,
+                    (double)readout.stress, (unsigned)m->quality_pct, (double)m->dfa_alpha1,
+                    p_dev->have_coherence ? p_dev->ring_coherence.stress_level : -1,
+                    p_dev->have_coherence ? p_dev->ring_coherence.coherence_pct : -1,
+                    p_dev->have_coherence ? p_dev->ring_coherence.rmssd_ms : -1,
+                    p_dev->have_state ? p_dev->ring_state.battery_pct : -1,
+                    p_dev->have_state ? p_dev->ring_state.skin_temp_c : -1);
+}
+
+/** One buffer, one O_APPEND write: rows from different shards never interleave */
+static void gw_write_aggregates(gw_shard_t *p_shard, uint32_t now_ms)
+{
+    size_t cap = (size_t)p_shard->n_devices * GW_ROW_MAX + 1U;
+    char *p_buf = malloc(cap);
+    size_t len = 0;
+
+    if (!p_buf) return;
+    for (uint32_t i = 0; i <= p_shard->table_mask; i++) {
+        if (p_shard->p_keys[i] == 0U) continue;
+        gw_device_t *p_dev = &p_shard->p_pool[p_shard->p_slots[i]];
+        if (!p_dev->streaming) continue;
+        len += (size_t)gw_format_row(&p_buf[len], p_shard, p_dev, now_ms / 1000.0);
+        p_dev->rr_window = 0;
+    }
+    if (len > 0U && write(m_out_fd, p_buf, len) != (ssize_t)len) {
+        fprintf(stderr, "nlr_gateway: short write to %s\n", m_cfg.out_file);
+    }
+    free(p_buf);
+}
+
+static void gw_on_tick(gw_shard_t *p_shard, uint32_t now_ms)
+{
+    uint64_t expirations;
+    (void)read(p_shard->timer_fd, &expirations, sizeof(expirations));
+
+    for (uint32_t i = 0; i <= p_shard->table_mask; i++) {
+        if (p_shard->p_keys[i] == 0U) continue;
+        gw_device_t *p_dev = &p_shard->p_pool[p_shard->p_slots[i]];
+
+        /* Supervision timeout: the ring will advertise again */
+        if (now_ms - p_dev->last_seen_ms > NLR_CONN_SUP_TIMEOUT_MS) {
+            p_shard->stats.timeouts++;
+            gw_device_remove(p_shard, p_dev);
+            i--;    /* Backward shift may have pulled an entry into this slot */
+            continue;
+        }
+
+        for (uint32_t k = 0; k < GW_DFA_STEPS_PER_TICK; k++) {
+            if (hrv_nonlinear_step(&p_dev->nonlinear)) {
+                biometrics_set_dfa_alpha1(&p_dev->metrics, p_dev->nonlinear.dfa_alpha1);
+                break;
+            }
+        }
+        p_dev->metrics.sd1_us = p_dev->nonlinear.sd1_us;
+        p_dev->metrics.sd2_us = p_dev->nonlinear.sd2_us;
+        p_dev->metrics.sdnn_us = p_dev->nonlinear.sdnn_us;
+    }
+
+    if (++p_shard->ticks % (m_cfg.interval_s * 1000U / GW_TICK_MS) == 0U) {
+        gw_write_aggregates(p_shard, now_ms);
+    }
+}
+
+/*******************************************************************************
+ * SHARDS
+ ******************************************************************************/
+
+static int gw_bind(int type, uint16_t port)
+{
+    int one = 1;
+    int fd = socket(AF_INET, type | SOCK_NONBLOCK, 0);
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons(port),
+        .sin_addr.s_addr = htonl(INADDR_ANY),
+    };
+
+    if (fd < 0) return -1;
+    if (setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one)) != 0 ||
+        bind(fd, (const struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+        (type == SOCK_STREAM && listen(fd, 128) != 0)) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static int gw_epoll_add(int epfd, int fd, gw_ev_t type)
+{
+    struct epoll_event ev = { .events = EPOLLIN, .data.u64 = gw_ev(type, 0) };
+    return epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev);
+}
+
+static int gw_shard_init(gw_shard_t *p_shard, uint32_t index)
+{
+    uint32_t size = 1;
+    while (size < 2U * m_cfg.max_devices) size <<= 1;
+
+    p_shard->index = index;
+    p_shard->table_mask = size - 1U;
+    p_shard->p_keys = calloc(size, sizeof(uint64_t));
+    p_shard->p_slots = calloc(size, sizeof(uint32_t));
+    p_shard->p_pool = calloc(m_cfg.max_devices, sizeof(gw_device_t));
+    p_shard->p_free = calloc(m_cfg.max_devices, sizeof(uint32_t));
+    if (!p_shard->p_keys || !p_shard->p_slots || !p_shard->p_pool || !p_shard->p_free) return -1;
+
+    for (uint32_t i = 0; i < m_cfg.max_devices; i++) {
+        p_shard->p_free[i] = m_cfg.max_devices - 1U - i;
+    }
+    p_shard->n_free = m_cfg.max_devices;
+
+    for (uint32_t i = 0; i < GW_RX_BATCH; i++) {
+        p_shard->iov[i] = (struct iovec){ .iov_base = p_shard->rx[i], .iov_len = NLR_WIRE_MAX_FRAME };
+        p_shard->msgs[i].msg_hdr = (struct msghdr){
+            .msg_name = &p_shard->from[i],
+            .msg_namelen = sizeof(p_shard->from[i]),
+            .msg_iov = &p_shard->iov[i],
+            .msg_iovlen = 1,
+        };
+    }
+
+    struct itimerspec tick = {
+        .it_interval = { .tv_sec = GW_TICK_MS / 1000U, .tv_nsec = (GW_TICK_MS % 1000U) * 1000000L },
+        .it_value = { .tv_sec = GW_TICK_MS / 1000U, .tv_nsec = (GW_TICK_MS % 1000U) * 1000000L },
+    };
+
+    p_shard->epfd = epoll_create1(0);
+    p_shard->udp_fd = gw_bind(SOCK_DGRAM, m_cfg.port);
+    p_shard->listen_fd = gw_bind(SOCK_STREAM, m_cfg.port);
+    p_shard->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
+    p_shard->stop_fd = eventfd(0, EFD_NONBLOCK);
+
+    if (p_shard->epfd < 0 || p_shard->udp_fd < 0 || p_shard->listen_fd < 0 ||
+        p_shard->timer_fd < 0 || p_shard->stop_fd < 0 ||
+        timerfd_settime(p_shard->timer_fd, 0, &tick, NULL) != 0 ||
+        gw_epoll_add(p_shard->epfd, p_shard->udp_fd, GW_EV_UDP) != 0 ||
+        gw_epoll_add(p_shard->epfd, p_shard->listen_fd, GW_EV_LISTEN) != 0 ||
+        gw_epoll_add(p_shard->epfd, p_shard->timer_fd, GW_EV_TIMER) != 0 ||
+        gw_epoll_add(p_shard->epfd, p_shard->stop_fd, GW_EV_STOP) != 0) {
+        return -1;
+    }
+    return 0;
+}
+
+static void *gw_shard_run(void *p_arg)
+{
+    gw_shard_t *p_shard = p_arg;
+    struct epoll_event events[GW_EPOLL_EVENTS];
+    cpu_set_t cpus;
+
+    /* Pin to a core; the kernel already steers this shard's rings here */
+    CPU_ZERO(&cpus);
+    CPU_SET(p_shard->index % (uint32_t)CPU_SETSIZE, &cpus);
+    (void)pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+
+    for (;;) {
+        int n = epoll_wait(p_shard->epfd, events, GW_EPOLL_EVENTS, -1);
+        if (n < 0 && errno != EINTR) break;
+
+        uint32_t now_ms = gw_now_ms();
+        for (int i = 0; i < n; i++) {
+            uint64_t tag = events[i].data.u64;
+            switch ((gw_ev_t)(tag >> 32)) {
+                case GW_EV_UDP:     gw_on_udp(p_shard, now_ms); break;
+                case GW_EV_LISTEN:  gw_on_accept(p_shard, now_ms); break;
+                case GW_EV_TIMER:   gw_on_tick(p_shard, now_ms); break;
+                case GW_EV_TCP:
+                {
+                    gw_device_t *p_dev = &p_shard->p_pool[(uint32_t)tag];
+                    /* Skip stale events for a connection closed earlier in this batch */
+                    if (p_dev->key != 0U && p_dev->tcp) gw_on_tcp(p_shard, p_dev, now_ms);
+                    break;
+                }
+                case GW_EV_STOP:
+                    gw_write_aggregates(p_shard, now_ms);
+                    return NULL;
+            }
+        }
+    }
+    return NULL;
+}
+
+/*******************************************************************************
+ * MAIN
+ ******************************************************************************/
+
+static int gw_parse_args(int argc, char **argv)
+{
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        const char *v = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (!v) {
+            fprintf(stderr, "nlr_gateway: bad or incomplete option %s\n", a);
+            return -1;
+        }
+        i++;
+
+        if (strcmp(a, "--port") == 0)             m_cfg.port = (uint16_t)strtoul(v, NULL, 0);
+        else if (strcmp(a, "--shards") == 0)      m_cfg.shards = (uint32_t)strtoul(v, NULL, 0);
+        else if (strcmp(a, "--out") == 0)         m_cfg.out_file = v;
+        else if (strcmp(a, "--interval") == 0)    m_cfg.interval_s = (uint32_t)strtoul(v, NULL, 0);
+        else if (strcmp(a, "--duration") == 0)    m_cfg.duration_s = (uint32_t)strtoul(v, NULL, 0);
+        else if (strcmp(a, "--max-devices") == 0) m_cfg.max_devices = (uint32_t)strtoul(v, NULL, 0);
+        else {
+            fprintf(stderr, "nlr_gateway: unknown option %s\n", a);
+            return -1;
+        }
+    }
+
+    if (m_cfg.shards == 0U) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        m_cfg.shards = (cpus > 0) ? (uint32_t)cpus : 1U;
+    }
+    if (m_cfg.port == 0U || m_cfg.interval_s == 0U || m_cfg.interval_s > 3600U ||
+        m_cfg.max_devices == 0U || m_cfg.max_devices > (1U << 20)) {
+        fprintf(stderr, "nlr_gateway: option out of range\n");
+        return -1;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    sigset_t sigs;
+
+    if (gw_parse_args(argc, argv) != 0) return 2;
+
+    /* Shards inherit the mask; only main waits for signals */
+    sigemptyset(&sigs);
+    sigaddset(&sigs, SIGINT);
+    sigaddset(&sigs, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &sigs, NULL);
+
+    m_out_fd = open(m_cfg.out_file, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+    if (m_out_fd < 0) {
+        fprintf(stderr, "nlr_gateway: cannot write %s\n", m_cfg.out_file);
+        return 2;
+    }
+    static const char header[] =
+        "t_s,shard,device,transport,rr_total,rr_window,mean_rr_ms,rmssd_ms,sdnn_ms,stress,"
+        "quality_pct,dfa_alpha1,ring_stress,ring_coherence,ring_rmssd_ms,battery_pct,skin_c\n";
+    if (write(m_out_fd, header, sizeof(header) - 1U) != (ssize_t)(sizeof(header) - 1U)) return 2;
+
+    gw_shard_t *p_shards = calloc(m_cfg.shards, sizeof(gw_shard_t));
+    if (!p_shards) return 2;
+
+    clock_gettime(CLOCK_MONOTONIC, &m_start);
+    for (uint32_t s = 0; s < m_cfg.shards; s++) {
+        if (gw_shard_init(&p_shards[s], s) != 0) {
+            fprintf(stderr, "nlr_gateway: shard %u on port %u: %s\n",
+                    (unsigned)s, (unsigned)m_cfg.port, strerror(errno));
+            return 2;
+        }
+    }
+    for (uint32_t s = 0; s < m_cfg.shards; s++) {
+        if (pthread_create(&p_shards[s].thread, NULL, gw_shard_run, &p_shards[s]) != 0) {
+            fprintf(stderr, "nlr_gateway: cannot start shard %u\n", (unsigned)s);
+            return 2;
+        }
+    }
+    printf("listening on udp/tcp %u with %u shards, aggregates every %u s to %s\n",
+           (unsigned)m_cfg.port, (unsigned)m_cfg.shards, (unsigned)m_cfg.interval_s, m_cfg.out_file);
+    fflush(stdout);
+
+    /* Run until a signal or the requested duration */
+    for (;;) {
+        struct timespec wait = { .tv_sec = 1 };
+        int sig = sigtimedwait(&sigs, NULL, &wait);
+        if (sig == SIGINT || sig == SIGTERM) break;
+        if (m_cfg.duration_s > 0U && gw_now_ms() >= m_cfg.duration_s * 1000U) break;
+    }
+
+    gw_stats_t total = {0};
+    uint32_t devices = 0;
+    for (uint32_t s = 0; s < m_cfg.shards; s++) {
+        gw_shard_t *p_shard = &p_shards[s];
+        uint64_t one = 1;
+        (void)write(p_shard->stop_fd, &one, sizeof(one));
+        pthread_join(p_shard->thread, NULL);
+
+        printf("shard %u: %u devices, %llu frames, %llu RR\n", (unsigned)s,
+               (unsigned)p_shard->n_devices, (unsigned long long)p_shard->stats.frames,
+               (unsigned long long)p_shard->stats.rr);
+        devices += p_shard->n_devices;
+        total.frames += p_shard->stats.frames;
+        total.rr += p_shard->stats.rr;
+        total.bad_frames += p_shard->stats.bad_frames;
+        total.connects += p_shard->stats.connects;
+        total.timeouts += p_shard->stats.timeouts;
+        total.table_full += p_shard->stats.table_full;
+    }
+
+    printf("total:   %u devices, %llu frames, %llu RR, %llu connects, %llu timeouts, "
+           "%llu bad frames, %llu refused (table full)\n",
+           (unsigned)devices, (unsigned long long)total.frames, (unsigned long long)total.rr,
+           (unsigned long long)total.connects, (unsigned long long)total.timeouts,
+           (unsigned long long)total.bad_frames, (unsigned long long)total.table_full);
+    close(m_out_fd);
+    return 0;
+}
@@ -0,0 +1,670 @@
+/**
+ * @file loadgen.c
+ * @brief Neural Load Ring Host Load Generator - Many Emulated Rings
+ *
+ * Runs hundreds to thousands of emulated rings in one process to load the
+ * ingest path (phone app, gateway, backend) the way a fleet would. Every
+ * ring runs the firmware signal chain on its own synthetic physiology:
+ * ppg_fusion (a detector per PPG channel) -> biometrics -> hrv_nonlinear,
+ * and builds notifications with the firmware's own encoders (ble_packets.h).
+ * wellness_manager and ble_stack are singletons, so they are not
+ * instantiated; ring_app_tasks() mirrors what main.c schedules with them.
+ *
+ * Rings are split across a pool of worker threads. A worker advances each
+ * of its rings in real time one PPG block (PPG_BLOCK_FRAMES) at a time, and
+ * sends only at the ring's BLE connection events: random anchor, fixed
+ * interval, a bounded number of notifications per event and a TX queue the
+ * size of ble_stack.c's. Receivers therefore see the bursty arrival of real
+ * links, not a smooth stream.
+ *
+ * Each ring owns a UDP socket (its source port is its identity) and speaks
+ * nlr_wire.h to the target: ADVERTISE until CONNECT, stream after SUBSCRIBE,
+ * back to advertising on DISCONNECT. --auto-connect skips the handshake for
+ * receivers that only sink data.
+ *
+ * Usage: nlr_loadgen [options]
+ *   --rings N           Emulated rings (default 100)
+ *   --threads N         Worker threads (default: online CPUs)
+ *   --duration S        Run time in seconds (default 60)
+ *   --target HOST:PORT  Central / gateway (default 127.0.0.1:47100)
+ *   --conn-interval MS  Connection interval (default NLR_CONN_INTERVAL_MAX_MS)
+ *   --per-event N       Notifications per connection event (default 4)
+ *   --detector ID       Beat detector (default 1, SSF)
+ *   --seed N            Physiology seed (ring i uses seed + i)
+ *   --auto-connect      Start connected and subscribed
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "nlr_wire.h"
+#include "ppg_synth.h"
+#include "core/ppg_fusion.h"
+#include "core/biometric_algorithms.h"
+#include "core/hrv_nonlinear.h"
+#include "sensors/ppg_driver.h"
+#include "bluetooth/ble_packets.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+
+/*******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
+
+/* Application timing (main.c) */
+#define RING_RR_SEND_MS         250U
+#define RING_COHERENCE_MS       15000U
+#define RING_STATE_MS           5000U
+#define RING_RR_BUFFER          16U
+
+/* Link layer (ble_stack.c / ble_stack.h) */
+#define RING_TX_QUEUE           8U
+#define RING_ADV_INTERVAL_MS    NLR_ADV_INTERVAL_MIN_MS
+#define RING_ADV_DELAY_MAX_MS   10U     /**< advDelay, de-synchronises advertisers */
+#define RING_MTU_DEFAULT        23U
+#define RING_RX_PER_EVENT       4U
+
+#define RING_BLOCK_MS           (PPG_BLOCK_FRAMES * PPG_FRAME_PERIOD_MS)
+#define RING_SIGNAL_SCALE       16.0f   /**< Synth units to normalised ADC (sim_afe.c) */
+#define RING_FRAME_MAX          (NLR_WIRE_HDR_BYTES + sizeof(nlr_coherence_packet_t) + 8U)
+
+#define WORKER_SLEEP_MAX_MS     50U
+
+static struct {
+    uint32_t rings;
+    uint32_t threads;
+    uint32_t duration_s;
+    struct sockaddr_in target;
+    uint16_t conn_interval_ms;
+    uint8_t per_event;
+    uint8_t detector;
+    uint32_t seed;
+    bool auto_connect;
+} m_cfg = {
+    .rings = 100,
+    .duration_s = 60,
+    .conn_interval_ms = NLR_CONN_INTERVAL_MAX_MS,
+    .per_event = 4,
+    .detector = PEAK_DETECTOR_SSF,
+    .seed = 1000U,
+};
+
+/*******************************************************************************
+ * TYPES
+ ******************************************************************************/
+
+typedef enum {
+    RING_ADVERTISING,
+    RING_CONNECTED,
+    RING_STREAMING,
+} ring_link_t;
+
+typedef struct {
+    uint8_t len;
+    uint8_t frame[RING_FRAME_MAX];
+} ring_tx_t;
+
+typedef struct {
+    uint32_t id;
+    int fd;
+    ring_link_t link;
+    uint16_t mtu;
+
+    /* Signal chain */
+    ppg_synth_t synth;
+    ppg_fusion_t fusion;
+    hr_metrics_t metrics;
+    hrv_nonlinear_t nonlinear;
+    uint32_t last_peak_ms;
+    bool have_last_peak;
+
+    /* Application layer */
+    uint16_t rr_buffer[RING_RR_BUFFER];
+    uint8_t rr_count;
+    uint32_t last_rr_send_ms;
+    uint32_t last_coherence_ms;
+    uint32_t last_state_ms;
+
+    /* Link layer */
+    ring_tx_t txq[RING_TX_QUEUE];
+    uint8_t tx_head;
+    uint8_t tx_count;
+    uint32_t next_block_ms;
+    uint32_t next_event_ms;
+    uint32_t next_adv_ms;
+} ring_t;
+
+typedef struct {
+    atomic_uint_fast64_t frames_tx;
+    atomic_uint_fast64_t bytes_tx;
+    atomic_uint_fast64_t rr_tx;
+    atomic_uint_fast64_t beats;
+    atomic_uint_fast64_t queue_drops;   /**< Notification refused, queue full */
+    atomic_uint_fast64_t send_errors;
+    atomic_uint_fast64_t frames_rx;
+    atomic_uint_fast64_t connects;
+    atomic_uint_fast32_t lag_max_ms;    /**< Worst lateness of a due event */
+} lg_stats_t;
+
+typedef struct {
+    pthread_t thread;
+    ring_t *p_rings;
+    uint32_t n_rings;
+    lg_stats_t stats;
+} lg_worker_t;
+
+static struct timespec m_start;
+static atomic_bool m_stop;
+
+/*******************************************************************************
+ * TIME
+ ******************************************************************************/
+
+static uint32_t lg_now_ms(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint32_t)((t.tv_sec - m_start.tv_sec) * 1000 +
+                      (t.tv_nsec - m_start.tv_nsec) / 1000000);
+}
+
+static void lg_sleep_until(uint32_t t_ms)
+{
+    struct timespec t = m_start;
+    t.tv_sec += t_ms / 1000U;
+    t.tv_nsec += (long)(t_ms % 1000U) * 1000000L;
+    if (t.tv_nsec >= 1000000000L) {
+        t.tv_sec++;
+        t.tv_nsec -= 1000000000L;
+    }
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &t, NULL) == EINTR) {
+    }
+}
+
+static inline bool lg_due(uint32_t t_ms, uint32_t now_ms)
+{
+    return (int32_t)(now_ms - t_ms) >= 0;
+}
+
+static inline uint32_t lg_min(uint32_t a, uint32_t b)
+{
+    return ((int32_t)(a - b) < 0) ? a : b;
+}
+
+/*******************************************************************************
+ * LINK LAYER
+ ******************************************************************************/
+
+static void ring_send_now(ring_t *p_ring, lg_stats_t *p_stats, const uint8_t *p_frame, uint16_t len)
+{
+    if (send(p_ring->fd, p_frame, len, 0) == (ssize_t)len) {
+        atomic_fetch_add_explicit(&p_stats->frames_tx, 1, memory_order_relaxed);
+        atomic_fetch_add_explicit(&p_stats->bytes_tx, len, memory_order_relaxed);
+    } else {
+        atomic_fetch_add_explicit(&p_stats->send_errors, 1, memory_order_relaxed);
+    }
+}
+
+/** Queue a notification for the next connection event (0, or -4 like ble_stack.c) */
+static int ring_notify(ring_t *p_ring, lg_stats_t *p_stats, uint8_t type, const void *p_payload, uint16_t len)
+{
+    if (p_ring->tx_count >= RING_TX_QUEUE) {
+        atomic_fetch_add_explicit(&p_stats->queue_drops, 1, memory_order_relaxed);
+        return -4;
+    }
+
+    ring_tx_t *p_tx = &p_ring->txq[(p_ring->tx_head + p_ring->tx_count) % RING_TX_QUEUE];
+    p_tx->len = (uint8_t)nlr_wire_encode(p_tx->frame, type, p_payload, len);
+    p_ring->tx_count++;
+    return 0;
+}
+
+static void ring_disconnect(ring_t *p_ring, uint32_t now_ms)
+{
+    p_ring->link = RING_ADVERTISING;
+    p_ring->mtu = RING_MTU_DEFAULT;
+    p_ring->tx_count = 0;
+    p_ring->rr_count = 0;
+    p_ring->next_adv_ms = now_ms + RING_ADV_INTERVAL_MS;
+}
+
+static void ring_on_frame(ring_t *p_ring, lg_stats_t *p_stats, const uint8_t *p_frame,
+                          uint16_t n, uint32_t now_ms)
+{
+    uint8_t type;
+    const uint8_t *p_payload;
+    uint16_t len;
+
+    if (nlr_wire_decode(p_frame, n, &type, &p_payload, &len) != 0) return;
+    atomic_fetch_add_explicit(&p_stats->frames_rx, 1, memory_order_relaxed);
+
+    switch (type) {
+        case NLR_WIRE_CONNECT:
+            if (p_ring->link != RING_ADVERTISING) break;
+            p_ring->link = RING_CONNECTED;
+            p_ring->mtu = (len >= 2U) ? (uint16_t)(p_payload[0] | (p_payload[1] << 8)) : RING_MTU_DEFAULT;
+            if (p_ring->mtu < RING_MTU_DEFAULT) p_ring->mtu = RING_MTU_DEFAULT;
+            /* First connection event one interval after CONNECT_IND */
+            p_ring->next_event_ms = now_ms + m_cfg.conn_interval_ms;
+            atomic_fetch_add_explicit(&p_stats->connects, 1, memory_order_relaxed);
+            break;
+
+        case NLR_WIRE_SUBSCRIBE:
+            if (p_ring->link == RING_ADVERTISING) break;
+            p_ring->link = ((len == 0U) || (p_payload[0] != 0U)) ? RING_STREAMING : RING_CONNECTED;
+            break;
+
+        case NLR_WIRE_DISCONNECT:
+            ring_disconnect(p_ring, now_ms);
+            break;
+
+        default:
+            /* Actuator / config writes are accepted and ignored */
+            break;
+    }
+}
+
+static void ring_receive(ring_t *p_ring, lg_stats_t *p_stats, uint32_t now_ms)
+{
+    uint8_t frame[NLR_WIRE_MAX_FRAME];
+
+    for (uint8_t i = 0; i < RING_RX_PER_EVENT; i++) {
+        ssize_t n = recv(p_ring->fd, frame, sizeof(frame), 0);
+        if (n <= 0) break;
+        ring_on_frame(p_ring, p_stats, frame, (uint16_t)n, now_ms);
+    }
+}
+
+/** Advertising or connection events that fell due */
+static void ring_link_events(ring_t *p_ring, lg_stats_t *p_stats, uint32_t now_ms)
+{
+    if (p_ring->link == RING_ADVERTISING) {
+        if (!lg_due(p_ring->next_adv_ms, now_ms)) return;
+
+        uint8_t addr[6] = { 0x4E, 0x4C, (uint8_t)(p_ring->id >> 24), (uint8_t)(p_ring->id >> 16),
+                            (uint8_t)(p_ring->id >> 8), (uint8_t)p_ring->id };
+        uint8_t frame[NLR_WIRE_HDR_BYTES + sizeof(addr)];
+        ring_send_now(p_ring, p_stats, frame, nlr_wire_encode(frame, NLR_WIRE_ADVERTISE, addr, sizeof(addr)));
+        ring_receive(p_ring, p_stats, now_ms);
+        p_ring->next_adv_ms = now_ms + RING_ADV_INTERVAL_MS +
+                              ppg_synth_rand(&p_ring->synth) % (RING_ADV_DELAY_MAX_MS + 1U);
+        return;
+    }
+
+    while (p_ring->link != RING_ADVERTISING && lg_due(p_ring->next_event_ms, now_ms)) {
+        uint32_t late_ms = now_ms - p_ring->next_event_ms;
+        if (late_ms > atomic_load_explicit(&p_stats->lag_max_ms, memory_order_relaxed)) {
+            atomic_store_explicit(&p_stats->lag_max_ms, late_ms, memory_order_relaxed);
+        }
+
+        ring_receive(p_ring, p_stats, now_ms);
+        for (uint8_t i = 0; i < m_cfg.per_event && p_ring->tx_count > 0U; i++) {
+            ring_tx_t *p_tx = &p_ring->txq[p_ring->tx_head];
+            ring_send_now(p_ring, p_stats, p_tx->frame, p_tx->len);
+            p_ring->tx_head = (uint8_t)((p_ring->tx_head + 1U) % RING_TX_QUEUE);
+            p_ring->tx_count--;
+        }
+        p_ring->next_event_ms += m_cfg.conn_interval_ms;
+    }
+}
+
+/*******************************************************************************
+ * SIGNAL CHAIN AND APPLICATION
+ ******************************************************************************/
+
+/** One FIFO block through fusion and biometrics (ppg_driver + wellness_manager) */
+static void ring_ppg_block(ring_t *p_ring, lg_stats_t *p_stats)
+{
+    float frames[PPG_BLOCK_FRAMES * 2U];
+    uint32_t t0 = p_ring->synth.t_ms;
+    ppg_beat_t beat;
+
+    for (uint16_t k = 0; k < PPG_BLOCK_FRAMES; k++) {
+        float v = ppg_synth_next(&p_ring->synth, NULL, NULL) / RING_SIGNAL_SCALE;
+        frames[2U * k] = v;             /* Green */
+        frames[2U * k + 1U] = 0.5f * v; /* IR */
+    }
+    ppg_fusion_process(&p_ring->fusion, frames, PPG_BLOCK_FRAMES, t0, PPG_FRAME_PERIOD_MS);
+
+    while (ppg_fusion_pop(&p_ring->fusion, &beat)) {
+        if (p_ring->have_last_peak) {
+            float rr_ms = (float)(beat.peak_ms - p_ring->last_peak_ms);
+            atomic_fetch_add_explicit(&p_stats->beats, 1, memory_order_relaxed);
+            if (biometrics_process_rr(&p_ring->metrics, rr_ms)) {
+                hrv_nonlinear_add_rr(&p_ring->nonlinear, rr_ms);
+                if (p_ring->link == RING_STREAMING && p_ring->rr_count < RING_RR_BUFFER) {
+                    p_ring->rr_buffer[p_ring->rr_count++] = (uint16_t)rr_ms;
+                }
+            }
+        }
+        p_ring->last_peak_ms = beat.peak_ms;
+        p_ring->have_last_peak = true;
+    }
+
+    /* The manager steps DFA once per 10 ms tick; a block is 25 ticks of work */
+    for (uint16_t k = 0; k < PPG_BLOCK_FRAMES; k++) {
+        if (hrv_nonlinear_step(&p_ring->nonlinear)) {
+            biometrics_set_dfa_alpha1(&p_ring->metrics, p_ring->nonlinear.dfa_alpha1);
+        }
+    }
+    p_ring->metrics.sd1_us = p_ring->nonlinear.sd1_us;
+    p_ring->metrics.sd2_us = p_ring->nonlinear.sd2_us;
+    p_ring->metrics.sdnn_us = p_ring->nonlinear.sdnn_us;
+}
+
+/** main.c task_send_rr / task_send_coherence / task_update_device_state */
+static void ring_app_tasks(ring_t *p_ring, lg_stats_t *p_stats, uint32_t now_ms)
+{
+    if (p_ring->link == RING_STREAMING && p_ring->rr_count > 0U &&
+        now_ms - p_ring->last_rr_send_ms >= RING_RR_SEND_MS) {
+        uint8_t payload[NLR_RR_PER_NOTIFY_MAX * 2];
+        uint8_t count = (p_ring->rr_count > NLR_RR_PER_NOTIFY_MAX) ? NLR_RR_PER_NOTIFY_MAX : p_ring->rr_count;
+        uint16_t len = nlr_ble_encode_rr(payload, p_ring->rr_buffer, count, p_ring->mtu);
+
+        p_ring->last_rr_send_ms = now_ms;
+        if (ring_notify(p_ring, p_stats, NLR_WIRE_RR, payload, len) == 0) {
+            atomic_fetch_add_explicit(&p_stats->rr_tx, len / 2U, memory_order_relaxed);
+        }
+        p_ring->rr_count = 0;   /* Sent or queue full: cleared either way */
+    }
+
+    if (p_ring->link == RING_STREAMING && now_ms - p_ring->last_coherence_ms >= RING_COHERENCE_MS) {
+        nlr_coherence_packet_t packet;
+        p_ring->last_coherence_ms = now_ms;
+        nlr_ble_coherence_from_metrics(&p_ring->metrics, &packet);
+        (void)ring_notify(p_ring, p_stats, NLR_WIRE_COHERENCE, &packet, sizeof(packet));
+    }
+
+    if (p_ring->link != RING_ADVERTISING && now_ms - p_ring->last_state_ms >= RING_STATE_MS) {
+        nlr_device_state_t state = {
+            .battery_pct = (uint8_t)(100U - (now_ms / 600000U) % 60U),
+            .connection_state = 2,
+            .streaming_active = (p_ring->link == RING_STREAMING) ? 0x03 : 0x00,
+            .skin_temp_c = 33,
+            .uptime_min = (uint16_t)(now_ms / 60000U),
+        };
+        p_ring->last_state_ms = now_ms;
+        (void)ring_notify(p_ring, p_stats, NLR_WIRE_DEVICE_STATE, &state, sizeof(state));
+    }
+}
+
+/** Advance one ring to now; returns when it next needs attention */
+static uint32_t ring_run(ring_t *p_ring, lg_stats_t *p_stats, uint32_t now_ms)
+{
+    while (lg_due(p_ring->next_block_ms, now_ms)) {
+        ring_ppg_block(p_ring, p_stats);
+        p_ring->next_block_ms += RING_BLOCK_MS;
+    }
+    ring_app_tasks(p_ring, p_stats, now_ms);
+    ring_link_events(p_ring, p_stats, now_ms);
+
+    uint32_t next = p_ring->next_block_ms;
+    next = lg_min(next, (p_ring->link == RING_ADVERTISING) ? p_ring->next_adv_ms : p_ring->next_event_ms);
+    return next;
+}
+
+/*******************************************************************************
+ * RINGS AND WORKERS
+ ******************************************************************************/
+
+static int ring_init(ring_t *p_ring, uint32_t id)
+{
+    ppg_synth_params_t p = ppg_synth_defaults();
+    memset(p_ring, 0, sizeof(*p_ring));
+    p_ring->id = id;
+
+    /* Own physiology: 55-85 bpm, 15-55 ms beat-to-beat SD */
+    p.seed = m_cfg.seed + id;
+    ppg_synth_init(&p_ring->synth, &p);
+    p_ring->synth.p.hr_bpm = 55.0f + (float)(ppg_synth_rand(&p_ring->synth) % 31U);
+    p_ring->synth.p.hrv_sd_ms = 15.0f + (float)(ppg_synth_rand(&p_ring->synth) % 41U);
+
+    ppg_fusion_init(&p_ring->fusion, 2, (peak_detector_id_t)m_cfg.detector);
+    biometrics_reset(&p_ring->metrics);
+    hrv_nonlinear_reset(&p_ring->nonlinear);
+
+    /* Rings power up spread over one block and one advertising interval */
+    uint32_t phase = ppg_synth_rand(&p_ring->synth);
+    p_ring->next_block_ms = RING_BLOCK_MS + phase % RING_BLOCK_MS;
+    p_ring->next_adv_ms = phase % RING_ADV_INTERVAL_MS;
+    p_ring->mtu = RING_MTU_DEFAULT;
+
+    if (m_cfg.auto_connect) {
+        p_ring->link = RING_STREAMING;
+        p_ring->mtu = NLR_WIRE_MAX_PAYLOAD + NLR_ATT_HEADER_BYTES;
+        p_ring->next_event_ms = phase % m_cfg.conn_interval_ms;
+    }
+
+    p_ring->fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (p_ring->fd < 0) return -1;
+    if (connect(p_ring->fd, (const struct sockaddr *)&m_cfg.target, sizeof(m_cfg.target)) != 0 ||
+        fcntl(p_ring->fd, F_SETFL, fcntl(p_ring->fd, F_GETFL, 0) | O_NONBLOCK) != 0) {
+        close(p_ring->fd);
+        p_ring->fd = -1;
+        return -1;
+    }
+    return 0;
+}
+
+static void *lg_worker(void *p_arg)
+{
+    lg_worker_t *p_w = p_arg;
+
+    while (!atomic_load(&m_stop)) {
+        uint32_t now_ms = lg_now_ms();
+        uint32_t wake_ms = now_ms + WORKER_SLEEP_MAX_MS;
+
+        for (uint32_t i = 0; i < p_w->n_rings; i++) {
+            wake_ms = lg_min(wake_ms, ring_run(&p_w->p_rings[i], &p_w->stats, now_ms));
+        }
+        lg_sleep_until(wake_ms);
+    }
+    return NULL;
+}
+
+/*******************************************************************************
+ * COMMAND LINE AND REPORTING
+ ******************************************************************************/
+
+static int lg_parse_target(const char *v)
+{
+    char host[64];
+    const char *colon = strrchr(v, ':');
+    size_t n = colon ? (size_t)(colon - v) : strlen(v);
+
+    if (n == 0U || n >= sizeof(host)) return -1;
+    memcpy(host, v, n);
+    host[n] = '\0';
+
+    m_cfg.target.sin_family = AF_INET;
+    m_cfg.target.sin_port = htons(colon ? (uint16_t)strtoul(colon + 1, NULL, 0) : NLR_WIRE_PORT_DEFAULT);
+    return (inet_pton(AF_INET, host, &m_cfg.target.sin_addr) == 1) ? 0 : -1;
+}
+
+static int lg_parse_args(int argc, char **argv)
+{
+    m_cfg.target.sin_family = AF_INET;
+    m_cfg.target.sin_port = htons(NLR_WIRE_PORT_DEFAULT);
+    m_cfg.target.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        const char *v = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(a, "--auto-connect") == 0) { m_cfg.auto_connect = true; continue; }
+        if (!v) {
+            fprintf(stderr, "nlr_loadgen: bad or incomplete option %s\n", a);
+            return -1;
+        }
+        i++;
+
+        if (strcmp(a, "--rings") == 0)              m_cfg.rings = (uint32_t)strtoul(v, NULL, 0);
+        else if (strcmp(a, "--threads") == 0)       m_cfg.threads = (uint32_t)strtoul(v, NULL, 0);
+        else if (strcmp(a, "--duration") == 0)      m_cfg.duration_s = (uint32_t)strtoul(v, NULL, 0);
+        else if (strcmp(a, "--conn-interval") == 0) m_cfg.conn_interval_ms = (uint16_t)strtoul(v, NULL, 0);
+        else if (strcmp(a, "--per-event") == 0)     m_cfg.per_event = (uint8_t)strtoul(v, NULL, 0);
+        else if (strcmp(a, "--detector") == 0)      m_cfg.detector = (uint8_t)strtoul(v, NULL, 0);
+        else if (strcmp(a, "--seed") == 0)          m_cfg.seed = (uint32_t)strtoul(v, NULL, 0);
+        else if (strcmp(a, "--target") == 0) {
+            if (lg_parse_target(v) != 0) {
+                fprintf(stderr, "nlr_loadgen: bad target %s\n", v);
+                return -1;
+            }
+        } else {
+            fprintf(stderr, "nlr_loadgen: unknown option %s\n", a);
+            return -1;
+        }
+    }
+
+    if (m_cfg.threads == 0U) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        m_cfg.threads = (cpus > 0) ? (uint32_t)cpus : 1U;
+    }
+    if (m_cfg.threads > m_cfg.rings) m_cfg.threads = m_cfg.rings;
+
+    /* Connection interval: 7.5 ms to 4 s in the spec */
+    if (m_cfg.rings == 0U || m_cfg.duration_s == 0U || m_cfg.per_event == 0U ||
+        m_cfg.conn_interval_ms < 8U || m_cfg.conn_interval_ms > 4000U ||
+        m_cfg.detector >= (uint8_t)PEAK_DETECTOR_COUNT) {
+        fprintf(stderr, "nlr_loadgen: option out of range\n");
+        return -1;
+    }
+    return 0;
+}
+
+/** One socket per ring: lift the descriptor limit if the soft one is short */
+static int lg_raise_fd_limit(uint32_t needed)
+{
+    struct rlimit lim;
+
+    if (getrlimit(RLIMIT_NOFILE, &lim) != 0) return -1;
+    if (lim.rlim_cur >= needed) return 0;
+    if (lim.rlim_max != RLIM_INFINITY && lim.rlim_max < needed) return -1;
+    lim.rlim_cur = needed;
+    return setrlimit(RLIMIT_NOFILE, &lim);
+}
+
+typedef struct {
+    uint64_t frames_tx, bytes_tx, rr_tx, beats, queue_drops, send_errors, frames_rx, connects;
+    uint32_t lag_max_ms;
+} lg_totals_t;
+
+static void lg_sum(const lg_worker_t *p_workers, lg_totals_t *p_t)
+{
+    memset(p_t, 0, sizeof(*p_t));
+    for (uint32_t w = 0; w < m_cfg.threads; w++) {
+        const lg_stats_t *s = &p_workers[w].stats;
+        p_t->frames_tx += atomic_load_explicit(&s->frames_tx, memory_order_relaxed);
+        p_t->bytes_tx += atomic_load_explicit(&s->bytes_tx, memory_order_relaxed);
+        p_t->rr_tx += atomic_load_explicit(&s->rr_tx, memory_order_relaxed);
+        p_t->beats += atomic_load_explicit(&s->beats, memory_order_relaxed);
+        p_t->queue_drops += atomic_load_explicit(&s->queue_drops, memory_order_relaxed);
+        p_t->send_errors += atomic_load_explicit(&s->send_errors, memory_order_relaxed);
+        p_t->frames_rx += atomic_load_explicit(&s->frames_rx, memory_order_relaxed);
+        p_t->connects += atomic_load_explicit(&s->connects, memory_order_relaxed);
+        uint32_t lag = (uint32_t)atomic_load_explicit(&s->lag_max_ms, memory_order_relaxed);
+        if (lag > p_t->lag_max_ms) p_t->lag_max_ms = lag;
+    }
+}
+
+/*******************************************************************************
+ * MAIN
+ ******************************************************************************/
+
+int main(int argc, char **argv)
+{
+    if (lg_parse_args(argc, argv) != 0) return 2;
+
+    if (lg_raise_fd_limit(m_cfg.rings + 16U) != 0) {
+        fprintf(stderr, "nlr_loadgen: descriptor limit too low for %u rings (ulimit -n)\n",
+                (unsigned)m_cfg.rings);
+        return 2;
+    }
+
+    ring_t *p_rings = calloc(m_cfg.rings, sizeof(ring_t));
+    lg_worker_t *p_workers = calloc(m_cfg.threads, sizeof(lg_worker_t));
+    if (!p_rings || !p_workers) {
+        fprintf(stderr, "nlr_loadgen: out of memory\n");
+        return 2;
+    }
+
+    for (uint32_t i = 0; i < m_cfg.rings; i++) {
+        if (ring_init(&p_rings[i], i) != 0) {
+            fprintf(stderr, "nlr_loadgen: socket for ring %u: %s\n", (unsigned)i, strerror(errno));
+            return 2;
+        }
+    }
+
+    /* Contiguous slices: a worker's rings share its cache and its timers */
+    clock_gettime(CLOCK_MONOTONIC, &m_start);
+    for (uint32_t w = 0, first = 0; w < m_cfg.threads; w++) {
+        uint32_t n = m_cfg.rings / m_cfg.threads + ((w < m_cfg.rings % m_cfg.threads) ? 1U : 0U);
+        p_workers[w].p_rings = &p_rings[first];
+        p_workers[w].n_rings = n;
+        first += n;
+        if (pthread_create(&p_workers[w].thread, NULL, lg_worker, &p_workers[w]) != 0) {
+            fprintf(stderr, "nlr_loadgen: cannot start worker %u\n", (unsigned)w);
+            return 2;
+        }
+    }
+
+    printf("%u rings on %u threads -> %s:%u, %u ms interval, %u per event%s\n",
+           (unsigned)m_cfg.rings, (unsigned)m_cfg.threads, inet_ntoa(m_cfg.target.sin_addr),
+           (unsigned)ntohs(m_cfg.target.sin_port), (unsigned)m_cfg.conn_interval_ms,
+           (unsigned)m_cfg.per_event, m_cfg.auto_connect ? ", auto-connect" : "");
+
+    lg_totals_t prev = {0}, t;
+    for (uint32_t s = 1; s <= m_cfg.duration_s; s++) {
+        lg_sleep_until(s * 1000U);
+        lg_sum(p_workers, &t);
+        printf("t=%4us  tx %6llu frames/s %8llu B/s  rr %5llu/s  rx %5llu/s  drops %llu  errors %llu  lag max %u ms\n",
+               (unsigned)s,
+               (unsigned long long)(t.frames_tx - prev.frames_tx),
+               (unsigned long long)(t.bytes_tx - prev.bytes_tx),
+               (unsigned long long)(t.rr_tx - prev.rr_tx),
+               (unsigned long long)(t.frames_rx - prev.frames_rx),
+               (unsigned long long)t.queue_drops, (unsigned long long)t.send_errors,
+               (unsigned)t.lag_max_ms);
+        fflush(stdout);
+        prev = t;
+    }
+
+    atomic_store(&m_stop, true);
+    for (uint32_t w = 0; w < m_cfg.threads; w++) {
+        pthread_join(p_workers[w].thread, NULL);
+    }
+
+    lg_sum(p_workers, &t);
+    uint32_t streaming = 0;
+    for (uint32_t i = 0; i < m_cfg.rings; i++) {
+        if (p_rings[i].link == RING_STREAMING) streaming++;
+        close(p_rings[i].fd);
+    }
+
+    printf("total:   %llu frames, %llu bytes, %llu RR, %llu beats detected, %llu connects\n",
+           (unsigned long long)t.frames_tx, (unsigned long long)t.bytes_tx,
+           (unsigned long long)t.rr_tx, (unsigned long long)t.beats, (unsigned long long)t.connects);
+    printf("rings:   %u of %u streaming at exit, %llu queue drops, %llu send errors, lag max %u ms\n",
+           (unsigned)streaming, (unsigned)m_cfg.rings, (unsigned long long)t.queue_drops,
+           (unsigned long long)t.send_errors, (unsigned)t.lag_max_ms);
+
+    free(p_workers);
+    free(p_rings);
+
+    /* Falling behind by more than a connection interval is not real-time */
+    return (t.lag_max_ms > m_cfg.conn_interval_ms) ? 1 : 0;
+}
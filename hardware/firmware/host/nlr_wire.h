@@ -0,0 +1,118 @@
+/**
+ * @file nlr_wire.h
+ * @brief Neural Load Ring Host Wire Format (simulated BLE link)
+ *
+ * The host simulator carries the Wellness Service over UDP on localhost so
+ * a test client (or the phone-side code under test) can play the central.
+ * One datagram = one frame:
+ *
+ *   [type u8][len u8][payload: len bytes]
+ *
+ * Payloads are the GATT characteristic values from ble_stack.h, byte for
+ * byte (packed, little-endian), so what crosses the socket is what would
+ * cross the air.
+ *
+ * The bulk channel (ble_l2cap.h) crosses as its L2CAP signalling and
+ * K-frames: the central opens it with L2CAP_CONNECT, either side sends
+ * K-frames only against credits the other granted, and the ring returns
+ * credits with L2CAP_CREDIT_IND as it consumes frames. An MPS above
+ * NLR_WIRE_MAX_PAYLOAD is clamped to it.
+ *
+ * A ring that knows its central's address (the load generator) announces
+ * itself with ADVERTISE until it receives CONNECT; the single-ring
+ * simulator just listens on its port, and every source address that sends
+ * CONNECT is one more central (up to NLR_BLE_MAX_LINKS).
+ *
+ * A central is known by its source address unless CONNECT carries an
+ * identity address, as a phone with a private address would resolve to
+ * after bonding. PAIR bonds it; when it reconnects under the same
+ * identity its subscriptions come back without SUBSCRIBE, or it gets
+ * SERVICE_CHANGED if the ring's GATT layout moved (ble_bond.h).
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef NLR_WIRE_H
+#define NLR_WIRE_H
+
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NLR_WIRE_PORT_DEFAULT       47100U
+#define NLR_WIRE_HDR_BYTES          2U
+#define NLR_WIRE_MAX_PAYLOAD        244U    /**< ATT MTU 247 - 3 */
+#define NLR_WIRE_MAX_FRAME          (NLR_WIRE_HDR_BYTES + NLR_WIRE_MAX_PAYLOAD)
+
+typedef enum {
+    /* Central -> ring */
+    NLR_WIRE_CONNECT        = 0x01,     /**< Optional u16 ATT MTU, then optional u8[6] identity address */
+    NLR_WIRE_DISCONNECT     = 0x02,     /**< No payload */
+    NLR_WIRE_SUBSCRIBE      = 0x03,     /**< u8: 1 = enable notifications */
+    NLR_WIRE_L2CAP_CONNECT  = 0x04,     /**< u16 PSM, u16 MTU, u16 MPS, u16 credits */
+    NLR_WIRE_L2CAP_DISCONNECT = 0x05,   /**< No payload */
+    NLR_WIRE_L2CAP_CREDIT   = 0x06,     /**< u16 credits */
+    NLR_WIRE_PAIR           = 0x07,     /**< No payload: bond with this central */
+    NLR_WIRE_ACTUATOR_CMD   = 0x10,     /**< nlr_actuator_cmd_t */
+    NLR_WIRE_CONFIG         = 0x11,     /**< nlr_config_t */
+    NLR_WIRE_OTA            = 0x12,     /**< OTA packet (ota_update.h) */
+    NLR_WIRE_L2CAP_KFRAME   = 0x13,     /**< K-frame information payload */
+
+    /* Ring -> central */
+    NLR_WIRE_RR             = 0x80,     /**< u16 RR intervals (ms) */
+    NLR_WIRE_COHERENCE      = 0x81,     /**< nlr_coherence_packet_t */
+    NLR_WIRE_DEVICE_STATE   = 0x82,     /**< nlr_device_state_t */
+    NLR_WIRE_ADVERTISE      = 0x83,     /**< u8[6] device address */
+    NLR_WIRE_OTA_RSP        = 0x84,     /**< OTA response */
+    NLR_WIRE_L2CAP_CONNECT_RSP = 0x85,  /**< u16 result, u16 MTU, u16 MPS, u16 credits */
+    NLR_WIRE_L2CAP_DISCONNECT_IND = 0x86, /**< No payload */
+    NLR_WIRE_L2CAP_CREDIT_IND = 0x87,   /**< u16 credits */
+    NLR_WIRE_L2CAP_KFRAME_IND = 0x88,   /**< K-frame information payload */
+    NLR_WIRE_CONFIG_IND     = 0x89,     /**< nlr_config_t, after any central changes it */
+    NLR_WIRE_PAIR_RSP       = 0x8A,     /**< u8 status (0 = bonded) */
+    NLR_WIRE_SERVICE_CHANGED = 0x8B,    /**< u16 start handle, u16 end handle */
+} nlr_wire_type_t;
+
+/**
+ * @brief Build a frame
+ * @return Frame length, or 0 if the payload does not fit
+ */
+static inline uint16_t nlr_wire_encode(uint8_t *p_frame, uint8_t type,
+                                       const void *p_payload, uint16_t len)
+{
+    if (len > NLR_WIRE_MAX_PAYLOAD) return 0;
+
+    p_frame[0] = type;
+    p_frame[1] = (uint8_t)len;
+    if (len > 0U) {
+        memcpy(&p_frame[NLR_WIRE_HDR_BYTES], p_payload, len);
+    }
+    return (uint16_t)(NLR_WIRE_HDR_BYTES + len);
+}
+
+/**
+ * @brief Split a received frame
+ * @return 0 on success, -1 if truncated
+ */
+static inline int nlr_wire_decode(const uint8_t *p_frame, uint16_t frame_len,
+                                  uint8_t *p_type, const uint8_t **pp_payload,
+                                  uint16_t *p_len)
+{
+    if (frame_len < NLR_WIRE_HDR_BYTES) return -1;
+    if ((uint16_t)(NLR_WIRE_HDR_BYTES + p_frame[1]) > frame_len) return -1;
+
+    *p_type = p_frame[0];
+    *p_len = p_frame[1];
+    *pp_payload = &p_frame[NLR_WIRE_HDR_BYTES];
+    return 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NLR_WIRE_H */
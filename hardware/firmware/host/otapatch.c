@@ -0,0 +1,123 @@
+/**
+ * @file otapatch.c
+ * @brief Neural Load Ring Host Tool - Build a Delta OTA Patch
+ *
+ * Diffs the installed application image against a new build and writes the
+ * patch that system/ota_update.c applies into bank B (format in
+ * ota_update.h, encoder in tests/ota_delta.h). Before writing, the patch is
+ * checked by streaming it through the firmware's own decoder over a host
+ * flash image, exactly as a ring would receive it.
+ *
+ * Usage: nlr_otapatch OLD.bin NEW.bin PATCH.bin
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "ota_delta.h"
+#include "hal/hal.h"
+#include "system/nvm_store.h"
+#include "system/ota_update.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static uint8_t *read_file(const char *p_path, uint32_t *p_len)
+{
+    FILE *f = fopen(p_path, "rb");
+    uint8_t *p_buf = NULL;
+    long len;
+
+    if (f == NULL) return NULL;
+    if (fseek(f, 0, SEEK_END) == 0 && (len = ftell(f)) > 0 && len <= (long)OTA_BANK_SIZE &&
+        fseek(f, 0, SEEK_SET) == 0 && (p_buf = malloc((size_t)len)) != NULL) {
+        if (fread(p_buf, 1, (size_t)len, f) == (size_t)len) {
+            *p_len = (uint32_t)len;
+        } else {
+            free(p_buf);
+            p_buf = NULL;
+        }
+    }
+    fclose(f);
+    return p_buf;
+}
+
+static void load_bank_a(const uint8_t *p_img, uint32_t len)
+{
+    uint32_t words[HAL_FLASH_PAGE_SIZE / 4U];
+
+    for (uint32_t off = 0; off < len; off += HAL_FLASH_PAGE_SIZE) {
+        uint32_t chunk = (len - off < HAL_FLASH_PAGE_SIZE) ? len - off : HAL_FLASH_PAGE_SIZE;
+        memset(words, 0xFF, sizeof(words));
+        memcpy(words, &p_img[off], chunk);
+        hal_flash_erase_page(OTA_BANK_A_ADDR + off);
+        hal_flash_write_words(OTA_BANK_A_ADDR + off, words, (uint16_t)((chunk + 3U) / 4U));
+    }
+}
+
+/** Apply the patch block by block through ota_update; 0 if bank B ends up as p_new */
+static int verify(const uint8_t *p_old, uint32_t old_len, const uint8_t *p_new, uint32_t new_len,
+                  const uint8_t *p_patch, uint32_t patch_len)
+{
+    hal_host_reset();
+    nvm_store_format();
+    ota_update_init();
+    load_bank_a(p_old, old_len);
+
+    if (ota_update_start(patch_len, ota_crc32(0, p_patch, patch_len)) != 0) return -1;
+
+    for (uint32_t off = 0, b = 0; off < patch_len; off += OTA_BLOCK_SIZE, b++) {
+        uint16_t len = (uint16_t)((patch_len - off < OTA_BLOCK_SIZE) ? patch_len - off : OTA_BLOCK_SIZE);
+        int err = ota_update_block((uint16_t)b, &p_patch[off], len, ota_crc32(0, &p_patch[off], len));
+        if (err != 0) return err;
+    }
+    if (ota_update_finish() != 0) return -7;
+    return memcmp(hal_flash_ptr(OTA_BANK_B_ADDR), p_new, new_len) == 0 ? 0 : -7;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t old_len = 0, new_len = 0;
+
+    if (argc != 4) {
+        fprintf(stderr, "usage: nlr_otapatch OLD.bin NEW.bin PATCH.bin\n");
+        return 2;
+    }
+
+    uint8_t *p_old = read_file(argv[1], &old_len);
+    uint8_t *p_new = read_file(argv[2], &new_len);
+    if (p_old == NULL || p_new == NULL) {
+        fprintf(stderr, "nlr_otapatch: cannot read images (1..%u bytes each)\n", (unsigned)OTA_BANK_SIZE);
+        return 1;
+    }
+
+    size_t cap = 2U * OTA_BANK_SIZE;
+    uint8_t *p_patch = malloc(cap);
+    uint32_t patch_len = p_patch ? (uint32_t)ota_delta_encode(p_old, old_len, p_new, new_len, p_patch, cap) : 0U;
+    if (patch_len == 0U) {
+        fprintf(stderr, "nlr_otapatch: patch larger than %u bytes\n", (unsigned)cap);
+        return 1;
+    }
+
+    int err = verify(p_old, old_len, p_new, new_len, p_patch, patch_len);
+    if (err != 0) {
+        fprintf(stderr, "nlr_otapatch: patch does not reproduce the new image (%d)\n", err);
+        return 1;
+    }
+
+    FILE *f = fopen(argv[3], "wb");
+    if (f == NULL || fwrite(p_patch, 1, patch_len, f) != patch_len || fclose(f) != 0) {
+        fprintf(stderr, "nlr_otapatch: cannot write %s\n", argv[3]);
+        return 1;
+    }
+
+    printf("%s -> %s: %u bytes (%.1f%% of %u), %u blocks\n", argv[1], argv[2],
+           (unsigned)patch_len, 100.0 * patch_len / new_len, (unsigned)new_len,
+           (unsigned)((patch_len + OTA_BLOCK_SIZE - 1U) / OTA_BLOCK_SIZE));
+
+    free(p_patch);
+    free(p_new);
+    free(p_old);
+    return 0;
+}
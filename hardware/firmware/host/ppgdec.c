@@ -0,0 +1,119 @@
+/**
+ * @file ppgdec.c
+ * @brief Neural Load Ring Host Tool - Decode a Raw PPG Capture
+ *
+ * Turns a research capture into a "t_ms green ir" text file, the format
+ * nlr_sim --ppg replays, so a session recorded on a ring can be fed back
+ * through the firmware signal chain. The input is what a central logged
+ * from bulk stream 0x03 (sensors/ppg_capture.h), one record per SDU:
+ *
+ *   u16 len        payload length (little-endian)
+ *   ...            SDU payload after the stream byte: capture header + block
+ *
+ * Blocks are decoded with the firmware's own ppg_codec. Lost blocks (gaps
+ * in the sequence) are reported and left out; replay handles the jump in
+ * time. Output values are counts / PPG_ADC_FULL_SCALE, as ppg_driver
+ * hands them to the detector, or raw ADC counts with --counts.
+ *
+ * Usage: nlr_ppgdec [--counts] CAPTURE.bin OUT.txt
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "core/ppg_codec.h"
+#include "sensors/ppg_capture.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** Largest block the header can describe (u8 frame count) */
+#define PPGDEC_MAX_FRAMES   255U
+#define PPGDEC_SDU_MAX      (PPG_CAPTURE_HDR_BYTES + PPG_CODEC_MAX_BYTES(PPGDEC_MAX_FRAMES, PPG_CHANNELS))
+
+int main(int argc, char **argv)
+{
+    static uint8_t sdu[PPGDEC_SDU_MAX];
+    static int32_t frames[PPGDEC_MAX_FRAMES * PPG_CHANNELS];
+    bool counts = false;
+    int arg = 1;
+
+    if (arg < argc && strcmp(argv[arg], "--counts") == 0) {
+        counts = true;
+        arg++;
+    }
+    if (argc - arg != 2) {
+        fprintf(stderr, "usage: %s [--counts] CAPTURE.bin OUT.txt\n", argv[0]);
+        return 2;
+    }
+
+    FILE *in = fopen(argv[arg], "rb");
+    FILE *out = fopen(argv[arg + 1], "w");
+    if (in == NULL || out == NULL) {
+        fprintf(stderr, "cannot open %s\n", (in == NULL) ? argv[arg] : argv[arg + 1]);
+        return 1;
+    }
+    fprintf(out, "# t_ms green ir%s\n", counts ? " (ADC counts)" : "");
+
+    uint32_t blocks = 0, lost = 0, bad = 0, n_frames = 0, coded = 0;
+    uint16_t expect_seq = 0;
+    uint8_t hdr[2];
+
+    while (fread(hdr, 1, sizeof(hdr), in) == sizeof(hdr)) {
+        uint16_t len = (uint16_t)(hdr[0] | (hdr[1] << 8));
+        if (len > sizeof(sdu) || fread(sdu, 1, len, in) != len) {
+            bad++;
+            break;
+        }
+        if (len < PPG_CAPTURE_HDR_BYTES || sdu[7] != PPG_CHANNELS || sdu[6] == 0U) {
+            bad++;
+            continue;
+        }
+
+        uint16_t seq = (uint16_t)(sdu[0] | (sdu[1] << 8));
+        uint32_t t0 = (uint32_t)sdu[2] | ((uint32_t)sdu[3] << 8) | ((uint32_t)sdu[4] << 16) |
+                      ((uint32_t)sdu[5] << 24);
+        uint8_t n = sdu[6];
+
+        int used = ppg_codec_decode(&sdu[PPG_CAPTURE_HDR_BYTES], (uint16_t)(len - PPG_CAPTURE_HDR_BYTES),
+                                    n, PPG_CHANNELS, frames);
+        if (used < 0) {
+            bad++;
+            continue;
+        }
+
+        if (blocks > 0U && seq != expect_seq) {
+            uint16_t gap = (uint16_t)(seq - expect_seq);
+            fprintf(stderr, "t=%u ms: %u block(s) lost\n", (unsigned)t0, (unsigned)gap);
+            lost += gap;
+        }
+        expect_seq = (uint16_t)(seq + 1U);
+        blocks++;
+        n_frames += n;
+        coded += (uint32_t)used;
+
+        for (uint8_t f = 0; f < n; f++) {
+            uint32_t t = t0 + (uint32_t)f * PPG_FRAME_PERIOD_MS;
+            const int32_t *p = &frames[f * PPG_CHANNELS];
+            if (counts) {
+                fprintf(out, "%u %d %d\n", (unsigned)t, (int)p[0], (int)p[1]);
+            } else {
+                fprintf(out, "%u %.9g %.9g\n", (unsigned)t, (double)p[0] / PPG_ADC_FULL_SCALE,
+                        (double)p[1] / PPG_ADC_FULL_SCALE);
+            }
+        }
+    }
+
+    fclose(in);
+    fclose(out);
+
+    uint32_t samples = n_frames * PPG_CHANNELS;
+    printf("%u blocks, %u frames (%.1f s), %u lost, %u bad\n", (unsigned)blocks, (unsigned)n_frames,
+           n_frames * PPG_FRAME_PERIOD_MS / 1000.0, (unsigned)lost, (unsigned)bad);
+    if (samples > 0U) {
+        printf("%.2f bits/sample (%.2fx vs 16-bit)\n", 8.0 * coded / samples,
+               16.0 * samples / (8.0 * coded));
+    }
+    return (bad > 0U) ? 1 : 0;
+}
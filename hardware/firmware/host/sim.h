@@ -0,0 +1,119 @@
+/**
+ * @file sim.h
+ * @brief Neural Load Ring Host Simulator - Internal Interfaces
+ *
+ * The simulator links the unmodified firmware (system/main.c and every
+ * module it calls) against the HAL_BACKEND_HOST_SIM backend. Its pieces:
+ *
+ *   sim_main.c   Virtual clock, HAL hooks, command line, run summary
+ *   sim_plant.c  Heater + skin thermal model, NTC divider, ERM motor
+ *   sim_afe.c    MAX86141 model: synthetic PPG into a FIFO, PPG_INT, SPI
+ *   sim_ble.c    ble_stack.h API over a UDP socket (see nlr_wire.h)
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "hal/hal.h"
+
+/*******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
+
+typedef struct {
+    uint32_t duration_s;        /**< Simulated run time */
+    float speed;                /**< Multiple of real time, 0 = unpaced */
+    uint32_t seed;
+
+    /* PPG source */
+    const char *ppg_file;       /**< Replay "t green [ir]" file instead of the AFE */
+    float hr_bpm;
+    float hrv_sd_ms;
+    int detector;               /**< Beat detector set after boot, -1 = firmware default */
+
+    /* Thermal plant */
+    float ambient_skin_c;       /**< Skin temperature with the heater off */
+
+    /* BLE */
+    uint16_t ble_port;          /**< UDP port, 0 = no socket */
+    bool auto_connect;          /**< Built-in central that subscribes at boot */
+
+    /* Outputs */
+    const char *trace_file;     /**< CSV of actuator and skin samples */
+    const char *flash_file;     /**< NVM image loaded at boot, saved at exit */
+    uint32_t checkpoint_every_s;    /**< Pipeline checkpoint period, 0 = none */
+    const char *checkpoint_dir;     /**< Where ckpt_<ms>.bin files go */
+    const char *resume_file;        /**< Checkpoint to resume from (needs ppg_file) */
+    bool check;                 /**< Exit non-zero if the run looks unhealthy */
+} sim_config_t;
+
+/*******************************************************************************
+ * THERMAL PLANT / MOTOR
+ ******************************************************************************/
+
+void sim_plant_init(const sim_config_t *p_cfg, FILE *p_trace);
+void sim_plant_step(uint32_t now_ms, uint32_t dt_ms);
+void sim_plant_pwm(hal_pwm_t pwm, uint8_t duty_pct);
+uint16_t sim_plant_ntc_adc(void);
+
+typedef struct {
+    float skin_c;
+    float skin_max_c;
+    uint32_t heater_on_ms;
+    uint32_t motor_on_ms;
+    uint32_t motor_changes;
+    uint32_t motor_felt_ms;     /**< ERM above the feel threshold */
+} sim_plant_stats_t;
+
+void sim_plant_get_stats(sim_plant_stats_t *p_stats);
+
+/*******************************************************************************
+ * PPG AFE
+ ******************************************************************************/
+
+void sim_afe_init(const sim_config_t *p_cfg);
+void sim_afe_step(uint32_t now_ms);
+void sim_afe_spi(const uint8_t *p_tx, uint16_t tx_len, uint8_t *p_rx, uint16_t rx_len);
+
+typedef struct {
+    uint32_t frames;            /**< Frames sampled while running */
+    uint32_t interrupts;        /**< PPG_INT edges */
+    uint32_t fifo_overflows;    /**< Samples lost to a full FIFO */
+    uint32_t beats;             /**< True beats in the synthetic signal */
+    uint8_t led_pa[2];
+} sim_afe_stats_t;
+
+void sim_afe_get_stats(sim_afe_stats_t *p_stats);
+
+/*******************************************************************************
+ * BLE LINK
+ ******************************************************************************/
+
+int sim_ble_open(const sim_config_t *p_cfg);
+void sim_ble_close(void);
+
+typedef struct {
+    uint32_t rx_frames;
+    uint32_t tx_frames;
+    uint32_t rr_sent;           /**< RR intervals notified */
+    uint32_t coherence_sent;
+    uint32_t connections;
+    uint32_t l2cap_frames;      /**< Bulk channel K-frames, both ways */
+} sim_ble_stats_t;
+
+void sim_ble_get_stats(sim_ble_stats_t *p_stats);
+
+/*******************************************************************************
+ * FIRMWARE ENTRY
+ ******************************************************************************/
+
+/** system/main.c main(), renamed by the simulator build */
+int nlr_firmware_main(void);
+
+#endif /* SIM_H */
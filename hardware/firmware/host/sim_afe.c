@@ -0,0 +1,192 @@
+/**
+ * @file sim_afe.c
+ * @brief Neural Load Ring Host Simulator - MAX86141 PPG Front End
+ *
+ * Register-level model of the AFE as ppg_driver.c uses it: register writes
+ * over SPI, a 128-sample FIFO of tagged 19-bit counts filled at the frame
+ * rate once the part is out of shutdown, and PPG_INT when FIFO_A_FULL is
+ * reached (re-armed by the next FIFO read). The optical signal comes from
+ * the synthetic generator shared with the host tests; LED drive current
+ * scales each channel, so the driver's LED management has a visible effect.
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "sim.h"
+#include "ppg_synth.h"
+#include <string.h>
+
+/*******************************************************************************
+ * MAX86141 MODEL
+ ******************************************************************************/
+
+#define AFE_REG_INT_ENABLE1     0x02
+#define AFE_REG_FIFO_DATA       0x08
+#define AFE_REG_FIFO_CONFIG1    0x09
+#define AFE_REG_SYS_CONTROL     0x0D
+#define AFE_REG_LED1_PA         0x23
+#define AFE_REG_LED2_PA         0x24
+
+#define AFE_SPI_READ            0x80
+#define AFE_SYS_RESET           0x01
+#define AFE_SYS_SHDN            0x02
+#define AFE_INT_A_FULL          0x80
+#define AFE_FIFO_DEPTH          128U
+#define AFE_TAG_INVALID         0x1EU
+#define AFE_COUNT_MAX           0x7FFFFU
+#define AFE_LED_PA_NOMINAL      0x20U   /**< Drive the synthetic amplitude is scaled to */
+#define AFE_SIGNAL_SCALE        16.0f   /**< Synth output that maps to full scale */
+#define AFE_FRAME_MS            10U
+
+static struct {
+    bool enabled;                   /**< False while a replay file feeds the driver */
+    uint8_t reg[256];
+    uint32_t fifo[AFE_FIFO_DEPTH];  /**< tag << 19 | count */
+    uint8_t fifo_head;
+    uint8_t fifo_count;
+    bool a_full_sent;               /**< INT asserted, waiting for a FIFO read */
+    uint32_t next_frame_ms;
+    ppg_synth_t synth;
+    sim_afe_stats_t stats;
+} m_afe;
+
+static bool afe_running(void)
+{
+    return (m_afe.reg[AFE_REG_SYS_CONTROL] & (AFE_SYS_RESET | AFE_SYS_SHDN)) == 0U;
+}
+
+static void afe_fifo_push(uint8_t tag, uint32_t count)
+{
+    if (m_afe.fifo_count >= AFE_FIFO_DEPTH) {
+        m_afe.stats.fifo_overflows++;
+        return;
+    }
+    uint8_t idx = (uint8_t)((m_afe.fifo_head + m_afe.fifo_count) % AFE_FIFO_DEPTH);
+    m_afe.fifo[idx] = ((uint32_t)tag << 19) | (count & AFE_COUNT_MAX);
+    m_afe.fifo_count++;
+}
+
+static uint32_t afe_fifo_pop(void)
+{
+    if (m_afe.fifo_count == 0U) {
+        return ((uint32_t)AFE_TAG_INVALID << 19) | AFE_COUNT_MAX;
+    }
+    uint32_t s = m_afe.fifo[m_afe.fifo_head];
+    m_afe.fifo_head = (uint8_t)((m_afe.fifo_head + 1U) % AFE_FIFO_DEPTH);
+    m_afe.fifo_count--;
+    return s;
+}
+
+/** Optical signal through the LED drive to ADC counts */
+static uint32_t afe_counts(float signal, uint8_t led_pa)
+{
+    float v = signal / AFE_SIGNAL_SCALE * (float)led_pa / (float)AFE_LED_PA_NOMINAL;
+    float counts = v * (float)(AFE_COUNT_MAX + 1U);
+
+    if (counts < 0.0f) return 0;
+    if (counts > (float)AFE_COUNT_MAX) return AFE_COUNT_MAX;
+    return (uint32_t)counts;
+}
+
+static void afe_sample_frame(void)
+{
+    bool has_peak = false;
+    uint32_t peak_ms;
+    float v = ppg_synth_next(&m_afe.synth, &peak_ms, &has_peak);
+
+    if (has_peak) m_afe.stats.beats++;
+
+    /* LEDC1 green, LEDC2 IR (weaker pulsatile signal at the finger base) */
+    afe_fifo_push(1, afe_counts(v, m_afe.reg[AFE_REG_LED1_PA]));
+    afe_fifo_push(2, afe_counts(0.5f * v, m_afe.reg[AFE_REG_LED2_PA]));
+    m_afe.stats.frames++;
+}
+
+/*******************************************************************************
+ * PUBLIC API
+ ******************************************************************************/
+
+void sim_afe_init(const sim_config_t *p_cfg)
+{
+    memset(&m_afe, 0, sizeof(m_afe));
+    m_afe.enabled = (p_cfg->ppg_file == NULL);
+    m_afe.reg[AFE_REG_SYS_CONTROL] = AFE_SYS_SHDN;
+
+    ppg_synth_params_t p = ppg_synth_defaults();
+    p.hr_bpm = p_cfg->hr_bpm;
+    p.hrv_sd_ms = p_cfg->hrv_sd_ms;
+    p.seed = p_cfg->seed;
+    ppg_synth_init(&m_afe.synth, &p);
+}
+
+void sim_afe_step(uint32_t now_ms)
+{
+    if (!m_afe.enabled) return;
+
+    while ((int32_t)(m_afe.next_frame_ms - now_ms) <= 0) {
+        m_afe.next_frame_ms += AFE_FRAME_MS;
+        if (afe_running()) {
+            afe_sample_frame();
+        }
+    }
+
+    /* FIFO_A_FULL: free slots at or below FIFO_CONFIG1 */
+    uint8_t free_slots = (uint8_t)(AFE_FIFO_DEPTH - m_afe.fifo_count);
+    if ((m_afe.reg[AFE_REG_INT_ENABLE1] & AFE_INT_A_FULL) && !m_afe.a_full_sent &&
+        free_slots <= m_afe.reg[AFE_REG_FIFO_CONFIG1]) {
+        m_afe.a_full_sent = true;
+        m_afe.stats.interrupts++;
+        (void)hal_host_gpio_fire(HAL_PIN_PPG_INT);
+    }
+}
+
+/**
+ * One SPI transaction: [reg][R/W][data...] full duplex, as ppg_driver.c
+ * frames it. Reads return data from the third byte on.
+ */
+void sim_afe_spi(const uint8_t *p_tx, uint16_t tx_len, uint8_t *p_rx, uint16_t rx_len)
+{
+    if (tx_len < 2U) return;
+
+    uint8_t reg = p_tx[0];
+
+    if (p_tx[1] != AFE_SPI_READ) {
+        for (uint16_t i = 2; i < tx_len; i++) {
+            uint8_t r = (uint8_t)(reg + i - 2U);
+            m_afe.reg[r] = p_tx[i];
+            if (r == AFE_REG_SYS_CONTROL && (p_tx[i] & AFE_SYS_RESET)) {
+                memset(m_afe.reg, 0, sizeof(m_afe.reg));
+                m_afe.reg[AFE_REG_SYS_CONTROL] = AFE_SYS_SHDN;
+                m_afe.fifo_count = 0;
+                m_afe.a_full_sent = false;
+            }
+        }
+        return;
+    }
+
+    if (!p_rx || rx_len <= 2U) return;
+    p_rx[0] = 0;
+    p_rx[1] = 0;
+
+    if (reg == AFE_REG_FIFO_DATA) {
+        for (uint16_t i = 2; i + 3U <= rx_len; i += 3U) {
+            uint32_t s = afe_fifo_pop();
+            p_rx[i] = (uint8_t)(s >> 16);
+            p_rx[i + 1U] = (uint8_t)(s >> 8);
+            p_rx[i + 2U] = (uint8_t)s;
+        }
+        m_afe.a_full_sent = false;
+    } else {
+        for (uint16_t i = 2; i < rx_len; i++) {
+            p_rx[i] = m_afe.reg[(uint8_t)(reg + i - 2U)];
+        }
+    }
+}
+
+void sim_afe_get_stats(sim_afe_stats_t *p_stats)
+{
+    *p_stats = m_afe.stats;
+    p_stats->led_pa[0] = m_afe.reg[AFE_REG_LED1_PA];
+    p_stats->led_pa[1] = m_afe.reg[AFE_REG_LED2_PA];
+}
@@ -0,0 +1,379 @@
+/**
+ * @file sim_ble.c
+ * @brief Neural Load Ring Host Simulator - BLE Link over UDP
+ *
+ * Implements the ble_stack.c host link (NLR_BLE_HOST_LINK): the real stack
+ * runs unchanged above it, and each nlr_wire.h datagram stands for one
+ * radio event. Each client address that sends CONNECT becomes one more
+ * central (up to NLR_BLE_MAX_LINKS), on the connection handle the stack
+ * hands out; only connected addresses may send anything else, and each
+ * link's notifications go back to its own address.
+ *
+ * The bulk channel's K-frames and credits travel as their own frames; the
+ * stack does the segmentation and credit accounting (ble_l2cap.c) that
+ * the SoftDevice does on target.
+ *
+ * With --auto-connect a built-in central connects and subscribes at boot,
+ * so streaming runs without a client (notifications are counted, not
+ * sent); it holds one of the links.
+ *
+ * CONNECT may carry an identity address, so a client can reconnect as the
+ * same bonded central from a new port.
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "sim.h"
+#include "nlr_wire.h"
+#include "bluetooth/ble_stack.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#define LINK_POLL_MAX           16      /**< Datagrams handled per nlr_ble_process() */
+#define LINK_MTU                247U
+#define HCI_REMOTE_USER_TERMINATED  0x13
+#define HCI_LOCAL_HOST_TERMINATED   0x16
+
+static const uint16_t NOTIFY_UUIDS[] = {
+    NLR_UUID_CHAR_RR_INTERVAL,
+    NLR_UUID_CHAR_COHERENCE,
+    NLR_UUID_CHAR_DEVICE_STATE,
+    NLR_UUID_CHAR_CONFIG,
+    NLR_UUID_CHAR_OTA,
+};
+
+#define NUM_NOTIFY_UUIDS (sizeof(NOTIFY_UUIDS) / sizeof(NOTIFY_UUIDS[0]))
+
+/*******************************************************************************
+ * PRIVATE DATA
+ ******************************************************************************/
+
+/** One central, indexed by its connection handle */
+typedef struct {
+    struct sockaddr_in addr;
+    bool active;
+    bool has_addr;                  /**< False for the built-in auto central */
+} link_peer_t;
+
+static struct {
+    int fd;
+    link_peer_t peers[NLR_BLE_MAX_LINKS];
+    uint8_t service_changed[NLR_BLE_MAX_LINKS][4];  /**< Raised while connecting, sent after */
+    bool service_changed_pending[NLR_BLE_MAX_LINKS];
+    bool auto_pending;
+    sim_ble_stats_t stats;
+} m_link = { .fd = -1 };
+
+static void link_send(uint16_t conn, uint8_t type, const void *p_payload, uint16_t len)
+{
+    uint8_t frame[NLR_WIRE_MAX_FRAME];
+    uint16_t n = nlr_wire_encode(frame, type, p_payload, len);
+
+    if (m_link.fd < 0 || conn >= NLR_BLE_MAX_LINKS || !m_link.peers[conn].has_addr || n == 0U) {
+        return;
+    }
+
+    if (sendto(m_link.fd, frame, n, 0, (const struct sockaddr *)&m_link.peers[conn].addr,
+               sizeof(m_link.peers[conn].addr)) == (ssize_t)n) {
+        m_link.stats.tx_frames++;
+    }
+}
+
+/** Connection handle of a connected client address, or NLR_BLE_MAX_LINKS */
+static uint16_t link_peer_find(const struct sockaddr_in *p_from)
+{
+    for (uint16_t i = 0; i < NLR_BLE_MAX_LINKS; i++) {
+        const link_peer_t *p_peer = &m_link.peers[i];
+        if (p_peer->active && p_peer->has_addr &&
+            p_peer->addr.sin_addr.s_addr == p_from->sin_addr.s_addr &&
+            p_peer->addr.sin_port == p_from->sin_port) {
+            return i;
+        }
+    }
+    return NLR_BLE_MAX_LINKS;
+}
+
+static void link_peer_drop(uint16_t conn)
+{
+    if (conn < NLR_BLE_MAX_LINKS) {
+        memset(&m_link.peers[conn], 0, sizeof(m_link.peers[conn]));
+        m_link.service_changed_pending[conn] = false;
+    }
+}
+
+/** Send a Service Changed the stack raised before the link had an address */
+static void link_service_changed_flush(uint16_t conn)
+{
+    if (m_link.service_changed_pending[conn] && m_link.peers[conn].active) {
+        m_link.service_changed_pending[conn] = false;
+        link_send(conn, NLR_WIRE_SERVICE_CHANGED, m_link.service_changed[conn],
+                  sizeof(m_link.service_changed[conn]));
+    }
+}
+
+static void link_subscribe_all(uint16_t conn, bool enable)
+{
+    for (uint8_t i = 0; i < NUM_NOTIFY_UUIDS; i++) {
+        nlr_ble_host_subscribe(conn, NOTIFY_UUIDS[i], enable);
+    }
+}
+
+static uint16_t link_u16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static void link_on_frame(const uint8_t *p_frame, uint16_t n, const struct sockaddr_in *p_from)
+{
+    uint8_t type;
+    const uint8_t *p_payload;
+    uint16_t len;
+    uint16_t conn = link_peer_find(p_from);
+
+    if (nlr_wire_decode(p_frame, n, &type, &p_payload, &len) != 0) return;
+
+    /* Anyone may connect; only connected centrals may say anything else */
+    if (conn == NLR_BLE_MAX_LINKS && type != NLR_WIRE_CONNECT) return;
+    m_link.stats.rx_frames++;
+
+    switch (type) {
+        case NLR_WIRE_CONNECT:
+        {
+            if (conn != NLR_BLE_MAX_LINKS) break;
+
+            /* Peer address: the identity address if given, else IPv4
+             * address and port stand in for the BD_ADDR */
+            uint8_t addr[6];
+            memcpy(&addr[0], &p_from->sin_addr.s_addr, 4);
+            memcpy(&addr[4], &p_from->sin_port, 2);
+            if (len >= 8U) memcpy(addr, &p_payload[2], sizeof(addr));
+            uint16_t mtu = (len >= 2U) ? (uint16_t)(p_payload[0] | (p_payload[1] << 8)) : LINK_MTU;
+
+            conn = nlr_ble_host_connected(addr, mtu);
+            if (conn >= NLR_BLE_MAX_LINKS) break;   /* Every link taken */
+            m_link.peers[conn] = (link_peer_t){ .addr = *p_from, .active = true, .has_addr = true };
+            m_link.stats.connections++;
+            link_service_changed_flush(conn);
+            break;
+        }
+
+        case NLR_WIRE_DISCONNECT:
+            nlr_ble_host_disconnected(conn, HCI_REMOTE_USER_TERMINATED);
+            link_peer_drop(conn);
+            break;
+
+        case NLR_WIRE_PAIR:
+            nlr_ble_host_pair(conn);
+            break;
+
+        case NLR_WIRE_SUBSCRIBE:
+            link_subscribe_all(conn, (len == 0U) || (p_payload[0] != 0U));
+            break;
+
+        case NLR_WIRE_ACTUATOR_CMD:
+            nlr_ble_host_write(conn, NLR_UUID_CHAR_ACTUATOR_CTRL, p_payload, len);
+            break;
+
+        case NLR_WIRE_CONFIG:
+            nlr_ble_host_write(conn, NLR_UUID_CHAR_CONFIG, p_payload, len);
+            break;
+
+        case NLR_WIRE_OTA:
+            nlr_ble_host_write(conn, NLR_UUID_CHAR_OTA, p_payload, len);
+            break;
+
+        case NLR_WIRE_L2CAP_CONNECT:
+        {
+            if (len < 8U) break;
+            uint16_t mps = link_u16(&p_payload[4]);
+            if (mps > NLR_WIRE_MAX_PAYLOAD) mps = NLR_WIRE_MAX_PAYLOAD;
+            nlr_ble_host_l2cap_request(conn, link_u16(&p_payload[0]), link_u16(&p_payload[2]), mps,
+                                       link_u16(&p_payload[6]));
+            break;
+        }
+
+        case NLR_WIRE_L2CAP_DISCONNECT:
+            nlr_ble_host_l2cap_released(conn);
+            break;
+
+        case NLR_WIRE_L2CAP_CREDIT:
+            if (len >= 2U) nlr_ble_host_l2cap_credited(conn, link_u16(p_payload));
+            break;
+
+        case NLR_WIRE_L2CAP_KFRAME:
+            m_link.stats.l2cap_frames++;
+            nlr_ble_host_l2cap_received(conn, p_payload, len);
+            break;
+
+        default:
+            break;
+    }
+}
+
+/*******************************************************************************
+ * HOST LINK HOOKS (ble_stack.h)
+ ******************************************************************************/
+
+void nlr_ble_host_poll(void)
+{
+    if (m_link.auto_pending) {
+        static const uint8_t auto_addr[6] = { 0x01, 0x00, 0x00, 0x7F, 0x4E, 0x4C };
+        m_link.auto_pending = false;
+        uint16_t conn = nlr_ble_host_connected(auto_addr, LINK_MTU);
+        if (conn < NLR_BLE_MAX_LINKS) {
+            m_link.peers[conn].active = true;
+            m_link.stats.connections++;
+            link_service_changed_flush(conn);
+            link_subscribe_all(conn, true);
+        }
+    }
+
+    if (m_link.fd < 0) return;
+
+    for (uint8_t i = 0; i < LINK_POLL_MAX; i++) {
+        uint8_t frame[NLR_WIRE_MAX_FRAME];
+        struct sockaddr_in from;
+        socklen_t from_len = sizeof(from);
+        ssize_t n = recvfrom(m_link.fd, frame, sizeof(frame), 0,
+                             (struct sockaddr *)&from, &from_len);
+        if (n <= 0) break;
+        link_on_frame(frame, (uint16_t)n, &from);
+    }
+}
+
+int nlr_ble_host_notify(uint16_t conn_handle, uint16_t char_uuid, const uint8_t *p_data, uint16_t len)
+{
+    uint8_t type;
+
+    switch (char_uuid) {
+        case NLR_UUID_CHAR_RR_INTERVAL:
+            type = NLR_WIRE_RR;
+            m_link.stats.rr_sent += len / 2U;
+            break;
+        case NLR_UUID_CHAR_COHERENCE:
+            type = NLR_WIRE_COHERENCE;
+            m_link.stats.coherence_sent++;
+            break;
+        case NLR_UUID_CHAR_DEVICE_STATE:
+            type = NLR_WIRE_DEVICE_STATE;
+            break;
+        case NLR_UUID_CHAR_CONFIG:
+            type = NLR_WIRE_CONFIG_IND;
+            break;
+        case NLR_UUID_CHAR_OTA:
+            type = NLR_WIRE_OTA_RSP;
+            break;
+        default:
+            return -1;
+    }
+
+    link_send(conn_handle, type, p_data, len);
+    return 0;
+}
+
+void nlr_ble_host_disconnect(uint16_t conn_handle)
+{
+    link_send(conn_handle, NLR_WIRE_DISCONNECT, NULL, 0);
+    link_peer_drop(conn_handle);
+    nlr_ble_host_disconnected(conn_handle, HCI_LOCAL_HOST_TERMINATED);
+}
+
+void nlr_ble_host_paired(uint16_t conn_handle, uint8_t status)
+{
+    link_send(conn_handle, NLR_WIRE_PAIR_RSP, &status, 1);
+}
+
+void nlr_ble_host_service_changed(uint16_t conn_handle, uint16_t start_handle, uint16_t end_handle)
+{
+    if (conn_handle >= NLR_BLE_MAX_LINKS) return;
+
+    uint8_t *p = m_link.service_changed[conn_handle];
+    p[0] = (uint8_t)(start_handle & 0xFF);
+    p[1] = (uint8_t)(start_handle >> 8);
+    p[2] = (uint8_t)(end_handle & 0xFF);
+    p[3] = (uint8_t)(end_handle >> 8);
+    m_link.service_changed_pending[conn_handle] = true;
+    link_service_changed_flush(conn_handle);
+}
+
+void nlr_ble_host_l2cap_setup(uint16_t conn_handle, uint16_t result, uint16_t mtu, uint16_t mps,
+                              uint16_t credits)
+{
+    const uint16_t rsp[4] = { result, mtu, mps, credits };
+    uint8_t payload[8];
+
+    for (uint8_t i = 0; i < 4U; i++) {
+        payload[2 * i] = (uint8_t)(rsp[i] & 0xFF);
+        payload[2 * i + 1] = (uint8_t)(rsp[i] >> 8);
+    }
+    link_send(conn_handle, NLR_WIRE_L2CAP_CONNECT_RSP, payload, sizeof(payload));
+}
+
+void nlr_ble_host_l2cap_send(uint16_t conn_handle, const uint8_t *p_frame, uint16_t len)
+{
+    m_link.stats.l2cap_frames++;
+    link_send(conn_handle, NLR_WIRE_L2CAP_KFRAME_IND, p_frame, len);
+}
+
+void nlr_ble_host_l2cap_credit(uint16_t conn_handle, uint16_t credits)
+{
+    const uint8_t payload[2] = { (uint8_t)(credits & 0xFF), (uint8_t)(credits >> 8) };
+    link_send(conn_handle, NLR_WIRE_L2CAP_CREDIT_IND, payload, sizeof(payload));
+}
+
+void nlr_ble_host_l2cap_release(uint16_t conn_handle)
+{
+    link_send(conn_handle, NLR_WIRE_L2CAP_DISCONNECT_IND, NULL, 0);
+}
+
+/*******************************************************************************
+ * PUBLIC API
+ ******************************************************************************/
+
+int sim_ble_open(const sim_config_t *p_cfg)
+{
+    memset(&m_link, 0, sizeof(m_link));
+    m_link.fd = -1;
+    m_link.auto_pending = p_cfg->auto_connect;
+
+    if (p_cfg->ble_port == 0U) return 0;
+
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) return -1;
+
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons(p_cfg->ble_port),
+        .sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+    };
+    if (bind(fd, (const struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    m_link.fd = fd;
+    return 0;
+}
+
+void sim_ble_close(void)
+{
+    if (m_link.fd >= 0) {
+        close(m_link.fd);
+        m_link.fd = -1;
+    }
+}
+
+void sim_ble_get_stats(sim_ble_stats_t *p_stats)
+{
+    *p_stats = m_link.stats;
+}
@@ -0,0 +1,441 @@
+/**
+ * @file sim_main.c
+ * @brief Neural Load Ring Host Simulator - Virtual Clock and Entry Point
+ *
+ * Runs the firmware's own main loop on Linux. Time only passes when the
+ * firmware idles: hal_sleep_ms() lands in hal_sim_sleep_ms(), which moves
+ * the virtual RTC, steps the thermal plant and the AFE (which may raise
+ * PPG_INT), completes bus transfers, and optionally paces against the
+ * wall clock. Unpaced, a simulated hour takes seconds.
+ *
+ * Usage: nlr_sim [options]
+ *   --duration S      Simulated seconds (default 300)
+ *   --speed X         Run at X times real time (default 0 = unpaced)
+ *   --hr BPM          Synthetic heart rate (default 65)
+ *   --hrv MS          Beat-to-beat SD (default 25)
+ *   --seed N          Synthetic signal seed
+ *   --ppg FILE        Replay a "t_ms green [ir]" file instead of the AFE
+ *   --detector ID     Beat detector (0 Pan-Tompkins, 1 SSF, 2 Elgendi), as
+ *                     if set over BLE right after boot
+ *   --ambient C       Skin temperature with the heater off (default 33)
+ *   --ble-port N      UDP port for the BLE link (default 47100, 0 = none)
+ *   --auto-connect    Built-in central connects and subscribes at boot
+ *   --trace FILE      CSV of heater/motor duty and skin temperature
+ *   --flash FILE      NVM image: loaded at boot if present, saved at exit
+ *   --checkpoint-every S  Save the pipeline state every S simulated seconds
+ *                     as DIR/ckpt_<ms>.bin (see system/checkpoint.h)
+ *   --checkpoint-dir DIR  Directory for checkpoints (default ".")
+ *   --resume FILE     Restore a checkpoint after boot and continue the --ppg
+ *                     replay from its time; --duration counts from there.
+ *                     The thermal plant, BLE link and main loop timers start
+ *                     fresh; pass the matching --flash image for NVM records
+ *   --check           Exit 1 unless beats were tracked with no data loss
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "sim.h"
+#include "nlr_wire.h"
+#include "system/bus_manager.h"
+#include "sensors/ppg_driver.h"
+#include "core/wellness_manager.h"
+#include "core/peak_detector.h"
+#include "core/wellness_processor.h"
+#include "wellness_feedback/thermal_feature.h"
+#include "system/checkpoint.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define SIM_CHECK_RR_TOLERANCE  0.10f   /**< Mean RR within 10 % of the synthetic HR */
+#define SIM_REPLAY_TAIL_MS      1000U   /**< Keep running after the file ends */
+
+/*******************************************************************************
+ * PRIVATE DATA
+ ******************************************************************************/
+
+static sim_config_t m_cfg = {
+    .duration_s = 300,
+    .speed = 0.0f,
+    .seed = 12345U,
+    .hr_bpm = 65.0f,
+    .hrv_sd_ms = 25.0f,
+    .detector = -1,
+    .ambient_skin_c = 33.0f,
+    .ble_port = NLR_WIRE_PORT_DEFAULT,
+};
+
+static struct {
+    uint32_t now_ms;
+    uint32_t start_ms;          /**< Resume point, 0 from boot */
+    uint32_t end_ms;
+    uint32_t next_checkpoint_ms;
+    uint32_t checkpoints;
+    bool running;
+    bool booted;
+    bool bus_pending[HAL_BUS_COUNT];
+    struct timespec wall_start;
+} m_sim;
+
+static double sim_wall_s(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double)(t.tv_sec - m_sim.wall_start.tv_sec) +
+           (double)(t.tv_nsec - m_sim.wall_start.tv_nsec) / 1e9;
+}
+
+/** Sleep until the wall clock catches up with virtual time / speed */
+static void sim_pace(void)
+{
+    double ahead_s = (double)m_sim.now_ms / 1000.0 / (double)m_cfg.speed - sim_wall_s();
+
+    if (ahead_s > 0.0) {
+        struct timespec d = {
+            .tv_sec = (time_t)ahead_s,
+            .tv_nsec = (long)((ahead_s - (double)(time_t)ahead_s) * 1e9),
+        };
+        nanosleep(&d, NULL);
+    }
+}
+
+/** First idle: firmware init has run, attach the replay and apply overrides */
+static void sim_on_boot(void)
+{
+    m_sim.booted = true;
+    if (m_cfg.detector >= 0) {
+        (void)wellness_set_detector((uint8_t)m_cfg.detector);
+    }
+    if (m_cfg.ppg_file && ppg_replay_open(m_cfg.ppg_file) != 0) {
+        fprintf(stderr, "nlr_sim: cannot open %s\n", m_cfg.ppg_file);
+        m_sim.running = false;
+    }
+}
+
+/*******************************************************************************
+ * CHECKPOINTS
+ ******************************************************************************/
+
+/** Save after the pass at now_ms; resuming runs the next pass one period later */
+static void sim_checkpoint_write(void)
+{
+    static uint8_t *s_image;
+    uint32_t len;
+    char path[512];
+
+    if (!s_image) s_image = malloc(checkpoint_size());
+    if (!s_image || checkpoint_save(m_sim.now_ms, s_image, checkpoint_size(), &len) != 0) return;
+
+    (void)snprintf(path, sizeof(path), "%s/ckpt_%010u.bin",
+                   m_cfg.checkpoint_dir ? m_cfg.checkpoint_dir : ".", (unsigned)m_sim.now_ms);
+    FILE *f = fopen(path, "wb");
+    if (!f || fwrite(s_image, 1, len, f) != len) {
+        fprintf(stderr, "nlr_sim: cannot write %s\n", path);
+    } else {
+        m_sim.checkpoints++;
+    }
+    if (f) fclose(f);
+}
+
+static int sim_resume(uint32_t period_ms)
+{
+    FILE *f = fopen(m_cfg.resume_file, "rb");
+    uint32_t cap = checkpoint_size();
+    uint8_t *p_image = malloc(cap + 1U);
+    uint32_t t_ms = 0;
+    int err = -1;
+
+    if (f && p_image) {
+        size_t len = fread(p_image, 1, cap + 1U, f);
+        err = checkpoint_restore(p_image, (uint32_t)len, &t_ms);
+    }
+    if (f) fclose(f);
+    free(p_image);
+    if (err != 0) {
+        fprintf(stderr, "nlr_sim: cannot resume from %s (%d)\n", m_cfg.resume_file, err);
+        return -1;
+    }
+
+    (void)ppg_replay_seek(t_ms);
+    m_sim.now_ms = m_sim.start_ms = t_ms + period_ms;
+    m_sim.end_ms = m_sim.start_ms + m_cfg.duration_s * 1000U;
+    hal_host_set_time_ms(m_sim.now_ms);
+    return 0;
+}
+
+/*******************************************************************************
+ * HAL HOOKS (hal_sim.h)
+ ******************************************************************************/
+
+void hal_sim_pwm_changed(hal_pwm_t pwm, uint8_t duty_pct)
+{
+    sim_plant_pwm(pwm, duty_pct);
+}
+
+uint16_t hal_sim_adc_sample(hal_adc_t ch)
+{
+    return (ch == HAL_ADC_NTC) ? sim_plant_ntc_adc() : (uint16_t)((HAL_ADC_MAX + 1U) / 2U);
+}
+
+/**
+ * A transfer went on the wire. Device side effects happen now; END is
+ * delivered from the next idle, never from inside the scheduler.
+ */
+void hal_sim_bus_start(hal_bus_t bus, uint8_t address,
+                       const uint8_t *p_tx, uint16_t tx_len,
+                       uint8_t *p_rx, uint16_t rx_len)
+{
+    if (bus == HAL_BUS_SPIM0 && address == HAL_PIN_PPG_CS) {
+        sim_afe_spi(p_tx, tx_len, p_rx, rx_len);
+    }
+    m_sim.bus_pending[bus] = true;
+}
+
+uint32_t hal_sim_loop_start_ms(uint32_t period_ms)
+{
+    if (!m_sim.booted) {
+        sim_on_boot();
+    }
+    if (m_sim.running && m_cfg.resume_file && sim_resume(period_ms) != 0) {
+        m_sim.running = false;
+    }
+    if (m_cfg.checkpoint_every_s > 0U) {
+        /* On multiples of the period, so a resumed run rewrites the same files */
+        uint32_t every_ms = m_cfg.checkpoint_every_s * 1000U;
+        m_sim.next_checkpoint_ms = (m_sim.now_ms / every_ms + 1U) * every_ms;
+    }
+    return m_sim.now_ms;
+}
+
+void hal_sim_sleep_ms(uint32_t ms)
+{
+    if (!m_sim.booted) {
+        sim_on_boot();
+    }
+    if (m_cfg.checkpoint_every_s > 0U && (int32_t)(m_sim.now_ms - m_sim.next_checkpoint_ms) >= 0) {
+        sim_checkpoint_write();
+        m_sim.next_checkpoint_ms += m_cfg.checkpoint_every_s * 1000U;
+    }
+
+    /* Transfers started during the loop complete while the CPU sleeps */
+    for (uint8_t b = 0; b < HAL_BUS_COUNT; b++) {
+        while (m_sim.bus_pending[b]) {
+            m_sim.bus_pending[b] = false;
+            (void)bus_mock_drain((bus_id_t)b);
+        }
+    }
+
+    m_sim.now_ms += ms;
+    hal_host_set_time_ms(m_sim.now_ms);
+    sim_plant_step(m_sim.now_ms, ms);
+    sim_afe_step(m_sim.now_ms);
+
+    for (uint8_t b = 0; b < HAL_BUS_COUNT; b++) {
+        while (m_sim.bus_pending[b]) {
+            m_sim.bus_pending[b] = false;
+            (void)bus_mock_drain((bus_id_t)b);
+        }
+    }
+
+    if (m_cfg.speed > 0.0f) {
+        sim_pace();
+    }
+
+    if ((int32_t)(m_sim.now_ms - m_sim.end_ms) >= 0) {
+        m_sim.running = false;
+    }
+    if (m_cfg.ppg_file && ppg_replay_done() && m_sim.end_ms - m_sim.now_ms > SIM_REPLAY_TAIL_MS) {
+        m_sim.end_ms = m_sim.now_ms + SIM_REPLAY_TAIL_MS;
+    }
+}
+
+bool hal_sim_running(void)
+{
+    return m_sim.running;
+}
+
+/*******************************************************************************
+ * COMMAND LINE / FLASH IMAGE
+ ******************************************************************************/
+
+static int sim_parse_args(int argc, char **argv)
+{
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        const char *v = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(a, "--auto-connect") == 0) { m_cfg.auto_connect = true; continue; }
+        if (strcmp(a, "--check") == 0) { m_cfg.check = true; continue; }
+        if (!v) {
+            fprintf(stderr, "nlr_sim: bad or incomplete option %s\n", a);
+            return -1;
+        }
+        i++;
+
+        if (strcmp(a, "--duration") == 0)      m_cfg.duration_s = (uint32_t)strtoul(v, NULL, 0);
+        else if (strcmp(a, "--speed") == 0)    m_cfg.speed = strtof(v, NULL);
+        else if (strcmp(a, "--hr") == 0)       m_cfg.hr_bpm = strtof(v, NULL);
+        else if (strcmp(a, "--hrv") == 0)      m_cfg.hrv_sd_ms = strtof(v, NULL);
+        else if (strcmp(a, "--seed") == 0)     m_cfg.seed = (uint32_t)strtoul(v, NULL, 0);
+        else if (strcmp(a, "--ppg") == 0)      m_cfg.ppg_file = v;
+        else if (strcmp(a, "--detector") == 0) m_cfg.detector = (int)strtol(v, NULL, 0);
+        else if (strcmp(a, "--ambient") == 0)  m_cfg.ambient_skin_c = strtof(v, NULL);
+        else if (strcmp(a, "--ble-port") == 0) m_cfg.ble_port = (uint16_t)strtoul(v, NULL, 0);
+        else if (strcmp(a, "--trace") == 0)    m_cfg.trace_file = v;
+        else if (strcmp(a, "--flash") == 0)    m_cfg.flash_file = v;
+        else if (strcmp(a, "--checkpoint-every") == 0) m_cfg.checkpoint_every_s = (uint32_t)strtoul(v, NULL, 0);
+        else if (strcmp(a, "--checkpoint-dir") == 0)   m_cfg.checkpoint_dir = v;
+        else if (strcmp(a, "--resume") == 0)   m_cfg.resume_file = v;
+        else {
+            fprintf(stderr, "nlr_sim: unknown option %s\n", a);
+            return -1;
+        }
+    }
+
+    if (m_cfg.duration_s == 0U || m_cfg.duration_s > UINT32_MAX / 1000U ||
+        m_cfg.hr_bpm < 30.0f || m_cfg.hr_bpm > 200.0f || m_cfg.speed < 0.0f ||
+        m_cfg.detector < -1 || m_cfg.detector >= (int)PEAK_DETECTOR_COUNT) {
+        fprintf(stderr, "nlr_sim: option out of range\n");
+        return -1;
+    }
+    if (m_cfg.resume_file && !m_cfg.ppg_file) {
+        fprintf(stderr, "nlr_sim: --resume needs the --ppg recording it was taken from\n");
+        return -1;
+    }
+    if (m_cfg.checkpoint_every_s > UINT32_MAX / 1000U) {
+        fprintf(stderr, "nlr_sim: option out of range\n");
+        return -1;
+    }
+    return 0;
+}
+
+static void sim_flash_load(void)
+{
+    FILE *f = m_cfg.flash_file ? fopen(m_cfg.flash_file, "rb") : NULL;
+    if (!f) return;
+
+    if (fread(g_hal_host.flash, 1, HAL_FLASH_SIZE, f) != HAL_FLASH_SIZE) {
+        fprintf(stderr, "nlr_sim: short flash image, erasing\n");
+        memset(g_hal_host.flash, 0xFF, HAL_FLASH_SIZE);
+    }
+    fclose(f);
+}
+
+static void sim_flash_save(void)
+{
+    FILE *f = m_cfg.flash_file ? fopen(m_cfg.flash_file, "wb") : NULL;
+    if (!f) return;
+
+    (void)fwrite(g_hal_host.flash, 1, HAL_FLASH_SIZE, f);
+    fclose(f);
+}
+
+/*******************************************************************************
+ * SUMMARY
+ ******************************************************************************/
+
+static int sim_report(double wall_s)
+{
+    sim_plant_stats_t plant;
+    sim_afe_stats_t afe;
+    sim_ble_stats_t ble;
+    const hr_metrics_t *m = wellness_manager_get_metrics();
+    hr_readout_t readout;
+    int status = 0;
+
+    biometrics_readout(m, &readout);
+    sim_plant_get_stats(&plant);
+    sim_afe_get_stats(&afe);
+    sim_ble_get_stats(&ble);
+
+    double sim_s = (m_sim.now_ms - m_sim.start_ms) / 1000.0;
+
+    printf("simulated %.1f s in %.2f s wall (%.0fx real time)\n",
+           sim_s, wall_s, (wall_s > 0.0) ? sim_s / wall_s : 0.0);
+    if (m_sim.start_ms != 0U || m_sim.checkpoints != 0U) {
+        printf("resume:  from %.1f s, %u checkpoints written\n",
+               m_sim.start_ms / 1000.0, (unsigned)m_sim.checkpoints);
+    }
+    printf("ppg:     %u frames, %u INT, %u FIFO overflows, %u driver overruns, LED PA %u/%u\n",
+           (unsigned)afe.frames, (unsigned)afe.interrupts, (unsigned)afe.fifo_overflows,
+           (unsigned)ppg_get_overruns(), afe.led_pa[0], afe.led_pa[1]);
+    printf("beats:   %u true, %u accepted, mean RR %.0f ms, RMSSD %.1f ms, stress %.2f\n",
+           (unsigned)afe.beats, (unsigned)m->valid_samples, (double)readout.mean_rr_ms,
+           (double)readout.rmssd_ms, (double)readout.stress);
+    printf("thermal: skin %.1f C (max %.1f C), heater on %.1f s, state %d\n",
+           (double)plant.skin_c, (double)plant.skin_max_c, plant.heater_on_ms / 1000.0,
+           (int)thermal_feature_get_state());
+    printf("motor:   on %.1f s, felt %.1f s, %u duty changes\n",
+           plant.motor_on_ms / 1000.0, plant.motor_felt_ms / 1000.0, (unsigned)plant.motor_changes);
+    printf("ble:     %u connections, %u RR notified, %u coherence, %u frames in, %u out, "
+           "%u L2CAP K-frames\n",
+           (unsigned)ble.connections, (unsigned)ble.rr_sent, (unsigned)ble.coherence_sent,
+           (unsigned)ble.rx_frames, (unsigned)ble.tx_frames, (unsigned)ble.l2cap_frames);
+
+    if (!m_cfg.check) return 0;
+
+    if (ppg_get_overruns() != 0U || afe.fifo_overflows != 0U) {
+        fprintf(stderr, "check: PPG data lost\n");
+        status = 1;
+    }
+    if (m->valid_samples == 0U) {
+        fprintf(stderr, "check: no beats accepted\n");
+        status = 1;
+    }
+    if (!m_cfg.ppg_file) {
+        float expect_rr = 60000.0f / m_cfg.hr_bpm;
+        if (readout.mean_rr_ms < expect_rr * (1.0f - SIM_CHECK_RR_TOLERANCE) ||
+            readout.mean_rr_ms > expect_rr * (1.0f + SIM_CHECK_RR_TOLERANCE)) {
+            fprintf(stderr, "check: mean RR %.0f ms, expected %.0f ms\n",
+                    (double)readout.mean_rr_ms, (double)expect_rr);
+            status = 1;
+        }
+    }
+    if (m_cfg.auto_connect && ble.rr_sent == 0U) {
+        fprintf(stderr, "check: no RR notifications\n");
+        status = 1;
+    }
+    return status;
+}
+
+/*******************************************************************************
+ * MAIN
+ ******************************************************************************/
+
+int main(int argc, char **argv)
+{
+    if (sim_parse_args(argc, argv) != 0) return 2;
+
+    FILE *trace = m_cfg.trace_file ? fopen(m_cfg.trace_file, "w") : NULL;
+    if (m_cfg.trace_file && !trace) {
+        fprintf(stderr, "nlr_sim: cannot write %s\n", m_cfg.trace_file);
+        return 2;
+    }
+
+    hal_host_reset();
+    sim_flash_load();
+    sim_plant_init(&m_cfg, trace);
+    sim_afe_init(&m_cfg);
+    if (sim_ble_open(&m_cfg) != 0) {
+        fprintf(stderr, "nlr_sim: cannot bind UDP port %u\n", m_cfg.ble_port);
+        return 2;
+    }
+
+    m_sim.end_ms = m_cfg.duration_s * 1000U;
+    m_sim.running = true;
+    clock_gettime(CLOCK_MONOTONIC, &m_sim.wall_start);
+
+    (void)nlr_firmware_main();
+
+    double wall_s = sim_wall_s();
+    sim_ble_close();
+    ppg_replay_close();
+    sim_flash_save();
+    if (trace) fclose(trace);
+
+    return sim_report(wall_s);
+}
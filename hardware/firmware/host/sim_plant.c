@@ -0,0 +1,141 @@
+/**
+ * @file sim_plant.c
+ * @brief Neural Load Ring Host Simulator - Thermal Plant and Motor
+ *
+ * Skin under the heater is a first-order system: heater power raises the
+ * equilibrium above the ambient skin temperature through a thermal
+ * resistance, approached with the skin/ring time constant. The NTC reads
+ * that temperature through the same divider temperature_sensor.c assumes,
+ * so the firmware's safety limits see plausible numbers.
+ *
+ * The motor runs through the ERM model in tests/erm_model.h, so the report
+ * shows how long vibration was actually felt next to the drive on-time.
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "sim.h"
+#include "erm_model.h"
+#include <math.h>
+#include <string.h>
+
+/*******************************************************************************
+ * PLANT PARAMETERS
+ ******************************************************************************/
+
+#define PLANT_HEATER_MAX_W      0.6f    /**< Heater power at 100 % duty */
+#define PLANT_R_TH_K_PER_W      25.0f   /**< Heater to skin thermal resistance */
+#define PLANT_TAU_S             20.0f   /**< Skin/ring time constant */
+
+/* NTC divider (match temperature_sensor.c) */
+#define PLANT_NTC_R25           10000.0f
+#define PLANT_NTC_BETA          3380.0f
+#define PLANT_NTC_T25_K         298.15f
+#define PLANT_SERIES_R          10000.0f
+
+#define PLANT_TRACE_PERIOD_MS   1000U
+
+/*******************************************************************************
+ * PRIVATE DATA
+ ******************************************************************************/
+
+static struct {
+    float ambient_c;
+    float skin_c;
+    float skin_max_c;
+    uint8_t duty[HAL_PWM_COUNT];
+    uint32_t heater_on_ms;
+    uint32_t motor_on_ms;
+    uint32_t motor_changes;
+    erm_model_t motor;
+    uint32_t now_ms;
+    uint32_t last_trace_ms;
+    FILE *trace;
+} m_plant;
+
+static void plant_trace_row(void)
+{
+    if (!m_plant.trace) return;
+
+    fprintf(m_plant.trace, "%u,%u,%u,%.2f\n", (unsigned)m_plant.now_ms,
+            m_plant.duty[HAL_PWM_HEATER], m_plant.duty[HAL_PWM_MOTOR],
+            (double)m_plant.skin_c);
+    m_plant.last_trace_ms = m_plant.now_ms;
+}
+
+/*******************************************************************************
+ * PUBLIC API
+ ******************************************************************************/
+
+void sim_plant_init(const sim_config_t *p_cfg, FILE *p_trace)
+{
+    memset(&m_plant, 0, sizeof(m_plant));
+    m_plant.ambient_c = p_cfg->ambient_skin_c;
+    m_plant.skin_c = p_cfg->ambient_skin_c;
+    m_plant.skin_max_c = p_cfg->ambient_skin_c;
+    m_plant.trace = p_trace;
+    erm_model_reset(&m_plant.motor);
+
+    if (m_plant.trace) {
+        fprintf(m_plant.trace, "t_ms,heater_pct,motor_pct,skin_c\n");
+        plant_trace_row();
+    }
+}
+
+void sim_plant_step(uint32_t now_ms, uint32_t dt_ms)
+{
+    float power_w = PLANT_HEATER_MAX_W * (float)m_plant.duty[HAL_PWM_HEATER] / 100.0f;
+    float target_c = m_plant.ambient_c + power_w * PLANT_R_TH_K_PER_W;
+    float alpha = 1.0f - expf(-((float)dt_ms / 1000.0f) / PLANT_TAU_S);
+
+    m_plant.skin_c += (target_c - m_plant.skin_c) * alpha;
+    if (m_plant.skin_c > m_plant.skin_max_c) {
+        m_plant.skin_max_c = m_plant.skin_c;
+    }
+
+    if (m_plant.duty[HAL_PWM_HEATER] > 0U) m_plant.heater_on_ms += dt_ms;
+    if (m_plant.duty[HAL_PWM_MOTOR] > 0U) m_plant.motor_on_ms += dt_ms;
+    erm_model_step(&m_plant.motor, m_plant.duty[HAL_PWM_MOTOR], dt_ms);
+
+    m_plant.now_ms = now_ms;
+    if (now_ms - m_plant.last_trace_ms >= PLANT_TRACE_PERIOD_MS) {
+        plant_trace_row();
+    }
+}
+
+void sim_plant_pwm(hal_pwm_t pwm, uint8_t duty_pct)
+{
+    if (pwm >= HAL_PWM_COUNT) return;
+
+    m_plant.duty[pwm] = duty_pct;
+    if (pwm == HAL_PWM_MOTOR) {
+        m_plant.motor_changes++;
+    }
+    plant_trace_row();
+}
+
+/**
+ * Divider output for the current skin temperature (inverse of
+ * temperature_sensor.c: R_ntc = R_series * (ADC_MAX / adc - 1))
+ */
+uint16_t sim_plant_ntc_adc(void)
+{
+    float t_k = m_plant.skin_c + 273.15f;
+    float r_ntc = PLANT_NTC_R25 * expf(PLANT_NTC_BETA * (1.0f / t_k - 1.0f / PLANT_NTC_T25_K));
+    float adc = (float)(HAL_ADC_MAX + 1U) / (1.0f + r_ntc / PLANT_SERIES_R);
+
+    if (adc < 1.0f) adc = 1.0f;
+    if (adc > (float)HAL_ADC_MAX) adc = (float)HAL_ADC_MAX;
+    return (uint16_t)lroundf(adc);
+}
+
+void sim_plant_get_stats(sim_plant_stats_t *p_stats)
+{
+    p_stats->skin_c = m_plant.skin_c;
+    p_stats->skin_max_c = m_plant.skin_max_c;
+    p_stats->heater_on_ms = m_plant.heater_on_ms;
+    p_stats->motor_on_ms = m_plant.motor_on_ms;
+    p_stats->motor_changes = m_plant.motor_changes;
+    p_stats->motor_felt_ms = m_plant.motor.felt_ms;
+}
@@ -0,0 +1,172 @@
+/**
+ * @file ble_bond.c
+ * @brief Neural Load Ring Bonded Peers Implementation
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "ble_bond.h"
+#include "../system/nvm_store.h"
+#include <stddef.h>
+#include <string.h>
+
+/*******************************************************************************
+ * PRIVATE DATA
+ ******************************************************************************/
+
+static struct {
+    nlr_bond_t peers[NLR_BOND_MAX_PEERS];
+    uint32_t seq;                   /**< Highest seq handed out */
+    bool seq_dirty[NLR_BOND_MAX_PEERS];     /**< Touched since last saved */
+} m_bond;
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+static int bond_save(uint8_t slot)
+{
+    int err = nvm_store_write((uint16_t)(NVM_RECORD_BLE_BOND + slot), &m_bond.peers[slot],
+                              sizeof(nlr_bond_t));
+    if (err == 0) {
+        m_bond.seq_dirty[slot] = false;
+    }
+    return err;
+}
+
+static bool bond_valid(uint8_t slot)
+{
+    return m_bond.peers[slot].version == NLR_BOND_VERSION;
+}
+
+/** Free slot, else the least recently connected */
+static uint8_t bond_slot_for_new(void)
+{
+    uint8_t oldest = 0;
+
+    for (uint8_t i = 0; i < NLR_BOND_MAX_PEERS; i++) {
+        if (!bond_valid(i)) return i;
+        if (m_bond.peers[i].seq < m_bond.peers[oldest].seq) oldest = i;
+    }
+    return oldest;
+}
+
+/*******************************************************************************
+ * PUBLIC API
+ ******************************************************************************/
+
+void ble_bond_init(void)
+{
+    memset(&m_bond, 0, sizeof(m_bond));
+
+    for (uint8_t i = 0; i < NLR_BOND_MAX_PEERS; i++) {
+        nlr_bond_t *p_bond = &m_bond.peers[i];
+        if (nvm_store_read((uint16_t)(NVM_RECORD_BLE_BOND + i), p_bond, sizeof(*p_bond)) != 0 ||
+            p_bond->version != NLR_BOND_VERSION) {
+            memset(p_bond, 0, sizeof(*p_bond));
+            continue;
+        }
+        if (p_bond->seq > m_bond.seq) m_bond.seq = p_bond->seq;
+    }
+}
+
+int ble_bond_find(const uint8_t addr[6])
+{
+    for (uint8_t i = 0; i < NLR_BOND_MAX_PEERS; i++) {
+        if (bond_valid(i) && memcmp(m_bond.peers[i].addr, addr, 6) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int ble_bond_find_master_id(uint16_t ediv, const uint8_t rand[8])
+{
+    for (uint8_t i = 0; i < NLR_BOND_MAX_PEERS; i++) {
+        if (bond_valid(i) && m_bond.peers[i].keys.ediv == ediv &&
+            memcmp(m_bond.peers[i].keys.rand, rand, sizeof(m_bond.peers[i].keys.rand)) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int ble_bond_store(const uint8_t addr[6], uint8_t addr_type, const nlr_bond_keys_t *p_keys,
+                   uint8_t cccd, uint32_t db_hash)
+{
+    int existing = ble_bond_find(addr);
+    uint8_t slot = (existing >= 0) ? (uint8_t)existing : bond_slot_for_new();
+    nlr_bond_t *p_bond = &m_bond.peers[slot];
+
+    memset(p_bond, 0, sizeof(*p_bond));
+    p_bond->version = NLR_BOND_VERSION;
+    p_bond->addr_type = addr_type;
+    memcpy(p_bond->addr, addr, 6);
+    p_bond->cccd = cccd;
+    p_bond->db_hash = db_hash;
+    p_bond->seq = ++m_bond.seq;
+    if (p_keys != NULL) {
+        p_bond->keys = *p_keys;
+        for (uint8_t i = 0; i < sizeof(p_keys->irk); i++) {
+            if (p_keys->irk[i] != 0U) {
+                p_bond->flags |= NLR_BOND_FLAG_IRK;
+                break;
+            }
+        }
+    }
+
+    int err = bond_save(slot);
+    return (err == 0) ? (int)slot : err;
+}
+
+const nlr_bond_t *ble_bond_get(uint8_t slot)
+{
+    return (slot < NLR_BOND_MAX_PEERS && bond_valid(slot)) ? &m_bond.peers[slot] : NULL;
+}
+
+void ble_bond_touch(uint8_t slot)
+{
+    if (slot < NLR_BOND_MAX_PEERS && bond_valid(slot)) {
+        m_bond.peers[slot].seq = ++m_bond.seq;
+        m_bond.seq_dirty[slot] = true;
+    }
+}
+
+int ble_bond_update(uint8_t slot, uint8_t cccd, uint32_t db_hash)
+{
+    if (slot >= NLR_BOND_MAX_PEERS || !bond_valid(slot)) return -1;
+
+    nlr_bond_t *p_bond = &m_bond.peers[slot];
+    if (p_bond->cccd == cccd && p_bond->db_hash == db_hash && !m_bond.seq_dirty[slot]) {
+        return 0;
+    }
+    p_bond->cccd = cccd;
+    p_bond->db_hash = db_hash;
+    return bond_save(slot);
+}
+
+void ble_bond_delete(uint8_t slot)
+{
+    if (slot < NLR_BOND_MAX_PEERS && bond_valid(slot)) {
+        memset(&m_bond.peers[slot], 0, sizeof(nlr_bond_t));
+        (void)bond_save(slot);
+    }
+}
+
+void ble_bond_clear(void)
+{
+    for (uint8_t i = 0; i < NLR_BOND_MAX_PEERS; i++) {
+        ble_bond_delete(i);
+    }
+}
+
+uint8_t ble_bond_count(void)
+{
+    uint8_t count = 0;
+
+    for (uint8_t i = 0; i < NLR_BOND_MAX_PEERS; i++) {
+        if (bond_valid(i)) count++;
+    }
+    return count;
+}
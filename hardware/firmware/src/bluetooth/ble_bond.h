@@ -0,0 +1,135 @@
+/**
+ * @file ble_bond.h
+ * @brief Neural Load Ring Bonded Peers
+ *
+ * Up to NLR_BOND_MAX_PEERS bonded centrals, one nvm_store record each, so
+ * a phone that walks out of range and back does not start from scratch:
+ *
+ *   keys      what re-encryption needs (LTK / EDIV / Rand handed back on
+ *             SEC_INFO_REQUEST) and the peer IRK, so its resolvable
+ *             private addresses map back to the bond
+ *   cccd      the notifications it had enabled, restored on connect so
+ *             streaming resumes without it writing a single CCCD
+ *   db_hash   the GATT layout it last discovered; a bonded central keeps
+ *             its attribute cache, and gets a Service Changed indication
+ *             when the ring's layout moved (firmware update)
+ *
+ * A new bond takes a free slot or replaces the least recently connected
+ * one. Records are written when a bond is made and when a bonded link
+ * drops (its connection order moved, and any CCCD or hash change), not on
+ * every CCCD write, so the replacement order survives a reboot.
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef BLE_BOND_H
+#define BLE_BOND_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
+
+#define NLR_BOND_MAX_PEERS          4U
+#define NLR_BOND_VERSION            1U
+
+#define NLR_BOND_FLAG_IRK           0x01    /**< keys.irk is valid */
+
+/*******************************************************************************
+ * TYPES
+ ******************************************************************************/
+
+/** Keys distributed when bonding (zero on the host link) */
+typedef struct {
+    uint8_t ltk[16];                /**< Ring's LTK, handed back on re-encryption */
+    uint8_t rand[8];                /**< Master identification: Rand ... */
+    uint16_t ediv;                  /**< ... and EDIV */
+    uint8_t irk[16];                /**< Central's IRK */
+} nlr_bond_keys_t;
+
+/** One bond (this is also the persisted record) */
+typedef struct {
+    uint8_t version;                /**< NLR_BOND_VERSION; 0 = empty slot */
+    uint8_t addr_type;
+    uint8_t addr[6];                /**< Identity address */
+    uint8_t cccd;                   /**< Notifications enabled at the last disconnect */
+    uint8_t flags;                  /**< NLR_BOND_FLAG_* */
+    uint16_t reserved;
+    uint32_t db_hash;               /**< GATT layout the central has cached */
+    uint32_t seq;                   /**< Connection order, for replacement */
+    nlr_bond_keys_t keys;
+} nlr_bond_t;
+
+/*******************************************************************************
+ * PUBLIC API
+ ******************************************************************************/
+
+/**
+ * @brief Load the bonds from flash (nvm_store must be mounted)
+ */
+void ble_bond_init(void);
+
+/**
+ * @return Slot bonded to this identity address, or -1
+ */
+int ble_bond_find(const uint8_t addr[6]);
+
+/**
+ * @return Slot whose keys carry this EDIV / Rand, or -1
+ */
+int ble_bond_find_master_id(uint16_t ediv, const uint8_t rand[8]);
+
+/**
+ * @brief Bond a central (replaces an existing bond to the same address)
+ *
+ * @param p_keys  Keys from pairing, or NULL
+ * @param cccd    Notifications it has enabled right now
+ * @param db_hash GATT layout it has discovered
+ * @return Slot, or negative nvm_store error
+ */
+int ble_bond_store(const uint8_t addr[6], uint8_t addr_type, const nlr_bond_keys_t *p_keys,
+                   uint8_t cccd, uint32_t db_hash);
+
+/**
+ * @return The bond in a slot, or NULL if empty
+ */
+const nlr_bond_t *ble_bond_get(uint8_t slot);
+
+/**
+ * @brief Mark a bond as just connected (RAM; ble_bond_update persists it)
+ */
+void ble_bond_touch(uint8_t slot);
+
+/**
+ * @brief Record a bonded link's state at disconnect
+ *
+ * Written only if the bond was touched since it was last saved, or the
+ * CCCDs or hash changed.
+ *
+ * @return 0 on success, negative nvm_store error
+ */
+int ble_bond_update(uint8_t slot, uint8_t cccd, uint32_t db_hash);
+
+/**
+ * @brief Forget one bond, or all of them
+ */
+void ble_bond_delete(uint8_t slot);
+void ble_bond_clear(void);
+
+/**
+ * @return Bonds held
+ */
+uint8_t ble_bond_count(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BLE_BOND_H */
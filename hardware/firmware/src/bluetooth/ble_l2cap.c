@@ -0,0 +1,136 @@
+/**
+ * @file ble_l2cap.c
+ * @brief Neural Load Ring L2CAP Bulk Channel (LE Credit-Based CoC)
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "ble_l2cap.h"
+#include <stddef.h>
+#include <string.h>
+
+void nlr_l2cap_init(nlr_l2cap_chan_t *p_ch, uint8_t *p_rx_buf, uint16_t rx_mtu, uint16_t rx_mps)
+{
+    memset(p_ch, 0, sizeof(*p_ch));
+    p_ch->p_rx = p_rx_buf;
+    p_ch->rx_mtu = rx_mtu;
+    p_ch->rx_mps = rx_mps;
+}
+
+uint16_t nlr_l2cap_open(nlr_l2cap_chan_t *p_ch, uint16_t tx_mtu, uint16_t tx_mps, uint16_t tx_credits)
+{
+    nlr_l2cap_close(p_ch);
+    p_ch->open = true;
+    p_ch->tx_mtu = tx_mtu;
+    p_ch->tx_mps = (tx_mps < NLR_L2CAP_MPS_MIN) ? NLR_L2CAP_MPS_MIN : tx_mps;
+    p_ch->tx_credits = tx_credits;
+    p_ch->rx_credits = NLR_L2CAP_RX_CREDITS;
+    return NLR_L2CAP_RX_CREDITS;
+}
+
+void nlr_l2cap_close(nlr_l2cap_chan_t *p_ch)
+{
+    p_ch->open = false;
+    p_ch->tx_credits = 0;
+    p_ch->p_tx = NULL;
+    p_ch->tx_busy = false;
+    p_ch->rx_credits = 0;
+    p_ch->rx_len = 0;
+    p_ch->rx_off = 0;
+}
+
+/*******************************************************************************
+ * TRANSMIT
+ ******************************************************************************/
+
+int nlr_l2cap_tx_start(nlr_l2cap_chan_t *p_ch, const uint8_t *p_sdu, uint16_t len)
+{
+    if (!p_ch->open) return -3;
+    if (p_ch->tx_busy) return -2;
+    if (p_sdu == NULL || len == 0U || len > p_ch->tx_mtu) return -1;
+
+    p_ch->p_tx = p_sdu;
+    p_ch->tx_len = len;
+    p_ch->tx_off = 0;
+    p_ch->tx_busy = true;
+    return 0;
+}
+
+uint16_t nlr_l2cap_tx_frame(nlr_l2cap_chan_t *p_ch, uint8_t *p_frame)
+{
+    uint16_t n = 0;
+
+    if (!p_ch->tx_busy || p_ch->tx_credits == 0U) return 0;
+
+    /* First frame carries the SDU length ahead of the data */
+    if (p_ch->tx_off == 0U) {
+        p_frame[0] = (uint8_t)(p_ch->tx_len & 0xFF);
+        p_frame[1] = (uint8_t)(p_ch->tx_len >> 8);
+        n = NLR_L2CAP_SDU_LEN_BYTES;
+    }
+
+    uint16_t chunk = (uint16_t)(p_ch->tx_mps - n);
+    if (chunk > p_ch->tx_len - p_ch->tx_off) chunk = (uint16_t)(p_ch->tx_len - p_ch->tx_off);
+    memcpy(&p_frame[n], &p_ch->p_tx[p_ch->tx_off], chunk);
+    p_ch->tx_off = (uint16_t)(p_ch->tx_off + chunk);
+
+    p_ch->tx_credits--;
+    p_ch->tx_frames++;
+    if (p_ch->tx_off == p_ch->tx_len) {
+        p_ch->tx_busy = false;
+        p_ch->p_tx = NULL;
+    }
+    return (uint16_t)(n + chunk);
+}
+
+int nlr_l2cap_tx_credit(nlr_l2cap_chan_t *p_ch, uint16_t credits)
+{
+    if ((uint32_t)p_ch->tx_credits + credits > 0xFFFFU) return -1;
+
+    p_ch->tx_credits = (uint16_t)(p_ch->tx_credits + credits);
+    return 0;
+}
+
+/*******************************************************************************
+ * RECEIVE
+ ******************************************************************************/
+
+int nlr_l2cap_rx_frame(nlr_l2cap_chan_t *p_ch, const uint8_t *p_frame, uint16_t len,
+                       uint16_t *p_sdu_len)
+{
+    if (!p_ch->open || p_ch->rx_credits == 0U || len > p_ch->rx_mps) return -1;
+    p_ch->rx_credits--;
+    p_ch->rx_frames++;
+
+    if (p_ch->rx_len == 0U) {
+        if (len < NLR_L2CAP_SDU_LEN_BYTES) return -2;
+        uint16_t sdu_len = (uint16_t)(p_frame[0] | (p_frame[1] << 8));
+        if (sdu_len == 0U || sdu_len > p_ch->rx_mtu) return -2;
+
+        p_ch->rx_len = sdu_len;
+        p_ch->rx_off = 0;
+        p_frame += NLR_L2CAP_SDU_LEN_BYTES;
+        len = (uint16_t)(len - NLR_L2CAP_SDU_LEN_BYTES);
+    }
+
+    if (len > p_ch->rx_len - p_ch->rx_off) return -2;
+    memcpy(&p_ch->p_rx[p_ch->rx_off], p_frame, len);
+    p_ch->rx_off = (uint16_t)(p_ch->rx_off + len);
+
+    if (p_ch->rx_off < p_ch->rx_len) return 0;
+
+    if (p_sdu_len) *p_sdu_len = p_ch->rx_len;
+    p_ch->rx_len = 0;
+    p_ch->rx_off = 0;
+    return 1;
+}
+
+uint16_t nlr_l2cap_rx_grant(nlr_l2cap_chan_t *p_ch)
+{
+    if (!p_ch->open || p_ch->rx_credits > NLR_L2CAP_RX_CREDITS / 2U) return 0;
+
+    uint16_t grant = (uint16_t)(NLR_L2CAP_RX_CREDITS - p_ch->rx_credits);
+    p_ch->rx_credits = NLR_L2CAP_RX_CREDITS;
+    return grant;
+}
@@ -0,0 +1,146 @@
+/**
+ * @file ble_l2cap.h
+ * @brief Neural Load Ring L2CAP Bulk Channel (LE Credit-Based CoC)
+ *
+ * Bulk data (OTA patches today; logs and captures as they land) goes over
+ * one L2CAP connection-oriented channel instead of GATT writes and
+ * notifications: no ATT header or per-packet handler per chunk, SDUs larger
+ * than the ATT MTU, and the peer paces the sender with credits rather than
+ * the application polling a notification queue.
+ *
+ * On target the SoftDevice runs the channel (ble_stack.c hands it whole
+ * SDUs). This file is the same protocol for builds without one, and for
+ * the central side of host tools:
+ *
+ *   K-frame    information payload of at most the receiver's MPS; the
+ *              first frame of an SDU starts with the u16 SDU length (LE)
+ *   credits    one per K-frame; the receiver returns them with LE Flow
+ *              Control Credit once it has consumed the frames
+ *
+ * A frame without a credit, over the MPS, or an SDU over the MTU is a
+ * protocol error: the channel must be disconnected.
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef BLE_L2CAP_H
+#define BLE_L2CAP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
+
+#define NLR_L2CAP_PSM               0x0081U /**< LE PSM (dynamic range 0x0080-0x00FF) */
+#define NLR_L2CAP_SDU_MAX           512U    /**< Our MTU: largest SDU either way */
+#define NLR_L2CAP_MPS_MAX           247U    /**< LL payload 251 - L2CAP header 4 */
+#define NLR_L2CAP_MPS_MIN           23U     /**< Smallest MPS the spec allows */
+#define NLR_L2CAP_RX_CREDITS        8U      /**< K-frames the peer may have in flight */
+#define NLR_L2CAP_SDU_LEN_BYTES     2U
+
+/*******************************************************************************
+ * TYPES
+ ******************************************************************************/
+
+/** One end of a channel */
+typedef struct {
+    bool open;
+
+    /* Transmit: peer's limits, one SDU in flight */
+    uint16_t tx_mtu;
+    uint16_t tx_mps;
+    uint16_t tx_credits;
+    const uint8_t *p_tx;            /**< Caller's SDU, held until sent */
+    uint16_t tx_len;
+    uint16_t tx_off;                /**< SDU bytes already framed */
+    bool tx_busy;
+
+    /* Receive: reassembly into the caller's buffer */
+    uint8_t *p_rx;
+    uint16_t rx_mtu;
+    uint16_t rx_mps;
+    uint16_t rx_credits;            /**< K-frames the peer may still send */
+    uint16_t rx_len;                /**< SDU length announced, 0 between SDUs */
+    uint16_t rx_off;
+
+    uint32_t tx_frames;
+    uint32_t rx_frames;
+} nlr_l2cap_chan_t;
+
+/*******************************************************************************
+ * PUBLIC API
+ ******************************************************************************/
+
+/**
+ * @brief Set up a closed channel end
+ *
+ * @param p_rx_buf  SDU reassembly buffer, rx_mtu bytes, held by the channel
+ * @param rx_mtu    Largest SDU accepted
+ * @param rx_mps    Largest K-frame payload accepted
+ */
+void nlr_l2cap_init(nlr_l2cap_chan_t *p_ch, uint8_t *p_rx_buf, uint16_t rx_mtu, uint16_t rx_mps);
+
+/**
+ * @brief Open with the peer's parameters (from its connect request/response)
+ *
+ * @return Credits granted to the peer (announce them in our request/response)
+ */
+uint16_t nlr_l2cap_open(nlr_l2cap_chan_t *p_ch, uint16_t tx_mtu, uint16_t tx_mps, uint16_t tx_credits);
+
+/**
+ * @brief Close; any SDU in flight or half received is dropped
+ */
+void nlr_l2cap_close(nlr_l2cap_chan_t *p_ch);
+
+/**
+ * @brief Queue an SDU (the buffer must stay valid until tx_busy clears)
+ *
+ * @return 0 on success, -1 invalid args or longer than the peer's MTU,
+ *         -2 previous SDU still in flight, -3 channel closed
+ */
+int nlr_l2cap_tx_start(nlr_l2cap_chan_t *p_ch, const uint8_t *p_sdu, uint16_t len);
+
+/**
+ * @brief Next K-frame of the queued SDU, consuming one credit
+ *
+ * @param[out] p_frame  At least tx_mps bytes
+ * @return Frame length, 0 if nothing queued or no credit
+ */
+uint16_t nlr_l2cap_tx_frame(nlr_l2cap_chan_t *p_ch, uint8_t *p_frame);
+
+/**
+ * @brief Credits returned by the peer
+ * @return 0 on success, -1 credit count overflow (protocol error)
+ */
+int nlr_l2cap_tx_credit(nlr_l2cap_chan_t *p_ch, uint16_t credits);
+
+/**
+ * @brief Feed one received K-frame
+ *
+ * @param[out] p_sdu_len  SDU length when one completes (it is in p_rx_buf)
+ * @return 1 SDU complete, 0 more frames needed, -1 channel closed or frame
+ *         without credit / over the MPS, -2 SDU over the MTU or overrun
+ */
+int nlr_l2cap_rx_frame(nlr_l2cap_chan_t *p_ch, const uint8_t *p_frame, uint16_t len,
+                       uint16_t *p_sdu_len);
+
+/**
+ * @brief Credits to return to the peer now (0 while it has enough)
+ *
+ * Tops the peer back up to NLR_L2CAP_RX_CREDITS once half are used, so a
+ * credit packet goes out every few frames rather than after each one.
+ */
+uint16_t nlr_l2cap_rx_grant(nlr_l2cap_chan_t *p_ch);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BLE_L2CAP_H */
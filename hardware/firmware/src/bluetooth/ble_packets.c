@@ -0,0 +1,48 @@
+/**
+ * @file ble_packets.c
+ * @brief Neural Load Ring BLE Payload Encoding
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "ble_packets.h"
+#include <stddef.h>
+
+uint16_t nlr_ble_encode_rr(uint8_t *p_out, const uint16_t *p_rr_ms, uint8_t count, uint16_t mtu)
+{
+    if (p_out == NULL || p_rr_ms == NULL || mtu <= NLR_ATT_HEADER_BYTES) {
+        return 0;
+    }
+
+    uint16_t fit = (uint16_t)((mtu - NLR_ATT_HEADER_BYTES) / 2U);
+    if (count > NLR_RR_PER_NOTIFY_MAX) count = NLR_RR_PER_NOTIFY_MAX;
+    if (count > fit) count = (uint8_t)fit;
+
+    for (uint8_t i = 0; i < count; i++) {
+        p_out[i * 2]     = (uint8_t)(p_rr_ms[i] & 0xFF);
+        p_out[i * 2 + 1] = (uint8_t)((p_rr_ms[i] >> 8) & 0xFF);
+    }
+    return (uint16_t)(count * 2U);
+}
+
+void nlr_ble_coherence_from_metrics(const hr_metrics_t *p_metrics, nlr_coherence_packet_t *p_packet)
+{
+    uint8_t confidence = 50;
+    uint32_t rmssd_ms = p_metrics->rmssd_us / 1000U;
+
+    if (p_metrics->valid_samples > 30) {
+        confidence = (p_metrics->quality_pct < 90) ? p_metrics->quality_pct : 90;
+    }
+
+    *p_packet = (nlr_coherence_packet_t) {
+        .stress_level = biometrics_stress_pct(p_metrics),
+        .coherence_pct = biometrics_coherence_pct(p_metrics),
+        .confidence_pct = confidence,
+        .variability_level = (uint8_t)(rmssd_ms > 100U ? 100U : rmssd_ms),
+        .mean_rr_ms = (uint16_t)(p_metrics->mean_rr_us / 1000U),
+        .rmssd_ms = (uint16_t)rmssd_ms,
+        .respiratory_rate_cpm = 0, /* TODO: Implement resp rate detection */
+        .dfa_alpha1_x1000 = p_metrics->dfa_alpha1_x1000,
+    };
+}
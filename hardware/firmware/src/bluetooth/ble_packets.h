@@ -0,0 +1,43 @@
+/**
+ * @file ble_packets.h
+ * @brief Neural Load Ring BLE Payload Encoding
+ *
+ * Builds the notification payloads of the Wellness service from firmware
+ * state. Kept out of ble_stack.c, which owns the SoftDevice, so host tools
+ * (load generator, gateway tests) emit byte-identical packets without a
+ * stack instance.
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef BLE_PACKETS_H
+#define BLE_PACKETS_H
+
+#include <stdint.h>
+#include "ble_stack.h"
+#include "../core/biometric_algorithms.h"
+
+#define NLR_RR_PER_NOTIFY_MAX       10      /**< RR characteristic holds 10 values */
+#define NLR_ATT_HEADER_BYTES        3       /**< Opcode + handle in a notification */
+
+/**
+ * @brief Encode RR intervals as the RR characteristic value
+ *
+ * Little-endian uint16 per interval. Stops at NLR_RR_PER_NOTIFY_MAX values
+ * or what fits in one notification at this ATT MTU, whichever is smaller.
+ *
+ * @param[out] p_out    At least NLR_RR_PER_NOTIFY_MAX * 2 bytes
+ * @param[in]  p_rr_ms  Intervals in ms
+ * @param[in]  count    Number of intervals offered
+ * @param[in]  mtu      Negotiated ATT MTU
+ * @return Payload length in bytes (twice the intervals encoded)
+ */
+uint16_t nlr_ble_encode_rr(uint8_t *p_out, const uint16_t *p_rr_ms, uint8_t count, uint16_t mtu);
+
+/**
+ * @brief Fill a coherence packet from the current biometrics
+ */
+void nlr_ble_coherence_from_metrics(const hr_metrics_t *p_metrics, nlr_coherence_packet_t *p_packet);
+
+#endif /* BLE_PACKETS_H */
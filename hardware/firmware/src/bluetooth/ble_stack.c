@@ -12,6 +12,11 @@
  */
 
 #include "ble_stack.h"
+#include "ble_packets.h"
+#include "ble_l2cap.h"
+#include "ble_bond.h"
+#include "../system/ota_update.h"
+#include "../core/peak_detector.h"
 #include <string.h>
 
 /* Nordic SDK includes - these would come from nRF5 SDK */
@@ -61,11 +66,25 @@ typedef uint32_t ret_code_t;
 #define CONN_INTERVAL_UNITS         1250
 
 /** Maximum characteristics */
-#define NLR_MAX_CHARACTERISTICS     5
+#define NLR_MAX_CHARACTERISTICS     6
 
-/** TX queue depth for notifications */
+/** Bump when a characteristic changes without moving any handle (see gatt_db_hash) */
+#define NLR_GATT_DB_REVISION        1
+
+/** Asked for as soon as a central connects */
+#define NLR_ATT_MTU_MAX             247
+#define NLR_DLE_OCTETS_MAX          251     /**< LL payload carrying a full 247-byte ATT MTU */
+
+/** TX queue depth for notifications, per link */
 #define NLR_TX_QUEUE_SIZE           8
 
+/** Notifications a central has enabled (nlr_ble_link_t.cccd) */
+#define SUB_RR                      0x01
+#define SUB_COHERENCE               0x02
+#define SUB_DEVICE_STATE            0x04
+#define SUB_OTA                     0x08
+#define SUB_CONFIG                  0x10
+
 /*******************************************************************************
  * PRIVATE DATA
  ******************************************************************************/
@@ -81,34 +100,60 @@ typedef struct {
     uint16_t device_state_handle;
     uint16_t device_state_cccd;
     uint16_t config_handle;
+    uint16_t config_cccd;
+    uint16_t ota_handle;
+    uint16_t ota_cccd;
 } nlr_service_handles_t;
 
+/** One connected central */
+typedef struct {
+    uint16_t conn_handle;           /**< BLE_CONN_HANDLE_INVALID: slot free */
+    uint16_t mtu_size;
+    uint8_t cccd;                   /**< SUB_* notifications this central enabled */
+    uint8_t tx_queue_count;         /**< Notifications queued in the SoftDevice */
+    uint32_t tx_drops;              /**< Notifications it missed, queue full */
+    uint8_t peer_addr[6];           /**< Identity address when resolved */
+    uint8_t peer_addr_type;
+    int8_t bond;                    /**< ble_bond slot, -1 if not bonded */
+    bool db_synced;                 /**< Central's attribute cache matches m_state.db_hash */
+    bool encrypted;                 /**< Encrypted by pairing or with the bond's LTK */
+#ifdef NRF_SDK_PRESENT
+    ble_gap_enc_key_t own_enc;      /**< Keys distributed while pairing */
+    ble_gap_id_key_t peer_id;
+#endif
+} nlr_ble_link_t;
+
 /** Module state */
 typedef struct {
     bool initialized;
     bool advertising;
-    uint16_t conn_handle;
-    uint16_t mtu_size;
+    nlr_ble_link_t links[NLR_BLE_MAX_LINKS];
+    uint8_t link_count;
+    uint16_t conn_interval_ms;      /**< Interval every link is asked for */
     uint8_t uuid_type;
     nlr_service_handles_t handles;
+    uint32_t db_hash;               /**< GATT layout, see gatt_db_hash() */
     nlr_ble_evt_handler_t evt_handler;
     nlr_config_t config;
     nlr_device_state_t device_state;
     
-    /* Notification state */
-    bool rr_notifications_enabled;
-    bool coherence_notifications_enabled;
-    bool device_state_notifications_enabled;
-    
-    /* TX queue for flow control */
-    uint8_t tx_queue_count;
+    /* Bulk L2CAP channel (one, on whichever link opened it) */
+    uint16_t bulk_conn;             /**< Link that owns the channel */
+    uint16_t bulk_cid;              /**< Local CID, 0xFFFF when closed */
+    bool bulk_tx_busy;              /**< bulk_tx handed to the channel */
+    uint8_t bulk_rx[NLR_L2CAP_SDU_MAX];
+    uint8_t bulk_tx[NLR_L2CAP_SDU_MAX];
+#ifdef NLR_BLE_HOST_LINK
+    nlr_l2cap_chan_t bulk;          /**< What the SoftDevice does on target */
+#endif
 } nlr_ble_state_t;
 
 static nlr_ble_state_t m_state = {
     .initialized = false,
     .advertising = false,
-    .conn_handle = 0xFFFF,  /* BLE_CONN_HANDLE_INVALID */
-    .mtu_size = 23,         /* Default BLE 4.0 MTU */
+    .conn_interval_ms = NLR_CONN_INTERVAL_MAX_MS,
+    .bulk_conn = 0xFFFF,
+    .bulk_cid = 0xFFFF,
     .config = {
         .streaming_rate_hz = 4,
         .coherence_update_s = 15,
@@ -117,6 +162,7 @@ static nlr_ble_state_t m_state = {
         .quiet_hours_start = 22,
         .quiet_hours_end = 7,
         .led_brightness = 50,
+        .detector_id = PPG_DETECTOR_DEFAULT,
     },
 };
 
@@ -131,8 +177,28 @@ static int services_init(void);
 static int advertising_init(void);
 static int conn_params_init(void);
 static void on_ble_evt(uint16_t evt_id, void *p_evt_data);
-static void on_write_evt(uint16_t handle, const uint8_t *data, uint16_t len);
+static void on_write_evt(nlr_ble_link_t *p_link, uint16_t handle, const uint8_t *data, uint16_t len);
+static void on_gap_connected(uint16_t conn_handle, const uint8_t *p_peer_addr);
+static void on_gap_disconnected(uint16_t conn_handle, uint8_t reason);
+static void on_ota_packet(nlr_ble_link_t *p_link, const uint8_t *data, uint16_t len, bool via_bulk);
+static void on_bulk_sdu(const uint8_t *data, uint16_t len);
+static void bulk_closed(void);
+#ifdef NLR_BLE_HOST_LINK
+static void bulk_pump(void);
+#endif
 static void dispatch_event(nlr_ble_evt_type_t type, const void *data);
+static nlr_ble_link_t *link_find(uint16_t conn_handle);
+static void links_reschedule(void);
+static uint32_t gatt_db_hash(void);
+static void link_resume(nlr_ble_link_t *p_link, uint8_t slot);
+static void link_bond(nlr_ble_link_t *p_link, const nlr_bond_keys_t *p_keys);
+static void link_service_changed(nlr_ble_link_t *p_link);
+#ifdef NRF_SDK_PRESENT
+static void link_fast_start(uint16_t conn_handle);
+static void bonds_identities_set(void);
+#endif
+static int notify_fanout(uint8_t sub, uint16_t char_uuid, uint16_t value_handle,
+                         const uint8_t *p_data, uint16_t len);
 
 /*******************************************************************************
  * PUBLIC API IMPLEMENTATION
@@ -145,7 +211,15 @@ int nlr_ble_init(nlr_ble_evt_handler_t evt_handler)
     }
     
     m_state.evt_handler = evt_handler;
-    m_state.conn_handle = 0xFFFF;
+    for (uint8_t i = 0; i < NLR_BLE_MAX_LINKS; i++) {
+        m_state.links[i].conn_handle = BLE_CONN_HANDLE_INVALID;
+    }
+    m_state.link_count = 0;
+    m_state.bulk_conn = BLE_CONN_HANDLE_INVALID;
+    m_state.bulk_cid = 0xFFFF;
+#ifdef NLR_BLE_HOST_LINK
+    nlr_l2cap_init(&m_state.bulk, m_state.bulk_rx, NLR_L2CAP_SDU_MAX, NLR_L2CAP_MPS_MAX);
+#endif
     
     int err;
     
@@ -176,6 +250,13 @@ int nlr_ble_init(nlr_ble_evt_handler_t evt_handler)
         NRF_LOG_ERROR("Services init failed: %d", err);
         return err;
     }
+    m_state.db_hash = gatt_db_hash();
+    
+    /* Bonded centrals (nvm_store is mounted by now) */
+    ble_bond_init();
+#ifdef NRF_SDK_PRESENT
+    bonds_identities_set();
+#endif
     
     /* Configure advertising */
     err = advertising_init();
@@ -216,7 +297,9 @@ int nlr_ble_advertising_start(void)
 #endif
     
     m_state.advertising = true;
-    m_state.device_state.connection_state = 1; /* Advertising */
+    if (m_state.link_count == 0) {
+        m_state.device_state.connection_state = 1; /* Advertising */
+    }
     
     NRF_LOG_INFO("Advertising started");
     return 0;
@@ -233,7 +316,9 @@ int nlr_ble_advertising_stop(void)
 #endif
     
     m_state.advertising = false;
-    m_state.device_state.connection_state = 0; /* Idle */
+    if (m_state.link_count == 0) {
+        m_state.device_state.connection_state = 0; /* Idle */
+    }
     
     NRF_LOG_INFO("Advertising stopped");
     return 0;
@@ -241,125 +326,83 @@ int nlr_ble_advertising_stop(void)
 
 int nlr_ble_disconnect(void)
 {
-    if (m_state.conn_handle == 0xFFFF) {
-        return 0; /* Not connected */
-    }
+    int result = 0;
     
+    for (uint8_t i = 0; i < NLR_BLE_MAX_LINKS; i++) {
+        uint16_t conn_handle = m_state.links[i].conn_handle;
+        if (conn_handle == BLE_CONN_HANDLE_INVALID) {
+            continue;
+        }
+        
 #ifdef NRF_SDK_PRESENT
-    ret_code_t err = sd_ble_gap_disconnect(m_state.conn_handle, 
-                                            BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION);
-    if (err != NRF_SUCCESS) {
-        NRF_LOG_WARNING("Disconnect failed: %d", err);
-        return -1;
-    }
+        ret_code_t err = sd_ble_gap_disconnect(conn_handle, 
+                                                BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION);
+        if (err != NRF_SUCCESS) {
+            NRF_LOG_WARNING("Disconnect failed: %d", err);
+            result = -1;
+        }
+#elif defined(NLR_BLE_HOST_LINK)
+        nlr_ble_host_disconnect(conn_handle);
 #endif
+    }
     
-    return 0;
+    return result;
 }
 
 int nlr_ble_send_rr(const uint16_t *rr_ms, uint8_t count)
 {
-    if (!m_state.initialized || m_state.conn_handle == 0xFFFF) {
+    if (!m_state.initialized || m_state.link_count == 0) {
         return -1; /* Not connected */
     }
     
-    if (!m_state.rr_notifications_enabled) {
+    /* One encoding for every subscriber: it must fit the smallest MTU */
+    uint16_t mtu = 0;
+    for (uint8_t i = 0; i < NLR_BLE_MAX_LINKS; i++) {
+        const nlr_ble_link_t *p_link = &m_state.links[i];
+        if (p_link->conn_handle != BLE_CONN_HANDLE_INVALID && (p_link->cccd & SUB_RR) &&
+            (mtu == 0 || p_link->mtu_size < mtu)) {
+            mtu = p_link->mtu_size;
+        }
+    }
+    if (mtu == 0) {
         return -2; /* Notifications not enabled */
     }
     
-    if (count == 0 || count > 10 || rr_ms == NULL) {
+    if (count == 0 || count > NLR_RR_PER_NOTIFY_MAX || rr_ms == NULL) {
         return -3; /* Invalid parameters */
     }
     
-    /* Check TX queue space */
-    if (m_state.tx_queue_count >= NLR_TX_QUEUE_SIZE) {
-        return -4; /* Queue full */
-    }
-    
-    /* Prepare notification data (array of uint16_t, little-endian) */
-    uint8_t data[20]; /* Max 10 RR values × 2 bytes */
-    uint16_t len = count * 2;
-    
-    /* Ensure we don't exceed MTU */
-    uint16_t max_len = m_state.mtu_size - 3; /* ATT header overhead */
-    if (len > max_len) {
-        count = max_len / 2;
-        len = count * 2;
-    }
-    
-    for (uint8_t i = 0; i < count; i++) {
-        data[i * 2]     = (uint8_t)(rr_ms[i] & 0xFF);
-        data[i * 2 + 1] = (uint8_t)((rr_ms[i] >> 8) & 0xFF);
-    }
-    
-#ifdef NRF_SDK_PRESENT
-    ble_gatts_hvx_params_t hvx_params = {
-        .handle = m_state.handles.rr_interval_handle,
-        .type   = BLE_GATT_HVX_NOTIFICATION,
-        .offset = 0,
-        .p_len  = &len,
-        .p_data = data,
-    };
+    /* Prepare notification data (array of uint16_t, little-endian, MTU-bound) */
+    uint8_t data[NLR_RR_PER_NOTIFY_MAX * 2];
+    uint16_t len = nlr_ble_encode_rr(data, rr_ms, count, mtu);
     
-    ret_code_t err = sd_ble_gatts_hvx(m_state.conn_handle, &hvx_params);
-    if (err == NRF_SUCCESS) {
-        m_state.tx_queue_count++;
-        m_state.device_state.streaming_active |= 0x01;
-        return 0;
-    } else if (err == NRF_ERROR_RESOURCES) {
-        return -4; /* Queue full */
-    } else {
-        NRF_LOG_WARNING("RR notification failed: %d", err);
-        return -5;
+    int err = notify_fanout(SUB_RR, NLR_UUID_CHAR_RR_INTERVAL,
+                            m_state.handles.rr_interval_handle, data, len);
+    if (err < 0) {
+        return err; /* -4: every subscriber's queue full */
     }
-#else
-    (void)data;
-    (void)len;
     m_state.device_state.streaming_active |= 0x01;
     return 0;
-#endif
 }
 
 int nlr_ble_send_coherence(const nlr_coherence_packet_t *p_coherence)
 {
-    if (!m_state.initialized || m_state.conn_handle == 0xFFFF) {
+    if (!m_state.initialized || m_state.link_count == 0) {
         return -1;
     }
     
-    if (!m_state.coherence_notifications_enabled) {
-        return -2;
-    }
-    
     if (p_coherence == NULL) {
         return -3;
     }
     
-    if (m_state.tx_queue_count >= NLR_TX_QUEUE_SIZE) {
-        return -4;
-    }
-    
-#ifdef NRF_SDK_PRESENT
-    uint16_t len = sizeof(nlr_coherence_packet_t);
-    
-    ble_gatts_hvx_params_t hvx_params = {
-        .handle = m_state.handles.coherence_handle,
-        .type   = BLE_GATT_HVX_NOTIFICATION,
-        .offset = 0,
-        .p_len  = &len,
-        .p_data = (const uint8_t *)p_coherence,
-    };
-    
-    ret_code_t err = sd_ble_gatts_hvx(m_state.conn_handle, &hvx_params);
-    if (err == NRF_SUCCESS) {
-        m_state.tx_queue_count++;
-        m_state.device_state.streaming_active |= 0x02;
-        return 0;
+    int err = notify_fanout(SUB_COHERENCE, NLR_UUID_CHAR_COHERENCE,
+                            m_state.handles.coherence_handle,
+                            (const uint8_t *)p_coherence, sizeof(nlr_coherence_packet_t));
+    if (err < 0) {
+        return err;
     }
-    return -5;
-#else
     m_state.device_state.streaming_active |= 0x02;
     return 0;
-#endif
 }
 
 int nlr_ble_update_device_state(const nlr_device_state_t *p_state)
@@ -375,7 +418,7 @@ int nlr_ble_update_device_state(const nlr_device_state_t *p_state)
         m_state.device_state.connection_state = conn_state;
     }
     
-    /* Update characteristic value */
+    /* Update characteristic value (shared by all links) */
 #ifdef NRF_SDK_PRESENT
     ble_gatts_value_t val = {
         .len     = sizeof(nlr_device_state_t),
@@ -383,33 +426,67 @@ int nlr_ble_update_device_state(const nlr_device_state_t *p_state)
         .p_value = (uint8_t *)&m_state.device_state,
     };
     
-    sd_ble_gatts_value_set(m_state.conn_handle, 
+    sd_ble_gatts_value_set(BLE_CONN_HANDLE_INVALID, 
                            m_state.handles.device_state_handle, 
                            &val);
+#endif
     
-    /* Send notification if enabled and connected */
-    if (m_state.device_state_notifications_enabled && 
-        m_state.conn_handle != 0xFFFF &&
-        m_state.tx_queue_count < NLR_TX_QUEUE_SIZE) {
-        
-        uint16_t len = sizeof(nlr_device_state_t);
-        ble_gatts_hvx_params_t hvx_params = {
-            .handle = m_state.handles.device_state_handle,
-            .type   = BLE_GATT_HVX_NOTIFICATION,
-            .offset = 0,
-            .p_len  = &len,
-            .p_data = (uint8_t *)&m_state.device_state,
-        };
-        
-        if (sd_ble_gatts_hvx(m_state.conn_handle, &hvx_params) == NRF_SUCCESS) {
-            m_state.tx_queue_count++;
-        }
+    (void)notify_fanout(SUB_DEVICE_STATE, NLR_UUID_CHAR_DEVICE_STATE,
+                        m_state.handles.device_state_handle,
+                        (const uint8_t *)&m_state.device_state, sizeof(nlr_device_state_t));
+    
+    return 0;
+}
+
+int nlr_ble_bulk_send(uint8_t stream, const uint8_t *p_data, uint16_t len)
+{
+    if (m_state.bulk_cid == 0xFFFF) {
+        return -1;
+    }
+    
+    if ((p_data == NULL && len > 0) || len > NLR_L2CAP_SDU_MAX - 1U) {
+        return -3;
     }
+    
+    if (m_state.bulk_tx_busy) {
+        return -2;
+    }
+    
+    m_state.bulk_tx[0] = stream;
+    if (len > 0) {
+        memcpy(&m_state.bulk_tx[1], p_data, len);
+    }
+    
+#ifdef NRF_SDK_PRESENT
+    ble_data_t sdu = {
+        .p_data = m_state.bulk_tx,
+        .len    = (uint16_t)(len + 1U),
+    };
+    
+    ret_code_t err = sd_ble_l2cap_ch_tx(m_state.bulk_conn, m_state.bulk_cid, &sdu);
+    if (err == NRF_ERROR_RESOURCES) {
+        return -2;
+    } else if (err != NRF_SUCCESS) {
+        NRF_LOG_WARNING("Bulk SDU failed: %d", err);
+        return -3;
+    }
+    m_state.bulk_tx_busy = true;
+#elif defined(NLR_BLE_HOST_LINK)
+    if (nlr_l2cap_tx_start(&m_state.bulk, m_state.bulk_tx, (uint16_t)(len + 1U)) != 0) {
+        return -3; /* Over the central's MTU */
+    }
+    m_state.bulk_tx_busy = true;
+    bulk_pump();
 #endif
     
     return 0;
 }
 
+bool nlr_ble_bulk_is_open(void)
+{
+    return m_state.bulk_cid != 0xFFFF;
+}
+
 void nlr_ble_get_config(nlr_config_t *p_config)
 {
     if (p_config != NULL) {
@@ -419,17 +496,72 @@ void nlr_ble_get_config(nlr_config_t *p_config)
 
 bool nlr_ble_is_connected(void)
 {
-    return m_state.conn_handle != 0xFFFF;
+    return m_state.link_count > 0;
+}
+
+uint8_t nlr_ble_get_link_count(void)
+{
+    return m_state.link_count;
 }
 
 uint16_t nlr_ble_get_conn_handle(void)
 {
-    return m_state.conn_handle;
+    for (uint8_t i = 0; i < NLR_BLE_MAX_LINKS; i++) {
+        if (m_state.links[i].conn_handle != BLE_CONN_HANDLE_INVALID) {
+            return m_state.links[i].conn_handle;
+        }
+    }
+    return BLE_CONN_HANDLE_INVALID;
 }
 
 uint16_t nlr_ble_get_mtu(void)
 {
-    return m_state.mtu_size;
+    uint16_t mtu = 0;
+    
+    for (uint8_t i = 0; i < NLR_BLE_MAX_LINKS; i++) {
+        const nlr_ble_link_t *p_link = &m_state.links[i];
+        if (p_link->conn_handle != BLE_CONN_HANDLE_INVALID && (mtu == 0 || p_link->mtu_size < mtu)) {
+            mtu = p_link->mtu_size;
+        }
+    }
+    return (mtu == 0) ? 23 : mtu;
+}
+
+uint8_t nlr_ble_get_subscribers(uint16_t char_uuid)
+{
+    uint8_t sub = (char_uuid == NLR_UUID_CHAR_RR_INTERVAL)  ? SUB_RR :
+                  (char_uuid == NLR_UUID_CHAR_COHERENCE)    ? SUB_COHERENCE :
+                  (char_uuid == NLR_UUID_CHAR_DEVICE_STATE) ? SUB_DEVICE_STATE :
+                  (char_uuid == NLR_UUID_CHAR_CONFIG)       ? SUB_CONFIG :
+                  (char_uuid == NLR_UUID_CHAR_OTA)          ? SUB_OTA : 0;
+    uint8_t n = 0;
+    
+    for (uint8_t i = 0; i < NLR_BLE_MAX_LINKS; i++) {
+        if (m_state.links[i].conn_handle != BLE_CONN_HANDLE_INVALID && (m_state.links[i].cccd & sub)) {
+            n++;
+        }
+    }
+    return n;
+}
+
+uint8_t nlr_ble_get_tx_room(void)
+{
+    uint8_t room = 0;
+    bool any = false;
+    
+    for (uint8_t i = 0; i < NLR_BLE_MAX_LINKS; i++) {
+        const nlr_ble_link_t *p_link = &m_state.links[i];
+        if (p_link->conn_handle == BLE_CONN_HANDLE_INVALID || !(p_link->cccd & (SUB_RR | SUB_COHERENCE))) {
+            continue;
+        }
+        uint8_t slots = (p_link->tx_queue_count < NLR_TX_QUEUE_SIZE) ?
+                        (uint8_t)(NLR_TX_QUEUE_SIZE - p_link->tx_queue_count) : 0;
+        if (!any || slots < room) {
+            room = slots;
+        }
+        any = true;
+    }
+    return room;
 }
 
 void nlr_ble_process(void)
@@ -437,6 +569,10 @@ void nlr_ble_process(void)
 #ifdef NRF_SDK_PRESENT
     /* Process SoftDevice events */
     nrf_sdh_evts_poll();
+#elif defined(NLR_BLE_HOST_LINK)
+    /* Process central activity from the host link, then send what credits allow */
+    nlr_ble_host_poll();
+    bulk_pump();
 #endif
 }
 
@@ -458,12 +594,51 @@ static int softdevice_init(void)
     err = nrf_sdh_ble_default_cfg_set(1, &ram_start);
     if (err != NRF_SUCCESS) return -2;
     
+    /* Up to NLR_BLE_MAX_LINKS centrals at once */
+    ble_cfg_t cfg = {0};
+    cfg.gap_cfg.role_count_cfg.periph_role_count = NLR_BLE_MAX_LINKS;
+    cfg.gap_cfg.role_count_cfg.central_role_count = 0;
+    err = sd_ble_cfg_set(BLE_GAP_CFG_ROLE_COUNT, &cfg, ram_start);
+    if (err != NRF_SUCCESS) return -2;
+    
+    /* Fixed event length per link, so links_reschedule() can fit them side by side */
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.conn_cfg.conn_cfg_tag = 1;
+    cfg.conn_cfg.params.gap_conn_cfg.conn_count = NLR_BLE_MAX_LINKS;
+    cfg.conn_cfg.params.gap_conn_cfg.event_length = MSEC_TO_UNITS(NLR_CONN_EVENT_LEN_MS, CONN_INTERVAL_UNITS);
+    err = sd_ble_cfg_set(BLE_CONN_CFG_GAP, &cfg, ram_start);
+    if (err != NRF_SUCCESS) return -2;
+    
+    /* One bulk CoC channel per link; the SoftDevice segments and tracks credits */
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.conn_cfg.conn_cfg_tag = 1;
+    cfg.conn_cfg.params.l2cap_conn_cfg.rx_mps = NLR_L2CAP_MPS_MAX;
+    cfg.conn_cfg.params.l2cap_conn_cfg.tx_mps = NLR_L2CAP_MPS_MAX;
+    cfg.conn_cfg.params.l2cap_conn_cfg.rx_queue_size = NLR_L2CAP_RX_CREDITS;
+    cfg.conn_cfg.params.l2cap_conn_cfg.tx_queue_size = 1;
+    cfg.conn_cfg.params.l2cap_conn_cfg.ch_count = 1;
+    err = sd_ble_cfg_set(BLE_CONN_CFG_L2CAP, &cfg, ram_start);
+    if (err != NRF_SUCCESS) return -2;
+    
+    /* Service Changed characteristic: bonded centrals may cache the database */
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.gatts_cfg.service_changed.service_changed = 1;
+    err = sd_ble_cfg_set(BLE_GATTS_CFG_SERVICE_CHANGED, &cfg, ram_start);
+    if (err != NRF_SUCCESS) return -2;
+    
     /* Enable BLE stack */
     err = nrf_sdh_ble_enable(&ram_start);
     if (err != NRF_SUCCESS) return -3;
     
     /* Register BLE event handler */
     NRF_SDH_BLE_OBSERVER(m_ble_observer, 3, on_ble_evt, NULL);
+#else
+    /* No radio: the event paths are only reached through the host link */
+    (void)on_ble_evt;
+    (void)on_write_evt;
+    (void)on_gap_connected;
+    (void)on_gap_disconnected;
+    (void)on_bulk_sdu;
 #endif
     
     NRF_LOG_INFO("SoftDevice S140 initialized");
@@ -683,15 +858,22 @@ static int services_init(void)
         m_state.handles.device_state_cccd = handles.cccd_handle;
     }
     
-    /* 5. Configuration Characteristic (Read + Write) */
+    /* 5. Configuration Characteristic (Read + Write + Notify to the other centrals) */
     {
         ble_gatts_char_md_t char_md = {0};
+        ble_gatts_attr_md_t cccd_md = {0};
         ble_gatts_attr_md_t attr_md = {0};
         ble_gatts_attr_t    attr = {0};
         ble_uuid_t          char_uuid = { .uuid = NLR_UUID_CHAR_CONFIG, .type = m_state.uuid_type };
         
+        BLE_GAP_CONN_SEC_MODE_SET_OPEN(&cccd_md.read_perm);
+        BLE_GAP_CONN_SEC_MODE_SET_OPEN(&cccd_md.write_perm);
+        cccd_md.vloc = BLE_GATTS_VLOC_STACK;
+        
         char_md.char_props.read = 1;
         char_md.char_props.write = 1;
+        char_md.char_props.notify = 1;
+        char_md.p_cccd_md = &cccd_md;
         
         BLE_GAP_CONN_SEC_MODE_SET_OPEN(&attr_md.read_perm);
         BLE_GAP_CONN_SEC_MODE_SET_OPEN(&attr_md.write_perm);
@@ -709,10 +891,62 @@ static int services_init(void)
         if (err != NRF_SUCCESS) return -7;
         
         m_state.handles.config_handle = handles.value_handle;
+        m_state.handles.config_cccd = handles.cccd_handle;
     }
+    
+    /* 6. OTA Characteristic (Write + Notify) */
+    {
+        ble_gatts_char_md_t char_md = {0};
+        ble_gatts_attr_md_t cccd_md = {0};
+        ble_gatts_attr_md_t attr_md = {0};
+        ble_gatts_attr_t    attr = {0};
+        ble_uuid_t          char_uuid = { .uuid = NLR_UUID_CHAR_OTA, .type = m_state.uuid_type };
+        
+        BLE_GAP_CONN_SEC_MODE_SET_OPEN(&cccd_md.read_perm);
+        BLE_GAP_CONN_SEC_MODE_SET_OPEN(&cccd_md.write_perm);
+        cccd_md.vloc = BLE_GATTS_VLOC_STACK;
+        
+        char_md.char_props.write = 1;
+        char_md.char_props.write_wo_resp = 1;   /* DATA blocks */
+        char_md.char_props.notify = 1;
+        char_md.p_cccd_md = &cccd_md;
+        
+        /* Unencrypted writes fail with insufficient encryption; the central pairs first */
+        BLE_GAP_CONN_SEC_MODE_SET_NO_ACCESS(&attr_md.read_perm);
+        BLE_GAP_CONN_SEC_MODE_SET_ENC_NO_MITM(&attr_md.write_perm);
+        attr_md.vloc = BLE_GATTS_VLOC_STACK;
+        attr_md.vlen = 1;
+        
+        attr.p_uuid = &char_uuid;
+        attr.p_attr_md = &attr_md;
+        attr.init_len = 0;
+        attr.max_len = 7 + OTA_BLOCK_SIZE;
+        
+        ble_gatts_char_handles_t handles;
+        err = sd_ble_gatts_characteristic_add(m_state.handles.service_handle, 
+                                               &char_md, &attr, &handles);
+        if (err != NRF_SUCCESS) return -8;
+        
+        m_state.handles.ota_handle = handles.value_handle;
+        m_state.handles.ota_cccd = handles.cccd_handle;
+    }
+#elif defined(NLR_BLE_HOST_LINK)
+    /* Host link: value handle = 2 x UUID, CCCD right after it */
+    m_state.handles.service_handle = NLR_UUID_WELLNESS_SERVICE;
+    m_state.handles.rr_interval_handle = 2 * NLR_UUID_CHAR_RR_INTERVAL;
+    m_state.handles.rr_interval_cccd = 2 * NLR_UUID_CHAR_RR_INTERVAL + 1;
+    m_state.handles.coherence_handle = 2 * NLR_UUID_CHAR_COHERENCE;
+    m_state.handles.coherence_cccd = 2 * NLR_UUID_CHAR_COHERENCE + 1;
+    m_state.handles.actuator_ctrl_handle = 2 * NLR_UUID_CHAR_ACTUATOR_CTRL;
+    m_state.handles.device_state_handle = 2 * NLR_UUID_CHAR_DEVICE_STATE;
+    m_state.handles.device_state_cccd = 2 * NLR_UUID_CHAR_DEVICE_STATE + 1;
+    m_state.handles.config_handle = 2 * NLR_UUID_CHAR_CONFIG;
+    m_state.handles.config_cccd = 2 * NLR_UUID_CHAR_CONFIG + 1;
+    m_state.handles.ota_handle = 2 * NLR_UUID_CHAR_OTA;
+    m_state.handles.ota_cccd = 2 * NLR_UUID_CHAR_OTA + 1;
 #endif
     
-    NRF_LOG_INFO("Wellness Service registered with 5 characteristics");
+    NRF_LOG_INFO("Wellness Service registered with 6 characteristics");
     return 0;
 }
 
@@ -782,6 +1016,353 @@ static int conn_params_init(void)
  * PRIVATE FUNCTIONS - EVENT HANDLING
  ******************************************************************************/
 
+static nlr_ble_link_t *link_find(uint16_t conn_handle)
+{
+    if (conn_handle == BLE_CONN_HANDLE_INVALID) {
+        return NULL;
+    }
+    for (uint8_t i = 0; i < NLR_BLE_MAX_LINKS; i++) {
+        if (m_state.links[i].conn_handle == conn_handle) {
+            return &m_state.links[i];
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Every link is asked for the same interval, so their connection events
+ * keep fixed offsets and the SoftDevice slots them side by side instead of
+ * letting anchors drift into each other: the interval must hold one
+ * NLR_CONN_EVENT_LEN_MS event per link. A lone link keeps the usual range.
+ */
+static void links_reschedule(void)
+{
+    uint16_t min_ms = NLR_CONN_INTERVAL_MIN_MS;
+    uint16_t max_ms = NLR_CONN_INTERVAL_MAX_MS;
+    
+    if (m_state.link_count > 1) {
+        uint16_t need_ms = (uint16_t)(m_state.link_count * NLR_CONN_EVENT_LEN_MS);
+        max_ms = (need_ms > NLR_CONN_INTERVAL_MAX_MS) ? need_ms : NLR_CONN_INTERVAL_MAX_MS;
+        min_ms = max_ms;
+    }
+    m_state.conn_interval_ms = max_ms;
+    
+#ifdef NRF_SDK_PRESENT
+    ble_gap_conn_params_t conn_params = {
+        .min_conn_interval = MSEC_TO_UNITS(min_ms, CONN_INTERVAL_UNITS),
+        .max_conn_interval = MSEC_TO_UNITS(max_ms, CONN_INTERVAL_UNITS),
+        .slave_latency     = NLR_CONN_SLAVE_LATENCY,
+        .conn_sup_timeout  = MSEC_TO_UNITS(NLR_CONN_SUP_TIMEOUT_MS, 10000),
+    };
+    
+    /* Centrals that connect next are asked for the same */
+    sd_ble_gap_ppcp_set(&conn_params);
+    for (uint8_t i = 0; i < NLR_BLE_MAX_LINKS; i++) {
+        if (m_state.links[i].conn_handle != BLE_CONN_HANDLE_INVALID) {
+            sd_ble_gap_conn_param_update(m_state.links[i].conn_handle, &conn_params);
+        }
+    }
+#else
+    (void)min_ms;
+#endif
+    
+    NRF_LOG_INFO("%d link(s): connection interval %d ms", m_state.link_count, max_ms);
+}
+
+/**
+ * Notify every link subscribed to a value, all from the one encoded buffer.
+ * A link with a full queue misses this value rather than holding back the
+ * others.
+ *
+ * @return Links that took it, -2 no subscriber, -4 every subscriber's queue full
+ */
+static int notify_fanout(uint8_t sub, uint16_t char_uuid, uint16_t value_handle,
+                         const uint8_t *p_data, uint16_t len)
+{
+    int subscribed = 0;
+    int sent = 0;
+    
+    for (uint8_t i = 0; i < NLR_BLE_MAX_LINKS; i++) {
+        nlr_ble_link_t *p_link = &m_state.links[i];
+        if (p_link->conn_handle == BLE_CONN_HANDLE_INVALID || !(p_link->cccd & sub)) {
+            continue;
+        }
+        subscribed++;
+        
+        if (p_link->tx_queue_count >= NLR_TX_QUEUE_SIZE) {
+            p_link->tx_drops++;
+            continue;
+        }
+        
+#ifdef NRF_SDK_PRESENT
+        uint16_t hvx_len = len;
+        ble_gatts_hvx_params_t hvx_params = {
+            .handle = value_handle,
+            .type   = BLE_GATT_HVX_NOTIFICATION,
+            .offset = 0,
+            .p_len  = &hvx_len,
+            .p_data = p_data,
+        };
+        
+        ret_code_t err = sd_ble_gatts_hvx(p_link->conn_handle, &hvx_params);
+        if (err == NRF_SUCCESS) {
+            p_link->tx_queue_count++;
+            sent++;
+        } else {
+            if (err != NRF_ERROR_RESOURCES) {
+                NRF_LOG_WARNING("Notification failed: handle=%d err=%d", p_link->conn_handle, err);
+            }
+            p_link->tx_drops++;
+        }
+        (void)char_uuid;
+#elif defined(NLR_BLE_HOST_LINK)
+        (void)value_handle;
+        if (nlr_ble_host_notify(p_link->conn_handle, char_uuid, p_data, len) == 0) {
+            sent++;
+        } else {
+            p_link->tx_drops++;
+        }
+#else
+        (void)char_uuid;
+        (void)value_handle;
+        (void)p_data;
+        (void)len;
+        sent++;
+#endif
+    }
+    
+    if (subscribed == 0) {
+        return -2;
+    }
+    return (sent > 0) ? sent : -4;
+}
+
+/*
+ * Stand-in for the GATT Database Hash: a CRC over the revision and every
+ * handle, so a firmware image whose table moved gets a different value.
+ */
+static uint32_t gatt_db_hash(void)
+{
+    uint32_t revision = NLR_GATT_DB_REVISION;
+    uint32_t crc = ota_crc32(0, &revision, sizeof(revision));
+    
+    return ota_crc32(crc, &m_state.handles, sizeof(m_state.handles));
+}
+
+/*
+ * A bonded central kept its attribute cache and its subscriptions: restore
+ * the CCCDs now and notifications go out from the first connection event,
+ * without discovery or CCCD writes. If the layout moved since it last
+ * looked, indicate Service Changed instead; it rediscovers and subscribes
+ * again.
+ */
+static void link_resume(nlr_ble_link_t *p_link, uint8_t slot)
+{
+    const nlr_bond_t *p_bond = ble_bond_get(slot);
+    
+    p_link->bond = (int8_t)slot;
+    ble_bond_touch(slot);
+    
+    if (p_bond->db_hash != m_state.db_hash) {
+        link_service_changed(p_link);
+        return;
+    }
+    p_link->db_synced = true;
+    p_link->cccd = p_bond->cccd;
+    
+#ifdef NRF_SDK_PRESENT
+    /* CCCDs live in the SoftDevice's system attributes, per connection */
+    const struct { uint8_t sub; uint16_t handle; } cccds[] = {
+        { SUB_RR,           m_state.handles.rr_interval_cccd },
+        { SUB_COHERENCE,    m_state.handles.coherence_cccd },
+        { SUB_DEVICE_STATE, m_state.handles.device_state_cccd },
+        { SUB_CONFIG,       m_state.handles.config_cccd },
+        { SUB_OTA,          m_state.handles.ota_cccd },
+    };
+    sd_ble_gatts_sys_attr_set(p_link->conn_handle, NULL, 0, 0);
+    for (uint8_t i = 0; i < sizeof(cccds) / sizeof(cccds[0]); i++) {
+        if (p_link->cccd & cccds[i].sub) {
+            uint8_t enabled[2] = { BLE_GATT_HVX_NOTIFICATION, 0x00 };
+            ble_gatts_value_t value = { .len = sizeof(enabled), .offset = 0, .p_value = enabled };
+            sd_ble_gatts_value_set(p_link->conn_handle, cccds[i].handle, &value);
+        }
+    }
+#endif
+    
+    NRF_LOG_INFO("Link %d resumed bond %d, notifications 0x%02X", p_link->conn_handle, slot, p_link->cccd);
+    if (p_link->cccd & (SUB_RR | SUB_COHERENCE | SUB_DEVICE_STATE)) {
+        dispatch_event(NLR_BLE_EVT_NOTIFICATIONS_ENABLED, NULL);
+    }
+}
+
+/** Pairing finished with bonding: remember this central */
+static void link_bond(nlr_ble_link_t *p_link, const nlr_bond_keys_t *p_keys)
+{
+    int slot = ble_bond_store(p_link->peer_addr, p_link->peer_addr_type, p_keys, p_link->cccd,
+                              m_state.db_hash);
+    if (slot < 0) {
+        NRF_LOG_WARNING("Bond not stored: %d", slot);
+        return;
+    }
+    
+    /* It has just discovered this layout */
+    p_link->bond = (int8_t)slot;
+    p_link->db_synced = true;
+    NRF_LOG_INFO("Link %d bonded in slot %d", p_link->conn_handle, slot);
+#ifdef NRF_SDK_PRESENT
+    bonds_identities_set();
+#endif
+}
+
+/** Tell a bonded central its attribute cache is stale (whole Wellness Service) */
+static void link_service_changed(nlr_ble_link_t *p_link)
+{
+#ifdef NRF_SDK_PRESENT
+    /* db_synced once the central confirms (BLE_GATTS_EVT_SC_CONFIRM) */
+    sd_ble_gatts_service_changed(p_link->conn_handle, m_state.handles.service_handle, 0xFFFF);
+#elif defined(NLR_BLE_HOST_LINK)
+    /* The host link has no confirmation: sent counts as confirmed */
+    nlr_ble_host_service_changed(p_link->conn_handle, m_state.handles.service_handle, 0xFFFF);
+    p_link->db_synced = true;
+#else
+    p_link->db_synced = true;
+#endif
+    NRF_LOG_INFO("Link %d: GATT layout changed, Service Changed sent", p_link->conn_handle);
+}
+
+#ifdef NRF_SDK_PRESENT
+/*
+ * Ask for the large ATT MTU, data length and 2M PHY together as soon as
+ * the link is up, instead of waiting for the central to get to each: the
+ * three procedures then overlap in the first connection events.
+ */
+static void link_fast_start(uint16_t conn_handle)
+{
+    ble_gap_data_length_params_t dl = {
+        .max_tx_octets  = NLR_DLE_OCTETS_MAX,
+        .max_rx_octets  = NLR_DLE_OCTETS_MAX,
+        .max_tx_time_us = BLE_GAP_DATA_LENGTH_AUTO,
+        .max_rx_time_us = BLE_GAP_DATA_LENGTH_AUTO,
+    };
+    ble_gap_phys_t phys = { .tx_phys = BLE_GAP_PHY_2MBPS, .rx_phys = BLE_GAP_PHY_2MBPS };
+    
+    sd_ble_gattc_exchange_mtu_request(conn_handle, NLR_ATT_MTU_MAX);
+    sd_ble_gap_data_length_update(conn_handle, &dl, NULL);
+    sd_ble_gap_phy_update(conn_handle, &phys);
+}
+
+/** Hand the bonded IRKs to the SoftDevice so private addresses resolve on connect */
+static void bonds_identities_set(void)
+{
+    static ble_gap_id_key_t id_keys[NLR_BOND_MAX_PEERS];
+    ble_gap_id_key_t const *p_keys[NLR_BOND_MAX_PEERS];
+    uint8_t count = 0;
+    
+    for (uint8_t i = 0; i < NLR_BOND_MAX_PEERS; i++) {
+        const nlr_bond_t *p_bond = ble_bond_get(i);
+        if (p_bond == NULL || !(p_bond->flags & NLR_BOND_FLAG_IRK)) {
+            continue;
+        }
+        memcpy(id_keys[count].id_info.irk, p_bond->keys.irk, sizeof(p_bond->keys.irk));
+        id_keys[count].id_addr_info.addr_type = p_bond->addr_type;
+        memcpy(id_keys[count].id_addr_info.addr, p_bond->addr, 6);
+        p_keys[count] = &id_keys[count];
+        count++;
+    }
+    
+    /* Refused while advertising; the list is set again after the next bond */
+    (void)sd_ble_gap_device_identities_set(count ? p_keys : NULL, NULL, count);
+}
+#endif
+
+static void on_gap_connected(uint16_t conn_handle, const uint8_t *p_peer_addr)
+{
+    nlr_ble_link_t *p_link = NULL;
+    
+    for (uint8_t i = 0; i < NLR_BLE_MAX_LINKS && p_link == NULL; i++) {
+        if (m_state.links[i].conn_handle == BLE_CONN_HANDLE_INVALID) {
+            p_link = &m_state.links[i];
+        }
+    }
+    if (p_link == NULL) {
+        return; /* Role count is NLR_BLE_MAX_LINKS; cannot happen */
+    }
+    
+    memset(p_link, 0, sizeof(*p_link));
+    p_link->conn_handle = conn_handle;
+    p_link->mtu_size = 23;  /* Default BLE 4.0 MTU until exchanged */
+    memcpy(p_link->peer_addr, p_peer_addr, 6);
+    p_link->bond = -1;
+    m_state.link_count++;
+    m_state.advertising = false;
+    m_state.device_state.connection_state = 2; /* Connected */
+    
+    NRF_LOG_INFO("Connected: handle=%d (%d links)", conn_handle, m_state.link_count);
+    links_reschedule();
+    
+    /* Notify application */
+    nlr_ble_evt_t evt = {
+        .type = NLR_BLE_EVT_CONNECTED,
+        .data.connected.conn_handle = conn_handle,
+    };
+    memcpy(evt.data.connected.peer_addr, p_peer_addr, 6);
+    dispatch_event(NLR_BLE_EVT_CONNECTED, &evt);
+    
+    int slot = ble_bond_find(p_peer_addr);
+    if (slot >= 0) {
+        link_resume(p_link, (uint8_t)slot);
+    }
+    
+    /* Stay connectable for the next central */
+    if (m_state.link_count < NLR_BLE_MAX_LINKS) {
+        nlr_ble_advertising_start();
+    }
+}
+
+static void on_gap_disconnected(uint16_t conn_handle, uint8_t reason)
+{
+    nlr_ble_link_t *p_link = link_find(conn_handle);
+    
+    if (p_link == NULL) {
+        return;
+    }
+    
+    if (m_state.bulk_conn == conn_handle) {
+        bulk_closed();
+    }
+    
+    /* Subscriptions (and the layout it now knows) come back on the next connection;
+       its place in the replacement order is saved with them */
+    if (p_link->bond >= 0) {
+        const nlr_bond_t *p_bond = ble_bond_get((uint8_t)p_link->bond);
+        if (p_bond != NULL) {
+            (void)ble_bond_update((uint8_t)p_link->bond, p_link->cccd,
+                                  p_link->db_synced ? m_state.db_hash : p_bond->db_hash);
+        }
+    }
+    p_link->conn_handle = BLE_CONN_HANDLE_INVALID;
+    p_link->cccd = 0;
+    m_state.link_count--;
+    if (m_state.link_count == 0) {
+        m_state.device_state.streaming_active = 0;
+        m_state.device_state.connection_state = 0;
+    }
+    
+    NRF_LOG_INFO("Disconnected: handle=%d, reason=0x%02X", conn_handle, reason);
+    links_reschedule();
+    
+    /* Notify application */
+    nlr_ble_evt_t evt = {
+        .type = NLR_BLE_EVT_DISCONNECTED,
+        .data.disconnected.conn_handle = conn_handle,
+        .data.disconnected.reason = reason,
+    };
+    dispatch_event(NLR_BLE_EVT_DISCONNECTED, &evt);
+    
+    /* Auto-restart advertising */
+    nlr_ble_advertising_start();
+}
+
 #ifdef NRF_SDK_PRESENT
 static void on_ble_evt(ble_evt_t const *p_ble_evt, void *p_context)
 {
@@ -790,50 +1371,41 @@ static void on_ble_evt(ble_evt_t const *p_ble_evt, void *p_context)
     switch (p_ble_evt->header.evt_id) {
         case BLE_GAP_EVT_CONNECTED:
         {
-            m_state.conn_handle = p_ble_evt->evt.gap_evt.conn_handle;
-            m_state.advertising = false;
-            m_state.device_state.connection_state = 2; /* Connected */
-            m_state.tx_queue_count = 0;
+            /* A resolved private address connects as the bond's identity */
+            ble_gap_evt_connected_t const *p_conn = &p_ble_evt->evt.gap_evt.params.connected;
+            uint16_t conn_handle = p_ble_evt->evt.gap_evt.conn_handle;
+            ble_gap_addr_t const *p_addr = &p_conn->peer_addr;
+            ble_gap_addr_t identity;
             
-            NRF_LOG_INFO("Connected: handle=%d", m_state.conn_handle);
-            
-            /* Notify application */
-            nlr_ble_evt_t evt = {
-                .type = NLR_BLE_EVT_CONNECTED,
-                .data.connected.conn_handle = m_state.conn_handle,
-            };
-            memcpy(evt.data.connected.peer_addr, 
-                   p_ble_evt->evt.gap_evt.params.connected.peer_addr.addr, 6);
-            dispatch_event(NLR_BLE_EVT_CONNECTED, &evt);
+            if (p_conn->irk_match) {
+                const nlr_bond_t *p_bond = NULL;
+                uint8_t seen = 0;
+                for (uint8_t i = 0; i < NLR_BOND_MAX_PEERS && p_bond == NULL; i++) {
+                    const nlr_bond_t *p = ble_bond_get(i);
+                    if (p != NULL && (p->flags & NLR_BOND_FLAG_IRK) && seen++ == p_conn->irk_match_idx) {
+                        p_bond = p;
+                    }
+                }
+                if (p_bond != NULL) {
+                    identity.addr_id_peer = 1;
+                    identity.addr_type = p_bond->addr_type;
+                    memcpy(identity.addr, p_bond->addr, 6);
+                    p_addr = &identity;
+                }
+            }
+            on_gap_connected(conn_handle, p_addr->addr);
+            nlr_ble_link_t *p_link = link_find(conn_handle);
+            if (p_link != NULL) {
+                p_link->peer_addr_type = p_addr->addr_type;
+                link_fast_start(conn_handle);
+            }
             break;
         }
         
         case BLE_GAP_EVT_DISCONNECTED:
-        {
-            uint16_t old_handle = m_state.conn_handle;
-            uint8_t reason = p_ble_evt->evt.gap_evt.params.disconnected.reason;
-            
-            m_state.conn_handle = BLE_CONN_HANDLE_INVALID;
-            m_state.rr_notifications_enabled = false;
-            m_state.coherence_notifications_enabled = false;
-            m_state.device_state_notifications_enabled = false;
-            m_state.device_state.streaming_active = 0;
-            m_state.device_state.connection_state = 0;
-            
-            NRF_LOG_INFO("Disconnected: handle=%d, reason=0x%02X", old_handle, reason);
-            
-            /* Notify application */
-            nlr_ble_evt_t evt = {
-                .type = NLR_BLE_EVT_DISCONNECTED,
-                .data.disconnected.conn_handle = old_handle,
-                .data.disconnected.reason = reason,
-            };
-            dispatch_event(NLR_BLE_EVT_DISCONNECTED, &evt);
-            
-            /* Auto-restart advertising */
-            nlr_ble_advertising_start();
+            on_gap_disconnected(p_ble_evt->evt.gap_evt.conn_handle,
+                                p_ble_evt->evt.gap_evt.params.disconnected.reason);
             break;
-        }
         
         case BLE_GAP_EVT_PHY_UPDATE_REQUEST:
         {
@@ -844,46 +1416,228 @@ static void on_ble_evt(ble_evt_t const *p_ble_evt, void *p_context)
         }
         
         case BLE_GATTC_EVT_TIMEOUT:
+            /* GATT timeout - disconnect that link */
+            sd_ble_gap_disconnect(p_ble_evt->evt.gattc_evt.conn_handle,
+                                  BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION);
+            break;
+        
         case BLE_GATTS_EVT_TIMEOUT:
-        {
-            /* GATT timeout - disconnect */
-            sd_ble_gap_disconnect(m_state.conn_handle, BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION);
+            sd_ble_gap_disconnect(p_ble_evt->evt.gatts_evt.conn_handle,
+                                  BLE_HCI_REMOTE_USER_TERMINATED_CONNECTION);
             break;
-        }
         
         case BLE_GATTS_EVT_WRITE:
         {
             ble_gatts_evt_write_t const *p_write = &p_ble_evt->evt.gatts_evt.params.write;
-            on_write_evt(p_write->handle, p_write->data, p_write->len);
+            nlr_ble_link_t *p_link = link_find(p_ble_evt->evt.gatts_evt.conn_handle);
+            if (p_link != NULL) {
+                on_write_evt(p_link, p_write->handle, p_write->data, p_write->len);
+            }
             break;
         }
         
         case BLE_GATTS_EVT_HVN_TX_COMPLETE:
         {
-            /* TX complete - decrement queue count */
+            /* TX complete - decrement that link's queue count */
+            nlr_ble_link_t *p_link = link_find(p_ble_evt->evt.gatts_evt.conn_handle);
             uint8_t count = p_ble_evt->evt.gatts_evt.params.hvn_tx_complete.count;
-            if (m_state.tx_queue_count >= count) {
-                m_state.tx_queue_count -= count;
+            if (p_link == NULL) {
+                break;
+            }
+            if (p_link->tx_queue_count >= count) {
+                p_link->tx_queue_count -= count;
             } else {
-                m_state.tx_queue_count = 0;
+                p_link->tx_queue_count = 0;
             }
             break;
         }
         
         case BLE_GATTS_EVT_EXCHANGE_MTU_REQUEST:
         {
-            /* Respond with our max MTU */
-            sd_ble_gatts_exchange_mtu_reply(m_state.conn_handle, 247);
+            /* Respond with our max MTU; the link uses the smaller of the two */
+            uint16_t conn_handle = p_ble_evt->evt.gatts_evt.conn_handle;
+            uint16_t client_mtu = p_ble_evt->evt.gatts_evt.params.exchange_mtu_request.client_rx_mtu;
+            nlr_ble_link_t *p_link = link_find(conn_handle);
+            
+            sd_ble_gatts_exchange_mtu_reply(conn_handle, 247);
+            if (p_link != NULL) {
+                p_link->mtu_size = (client_mtu < 23) ? 23 : (client_mtu > 247) ? 247 : client_mtu;
+                nlr_ble_evt_t evt = {
+                    .type = NLR_BLE_EVT_MTU_UPDATED,
+                    .data.mtu.conn_handle = conn_handle,
+                    .data.mtu.mtu = p_link->mtu_size,
+                };
+                dispatch_event(NLR_BLE_EVT_MTU_UPDATED, &evt);
+            }
+            break;
+        }
+        
+        case BLE_GATTC_EVT_EXCHANGE_MTU_RSP:
+        {
+            /* Our request from link_fast_start() */
+            uint16_t conn_handle = p_ble_evt->evt.gattc_evt.conn_handle;
+            uint16_t server_mtu = p_ble_evt->evt.gattc_evt.params.exchange_mtu_rsp.server_rx_mtu;
+            nlr_ble_link_t *p_link = link_find(conn_handle);
+            
+            if (p_link != NULL) {
+                p_link->mtu_size = (server_mtu < 23) ? 23 :
+                                   (server_mtu > NLR_ATT_MTU_MAX) ? NLR_ATT_MTU_MAX : server_mtu;
+                nlr_ble_evt_t evt = {
+                    .type = NLR_BLE_EVT_MTU_UPDATED,
+                    .data.mtu.conn_handle = conn_handle,
+                    .data.mtu.mtu = p_link->mtu_size,
+                };
+                dispatch_event(NLR_BLE_EVT_MTU_UPDATED, &evt);
+            }
             break;
         }
         
-        case BLE_GAP_EVT_DATA_LENGTH_UPDATE:
         case BLE_GAP_EVT_DATA_LENGTH_UPDATE_REQUEST:
+            /* Accept, with whatever the controller supports */
+            sd_ble_gap_data_length_update(p_ble_evt->evt.gap_evt.conn_handle, NULL, NULL);
+            break;
+        
+        case BLE_GAP_EVT_DATA_LENGTH_UPDATE:
+            break;
+        
+        case BLE_GAP_EVT_SEC_PARAMS_REQUEST:
         {
-            /* Accept data length updates */
+            /* No display or keys on a ring: Just Works, bonded */
+            uint16_t conn_handle = p_ble_evt->evt.gap_evt.conn_handle;
+            nlr_ble_link_t *p_link = link_find(conn_handle);
+            ble_gap_sec_params_t params = {
+                .bond = 1,
+                .io_caps = BLE_GAP_IO_CAPS_NONE,
+                .min_key_size = 7,
+                .max_key_size = 16,
+                .kdist_own = { .enc = 1 },
+                .kdist_peer = { .id = 1 },
+            };
+            ble_gap_sec_keyset_t keyset = { 0 };
+            
+            if (p_link == NULL) {
+                break;
+            }
+            keyset.keys_own.p_enc_key = &p_link->own_enc;
+            keyset.keys_peer.p_id_key = &p_link->peer_id;
+            sd_ble_gap_sec_params_reply(conn_handle, BLE_GAP_SEC_STATUS_SUCCESS, &params, &keyset);
             break;
         }
         
+        case BLE_GAP_EVT_AUTH_STATUS:
+        {
+            ble_gap_evt_auth_status_t const *p_auth = &p_ble_evt->evt.gap_evt.params.auth_status;
+            nlr_ble_link_t *p_link = link_find(p_ble_evt->evt.gap_evt.conn_handle);
+            
+            if (p_link == NULL || p_auth->auth_status != BLE_GAP_SEC_STATUS_SUCCESS || !p_auth->bonded) {
+                break;
+            }
+            nlr_bond_keys_t keys = { 0 };
+            memcpy(keys.ltk, p_link->own_enc.enc_info.ltk, sizeof(keys.ltk));
+            memcpy(keys.rand, p_link->own_enc.master_id.rand, sizeof(keys.rand));
+            keys.ediv = p_link->own_enc.master_id.ediv;
+            if (p_auth->kdist_peer.id) {
+                /* Bond under the identity address, not this connection's private one */
+                memcpy(keys.irk, p_link->peer_id.id_info.irk, sizeof(keys.irk));
+                memcpy(p_link->peer_addr, p_link->peer_id.id_addr_info.addr, 6);
+                p_link->peer_addr_type = p_link->peer_id.id_addr_info.addr_type;
+            }
+            link_bond(p_link, &keys);
+            break;
+        }
+        
+        case BLE_GAP_EVT_CONN_SEC_UPDATE:
+        {
+            /* Pairing finished, or a bonded central re-encrypted with its LTK */
+            ble_gap_conn_sec_t const *p_sec = &p_ble_evt->evt.gap_evt.params.conn_sec_update.conn_sec;
+            nlr_ble_link_t *p_link = link_find(p_ble_evt->evt.gap_evt.conn_handle);
+            
+            if (p_link != NULL) {
+                p_link->encrypted = (p_sec->sec_mode.sm == 1 && p_sec->sec_mode.lv >= 2);
+            }
+            break;
+        }
+        
+        case BLE_GAP_EVT_SEC_INFO_REQUEST:
+        {
+            /* A bonded central re-encrypting: hand back its LTK */
+            ble_gap_evt_sec_info_request_t const *p_req = &p_ble_evt->evt.gap_evt.params.sec_info_request;
+            int slot = ble_bond_find_master_id(p_req->master_id.ediv, p_req->master_id.rand);
+            ble_gap_enc_info_t enc = { .lesc = 0, .auth = 0, .ltk_len = 16 };
+            
+            if (slot < 0) {
+                sd_ble_gap_sec_info_reply(p_ble_evt->evt.gap_evt.conn_handle, NULL, NULL, NULL);
+                break;
+            }
+            memcpy(enc.ltk, ble_bond_get((uint8_t)slot)->keys.ltk, sizeof(enc.ltk));
+            sd_ble_gap_sec_info_reply(p_ble_evt->evt.gap_evt.conn_handle, &enc, NULL, NULL);
+            break;
+        }
+        
+        case BLE_GATTS_EVT_SYS_ATTR_MISSING:
+            /* Not restored by link_resume(): start with every CCCD off */
+            sd_ble_gatts_sys_attr_set(p_ble_evt->evt.gatts_evt.conn_handle, NULL, 0, 0);
+            break;
+        
+        case BLE_GATTS_EVT_SC_CONFIRM:
+        {
+            nlr_ble_link_t *p_link = link_find(p_ble_evt->evt.gatts_evt.conn_handle);
+            if (p_link != NULL) {
+                p_link->db_synced = true;
+            }
+            break;
+        }
+        
+        case BLE_L2CAP_EVT_CH_SETUP_REQUEST:
+        {
+            /* Accept one bulk channel on our PSM, first SDU buffer with it */
+            ble_l2cap_evt_t const *p_l2cap = &p_ble_evt->evt.l2cap_evt;
+            uint16_t cid = p_l2cap->local_cid;
+            ble_l2cap_ch_setup_params_t params = {
+                .rx_params = {
+                    .rx_mtu  = NLR_L2CAP_SDU_MAX,
+                    .rx_mps  = NLR_L2CAP_MPS_MAX,
+                    .sdu_buf = { .p_data = m_state.bulk_rx, .len = sizeof(m_state.bulk_rx) },
+                },
+                .status = BLE_L2CAP_CH_STATUS_CODE_SUCCESS,
+            };
+            if (p_l2cap->params.ch_setup_request.le_psm != NLR_L2CAP_PSM) {
+                params.status = BLE_L2CAP_CH_STATUS_CODE_LE_PSM_NOT_SUPPORTED;
+            } else if (m_state.bulk_cid != 0xFFFF) {
+                params.status = BLE_L2CAP_CH_STATUS_CODE_NO_RESOURCES; /* Another link has it */
+            }
+            sd_ble_l2cap_ch_setup(p_l2cap->conn_handle, &cid, &params);
+            break;
+        }
+        
+        case BLE_L2CAP_EVT_CH_SETUP:
+            m_state.bulk_conn = p_ble_evt->evt.l2cap_evt.conn_handle;
+            m_state.bulk_cid = p_ble_evt->evt.l2cap_evt.local_cid;
+            m_state.bulk_tx_busy = false;
+            NRF_LOG_INFO("Bulk channel open: cid=0x%04X, peer mtu=%d",
+                         m_state.bulk_cid,
+                         p_ble_evt->evt.l2cap_evt.params.ch_setup.tx_params.tx_mtu);
+            break;
+        
+        case BLE_L2CAP_EVT_CH_RX:
+        {
+            ble_l2cap_evt_t const *p_l2cap = &p_ble_evt->evt.l2cap_evt;
+            ble_data_t buf = { .p_data = m_state.bulk_rx, .len = sizeof(m_state.bulk_rx) };
+            
+            on_bulk_sdu(p_l2cap->params.rx.sdu_buf.p_data, p_l2cap->params.rx.sdu_len);
+            /* Handled in place: hand the same buffer back for the next SDU */
+            sd_ble_l2cap_ch_rx(p_l2cap->conn_handle, p_l2cap->local_cid, &buf);
+            break;
+        }
+        
+        case BLE_L2CAP_EVT_CH_TX:
+            m_state.bulk_tx_busy = false;
+            break;
+        
+        case BLE_L2CAP_EVT_CH_RELEASED:
+            bulk_closed();
+            break;
+        
         default:
             break;
     }
@@ -896,22 +1650,34 @@ static void on_ble_evt(uint16_t evt_id, void *p_evt_data)
 }
 #endif
 
-static void on_write_evt(uint16_t handle, const uint8_t *data, uint16_t len)
+static void on_write_evt(nlr_ble_link_t *p_link, uint16_t handle, const uint8_t *data, uint16_t len)
 {
-    /* Handle CCCD writes (notification enable/disable) */
+    /* Handle CCCD writes (notification enable/disable, per link) */
     if (len == 2) {
         uint16_t cccd_value = (data[1] << 8) | data[0];
         bool notifications_enabled = (cccd_value & 0x0001) != 0;
+        uint8_t sub = 0;
         
         if (handle == m_state.handles.rr_interval_cccd) {
-            m_state.rr_notifications_enabled = notifications_enabled;
-            NRF_LOG_INFO("RR notifications %s", notifications_enabled ? "enabled" : "disabled");
+            sub = SUB_RR;
         } else if (handle == m_state.handles.coherence_cccd) {
-            m_state.coherence_notifications_enabled = notifications_enabled;
-            NRF_LOG_INFO("Coherence notifications %s", notifications_enabled ? "enabled" : "disabled");
+            sub = SUB_COHERENCE;
         } else if (handle == m_state.handles.device_state_cccd) {
-            m_state.device_state_notifications_enabled = notifications_enabled;
-            NRF_LOG_INFO("Device state notifications %s", notifications_enabled ? "enabled" : "disabled");
+            sub = SUB_DEVICE_STATE;
+        } else if (handle == m_state.handles.config_cccd) {
+            sub = SUB_CONFIG;
+        } else if (handle == m_state.handles.ota_cccd) {
+            sub = SUB_OTA;
+        }
+        
+        if (notifications_enabled) {
+            p_link->cccd |= sub;
+        } else {
+            p_link->cccd &= (uint8_t)~sub;
+        }
+        NRF_LOG_INFO("Link %d notifications 0x%02X", p_link->conn_handle, p_link->cccd);
+        if (sub == SUB_OTA || sub == SUB_CONFIG) {
+            return;
         }
         
         /* Notify application */
@@ -947,6 +1713,12 @@ static void on_write_evt(uint16_t handle, const uint8_t *data, uint16_t len)
         return;
     }
     
+    /* Handle OTA packets (GATT fallback for centrals without the bulk channel) */
+    if (handle == m_state.handles.ota_handle) {
+        on_ota_packet(p_link, data, len, false);
+        return;
+    }
+    
     /* Handle Configuration writes */
     if (handle == m_state.handles.config_handle && len == sizeof(nlr_config_t)) {
         nlr_config_t new_config;
@@ -962,11 +1734,18 @@ static void on_write_evt(uint16_t handle, const uint8_t *data, uint16_t len)
         if (new_config.quiet_hours_start > 23) new_config.quiet_hours_start = 23;
         if (new_config.quiet_hours_end > 23) new_config.quiet_hours_end = 23;
         if (new_config.led_brightness > 100) new_config.led_brightness = 100;
+        if (new_config.detector_id >= PEAK_DETECTOR_COUNT) new_config.detector_id = PPG_DETECTOR_DEFAULT;
+        new_config.central_caps &= NLR_CENTRAL_CAP_MASK;
         
         memcpy(&m_state.config, &new_config, sizeof(nlr_config_t));
         
-        NRF_LOG_INFO("Config updated: rate=%dHz, coherence=%ds",
-                     new_config.streaming_rate_hz, new_config.coherence_update_s);
+        NRF_LOG_INFO("Config updated: rate=%dHz, coherence=%ds, detector=%d",
+                     new_config.streaming_rate_hz, new_config.coherence_update_s,
+                     new_config.detector_id);
+        
+        /* Other centrals (and the writer, with the clamped values) follow the change */
+        (void)notify_fanout(SUB_CONFIG, NLR_UUID_CHAR_CONFIG, m_state.handles.config_handle,
+                            (const uint8_t *)&m_state.config, sizeof(nlr_config_t));
         
         /* Notify application */
         nlr_ble_evt_t evt = {
@@ -977,6 +1756,87 @@ static void on_write_evt(uint16_t handle, const uint8_t *data, uint16_t len)
     }
 }
 
+/**
+ * OTA packet from either path; the response goes back the same way, to that
+ * link. FINISH resets into the bootloader, and the image is only CRC-checked,
+ * so only a bonded central on an encrypted link may drive a transfer.
+ */
+static void on_ota_packet(nlr_ble_link_t *p_link, const uint8_t *data, uint16_t len, bool via_bulk)
+{
+    uint8_t rsp[OTA_RSP_MAX_LEN];
+    uint16_t rsp_len;
+    
+    if (p_link != NULL && p_link->bond >= 0 && p_link->encrypted) {
+        rsp_len = ota_update_on_write(data, len, rsp);
+    } else if (len > 0) {
+        NRF_LOG_WARNING("OTA write on an unbonded or unencrypted link, rejected");
+        rsp[0] = data[0];
+        rsp[1] = (uint8_t)(int8_t)OTA_STATUS_INSECURE_LINK;
+        rsp_len = 2;
+    } else {
+        rsp_len = 0;
+    }
+    
+    if (rsp_len > 0 && via_bulk) {
+        (void)nlr_ble_bulk_send(NLR_BULK_STREAM_OTA, rsp, rsp_len);
+    } else if (rsp_len > 0 && p_link != NULL && (p_link->cccd & SUB_OTA)) {
+#ifdef NRF_SDK_PRESENT
+        ble_gatts_hvx_params_t hvx_params = {
+            .handle = m_state.handles.ota_handle,
+            .type   = BLE_GATT_HVX_NOTIFICATION,
+            .offset = 0,
+            .p_len  = &rsp_len,
+            .p_data = rsp,
+        };
+        (void)sd_ble_gatts_hvx(p_link->conn_handle, &hvx_params);
+#elif defined(NLR_BLE_HOST_LINK)
+        (void)nlr_ble_host_notify(p_link->conn_handle, NLR_UUID_CHAR_OTA, rsp, rsp_len);
+#endif
+    }
+    if (rsp_len == 2 && rsp[0] == OTA_OP_FINISH && rsp[1] == 0) {
+        NRF_LOG_INFO("OTA image verified, pending install");
+        dispatch_event(NLR_BLE_EVT_OTA_READY, NULL);
+    }
+}
+
+/** One SDU from the bulk channel: route by stream byte */
+static void on_bulk_sdu(const uint8_t *data, uint16_t len)
+{
+    if (len < 1) {
+        return;
+    }
+    
+    switch (data[0]) {
+        case NLR_BULK_STREAM_OTA:
+            on_ota_packet(link_find(m_state.bulk_conn), &data[1], (uint16_t)(len - 1U), true);
+            break;
+        
+        case NLR_BULK_STREAM_PPG_RAW:
+            if (len >= 2) {
+                nlr_ble_evt_t evt = {
+                    .type = NLR_BLE_EVT_PPG_CAPTURE,
+                    .data.capture.enable = (data[1] != 0),
+                };
+                dispatch_event(NLR_BLE_EVT_PPG_CAPTURE, &evt);
+            }
+            break;
+        
+        default:
+            NRF_LOG_WARNING("Bulk SDU for unknown stream 0x%02X", data[0]);
+            break;
+    }
+}
+
+static void bulk_closed(void)
+{
+    m_state.bulk_conn = BLE_CONN_HANDLE_INVALID;
+    m_state.bulk_cid = 0xFFFF;
+    m_state.bulk_tx_busy = false;
+#ifdef NLR_BLE_HOST_LINK
+    nlr_l2cap_close(&m_state.bulk);
+#endif
+}
+
 static void dispatch_event(nlr_ble_evt_type_t type, const void *data)
 {
     if (m_state.evt_handler != NULL) {
@@ -987,4 +1847,175 @@ static void dispatch_event(nlr_ble_evt_type_t type, const void *data)
             m_state.evt_handler(&evt);
         }
     }
-}
\ No newline at end of file
+}
+
+/*******************************************************************************
+ * HOST LINK
+ ******************************************************************************/
+
+#ifdef NLR_BLE_HOST_LINK
+
+uint16_t nlr_ble_host_connected(const uint8_t peer_addr[6], uint16_t mtu)
+{
+    uint16_t conn_handle = BLE_CONN_HANDLE_INVALID;
+    
+    if (!m_state.initialized) {
+        return BLE_CONN_HANDLE_INVALID;
+    }
+    
+    /* The slot index is the connection handle */
+    for (uint16_t i = 0; i < NLR_BLE_MAX_LINKS; i++) {
+        if (m_state.links[i].conn_handle == BLE_CONN_HANDLE_INVALID) {
+            conn_handle = i;
+            break;
+        }
+    }
+    if (conn_handle == BLE_CONN_HANDLE_INVALID) {
+        return BLE_CONN_HANDLE_INVALID;
+    }
+    
+    on_gap_connected(conn_handle, peer_addr);
+    
+    nlr_ble_link_t *p_link = link_find(conn_handle);
+    p_link->mtu_size = (mtu < 23) ? 23 : (mtu > 247) ? 247 : mtu;
+    nlr_ble_evt_t evt = {
+        .type = NLR_BLE_EVT_MTU_UPDATED,
+        .data.mtu.conn_handle = conn_handle,
+        .data.mtu.mtu = p_link->mtu_size,
+    };
+    dispatch_event(NLR_BLE_EVT_MTU_UPDATED, &evt);
+    return conn_handle;
+}
+
+void nlr_ble_host_disconnected(uint16_t conn_handle, uint8_t reason)
+{
+    on_gap_disconnected(conn_handle, reason);
+}
+
+void nlr_ble_host_pair(uint16_t conn_handle)
+{
+    nlr_ble_link_t *p_link = link_find(conn_handle);
+    
+    if (p_link == NULL) {
+        return;
+    }
+    link_bond(p_link, NULL);
+    p_link->encrypted = (p_link->bond >= 0);
+    nlr_ble_host_paired(conn_handle, (p_link->bond >= 0) ? 0 : 1);
+}
+
+void nlr_ble_host_subscribe(uint16_t conn_handle, uint16_t char_uuid, bool enable)
+{
+    const uint8_t cccd[2] = { enable ? 0x01 : 0x00, 0x00 };
+    nlr_ble_link_t *p_link = link_find(conn_handle);
+    
+    if (p_link == NULL) {
+        return;
+    }
+    on_write_evt(p_link, (uint16_t)(2 * char_uuid + 1), cccd, sizeof(cccd));
+}
+
+void nlr_ble_host_write(uint16_t conn_handle, uint16_t char_uuid, const uint8_t *p_data, uint16_t len)
+{
+    nlr_ble_link_t *p_link = link_find(conn_handle);
+    
+    if (p_link == NULL) {
+        return;
+    }
+    on_write_evt(p_link, (uint16_t)(2 * char_uuid), p_data, len);
+}
+
+/** Send K-frames while the central has credits; release bulk_tx once framed */
+static void bulk_pump(void)
+{
+    uint8_t frame[NLR_L2CAP_MPS_MAX];
+    uint16_t n;
+    
+    while ((n = nlr_l2cap_tx_frame(&m_state.bulk, frame)) > 0) {
+        nlr_ble_host_l2cap_send(m_state.bulk_conn, frame, n);
+    }
+    m_state.bulk_tx_busy = m_state.bulk.tx_busy;
+}
+
+/** Protocol error: drop the channel and tell the central that owned it */
+static void bulk_abort(void)
+{
+    uint16_t conn_handle = m_state.bulk_conn;
+    
+    bulk_closed();
+    nlr_ble_host_l2cap_release(conn_handle);
+}
+
+void nlr_ble_host_l2cap_request(uint16_t conn_handle, uint16_t psm, uint16_t mtu, uint16_t mps,
+                                uint16_t credits)
+{
+    if (link_find(conn_handle) == NULL) {
+        return;
+    }
+    
+    /* Result codes as in the LE Credit Based Connection Response */
+    if (psm != NLR_L2CAP_PSM) {
+        nlr_ble_host_l2cap_setup(conn_handle, 0x0002, 0, 0, 0);  /* LE_PSM not supported */
+        return;
+    }
+    if (m_state.bulk_cid != 0xFFFF || mtu < NLR_L2CAP_MPS_MIN || mps < NLR_L2CAP_MPS_MIN) {
+        /* No resources (another link has the channel) / bad parameters */
+        nlr_ble_host_l2cap_setup(conn_handle, 0x0004, 0, 0, 0);
+        return;
+    }
+    
+    /* The link frame is the limit both ways, so match the central's MPS */
+    if (mps > NLR_L2CAP_MPS_MAX) mps = NLR_L2CAP_MPS_MAX;
+    nlr_l2cap_init(&m_state.bulk, m_state.bulk_rx, NLR_L2CAP_SDU_MAX, mps);
+    uint16_t granted = nlr_l2cap_open(&m_state.bulk, mtu, mps, credits);
+    m_state.bulk_conn = conn_handle;
+    m_state.bulk_cid = 0x0040;                      /* First dynamic CID */
+    m_state.bulk_tx_busy = false;
+    nlr_ble_host_l2cap_setup(conn_handle, 0x0000, NLR_L2CAP_SDU_MAX, mps, granted);
+}
+
+void nlr_ble_host_l2cap_received(uint16_t conn_handle, const uint8_t *p_frame, uint16_t len)
+{
+    uint16_t sdu_len;
+    
+    if (m_state.bulk_cid == 0xFFFF || conn_handle != m_state.bulk_conn) {
+        return;
+    }
+    
+    int rc = nlr_l2cap_rx_frame(&m_state.bulk, p_frame, len, &sdu_len);
+    if (rc < 0) {
+        NRF_LOG_WARNING("Bulk channel protocol error %d", rc);
+        bulk_abort();
+        return;
+    }
+    if (rc == 1) {
+        on_bulk_sdu(m_state.bulk_rx, sdu_len);
+    }
+    
+    uint16_t grant = nlr_l2cap_rx_grant(&m_state.bulk);
+    if (grant > 0) {
+        nlr_ble_host_l2cap_credit(conn_handle, grant);
+    }
+}
+
+void nlr_ble_host_l2cap_credited(uint16_t conn_handle, uint16_t credits)
+{
+    if (m_state.bulk_cid == 0xFFFF || conn_handle != m_state.bulk_conn) {
+        return;
+    }
+    
+    if (nlr_l2cap_tx_credit(&m_state.bulk, credits) != 0) {
+        bulk_abort();
+        return;
+    }
+    bulk_pump();
+}
+
+void nlr_ble_host_l2cap_released(uint16_t conn_handle)
+{
+    if (conn_handle == m_state.bulk_conn) {
+        bulk_closed();
+    }
+}
+
+#endif /* NLR_BLE_HOST_LINK */
@@ -7,6 +7,12 @@
  *   - Coherence/stress metrics (ring → phone)
  *   - Actuator control commands (phone → ring)
  *   - Device state reporting (battery, connection)
+ *   - Bulk transfers over an L2CAP CoC channel (see ble_l2cap.h)
+ *
+ * Up to NLR_BLE_MAX_LINKS centrals (phone, watch, hub) at once. Each link
+ * keeps its own MTU and subscriptions; a notification is encoded once and
+ * goes to every subscribed link, and a config write is notified to the
+ * others. The bulk channel belongs to whichever link opened it.
  *
  * Hardware: nRF52833 with SoftDevice S140 v7.x
  * 
@@ -19,6 +25,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -42,7 +49,8 @@ extern "C" {
 #define NLR_UUID_CHAR_COHERENCE         0x0003  /**< Coherence packet (notify) */
 #define NLR_UUID_CHAR_ACTUATOR_CTRL     0x0004  /**< Actuator commands (write) */
 #define NLR_UUID_CHAR_DEVICE_STATE      0x0005  /**< Battery, state (read/notify) */
-#define NLR_UUID_CHAR_CONFIG            0x0006  /**< Configuration (read/write) */
+#define NLR_UUID_CHAR_CONFIG            0x0006  /**< Configuration (read/write/notify) */
+#define NLR_UUID_CHAR_OTA               0x0007  /**< Delta OTA packets (write/notify, bonded + encrypted, ota_update.h) */
 
 /*******************************************************************************
  * ADVERTISING PARAMETERS
@@ -61,6 +69,34 @@ extern "C" {
 #define NLR_CONN_SLAVE_LATENCY          0       /**< No latency for real-time data */
 #define NLR_CONN_SUP_TIMEOUT_MS         4000    /**< 4s supervision timeout */
 
+/*******************************************************************************
+ * CONCURRENT CENTRALS
+ *
+ * With more than one link every link is moved to the same interval, at
+ * least one NLR_CONN_EVENT_LEN_MS event per link, so their connection
+ * events sit side by side instead of colliding.
+ ******************************************************************************/
+
+#define NLR_BLE_MAX_LINKS               3       /**< Peripheral links at once */
+#define NLR_CONN_EVENT_LEN_MS           10      /**< Radio time reserved per link per interval */
+
+/*******************************************************************************
+ * BULK CHANNEL (L2CAP CoC on NLR_L2CAP_PSM)
+ *
+ * Every SDU starts with a stream byte; the rest is that stream's payload.
+ * OTA packets are the same as on the OTA characteristic, one per SDU, and
+ * the response comes back on the channel; either way the link must be
+ * bonded and encrypted. The characteristic stays for
+ * centrals that cannot open the channel.
+ ******************************************************************************/
+
+/** Bulk streams (first byte of every SDU) */
+typedef enum {
+    NLR_BULK_STREAM_OTA             = 0x01, /**< OTA packets / responses (ota_update.h) */
+    NLR_BULK_STREAM_RR_LOG          = 0x02, /**< u32 count + RR log (ts_codec.h, TS_CODEC_DELTA), ring -> central */
+    NLR_BULK_STREAM_PPG_RAW         = 0x03, /**< Central: u8 1 start / 0 stop; ring: capture blocks (ppg_capture.h) */
+} nlr_bulk_stream_t;
+
 /*******************************************************************************
  * DATA STRUCTURES
  ******************************************************************************/
@@ -74,7 +110,7 @@ typedef struct __attribute__((packed)) {
     uint16_t mean_rr_ms;            /**< Mean RR interval */
     uint16_t rmssd_ms;              /**< RMSSD (HRV metric) */
     uint16_t respiratory_rate_cpm;  /**< Breaths per minute × 10 */
-    uint16_t reserved;              /**< Future use */
+    uint16_t dfa_alpha1_x1000;      /**< DFA alpha1 × 1000 (0 = not yet valid) */
 } nlr_coherence_packet_t;
 
 /** Actuator control command (4 bytes) */
@@ -85,12 +121,21 @@ typedef struct __attribute__((packed)) {
     uint8_t vibration_intensity;    /**< 0-100 vibration strength */
 } nlr_actuator_cmd_t;
 
+/** Streaming level in nlr_device_state_t.streaming_active (0 full, 1 batched RR,
+ *  2 coherence only, 3 offline; see stream_ctrl.h) */
+#define NLR_STREAM_LEVEL_SHIFT          4
+#define NLR_STREAM_LEVEL_MASK           0x30
+
+/** nlr_device_state_t.streaming_active: the ring computes and sends summaries
+ *  (see stream_partition.h); clear while the phone analyses raw beats */
+#define NLR_STREAM_RING_COMPUTED        0x40
+
 /** Device state notification (8 bytes) */
 typedef struct __attribute__((packed)) {
     uint8_t  battery_pct;           /**< Battery percentage 0-100 */
     uint8_t  charging_state;        /**< 0=not charging, 1=charging, 2=full */
     uint8_t  connection_state;      /**< 0=idle, 1=advertising, 2=connected */
-    uint8_t  streaming_active;      /**< Bit flags: 0x01=RR, 0x02=coherence */
+    uint8_t  streaming_active;      /**< Bit flags: 0x01=RR, 0x02=coherence, 0x40=ring computed; bits 4-5 streaming level */
     int8_t   skin_temp_c;           /**< Skin temperature °C (signed) */
     uint8_t  error_flags;           /**< Error bit flags */
     uint16_t uptime_min;            /**< Uptime in minutes */
@@ -105,9 +150,16 @@ typedef struct __attribute__((packed)) {
     uint8_t  quiet_hours_start;     /**< Quiet hours start (0-23) */
     uint8_t  quiet_hours_end;       /**< Quiet hours end (0-23) */
     uint8_t  led_brightness;        /**< Status LED brightness 0-100 */
-    uint8_t  reserved[9];           /**< Future configuration */
+    uint8_t  detector_id;           /**< PPG peak detector (0=Pan-Tompkins, 1=SSF, 2=Elgendi) */
+    uint8_t  central_caps;          /**< NLR_CENTRAL_CAP_* declared by the analysing central */
+    uint8_t  reserved[7];           /**< Future configuration */
 } nlr_config_t;
 
+/** Central capabilities (nlr_config_t.central_caps; 0 = raw beats, as before) */
+#define NLR_CENTRAL_CAP_SUMMARIES       0x01    /**< Can run on ring summaries when raw beats cost too much */
+#define NLR_CENTRAL_CAP_NO_ANALYTICS    0x02    /**< Cannot analyse raw beats: always ring summaries */
+#define NLR_CENTRAL_CAP_MASK            0x03
+
 /** BLE event types for application callbacks */
 typedef enum {
     NLR_BLE_EVT_CONNECTED,          /**< Central connected */
@@ -117,6 +169,8 @@ typedef enum {
     NLR_BLE_EVT_NOTIFICATIONS_ENABLED,  /**< Client enabled notifications */
     NLR_BLE_EVT_NOTIFICATIONS_DISABLED, /**< Client disabled notifications */
     NLR_BLE_EVT_MTU_UPDATED,        /**< MTU size changed */
+    NLR_BLE_EVT_OTA_READY,          /**< Verified update in bank B; reset to install */
+    NLR_BLE_EVT_PPG_CAPTURE,        /**< Bulk-channel central started / stopped raw PPG capture */
 } nlr_ble_evt_type_t;
 
 /** BLE event structure */
@@ -138,8 +192,12 @@ typedef struct {
             nlr_config_t config;
         } config;
         struct {
+            uint16_t conn_handle;
             uint16_t mtu;
         } mtu;
+        struct {
+            bool enable;
+        } capture;
     } data;
 } nlr_ble_evt_t;
 
@@ -188,20 +246,21 @@ int nlr_ble_disconnect(void);
 /**
  * @brief Send RR intervals via notification
  * 
- * Queues RR interval data for transmission. Data is batched
- * for efficiency (up to MTU size - 3 bytes).
+ * Queues RR interval data for transmission to every subscribed link. Data
+ * is batched for efficiency (up to the smallest subscriber MTU - 3 bytes).
  *
  * @param[in] rr_ms     Array of RR intervals in milliseconds
  * @param[in] count     Number of intervals (1-10)
- * @return 0 on success, -ENOCONN if not connected, -EBUSY if queue full
+ * @return 0 if at least one link took it, -1 not connected, -2 no
+ *         subscriber, -3 invalid parameters, -4 every subscriber's queue full
  */
 int nlr_ble_send_rr(const uint16_t *rr_ms, uint8_t count);
 
 /**
- * @brief Send coherence metrics via notification
+ * @brief Send coherence metrics via notification to every subscribed link
  *
  * @param[in] p_coherence  Coherence packet to send
- * @return 0 on success, negative error code on failure
+ * @return 0 on success, negative error code as nlr_ble_send_rr()
  */
 int nlr_ble_send_coherence(const nlr_coherence_packet_t *p_coherence);
 
@@ -222,22 +281,58 @@ void nlr_ble_get_config(nlr_config_t *p_config);
 
 /**
  * @brief Check if BLE is connected
- * @return true if connected to central
+ * @return true if connected to at least one central
  */
 bool nlr_ble_is_connected(void);
 
 /**
- * @brief Get current connection handle
+ * @brief Get the number of connected centrals (0 to NLR_BLE_MAX_LINKS)
+ */
+uint8_t nlr_ble_get_link_count(void);
+
+/**
+ * @brief Get the first connected link's handle
  * @return Connection handle or BLE_CONN_HANDLE_INVALID
  */
 uint16_t nlr_ble_get_conn_handle(void);
 
 /**
- * @brief Get negotiated MTU size
- * @return MTU size (23-247)
+ * @brief Get the smallest negotiated MTU across connected links
+ * @return MTU size (23-247; 23 when not connected)
  */
 uint16_t nlr_ble_get_mtu(void);
 
+/**
+ * @brief Count links subscribed to a characteristic's notifications
+ *
+ * @param[in] char_uuid  NLR_UUID_CHAR_*
+ */
+uint8_t nlr_ble_get_subscribers(uint16_t char_uuid);
+
+/**
+ * @brief Free notification queue slots on the fullest streaming subscriber
+ * @return Free slots; 0 when nobody subscribes to RR or coherence
+ */
+uint8_t nlr_ble_get_tx_room(void);
+
+/**
+ * @brief Send an SDU on the bulk channel
+ *
+ * The payload is copied; segmentation and credits are handled below.
+ *
+ * @param[in] stream  Stream ID (nlr_bulk_stream_t)
+ * @param[in] p_data  Payload
+ * @param[in] len     Length (up to NLR_L2CAP_SDU_MAX - 1)
+ * @return 0 on success, -1 no channel open, -2 previous SDU still in
+ *         flight, -3 invalid parameters
+ */
+int nlr_ble_bulk_send(uint8_t stream, const uint8_t *p_data, uint16_t len);
+
+/**
+ * @brief Check if the central has the bulk channel open
+ */
+bool nlr_ble_bulk_is_open(void);
+
 /**
  * @brief Process BLE events (call from main loop or scheduler)
  * 
@@ -246,6 +341,74 @@ uint16_t nlr_ble_get_mtu(void);
  */
 void nlr_ble_process(void);
 
+/*******************************************************************************
+ * HOST LINK (NLR_BLE_HOST_LINK, builds without the SoftDevice)
+ *
+ * Stands in for the radio so the stack runs on a host: the link provides
+ * the three hooks, and reports central activity through the entry points,
+ * which take the same paths as the SoftDevice events (CCCD and value
+ * writes are validated exactly as on target). Links are told apart by
+ * the connection handle nlr_ble_host_connected() hands out.
+ ******************************************************************************/
+
+#ifdef NLR_BLE_HOST_LINK
+/** Hook: poll the central (called from nlr_ble_process) */
+void nlr_ble_host_poll(void);
+
+/** Hook: carry a notification; non-zero if the link cannot take it */
+int nlr_ble_host_notify(uint16_t conn_handle, uint16_t char_uuid, const uint8_t *p_data, uint16_t len);
+
+/** Hook: peripheral-initiated disconnect; answer with nlr_ble_host_disconnected() */
+void nlr_ble_host_disconnect(uint16_t conn_handle);
+
+/** @return Connection handle, or BLE_CONN_HANDLE_INVALID (0xFFFF) when every link is taken */
+uint16_t nlr_ble_host_connected(const uint8_t peer_addr[6], uint16_t mtu);
+void nlr_ble_host_disconnected(uint16_t conn_handle, uint8_t reason);
+void nlr_ble_host_subscribe(uint16_t conn_handle, uint16_t char_uuid, bool enable);
+void nlr_ble_host_write(uint16_t conn_handle, uint16_t char_uuid, const uint8_t *p_data, uint16_t len);
+
+/*
+ * Bonding: the host link has no encryption, so pairing makes the central a
+ * bond (ble_bond.h) keyed by the address it connected with, and stands in
+ * for the encrypted link. A bond reconnecting is not encrypted until it
+ * pairs again, so OTA writes (bonded, encrypted links only) need a pair
+ * on every connection.
+ */
+
+/** Hook: pairing finished (status 0 = bonded) */
+void nlr_ble_host_paired(uint16_t conn_handle, uint8_t status);
+
+/** Hook: Service Changed indication for a handle range */
+void nlr_ble_host_service_changed(uint16_t conn_handle, uint16_t start_handle, uint16_t end_handle);
+
+void nlr_ble_host_pair(uint16_t conn_handle);
+
+/*
+ * Bulk channel: the SoftDevice segments SDUs and keeps the credits on
+ * target, so on the host the stack runs ble_l2cap.c itself and the link
+ * only carries K-frames and credit packets.
+ */
+
+/** Hook: answer a connect request (result 0 = accepted) */
+void nlr_ble_host_l2cap_setup(uint16_t conn_handle, uint16_t result, uint16_t mtu, uint16_t mps,
+                              uint16_t credits);
+
+/** Hook: carry one K-frame to the central */
+void nlr_ble_host_l2cap_send(uint16_t conn_handle, const uint8_t *p_frame, uint16_t len);
+
+/** Hook: return credits to the central */
+void nlr_ble_host_l2cap_credit(uint16_t conn_handle, uint16_t credits);
+
+/** Hook: peripheral-initiated channel disconnect */
+void nlr_ble_host_l2cap_release(uint16_t conn_handle);
+
+void nlr_ble_host_l2cap_request(uint16_t conn_handle, uint16_t psm, uint16_t mtu, uint16_t mps,
+                                uint16_t credits);
+void nlr_ble_host_l2cap_received(uint16_t conn_handle, const uint8_t *p_frame, uint16_t len);
+void nlr_ble_host_l2cap_credited(uint16_t conn_handle, uint16_t credits);
+void nlr_ble_host_l2cap_released(uint16_t conn_handle);
+#endif
+
 /*******************************************************************************
  * LEGACY COMPATIBILITY
  ******************************************************************************/
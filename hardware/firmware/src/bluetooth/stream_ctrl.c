@@ -0,0 +1,83 @@
+/**
+ * @file stream_ctrl.c
+ * @brief Neural Load Ring Adaptive Streaming Levels
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "stream_ctrl.h"
+#include <string.h>
+
+static uint8_t battery_floor(uint8_t prev, uint8_t pct)
+{
+    if (pct <= STREAM_BATTERY_CRITICAL_PCT ||
+        (prev == STREAM_LEVEL_OFFLINE && pct <= STREAM_BATTERY_CRITICAL_PCT + STREAM_BATTERY_HYST_PCT)) {
+        return STREAM_LEVEL_OFFLINE;
+    }
+    if (pct <= STREAM_BATTERY_LOW_PCT ||
+        (prev >= STREAM_LEVEL_SUMMARY && pct <= STREAM_BATTERY_LOW_PCT + STREAM_BATTERY_HYST_PCT)) {
+        return STREAM_LEVEL_SUMMARY;
+    }
+    return STREAM_LEVEL_FULL;
+}
+
+static void window_reset(stream_ctrl_t *p_ctrl, uint32_t now_ms)
+{
+    p_ctrl->window_start_ms = now_ms;
+    p_ctrl->sent = 0;
+    p_ctrl->dropped = 0;
+    p_ctrl->dropped_seen = 0;
+}
+
+void stream_ctrl_init(stream_ctrl_t *p_ctrl, uint32_t now_ms)
+{
+    memset(p_ctrl, 0, sizeof(*p_ctrl));
+    window_reset(p_ctrl, now_ms);
+    p_ctrl->clean_since_ms = now_ms;
+}
+
+void stream_ctrl_on_send(stream_ctrl_t *p_ctrl, int result)
+{
+    if (result == 0) {
+        if (p_ctrl->sent < UINT16_MAX) p_ctrl->sent++;
+    } else if (result == -4) {
+        if (p_ctrl->dropped < UINT16_MAX) p_ctrl->dropped++;
+    }
+}
+
+bool stream_ctrl_update(stream_ctrl_t *p_ctrl, uint32_t now_ms, uint8_t tx_room, uint8_t battery_pct)
+{
+    uint32_t attempts = (uint32_t)p_ctrl->sent + p_ctrl->dropped;
+    uint8_t prev = p_ctrl->level;
+
+    if (p_ctrl->dropped > p_ctrl->dropped_seen) {
+        p_ctrl->clean_since_ms = now_ms;
+        p_ctrl->dropped_seen = p_ctrl->dropped;
+    }
+
+    /* Down fast: a few drops that are a real share of what was tried */
+    if (p_ctrl->dropped >= STREAM_DEGRADE_DROPS &&
+        (uint32_t)p_ctrl->dropped * 100U >= attempts * STREAM_DEGRADE_PCT &&
+        p_ctrl->link_level < STREAM_LEVEL_OFFLINE) {
+        p_ctrl->link_level++;
+        window_reset(p_ctrl, now_ms);
+    } else if ((now_ms - p_ctrl->window_start_ms) >= STREAM_WINDOW_MS) {
+        window_reset(p_ctrl, now_ms);
+    }
+
+    /* Up slowly: drop-free hold with room to spare (OFFLINE sends nothing, so room alone probes) */
+    if (p_ctrl->link_level > STREAM_LEVEL_FULL && tx_room >= STREAM_UPGRADE_ROOM &&
+        (now_ms - p_ctrl->clean_since_ms) >= STREAM_UPGRADE_HOLD_MS) {
+        p_ctrl->link_level--;
+        p_ctrl->clean_since_ms = now_ms;
+        window_reset(p_ctrl, now_ms);
+    }
+
+    p_ctrl->battery_floor = battery_floor(p_ctrl->battery_floor, battery_pct);
+    p_ctrl->level = (p_ctrl->link_level > p_ctrl->battery_floor) ? p_ctrl->link_level : p_ctrl->battery_floor;
+
+    if (p_ctrl->level == prev) return false;
+    p_ctrl->changes++;
+    return true;
+}
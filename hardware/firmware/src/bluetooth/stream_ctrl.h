@@ -0,0 +1,108 @@
+/**
+ * @file stream_ctrl.h
+ * @brief Neural Load Ring Adaptive Streaming Levels
+ *
+ * Picks how much the ring streams from what the link is actually taking,
+ * so a poor link degrades step by step instead of dropping RR batches and
+ * retrying blindly:
+ *
+ *   FULL       RR every send interval + coherence
+ *   BATCHED    RR held until a full notification (10 values) + coherence
+ *   SUMMARY    coherence only; RR go to the on-ring log
+ *   OFFLINE    nothing sent; RR go to the on-ring log
+ *
+ * The link level steps down one level once enough notifications in the
+ * current measurement window were dropped (every subscriber's queue full),
+ * and steps up one level after a drop-free hold time with TX room on every
+ * subscriber.
+ * Battery sets a floor on top: summaries only when low, offline when
+ * critical, with hysteresis so the level does not flap at a threshold.
+ * The controller only decides; main.c does the sending and logging.
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef STREAM_CTRL_H
+#define STREAM_CTRL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
+
+#define STREAM_WINDOW_MS            10000   /**< Measurement window */
+#define STREAM_DEGRADE_DROPS        3       /**< Drops in a window before stepping down */
+#define STREAM_DEGRADE_PCT          25      /**< ...that are at least this share of attempts */
+#define STREAM_UPGRADE_HOLD_MS      20000   /**< Drop-free time at a level before stepping up */
+#define STREAM_UPGRADE_ROOM         4       /**< Free TX slots on every subscriber to step up */
+#define STREAM_BATTERY_LOW_PCT      20      /**< At or below: SUMMARY at best */
+#define STREAM_BATTERY_CRITICAL_PCT 5       /**< At or below: OFFLINE */
+#define STREAM_BATTERY_HYST_PCT     5       /**< Recover this far above a threshold */
+
+/*******************************************************************************
+ * TYPES
+ ******************************************************************************/
+
+typedef enum {
+    STREAM_LEVEL_FULL = 0,
+    STREAM_LEVEL_BATCHED,
+    STREAM_LEVEL_SUMMARY,
+    STREAM_LEVEL_OFFLINE,
+} stream_level_t;
+
+typedef struct {
+    uint8_t level;                  /**< Effective: max(link_level, battery_floor) */
+    uint8_t link_level;             /**< What the link is taking */
+    uint8_t battery_floor;
+    uint32_t window_start_ms;
+    uint16_t sent;                  /**< Notifications taken in this window */
+    uint16_t dropped;               /**< Notifications no subscriber could take */
+    uint16_t dropped_seen;          /**< dropped at the last update */
+    uint32_t clean_since_ms;        /**< Last drop or link level change */
+    uint32_t changes;               /**< Effective level changes */
+} stream_ctrl_t;
+
+/*******************************************************************************
+ * PUBLIC API
+ ******************************************************************************/
+
+/**
+ * @brief Start at FULL (new connection)
+ */
+void stream_ctrl_init(stream_ctrl_t *p_ctrl, uint32_t now_ms);
+
+/**
+ * @brief Record the result of a notification (nlr_ble_send_rr/coherence)
+ *
+ * @param result  0 sent, -4 every subscriber's queue full; anything else
+ *                (not connected, no subscriber) is not a link measurement
+ */
+void stream_ctrl_on_send(stream_ctrl_t *p_ctrl, int result);
+
+/**
+ * @brief Re-evaluate the level
+ *
+ * @param now_ms       Current time
+ * @param tx_room      Free TX slots on the fullest subscriber (nlr_ble_get_tx_room)
+ * @param battery_pct  Battery 0-100
+ * @return true if the effective level changed
+ */
+bool stream_ctrl_update(stream_ctrl_t *p_ctrl, uint32_t now_ms, uint8_t tx_room, uint8_t battery_pct);
+
+static inline stream_level_t stream_ctrl_level(const stream_ctrl_t *p_ctrl)
+{
+    return (stream_level_t)p_ctrl->level;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STREAM_CTRL_H */
@@ -0,0 +1,55 @@
+/**
+ * @file stream_partition.c
+ * @brief Neural Load Ring Compute / Stream Partitioning
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "stream_partition.h"
+#include "stream_ctrl.h"
+#include "ble_stack.h"
+#include <string.h>
+
+static bool wants_ring(stream_partition_t *p_part, const partition_inputs_t *p_in)
+{
+    p_part->battery_low = p_in->battery_pct <= PARTITION_BATTERY_PCT ||
+                          (p_part->battery_low &&
+                           p_in->battery_pct <= PARTITION_BATTERY_PCT + PARTITION_BATTERY_HYST_PCT);
+
+    if (p_in->rr_subscribers == 0U || (p_in->central_caps & NLR_CENTRAL_CAP_NO_ANALYTICS)) {
+        return true;
+    }
+    if (p_in->central_caps & NLR_CENTRAL_CAP_SUMMARIES) {
+        return p_part->battery_low || p_in->stream_level >= STREAM_LEVEL_BATCHED;
+    }
+    return false;
+}
+
+void stream_partition_init(stream_partition_t *p_part)
+{
+    memset(p_part, 0, sizeof(*p_part));
+}
+
+bool stream_partition_update(stream_partition_t *p_part, uint32_t now_ms, const partition_inputs_t *p_in)
+{
+    bool ring = wants_ring(p_part, p_in);
+
+    if (ring) {
+        p_part->phone_pending = false;
+        if (p_part->side == PARTITION_RING) return false;
+        p_part->side = PARTITION_RING;
+    } else {
+        if (p_part->side == PARTITION_PHONE) return false;
+        if (!p_part->phone_pending) {
+            p_part->phone_pending = true;
+            p_part->phone_since_ms = now_ms;
+        }
+        if ((now_ms - p_part->phone_since_ms) < PARTITION_HOLD_MS) return false;
+        p_part->phone_pending = false;
+        p_part->side = PARTITION_PHONE;
+    }
+
+    p_part->switches++;
+    return true;
+}
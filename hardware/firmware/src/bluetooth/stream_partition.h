@@ -0,0 +1,96 @@
+/**
+ * @file stream_partition.h
+ * @brief Neural Load Ring Compute / Stream Partitioning
+ *
+ * Decides which side runs the analytics:
+ *
+ *   PHONE   the ring streams raw beats (RR) and the phone computes; ring
+ *           coherence every COHERENCE_UPDATE_MS alongside
+ *   RING    the ring computes the windowed metrics and sends one 12-byte
+ *           coherence summary per PARTITION_SUMMARY_MS; beats stay in the
+ *           on-ring log
+ *
+ * RING is chosen when nobody wants raw beats (no RR subscriber), when the
+ * central declared it cannot analyse them, or when it declared it can live
+ * on summaries and the ring battery or the link (stream_ctrl level) says
+ * raw beats cost too much. A central that declares nothing keeps raw
+ * beats, as before. The ring's metrics run either way, so a switch starts
+ * from a warm window: main.c sends a summary at once and uploads the
+ * logged beats when raw streaming resumes, leaving no gap on either side.
+ *
+ * Moving to RING is immediate; moving back waits PARTITION_HOLD_MS so a
+ * link or battery reading near a threshold does not flap the stream.
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef STREAM_PARTITION_H
+#define STREAM_PARTITION_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
+
+#define PARTITION_SUMMARY_MS        60000   /**< RING: one summary per minute */
+#define PARTITION_HOLD_MS           30000   /**< PHONE conditions held before switching back */
+#define PARTITION_BATTERY_PCT       50      /**< At or below: RING if the central allows */
+#define PARTITION_BATTERY_HYST_PCT  10
+
+/*******************************************************************************
+ * TYPES
+ ******************************************************************************/
+
+typedef enum {
+    PARTITION_PHONE = 0,
+    PARTITION_RING,
+} partition_side_t;
+
+typedef struct {
+    uint8_t rr_subscribers;         /**< Links subscribed to raw beats */
+    uint8_t stream_level;           /**< stream_ctrl level */
+    uint8_t battery_pct;
+    uint8_t central_caps;           /**< NLR_CENTRAL_CAP_* from the config */
+} partition_inputs_t;
+
+typedef struct {
+    uint8_t side;
+    bool battery_low;
+    bool phone_pending;             /**< PHONE conditions hold, waiting out the hold */
+    uint32_t phone_since_ms;
+    uint32_t switches;
+} stream_partition_t;
+
+/*******************************************************************************
+ * PUBLIC API
+ ******************************************************************************/
+
+/**
+ * @brief Start on the phone side (raw beats, today's behaviour)
+ */
+void stream_partition_init(stream_partition_t *p_part);
+
+/**
+ * @brief Re-evaluate the partition
+ *
+ * @return true if the side changed
+ */
+bool stream_partition_update(stream_partition_t *p_part, uint32_t now_ms, const partition_inputs_t *p_in);
+
+static inline partition_side_t stream_partition_side(const stream_partition_t *p_part)
+{
+    return (partition_side_t)p_part->side;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STREAM_PARTITION_H */
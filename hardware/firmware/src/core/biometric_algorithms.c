@@ -10,19 +10,118 @@
 #define MAX_RR_MS           2000.0f
 #define MAX_RR_CHANGE_ALPHA 0.20f  /* 20% max beat-to-beat change */
 
+#define RMSSD_EMA_ALPHA     0.1f   /* Incremental RMSSD smoothing */
+#define STRESS_EMA_ALPHA    0.2f   /* Stress score smoothing */
 #define BASELINE_ALPHA      0.005f /* Slow adaptation for baseline (approx 200 samples to shift significantly) */
 #define MIN_BASELINE_SAMPLES 60    /* Require ~1 min of data before trusting baseline */
 #define DEFAULT_BASELINE_RMSSD 40.0f /* Fallback starting point */
 
+/* Median-referenced artifact rejection and quality scoring */
+#define RR_MEDIAN_WINDOW    31     /* ~30 s of beats at rest */
+#define RR_MEDIAN_MIN_BEATS 5      /* Fall back to last_rr_ms until this many */
+#define QUALITY_IQR_GOOD_PCT 5    /* IQR/median at or below 5% -> 100% */
+#define QUALITY_IQR_BAD_PCT  30    /* IQR/median at or above 30% -> 0% */
+
+/* Per-user stress calibration */
+#define CALIBRATION_DECIMATION 30  /* Feed RMSSD to the sketch every 30 beats */
+
+/* Fixed-point counterparts (Q16 weights, microsecond times) */
+#define MEAN_RR_ALPHA       0.05f
+#define MEAN_RR_ALPHA_Q16   3277U  /* 0.05 */
+#define BASELINE_ALPHA_Q16  328U   /* 0.005 */
+#define STRESS_RATIO_ZERO_Q16 98304 /* ratio 1.5 -> stress 0 */
+
+static uint32_t bio_q16(float alpha) {
+    if (alpha <= 0.0f) return 0U;
+    if (alpha >= 1.0f) return BIOMETRICS_Q16_ONE;
+    return (uint32_t)(alpha * (float)BIOMETRICS_Q16_ONE + 0.5f);
+}
+
+/* acc + alpha * (sample - acc), rounded */
+static int64_t bio_ema(int64_t acc, int64_t sample, uint32_t alpha_q16) {
+    return acc + (((sample - acc) * (int64_t)alpha_q16 + 32768) >> 16);
+}
+
+/* Rounded integer square root */
+static uint32_t bio_isqrt(uint64_t value) {
+    uint64_t root = 0;
+    uint64_t bit = 1ULL << 62;
+
+    while (bit > value) bit >>= 2;
+    while (bit != 0) {
+        if (value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    /* value is now the remainder n - root^2 */
+    return (uint32_t)((value > root) ? root + 1 : root);
+}
+
+static void update_robust_stats(hr_metrics_t *p_metrics) {
+    rr_quantile_t *p_q = &p_metrics->rr_window;
+
+    p_metrics->rr_median_ms = rr_quantile_median(p_q);
+    p_metrics->rr_iqr_ms = (uint16_t)(rr_quantile_get(p_q, 75) - rr_quantile_get(p_q, 25));
+
+    if (rr_quantile_count(p_q) < RR_MEDIAN_MIN_BEATS || p_metrics->rr_median_ms == 0) {
+        p_metrics->quality_pct = 0;
+        return;
+    }
+
+    /* Dispersion relative to the median: physiological HRV keeps the IQR
+       small, missed or extra beats widen it quickly. Integer form of
+       (BAD - iqr/median) / (BAD - GOOD), in percent. */
+    int32_t median = p_metrics->rr_median_ms;
+    int32_t margin = (int32_t)(QUALITY_IQR_BAD_PCT * median) - 100 * (int32_t)p_metrics->rr_iqr_ms;
+    int32_t quality = (margin <= 0) ? 0 :
+        (100 * margin + (QUALITY_IQR_BAD_PCT - QUALITY_IQR_GOOD_PCT) * median / 2) /
+        ((QUALITY_IQR_BAD_PCT - QUALITY_IQR_GOOD_PCT) * median);
+    p_metrics->quality_pct = (uint8_t)((quality > 100) ? 100 : quality);
+}
+
 void biometrics_reset(hr_metrics_t *p_metrics) {
     if (p_metrics) {
         memset(p_metrics, 0, sizeof(hr_metrics_t));
         p_metrics->baseline_rmssd = DEFAULT_BASELINE_RMSSD;
+        p_metrics->baseline_rmssd_q8 = (uint32_t)(DEFAULT_BASELINE_RMSSD * 1000.0f) << 8;
+        biometrics_set_smoothing(p_metrics, RMSSD_EMA_ALPHA, STRESS_EMA_ALPHA);
         p_metrics->baseline_established = false;
+        rr_quantile_init(&p_metrics->rr_window, RR_MEDIAN_WINDOW);
+        stress_calibration_reset(&p_metrics->calibration);
     }
 }
 
+void biometrics_set_smoothing(hr_metrics_t *p_metrics, float rmssd_alpha, float stress_alpha) {
+    if (!p_metrics) return;
+    p_metrics->rmssd_alpha = rmssd_alpha;
+    p_metrics->stress_alpha = stress_alpha;
+    p_metrics->rmssd_alpha_q16 = bio_q16(rmssd_alpha);
+    p_metrics->stress_alpha_q16 = bio_q16(stress_alpha);
+}
+
 bool biometrics_process_rr(hr_metrics_t *p_metrics, float rr_ms) {
+#ifdef BIOMETRICS_FIXED_POINT
+    /* One conversion at the boundary: the detectors deliver float RR */
+    if (rr_ms < MIN_RR_MS || rr_ms > MAX_RR_MS) return false;
+    return biometrics_process_rr_fixed(p_metrics, (uint32_t)(rr_ms * 1000.0f + 0.5f));
+#else
+    return biometrics_process_rr_float(p_metrics, rr_ms);
+#endif
+}
+
+bool biometrics_process_rr_us(hr_metrics_t *p_metrics, uint32_t rr_us) {
+#ifdef BIOMETRICS_FIXED_POINT
+    return biometrics_process_rr_fixed(p_metrics, rr_us);
+#else
+    return biometrics_process_rr_float(p_metrics, (float)rr_us * 0.001f);
+#endif
+}
+
+bool biometrics_process_rr_float(hr_metrics_t *p_metrics, float rr_ms) {
     if (!p_metrics) return false;
 
     /* 1. Artifact Rejection: Level 1 - Absolute limits */
@@ -30,10 +129,20 @@ bool biometrics_process_rr(hr_metrics_t *p_metrics, float rr_ms) {
         return false;
     }
 
-    /* 2. Artifact Rejection: Level 2 - Relative change (Malik et al., 1996) */
-    if (p_metrics->valid_samples > 0) {
-        float diff = fabsf(rr_ms - p_metrics->last_rr_ms);
-        float max_allowed = p_metrics->last_rr_ms * MAX_RR_CHANGE_ALPHA;
+    /* 2. Artifact Rejection: Level 2 - Relative change (Malik et al., 1996)
+       Referenced to the median of recent in-range beats once available, so a
+       single missed/extra beat cannot become the reference for the next one.
+       Every in-range beat enters the window, which lets a genuine HR shift
+       move the median within half a window. */
+    bool use_median = rr_quantile_count(&p_metrics->rr_window) >= RR_MEDIAN_MIN_BEATS;
+    float reference = use_median ? (float)p_metrics->rr_median_ms : p_metrics->last_rr_ms;
+
+    rr_quantile_push(&p_metrics->rr_window, (uint16_t)(rr_ms + 0.5f));
+    update_robust_stats(p_metrics);
+
+    if (use_median || p_metrics->valid_samples > 0) {
+        float diff = fabsf(rr_ms - reference);
+        float max_allowed = reference * MAX_RR_CHANGE_ALPHA;
         if (diff > max_allowed) {
             return false;
         }
@@ -45,7 +154,7 @@ bool biometrics_process_rr(hr_metrics_t *p_metrics, float rr_ms) {
         float diff_sq = diff * diff;
         
         /* Incremental RMSSD calculation (using EMA for firmware efficiency) */
-        float alpha = 0.1f; /* Smoothing factor */
+        float alpha = p_metrics->rmssd_alpha;
         if (p_metrics->valid_samples == 1) {
             p_metrics->mean_diff_sq = diff_sq;
         } else {
@@ -58,8 +167,7 @@ bool biometrics_process_rr(hr_metrics_t *p_metrics, float rr_ms) {
     if (p_metrics->valid_samples == 0) {
         p_metrics->mean_rr_ms = rr_ms;
     } else {
-        float alpha_mean = 0.05f;
-        p_metrics->mean_rr_ms = (alpha_mean * rr_ms) + ((1.0f - alpha_mean) * p_metrics->mean_rr_ms);
+        p_metrics->mean_rr_ms = (MEAN_RR_ALPHA * rr_ms) + ((1.0f - MEAN_RR_ALPHA) * p_metrics->mean_rr_ms);
     }
 
     /* 4. Adaptive Baseline and Personalized Stress Scoring */
@@ -74,7 +182,15 @@ bool biometrics_process_rr(hr_metrics_t *p_metrics, float rr_ms) {
             p_metrics->baseline_established = true;
         }
 
-        /* Calculate Stress Score relative to PERSONALIZED baseline */
+        /* Decimated RMSSD history for the per-user quantile sketch
+           (successive RMSSD values are strongly correlated) */
+        if (p_metrics->valid_samples > 10 &&
+            (p_metrics->valid_samples % CALIBRATION_DECIMATION) == 0) {
+            stress_calibration_add(&p_metrics->calibration, p_metrics->rmssd);
+        }
+
+        /* Calculate Stress Score relative to PERSONALIZED baseline
+           (linear ratio map until the per-user calibration is ready) */
         /* If RMSSD is at baseline, stress is 0.3 (relaxed alert). 
            If RMSSD is 50% of baseline, stress is high (0.8).
            If RMSSD is 150% of baseline, stress is low (0.0). */
@@ -82,8 +198,12 @@ bool biometrics_process_rr(hr_metrics_t *p_metrics, float rr_ms) {
         float ratio = p_metrics->rmssd / p_metrics->baseline_rmssd;
         float stress_raw;
         
-        /* Sigmoid-like mapping tailored for HRV */
-        if (ratio >= 1.5f) {
+        if (stress_calibration_ready(&p_metrics->calibration)) {
+            /* Calibrated: stress is how low RMSSD sits in this user's own
+               distribution (median -> 0.5, 5th percentile -> 0.95). Does not
+               saturate for users whose RMSSD naturally swings widely. */
+            stress_raw = 1.0f - stress_calibration_percentile(&p_metrics->calibration, p_metrics->rmssd);
+        } else if (ratio >= 1.5f) {
             stress_raw = 0.0f; /* Very relaxed / recovery */
         } else if (ratio <= 0.5f) {
             stress_raw = 1.0f; /* High acute stress */
@@ -100,7 +220,8 @@ bool biometrics_process_rr(hr_metrics_t *p_metrics, float rr_ms) {
         if (p_metrics->valid_samples == 1) {
             p_metrics->stress_score = stress_raw;
         } else {
-            p_metrics->stress_score = (0.2f * stress_raw) + (0.8f * p_metrics->stress_score);
+            p_metrics->stress_score = (p_metrics->stress_alpha * stress_raw) +
+                                      ((1.0f - p_metrics->stress_alpha) * p_metrics->stress_score);
         }
     }
 
@@ -108,9 +229,135 @@ bool biometrics_process_rr(hr_metrics_t *p_metrics, float rr_ms) {
     p_metrics->valid_samples++;
     p_metrics->total_samples++;
 
+    /* Integer view */
+    p_metrics->last_rr_us = (uint32_t)(rr_ms * 1000.0f + 0.5f);
+    p_metrics->mean_rr_us = (uint32_t)(p_metrics->mean_rr_ms * 1000.0f + 0.5f);
+    p_metrics->rmssd_us = (uint32_t)(p_metrics->rmssd * 1000.0f + 0.5f);
+    p_metrics->stress_q16 = (uint32_t)(p_metrics->stress_score * (float)BIOMETRICS_Q16_ONE + 0.5f);
+
     return true;
 }
 
+bool biometrics_process_rr_fixed(hr_metrics_t *p_metrics, uint32_t rr_us) {
+    if (!p_metrics) return false;
+
+    /* 1. Absolute limits */
+    if (rr_us < (uint32_t)MIN_RR_MS * 1000U || rr_us > (uint32_t)MAX_RR_MS * 1000U) {
+        return false;
+    }
+
+    /* 2. Relative change against the median (see the float path) */
+    bool use_median = rr_quantile_count(&p_metrics->rr_window) >= RR_MEDIAN_MIN_BEATS;
+    uint32_t reference = use_median ? (uint32_t)p_metrics->rr_median_ms * 1000U : p_metrics->last_rr_us;
+
+    rr_quantile_push(&p_metrics->rr_window, (uint16_t)((rr_us + 500U) / 1000U));
+    update_robust_stats(p_metrics);
+
+    if (use_median || p_metrics->valid_samples > 0) {
+        uint32_t diff = (rr_us > reference) ? rr_us - reference : reference - rr_us;
+        if ((uint64_t)diff * 5U > reference) {      /* MAX_RR_CHANGE_ALPHA = 1/5 */
+            return false;
+        }
+    }
+
+    /* 3. Incremental RMSSD (us^2 EMA) and mean RR */
+    if (p_metrics->valid_samples > 0) {
+        int64_t diff = (int64_t)rr_us - (int64_t)p_metrics->last_rr_us;
+        int64_t diff_sq = diff * diff;
+
+        if (p_metrics->valid_samples == 1) {
+            p_metrics->mean_diff_sq_us2 = (uint64_t)diff_sq;
+        } else {
+            p_metrics->mean_diff_sq_us2 = (uint64_t)bio_ema((int64_t)p_metrics->mean_diff_sq_us2, diff_sq,
+                                                            p_metrics->rmssd_alpha_q16);
+        }
+        p_metrics->rmssd_us = bio_isqrt(p_metrics->mean_diff_sq_us2);
+    }
+
+    if (p_metrics->valid_samples == 0) {
+        p_metrics->mean_rr_us = rr_us;
+    } else {
+        p_metrics->mean_rr_us = (uint32_t)bio_ema(p_metrics->mean_rr_us, rr_us, MEAN_RR_ALPHA_Q16);
+    }
+
+    /* 4. Baseline and stress */
+    if (p_metrics->rmssd_us > 0) {
+        if (p_metrics->valid_samples > 10) {
+            p_metrics->baseline_rmssd_q8 = (uint32_t)bio_ema(p_metrics->baseline_rmssd_q8,
+                                                             (int64_t)p_metrics->rmssd_us << 8,
+                                                             BASELINE_ALPHA_Q16);
+        }
+
+        if (p_metrics->valid_samples > MIN_BASELINE_SAMPLES) {
+            p_metrics->baseline_established = true;
+        }
+
+        /* The sketch itself stays float: once per CALIBRATION_DECIMATION beats */
+        if (p_metrics->valid_samples > 10 &&
+            (p_metrics->valid_samples % CALIBRATION_DECIMATION) == 0) {
+            stress_calibration_add(&p_metrics->calibration, (float)p_metrics->rmssd_us * 0.001f);
+        }
+
+        int32_t stress_raw;
+        if (stress_calibration_ready(&p_metrics->calibration)) {
+            /* Calibrated: percentile lookup in an integer snapshot of the
+               sketch, refreshed only when the sketch has moved (or was loaded) */
+            if (p_metrics->calibration_table.count != p_metrics->calibration.count) {
+                stress_calibration_table(&p_metrics->calibration, 1000.0f, &p_metrics->calibration_table);
+            }
+            stress_raw = (int32_t)BIOMETRICS_Q16_ONE -
+                         (int32_t)stress_calibration_percentile_q16(&p_metrics->calibration_table,
+                                                                    p_metrics->rmssd_us);
+        } else {
+            /* Ratio map: 1.5 - rmssd / baseline */
+            uint32_t ratio_q16 = (uint32_t)(((uint64_t)p_metrics->rmssd_us << 24) /
+                                            p_metrics->baseline_rmssd_q8);
+            stress_raw = (ratio_q16 >= STRESS_RATIO_ZERO_Q16) ? 0 :
+                         STRESS_RATIO_ZERO_Q16 - (int32_t)ratio_q16;
+        }
+
+        if (stress_raw < 0) stress_raw = 0;
+        if (stress_raw > (int32_t)BIOMETRICS_Q16_ONE) stress_raw = (int32_t)BIOMETRICS_Q16_ONE;
+
+        if (p_metrics->valid_samples == 1) {
+            p_metrics->stress_q16 = (uint32_t)stress_raw;
+        } else {
+            p_metrics->stress_q16 = (uint32_t)bio_ema(p_metrics->stress_q16, stress_raw,
+                                                      p_metrics->stress_alpha_q16);
+        }
+    }
+
+    p_metrics->last_rr_us = rr_us;
+    p_metrics->valid_samples++;
+    p_metrics->total_samples++;
+
+    return true;
+}
+
+void biometrics_set_dfa_alpha1(hr_metrics_t *p_metrics, float dfa_alpha1) {
+    if (!p_metrics) return;
+    p_metrics->dfa_alpha1 = dfa_alpha1;
+    p_metrics->dfa_alpha1_x1000 = (dfa_alpha1 > 0.0f) ? (uint16_t)(dfa_alpha1 * 1000.0f) : 0;
+}
+
+uint8_t biometrics_stress_pct(const hr_metrics_t *p_metrics) {
+    return (uint8_t)((p_metrics->stress_q16 * 100U) >> 16);
+}
+
+uint8_t biometrics_coherence_pct(const hr_metrics_t *p_metrics) {
+    return (uint8_t)(((BIOMETRICS_Q16_ONE - p_metrics->stress_q16) * 100U) >> 16);
+}
+
+void biometrics_readout(const hr_metrics_t *p_metrics, hr_readout_t *p_out) {
+    if (!p_metrics || !p_out) return;
+    p_out->mean_rr_ms = (float)p_metrics->mean_rr_us * 0.001f;
+    p_out->rmssd_ms = (float)p_metrics->rmssd_us * 0.001f;
+    p_out->stress = (float)p_metrics->stress_q16 / (float)BIOMETRICS_Q16_ONE;
+    p_out->sd1_ms = (float)p_metrics->sd1_us * 0.001f;
+    p_out->sd2_ms = (float)p_metrics->sd2_us * 0.001f;
+    p_out->sdnn_ms = (float)p_metrics->sdnn_us * 0.001f;
+}
+
 void compute_biometrics(void) {
     /* Legacy placeholder - metrics are now updated per RR interval */
 }
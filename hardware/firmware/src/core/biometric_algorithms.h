@@ -4,10 +4,19 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "rr_quantile.h"
+#include "stress_calibration.h"
+
+/* Per-beat arithmetic: build with -DBIOMETRICS_FIXED_POINT for the integer
+ * implementation (RR and RMSSD in microseconds, stress in Q16, no FPU on the
+ * per-beat path; RR arrives as integer us via biometrics_process_rr_us).
+ * Either way the integer view below is kept current, and the cue and
+ * coherence conversions read only that. */
+
+#define BIOMETRICS_Q16_ONE  65536U
 
 typedef struct {
     float rmssd;
-    float sdnn;
     float mean_rr_ms;
     float stress_score;
     uint32_t valid_samples;
@@ -15,13 +24,82 @@ typedef struct {
     float mean_diff_sq;       /**< Internal state for incremental RMSSD */
     uint32_t total_samples;   /**< Total samples seen (including artifacts) */
     
+    /* Smoothing weights per accepted beat (defaults set by biometrics_reset) */
+    float rmssd_alpha;        /**< EMA weight of the squared successive difference */
+    float stress_alpha;       /**< EMA weight of the raw stress score */
+
     /* Adaptive Baseline Tracking */
     float baseline_rmssd;     /**< Long-term average RMSSD (User Normal) */
     bool baseline_established;/**< True if enough data collected to trust baseline */
+
+    /* Nonlinear HRV (filled from hrv_nonlinear by the wellness manager) */
+    float dfa_alpha1;         /**< Short-term DFA exponent (0 until valid) */
+    float sample_entropy;     /**< SampEn (m = 2, r = 0.2 SD), 0 until valid */
+    float approx_entropy;     /**< ApEn (m = 2, r = 0.2 SD), 0 until valid */
+
+    /* Robust statistics over recent in-range beats */
+    rr_quantile_t rr_window;  /**< Sliding median / quantile filter */
+    uint16_t rr_median_ms;    /**< Median RR (artifact reference) */
+    uint16_t rr_iqr_ms;       /**< Interquartile range of RR */
+    uint8_t quality_pct;      /**< IQR-based signal quality 0-100 */
+
+    /* Per-user calibration: distribution of this user's RMSSD */
+    stress_calibration_t calibration;
+
+    /* Integer view (both builds) */
+    uint32_t last_rr_us;
+    uint32_t mean_rr_us;
+    uint32_t rmssd_us;
+    uint32_t stress_q16;      /**< Smoothed stress score, 0..BIOMETRICS_Q16_ONE */
+    uint16_t dfa_alpha1_x1000;/**< dfa_alpha1 x 1000 (0 until valid) */
+    uint32_t sd1_us;          /**< Poincaré SD1, short-term variability */
+    uint32_t sd2_us;          /**< Poincaré SD2, long-term variability */
+    uint32_t sdnn_us;         /**< SD of RR over the hrv_nonlinear window */
+
+    /* Fixed-point state */
+    uint64_t mean_diff_sq_us2;/**< EMA of squared successive differences (us^2) */
+    uint32_t baseline_rmssd_q8;/**< Baseline RMSSD, us x 256 */
+    uint32_t rmssd_alpha_q16;
+    uint32_t stress_alpha_q16;
+    stress_calibration_table_t calibration_table; /**< Percentile lookup, us */
 } hr_metrics_t;
 
+/** Per-beat metrics in float units, converted from the integer view */
+typedef struct {
+    float mean_rr_ms;
+    float rmssd_ms;
+    float stress;             /**< Smoothed stress score, 0..1 */
+    float sd1_ms;
+    float sd2_ms;
+    float sdnn_ms;
+} hr_readout_t;
+
 void biometrics_reset(hr_metrics_t *p_metrics);
+
+/** Set both EMA weights (keeps the float and Q16 copies in step) */
+void biometrics_set_smoothing(hr_metrics_t *p_metrics, float rmssd_alpha, float stress_alpha);
+
+/** Process one RR interval with the build's implementation */
 bool biometrics_process_rr(hr_metrics_t *p_metrics, float rr_ms);
+
+/** Same, RR in integer microseconds (the detector path; no float in fixed builds) */
+bool biometrics_process_rr_us(hr_metrics_t *p_metrics, uint32_t rr_us);
+
+/** The two implementations, callable directly for parity checks */
+bool biometrics_process_rr_float(hr_metrics_t *p_metrics, float rr_ms);
+bool biometrics_process_rr_fixed(hr_metrics_t *p_metrics, uint32_t rr_us);
+
+/** Store the DFA exponent from hrv_nonlinear (float and x1000 copies) */
+void biometrics_set_dfa_alpha1(hr_metrics_t *p_metrics, float dfa_alpha1);
+
+/** Smoothed stress and coherence as 0-100 percentages (integer view) */
+uint8_t biometrics_stress_pct(const hr_metrics_t *p_metrics);
+uint8_t biometrics_coherence_pct(const hr_metrics_t *p_metrics);
+
+/** Per-beat metrics for logs and host tools (correct in both builds; the
+ *  float fields above are not updated by the fixed-point path) */
+void biometrics_readout(const hr_metrics_t *p_metrics, hr_readout_t *p_out);
+
 void compute_biometrics(void);
 
 #endif
@@ -0,0 +1,154 @@
+/**
+ * @file detector_elgendi.c
+ * @brief Elgendi two-moving-average PPG peak detector engine (100 Hz)
+ *
+ * Based on Elgendi et al., "Systolic Peak Detection in Acceleration
+ * Photoplethysmograms Measured from Emergency Responders in Tropical
+ * Conditions" (2013):
+ *
+ *   0.5-8 Hz band-pass -> clip negatives -> square -> MA over W1 (peak)
+ *   and W2 (beat) -> blocks of interest where MA_peak > MA_beat + alpha
+ *   -> beat at energy maximum inside each block at least W1 wide
+ *
+ * Most robust of the three engines under baseline wander and motion, at the
+ * cost of two biquads and two moving averages per sample.
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "peak_detector.h"
+
+/*******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
+
+#define ELGENDI_BETA            0.02f       /**< Offset: beta * mean energy */
+#define ELGENDI_ENERGY_ALPHA    0.002f      /**< Mean energy EMA (~5 s) */
+#define ELGENDI_WARMUP_SAMPLES  200U        /**< Let filters settle (2 s) */
+#define ELGENDI_REFRACTORY_MS   300U        /**< Ignore blocks within 300 ms of a beat */
+
+/* Butterworth biquads for fs = 100 Hz (RBJ cookbook, Q = 0.7071) */
+#define ELGENDI_HP_B0           0.97803048f
+#define ELGENDI_HP_B1          -1.95606096f
+#define ELGENDI_HP_A1          -1.95557824f
+#define ELGENDI_HP_A2           0.95654368f
+
+#define ELGENDI_LP_B0           0.04613180f
+#define ELGENDI_LP_B1           0.09226360f
+#define ELGENDI_LP_A1          -1.30728503f
+#define ELGENDI_LP_A2           0.49181224f
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+static inline float elgendi_biquad(float x, float *xh, float *yh,
+                                   float b0, float b1, float a1, float a2)
+{
+    /* Symmetric numerator (b2 == b0) for both Butterworth sections */
+    float y = b0 * (x + xh[1]) + b1 * xh[0] - a1 * yh[0] - a2 * yh[1];
+    xh[1] = xh[0];
+    xh[0] = x;
+    yh[1] = yh[0];
+    yh[0] = y;
+    return y;
+}
+
+static void elgendi_process_sample(peak_detector_t *det, float sample,
+                                   uint32_t timestamp_ms, uint16_t period_ms)
+{
+    elgendi_detector_state_t *s = &det->engine.elgendi;
+
+    /* Seed high-pass history with the first sample to avoid a DC step */
+    if (s->warmup == 0U) {
+        s->hp_x[0] = s->hp_x[1] = sample;
+    }
+
+    /* 1) Band-pass */
+    float hp = elgendi_biquad(sample, s->hp_x, s->hp_y,
+                              ELGENDI_HP_B0, ELGENDI_HP_B1, ELGENDI_HP_A1, ELGENDI_HP_A2);
+    float bp = elgendi_biquad(hp, s->lp_x, s->lp_y,
+                              ELGENDI_LP_B0, ELGENDI_LP_B1, ELGENDI_LP_A1, ELGENDI_LP_A2);
+
+    /* 2) Clip and square */
+    float clipped = (bp > 0.0f) ? bp : 0.0f;
+    float energy = clipped * clipped;
+
+    /* 3) Two moving averages */
+    s->peak_sum += energy - s->peak_buffer[s->peak_idx];
+    s->peak_buffer[s->peak_idx] = energy;
+    s->peak_idx = (uint8_t)((s->peak_idx + 1U) % ELGENDI_W1);
+
+    s->beat_sum += energy - s->beat_buffer[s->beat_idx];
+    s->beat_buffer[s->beat_idx] = energy;
+    s->beat_idx = (uint8_t)((s->beat_idx + 1U) % ELGENDI_W2);
+
+    s->mean_energy += ELGENDI_ENERGY_ALPHA * (energy - s->mean_energy);
+
+    if (s->warmup < ELGENDI_WARMUP_SAMPLES) {
+        s->warmup++;
+        return;
+    }
+
+    float ma_peak = s->peak_sum * (1.0f / (float)ELGENDI_W1);
+    float ma_beat = s->beat_sum * (1.0f / (float)ELGENDI_W2);
+    float thr = ma_beat + ELGENDI_BETA * s->mean_energy;
+
+    /* MA_peak is a trailing window: search the sample at its centre */
+    uint8_t centre_idx = (uint8_t)((s->peak_idx + ELGENDI_W1 / 2U) % ELGENDI_W1);
+    float centre_energy = s->peak_buffer[centre_idx];
+    uint32_t centre_ms = timestamp_ms - (uint32_t)(ELGENDI_W1 / 2U) * period_ms;
+
+    /* 4) Blocks of interest */
+    if (ma_peak > thr) {
+        if (!s->in_block) {
+            s->in_block = true;
+            s->block_len = 0;
+            s->block_max = 0.0f;
+        }
+        s->block_len++;
+        if (centre_energy > s->block_max) {
+            s->block_max = centre_energy;
+            s->block_max_ms = centre_ms;
+        }
+        return;
+    }
+
+    if (s->in_block) {
+        s->in_block = false;
+
+        bool wide_enough = (s->block_len >= ELGENDI_W1);
+        bool refractory_ok = (s->last_beat_ms == 0U) ||
+                             ((s->block_max_ms - s->last_beat_ms) > ELGENDI_REFRACTORY_MS);
+
+        if (wide_enough && refractory_ok && s->block_max > 0.0f) {
+            s->last_beat_ms = s->block_max_ms;
+            peak_detector_emit(det, s->block_max_ms, s->block_max);
+        }
+    }
+}
+
+/*******************************************************************************
+ * ENGINE OPERATIONS
+ ******************************************************************************/
+
+static void elgendi_init(peak_detector_t *det)
+{
+    det->engine.elgendi = (elgendi_detector_state_t){0};
+}
+
+static void elgendi_process_block(peak_detector_t *det, const float *samples,
+                                  uint16_t count, uint32_t t0_ms, uint16_t period_ms)
+{
+    for (uint16_t i = 0; i < count; i++) {
+        elgendi_process_sample(det, samples[i], t0_ms + (uint32_t)i * period_ms, period_ms);
+    }
+}
+
+const peak_detector_ops_t g_peak_detector_elgendi = {
+    .name = "elgendi",
+    .init = elgendi_init,
+    .process_block = elgendi_process_block,
+    .reset = elgendi_init,
+};
@@ -0,0 +1,109 @@
+/**
+ * @file detector_pan_tompkins.c
+ * @brief Simplified Pan-Tompkins PPG peak detector engine (100 Hz)
+ *
+ * Pipeline: DC removal -> derivative -> squaring -> moving integration ->
+ * adaptive threshold with refractory guard. This is the original ring
+ * detector, moved behind the peak_detector interface; the only
+ * change is priming the derivative at zero so the first sample no longer
+ * produces a start-up energy spike.
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "peak_detector.h"
+
+/*******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
+
+#define PT_REFRACTORY_MS        300U        /**< Ignore peaks within 300 ms */
+#define PT_INITIAL_THRESHOLD    0.05f       /**< Starting adaptive threshold */
+#define PT_THRESH_DECAY         0.995f      /**< Slow decay when no peaks */
+#define PT_THRESH_BOOST_ALPHA   0.10f       /**< How fast threshold follows peaks */
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+static inline float pt_moving_average(float *buffer, uint8_t *idx, uint8_t size,
+                                      float *accum, float sample)
+{
+    *accum -= buffer[*idx];
+    buffer[*idx] = sample;
+    *accum += sample;
+    *idx = (uint8_t)((*idx + 1U) % size);
+    return *accum / (float)size;
+}
+
+static void pt_process_sample(peak_detector_t *det, float sample, uint32_t timestamp_ms)
+{
+    pt_detector_state_t *s = &det->engine.pt;
+
+    /* Initialize threshold and buffers on first sample */
+    if (!s->initialized) {
+        for (uint8_t i = 0; i < PT_DC_WINDOW; i++) s->dc_buffer[i] = sample;
+        for (uint8_t i = 0; i < PT_INTEGRATOR_WINDOW; i++) s->integ_buffer[i] = 0.0f;
+        s->dc_sum = sample * (float)PT_DC_WINDOW;
+        s->integ_sum = 0.0f;
+        s->prev_dc_removed = 0.0f;
+        s->threshold = PT_INITIAL_THRESHOLD;
+        s->last_peak_ts_ms = 0U;
+        s->dc_idx = 0U;
+        s->integ_idx = 0U;
+        s->initialized = true;
+    }
+
+    /* 1) DC removal via short moving average */
+    float dc_mean = pt_moving_average(s->dc_buffer, &s->dc_idx, PT_DC_WINDOW, &s->dc_sum, sample);
+    float dc_removed = sample - dc_mean;
+
+    /* 2) Derivative (emphasize rising edge) and 3) Squaring */
+    float diff = dc_removed - s->prev_dc_removed;
+    s->prev_dc_removed = dc_removed;
+    float squared = diff * diff;
+
+    /* 4) Moving integration (approximate energy over ~120 ms) */
+    float integ_avg = pt_moving_average(s->integ_buffer, &s->integ_idx, PT_INTEGRATOR_WINDOW,
+                                        &s->integ_sum, squared);
+
+    /* 5) Adaptive thresholding with refractory period */
+    bool refractory_ok = (s->last_peak_ts_ms == 0U) ||
+                         ((timestamp_ms - s->last_peak_ts_ms) > PT_REFRACTORY_MS);
+
+    if (refractory_ok && (integ_avg > s->threshold)) {
+        /* Update threshold toward current peak energy */
+        s->threshold = (1.0f - PT_THRESH_BOOST_ALPHA) * s->threshold + PT_THRESH_BOOST_ALPHA * integ_avg;
+        s->last_peak_ts_ms = timestamp_ms;
+        peak_detector_emit(det, timestamp_ms, integ_avg);
+        return;
+    }
+
+    /* Slowly decay threshold to follow lower amplitudes */
+    s->threshold *= PT_THRESH_DECAY;
+}
+
+/*******************************************************************************
+ * ENGINE OPERATIONS
+ ******************************************************************************/
+
+static void pt_init(peak_detector_t *det)
+{
+    det->engine.pt = (pt_detector_state_t){0};
+}
+
+static void pt_process_block(peak_detector_t *det, const float *samples,
+                             uint16_t count, uint32_t t0_ms, uint16_t period_ms)
+{
+    for (uint16_t i = 0; i < count; i++) {
+        pt_process_sample(det, samples[i], t0_ms + (uint32_t)i * period_ms);
+    }
+}
+
+const peak_detector_ops_t g_peak_detector_pan_tompkins = {
+    .name = "pan-tompkins",
+    .init = pt_init,
+    .process_block = pt_process_block,
+    .reset = pt_init,
+};
@@ -0,0 +1,139 @@
+/**
+ * @file detector_ssf.c
+ * @brief Slope sum function (SSF) PPG peak detector engine (100 Hz)
+ *
+ * Based on Zong et al., "An open-source algorithm to detect onset of
+ * arterial blood pressure pulses" (2003), adapted for PPG:
+ *
+ *   smooth (3-tap) -> positive first difference -> windowed sum (~128 ms)
+ *   -> threshold at a fraction of the running SSF maximum -> local max
+ *      search -> beat at SSF maximum (end of systolic upstroke)
+ *
+ * A handful of adds and compares per sample; the threshold is only
+ * recomputed once per beat. On bench_detectors it runs in slightly fewer
+ * cycles per sample than Elgendi; Pan-Tompkins is cheaper but far less
+ * accurate on PPG.
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "peak_detector.h"
+
+/*******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
+
+#define SSF_LEARN_MS            2000U       /**< Initial threshold learning period */
+#define SSF_REFRACTORY_MS       300U        /**< Ignore onsets within 300 ms of a beat */
+#define SSF_SEARCH_MAX_MS       200U        /**< Max time to look for SSF maximum */
+#define SSF_LOST_MS             2500U       /**< Start lowering threshold after this gap */
+#define SSF_THRESHOLD_FRACTION  0.6f        /**< Threshold vs running SSF maximum */
+#define SSF_PEAK_AVG_ALPHA      0.25f       /**< Running maximum update weight */
+#define SSF_SEARCH_END_FRACTION 0.5f        /**< Pulse ends when SSF falls below this */
+#define SSF_LOST_DECAY          0.995f      /**< Per-sample decay while lost */
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+static void ssf_process_sample(peak_detector_t *det, float sample, uint32_t timestamp_ms)
+{
+    ssf_detector_state_t *s = &det->engine.ssf;
+
+    if (!s->initialized) {
+        s->smooth[0] = s->smooth[1] = s->smooth[2] = sample;
+        s->prev_smoothed = sample;
+        s->learn_end_ms = timestamp_ms + SSF_LEARN_MS;
+        s->initialized = true;
+    }
+
+    /* 1) Light smoothing to suppress sample-level noise */
+    s->smooth[2] = s->smooth[1];
+    s->smooth[1] = s->smooth[0];
+    s->smooth[0] = sample;
+    float smoothed = (s->smooth[0] + s->smooth[1] + s->smooth[2]) * (1.0f / 3.0f);
+
+    /* 2) Positive slopes only (rising edge of the pulse) */
+    float dy = smoothed - s->prev_smoothed;
+    s->prev_smoothed = smoothed;
+    float slope = (dy > 0.0f) ? dy : 0.0f;
+
+    /* 3) Windowed slope sum */
+    s->ssf_sum += slope - s->slope_buffer[s->slope_idx];
+    s->slope_buffer[s->slope_idx] = slope;
+    s->slope_idx = (uint8_t)((s->slope_idx + 1U) % SSF_WINDOW);
+    if (s->ssf_sum < 0.0f) s->ssf_sum = 0.0f;   /* Guard float drift */
+    float ssf = s->ssf_sum;
+
+    /* 4) Learning period: seed threshold from the largest SSF seen */
+    if ((int32_t)(timestamp_ms - s->learn_end_ms) < 0) {
+        if (ssf > s->peak_avg) {
+            s->peak_avg = ssf;
+            s->threshold = SSF_THRESHOLD_FRACTION * s->peak_avg;
+        }
+        return;
+    }
+
+    /* 5) Inside a pulse: track SSF maximum until it falls away */
+    if (s->searching) {
+        if (ssf > s->search_max) {
+            s->search_max = ssf;
+            s->search_max_ms = timestamp_ms;
+        }
+
+        if (ssf < SSF_SEARCH_END_FRACTION * s->search_max ||
+            (timestamp_ms - s->search_start_ms) > SSF_SEARCH_MAX_MS) {
+            s->searching = false;
+            s->last_beat_ms = s->search_max_ms;
+            s->peak_avg = (1.0f - SSF_PEAK_AVG_ALPHA) * s->peak_avg +
+                          SSF_PEAK_AVG_ALPHA * s->search_max;
+            s->threshold = SSF_THRESHOLD_FRACTION * s->peak_avg;
+            peak_detector_emit(det, s->search_max_ms, s->search_max);
+        }
+        return;
+    }
+
+    /* 6) Pulse onset: SSF crosses threshold outside refractory period */
+    bool refractory_ok = (s->last_beat_ms == 0U) ||
+                         ((timestamp_ms - s->last_beat_ms) > SSF_REFRACTORY_MS);
+
+    if (refractory_ok && ssf > s->threshold) {
+        s->searching = true;
+        s->search_max = ssf;
+        s->search_max_ms = timestamp_ms;
+        s->search_start_ms = timestamp_ms;
+        return;
+    }
+
+    /* 7) No beats for a while (amplitude dropped): relax threshold */
+    uint32_t since = timestamp_ms - ((s->last_beat_ms != 0U) ? s->last_beat_ms : s->learn_end_ms);
+    if (since > SSF_LOST_MS) {
+        s->peak_avg *= SSF_LOST_DECAY;
+        s->threshold = SSF_THRESHOLD_FRACTION * s->peak_avg;
+    }
+}
+
+/*******************************************************************************
+ * ENGINE OPERATIONS
+ ******************************************************************************/
+
+static void ssf_init(peak_detector_t *det)
+{
+    det->engine.ssf = (ssf_detector_state_t){0};
+}
+
+static void ssf_process_block(peak_detector_t *det, const float *samples,
+                              uint16_t count, uint32_t t0_ms, uint16_t period_ms)
+{
+    for (uint16_t i = 0; i < count; i++) {
+        ssf_process_sample(det, samples[i], t0_ms + (uint32_t)i * period_ms);
+    }
+}
+
+const peak_detector_ops_t g_peak_detector_ssf = {
+    .name = "ssf",
+    .init = ssf_init,
+    .process_block = ssf_process_block,
+    .reset = ssf_init,
+};
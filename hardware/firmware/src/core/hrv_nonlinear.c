@@ -0,0 +1,410 @@
+/**
+ * @file hrv_nonlinear.c
+ * @brief Incremental Nonlinear HRV: Poincaré SD1/SD2, DFA alpha1, SampEn/ApEn
+ *
+ * SD1/SD2 use the rotated Poincaré axes: with d = RR[n+1] - RR[n] and
+ * s = RR[n+1] + RR[n], SD1² = var(d) / 2 and SD2² = var(s) / 2; SDNN is
+ * the sample SD of the RR intervals themselves. The sums
+ * are exact integers, so adding and evicting pairs never drifts, and the
+ * per-beat update (including the square root) stays in integer arithmetic.
+ *
+ * DFA alpha1 follows Peng et al. (1995): integrate the mean-removed RR
+ * series, split it into non-overlapping boxes of n beats, remove a linear
+ * trend per box, and take the slope of log F(n) against log n for n = 4..16.
+ *
+ * SampEn follows Richman & Moorman (2000): B and A count template pairs
+ * (self-matches excluded, first N - m templates) within r in every sample
+ * for lengths m and m + 1, SampEn = ln(B / A). ApEn (Pincus 1991) uses
+ * the per-template match counts including self: ApEn = Φ^m - Φ^(m+1).
+ * Matching a template against only the candidates in its own and the next
+ * sort bucket finds exactly the pairs a full O(n²) scan would.
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "hrv_nonlinear.h"
+#include <math.h>
+#include <string.h>
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+static inline uint16_t hrv_nl_index(const hrv_nonlinear_t *p_ctx, uint16_t age_from_oldest)
+{
+    return (uint16_t)((p_ctx->head + HRV_NL_MAX_BEATS - p_ctx->count + age_from_oldest) % HRV_NL_MAX_BEATS);
+}
+
+static void hrv_nl_pair(hrv_nonlinear_t *p_ctx, uint16_t x, uint16_t y, bool add)
+{
+    int64_t d = (int64_t)y - (int64_t)x;
+    uint64_t s = (uint64_t)y + (uint64_t)x;
+
+    if (add) {
+        p_ctx->sum_d += d;
+        p_ctx->sum_dd += (uint64_t)(d * d);
+        p_ctx->sum_s += s;
+        p_ctx->sum_ss += s * s;
+    } else {
+        p_ctx->sum_d -= d;
+        p_ctx->sum_dd -= (uint64_t)(d * d);
+        p_ctx->sum_s -= s;
+        p_ctx->sum_ss -= s * s;
+    }
+}
+
+static void hrv_nl_evict_oldest(hrv_nonlinear_t *p_ctx)
+{
+    uint16_t oldest = hrv_nl_index(p_ctx, 0);
+
+    if (p_ctx->count >= 2U) {
+        uint16_t next = hrv_nl_index(p_ctx, 1);
+        hrv_nl_pair(p_ctx, p_ctx->rr[oldest], p_ctx->rr[next], false);
+    }
+    p_ctx->window_ms -= p_ctx->rr[oldest];
+    p_ctx->sum_rr_sq -= (uint64_t)p_ctx->rr[oldest] * p_ctx->rr[oldest];
+    p_ctx->count--;
+}
+
+static uint32_t hrv_nl_isqrt(uint64_t value)
+{
+    uint64_t root = 0;
+    uint64_t bit = 1ULL << 62;
+
+    while (bit > value) bit >>= 2;
+    while (bit != 0) {
+        if (value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)((value > root) ? root + 1 : root);
+}
+
+/* sqrt(num / den) ms² in us; the quotient is split so the 10^6 scale cannot overflow */
+static uint32_t hrv_nl_sqrt_us(int64_t num, uint64_t den)
+{
+    if (num <= 0) return 0U;
+
+    uint64_t q = (uint64_t)num / den;
+    uint64_t r = (uint64_t)num % den;
+    return hrv_nl_isqrt(q * 1000000U + (r * 1000000U) / den);
+}
+
+static void hrv_nl_update_poincare(hrv_nonlinear_t *p_ctx)
+{
+    int64_t n = (int64_t)p_ctx->count - 1;
+    int64_t beats = (int64_t)p_ctx->count;
+
+    if (n < 2) {
+        p_ctx->sd1_us = 0U;
+        p_ctx->sd2_us = 0U;
+        p_ctx->sdnn_us = 0U;
+        return;
+    }
+
+    /* n² * variance, exact in 64-bit for the window sizes used here */
+    int64_t var_d = n * (int64_t)p_ctx->sum_dd - p_ctx->sum_d * p_ctx->sum_d;
+    int64_t var_s = n * (int64_t)p_ctx->sum_ss - (int64_t)(p_ctx->sum_s * p_ctx->sum_s);
+    int64_t var_rr = beats * (int64_t)p_ctx->sum_rr_sq - (int64_t)p_ctx->window_ms * (int64_t)p_ctx->window_ms;
+
+    p_ctx->sd1_us = hrv_nl_sqrt_us(var_d, 2U * (uint64_t)(n * n));
+    p_ctx->sd2_us = hrv_nl_sqrt_us(var_s, 2U * (uint64_t)(n * n));
+    p_ctx->sdnn_us = hrv_nl_sqrt_us(var_rr, (uint64_t)(beats * n));
+}
+
+/* Copy the window into the integrated, mean-removed profile */
+static void hrv_nl_snapshot(hrv_nonlinear_t *p_ctx)
+{
+    int32_t mean = (int32_t)((p_ctx->window_ms + p_ctx->count / 2U) / p_ctx->count);
+    int32_t acc = 0;
+
+    for (uint16_t i = 0; i < p_ctx->count; i++) {
+        acc += (int32_t)p_ctx->rr[hrv_nl_index(p_ctx, i)] - mean;
+        p_ctx->profile[i] = acc;
+    }
+    p_ctx->profile_len = p_ctx->count;
+}
+
+/**
+ * Mean squared residual of the profile after per-box linear detrending.
+ *
+ * Per box (k = 0..n-1) the least-squares residual is
+ *   R = (A - B² / C) / n,  A = nΣy² - (Σy)²,  B = nΣky - ΣkΣy,
+ *   C = n²(n² - 1) / 12
+ * A and B are exact integers; values are taken relative to the first
+ * sample of the box to keep them small.
+ */
+static float hrv_nl_fluctuation(const int32_t *profile, uint16_t len, uint8_t n)
+{
+    uint16_t boxes = (uint16_t)(len / n);
+    if (boxes == 0U) return 0.0f;
+
+    const int64_t sum_k = (int64_t)n * (n - 1) / 2;
+    const float c = (float)((int64_t)n * n * ((int64_t)n * n - 1) / 12);
+    float total = 0.0f;
+
+    for (uint16_t b = 0; b < boxes; b++) {
+        const int32_t *y = &profile[b * n];
+        int64_t sy = 0, sky = 0, syy = 0;
+
+        for (uint8_t k = 0; k < n; k++) {
+            int64_t v = (int64_t)y[k] - y[0];
+            sy += v;
+            sky += (int64_t)k * v;
+            syy += v * v;
+        }
+
+        int64_t a = (int64_t)n * syy - sy * sy;
+        float bb = (float)((int64_t)n * sky - sum_k * sy);
+        float r = ((float)a - bb * bb / c) / (float)n;
+        if (r > 0.0f) total += r;
+    }
+
+    return total / (float)(boxes * n);
+}
+
+static float hrv_nl_slope(const float *x, const float *y, uint8_t n)
+{
+    float sx = 0.0f, sy = 0.0f, sxx = 0.0f, sxy = 0.0f;
+
+    for (uint8_t i = 0; i < n; i++) {
+        sx += x[i];
+        sy += y[i];
+        sxx += x[i] * x[i];
+        sxy += x[i] * y[i];
+    }
+
+    float den = (float)n * sxx - sx * sx;
+    return (den != 0.0f) ? ((float)n * sxy - sx * sy) / den : 0.0f;
+}
+
+static inline uint16_t hrv_nl_absdiff(uint16_t a, uint16_t b)
+{
+    return (uint16_t)((a > b) ? a - b : b - a);
+}
+
+/* Snapshot the window, pick r and bucket-sort the templates by first value */
+static void hrv_nl_entropy_start(hrv_nonlinear_t *p_ctx)
+{
+    uint16_t n = p_ctx->count;
+    uint16_t templates = (uint16_t)(n - HRV_NL_ENT_M + 1U);
+    uint16_t lo = UINT16_MAX, hi = 0;
+    uint64_t sum = 0, sum_sq = 0;
+
+    for (uint16_t i = 0; i < n; i++) {
+        uint16_t x = p_ctx->rr[hrv_nl_index(p_ctx, i)];
+        p_ctx->ent_x[i] = x;
+        sum += x;
+        sum_sq += (uint64_t)x * x;
+        if (x < lo) lo = x;
+        if (x > hi) hi = x;
+    }
+
+    /* n² * variance is exact; r = 0.2 SD rounded to whole ms */
+    uint64_t var_n2 = (uint64_t)n * sum_sq - sum * sum;
+    float sd = sqrtf((float)var_n2) / (float)n;
+    p_ctx->ent_r = (uint16_t)(sd * (float)HRV_NL_ENT_R_PCT / 100.0f + 0.5f);
+
+    /* Bucket width >= r keeps every match in the same or the next bucket */
+    uint16_t width = (p_ctx->ent_r > 0U) ? p_ctx->ent_r : 1U;
+    if ((uint32_t)(hi - lo) / width >= HRV_NL_ENT_BUCKETS) {
+        width = (uint16_t)((hi - lo) / HRV_NL_ENT_BUCKETS + 1U);
+    }
+
+    /* Counting sort: O(n + buckets) */
+    uint16_t start[HRV_NL_ENT_BUCKETS + 1];
+    memset(start, 0, sizeof(start));
+    for (uint16_t i = 0; i < templates; i++) {
+        p_ctx->ent_key[i] = (uint8_t)((p_ctx->ent_x[i] - lo) / width);
+        start[p_ctx->ent_key[i] + 1U]++;
+    }
+    for (uint16_t b = 0; b < HRV_NL_ENT_BUCKETS; b++) {
+        start[b + 1U] = (uint16_t)(start[b + 1U] + start[b]);
+    }
+    for (uint16_t i = 0; i < templates; i++) {
+        p_ctx->ent_order[start[p_ctx->ent_key[i]]++] = (uint8_t)i;
+    }
+
+    memset(p_ctx->ent_cnt_m, 0, templates * sizeof(uint16_t));
+    memset(p_ctx->ent_cnt_m1, 0, templates * sizeof(uint16_t));
+    p_ctx->ent_templates = templates;
+    p_ctx->ent_pos = 0U;
+    p_ctx->ent_b = 0U;
+    p_ctx->ent_a = 0U;
+    p_ctx->ent_phi_m = 0.0f;
+    p_ctx->ent_phi_m1 = 0.0f;
+    p_ctx->ent_phase = 1U;
+    p_ctx->beats_since_ent = 0U;
+}
+
+/* Match one chunk of sorted templates against the candidates after them */
+static void hrv_nl_entropy_count(hrv_nonlinear_t *p_ctx)
+{
+    const uint16_t *x = p_ctx->ent_x;
+    const uint16_t r = p_ctx->ent_r;
+    const uint16_t templates = p_ctx->ent_templates;
+    const uint16_t last = (uint16_t)(templates - 1U);   /* No (m+1)-sample extension */
+    uint16_t end = (uint16_t)(p_ctx->ent_pos + HRV_NL_ENT_CHUNK);
+    if (end > templates) end = templates;
+
+    for (uint16_t p = p_ctx->ent_pos; p < end; p++) {
+        uint8_t i = p_ctx->ent_order[p];
+        uint16_t key_limit = (uint16_t)(p_ctx->ent_key[i] + 1U);
+
+        for (uint16_t q = (uint16_t)(p + 1U); q < templates; q++) {
+            uint8_t j = p_ctx->ent_order[q];
+            if (p_ctx->ent_key[j] > key_limit) break;
+            if (hrv_nl_absdiff(x[i], x[j]) > r || hrv_nl_absdiff(x[i + 1], x[j + 1]) > r) continue;
+
+            p_ctx->ent_cnt_m[i]++;
+            p_ctx->ent_cnt_m[j]++;
+            if (i == last || j == last) continue;
+
+            p_ctx->ent_b++;
+            if (hrv_nl_absdiff(x[i + 2], x[j + 2]) <= r) {
+                p_ctx->ent_a++;
+                p_ctx->ent_cnt_m1[i]++;
+                p_ctx->ent_cnt_m1[j]++;
+            }
+        }
+    }
+
+    p_ctx->ent_pos = end;
+    if (end == templates) {
+        p_ctx->ent_pos = 0U;
+        p_ctx->ent_phase = 2U;
+    }
+}
+
+/* Sum one chunk of ln(count) terms for ApEn; publish when done */
+static bool hrv_nl_entropy_sum(hrv_nonlinear_t *p_ctx)
+{
+    const uint16_t templates = p_ctx->ent_templates;
+    uint16_t end = (uint16_t)(p_ctx->ent_pos + HRV_NL_ENT_CHUNK);
+    if (end > templates) end = templates;
+
+    for (uint16_t i = p_ctx->ent_pos; i < end; i++) {
+        p_ctx->ent_phi_m += logf((float)p_ctx->ent_cnt_m[i] + 1.0f);
+        if (i + 1U < templates) {
+            p_ctx->ent_phi_m1 += logf((float)p_ctx->ent_cnt_m1[i] + 1.0f);
+        }
+    }
+    p_ctx->ent_pos = end;
+    if (end < templates) return false;
+
+    p_ctx->ent_phase = 0U;
+    if (p_ctx->ent_a == 0U) return false;   /* SampEn undefined: keep the last values */
+
+    float t_m = (float)templates, t_m1 = (float)(templates - 1U);
+    p_ctx->apen = (p_ctx->ent_phi_m / t_m - logf(t_m)) - (p_ctx->ent_phi_m1 / t_m1 - logf(t_m1));
+    p_ctx->sampen = logf((float)p_ctx->ent_b / (float)p_ctx->ent_a);
+    p_ctx->entropy_valid = true;
+    return true;
+}
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+void hrv_nonlinear_reset(hrv_nonlinear_t *p_ctx)
+{
+    if (p_ctx) {
+        memset(p_ctx, 0, sizeof(hrv_nonlinear_t));
+    }
+}
+
+void hrv_nonlinear_add_rr(hrv_nonlinear_t *p_ctx, float rr_ms)
+{
+    if (rr_ms < 1.0f) return;
+    hrv_nonlinear_add_rr_us(p_ctx, (rr_ms >= 65535.0f) ? 65535000U : (uint32_t)(rr_ms * 1000.0f + 0.5f));
+}
+
+void hrv_nonlinear_add_rr_us(hrv_nonlinear_t *p_ctx, uint32_t rr_us)
+{
+    if (!p_ctx || rr_us < 1000U) return;
+
+    uint16_t rr = (rr_us >= 65535000U) ? 65535U : (uint16_t)((rr_us + 500U) / 1000U);
+
+    if (p_ctx->count == HRV_NL_MAX_BEATS) {
+        hrv_nl_evict_oldest(p_ctx);
+    }
+
+    if (p_ctx->count > 0U) {
+        uint16_t prev = p_ctx->rr[(p_ctx->head + HRV_NL_MAX_BEATS - 1U) % HRV_NL_MAX_BEATS];
+        hrv_nl_pair(p_ctx, prev, rr, true);
+    }
+
+    p_ctx->rr[p_ctx->head] = rr;
+    p_ctx->head = (uint16_t)((p_ctx->head + 1U) % HRV_NL_MAX_BEATS);
+    p_ctx->count++;
+    p_ctx->window_ms += rr;
+    p_ctx->sum_rr_sq += (uint64_t)rr * rr;
+
+    /* Keep the window to the last ~2 minutes */
+    while (p_ctx->count > 1U && p_ctx->window_ms > HRV_NL_WINDOW_MS) {
+        hrv_nl_evict_oldest(p_ctx);
+    }
+
+    if (p_ctx->beats_since_dfa < UINT16_MAX) {
+        p_ctx->beats_since_dfa++;
+    }
+    if (p_ctx->beats_since_ent < UINT16_MAX) {
+        p_ctx->beats_since_ent++;
+    }
+
+    hrv_nl_update_poincare(p_ctx);
+}
+
+bool hrv_nonlinear_step(hrv_nonlinear_t *p_ctx)
+{
+    if (!p_ctx) return false;
+
+    if (p_ctx->dfa_scale == 0U) {
+        if (p_ctx->ent_phase == 1U) {
+            hrv_nl_entropy_count(p_ctx);
+            return false;
+        }
+        if (p_ctx->ent_phase == 2U) return hrv_nl_entropy_sum(p_ctx);
+
+        /* Idle: start a new pass once enough fresh beats have arrived;
+         * when both are due the staler one goes first (DFA on a tie) */
+        bool dfa_due = p_ctx->count >= HRV_NL_DFA_MIN_BEATS &&
+                       (!p_ctx->dfa_valid || p_ctx->beats_since_dfa >= HRV_NL_DFA_UPDATE_BEATS);
+        bool ent_due = p_ctx->count >= HRV_NL_ENT_MIN_BEATS &&
+                       p_ctx->beats_since_ent >= HRV_NL_ENT_UPDATE_BEATS;
+
+        if (dfa_due && (!ent_due || p_ctx->beats_since_dfa >= p_ctx->beats_since_ent)) {
+            hrv_nl_snapshot(p_ctx);
+            p_ctx->dfa_scale = HRV_NL_DFA_MIN_SCALE;
+            p_ctx->dfa_points = 0U;
+            p_ctx->beats_since_dfa = 0U;
+        } else if (ent_due) {
+            hrv_nl_entropy_start(p_ctx);
+        }
+        return false;
+    }
+
+    /* One box size per call */
+    float f2 = hrv_nl_fluctuation(p_ctx->profile, p_ctx->profile_len, p_ctx->dfa_scale);
+    if (f2 > 0.0f) {
+        p_ctx->dfa_log_n[p_ctx->dfa_points] = logf((float)p_ctx->dfa_scale);
+        p_ctx->dfa_log_f[p_ctx->dfa_points] = 0.5f * logf(f2);
+        p_ctx->dfa_points++;
+    }
+    p_ctx->dfa_scale++;
+
+    if (p_ctx->dfa_scale <= HRV_NL_DFA_MAX_SCALE) return false;
+
+    /* Pass complete: fit log F(n) = alpha1 * log n + c */
+    p_ctx->dfa_scale = 0U;
+    if (p_ctx->dfa_points < 3U) return false;
+
+    p_ctx->dfa_alpha1 = hrv_nl_slope(p_ctx->dfa_log_n, p_ctx->dfa_log_f, p_ctx->dfa_points);
+    p_ctx->dfa_valid = true;
+    return true;
+}
@@ -0,0 +1,143 @@
+/**
+ * @file hrv_nonlinear.h
+ * @brief Incremental Nonlinear HRV: Poincaré SD1/SD2, DFA alpha1, SampEn/ApEn
+ *
+ * Runs next to biometrics_process_rr() on accepted RR intervals.
+ *
+ *   - SD1/SD2 are kept current in O(1) per beat from running integer sums
+ *     of successive RR pairs over a sliding ~2 minute window (integer math
+ *     only, so the per-beat path needs no FPU). SDNN comes from the same
+ *     window's running sums of RR and RR².
+ *   - Short-term DFA alpha1 (box sizes 4..16 beats) is computed over the
+ *     same window. The work is amortized: the RR profile is snapshotted
+ *     into a fixed int32 buffer and one box size is evaluated per
+ *     hrv_nonlinear_step() call, so no tick does more than O(window).
+ *   - Sample and approximate entropy (m = 2, r = 0.2 SD) over the same
+ *     window. Templates are bucket-sorted by their first RR value with
+ *     bucket width >= r, so only the same and the next bucket hold match
+ *     candidates; a fixed number of templates is scanned per step call.
+ *
+ * All buffers are fixed-size; no dynamic allocation.
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef HRV_NONLINEAR_H
+#define HRV_NONLINEAR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
+
+#define HRV_NL_MAX_BEATS            256     /**< RR ring capacity (2 min @ 128 bpm) */
+#define HRV_NL_WINDOW_MS            120000U /**< Sliding analysis window */
+#define HRV_NL_DFA_MIN_SCALE        4       /**< Smallest DFA box (beats) */
+#define HRV_NL_DFA_MAX_SCALE        16      /**< Largest DFA box (beats) */
+#define HRV_NL_DFA_MIN_BEATS        64      /**< Beats needed before DFA runs */
+#define HRV_NL_DFA_UPDATE_BEATS     10      /**< New beats between DFA passes */
+
+#define HRV_NL_ENT_M                2       /**< Template length */
+#define HRV_NL_ENT_R_PCT            20      /**< Tolerance r, % of window SD */
+#define HRV_NL_ENT_MIN_BEATS        64      /**< Beats needed before entropy runs */
+#define HRV_NL_ENT_UPDATE_BEATS     10      /**< New beats between entropy passes */
+#define HRV_NL_ENT_BUCKETS          64      /**< Max sort buckets (widened past r if needed) */
+#define HRV_NL_ENT_CHUNK            32      /**< Templates handled per step call */
+
+#define HRV_NL_DFA_SCALES   (HRV_NL_DFA_MAX_SCALE - HRV_NL_DFA_MIN_SCALE + 1)
+
+/*******************************************************************************
+ * TYPES
+ ******************************************************************************/
+
+typedef struct {
+    /* RR window (ms) */
+    uint16_t rr[HRV_NL_MAX_BEATS];
+    uint16_t head;                  /**< Next write index */
+    uint16_t count;
+    uint32_t window_ms;             /**< Sum of RR in the window */
+    uint64_t sum_rr_sq;             /**< Σ RR² in the window */
+
+    /* Poincaré running sums over successive pairs (x = RR[n], y = RR[n+1]) */
+    int64_t sum_d;                  /**< Σ (y - x) */
+    uint64_t sum_dd;                /**< Σ (y - x)² */
+    uint64_t sum_s;                 /**< Σ (y + x) */
+    uint64_t sum_ss;                /**< Σ (y + x)² */
+
+    /* Amortized DFA */
+    int32_t profile[HRV_NL_MAX_BEATS];  /**< Integrated, mean-removed snapshot */
+    uint16_t profile_len;
+    uint8_t dfa_scale;              /**< Box size being evaluated (0 = idle) */
+    uint8_t dfa_points;
+    float dfa_log_n[HRV_NL_DFA_SCALES];
+    float dfa_log_f[HRV_NL_DFA_SCALES];
+    uint16_t beats_since_dfa;
+
+    /* Amortized sample / approximate entropy */
+    uint16_t ent_x[HRV_NL_MAX_BEATS];       /**< RR snapshot (ms) */
+    uint8_t ent_order[HRV_NL_MAX_BEATS];    /**< Templates sorted by bucket */
+    uint8_t ent_key[HRV_NL_MAX_BEATS];      /**< Bucket of each template */
+    uint16_t ent_cnt_m[HRV_NL_MAX_BEATS];   /**< Matches of length m (excl. self) */
+    uint16_t ent_cnt_m1[HRV_NL_MAX_BEATS];  /**< Matches of length m + 1 */
+    uint16_t ent_templates;         /**< N - m + 1 */
+    uint16_t ent_pos;               /**< Progress through the current phase */
+    uint16_t ent_r;                 /**< Tolerance (ms) */
+    uint8_t ent_phase;              /**< 0 idle, 1 counting, 2 summing */
+    uint32_t ent_b;                 /**< SampEn pairs matching for m */
+    uint32_t ent_a;                 /**< SampEn pairs matching for m + 1 */
+    float ent_phi_m;                /**< Σ ln(C_i^m count) */
+    float ent_phi_m1;
+    uint16_t beats_since_ent;
+
+    /* Results */
+    uint32_t sd1_us;                /**< Short-term variability */
+    uint32_t sd2_us;                /**< Long-term variability */
+    uint32_t sdnn_us;               /**< SD of the RR intervals in the window */
+    float dfa_alpha1;               /**< Short-term fractal scaling exponent */
+    bool dfa_valid;
+    float sampen;                   /**< Sample entropy */
+    float apen;                     /**< Approximate entropy */
+    bool entropy_valid;
+} hrv_nonlinear_t;
+
+/*******************************************************************************
+ * PUBLIC API
+ ******************************************************************************/
+
+/**
+ * @brief Clear the window and results
+ */
+void hrv_nonlinear_reset(hrv_nonlinear_t *p_ctx);
+
+/**
+ * @brief Add an accepted RR interval (O(1))
+ *
+ * Slides the window (count and duration limits) and refreshes SD1/SD2
+ * and SDNN.
+ *
+ * @param p_ctx Context
+ * @param rr_ms RR interval, already artifact-checked
+ */
+void hrv_nonlinear_add_rr(hrv_nonlinear_t *p_ctx, float rr_ms);
+
+/**
+ * @brief Same, RR in integer microseconds (the firmware's beat path)
+ */
+void hrv_nonlinear_add_rr_us(hrv_nonlinear_t *p_ctx, uint32_t rr_us);
+
+/**
+ * @brief Advance the amortized DFA or entropy pass by one unit of work
+ *
+ * Call once per processing tick. Starts a new pass once enough new beats
+ * have arrived (DFA first), then evaluates one DFA scale or one chunk of
+ * entropy templates per call.
+ *
+ * @return true when new dfa_alpha1 or sampen/apen values were published
+ *         on this call
+ */
+bool hrv_nonlinear_step(hrv_nonlinear_t *p_ctx);
+
+#endif /* HRV_NONLINEAR_H */
@@ -0,0 +1,108 @@
+/**
+ * @file peak_detector.c
+ * @brief Neural Load Ring - Peak Detector Dispatch and Beat Queue
+ *
+ * Engine selection plus the beat queue shared by all engines. The engines
+ * themselves live in detector_*.c.
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "peak_detector.h"
+#include <string.h>
+
+/*******************************************************************************
+ * ENGINE REGISTRY
+ ******************************************************************************/
+
+static const peak_detector_ops_t *const DETECTOR_ENGINES[PEAK_DETECTOR_COUNT] = {
+    &g_peak_detector_pan_tompkins,
+    &g_peak_detector_ssf,
+    &g_peak_detector_elgendi,
+};
+
+/*******************************************************************************
+ * PUBLIC API
+ ******************************************************************************/
+
+void peak_detector_init(peak_detector_t *det, peak_detector_id_t id)
+{
+    if (det == NULL) return;
+
+    if ((unsigned)id >= PEAK_DETECTOR_COUNT) {
+        id = (peak_detector_id_t)PPG_DETECTOR_DEFAULT;
+    }
+
+    memset(det, 0, sizeof(*det));
+    det->id = id;
+    det->ops = DETECTOR_ENGINES[id];
+    det->ops->init(det);
+}
+
+uint16_t peak_detector_process_block(peak_detector_t *det, const float *samples,
+                                     uint16_t count, uint32_t t0_ms, uint16_t period_ms)
+{
+    if (det == NULL || det->ops == NULL || samples == NULL || count == 0) {
+        return 0;
+    }
+
+    uint32_t emitted_before = det->beats_dropped + det->beat_count;
+    det->ops->process_block(det, samples, count, t0_ms, period_ms);
+    return (uint16_t)((det->beats_dropped + det->beat_count) - emitted_before);
+}
+
+bool peak_detector_pop(peak_detector_t *det, ppg_beat_t *out)
+{
+    if (det == NULL || out == NULL || det->beat_count == 0) {
+        return false;
+    }
+
+    *out = det->beats[det->beat_tail];
+    det->beat_tail = (uint8_t)((det->beat_tail + 1U) % PEAK_DETECTOR_BEAT_QUEUE);
+    det->beat_count--;
+    return true;
+}
+
+void peak_detector_reset(peak_detector_t *det)
+{
+    if (det == NULL || det->ops == NULL) return;
+
+    det->beat_head = 0;
+    det->beat_tail = 0;
+    det->beat_count = 0;
+    det->ops->reset(det);
+}
+
+void peak_detector_relink(peak_detector_t *det)
+{
+    if (det == NULL) return;
+
+    if ((unsigned)det->id >= PEAK_DETECTOR_COUNT) {
+        det->id = (peak_detector_id_t)PPG_DETECTOR_DEFAULT;
+    }
+    det->ops = DETECTOR_ENGINES[det->id];
+}
+
+const char *peak_detector_name(peak_detector_id_t id)
+{
+    if ((unsigned)id >= PEAK_DETECTOR_COUNT) {
+        return "unknown";
+    }
+    return DETECTOR_ENGINES[id]->name;
+}
+
+void peak_detector_emit(peak_detector_t *det, uint32_t peak_ms, float amplitude)
+{
+    /* Drop oldest on overflow */
+    if (det->beat_count == PEAK_DETECTOR_BEAT_QUEUE) {
+        det->beat_tail = (uint8_t)((det->beat_tail + 1U) % PEAK_DETECTOR_BEAT_QUEUE);
+        det->beat_count--;
+        det->beats_dropped++;
+    }
+
+    det->beats[det->beat_head].peak_ms = peak_ms;
+    det->beats[det->beat_head].amplitude = amplitude;
+    det->beat_head = (uint8_t)((det->beat_head + 1U) % PEAK_DETECTOR_BEAT_QUEUE);
+    det->beat_count++;
+}
@@ -0,0 +1,224 @@
+/**
+ * @file peak_detector.h
+ * @brief Neural Load Ring - Pluggable PPG Peak Detector Engines
+ *
+ * Common interface (init / process_block / pop / reset) over several beat
+ * detectors so the cheapest one that is accurate enough for a given user
+ * and activity level can be selected at runtime:
+ *
+ *   - PAN_TOMPKINS: simplified Pan-Tompkins (DC removal -> derivative ->
+ *                   squaring -> moving integration -> adaptive threshold)
+ *   - SSF:          slope sum function (Zong et al., 2003)
+ *   - ELGENDI:      two event-related moving averages (Elgendi et al., 2013)
+ *
+ * All engine state is held inside peak_detector_t (no heap), so several
+ * detectors can run side by side (e.g. one per PPG channel, or in the host
+ * benchmark). Engines emit beat timestamps; RR conversion is left to the
+ * caller.
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef PEAK_DETECTOR_H
+#define PEAK_DETECTOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/**
+ * Engine at boot, until the BLE configuration picks another. SSF: on
+ * bench_detectors its Se/PPV are within ~3 points of Elgendi's on every
+ * scenario (motion is the weakest for both) at 4-21% fewer cycles per
+ * sample. Pan-Tompkins is cheaper still but over-detects on PPG (PPV under
+ * 40%). Override with -DPPG_DETECTOR_DEFAULT=<id>.
+ */
+#ifndef PPG_DETECTOR_DEFAULT
+#define PPG_DETECTOR_DEFAULT            PEAK_DETECTOR_SSF
+#endif
+
+/** Detected beats buffered per detector before they must be popped */
+#define PEAK_DETECTOR_BEAT_QUEUE        8
+
+/** Pan-Tompkins windows (samples @ 100 Hz) */
+#define PT_DC_WINDOW                    5       /**< 50 ms DC removal */
+#define PT_INTEGRATOR_WINDOW            12      /**< 120 ms moving integration */
+
+/** Slope sum function window (samples @ 100 Hz) */
+#define SSF_WINDOW                      13      /**< ~128 ms (Zong et al.) */
+
+/** Elgendi moving average windows (samples @ 100 Hz) */
+#define ELGENDI_W1                      11      /**< 111 ms: systolic peak */
+#define ELGENDI_W2                      67      /**< 667 ms: one beat */
+
+/*******************************************************************************
+ * TYPES
+ ******************************************************************************/
+
+/** Detector engine IDs (also used by the BLE configuration byte) */
+typedef enum {
+    PEAK_DETECTOR_PAN_TOMPKINS = 0, /**< Simplified Pan-Tompkins */
+    PEAK_DETECTOR_SSF = 1,          /**< Slope sum function (default) */
+    PEAK_DETECTOR_ELGENDI = 2,      /**< Two moving averages */
+    PEAK_DETECTOR_COUNT
+} peak_detector_id_t;
+
+/** A detected beat */
+typedef struct {
+    uint32_t peak_ms;               /**< Fiducial point timestamp */
+    float    amplitude;             /**< Engine-specific peak strength */
+} ppg_beat_t;
+
+/** Pan-Tompkins engine state */
+typedef struct {
+    float dc_buffer[PT_DC_WINDOW];
+    float integ_buffer[PT_INTEGRATOR_WINDOW];
+    uint8_t dc_idx;
+    uint8_t integ_idx;
+    float dc_sum;
+    float integ_sum;
+    float prev_dc_removed;
+    float threshold;
+    uint32_t last_peak_ts_ms;
+    bool initialized;
+} pt_detector_state_t;
+
+/** Slope sum function engine state */
+typedef struct {
+    float slope_buffer[SSF_WINDOW];
+    uint8_t slope_idx;
+    float ssf_sum;
+    float smooth[3];                /**< 3-tap smoother history */
+    float prev_smoothed;
+    float peak_avg;                 /**< Running average of SSF maxima */
+    float threshold;
+    float search_max;               /**< Max SSF within current pulse */
+    uint32_t search_max_ms;
+    uint32_t search_start_ms;
+    uint32_t last_beat_ms;
+    uint32_t learn_end_ms;
+    bool searching;
+    bool initialized;
+} ssf_detector_state_t;
+
+/** Elgendi engine state */
+typedef struct {
+    float hp_x[2], hp_y[2];         /**< 0.5 Hz high-pass biquad history */
+    float lp_x[2], lp_y[2];         /**< 8 Hz low-pass biquad history */
+    float peak_buffer[ELGENDI_W1];
+    float beat_buffer[ELGENDI_W2];
+    uint8_t peak_idx;
+    uint8_t beat_idx;
+    float peak_sum;
+    float beat_sum;
+    float mean_energy;              /**< Running mean of squared signal */
+    float block_max;                /**< Max energy inside block of interest */
+    uint32_t block_max_ms;
+    uint16_t block_len;
+    uint16_t warmup;
+    uint32_t last_beat_ms;
+    bool in_block;
+} elgendi_detector_state_t;
+
+typedef struct peak_detector_s peak_detector_t;
+
+/** Engine operations */
+typedef struct {
+    const char *name;
+    void (*init)(peak_detector_t *det);
+    void (*process_block)(peak_detector_t *det, const float *samples,
+                          uint16_t count, uint32_t t0_ms, uint16_t period_ms);
+    void (*reset)(peak_detector_t *det);
+} peak_detector_ops_t;
+
+/** Detector instance (engine state + beat queue) */
+struct peak_detector_s {
+    const peak_detector_ops_t *ops;
+    peak_detector_id_t id;
+    ppg_beat_t beats[PEAK_DETECTOR_BEAT_QUEUE];
+    uint8_t beat_head;
+    uint8_t beat_tail;
+    uint8_t beat_count;
+    uint32_t beats_dropped;
+    union {
+        pt_detector_state_t pt;
+        ssf_detector_state_t ssf;
+        elgendi_detector_state_t elgendi;
+    } engine;
+};
+
+/*******************************************************************************
+ * PUBLIC API
+ ******************************************************************************/
+
+/**
+ * @brief Initialize a detector with the given engine
+ *
+ * Unknown IDs fall back to PPG_DETECTOR_DEFAULT.
+ *
+ * @param det Detector instance
+ * @param id  Engine to use
+ */
+void peak_detector_init(peak_detector_t *det, peak_detector_id_t id);
+
+/**
+ * @brief Feed a block of evenly spaced PPG samples
+ *
+ * @param det       Detector instance
+ * @param samples   Sample block
+ * @param count     Number of samples
+ * @param t0_ms     Timestamp of samples[0]
+ * @param period_ms Sample spacing (10 ms at 100 Hz)
+ * @return Number of beats added to the queue by this block
+ */
+uint16_t peak_detector_process_block(peak_detector_t *det, const float *samples,
+                                     uint16_t count, uint32_t t0_ms, uint16_t period_ms);
+
+/**
+ * @brief Pop the oldest detected beat
+ * @param det Detector instance
+ * @param out Beat output
+ * @return true if a beat was returned
+ */
+bool peak_detector_pop(peak_detector_t *det, ppg_beat_t *out);
+
+/**
+ * @brief Reset engine state and clear the beat queue (engine is kept)
+ */
+void peak_detector_reset(peak_detector_t *det);
+
+/**
+ * @brief Re-resolve the engine table from det->id (after a raw state copy)
+ */
+void peak_detector_relink(peak_detector_t *det);
+
+/**
+ * @brief Human-readable engine name (for logs and benchmarks)
+ */
+const char *peak_detector_name(peak_detector_id_t id);
+
+/**
+ * @brief Queue a detected beat (used by engines)
+ *
+ * Drops the oldest beat when the queue is full.
+ */
+void peak_detector_emit(peak_detector_t *det, uint32_t peak_ms, float amplitude);
+
+/** Engine operation tables */
+extern const peak_detector_ops_t g_peak_detector_pan_tompkins;
+extern const peak_detector_ops_t g_peak_detector_ssf;
+extern const peak_detector_ops_t g_peak_detector_elgendi;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PEAK_DETECTOR_H */
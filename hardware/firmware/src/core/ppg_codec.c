@@ -0,0 +1,257 @@
+/**
+ * @file ppg_codec.c
+ * @brief Lossless Block Codec for Raw PPG Capture Implementation
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "ppg_codec.h"
+#include <stddef.h>
+
+#define PC_SAMPLE_MIN   (-(int32_t)(1U << (PPG_CODEC_SAMPLE_BITS - 1U)))
+#define PC_SAMPLE_MAX   ((int32_t)(1U << (PPG_CODEC_SAMPLE_BITS - 1U)) - 1)
+#define PC_SAMPLE_MASK  ((1U << PPG_CODEC_SAMPLE_BITS) - 1U)
+#define PC_MAX_RICE_K   30U
+
+/*******************************************************************************
+ * PREDICTION
+ ******************************************************************************/
+
+/** Fixed polynomial prediction of sample i from the ones before it (stride apart) */
+static int64_t pc_predict(const int32_t *p_x, uint32_t i, uint8_t stride, uint8_t order)
+{
+    if (order > i) order = (uint8_t)i;
+
+    switch (order) {
+        case 1:
+            return p_x[(i - 1U) * stride];
+        case 2:
+            return 2 * (int64_t)p_x[(i - 1U) * stride] - p_x[(i - 2U) * stride];
+        case 3:
+            return 3 * (int64_t)p_x[(i - 1U) * stride] - 3 * (int64_t)p_x[(i - 2U) * stride] +
+                   p_x[(i - 3U) * stride];
+        default:
+            return 0;
+    }
+}
+
+static uint32_t pc_zigzag(int64_t residual)
+{
+    int32_t r = (int32_t)residual;
+    return ((uint32_t)r << 1) ^ (uint32_t)(r >> 31);
+}
+
+static uint32_t pc_rice_bits(uint32_t zz, uint8_t k)
+{
+    uint32_t q = zz >> k;
+    return (q < PPG_CODEC_ESCAPE) ? q + 1U + k : PPG_CODEC_ESCAPE + 32U;
+}
+
+/*******************************************************************************
+ * ENCODER
+ ******************************************************************************/
+
+typedef struct {
+    uint8_t *p_out;
+    uint32_t pos;
+    uint64_t acc;
+    uint8_t n;
+} pc_writer_t;
+
+static void pc_put(pc_writer_t *p_w, uint32_t value, uint8_t n)
+{
+    p_w->acc = (p_w->acc << n) | value;
+    p_w->n = (uint8_t)(p_w->n + n);
+    while (p_w->n >= 8U) {
+        p_w->n = (uint8_t)(p_w->n - 8U);
+        p_w->p_out[p_w->pos++] = (uint8_t)(p_w->acc >> p_w->n);
+    }
+}
+
+/** Cheapest coding of one channel; returns its size in bits */
+static uint32_t pc_choose(const int32_t *p_x, uint16_t n, uint8_t stride, uint8_t *p_order, uint8_t *p_k)
+{
+    uint32_t best_bits = PPG_CODEC_SAMPLE_BITS * (uint32_t)n;
+
+    *p_order = 0;
+    *p_k = PPG_CODEC_VERBATIM_K;
+
+    for (uint8_t order = 0; order <= PPG_CODEC_MAX_ORDER; order++) {
+        uint32_t cost[PC_MAX_RICE_K + 1U];
+        uint64_t sum = 0;
+        uint8_t k_max = 0;
+
+        for (uint32_t i = 1; i < n; i++) {
+            sum += pc_zigzag((int64_t)p_x[i * stride] - pc_predict(p_x, i, stride, order));
+        }
+
+        /* Every k up to just past log2 of the mean: escapes make the cost
+         * non-convex in k, and outliers inflate the mean */
+        while (k_max < PC_MAX_RICE_K && ((uint64_t)n << k_max) <= sum) k_max++;
+        for (uint8_t k = 0; k <= k_max; k++) cost[k] = PPG_CODEC_SAMPLE_BITS;
+
+        for (uint32_t i = 1; i < n; i++) {
+            uint32_t zz = pc_zigzag((int64_t)p_x[i * stride] - pc_predict(p_x, i, stride, order));
+            for (uint8_t k = 0; k <= k_max; k++) cost[k] += pc_rice_bits(zz, k);
+        }
+
+        for (uint8_t k = 0; k <= k_max; k++) {
+            if (cost[k] < best_bits) {
+                best_bits = cost[k];
+                *p_order = order;
+                *p_k = k;
+            }
+        }
+    }
+
+    return 7U + best_bits;
+}
+
+int ppg_codec_encode(const int32_t *p_frames, uint16_t n_frames, uint8_t channels,
+                     uint8_t *p_out, uint16_t cap)
+{
+    uint8_t order[8], k[8];
+    uint32_t bits = 0;
+
+    if (p_frames == NULL || p_out == NULL || n_frames == 0U || channels == 0U ||
+        channels > sizeof(order)) {
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < (uint32_t)n_frames * channels; i++) {
+        if (p_frames[i] < PC_SAMPLE_MIN || p_frames[i] > PC_SAMPLE_MAX) return -1;
+    }
+
+    for (uint8_t c = 0; c < channels; c++) {
+        bits += pc_choose(&p_frames[c], n_frames, channels, &order[c], &k[c]);
+    }
+    if ((bits + 7U) / 8U > cap) return -1;
+
+    pc_writer_t w = { .p_out = p_out };
+    for (uint8_t c = 0; c < channels; c++) {
+        const int32_t *p_x = &p_frames[c];
+
+        pc_put(&w, order[c], 2);
+        pc_put(&w, k[c], 5);
+        pc_put(&w, (uint32_t)p_x[0] & PC_SAMPLE_MASK, PPG_CODEC_SAMPLE_BITS);
+
+        for (uint32_t i = 1; i < n_frames; i++) {
+            if (k[c] == PPG_CODEC_VERBATIM_K) {
+                pc_put(&w, (uint32_t)p_x[i * channels] & PC_SAMPLE_MASK, PPG_CODEC_SAMPLE_BITS);
+                continue;
+            }
+
+            uint32_t zz = pc_zigzag((int64_t)p_x[i * channels] - pc_predict(p_x, i, channels, order[c]));
+            uint32_t q = zz >> k[c];
+            if (q < PPG_CODEC_ESCAPE) {
+                pc_put(&w, 1, (uint8_t)(q + 1U));
+                if (k[c] > 0U) pc_put(&w, zz & ((1U << k[c]) - 1U), k[c]);
+            } else {
+                pc_put(&w, 0, PPG_CODEC_ESCAPE);
+                pc_put(&w, zz, 32);
+            }
+        }
+    }
+    if (w.n > 0U) {
+        p_out[w.pos++] = (uint8_t)(w.acc << (8U - w.n));
+    }
+
+    return (int)w.pos;
+}
+
+/*******************************************************************************
+ * DECODER
+ ******************************************************************************/
+
+typedef struct {
+    const uint8_t *p_in;
+    uint32_t len;
+    uint32_t pos;
+    uint64_t acc;               /**< MSB-aligned */
+    uint8_t n;                  /**< Valid bits in acc */
+} pc_reader_t;
+
+static void pc_fill(pc_reader_t *p_r)
+{
+    while (p_r->n <= 56U && p_r->pos < p_r->len) {
+        p_r->acc |= (uint64_t)p_r->p_in[p_r->pos++] << (56U - p_r->n);
+        p_r->n = (uint8_t)(p_r->n + 8U);
+    }
+}
+
+static bool pc_get(pc_reader_t *p_r, uint8_t bits, uint32_t *p_value)
+{
+    if (bits == 0U) {
+        *p_value = 0;
+        return true;
+    }
+    pc_fill(p_r);
+    if (p_r->n < bits) return false;
+
+    *p_value = (uint32_t)(p_r->acc >> (64U - bits));
+    p_r->acc <<= bits;
+    p_r->n = (uint8_t)(p_r->n - bits);
+    return true;
+}
+
+static bool pc_get_rice(pc_reader_t *p_r, uint8_t k, uint32_t *p_zz)
+{
+    uint32_t low;
+
+    pc_fill(p_r);
+    uint32_t zeros = (p_r->acc != 0U) ? (uint32_t)__builtin_clzll(p_r->acc) : 64U;
+
+    if (zeros >= PPG_CODEC_ESCAPE) {
+        if (p_r->n < PPG_CODEC_ESCAPE) return false;
+        p_r->acc <<= PPG_CODEC_ESCAPE;
+        p_r->n = (uint8_t)(p_r->n - PPG_CODEC_ESCAPE);
+        return pc_get(p_r, 32, p_zz);
+    }
+    if (zeros >= p_r->n) return false;
+
+    p_r->acc <<= zeros + 1U;
+    p_r->n = (uint8_t)(p_r->n - zeros - 1U);
+    if (!pc_get(p_r, k, &low)) return false;
+    *p_zz = (zeros << k) | low;
+    return true;
+}
+
+static int32_t pc_sign_extend(uint32_t raw)
+{
+    return (int32_t)(raw ^ (1U << (PPG_CODEC_SAMPLE_BITS - 1U))) - (int32_t)(1U << (PPG_CODEC_SAMPLE_BITS - 1U));
+}
+
+int ppg_codec_decode(const uint8_t *p_in, uint16_t len, uint16_t n_frames, uint8_t channels,
+                     int32_t *p_frames)
+{
+    pc_reader_t r = { .p_in = p_in, .len = len };
+
+    if (p_in == NULL || p_frames == NULL || n_frames == 0U || channels == 0U) return -1;
+
+    for (uint8_t c = 0; c < channels; c++) {
+        int32_t *p_x = &p_frames[c];
+        uint32_t order, k, raw;
+
+        if (!pc_get(&r, 2, &order) || !pc_get(&r, 5, &k) ||
+            !pc_get(&r, PPG_CODEC_SAMPLE_BITS, &raw)) {
+            return -1;
+        }
+        p_x[0] = pc_sign_extend(raw);
+
+        for (uint32_t i = 1; i < n_frames; i++) {
+            if (k == PPG_CODEC_VERBATIM_K) {
+                if (!pc_get(&r, PPG_CODEC_SAMPLE_BITS, &raw)) return -1;
+                p_x[i * channels] = pc_sign_extend(raw);
+                continue;
+            }
+
+            uint32_t zz;
+            if (!pc_get_rice(&r, (uint8_t)k, &zz)) return -1;
+            uint32_t residual = (zz >> 1) ^ (0U - (zz & 1U));
+            p_x[i * channels] = (int32_t)((uint32_t)pc_predict(p_x, i, channels, (uint8_t)order) + residual);
+        }
+    }
+
+    return (int)(r.pos - r.n / 8U);
+}
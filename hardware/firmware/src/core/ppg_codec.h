@@ -0,0 +1,91 @@
+/**
+ * @file ppg_codec.h
+ * @brief Lossless Block Codec for Raw PPG Capture (fixed LPC + Rice)
+ *
+ * Codes a block of interleaved frames (ADC counts) one channel after the
+ * other, MSB first, padded to a byte at the end of the block:
+ *
+ *   per channel    2 bits predictor order (0..3), 5 bits Rice k
+ *   k < 31         first sample: 20-bit two's complement
+ *                  then one residual per sample against the fixed
+ *                  polynomial predictor (order limited to the samples so far)
+ *                    order 0   0
+ *                    order 1   x[n-1]
+ *                    order 2   2x[n-1] - x[n-2]
+ *                    order 3   3x[n-1] - 3x[n-2] + x[n-3]
+ *                  residual zigzag-mapped, Rice-coded: (zz >> k) zeros, a
+ *                  one, k low bits; PPG_CODEC_ESCAPE zeros instead mean a
+ *                  32-bit zz follows
+ *   k == 31        verbatim: every sample 20-bit two's complement
+ *
+ * The encoder tries every order and the Rice parameters around the mean
+ * residual, keeps the cheapest, and falls back to verbatim, so a block
+ * never exceeds PPG_CODEC_MAX_BYTES. PPG waveforms are smooth at 100 Hz:
+ * residuals sit near the AFE noise, a few bits a sample instead of 16-24.
+ *
+ * No state crosses blocks, so a lost block costs only itself. The decoder
+ * reads 64 bits at a time and counts the unary run with one clz; it is
+ * meant for the host (nlr_ppgdec), though it builds for the ring too.
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef PPG_CODEC_H
+#define PPG_CODEC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
+
+#define PPG_CODEC_SAMPLE_BITS   20U     /**< Sample range: -2^19 .. 2^19-1 (MAX86141 counts are 19 bits) */
+#define PPG_CODEC_MAX_ORDER     3U
+#define PPG_CODEC_VERBATIM_K    31U
+#define PPG_CODEC_ESCAPE        24U     /**< Unary run length that escapes to 32 raw bits */
+
+/** Worst-case block size in bytes (every channel verbatim) */
+#define PPG_CODEC_MAX_BYTES(n_frames, channels) \
+    ((((7U + PPG_CODEC_SAMPLE_BITS * (uint32_t)(n_frames)) * (uint32_t)(channels)) + 7U) / 8U)
+
+/*******************************************************************************
+ * PUBLIC API
+ ******************************************************************************/
+
+/**
+ * @brief Encode one block
+ *
+ * @param p_frames   n_frames * channels samples, frame-interleaved
+ * @param n_frames   Frames in the block (at least 1)
+ * @param channels   Samples per frame
+ * @param p_out      Output buffer
+ * @param cap        Output size in bytes
+ * @return Bytes written, -1 if a sample is out of range or the block does not fit
+ */
+int ppg_codec_encode(const int32_t *p_frames, uint16_t n_frames, uint8_t channels,
+                     uint8_t *p_out, uint16_t cap);
+
+/**
+ * @brief Decode one block
+ *
+ * @param p_in       Coded block
+ * @param len        Bytes available
+ * @param n_frames   Frames in the block
+ * @param channels   Samples per frame
+ * @param p_frames   n_frames * channels samples out, frame-interleaved
+ * @return Bytes consumed, -1 on a truncated or malformed block
+ */
+int ppg_codec_decode(const uint8_t *p_in, uint16_t len, uint16_t n_frames, uint8_t channels,
+                     int32_t *p_frames);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PPG_CODEC_H */
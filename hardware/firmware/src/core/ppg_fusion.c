@@ -0,0 +1,297 @@
+/**
+ * @file ppg_fusion.c
+ * @brief Neural Load Ring - Multi-Channel PPG Beat Fusion
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "ppg_fusion.h"
+#include <string.h>
+
+/*******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
+
+#define FUSION_CHUNK                32      /**< Frames de-interleaved at a time */
+#define FUSION_SQI_INITIAL          0.5f
+#define FUSION_SQI_ALPHA            0.10f
+#define FUSION_RR_MIN_MS            300U
+#define FUSION_RR_MAX_MS            2000U
+#define FUSION_RR_TOLERANCE         0.20f   /**< Plausible beat-to-beat change */
+#define FUSION_RELEARN_SQI          0.30f   /**< Re-learn channel RR below this */
+#define FUSION_SILENCE_MS           2500U   /**< No beat for this long = poor */
+#define FUSION_SWITCH_MARGIN        0.15f   /**< SQI lead needed to switch */
+#define FUSION_ALIGN_WINDOW_MS      150     /**< Same beat on two channels */
+#define FUSION_LAG_ALPHA            0.10f
+#define FUSION_MIN_OUT_RR_MS        250     /**< Duplicate guard at switches */
+#define FUSION_LED_OFF_SQI          0.85f   /**< Primary "clearly sufficient" */
+#define FUSION_LED_OFF_HOLD_MS      60000U  /**< ...for this long */
+#define FUSION_LED_ON_SQI           0.60f   /**< Primary degraded: LEDs back on */
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+static void fusion_channel_restart(ppg_fusion_channel_t *p_ch, uint32_t now_ms)
+{
+    peak_detector_reset(&p_ch->det);
+    p_ch->sqi = FUSION_SQI_INITIAL;
+    p_ch->rr_avg_ms = 0.0f;
+    p_ch->has_last_beat = false;
+    p_ch->last_activity_ms = now_ms;
+}
+
+static void fusion_emit(ppg_fusion_t *p_fusion, uint32_t peak_ms, float amplitude)
+{
+    /* A channel switch can re-deliver a beat already emitted */
+    if (p_fusion->has_last_out &&
+        (int32_t)(peak_ms - p_fusion->last_out_ms) < FUSION_MIN_OUT_RR_MS) {
+        return;
+    }
+    p_fusion->last_out_ms = peak_ms;
+    p_fusion->has_last_out = true;
+
+    if (p_fusion->beat_count == PPG_FUSION_BEAT_QUEUE) {
+        p_fusion->beat_tail = (uint8_t)((p_fusion->beat_tail + 1U) % PPG_FUSION_BEAT_QUEUE);
+        p_fusion->beat_count--;
+    }
+    p_fusion->beats[p_fusion->beat_head].peak_ms = peak_ms;
+    p_fusion->beats[p_fusion->beat_head].amplitude = amplitude;
+    p_fusion->beat_head = (uint8_t)((p_fusion->beat_head + 1U) % PPG_FUSION_BEAT_QUEUE);
+    p_fusion->beat_count++;
+}
+
+static void fusion_update_lag(ppg_fusion_channel_t *p_ch, int32_t lag_ms)
+{
+    p_ch->lag_ms += FUSION_LAG_ALPHA * ((float)lag_ms - p_ch->lag_ms);
+}
+
+static void fusion_on_beat(ppg_fusion_t *p_fusion, uint8_t c, const ppg_beat_t *p_beat)
+{
+    ppg_fusion_channel_t *p_ch = &p_fusion->ch[c];
+    uint32_t t = p_beat->peak_ms;
+
+    /* 1) SQI: is this RR plausible for this channel? */
+    if (p_ch->has_last_beat) {
+        uint32_t rr = t - p_ch->last_beat_ms;
+        bool in_range = (rr >= FUSION_RR_MIN_MS) && (rr <= FUSION_RR_MAX_MS);
+        bool plausible = in_range &&
+                         ((p_ch->rr_avg_ms <= 0.0f) ||
+                          ((float)rr >= p_ch->rr_avg_ms * (1.0f - FUSION_RR_TOLERANCE) &&
+                           (float)rr <= p_ch->rr_avg_ms * (1.0f + FUSION_RR_TOLERANCE)));
+
+        if (plausible) {
+            p_ch->rr_avg_ms = (p_ch->rr_avg_ms <= 0.0f) ?
+                              (float)rr : p_ch->rr_avg_ms + 0.1f * ((float)rr - p_ch->rr_avg_ms);
+        } else if (in_range && p_ch->sqi < FUSION_RELEARN_SQI) {
+            p_ch->rr_avg_ms = (float)rr;    /* Stuck on a wrong rhythm */
+        }
+        p_ch->sqi += FUSION_SQI_ALPHA * ((plausible ? 1.0f : 0.0f) - p_ch->sqi);
+    }
+
+    /* 2) Alignment: learn each channel's fiducial lag vs the reference */
+    if (c != PPG_CHANNEL_GREEN) {
+        ppg_fusion_channel_t *p_ref = &p_fusion->ch[PPG_CHANNEL_GREEN];
+        int32_t d = (int32_t)(t - p_ref->last_beat_ms);
+        if (p_ref->led_on && p_ref->has_last_beat &&
+            d > -FUSION_ALIGN_WINDOW_MS && d < FUSION_ALIGN_WINDOW_MS) {
+            fusion_update_lag(p_ch, d);
+        }
+    } else {
+        for (uint8_t o = 1; o < p_fusion->n_channels; o++) {
+            ppg_fusion_channel_t *p_other = &p_fusion->ch[o];
+            int32_t d = (int32_t)(p_other->last_beat_ms - t);
+            if (p_other->led_on && p_other->has_last_beat &&
+                d > -FUSION_ALIGN_WINDOW_MS && d < FUSION_ALIGN_WINDOW_MS) {
+                fusion_update_lag(p_other, d);
+            }
+        }
+    }
+
+    p_ch->last_beat_ms = t;
+    p_ch->has_last_beat = true;
+    p_ch->last_activity_ms = t;
+
+    /* 3) Output: primary channel only, on the reference timeline */
+    if (c == p_fusion->primary) {
+        int32_t lag = (int32_t)(p_ch->lag_ms + ((p_ch->lag_ms >= 0.0f) ? 0.5f : -0.5f));
+        fusion_emit(p_fusion, (uint32_t)((int32_t)t - lag), p_beat->amplitude);
+    }
+}
+
+static void fusion_select_primary(ppg_fusion_t *p_fusion)
+{
+    uint8_t best = p_fusion->primary;
+
+    for (uint8_t c = 0; c < p_fusion->n_channels; c++) {
+        if (p_fusion->ch[c].led_on && p_fusion->ch[c].sqi > p_fusion->ch[best].sqi) {
+            best = c;
+        }
+    }
+
+    if (best != p_fusion->primary &&
+        (!p_fusion->ch[p_fusion->primary].led_on ||
+         p_fusion->ch[best].sqi > p_fusion->ch[p_fusion->primary].sqi + FUSION_SWITCH_MARGIN)) {
+        p_fusion->primary = best;
+        p_fusion->primary_good = false;
+        p_fusion->switches++;
+    }
+}
+
+static void fusion_manage_leds(ppg_fusion_t *p_fusion, uint32_t now_ms)
+{
+    if (p_fusion->n_channels < 2U || p_fusion->led_fn == NULL) return;
+
+    const ppg_fusion_channel_t *p_primary = &p_fusion->ch[p_fusion->primary];
+
+    if (p_primary->sqi < FUSION_LED_ON_SQI) {
+        /* Primary degraded: bring every channel back */
+        p_fusion->primary_good = false;
+        for (uint8_t c = 0; c < p_fusion->n_channels; c++) {
+            if (!p_fusion->ch[c].led_on) {
+                p_fusion->ch[c].led_on = true;
+                fusion_channel_restart(&p_fusion->ch[c], now_ms);
+                p_fusion->led_fn(c, true);
+            }
+        }
+        return;
+    }
+
+    if (p_primary->sqi >= FUSION_LED_OFF_SQI) {
+        if (!p_fusion->primary_good) {
+            p_fusion->primary_good = true;
+            p_fusion->primary_good_since_ms = now_ms;
+        } else if (now_ms - p_fusion->primary_good_since_ms >= FUSION_LED_OFF_HOLD_MS) {
+            for (uint8_t c = 0; c < p_fusion->n_channels; c++) {
+                if (c != p_fusion->primary && p_fusion->ch[c].led_on) {
+                    p_fusion->ch[c].led_on = false;
+                    p_fusion->led_fn(c, false);
+                }
+            }
+        }
+    } else {
+        p_fusion->primary_good = false;
+    }
+}
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+void ppg_fusion_init(ppg_fusion_t *p_fusion, uint8_t n_channels, peak_detector_id_t id)
+{
+    if (!p_fusion) return;
+
+    memset(p_fusion, 0, sizeof(ppg_fusion_t));
+    if (n_channels == 0U) n_channels = 1U;
+    if (n_channels > PPG_FUSION_MAX_CHANNELS) n_channels = PPG_FUSION_MAX_CHANNELS;
+    p_fusion->n_channels = n_channels;
+
+    for (uint8_t c = 0; c < n_channels; c++) {
+        peak_detector_init(&p_fusion->ch[c].det, id);
+        p_fusion->ch[c].sqi = FUSION_SQI_INITIAL;
+        p_fusion->ch[c].led_on = true;
+    }
+}
+
+void ppg_fusion_set_detector(ppg_fusion_t *p_fusion, peak_detector_id_t id)
+{
+    if (!p_fusion) return;
+
+    for (uint8_t c = 0; c < p_fusion->n_channels; c++) {
+        peak_detector_init(&p_fusion->ch[c].det, id);
+        p_fusion->ch[c].has_last_beat = false;
+    }
+    p_fusion->has_last_out = false;
+}
+
+void ppg_fusion_set_led_callback(ppg_fusion_t *p_fusion, ppg_fusion_led_fn_t fn)
+{
+    if (p_fusion) {
+        p_fusion->led_fn = fn;
+    }
+}
+
+void ppg_fusion_process(ppg_fusion_t *p_fusion, const float *p_frames,
+                        uint16_t n_frames, uint32_t t0_ms, uint16_t period_ms)
+{
+    float chunk[FUSION_CHUNK];
+
+    if (!p_fusion || !p_frames || n_frames == 0U) return;
+
+    for (uint16_t start = 0; start < n_frames; start = (uint16_t)(start + FUSION_CHUNK)) {
+        uint16_t n = (uint16_t)(n_frames - start);
+        if (n > FUSION_CHUNK) n = FUSION_CHUNK;
+        uint32_t t_chunk = t0_ms + (uint32_t)start * period_ms;
+        uint32_t t_end = t_chunk + (uint32_t)(n - 1U) * period_ms;
+
+        for (uint8_t c = 0; c < p_fusion->n_channels; c++) {
+            ppg_fusion_channel_t *p_ch = &p_fusion->ch[c];
+            ppg_beat_t beat;
+
+            if (!p_ch->led_on) continue;    /* Paused with its LED */
+
+            for (uint16_t i = 0; i < n; i++) {
+                chunk[i] = p_frames[(uint32_t)(start + i) * p_fusion->n_channels + c];
+            }
+            peak_detector_process_block(&p_ch->det, chunk, n, t_chunk, period_ms);
+
+            while (peak_detector_pop(&p_ch->det, &beat)) {
+                fusion_on_beat(p_fusion, c, &beat);
+            }
+
+            /* Silent channel: quality decays */
+            if (p_ch->last_activity_ms == 0U) {
+                p_ch->last_activity_ms = t_chunk;
+            } else if (t_end - p_ch->last_activity_ms > FUSION_SILENCE_MS) {
+                p_ch->sqi *= (1.0f - FUSION_SQI_ALPHA);
+            }
+        }
+
+        if (p_fusion->n_channels > 1U) {
+            fusion_select_primary(p_fusion);
+            fusion_manage_leds(p_fusion, t_end);
+        }
+    }
+}
+
+bool ppg_fusion_pop(ppg_fusion_t *p_fusion, ppg_beat_t *p_beat)
+{
+    if (!p_fusion || !p_beat || p_fusion->beat_count == 0U) return false;
+
+    *p_beat = p_fusion->beats[p_fusion->beat_tail];
+    p_fusion->beat_tail = (uint8_t)((p_fusion->beat_tail + 1U) % PPG_FUSION_BEAT_QUEUE);
+    p_fusion->beat_count--;
+    return true;
+}
+
+void ppg_fusion_reset(ppg_fusion_t *p_fusion)
+{
+    if (!p_fusion) return;
+
+    for (uint8_t c = 0; c < p_fusion->n_channels; c++) {
+        ppg_fusion_channel_t *p_ch = &p_fusion->ch[c];
+        fusion_channel_restart(p_ch, 0U);
+        p_ch->lag_ms = 0.0f;
+        if (!p_ch->led_on) {
+            p_ch->led_on = true;
+            if (p_fusion->led_fn) p_fusion->led_fn(c, true);
+        }
+    }
+    p_fusion->primary = PPG_CHANNEL_GREEN;
+    p_fusion->primary_good = false;
+    p_fusion->beat_head = p_fusion->beat_tail = p_fusion->beat_count = 0U;
+    p_fusion->has_last_out = false;
+}
+
+void ppg_fusion_relink(ppg_fusion_t *p_fusion, ppg_fusion_led_fn_t fn)
+{
+    if (!p_fusion) return;
+
+    p_fusion->led_fn = fn;
+    for (uint8_t c = 0; c < p_fusion->n_channels; c++) {
+        peak_detector_relink(&p_fusion->ch[c].det);
+        if (fn) fn(c, p_fusion->ch[c].led_on);
+    }
+}
@@ -0,0 +1,142 @@
+/**
+ * @file ppg_fusion.h
+ * @brief Neural Load Ring - Multi-Channel PPG Beat Fusion
+ *
+ * The MAX86141 delivers interleaved frames with one sample per LED/channel
+ * (e.g. green + IR). Each channel gets its own peak detector; a per-channel
+ * signal quality index (SQI) decides which channel's beats form the output
+ * beat stream at any moment:
+ *
+ *   - SQI: exponential average of beat-to-beat plausibility (RR within 20 %
+ *     of the channel's running RR), decaying when a channel goes silent.
+ *   - Selection: the best channel becomes primary, with hysteresis so noise
+ *     does not cause flapping.
+ *   - Alignment: the fiducial lag between channels is learned from beats
+ *     both channels detect; beats from a non-reference channel are shifted
+ *     by that lag so RR stays unbiased across a channel switch.
+ *   - Power: when the primary has been clearly sufficient for a while, the
+ *     weaker channel's LED is switched off through a callback and its
+ *     detector is paused; it is switched back on when the primary degrades.
+ *
+ * With one channel the stage is a pass-through for the single detector.
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef PPG_FUSION_H
+#define PPG_FUSION_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "peak_detector.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+#define PPG_FUSION_MAX_CHANNELS         2
+#define PPG_FUSION_BEAT_QUEUE           8
+
+/** Channel indices in an interleaved frame */
+typedef enum {
+    PPG_CHANNEL_GREEN = 0,          /**< Reference channel (lag 0) */
+    PPG_CHANNEL_IR = 1,
+} ppg_channel_t;
+
+/*******************************************************************************
+ * TYPES
+ ******************************************************************************/
+
+/** LED control hook: enable/disable the LED feeding a channel */
+typedef void (*ppg_fusion_led_fn_t)(uint8_t channel, bool enabled);
+
+/** Per-channel state */
+typedef struct {
+    peak_detector_t det;
+    float sqi;                      /**< 0..1 signal quality */
+    float rr_avg_ms;                /**< Running RR on this channel */
+    uint32_t last_beat_ms;
+    bool has_last_beat;
+    uint32_t last_activity_ms;      /**< Last beat or LED (re)start */
+    float lag_ms;                   /**< Fiducial lag vs reference channel */
+    bool led_on;
+} ppg_fusion_channel_t;
+
+/** Fusion stage instance */
+typedef struct {
+    ppg_fusion_channel_t ch[PPG_FUSION_MAX_CHANNELS];
+    uint8_t n_channels;
+    uint8_t primary;
+    uint32_t primary_good_since_ms; /**< Start of current "clearly good" run */
+    bool primary_good;
+    ppg_fusion_led_fn_t led_fn;
+
+    /* Fused output */
+    ppg_beat_t beats[PPG_FUSION_BEAT_QUEUE];
+    uint8_t beat_head;
+    uint8_t beat_tail;
+    uint8_t beat_count;
+    uint32_t last_out_ms;
+    bool has_last_out;
+    uint16_t switches;              /**< Primary channel changes (diagnostics) */
+} ppg_fusion_t;
+
+/*******************************************************************************
+ * PUBLIC API
+ ******************************************************************************/
+
+/**
+ * @brief Initialize fusion for n_channels with the given detector engine
+ */
+void ppg_fusion_init(ppg_fusion_t *p_fusion, uint8_t n_channels, peak_detector_id_t id);
+
+/**
+ * @brief Switch every channel to another detector engine (state restarts)
+ */
+void ppg_fusion_set_detector(ppg_fusion_t *p_fusion, peak_detector_id_t id);
+
+/**
+ * @brief Register the LED control hook (NULL disables LED power saving)
+ */
+void ppg_fusion_set_led_callback(ppg_fusion_t *p_fusion, ppg_fusion_led_fn_t fn);
+
+/**
+ * @brief Process interleaved frames
+ *
+ * @param p_fusion  Fusion instance
+ * @param p_frames  Samples, frame-major: [ch0, ch1, ch0, ch1, ...]
+ * @param n_frames  Number of frames
+ * @param t0_ms     Timestamp of the first frame
+ * @param period_ms Frame period
+ */
+void ppg_fusion_process(ppg_fusion_t *p_fusion, const float *p_frames,
+                        uint16_t n_frames, uint32_t t0_ms, uint16_t period_ms);
+
+/**
+ * @brief Pop the next fused beat (timestamps on the reference channel's timeline)
+ */
+bool ppg_fusion_pop(ppg_fusion_t *p_fusion, ppg_beat_t *p_beat);
+
+/**
+ * @brief Restart detectors, SQI and output queue (keeps channel count/engine)
+ */
+void ppg_fusion_reset(ppg_fusion_t *p_fusion);
+
+/**
+ * @brief Repair a fusion stage copied in from a checkpoint
+ *
+ * Re-resolves every channel's engine from its ID, installs fn and drives
+ * each LED to its saved on/off state.
+ */
+void ppg_fusion_relink(ppg_fusion_t *p_fusion, ppg_fusion_led_fn_t fn);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PPG_FUSION_H */
@@ -0,0 +1,82 @@
+/**
+ * @file rr_quantile.c
+ * @brief Streaming Sliding-Window Median / Quantile Filter for RR Intervals
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "rr_quantile.h"
+#include <string.h>
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+static void rr_q_tree_add(rr_quantile_t *p_q, uint16_t value, int8_t delta)
+{
+    for (uint16_t i = (uint16_t)(value + 1U); i <= RR_QUANTILE_DOMAIN; i = (uint16_t)(i + (i & (uint16_t)-i))) {
+        p_q->tree[i] = (uint8_t)(p_q->tree[i] + delta);
+    }
+}
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+void rr_quantile_init(rr_quantile_t *p_q, uint8_t window)
+{
+    if (!p_q) return;
+
+    memset(p_q, 0, sizeof(rr_quantile_t));
+    if (window == 0U) window = 1U;
+    if (window > RR_QUANTILE_CAPACITY) window = RR_QUANTILE_CAPACITY;
+    p_q->window = window;
+}
+
+void rr_quantile_push(rr_quantile_t *p_q, uint16_t value)
+{
+    if (!p_q || p_q->window == 0U) return;
+
+    if (value >= RR_QUANTILE_DOMAIN) value = RR_QUANTILE_DOMAIN - 1U;
+
+    if (p_q->count == p_q->window) {
+        uint8_t oldest = (uint8_t)((p_q->head + RR_QUANTILE_CAPACITY - p_q->count) % RR_QUANTILE_CAPACITY);
+        rr_q_tree_add(p_q, p_q->ring[oldest], -1);
+        p_q->count--;
+    }
+
+    p_q->ring[p_q->head] = value;
+    p_q->head = (uint8_t)((p_q->head + 1U) % RR_QUANTILE_CAPACITY);
+    p_q->count++;
+    rr_q_tree_add(p_q, value, +1);
+}
+
+uint16_t rr_quantile_select(const rr_quantile_t *p_q, uint8_t rank)
+{
+    if (!p_q || rank >= p_q->count) return 0;
+
+    /* Binary lifting: find the largest prefix with at most 'rank' values */
+    uint16_t pos = 0;
+    uint8_t remaining = rank;
+
+    for (uint16_t step = RR_QUANTILE_DOMAIN; step > 0U; step >>= 1) {
+        uint16_t next = (uint16_t)(pos + step);
+        if (next <= RR_QUANTILE_DOMAIN && p_q->tree[next] <= remaining) {
+            pos = next;
+            remaining = (uint8_t)(remaining - p_q->tree[next]);
+        }
+    }
+
+    /* 1-based tree position pos+1 holds value pos */
+    return pos;
+}
+
+uint16_t rr_quantile_get(const rr_quantile_t *p_q, uint8_t pct)
+{
+    if (!p_q || p_q->count == 0U) return 0;
+    if (pct > 100U) pct = 100U;
+
+    uint8_t rank = (uint8_t)(((uint16_t)pct * (uint16_t)(p_q->count - 1U) + 50U) / 100U);
+    return rr_quantile_select(p_q, rank);
+}
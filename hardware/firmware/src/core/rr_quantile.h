@@ -0,0 +1,90 @@
+/**
+ * @file rr_quantile.h
+ * @brief Streaming Sliding-Window Median / Quantile Filter for RR Intervals
+ *
+ * Keeps the last N RR values (uint16 ms) in a ring buffer plus a Fenwick
+ * (binary indexed) tree of counts over the value domain 0..2047 ms.
+ *
+ *   push (insert + evict oldest)  O(log V), 22 tree steps worst case
+ *   k-th smallest / quantile      O(log V), 11 steps (binary lifting)
+ *
+ * V = 2048 is fixed, so cost does not depend on window length and there are
+ * no pointers, heaps or lazy deletions - just two static arrays. Used for
+ * median-referenced artifact rejection, robust baselines and the IQR-based
+ * signal quality score in biometric_algorithms.
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef RR_QUANTILE_H
+#define RR_QUANTILE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
+
+#define RR_QUANTILE_DOMAIN_BITS     11
+#define RR_QUANTILE_DOMAIN          (1U << RR_QUANTILE_DOMAIN_BITS) /**< 0..2047 ms */
+#define RR_QUANTILE_CAPACITY        64      /**< Max window (fits uint8 counts) */
+
+/*******************************************************************************
+ * TYPES
+ ******************************************************************************/
+
+typedef struct {
+    uint8_t tree[RR_QUANTILE_DOMAIN + 1];   /**< Fenwick tree, 1-based */
+    uint16_t ring[RR_QUANTILE_CAPACITY];    /**< Values in arrival order */
+    uint8_t head;
+    uint8_t count;
+    uint8_t window;                         /**< Active window length */
+} rr_quantile_t;
+
+/*******************************************************************************
+ * PUBLIC API
+ ******************************************************************************/
+
+/**
+ * @brief Clear the filter and set the window length
+ *
+ * @param p_q    Filter
+ * @param window Number of most recent values kept (1..RR_QUANTILE_CAPACITY)
+ */
+void rr_quantile_init(rr_quantile_t *p_q, uint8_t window);
+
+/**
+ * @brief Add a value, evicting the oldest once the window is full
+ *
+ * Values above the domain are clamped to RR_QUANTILE_DOMAIN - 1.
+ */
+void rr_quantile_push(rr_quantile_t *p_q, uint16_t value);
+
+/**
+ * @brief k-th smallest value in the window (0-based)
+ *
+ * @return Value, or 0 if rank >= count
+ */
+uint16_t rr_quantile_select(const rr_quantile_t *p_q, uint8_t rank);
+
+/**
+ * @brief Nearest-rank quantile
+ *
+ * @param pct Percentile 0-100 (50 = median)
+ * @return Value, or 0 if the window is empty
+ */
+uint16_t rr_quantile_get(const rr_quantile_t *p_q, uint8_t pct);
+
+static inline uint16_t rr_quantile_median(const rr_quantile_t *p_q)
+{
+    return rr_quantile_get(p_q, 50);
+}
+
+static inline uint8_t rr_quantile_count(const rr_quantile_t *p_q)
+{
+    return p_q->count;
+}
+
+#endif /* RR_QUANTILE_H */
@@ -0,0 +1,203 @@
+/**
+ * @file stress_calibration.c
+ * @brief Per-User Stress Calibration via Streaming Quantile Sketch
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "stress_calibration.h"
+#include "../system/nvm_store.h"
+#include <string.h>
+
+/*******************************************************************************
+ * PRIVATE DATA
+ ******************************************************************************/
+
+/** Marker probabilities: dense in the tails where stress decisions happen */
+static const float MARKER_P[STRESS_CAL_MARKERS] = {
+    0.0f, 0.05f, 0.10f, 0.25f, 0.50f, 0.75f, 0.90f, 0.95f, 1.0f
+};
+
+/** The same probabilities in Q16 */
+static const uint32_t MARKER_P_Q16[STRESS_CAL_MARKERS] = {
+    0U, 3277U, 6554U, 16384U, 32768U, 49152U, 58982U, 62259U, 65536U
+};
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+static float sc_parabolic(const stress_calibration_t *p_cal, uint8_t i, int32_t d)
+{
+    const float *q = p_cal->height;
+    const int32_t *n = p_cal->position;
+
+    float a = (float)(n[i] - n[i - 1] + d) * (q[i + 1] - q[i]) / (float)(n[i + 1] - n[i]);
+    float b = (float)(n[i + 1] - n[i] - d) * (q[i] - q[i - 1]) / (float)(n[i] - n[i - 1]);
+    return q[i] + (float)d / (float)(n[i + 1] - n[i - 1]) * (a + b);
+}
+
+static float sc_linear(const stress_calibration_t *p_cal, uint8_t i, int32_t d)
+{
+    const float *q = p_cal->height;
+    const int32_t *n = p_cal->position;
+    uint8_t j = (uint8_t)(i + d);
+
+    return q[i] + (float)d * (q[j] - q[i]) / (float)(n[j] - n[i]);
+}
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+void stress_calibration_reset(stress_calibration_t *p_cal)
+{
+    if (p_cal) {
+        memset(p_cal, 0, sizeof(stress_calibration_t));
+        p_cal->version = STRESS_CAL_VERSION;
+    }
+}
+
+void stress_calibration_add(stress_calibration_t *p_cal, float value)
+{
+    if (!p_cal) return;
+
+    float *q = p_cal->height;
+    int32_t *n = p_cal->position;
+
+    /* Warm-up: keep the first observations sorted */
+    if (p_cal->count < STRESS_CAL_MARKERS) {
+        int8_t i = (int8_t)p_cal->count - 1;
+        while (i >= 0 && q[i] > value) {
+            q[i + 1] = q[i];
+            i--;
+        }
+        q[i + 1] = value;
+        p_cal->count++;
+        if (p_cal->count == STRESS_CAL_MARKERS) {
+            for (uint8_t m = 0; m < STRESS_CAL_MARKERS; m++) n[m] = m + 1;
+        }
+        return;
+    }
+
+    /* 1. Find cell k containing the value; extend extremes */
+    uint8_t k;
+    if (value < q[0]) {
+        q[0] = value;
+        k = 0;
+    } else if (value >= q[STRESS_CAL_MARKERS - 1]) {
+        q[STRESS_CAL_MARKERS - 1] = value;
+        k = STRESS_CAL_MARKERS - 2;
+    } else {
+        k = 0;
+        while (k < STRESS_CAL_MARKERS - 2 && value >= q[k + 1]) k++;
+    }
+
+    /* 2. Shift positions of markers above the cell */
+    for (uint8_t i = (uint8_t)(k + 1); i < STRESS_CAL_MARKERS; i++) {
+        n[i]++;
+    }
+    p_cal->count++;
+
+    /* 3. Nudge interior markers toward their desired positions */
+    for (uint8_t i = 1; i < STRESS_CAL_MARKERS - 1; i++) {
+        float desired = 1.0f + (float)(p_cal->count - 1U) * MARKER_P[i];
+        float delta = desired - (float)n[i];
+
+        if ((delta >= 1.0f && n[i + 1] - n[i] > 1) ||
+            (delta <= -1.0f && n[i - 1] - n[i] < -1)) {
+            int32_t d = (delta > 0.0f) ? 1 : -1;
+            float candidate = sc_parabolic(p_cal, i, d);
+            if (q[i - 1] < candidate && candidate < q[i + 1]) {
+                q[i] = candidate;
+            } else {
+                q[i] = sc_linear(p_cal, i, d);
+            }
+            n[i] += d;
+        }
+    }
+}
+
+bool stress_calibration_ready(const stress_calibration_t *p_cal)
+{
+    return p_cal && p_cal->count >= STRESS_CAL_MIN_OBSERVATIONS;
+}
+
+float stress_calibration_quantile(const stress_calibration_t *p_cal, float p)
+{
+    if (!p_cal || p_cal->count < STRESS_CAL_MARKERS) return 0.0f;
+    if (p <= 0.0f) return p_cal->height[0];
+    if (p >= 1.0f) return p_cal->height[STRESS_CAL_MARKERS - 1];
+
+    uint8_t k = 0;
+    while (k < STRESS_CAL_MARKERS - 2 && p > MARKER_P[k + 1]) k++;
+
+    float t = (p - MARKER_P[k]) / (MARKER_P[k + 1] - MARKER_P[k]);
+    return p_cal->height[k] + t * (p_cal->height[k + 1] - p_cal->height[k]);
+}
+
+float stress_calibration_percentile(const stress_calibration_t *p_cal, float value)
+{
+    if (!p_cal || p_cal->count < STRESS_CAL_MARKERS) return 0.5f;
+
+    const float *q = p_cal->height;
+    if (value <= q[0]) return 0.0f;
+    if (value >= q[STRESS_CAL_MARKERS - 1]) return 1.0f;
+
+    uint8_t k = 0;
+    while (k < STRESS_CAL_MARKERS - 2 && value >= q[k + 1]) k++;
+
+    float span = q[k + 1] - q[k];
+    float t = (span > 0.0f) ? (value - q[k]) / span : 0.5f;
+    return MARKER_P[k] + t * (MARKER_P[k + 1] - MARKER_P[k]);
+}
+
+void stress_calibration_table(const stress_calibration_t *p_cal, float scale,
+                              stress_calibration_table_t *p_table)
+{
+    if (!p_cal || !p_table) return;
+
+    p_table->count = p_cal->count;
+    for (uint8_t i = 0; i < STRESS_CAL_MARKERS; i++) {
+        float h = p_cal->height[i] * scale;
+        p_table->height[i] = (h > 0.0f) ? (uint32_t)(h + 0.5f) : 0U;
+    }
+}
+
+uint32_t stress_calibration_percentile_q16(const stress_calibration_table_t *p_table, uint32_t value)
+{
+    if (!p_table || p_table->count < STRESS_CAL_MARKERS) return MARKER_P_Q16[4];
+
+    const uint32_t *q = p_table->height;
+    if (value <= q[0]) return 0U;
+    if (value >= q[STRESS_CAL_MARKERS - 1]) return MARKER_P_Q16[STRESS_CAL_MARKERS - 1];
+
+    uint8_t k = 0;
+    while (k < STRESS_CAL_MARKERS - 2 && value >= q[k + 1]) k++;
+
+    uint32_t span = q[k + 1] - q[k];
+    uint32_t dp = MARKER_P_Q16[k + 1] - MARKER_P_Q16[k];
+    uint32_t t = (span > 0U) ? (uint32_t)(((uint64_t)(value - q[k]) * dp + span / 2U) / span) : dp / 2U;
+    return MARKER_P_Q16[k] + t;
+}
+
+int stress_calibration_save(const stress_calibration_t *p_cal)
+{
+    if (!p_cal) return -1;
+    return nvm_store_write(NVM_RECORD_STRESS_CALIBRATION, p_cal, sizeof(stress_calibration_t));
+}
+
+int stress_calibration_load(stress_calibration_t *p_cal)
+{
+    stress_calibration_t stored;
+
+    if (!p_cal) return -1;
+
+    int err = nvm_store_read(NVM_RECORD_STRESS_CALIBRATION, &stored, sizeof(stored));
+    if (err != 0) return err;
+    if (stored.version != STRESS_CAL_VERSION) return -5;
+
+    *p_cal = stored;
+    return 0;
+}
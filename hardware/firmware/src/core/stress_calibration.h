@@ -0,0 +1,112 @@
+/**
+ * @file stress_calibration.h
+ * @brief Per-User Stress Calibration via Streaming Quantile Sketch
+ *
+ * Tracks the distribution of the user's own RMSSD with an extended P²
+ * estimator (Jain & Chlamtac 1985; Raatikainen 1987): nine markers at fixed
+ * probabilities, O(1) update, constant memory (~80 bytes), no stored
+ * samples. Stress is then "how low is RMSSD right now compared with this
+ * user's history": stress = 1 - percentile(rmssd).
+ *
+ * The sketch is persisted through nvm_store so calibration survives
+ * reboots and battery swaps.
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef STRESS_CALIBRATION_H
+#define STRESS_CALIBRATION_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
+
+#define STRESS_CAL_MARKERS          9       /**< p = 0, .05, .1, .25, .5, .75, .9, .95, 1 */
+#define STRESS_CAL_MIN_OBSERVATIONS 40      /**< ~20 min of decimated RMSSD */
+#define STRESS_CAL_VERSION          1
+
+/*******************************************************************************
+ * TYPES
+ ******************************************************************************/
+
+/** Sketch state (this is also the persisted record) */
+typedef struct {
+    uint8_t version;
+    uint8_t reserved[3];
+    uint32_t count;                         /**< Observations seen */
+    float height[STRESS_CAL_MARKERS];       /**< Marker values (quantile estimates) */
+    int32_t position[STRESS_CAL_MARKERS];   /**< Marker positions (1-based ranks) */
+} stress_calibration_t;
+
+/** Integer snapshot of the marker heights, for percentile lookups without the FPU */
+typedef struct {
+    uint32_t count;                         /**< Sketch count when taken */
+    uint32_t height[STRESS_CAL_MARKERS];    /**< Marker heights x scale, rounded */
+} stress_calibration_table_t;
+
+/*******************************************************************************
+ * PUBLIC API
+ ******************************************************************************/
+
+/**
+ * @brief Clear the sketch
+ */
+void stress_calibration_reset(stress_calibration_t *p_cal);
+
+/**
+ * @brief Add one observation (O(1))
+ */
+void stress_calibration_add(stress_calibration_t *p_cal, float value);
+
+/**
+ * @brief True once enough observations exist to trust percentiles
+ */
+bool stress_calibration_ready(const stress_calibration_t *p_cal);
+
+/**
+ * @brief Estimated quantile at probability p (0..1)
+ */
+float stress_calibration_quantile(const stress_calibration_t *p_cal, float p);
+
+/**
+ * @brief Estimated percentile (0..1) of a value within the user's history
+ *
+ * Piecewise-linear interpolation of the CDF between markers.
+ */
+float stress_calibration_percentile(const stress_calibration_t *p_cal, float value);
+
+/**
+ * @brief Snapshot the marker heights as integers (height x scale)
+ *
+ * Refresh whenever the sketch count moves; negative heights clamp to 0.
+ */
+void stress_calibration_table(const stress_calibration_t *p_cal, float scale,
+                              stress_calibration_table_t *p_table);
+
+/**
+ * @brief stress_calibration_percentile() on a table, in Q16 (65536 = 1.0)
+ *
+ * @param value Same units as the table heights
+ */
+uint32_t stress_calibration_percentile_q16(const stress_calibration_table_t *p_table, uint32_t value);
+
+/**
+ * @brief Persist the sketch to flash
+ * @return 0 on success (nvm_store error code otherwise)
+ */
+int stress_calibration_save(const stress_calibration_t *p_cal);
+
+/**
+ * @brief Restore the sketch from flash
+ *
+ * Leaves p_cal untouched if nothing valid is stored.
+ *
+ * @return 0 on success, negative if no valid record
+ */
+int stress_calibration_load(stress_calibration_t *p_cal);
+
+#endif /* STRESS_CALIBRATION_H */
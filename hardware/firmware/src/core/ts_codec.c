@@ -0,0 +1,261 @@
+/**
+ * @file ts_codec.c
+ * @brief Streaming Time-Series Codec Implementation
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "ts_codec.h"
+#include <string.h>
+
+/*******************************************************************************
+ * BIT WRITER
+ ******************************************************************************/
+
+static bool put_bits(ts_encoder_t *p_enc, uint32_t value, uint8_t n)
+{
+    if (p_enc->bits + n > p_enc->cap_bits) return false;
+
+    while (n > 0U) {
+        uint8_t off = (uint8_t)(p_enc->bits & 7U);
+        uint8_t space = (uint8_t)(8U - off);
+        uint8_t take = (n < space) ? n : space;
+        uint8_t chunk = (uint8_t)((value >> (n - take)) & ((1U << take) - 1U));
+        uint8_t shift = (uint8_t)(space - take);
+        uint8_t mask = (uint8_t)(((1U << take) - 1U) << shift);
+        uint8_t *p = &p_enc->p_buf[p_enc->bits >> 3];
+
+        *p = (uint8_t)((*p & ~mask) | (chunk << shift));
+        p_enc->bits += take;
+        n = (uint8_t)(n - take);
+    }
+    return true;
+}
+
+/** Prefix code of up to 4 ones, then payload */
+static bool put_coded(ts_encoder_t *p_enc, uint8_t ones, bool stop, uint32_t payload, uint8_t n)
+{
+    uint32_t prefix = ((1U << ones) - 1U) << (stop ? 1 : 0);
+    return put_bits(p_enc, prefix, (uint8_t)(ones + (stop ? 1U : 0U))) &&
+           (n == 0U || put_bits(p_enc, payload, n));
+}
+
+static bool put_timestamp(ts_encoder_t *p_enc, uint32_t ts_ms)
+{
+    uint32_t delta = ts_ms - p_enc->prev_ts;
+    int32_t dod = (int32_t)(delta - p_enc->prev_delta);
+
+    p_enc->prev_ts = ts_ms;
+    p_enc->prev_delta = delta;
+
+    if (dod == 0) return put_bits(p_enc, 0, 1);
+    if (dod >= -63 && dod <= 64) return put_coded(p_enc, 1, true, (uint32_t)(dod + 63), 7);
+    if (dod >= -255 && dod <= 256) return put_coded(p_enc, 2, true, (uint32_t)(dod + 255), 9);
+    if (dod >= -2047 && dod <= 2048) return put_coded(p_enc, 3, true, (uint32_t)(dod + 2047), 12);
+    return put_coded(p_enc, 4, false, (uint32_t)dod, 32);
+}
+
+static bool put_delta_value(ts_encoder_t *p_enc, uint32_t value)
+{
+    int32_t d = (int32_t)(value - p_enc->prev_value);
+    uint32_t zz = ((uint32_t)d << 1) ^ (uint32_t)(d >> 31);
+
+    p_enc->prev_value = value;
+
+    if (zz == 0U) return put_bits(p_enc, 0, 1);
+    if (zz < (1U << 6)) return put_coded(p_enc, 1, true, zz, 6);
+    if (zz < (1U << 12)) return put_coded(p_enc, 2, true, zz, 12);
+    if (zz < (1U << 20)) return put_coded(p_enc, 3, true, zz, 20);
+    return put_coded(p_enc, 4, false, zz, 32);
+}
+
+static bool put_xor_value(ts_encoder_t *p_enc, uint32_t value)
+{
+    uint32_t x = value ^ p_enc->prev_value;
+
+    p_enc->prev_value = value;
+    if (x == 0U) return put_bits(p_enc, 0, 1);
+
+    uint8_t lead = (uint8_t)__builtin_clz(x);
+    uint8_t trail = (uint8_t)__builtin_ctz(x);
+
+    /* Reuse the previous window if the meaningful bits fall inside it */
+    if (p_enc->prev_len > 0U && lead >= p_enc->prev_lead &&
+        trail >= 32U - p_enc->prev_lead - p_enc->prev_len) {
+        uint8_t shift = (uint8_t)(32U - p_enc->prev_lead - p_enc->prev_len);
+        return put_bits(p_enc, 2U, 2) && put_bits(p_enc, x >> shift, p_enc->prev_len);
+    }
+
+    uint8_t len = (uint8_t)(32U - lead - trail);
+    p_enc->prev_lead = lead;
+    p_enc->prev_len = len;
+    return put_bits(p_enc, 3U, 2) &&
+           put_bits(p_enc, ((uint32_t)lead << 5) | (len - 1U), 10) &&
+           put_bits(p_enc, x >> trail, len);
+}
+
+/*******************************************************************************
+ * BIT READER
+ ******************************************************************************/
+
+static uint32_t peek_bits(const ts_decoder_t *p_dec, uint8_t n)
+{
+    uint32_t byte = p_dec->pos >> 3;
+    uint32_t len = (p_dec->len_bits + 7U) >> 3;
+    uint64_t acc = 0;
+
+    if (n == 0U) return 0;
+    if (byte + 8U <= len) {
+        uint8_t raw[8];
+        memcpy(raw, &p_dec->p_buf[byte], 8);
+        for (uint8_t i = 0; i < 8U; i++) acc = (acc << 8) | raw[i];
+    } else {
+        for (uint8_t i = 0; i < 8U; i++) {
+            acc = (acc << 8) | ((byte + i < len) ? p_dec->p_buf[byte + i] : 0U);
+        }
+    }
+    return (uint32_t)((acc << (p_dec->pos & 7U)) >> (64U - n));
+}
+
+static uint32_t get_bits(ts_decoder_t *p_dec, uint8_t n)
+{
+    uint32_t v = peek_bits(p_dec, n);
+    p_dec->pos += n;
+    return v;
+}
+
+/** Count of leading ones (0..4) and the bits that took */
+static uint8_t get_prefix(ts_decoder_t *p_dec)
+{
+    static const uint8_t ONES[16] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 3, 4 };
+    uint8_t ones = ONES[peek_bits(p_dec, 4)];
+
+    p_dec->pos += (ones < 4U) ? ones + 1U : 4U;
+    return ones;
+}
+
+static uint32_t get_timestamp(ts_decoder_t *p_dec)
+{
+    static const uint8_t WIDTH[5] = { 0, 7, 9, 12, 32 };
+    static const int32_t BIAS[5] = { 0, 63, 255, 2047, 0 };
+    uint8_t k = get_prefix(p_dec);
+    int32_t dod = (k == 0U) ? 0 : (int32_t)get_bits(p_dec, WIDTH[k]) - BIAS[k];
+
+    p_dec->prev_delta += (uint32_t)dod;
+    p_dec->prev_ts += p_dec->prev_delta;
+    return p_dec->prev_ts;
+}
+
+static uint32_t get_value(ts_decoder_t *p_dec)
+{
+    if (p_dec->mode == TS_CODEC_DELTA) {
+        static const uint8_t WIDTH[5] = { 0, 6, 12, 20, 32 };
+        uint8_t k = get_prefix(p_dec);
+        uint32_t zz = (k == 0U) ? 0U : get_bits(p_dec, WIDTH[k]);
+        p_dec->prev_value += (zz >> 1) ^ (0U - (zz & 1U));
+        return p_dec->prev_value;
+    }
+
+    if (get_bits(p_dec, 1) == 0U) return p_dec->prev_value;
+    if (get_bits(p_dec, 1) == 1U) {
+        uint32_t hdr = get_bits(p_dec, 10);
+        p_dec->prev_lead = (uint8_t)(hdr >> 5);
+        p_dec->prev_len = (uint8_t)((hdr & 0x1FU) + 1U);
+    }
+    uint8_t shift = (uint8_t)(32U - p_dec->prev_lead - p_dec->prev_len);
+    p_dec->prev_value ^= get_bits(p_dec, p_dec->prev_len) << shift;
+    return p_dec->prev_value;
+}
+
+/*******************************************************************************
+ * PUBLIC API
+ ******************************************************************************/
+
+void ts_encoder_init(ts_encoder_t *p_enc, ts_codec_mode_t mode, uint8_t *p_buf, uint16_t cap)
+{
+    memset(p_enc, 0, sizeof(*p_enc));
+    p_enc->p_buf = p_buf;
+    p_enc->cap_bits = (uint32_t)cap * 8U;
+    p_enc->mode = (uint8_t)mode;
+    if (cap > 0U) p_buf[0] = 0;
+}
+
+int ts_encoder_append(ts_encoder_t *p_enc, uint32_t ts_ms, uint32_t value)
+{
+    ts_encoder_t saved = *p_enc;
+    bool ok;
+
+    if (p_enc->count == 0U) {
+        ok = put_bits(p_enc, ts_ms, 32) && put_bits(p_enc, value, 32);
+        p_enc->prev_ts = ts_ms;
+        p_enc->prev_value = value;
+    } else {
+        ok = put_timestamp(p_enc, ts_ms) &&
+             ((p_enc->mode == TS_CODEC_DELTA) ? put_delta_value(p_enc, value)
+                                              : put_xor_value(p_enc, value));
+    }
+
+    if (!ok) {
+        /* Roll back; keep the padding of the last byte clear */
+        *p_enc = saved;
+        if ((p_enc->bits & 7U) != 0U) {
+            p_enc->p_buf[p_enc->bits >> 3] &= (uint8_t)(0xFFU << (8U - (p_enc->bits & 7U)));
+        }
+        return -1;
+    }
+    p_enc->count++;
+    return 0;
+}
+
+uint16_t ts_encoder_bytes(const ts_encoder_t *p_enc)
+{
+    return (uint16_t)((p_enc->bits + 7U) >> 3);
+}
+
+void ts_decoder_init(ts_decoder_t *p_dec, ts_codec_mode_t mode, const uint8_t *p_buf, uint16_t len, uint32_t count)
+{
+    memset(p_dec, 0, sizeof(*p_dec));
+    p_dec->p_buf = p_buf;
+    p_dec->len_bits = (uint32_t)len * 8U;
+    p_dec->left = count;
+    p_dec->first = 1U;
+    p_dec->mode = (uint8_t)mode;
+}
+
+bool ts_decoder_next(ts_decoder_t *p_dec, uint32_t *p_ts_ms, uint32_t *p_value)
+{
+    if (p_dec->left == 0U) return false;
+
+    if (p_dec->first) {
+        p_dec->prev_ts = get_bits(p_dec, 32);
+        p_dec->prev_value = get_bits(p_dec, 32);
+        p_dec->first = 0U;
+        *p_ts_ms = p_dec->prev_ts;
+        *p_value = p_dec->prev_value;
+    } else {
+        *p_ts_ms = get_timestamp(p_dec);
+        *p_value = get_value(p_dec);
+    }
+
+    if (p_dec->pos > p_dec->len_bits) {
+        p_dec->left = 0;
+        return false;   /* Truncated */
+    }
+    p_dec->left--;
+    return true;
+}
+
+uint32_t ts_codec_float_bits(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+float ts_codec_bits_float(uint32_t bits)
+{
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
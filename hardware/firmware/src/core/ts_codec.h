@@ -0,0 +1,134 @@
+/**
+ * @file ts_codec.h
+ * @brief Streaming Time-Series Codec for On-Ring Logs (Gorilla-style)
+ *
+ * Packs (timestamp, value) samples into a bit stream, MSB first:
+ *
+ *   first sample   32-bit timestamp, 32-bit value
+ *   timestamps     delta-of-delta (ms), prefix-coded:
+ *                    0                    dod == 0
+ *                    10   + 7 bits        -63..64
+ *                    110  + 9 bits        -255..256
+ *                    1110 + 12 bits       -2047..2048
+ *                    1111 + 32 bits       anything (wraps modulo 2^32)
+ *   values         TS_CODEC_DELTA (fixed-point int32: RR ms, 0.01 C):
+ *                    zigzag delta, 0 | 10+6 | 110+12 | 1110+20 | 1111+32 bits
+ *                  TS_CODEC_XOR (float bits: metric snapshots):
+ *                    0                    same value
+ *                    10 + bits            XOR fits the previous window
+ *                    11 + 5 lead + 5 (len - 1) + len bits
+ *
+ * The encoder is append-only with O(1) state and no allocation, so it can
+ * sit in wellness_manager_tick(); an append that does not fit leaves the
+ * stream and state untouched. The decoder reads 64 bits at a time and is
+ * meant for the host (sync/replay), though it builds for the ring too.
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef TS_CODEC_H
+#define TS_CODEC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+ * TYPES
+ ******************************************************************************/
+
+/** Value coding, fixed per stream */
+typedef enum {
+    TS_CODEC_DELTA = 0,         /**< Fixed-point integers */
+    TS_CODEC_XOR,               /**< IEEE-754 float bit patterns */
+} ts_codec_mode_t;
+
+typedef struct {
+    uint8_t *p_buf;
+    uint32_t cap_bits;
+    uint32_t bits;              /**< Stream length so far */
+    uint32_t count;             /**< Samples appended */
+    uint32_t prev_ts;
+    uint32_t prev_delta;
+    uint32_t prev_value;
+    uint8_t prev_lead;          /**< XOR window of the last explicit value */
+    uint8_t prev_len;
+    uint8_t mode;
+} ts_encoder_t;
+
+typedef struct {
+    const uint8_t *p_buf;
+    uint32_t len_bits;
+    uint32_t pos;               /**< Read position in bits */
+    uint32_t left;              /**< Samples still to decode */
+    uint32_t first;
+    uint32_t prev_ts;
+    uint32_t prev_delta;
+    uint32_t prev_value;
+    uint8_t prev_lead;
+    uint8_t prev_len;
+    uint8_t mode;
+} ts_decoder_t;
+
+/*******************************************************************************
+ * PUBLIC API
+ ******************************************************************************/
+
+/**
+ * @brief Start an empty stream in a caller-owned buffer
+ *
+ * @param p_enc  Encoder
+ * @param mode   Value coding
+ * @param p_buf  Output buffer
+ * @param cap    Buffer size in bytes
+ */
+void ts_encoder_init(ts_encoder_t *p_enc, ts_codec_mode_t mode, uint8_t *p_buf, uint16_t cap);
+
+/**
+ * @brief Append one sample
+ *
+ * @param p_enc   Encoder
+ * @param ts_ms   Timestamp
+ * @param value   Fixed-point value, or float bits (ts_codec_float_bits)
+ * @return 0 on success, -1 buffer full (nothing written)
+ */
+int ts_encoder_append(ts_encoder_t *p_enc, uint32_t ts_ms, uint32_t value);
+
+/**
+ * @brief Bytes used so far (last byte zero-padded)
+ */
+uint16_t ts_encoder_bytes(const ts_encoder_t *p_enc);
+
+/**
+ * @brief Start decoding a stream of count samples
+ *
+ * @param p_dec  Decoder
+ * @param mode   Value coding used by the encoder
+ * @param p_buf  Stream
+ * @param len    Stream length in bytes
+ * @param count  Samples in the stream
+ */
+void ts_decoder_init(ts_decoder_t *p_dec, ts_codec_mode_t mode, const uint8_t *p_buf, uint16_t len, uint32_t count);
+
+/**
+ * @brief Decode the next sample
+ *
+ * @return true with the sample, false at the end or on a truncated stream
+ */
+bool ts_decoder_next(ts_decoder_t *p_dec, uint32_t *p_ts_ms, uint32_t *p_value);
+
+/**
+ * @brief Float to the bit pattern TS_CODEC_XOR stores, and back
+ */
+uint32_t ts_codec_float_bits(float value);
+float ts_codec_bits_float(uint32_t bits);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TS_CODEC_H */
@@ -1,29 +1,40 @@
 #include "wellness_manager.h"
 #include "wellness_processor.h"
+#include "hrv_nonlinear.h"
 #include "../sensors/ppg_driver.h"
 #include "../wellness_feedback/cue_processor.h"
 #include "../wellness_feedback/actuator_controller.h"
 #include <stddef.h>
+#include <string.h>
 
 static struct {
     hr_metrics_t metrics;
+    hrv_nonlinear_t nonlinear;
     bool autonomous_enabled;
     uint32_t last_check_ms;
+    uint32_t check_interval_ms;
     
     /* Buffer for RR intervals to be consumed by other tasks (e.g. BLE) */
-    float rr_buffer[16];
+    uint16_t rr_buffer[16];   /* ms */
     uint8_t rr_head;
     uint8_t rr_tail;
     uint8_t rr_count;
     
+    /* Calibration persistence */
+    uint32_t calibration_saved_count;
+    
     /* Power Management */
     uint8_t battery_pct;
 } s_manager;
 
 void wellness_manager_init(void) {
     biometrics_reset(&s_manager.metrics);
+    hrv_nonlinear_reset(&s_manager.nonlinear);
+    stress_calibration_load(&s_manager.metrics.calibration); /* Keep defaults if none stored */
+    s_manager.calibration_saved_count = s_manager.metrics.calibration.count;
     s_manager.autonomous_enabled = true; /* Default to ON for "Local Awareness" */
     s_manager.last_check_ms = 0;
+    s_manager.check_interval_ms = WELLNESS_CHECK_INTERVAL_MS;
     s_manager.rr_head = 0;
     s_manager.rr_tail = 0;
     s_manager.rr_count = 0;
@@ -31,40 +42,66 @@ void wellness_manager_init(void) {
 }
 
 void wellness_manager_tick(uint32_t now_ms) {
-    float rr_ms;
+    uint32_t rr_us;
     bool has_new_data = false;
 
-    /* 1. Poll all available RR intervals from the buffer */
-    while (ppg_get_rr(&rr_ms)) {
-        if (biometrics_process_rr(&s_manager.metrics, rr_ms)) {
+    /* 1. Poll all available RR intervals from the buffer (integer us end to end) */
+    while (ppg_get_rr_us(&rr_us)) {
+        if (biometrics_process_rr_us(&s_manager.metrics, rr_us)) {
             has_new_data = true;
+            hrv_nonlinear_add_rr_us(&s_manager.nonlinear, rr_us);
             
             /* Add to internal buffer for external consumers */
             if (s_manager.rr_count < 16) {
-                s_manager.rr_buffer[s_manager.rr_head] = rr_ms;
+                s_manager.rr_buffer[s_manager.rr_head] = (uint16_t)((rr_us + 500U) / 1000U);
                 s_manager.rr_head = (s_manager.rr_head + 1) % 16;
                 s_manager.rr_count++;
             }
         }
     }
 
+    /* Advance DFA / entropy by one unit of work per tick (amortized) */
+    if (hrv_nonlinear_step(&s_manager.nonlinear)) {
+        biometrics_set_dfa_alpha1(&s_manager.metrics, s_manager.nonlinear.dfa_alpha1);
+        s_manager.metrics.sample_entropy = s_manager.nonlinear.sampen;
+        s_manager.metrics.approx_entropy = s_manager.nonlinear.apen;
+    }
+
     if (!has_new_data) return;
 
+    s_manager.metrics.sd1_us = s_manager.nonlinear.sd1_us;
+    s_manager.metrics.sd2_us = s_manager.nonlinear.sd2_us;
+    s_manager.metrics.sdnn_us = s_manager.nonlinear.sdnn_us;
+
+    /* Persist calibration every 20 new observations (~10 min of beats) */
+    if (s_manager.metrics.calibration.count - s_manager.calibration_saved_count >= 20) {
+        if (stress_calibration_save(&s_manager.metrics.calibration) == 0) {
+            s_manager.calibration_saved_count = s_manager.metrics.calibration.count;
+        }
+    }
+
     /* 2. Evaluate autonomous feedback logic (Rate limited) */
-    if (s_manager.autonomous_enabled && (now_ms - s_manager.last_check_ms >= 15000)) {
+    if (s_manager.autonomous_enabled && (now_ms - s_manager.last_check_ms >= s_manager.check_interval_ms)) {
         s_manager.last_check_ms = now_ms;
 
         /* If stress score is high (> 0.7) and we have enough data (at least ~30 seconds) */
         if (s_manager.metrics.valid_samples > 30) {
             
+            /* Confidence: data volume, capped by the IQR-based signal quality */
+            uint8_t confidence = (s_manager.metrics.valid_samples > 60) ? 90 : 70;
+            if (s_manager.metrics.quality_pct < confidence) {
+                confidence = s_manager.metrics.quality_pct;
+            }
+
             /* Prepare input for the cue processor */
             cue_input_t cue_in = {
                 .timestamp_ms = now_ms,
-                .stress_level = (uint8_t)(s_manager.metrics.stress_score * 100.0f),
-                .coherence_pct = (uint8_t)((1.0f - s_manager.metrics.stress_score) * 100.0f),
-                .confidence_pct = (s_manager.metrics.valid_samples > 60) ? 90 : 70,
-                .micro_var_pct100 = (uint16_t)(s_manager.metrics.rmssd * 10.0f), /* Scaled RMSSD */
-                .artifact_rate_pct = (uint8_t)((1.0f - (float)s_manager.metrics.valid_samples / s_manager.metrics.total_samples) * 100.0f),
+                .stress_level = biometrics_stress_pct(&s_manager.metrics),
+                .coherence_pct = biometrics_coherence_pct(&s_manager.metrics),
+                .confidence_pct = confidence,
+                .micro_var_pct100 = (uint16_t)(s_manager.metrics.rmssd_us / 100U), /* RMSSD in 0.1 ms */
+                .artifact_rate_pct = (uint8_t)((s_manager.metrics.total_samples - s_manager.metrics.valid_samples) * 100U /
+                                               s_manager.metrics.total_samples),
                 .stability_pct = 80 /* Placeholder for coherence stability */
             };
             
@@ -101,13 +138,27 @@ void wellness_manager_set_autonomous(bool enabled) {
 
 void wellness_manager_set_battery(uint8_t level_pct) {
     s_manager.battery_pct = level_pct;
+    actuator_set_battery_soc(level_pct); /* Heater budget scales with SoC */
+}
+
+void wellness_manager_get_tuning(wellness_tuning_t *p_tuning) {
+    if (!p_tuning) return;
+    p_tuning->check_interval_ms = s_manager.check_interval_ms;
+    p_tuning->rmssd_alpha = s_manager.metrics.rmssd_alpha;
+    p_tuning->stress_alpha = s_manager.metrics.stress_alpha;
+}
+
+void wellness_manager_set_tuning(const wellness_tuning_t *p_tuning) {
+    if (!p_tuning) return;
+    s_manager.check_interval_ms = p_tuning->check_interval_ms;
+    biometrics_set_smoothing(&s_manager.metrics, p_tuning->rmssd_alpha, p_tuning->stress_alpha);
 }
 
 const hr_metrics_t* wellness_manager_get_metrics(void) {
     return &s_manager.metrics;
 }
 
-bool wellness_manager_pop_rr(float *out_rr_ms) {
+bool wellness_manager_pop_rr(uint16_t *out_rr_ms) {
     if (!out_rr_ms || s_manager.rr_count == 0) return false;
     
     *out_rr_ms = s_manager.rr_buffer[s_manager.rr_tail];
@@ -115,3 +166,16 @@ bool wellness_manager_pop_rr(float *out_rr_ms) {
     s_manager.rr_count--;
     return true;
 }
+
+uint32_t wellness_manager_state_save(void *p_buf, uint32_t cap) {
+    if (p_buf && cap >= sizeof(s_manager)) {
+        memcpy(p_buf, &s_manager, sizeof(s_manager));
+    }
+    return (uint32_t)sizeof(s_manager);
+}
+
+int wellness_manager_state_load(const void *p_buf, uint32_t len) {
+    if (!p_buf || len != sizeof(s_manager)) return -1;
+    memcpy(&s_manager, p_buf, sizeof(s_manager));
+    return 0;
+}
@@ -10,6 +10,18 @@
 #include <stdbool.h>
 #include "biometric_algorithms.h"
 
+/** Default autonomous cue evaluation period */
+#define WELLNESS_CHECK_INTERVAL_MS  15000U
+
+/**
+ * @brief Latency / false-cue tradeoff knobs (see tests/bench_cue_latency.c)
+ */
+typedef struct {
+    uint32_t check_interval_ms; /**< Autonomous cue evaluation period */
+    float rmssd_alpha;          /**< RMSSD EMA weight per beat */
+    float stress_alpha;         /**< Stress score EMA weight per beat */
+} wellness_tuning_t;
+
 /**
  * @brief Initialize the wellness manager
  */
@@ -38,6 +50,12 @@ void wellness_manager_set_autonomous(bool enabled);
  */
 void wellness_manager_set_battery(uint8_t level_pct);
 
+/**
+ * @brief Read or replace the tuning (init restores the defaults)
+ */
+void wellness_manager_get_tuning(wellness_tuning_t *p_tuning);
+void wellness_manager_set_tuning(const wellness_tuning_t *p_tuning);
+
 /**
  * @brief Get latest computed metrics
  */
@@ -47,9 +65,20 @@ const hr_metrics_t* wellness_manager_get_metrics(void);
  * @brief Pop an RR interval that has been processed by the manager.
  *        Useful for streaming RR intervals to BLE.
  * 
- * @param[out] out_rr_ms Pointer to store the RR interval
+ * @param[out] out_rr_ms Pointer to store the RR interval (ms)
  * @return true if an RR was returned, false if queue is empty
  */
-bool wellness_manager_pop_rr(float *out_rr_ms);
+bool wellness_manager_pop_rr(uint16_t *out_rr_ms);
+
+/**
+ * @brief Checkpoint support (see system/checkpoint.h)
+ *
+ * Save copies metrics, calibration, HRV windows and tuning to p_buf when it
+ * fits in cap and returns the state size (p_buf NULL queries the size).
+ *
+ * @return Load: 0 on success, -1 if len does not match this build
+ */
+uint32_t wellness_manager_state_save(void *p_buf, uint32_t cap);
+int wellness_manager_state_load(const void *p_buf, uint32_t len);
 
 #endif // WELLNESS_MANAGER_H
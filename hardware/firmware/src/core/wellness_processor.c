@@ -1,120 +1,169 @@
 // wellness_processor.c - renamed from neural_load_core
 // PPG peak detection for RR interval extraction at 100Hz.
+// The beat detector itself is pluggable (see peak_detector.h) and runs once
+// per PPG channel; ppg_fusion picks the cleanest channel's beats. This module
+// owns the fusion stage and turns fused beat timestamps into RR intervals.
 
 #include "wellness_processor.h"
+#include "ppg_fusion.h"
 #include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
 
-// Tunable parameters for 100Hz PPG
-#define PPG_FS_HZ              100U          // sample rate
-#define MA_DC_WINDOW           5U            // 50 ms DC removal window
-#define MA_INTEGRATOR_WINDOW   12U           // 120 ms moving integration
-#define REFRACTORY_MS          300U          // ignore peaks within 300 ms
-#define INITIAL_THRESHOLD      0.05f         // starting adaptive threshold
-#define THRESH_DECAY           0.995f        // slow decay when no peaks
-#define THRESH_BOOST_ALPHA     0.10f         // how fast threshold follows peaks
-
-typedef struct {
-	float dc_buffer[MA_DC_WINDOW];
-	float integ_buffer[MA_INTEGRATOR_WINDOW];
-	uint8_t dc_idx;
-	uint8_t integ_idx;
-	float dc_sum;
-	float integ_sum;
-	float prev_dc_removed;
-	float threshold;
-	uint32_t last_peak_ts_ms;
-	bool initialized;
-} ppg_peak_state_t;
-
-static ppg_peak_state_t g_state = {0};
+#define PPG_SAMPLE_PERIOD_MS   10U           // 100 Hz
 
 // RR ring buffer for downstream consumers (e.g., BLE telemetry)
 #define RR_BUFFER_SIZE 32U
-static float g_rr_buffer[RR_BUFFER_SIZE];
-static uint8_t g_rr_head = 0U;
-static uint8_t g_rr_tail = 0U;
-static uint8_t g_rr_count = 0U;
-
-static inline float moving_average_update(float *buffer, uint8_t *idx, uint8_t size, float *accum, float sample) {
-	*accum -= buffer[*idx];
-	buffer[*idx] = sample;
-	*accum += sample;
-	*idx = (uint8_t)((*idx + 1U) % size);
-	return *accum / (float)size;
+
+// Everything but the LED hook is plain data, so a checkpoint is one copy
+static struct {
+	ppg_fusion_t fusion;
+	peak_detector_id_t detector_id;
+	bool fusion_ready;
+	uint32_t last_peak_ms;
+	bool have_last_peak;
+	uint32_t rr_buffer[RR_BUFFER_SIZE];   // us (beat timestamps are whole ms)
+	uint8_t rr_head;
+	uint8_t rr_tail;
+	uint8_t rr_count;
+} g_state = {
+	.detector_id = (peak_detector_id_t)PPG_DETECTOR_DEFAULT,
+};
+static ppg_fusion_led_fn_t g_led_fn = NULL;
+
+// (Re)build the fusion stage when first used or when the channel count changes
+static void ensure_fusion(uint8_t n_channels) {
+	if (!g_state.fusion_ready || g_state.fusion.n_channels != n_channels) {
+		if (g_state.fusion_ready) {
+			ppg_fusion_reset(&g_state.fusion);   // Turns any paused LEDs back on
+		}
+		ppg_fusion_init(&g_state.fusion, n_channels, g_state.detector_id);
+		ppg_fusion_set_led_callback(&g_state.fusion, g_led_fn);
+		g_state.detector_id = g_state.fusion.ch[0].det.id;
+		g_state.fusion_ready = true;
+		g_state.have_last_peak = false;
+	}
+}
+
+static void push_rr(uint32_t rr_us) {
+	// Push into RR ring buffer (drop oldest on overflow)
+	if (g_state.rr_count == RR_BUFFER_SIZE) {
+		g_state.rr_tail = (uint8_t)((g_state.rr_tail + 1U) % RR_BUFFER_SIZE);
+		g_state.rr_count--;
+	}
+	g_state.rr_buffer[g_state.rr_head] = rr_us;
+	g_state.rr_head = (uint8_t)((g_state.rr_head + 1U) % RR_BUFFER_SIZE);
+	g_state.rr_count++;
+}
+
+// Drain fused beats into RR intervals. Returns number of RR produced and
+// writes the most recent one to out_rr_ms (if non-NULL).
+static int drain_beats(float *out_rr_ms) {
+	int produced = 0;
+	ppg_beat_t beat;
+
+	while (ppg_fusion_pop(&g_state.fusion, &beat)) {
+		if (g_state.have_last_peak) {
+			uint32_t rr_us = (beat.peak_ms - g_state.last_peak_ms) * 1000U;
+			push_rr(rr_us);
+			if (out_rr_ms) *out_rr_ms = (float)(beat.peak_ms - g_state.last_peak_ms);
+			produced++;
+		}
+		g_state.last_peak_ms = beat.peak_ms;
+		g_state.have_last_peak = true;
+	}
+	return produced;
 }
 
 int wellness_process_sample(float sample, uint32_t timestamp_ms, float *out_rr_ms) {
 	if (!out_rr_ms) return 0;
 
-	// Initialize threshold and buffers on first call
-	if (!g_state.initialized) {
-		for (uint8_t i = 0; i < MA_DC_WINDOW; i++) g_state.dc_buffer[i] = sample;
-		for (uint8_t i = 0; i < MA_INTEGRATOR_WINDOW; i++) g_state.integ_buffer[i] = 0.0f;
-		g_state.dc_sum = sample * (float)MA_DC_WINDOW;
-		g_state.integ_sum = 0.0f;
-		g_state.prev_dc_removed = sample;
-		g_state.threshold = INITIAL_THRESHOLD;
-		g_state.last_peak_ts_ms = 0U;
-		g_state.dc_idx = 0U;
-		g_state.integ_idx = 0U;
-		g_state.initialized = true;
-	}
+	ensure_fusion(1U);
+	ppg_fusion_process(&g_state.fusion, &sample, 1U, timestamp_ms, PPG_SAMPLE_PERIOD_MS);
+	return (drain_beats(out_rr_ms) > 0) ? 1 : 0;
+}
 
-	// 1) DC removal via short moving average
-	float dc_mean = moving_average_update(g_state.dc_buffer, &g_state.dc_idx, MA_DC_WINDOW, &g_state.dc_sum, sample);
-	float dc_removed = sample - dc_mean;
-
-	// 2) Derivative (emphasize rising edge) and 3) Squaring
-	float diff = dc_removed - g_state.prev_dc_removed;
-	g_state.prev_dc_removed = dc_removed;
-	float squared = diff * diff;
-
-	// 4) Moving integration (approximate energy over ~120 ms)
-	float integ_avg = moving_average_update(g_state.integ_buffer, &g_state.integ_idx, MA_INTEGRATOR_WINDOW, &g_state.integ_sum, squared);
-
-	// 5) Adaptive thresholding with refractory period
-	bool refractory_ok = (g_state.last_peak_ts_ms == 0U) || ((timestamp_ms - g_state.last_peak_ts_ms) > REFRACTORY_MS);
-	bool is_peak = refractory_ok && (integ_avg > g_state.threshold);
-
-	if (is_peak) {
-		// Update threshold toward current peak energy
-		g_state.threshold = (1.0f - THRESH_BOOST_ALPHA) * g_state.threshold + THRESH_BOOST_ALPHA * integ_avg;
-
-		// Emit RR if we have a previous peak
-		if (g_state.last_peak_ts_ms > 0U) {
-			*out_rr_ms = (float)(timestamp_ms - g_state.last_peak_ts_ms);
-
-			// Push into RR ring buffer (drop oldest on overflow)
-			if (g_rr_count == RR_BUFFER_SIZE) {
-				g_rr_tail = (uint8_t)((g_rr_tail + 1U) % RR_BUFFER_SIZE);
-				g_rr_count--;
-			}
-			g_rr_buffer[g_rr_head] = *out_rr_ms;
-			g_rr_head = (uint8_t)((g_rr_head + 1U) % RR_BUFFER_SIZE);
-			g_rr_count++;
-		}
+int wellness_process_block(const float *samples, uint16_t count, uint32_t t0_ms, uint16_t period_ms) {
+	return wellness_process_frames(samples, count, 1U, t0_ms, period_ms);
+}
 
-		g_state.last_peak_ts_ms = timestamp_ms;
-		return (g_state.last_peak_ts_ms > 0U); // returns 1 when RR computed
+int wellness_process_frames(const float *frames, uint16_t n_frames, uint8_t n_channels,
+                            uint32_t t0_ms, uint16_t period_ms) {
+	if (!frames || n_frames == 0U || n_channels == 0U || n_channels > PPG_FUSION_MAX_CHANNELS) return 0;
+
+	ensure_fusion(n_channels);
+	ppg_fusion_process(&g_state.fusion, frames, n_frames, t0_ms, period_ms);
+	return drain_beats(NULL);
+}
+
+void wellness_set_led_callback(void (*led_fn)(uint8_t channel, bool enabled)) {
+	g_led_fn = led_fn;
+	if (g_state.fusion_ready) {
+		ppg_fusion_set_led_callback(&g_state.fusion, led_fn);
 	}
+}
 
-	// Slowly decay threshold to follow lower amplitudes
-	g_state.threshold *= THRESH_DECAY;
+uint8_t wellness_get_ppg_channel(void) {
+	return g_state.fusion_ready ? g_state.fusion.primary : 0U;
+}
+
+int wellness_set_detector(uint8_t detector_id) {
+	if (detector_id >= (uint8_t)PEAK_DETECTOR_COUNT) return -1;
+	if (g_state.fusion_ready && g_state.detector_id == (peak_detector_id_t)detector_id) return 0;
+
+	// New engine starts from scratch; the first beat only re-anchors timing
+	g_state.detector_id = (peak_detector_id_t)detector_id;
+	g_state.have_last_peak = false;
+	if (g_state.fusion_ready) {
+		ppg_fusion_set_detector(&g_state.fusion, g_state.detector_id);
+	}
 	return 0;
 }
 
+uint8_t wellness_get_detector(void) {
+	return (uint8_t)g_state.detector_id;
+}
+
 void wellness_reset(void) {
-	g_state = (ppg_peak_state_t){0};
-	g_rr_head = g_rr_tail = g_rr_count = 0U;
+	if (g_state.fusion_ready) {
+		ppg_fusion_reset(&g_state.fusion);
+	}
+	g_state.have_last_peak = false;
+	g_state.last_peak_ms = 0U;
+	g_state.rr_head = g_state.rr_tail = g_state.rr_count = 0U;
 }
 
 int wellness_pop_rr(float *out_rr_ms) {
-	if (!out_rr_ms || g_rr_count == 0U) return 0;
-	*out_rr_ms = g_rr_buffer[g_rr_tail];
-	g_rr_tail = (uint8_t)((g_rr_tail + 1U) % RR_BUFFER_SIZE);
-	g_rr_count--;
+	uint32_t rr_us;
+	if (!out_rr_ms || !wellness_pop_rr_us(&rr_us)) return 0;
+	*out_rr_ms = (float)rr_us * 0.001f;
 	return 1;
 }
 
+int wellness_pop_rr_us(uint32_t *out_rr_us) {
+	if (!out_rr_us || g_state.rr_count == 0U) return 0;
+	*out_rr_us = g_state.rr_buffer[g_state.rr_tail];
+	g_state.rr_tail = (uint8_t)((g_state.rr_tail + 1U) % RR_BUFFER_SIZE);
+	g_state.rr_count--;
+	return 1;
+}
+
+uint32_t wellness_state_save(void *p_buf, uint32_t cap) {
+	if (p_buf && cap >= sizeof(g_state)) {
+		memcpy(p_buf, &g_state, sizeof(g_state));
+	}
+	return (uint32_t)sizeof(g_state);
+}
+
+int wellness_state_load(const void *p_buf, uint32_t len) {
+	if (!p_buf || len != sizeof(g_state)) return -1;
+	memcpy(&g_state, p_buf, sizeof(g_state));
+	// Engine tables and the LED hook are addresses in this image, not the saver's
+	if (g_state.fusion_ready) {
+		ppg_fusion_relink(&g_state.fusion, g_led_fn);
+	}
+	return 0;
+}
+
 // Legacy entry point kept for compatibility; does nothing in this implementation.
-void wellness_process(void) {}
\ No newline at end of file
+void wellness_process(void) {}
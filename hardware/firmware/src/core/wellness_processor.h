@@ -1,20 +1,58 @@
 // wellness_processor.h
-// Lightweight PPG peak detector (100Hz) producing RR intervals in milliseconds.
-// Implements a simplified Pan-Tompkins style pipeline: DC removal -> derivative ->
-// squaring -> moving integration -> adaptive threshold with refractory guard.
+// PPG beat detection (100Hz) producing RR intervals in milliseconds.
+// The detector engine is selectable at runtime (see peak_detector.h); the
+// default is the slope sum function (PPG_DETECTOR_DEFAULT). Multi-channel
+// frames (green + IR) run one detector per channel and are fused by signal
+// quality (see ppg_fusion.h).
 
 #include <stdint.h>
+#include <stdbool.h>
 
 // Process a single PPG sample. Returns 1 when a new RR interval is produced and
 // writes it (ms) to out_rr_ms. Returns 0 otherwise.
 int wellness_process_sample(float sample, uint32_t timestamp_ms, float *out_rr_ms);
 
+// Process a block of evenly spaced PPG samples (samples[0] at t0_ms). Returns
+// the number of RR intervals pushed to the ring buffer.
+int wellness_process_block(const float *samples, uint16_t count, uint32_t t0_ms, uint16_t period_ms);
+
+// Process a block of interleaved multi-channel frames ([ch0, ch1, ch0, ...]).
+// Changing n_channels restarts detection. Returns the number of RR intervals
+// pushed to the ring buffer.
+int wellness_process_frames(const float *frames, uint16_t n_frames, uint8_t n_channels,
+                            uint32_t t0_ms, uint16_t period_ms);
+
+// Register the LED enable hook used to switch off a channel's LED while
+// another channel is clearly sufficient (NULL keeps all LEDs on).
+void wellness_set_led_callback(void (*led_fn)(uint8_t channel, bool enabled));
+
+// Channel currently providing beats (0 = green / single channel).
+uint8_t wellness_get_ppg_channel(void);
+
 // Pop the next available RR interval (ms) from the ring buffer. Returns 1 if a
 // value was read, 0 if the buffer is empty.
 int wellness_pop_rr(float *out_rr_ms);
 
+// Same, in integer microseconds (no float conversion on the beat path).
+int wellness_pop_rr_us(uint32_t *out_rr_us);
+
+// Select the peak detector engine (peak_detector_id_t). Detector state is
+// restarted; buffered RR intervals are kept. Returns 0 on success, -1 if the
+// ID is unknown.
+int wellness_set_detector(uint8_t detector_id);
+
+// Currently selected peak detector engine.
+uint8_t wellness_get_detector(void);
+
 // Reset detector state (clears buffers, thresholds, timers).
 void wellness_reset(void);
 
+// Checkpoint support (see system/checkpoint.h). Save copies the detector,
+// fusion and RR ring state to p_buf when it fits in cap and returns its size
+// (p_buf NULL queries the size). Load returns 0, or -1 if len does not match
+// this build; the LED hook registered here is kept.
+uint32_t wellness_state_save(void *p_buf, uint32_t cap);
+int wellness_state_load(const void *p_buf, uint32_t len);
+
 // Legacy entry point (no-op placeholder to keep compatibility if needed).
-void wellness_process(void);
\ No newline at end of file
+void wellness_process(void);
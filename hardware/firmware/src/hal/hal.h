@@ -0,0 +1,103 @@
+/**
+ * @file hal.h
+ * @brief Neural Load Ring Hardware Abstraction Layer
+ *
+ * One set of hardware primitives (PWM, ADC, GPIO and pin interrupts, RTC,
+ * IRQ masking, idle, flash, serial bus start) shared by every driver. The backend is picked at compile
+ * time and every primitive is a static inline function, so on target a call
+ * such as hal_pwm_set(HAL_PWM_MOTOR, d) compiles straight to the register
+ * write - no function pointers, no extra translation unit.
+ *
+ * Backends:
+ *   HAL_BACKEND_NRF52      nRF52833 peripherals (default on target)
+ *   HAL_BACKEND_HOST_SIM   Host simulator: outputs drive a plant model,
+ *                          ADC samples come from it (see hal_sim.h)
+ *   HAL_BACKEND_RECORDER   Unit tests: outputs are recorded, inputs are
+ *                          set by the test (default with HOST_TEST)
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef HAL_H
+#define HAL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+ * BOARD PIN MAP (match schematic main_board_v1.kicad_sch / system_init.c)
+ ******************************************************************************/
+
+#define HAL_PIN_PPG_CS          14      /**< P0.14 */
+#define HAL_PIN_PPG_INT         15      /**< P0.15 */
+#define HAL_PIN_MOTOR_IN1       20      /**< P0.20 - PWM */
+#define HAL_PIN_MOTOR_NSLEEP    22      /**< P0.22 - DRV8837 enable */
+#define HAL_PIN_THERMAL_PWM     23      /**< P0.23 - heater MOSFET gate */
+#define HAL_PIN_CHG_INT         28      /**< P0.28 */
+#define HAL_PIN_LED_STATUS      30      /**< P0.30 */
+#define HAL_PIN_COUNT           48U
+
+/*******************************************************************************
+ * TYPES
+ ******************************************************************************/
+
+/** PWM outputs (one nRF52 PWM instance each) */
+typedef enum {
+    HAL_PWM_MOTOR = 0,          /**< PWM0, 200 Hz, DRV8837 IN1 */
+    HAL_PWM_HEATER,             /**< PWM1, 1 kHz, heater MOSFET */
+    HAL_PWM_COUNT
+} hal_pwm_t;
+
+/** SAADC channels */
+typedef enum {
+    HAL_ADC_NTC = 0,            /**< AIN0 (P0.02), skin NTC divider */
+    HAL_ADC_COUNT
+} hal_adc_t;
+
+/** Serial buses (EasyDMA peripherals) */
+typedef enum {
+    HAL_BUS_SPIM0 = 0,
+    HAL_BUS_TWIM0,
+    HAL_BUS_COUNT
+} hal_bus_t;
+
+/** Pin interrupt handler (falling edge, interrupt context) */
+typedef void (*hal_gpio_irq_fn_t)(void);
+
+#define HAL_ADC_MAX             4095U       /**< 12-bit SAADC */
+#define HAL_RTC_HZ              32768U      /**< RTC1 tick rate */
+#define HAL_RTC_MASK            0x00FFFFFFU /**< RTC COUNTER is 24-bit */
+#define HAL_FLASH_SIZE          0x80000U    /**< nRF52833: 512 kB */
+#define HAL_FLASH_PAGE_SIZE     4096U
+
+/*******************************************************************************
+ * BACKEND SELECTION
+ ******************************************************************************/
+
+#if !defined(HAL_BACKEND_NRF52) && !defined(HAL_BACKEND_HOST_SIM) && \
+    !defined(HAL_BACKEND_RECORDER)
+#ifdef HOST_TEST
+#define HAL_BACKEND_RECORDER
+#else
+#define HAL_BACKEND_NRF52
+#endif
+#endif
+
+#if defined(HAL_BACKEND_NRF52)
+#include "hal_nrf52.h"
+#elif defined(HAL_BACKEND_HOST_SIM)
+#include "hal_sim.h"
+#else
+#include "hal_recorder.h"
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_H */
@@ -0,0 +1,22 @@
+/**
+ * @file hal_host.c
+ * @brief Neural Load Ring HAL - Host Backend State
+ *
+ * Built only with HAL_BACKEND_HOST_SIM or HAL_BACKEND_RECORDER.
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "hal.h"
+
+hal_host_t g_hal_host;
+
+void hal_host_reset(void)
+{
+    memset(&g_hal_host, 0, sizeof(g_hal_host));
+    for (uint8_t ch = 0; ch < HAL_ADC_COUNT; ch++) {
+        g_hal_host.adc[ch] = (HAL_ADC_MAX + 1U) / 2U;
+    }
+    memset(g_hal_host.flash, 0xFF, sizeof(g_hal_host.flash));
+}
@@ -0,0 +1,192 @@
+/**
+ * @file hal_host.h
+ * @brief Neural Load Ring HAL - State Shared by the Host Backends
+ *
+ * Both host backends (simulator and test recorder) keep the "hardware" in
+ * one struct, g_hal_host, defined in hal_host.c: output levels, input
+ * values, the RTC counter and a RAM image of the whole flash. This header
+ * provides the primitives that behave the same in both; hal_sim.h and
+ * hal_recorder.h add PWM, ADC and bus start.
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef HAL_HOST_H
+#define HAL_HOST_H
+
+#ifndef HAL_H
+#error "Include hal.h instead"
+#endif
+
+#include <string.h>
+
+/*******************************************************************************
+ * HOST STATE
+ ******************************************************************************/
+
+#define HAL_REC_LOG_SIZE        64U
+
+/** Recorded output event kinds */
+typedef enum {
+    HAL_REC_PWM = 1,            /**< id = hal_pwm_t, value = duty % */
+    HAL_REC_GPIO,               /**< id = pin, value = level */
+    HAL_REC_FLASH_WRITE,        /**< value = address */
+    HAL_REC_FLASH_ERASE,        /**< value = address */
+    HAL_REC_BUS,                /**< id = hal_bus_t, value = tx_len << 16 | rx_len */
+} hal_rec_kind_t;
+
+typedef struct {
+    uint8_t kind;
+    uint8_t id;
+    uint32_t value;
+} hal_rec_event_t;
+
+typedef struct {
+    /* Outputs */
+    uint8_t pwm_duty[HAL_PWM_COUNT];
+    uint32_t pwm_writes[HAL_PWM_COUNT];
+    uint64_t gpio_out;                  /**< Bit per pin */
+    uint32_t bus_starts[HAL_BUS_COUNT];
+    uint32_t flash_writes;
+    uint32_t flash_erases;
+    uint32_t flash_cut_erases;          /**< Nonzero: power is cut after this many more erases */
+    bool flash_cut;                     /**< Power cut: flash writes and erases are lost */
+
+    /* Inputs */
+    uint16_t adc[HAL_ADC_COUNT];
+    uint64_t gpio_in;
+    uint32_t rtc_ticks;
+    hal_gpio_irq_fn_t gpio_irq[HAL_PIN_COUNT];
+
+    /* Output history (ring) */
+    hal_rec_event_t log[HAL_REC_LOG_SIZE];
+    uint32_t log_count;                 /**< Total events (may exceed size) */
+
+    uint8_t flash[HAL_FLASH_SIZE];
+} hal_host_t;
+
+extern hal_host_t g_hal_host;
+
+/**
+ * Power-on state: outputs low, ADC mid-scale, flash erased
+ */
+void hal_host_reset(void);
+
+static inline void hal_rec_push(hal_rec_kind_t kind, uint8_t id, uint32_t value)
+{
+    hal_rec_event_t *e = &g_hal_host.log[g_hal_host.log_count % HAL_REC_LOG_SIZE];
+    e->kind = (uint8_t)kind;
+    e->id = id;
+    e->value = value;
+    g_hal_host.log_count++;
+}
+
+/*******************************************************************************
+ * GPIO
+ ******************************************************************************/
+
+static inline void hal_gpio_output(uint8_t pin)
+{
+    (void)pin;
+}
+
+static inline void hal_gpio_write(uint8_t pin, bool level)
+{
+    if (pin >= HAL_PIN_COUNT) return;
+    if (level) {
+        g_hal_host.gpio_out |= (1ULL << pin);
+    } else {
+        g_hal_host.gpio_out &= ~(1ULL << pin);
+    }
+    hal_rec_push(HAL_REC_GPIO, pin, level ? 1U : 0U);
+}
+
+static inline bool hal_gpio_read(uint8_t pin)
+{
+    return (pin < HAL_PIN_COUNT) && ((g_hal_host.gpio_in >> pin) & 1U);
+}
+
+static inline void hal_gpio_irq_enable(uint8_t pin, hal_gpio_irq_fn_t handler)
+{
+    if (pin < HAL_PIN_COUNT) {
+        g_hal_host.gpio_irq[pin] = handler;
+    }
+}
+
+/** Play a falling edge on an input pin; false if no handler is attached */
+static inline bool hal_host_gpio_fire(uint8_t pin)
+{
+    if (pin >= HAL_PIN_COUNT || !g_hal_host.gpio_irq[pin]) return false;
+    g_hal_host.gpio_irq[pin]();
+    return true;
+}
+
+/** Level last written to an output pin */
+static inline bool hal_host_gpio_out(uint8_t pin)
+{
+    return (pin < HAL_PIN_COUNT) && ((g_hal_host.gpio_out >> pin) & 1U);
+}
+
+/*******************************************************************************
+ * TIME / INTERRUPTS
+ ******************************************************************************/
+
+static inline uint32_t hal_rtc_ticks(void)
+{
+    return g_hal_host.rtc_ticks & HAL_RTC_MASK;
+}
+
+/** Move the RTC to an absolute time (wraps like the 24-bit counter) */
+static inline void hal_host_set_time_ms(uint32_t ms)
+{
+    g_hal_host.rtc_ticks = (uint32_t)(((uint64_t)ms * HAL_RTC_HZ) / 1000U) & HAL_RTC_MASK;
+}
+
+static inline uint32_t hal_irq_lock(void)
+{
+    return 0;
+}
+
+static inline void hal_irq_unlock(uint32_t key)
+{
+    (void)key;
+}
+
+/*******************************************************************************
+ * FLASH
+ ******************************************************************************/
+
+static inline const uint8_t *hal_flash_ptr(uint32_t addr)
+{
+    return &g_hal_host.flash[addr % HAL_FLASH_SIZE];
+}
+
+/** Programming can only clear bits, like NVMC */
+static inline void hal_flash_write_words(uint32_t addr, const uint32_t *p_words, uint16_t count)
+{
+    if (g_hal_host.flash_cut) return;
+    for (uint16_t i = 0; i < count; i++) {
+        uint32_t w;
+        uint32_t a = (addr + 4U * i) % HAL_FLASH_SIZE;
+        memcpy(&w, &g_hal_host.flash[a], 4);
+        w &= p_words[i];
+        memcpy(&g_hal_host.flash[a], &w, 4);
+    }
+    g_hal_host.flash_writes++;
+    hal_rec_push(HAL_REC_FLASH_WRITE, 0, addr);
+}
+
+static inline void hal_flash_erase_page(uint32_t addr)
+{
+    uint32_t page = (addr % HAL_FLASH_SIZE) & ~(HAL_FLASH_PAGE_SIZE - 1U);
+    if (g_hal_host.flash_cut) return;
+    memset(&g_hal_host.flash[page], 0xFF, HAL_FLASH_PAGE_SIZE);
+    g_hal_host.flash_erases++;
+    hal_rec_push(HAL_REC_FLASH_ERASE, 0, page);
+    if (g_hal_host.flash_cut_erases != 0U && --g_hal_host.flash_cut_erases == 0U) {
+        g_hal_host.flash_cut = true;
+    }
+}
+
+#endif /* HAL_HOST_H */
@@ -0,0 +1,272 @@
+/**
+ * @file hal_nrf52.h
+ * @brief Neural Load Ring HAL - nRF52833 Backend
+ *
+ * Included through hal.h only. Peripheral handles are owned by the modules
+ * that take their interrupts (m_pwm[] by system_init.c, m_spim / m_twim by
+ * bus_manager.c); the register-level bodies are kept as nRF SDK examples
+ * until the SDK is wired into the build.
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef HAL_NRF52_H
+#define HAL_NRF52_H
+
+#ifndef HAL_H
+#error "Include hal.h instead"
+#endif
+
+/*******************************************************************************
+ * PWM
+ ******************************************************************************/
+
+/**
+ * Configure a PWM instance
+ *   HAL_PWM_MOTOR:  PWM0, 200 Hz (optimal for LRA), P0.20
+ *   HAL_PWM_HEATER: PWM1, 1 kHz, P0.23, active high (MOSFET gate)
+ */
+static inline void hal_pwm_init(hal_pwm_t pwm)
+{
+    /*
+     * Example (nRF SDK):
+     *   nrf_drv_pwm_config_t config = {
+     *       .output_pins = { pin, NRF_DRV_PWM_PIN_NOT_USED, ... },
+     *       .base_clock = NRF_PWM_CLK_1MHz,
+     *       .count_mode = NRF_PWM_MODE_UP,
+     *       .top_value = (pwm == HAL_PWM_MOTOR) ? 5000 : 1000,
+     *       .load_mode = NRF_PWM_LOAD_INDIVIDUAL,
+     *   };
+     *   nrf_drv_pwm_init(&m_pwm[pwm], &config, NULL);
+     */
+    (void)pwm;
+}
+
+/**
+ * Set duty cycle (0-100 %)
+ */
+static inline void hal_pwm_set(hal_pwm_t pwm, uint8_t duty_pct)
+{
+    /*
+     * Example (nRF SDK):
+     *   m_pwm_values[pwm].channel_0 = (duty_pct * m_pwm_top[pwm]) / 100;
+     *   nrf_drv_pwm_simple_playback(&m_pwm[pwm], &m_pwm_seq[pwm], 1,
+     *                               NRF_DRV_PWM_FLAG_LOOP);
+     */
+    (void)pwm;
+    (void)duty_pct;
+}
+
+/*******************************************************************************
+ * ADC
+ ******************************************************************************/
+
+/**
+ * Configure a SAADC channel: 12-bit, internal 0.6 V reference with 1/6
+ * gain (3.6 V full scale), 10 us acquisition
+ */
+static inline void hal_adc_init(hal_adc_t ch)
+{
+    /*
+     * Example (nRF SDK):
+     *   nrf_drv_saadc_config_t saadc_config = NRFX_SAADC_DEFAULT_CONFIG;
+     *   nrf_drv_saadc_init(&saadc_config, saadc_event_handler);
+     *
+     *   nrf_saadc_channel_config_t channel_config =
+     *       NRFX_SAADC_DEFAULT_CHANNEL_CONFIG_SE(NRF_SAADC_INPUT_AIN0);
+     *   nrf_drv_saadc_channel_init(ch, &channel_config);
+     */
+    (void)ch;
+}
+
+/**
+ * Blocking single conversion, 0..HAL_ADC_MAX
+ */
+static inline uint16_t hal_adc_read(hal_adc_t ch)
+{
+    /*
+     * Example (nRF SDK):
+     *   nrf_saadc_value_t value;
+     *   nrf_drv_saadc_sample_convert(ch, &value);
+     *   return (value < 0) ? 0 : (uint16_t)value;
+     */
+    (void)ch;
+    return 2048;    /* Placeholder: mid-scale (~25 C with the NTC divider) */
+}
+
+/*******************************************************************************
+ * GPIO
+ ******************************************************************************/
+
+static inline void hal_gpio_output(uint8_t pin)
+{
+    /* nrf_gpio_cfg_output(pin); */
+    (void)pin;
+}
+
+static inline void hal_gpio_write(uint8_t pin, bool level)
+{
+    /* nrf_gpio_pin_write(pin, level ? 1 : 0); */
+    (void)pin;
+    (void)level;
+}
+
+static inline bool hal_gpio_read(uint8_t pin)
+{
+    /* return nrf_gpio_pin_read(pin) != 0; */
+    (void)pin;
+    return false;
+}
+
+/**
+ * Falling-edge interrupt with pull-up (GPIOTE IN event)
+ */
+static inline void hal_gpio_irq_enable(uint8_t pin, hal_gpio_irq_fn_t handler)
+{
+    /*
+     * Example (nrfx):
+     *   nrfx_gpiote_in_config_t in = NRFX_GPIOTE_CONFIG_IN_SENSE_HITOLO(true);
+     *   in.pull = NRF_GPIO_PIN_PULLUP;
+     *   nrfx_gpiote_in_init(pin, &in, gpiote_evt_handler);
+     *   nrfx_gpiote_in_event_enable(pin, true);
+     *
+     * where gpiote_evt_handler() looks the pin up and calls handler.
+     */
+    (void)pin;
+    (void)handler;
+}
+
+/*******************************************************************************
+ * TIME / INTERRUPTS
+ ******************************************************************************/
+
+/**
+ * RTC1 COUNTER (24-bit, HAL_RTC_HZ, shared with app_timer)
+ */
+static inline uint32_t hal_rtc_ticks(void)
+{
+    /* return nrf_rtc_counter_get(NRF_RTC1); */
+    return 0;
+}
+
+static inline uint32_t hal_irq_lock(void)
+{
+    /*
+     * Example (CMSIS):
+     *   uint32_t primask = __get_PRIMASK();
+     *   __disable_irq();
+     *   return primask;
+     */
+    return 0;
+}
+
+static inline void hal_irq_unlock(uint32_t key)
+{
+    /* __set_PRIMASK(key); */
+    (void)key;
+}
+
+/**
+ * Sleep until the next main-loop tick; interrupts keep running
+ */
+static inline void hal_sleep_ms(uint32_t ms)
+{
+    /*
+     * Example (app_timer tick sets m_tick_due):
+     *   while (!m_tick_due) { nrf_pwr_mgmt_run(); }
+     *   m_tick_due = false;
+     */
+    (void)ms;
+}
+
+/**
+ * Main loop condition (the firmware never returns from main on target)
+ */
+static inline bool hal_running(void)
+{
+    return true;
+}
+
+/**
+ * Time of the first main-loop pass, loop period period_ms (0 on target)
+ */
+static inline uint32_t hal_loop_start_ms(uint32_t period_ms)
+{
+    (void)period_ms;
+    return 0;
+}
+
+/*******************************************************************************
+ * FLASH
+ ******************************************************************************/
+
+/**
+ * Flash is memory mapped: read in place
+ */
+static inline const uint8_t *hal_flash_ptr(uint32_t addr)
+{
+    return (const uint8_t *)(uintptr_t)addr;
+}
+
+/**
+ * Program words (flash can only clear bits)
+ */
+static inline void hal_flash_write_words(uint32_t addr, const uint32_t *p_words, uint16_t count)
+{
+    /*
+     * Without SoftDevice:
+     *   nrf_nvmc_write_words(addr, p_words, count);
+     *
+     * With SoftDevice enabled use fstorage (sd_flash_write is asynchronous):
+     *   nrf_fstorage_write(&m_fstorage, addr, p_words, count * 4, NULL);
+     *   while (nrf_fstorage_is_busy(&m_fstorage)) { sd_app_evt_wait(); }
+     */
+    (void)addr;
+    (void)p_words;
+    (void)count;
+}
+
+static inline void hal_flash_erase_page(uint32_t addr)
+{
+    /*
+     * nrf_nvmc_page_erase(addr);
+     * (or nrf_fstorage_erase() with SoftDevice)
+     */
+    (void)addr;
+}
+
+/*******************************************************************************
+ * SERIAL BUS
+ ******************************************************************************/
+
+/**
+ * Start one EasyDMA transfer; END is reported by the nrfx handler
+ *
+ * SPIM: full duplex, address is the CS pin (driven by hand).
+ * TWIM: write tx, repeated start, read rx; address is the 7-bit address.
+ */
+static inline void hal_bus_start(hal_bus_t bus, uint8_t address,
+                                 const uint8_t *p_tx, uint16_t tx_len,
+                                 uint8_t *p_rx, uint16_t rx_len)
+{
+    /*
+     * SPIM:
+     *   nrf_gpio_pin_clear(address);
+     *   nrfx_spim_xfer_desc_t d = NRFX_SPIM_XFER_TRX(p_tx, tx_len, p_rx, rx_len);
+     *   nrfx_spim_xfer(&m_spim, &d, 0);
+     *
+     * TWIM:
+     *   nrfx_twim_xfer_desc_t d = NRFX_TWIM_XFER_DESC_TXRX(address,
+     *       (uint8_t *)p_tx, tx_len, p_rx, rx_len);
+     *   nrfx_twim_xfer(&m_twim, &d, 0);
+     */
+    (void)bus;
+    (void)address;
+    (void)p_tx;
+    (void)tx_len;
+    (void)p_rx;
+    (void)rx_len;
+}
+
+#endif /* HAL_NRF52_H */
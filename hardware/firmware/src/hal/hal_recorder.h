@@ -0,0 +1,111 @@
+/**
+ * @file hal_recorder.h
+ * @brief Neural Load Ring HAL - Test Recorder Backend
+ *
+ * Real driver code runs unchanged; every output lands in g_hal_host (level
+ * plus a short event log) and every input is whatever the test put there.
+ * Tests assert on what the hardware would have seen:
+ *
+ *   hal_rec_clear();
+ *   vibration_feature_on(60);
+ *   ASSERT_EQ(60, g_hal_host.pwm_duty[HAL_PWM_MOTOR]);
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef HAL_RECORDER_H
+#define HAL_RECORDER_H
+
+#include "hal_host.h"
+
+/*******************************************************************************
+ * PWM / ADC / IDLE / BUS
+ ******************************************************************************/
+
+static inline void hal_pwm_init(hal_pwm_t pwm)
+{
+    (void)pwm;
+}
+
+static inline void hal_pwm_set(hal_pwm_t pwm, uint8_t duty_pct)
+{
+    g_hal_host.pwm_duty[pwm] = duty_pct;
+    g_hal_host.pwm_writes[pwm]++;
+    hal_rec_push(HAL_REC_PWM, (uint8_t)pwm, duty_pct);
+}
+
+static inline void hal_adc_init(hal_adc_t ch)
+{
+    (void)ch;
+}
+
+static inline uint16_t hal_adc_read(hal_adc_t ch)
+{
+    return g_hal_host.adc[ch];
+}
+
+/** Idle advances the RTC by the requested time */
+static inline void hal_sleep_ms(uint32_t ms)
+{
+    g_hal_host.rtc_ticks = (g_hal_host.rtc_ticks +
+                            (uint32_t)(((uint64_t)ms * HAL_RTC_HZ) / 1000U)) & HAL_RTC_MASK;
+}
+
+static inline bool hal_running(void)
+{
+    return true;
+}
+
+static inline uint32_t hal_loop_start_ms(uint32_t period_ms)
+{
+    (void)period_ms;
+    return 0;
+}
+
+static inline void hal_bus_start(hal_bus_t bus, uint8_t address,
+                                 const uint8_t *p_tx, uint16_t tx_len,
+                                 uint8_t *p_rx, uint16_t rx_len)
+{
+    (void)address;
+    (void)p_tx;
+    (void)p_rx;
+    g_hal_host.bus_starts[bus]++;
+    hal_rec_push(HAL_REC_BUS, (uint8_t)bus, ((uint32_t)tx_len << 16) | rx_len);
+}
+
+/*******************************************************************************
+ * TEST HELPERS
+ ******************************************************************************/
+
+/**
+ * Forget recorded outputs (levels, counters, log); inputs and flash stay
+ */
+static inline void hal_rec_clear(void)
+{
+    memset(g_hal_host.pwm_duty, 0, sizeof(g_hal_host.pwm_duty));
+    memset(g_hal_host.pwm_writes, 0, sizeof(g_hal_host.pwm_writes));
+    memset(g_hal_host.bus_starts, 0, sizeof(g_hal_host.bus_starts));
+    g_hal_host.gpio_out = 0;
+    g_hal_host.flash_writes = 0;
+    g_hal_host.flash_erases = 0;
+    g_hal_host.log_count = 0;
+}
+
+/**
+ * Count recorded events of a kind for one id (within the log window)
+ */
+static inline uint32_t hal_rec_count(hal_rec_kind_t kind, uint8_t id)
+{
+    uint32_t n = 0;
+    uint32_t first = (g_hal_host.log_count > HAL_REC_LOG_SIZE) ?
+                     g_hal_host.log_count - HAL_REC_LOG_SIZE : 0;
+
+    for (uint32_t i = first; i < g_hal_host.log_count; i++) {
+        const hal_rec_event_t *e = &g_hal_host.log[i % HAL_REC_LOG_SIZE];
+        if (e->kind == (uint8_t)kind && e->id == id) n++;
+    }
+    return n;
+}
+
+#endif /* HAL_RECORDER_H */
@@ -0,0 +1,88 @@
+/**
+ * @file hal_sim.h
+ * @brief Neural Load Ring HAL - Host Simulator Backend
+ *
+ * Like the recorder, outputs land in g_hal_host, but the simulator closes
+ * the loop: PWM changes and bus transfers are reported to the plant model
+ * and ADC conversions sample it. The simulator provides the hal_sim_*
+ * hooks below; hal_sleep_ms() hands control to it, so the firmware's idle
+ * is where virtual time passes and the plant and peripherals run.
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef HAL_SIM_H
+#define HAL_SIM_H
+
+#include "hal_host.h"
+
+/*******************************************************************************
+ * PLANT HOOKS (implemented by the simulator)
+ ******************************************************************************/
+
+void hal_sim_pwm_changed(hal_pwm_t pwm, uint8_t duty_pct);
+uint16_t hal_sim_adc_sample(hal_adc_t ch);
+void hal_sim_bus_start(hal_bus_t bus, uint8_t address,
+                       const uint8_t *p_tx, uint16_t tx_len,
+                       uint8_t *p_rx, uint16_t rx_len);
+void hal_sim_sleep_ms(uint32_t ms);
+bool hal_sim_running(void);
+uint32_t hal_sim_loop_start_ms(uint32_t period_ms);
+
+/*******************************************************************************
+ * PWM / ADC / IDLE / BUS
+ ******************************************************************************/
+
+static inline void hal_pwm_init(hal_pwm_t pwm)
+{
+    (void)pwm;
+}
+
+static inline void hal_pwm_set(hal_pwm_t pwm, uint8_t duty_pct)
+{
+    if (g_hal_host.pwm_duty[pwm] != duty_pct) {
+        g_hal_host.pwm_duty[pwm] = duty_pct;
+        hal_sim_pwm_changed(pwm, duty_pct);
+    }
+    g_hal_host.pwm_writes[pwm]++;
+    hal_rec_push(HAL_REC_PWM, (uint8_t)pwm, duty_pct);
+}
+
+static inline void hal_adc_init(hal_adc_t ch)
+{
+    (void)ch;
+}
+
+static inline uint16_t hal_adc_read(hal_adc_t ch)
+{
+    g_hal_host.adc[ch] = hal_sim_adc_sample(ch);
+    return g_hal_host.adc[ch];
+}
+
+static inline void hal_sleep_ms(uint32_t ms)
+{
+    hal_sim_sleep_ms(ms);
+}
+
+static inline bool hal_running(void)
+{
+    return hal_sim_running();
+}
+
+/** Init is done: the simulator may resume a checkpoint, one period after it */
+static inline uint32_t hal_loop_start_ms(uint32_t period_ms)
+{
+    return hal_sim_loop_start_ms(period_ms);
+}
+
+static inline void hal_bus_start(hal_bus_t bus, uint8_t address,
+                                 const uint8_t *p_tx, uint16_t tx_len,
+                                 uint8_t *p_rx, uint16_t rx_len)
+{
+    g_hal_host.bus_starts[bus]++;
+    hal_rec_push(HAL_REC_BUS, (uint8_t)bus, ((uint32_t)tx_len << 16) | rx_len);
+    hal_sim_bus_start(bus, address, p_tx, tx_len, p_rx, rx_len);
+}
+
+#endif /* HAL_SIM_H */
@@ -0,0 +1,164 @@
+/**
+ * @file ppg_capture.c
+ * @brief Neural Load Ring Raw PPG Capture Implementation
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "ppg_capture.h"
+#include <string.h>
+
+#define CAPTURE_COUNT_MIN   (-(int32_t)(1U << (PPG_CODEC_SAMPLE_BITS - 1U)))
+#define CAPTURE_COUNT_MAX   ((int32_t)(1U << (PPG_CODEC_SAMPLE_BITS - 1U)) - 1)
+
+/*******************************************************************************
+ * PRIVATE DATA
+ ******************************************************************************/
+
+static struct {
+    bool active;
+    uint16_t seq;
+
+    /* Block being filled */
+    int32_t block[PPG_CAPTURE_BLOCK_FRAMES * PPG_CHANNELS];
+    uint16_t n;
+    uint32_t t0_ms;
+    uint32_t next_ms;               /**< Expected time of the next frame */
+
+    /* Coded blocks waiting for the link */
+    uint8_t sdu[PPG_CAPTURE_QUEUE][PPG_CAPTURE_SDU_MAX];
+    uint16_t sdu_len[PPG_CAPTURE_QUEUE];
+    uint8_t head;
+    uint8_t count;
+
+    ppg_capture_stats_t stats;
+} m_capture;
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+/** Frame value back to the AFE count it came from (exact for 19-bit counts) */
+static int32_t capture_counts(float value)
+{
+    float counts = value * PPG_ADC_FULL_SCALE;
+
+    if (counts <= (float)CAPTURE_COUNT_MIN) return CAPTURE_COUNT_MIN;
+    if (counts >= (float)CAPTURE_COUNT_MAX) return CAPTURE_COUNT_MAX;
+    return (int32_t)(counts + ((counts >= 0.0f) ? 0.5f : -0.5f));
+}
+
+static void capture_flush(void)
+{
+    if (m_capture.n == 0U) return;
+
+    uint16_t seq = m_capture.seq++;
+    uint16_t frames = m_capture.n;
+    m_capture.n = 0;
+
+    if (m_capture.count >= PPG_CAPTURE_QUEUE) {
+        m_capture.stats.dropped++;
+        return;
+    }
+
+    uint8_t slot = (uint8_t)((m_capture.head + m_capture.count) % PPG_CAPTURE_QUEUE);
+    uint8_t *p = m_capture.sdu[slot];
+    int len = ppg_codec_encode(m_capture.block, frames, (uint8_t)PPG_CHANNELS,
+                               &p[PPG_CAPTURE_HDR_BYTES],
+                               (uint16_t)(PPG_CAPTURE_SDU_MAX - PPG_CAPTURE_HDR_BYTES));
+    if (len < 0) {
+        m_capture.stats.dropped++;
+        return;
+    }
+
+    memcpy(&p[0], &seq, sizeof(seq));
+    memcpy(&p[2], &m_capture.t0_ms, sizeof(m_capture.t0_ms));
+    p[6] = (uint8_t)frames;
+    p[7] = (uint8_t)PPG_CHANNELS;
+    m_capture.sdu_len[slot] = (uint16_t)(PPG_CAPTURE_HDR_BYTES + (uint16_t)len);
+    m_capture.count++;
+
+    m_capture.stats.blocks++;
+    m_capture.stats.coded_bytes += (uint32_t)len;
+}
+
+/*******************************************************************************
+ * PUBLIC API
+ ******************************************************************************/
+
+void ppg_capture_start(void)
+{
+    memset(&m_capture, 0, sizeof(m_capture));
+    m_capture.active = true;
+}
+
+void ppg_capture_stop(void)
+{
+    if (!m_capture.active) return;
+
+    capture_flush();
+    m_capture.active = false;
+}
+
+void ppg_capture_abort(void)
+{
+    m_capture.active = false;
+    m_capture.n = 0;
+    m_capture.count = 0;
+}
+
+bool ppg_capture_active(void)
+{
+    return m_capture.active;
+}
+
+void ppg_capture_frames(const float *p_frames, uint16_t n_frames, uint32_t t0_ms)
+{
+    if (!m_capture.active || p_frames == NULL) return;
+
+    for (uint16_t f = 0; f < n_frames; f++) {
+        uint32_t t_ms = t0_ms + (uint32_t)f * PPG_FRAME_PERIOD_MS;
+
+        /* A block holds one uninterrupted run of frames */
+        if (m_capture.n > 0U && t_ms != m_capture.next_ms) {
+            capture_flush();
+        }
+        if (m_capture.n == 0U) {
+            m_capture.t0_ms = t_ms;
+        }
+
+        for (uint8_t c = 0; c < PPG_CHANNELS; c++) {
+            m_capture.block[m_capture.n * PPG_CHANNELS + c] = capture_counts(p_frames[f * PPG_CHANNELS + c]);
+        }
+        m_capture.n++;
+        m_capture.next_ms = t_ms + PPG_FRAME_PERIOD_MS;
+        m_capture.stats.frames++;
+
+        if (m_capture.n >= PPG_CAPTURE_BLOCK_FRAMES) {
+            capture_flush();
+        }
+    }
+}
+
+bool ppg_capture_peek(const uint8_t **pp_sdu, uint16_t *p_len)
+{
+    if (m_capture.count == 0U) return false;
+
+    *pp_sdu = m_capture.sdu[m_capture.head];
+    *p_len = m_capture.sdu_len[m_capture.head];
+    return true;
+}
+
+void ppg_capture_pop(void)
+{
+    if (m_capture.count == 0U) return;
+
+    m_capture.head = (uint8_t)((m_capture.head + 1U) % PPG_CAPTURE_QUEUE);
+    m_capture.count--;
+}
+
+void ppg_capture_get_stats(ppg_capture_stats_t *p_stats)
+{
+    *p_stats = m_capture.stats;
+}
@@ -0,0 +1,106 @@
+/**
+ * @file ppg_capture.h
+ * @brief Neural Load Ring Raw PPG Capture (research sessions)
+ *
+ * While a capture runs, ppg_driver hands every frame to ppg_capture_frames()
+ * before beat detection sees it. Frames go back to ADC counts, are cut into
+ * blocks of PPG_CAPTURE_BLOCK_FRAMES consecutive frames, and each block is
+ * coded losslessly (core/ppg_codec.h) into a queued SDU:
+ *
+ *   u16 seq        block number since the capture started (gaps = dropped)
+ *   u32 t0_ms      time of the first frame; frames are PPG_FRAME_PERIOD_MS apart
+ *   u8  frames     frames in the block (short when the frame timeline jumps)
+ *   u8  channels   PPG_CHANNELS (green, IR)
+ *   ...            ppg_codec block
+ *
+ * main.c drains the queue to the bulk channel. Coding happens at most
+ * twice a second in thread context (a few thousand cycles); a queue that
+ * the link cannot keep up with drops whole blocks, never samples inside one.
+ * Stopping codes the partial last block, so a capture keeps its tail.
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef PPG_CAPTURE_H
+#define PPG_CAPTURE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ppg_driver.h"
+#include "../core/ppg_codec.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
+
+#define PPG_CAPTURE_BLOCK_FRAMES    50U     /**< 500 ms per block */
+#define PPG_CAPTURE_QUEUE           8U      /**< Blocks waiting for the link (4 s) */
+#define PPG_CAPTURE_HDR_BYTES       8U
+#define PPG_CAPTURE_SDU_MAX         (PPG_CAPTURE_HDR_BYTES + \
+                                     PPG_CODEC_MAX_BYTES(PPG_CAPTURE_BLOCK_FRAMES, PPG_CHANNELS))
+
+/*******************************************************************************
+ * TYPES
+ ******************************************************************************/
+
+typedef struct {
+    uint32_t blocks;                /**< Blocks coded */
+    uint32_t dropped;               /**< Blocks lost to a full queue */
+    uint32_t frames;                /**< Frames captured */
+    uint32_t coded_bytes;           /**< Codec output, headers excluded */
+} ppg_capture_stats_t;
+
+/*******************************************************************************
+ * PUBLIC API
+ ******************************************************************************/
+
+/**
+ * @brief Start a capture (restarts block numbering, clears the stats)
+ */
+void ppg_capture_start(void);
+
+/**
+ * @brief Stop the capture
+ *
+ * The partial block is coded and queued (short frames count); queued SDUs
+ * stay until popped, so the tail still goes out.
+ */
+void ppg_capture_stop(void);
+
+/**
+ * @brief Stop the capture and discard everything not yet sent (link gone)
+ */
+void ppg_capture_abort(void);
+
+bool ppg_capture_active(void);
+
+/**
+ * @brief Capture frames (called by ppg_driver)
+ *
+ * @param p_frames  n_frames * PPG_CHANNELS values, counts / PPG_ADC_FULL_SCALE
+ * @param n_frames  Frames
+ * @param t0_ms     Time of the first frame; the rest follow PPG_FRAME_PERIOD_MS apart
+ */
+void ppg_capture_frames(const float *p_frames, uint16_t n_frames, uint32_t t0_ms);
+
+/**
+ * @brief Oldest queued SDU payload (stream byte not included)
+ *
+ * @return true if one is waiting; it stays queued until ppg_capture_pop()
+ */
+bool ppg_capture_peek(const uint8_t **pp_sdu, uint16_t *p_len);
+
+void ppg_capture_pop(void);
+
+void ppg_capture_get_stats(ppg_capture_stats_t *p_stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PPG_CAPTURE_H */
@@ -1,16 +1,487 @@
-// ppg_driver.c
+/**
+ * @file ppg_driver.c
+ * @brief Neural Load Ring MAX86141 PPG Acquisition Driver Implementation
+ *
+ * Data path (target):
+ *
+ *   AFE FIFO --PPG_INT--> ppg_afe_irq_handler()   [GPIOTE ISR]
+ *                           - timestamp block from RTC1
+ *                           - submit high-priority FIFO read into rx[dma_idx]
+ *            --SPIM END--> ppg_fifo_done()         [bus_manager, SPIM ISR]
+ *                           - mark rx[dma_idx] ready, flip to the other buffer
+ *   main loop -----------> ppg_process()          [thread]
+ *                           - decode 19-bit samples, rebuild frame times
+ *                           - ppg_capture_frames() while a capture runs
+ *                           - wellness_process_frames()
+ *
+ * Each ready flag has a single writer per transition (ISR sets, thread
+ * clears), so no critical section is needed between the two contexts.
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
 #include "ppg_driver.h"
+#include "ppg_capture.h"
 #include "../core/wellness_processor.h"
+#include "../system/bus_manager.h"
+#include "../hal/hal.h"
+#include <string.h>
+
+#ifdef HOST_TEST
+#include <stdio.h>
+#endif
+
+/*******************************************************************************
+ * MAX86141 REGISTERS
+ ******************************************************************************/
+
+#define MAX86141_REG_INT_STATUS1    0x00
+#define MAX86141_REG_INT_ENABLE1    0x02
+#define MAX86141_REG_FIFO_DATA      0x08
+#define MAX86141_REG_FIFO_CONFIG1   0x09    /**< FIFO_A_FULL: free slots at INT */
+#define MAX86141_REG_FIFO_CONFIG2   0x0A
+#define MAX86141_REG_SYS_CONTROL    0x0D
+#define MAX86141_REG_PPG_CONFIG1    0x11
+#define MAX86141_REG_PPG_CONFIG2    0x12
+#define MAX86141_REG_LED_SEQ1       0x20
+#define MAX86141_REG_LED1_PA        0x23
+#define MAX86141_REG_LED2_PA        0x24
+
+#define MAX86141_SPI_WRITE          0x00    /**< Second SPI byte: write */
+#define MAX86141_SPI_READ           0x80    /**< Second SPI byte: read */
+#define MAX86141_FIFO_DEPTH         128U    /**< Samples */
+#define MAX86141_TAG_INVALID        0x1EU   /**< Slot read past the FIFO end */
+
+/*******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
+
+
+#define PPG_SAMPLE_BYTES            3U      /**< 5-bit tag + 19-bit count */
+#define PPG_SPI_HDR_BYTES           2U      /**< Register address + R/W byte */
+#define PPG_BLOCK_SAMPLES           (PPG_BLOCK_FRAMES * PPG_CHANNELS)
+#define PPG_RX_BYTES                (PPG_SPI_HDR_BYTES + PPG_BLOCK_SAMPLES * PPG_SAMPLE_BYTES)
+#define PPG_LED_PA_DEFAULT          0x20    /**< ~10 mA drive */
+
+
+/*******************************************************************************
+ * PRIVATE DATA
+ ******************************************************************************/
+
+static struct {
+    /* Ping-pong EasyDMA targets (must live in RAM) */
+    uint8_t rx[2][PPG_RX_BYTES];
+    volatile uint32_t block_ms[2];  /**< RTC time at PPG_INT = last frame time */
+    volatile bool ready[2];         /**< Set by SPIM ISR, cleared by thread */
+    volatile uint8_t dma_idx;       /**< Buffer the next transfer targets */
+    volatile uint32_t overruns;
+    uint8_t proc_idx;               /**< Next buffer the thread consumes */
+
+    /* RTC1 extension to 32-bit ms */
+    uint32_t rtc_last;
+    uint32_t rtc_wraps;
+
+    /* Frame timeline continuity */
+    uint32_t last_frame_ms;
+    bool have_last_frame;
+
+    /* Bus transfers (descriptors and tx must stay put until done) */
+    bus_xfer_t fifo_xfer;
+    bus_xfer_t led_xfer[PPG_CHANNELS];
+    uint8_t led_tx[PPG_CHANNELS][3];
+    uint8_t led_pa[PPG_CHANNELS];
+    bool led_on[PPG_CHANNELS];
+
+#ifdef HOST_TEST
+    FILE *replay;
+    float pending[PPG_CHANNELS];
+    uint32_t pending_ms;
+    uint8_t replay_channels;
+    bool pending_valid;
+#endif
+} m_ppg;
+
+static float m_frames[PPG_BLOCK_SAMPLES];
+
+/** Register writes at init: reset, configure, leave shutdown */
+static const uint8_t PPG_INIT_SEQ[][3] = {
+    { MAX86141_REG_SYS_CONTROL,  MAX86141_SPI_WRITE, 0x01 },    /* Reset */
+    { MAX86141_REG_SYS_CONTROL,  MAX86141_SPI_WRITE, 0x02 },    /* Shutdown */
+    { MAX86141_REG_PPG_CONFIG1,  MAX86141_SPI_WRITE, 0x03 },    /* 117 us integration */
+    { MAX86141_REG_PPG_CONFIG2,  MAX86141_SPI_WRITE, 0x18 },    /* 100 sps */
+    { MAX86141_REG_LED_SEQ1,     MAX86141_SPI_WRITE, 0x21 },    /* LEDC1 green, LEDC2 IR */
+    { MAX86141_REG_LED1_PA,      MAX86141_SPI_WRITE, PPG_LED_PA_DEFAULT },
+    { MAX86141_REG_LED2_PA,      MAX86141_SPI_WRITE, PPG_LED_PA_DEFAULT },
+    /* A_FULL when PPG_BLOCK_SAMPLES are waiting; clear on FIFO read */
+    { MAX86141_REG_FIFO_CONFIG1, MAX86141_SPI_WRITE,
+      (uint8_t)(MAX86141_FIFO_DEPTH - PPG_BLOCK_SAMPLES) },
+    { MAX86141_REG_FIFO_CONFIG2, MAX86141_SPI_WRITE, 0x0A },
+    { MAX86141_REG_INT_ENABLE1,  MAX86141_SPI_WRITE, 0x80 },    /* A_FULL_EN */
+    { MAX86141_REG_SYS_CONTROL,  MAX86141_SPI_WRITE, 0x04 },    /* Run */
+};
+
+#define PPG_INIT_STEPS  (sizeof(PPG_INIT_SEQ) / sizeof(PPG_INIT_SEQ[0]))
+
+static const uint8_t PPG_FIFO_READ_CMD[PPG_SPI_HDR_BYTES] = {
+    MAX86141_REG_FIFO_DATA, MAX86141_SPI_READ
+};
+
+static bus_xfer_t m_init_xfer[PPG_INIT_STEPS];
+
+/*******************************************************************************
+ * HARDWARE ABSTRACTION
+ ******************************************************************************/
+
+/**
+ * Enable/disable the LED feeding a channel. Called by the fusion stage to
+ * save LED current while the other channel is clearly sufficient. The LED
+ * sequence (0x20/0x21) is left alone so frames stay interleaved; only the
+ * drive current is zeroed.
+ */
+static void ppg_led_submit(uint8_t channel)
+{
+    m_ppg.led_tx[channel][2] = m_ppg.led_on[channel] ? m_ppg.led_pa[channel] : 0x00;
+    (void)bus_submit(&m_ppg.led_xfer[channel]);
+}
+
+/** The request may have changed while the write was queued or on the wire */
+static void ppg_led_done(bus_xfer_t *p_xfer, int result)
+{
+    (void)result;
+    uint8_t channel = (uint8_t)(p_xfer - m_ppg.led_xfer);
+    uint8_t want = m_ppg.led_on[channel] ? m_ppg.led_pa[channel] : 0x00;
+
+    if (m_ppg.led_tx[channel][2] != want) {
+        ppg_led_submit(channel);
+    }
+}
+
+static void hw_led_enable(uint8_t channel, bool enabled)
+{
+    if (channel >= PPG_CHANNELS) return;
+
+    m_ppg.led_on[channel] = enabled;
+    if (m_ppg.led_xfer[channel].state == BUS_XFER_IDLE) {
+        ppg_led_submit(channel);
+    }
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+static uint32_t ppg_rtc_now_ms(void)
+{
+    uint32_t ticks = hal_rtc_ticks() & HAL_RTC_MASK;
+
+    if (ticks < m_ppg.rtc_last) {
+        m_ppg.rtc_wraps++;
+    }
+    m_ppg.rtc_last = ticks;
+
+    uint64_t total = ((uint64_t)m_ppg.rtc_wraps << 24) | ticks;
+    return (uint32_t)((total * 1000U + HAL_RTC_HZ / 2U) / HAL_RTC_HZ);
+}
+
+/**
+ * Decode raw FIFO bytes into interleaved float frames.
+ * Tags 1..PPG_CHANNELS are LEDC1..LEDCn; anything else (invalid slot, ambient,
+ * proximity) is skipped. A frame counts once its last channel arrives.
+ *
+ * @return Number of complete frames written to p_frames
+ */
+static uint16_t ppg_decode_fifo(const uint8_t *p_raw, uint16_t n_samples, float *p_frames)
+{
+    uint16_t n_frames = 0;
+
+    for (uint16_t i = 0; i < n_samples; i++) {
+        const uint8_t *s = &p_raw[i * PPG_SAMPLE_BYTES];
+        uint8_t tag = (uint8_t)(s[0] >> 3);
+        uint32_t count = ((uint32_t)(s[0] & 0x07U) << 16) |
+                         ((uint32_t)s[1] << 8) | s[2];
+
+        if (tag == 0U || tag > PPG_CHANNELS) continue;
+
+        p_frames[n_frames * PPG_CHANNELS + (tag - 1U)] = (float)count / PPG_ADC_FULL_SCALE;
+        if (tag == PPG_CHANNELS) {
+            n_frames++;
+        }
+    }
+
+    return n_frames;
+}
+
+/**
+ * Rebuild per-frame times for a block that ended at last_ms and hand it over.
+ * The AFE paces frames on its own clock, so the block is laid out backwards
+ * from the interrupt time; ISR latency jitter is absorbed by never starting
+ * a block before one period after the previous block's last frame.
+ */
+static void ppg_deliver(const float *p_frames, uint16_t n_frames, uint32_t last_ms)
+{
+    if (n_frames == 0U) return;
+
+    uint32_t span = (uint32_t)(n_frames - 1U) * PPG_FRAME_PERIOD_MS;
+    uint32_t t0 = last_ms - span;
+
+    if (m_ppg.have_last_frame &&
+        (int32_t)(t0 - m_ppg.last_frame_ms) < (int32_t)PPG_FRAME_PERIOD_MS) {
+        t0 = m_ppg.last_frame_ms + PPG_FRAME_PERIOD_MS;
+    }
+
+    if (ppg_capture_active()) {
+        ppg_capture_frames(p_frames, n_frames, t0);
+    }
+    (void)wellness_process_frames(p_frames, n_frames, (uint8_t)PPG_CHANNELS,
+                                  t0, PPG_FRAME_PERIOD_MS);
+    m_ppg.last_frame_ms = t0 + span;
+    m_ppg.have_last_frame = true;
+}
+
+/*******************************************************************************
+ * INTERRUPT HANDLERS
+ ******************************************************************************/
+
+/**
+ * PPG_INT (GPIOTE, falling edge): FIFO reached the watermark
+ */
+static void ppg_afe_irq_handler(void)
+{
+    uint32_t now_ms = ppg_rtc_now_ms();
+    uint8_t idx = m_ppg.dma_idx;
+
+    /* Thread still owns this buffer: drop the block, the AFE keeps sampling */
+    if (m_ppg.fifo_xfer.state != BUS_XFER_IDLE || m_ppg.ready[idx]) {
+        m_ppg.overruns++;
+        return;
+    }
+
+    m_ppg.block_ms[idx] = now_ms;
+    m_ppg.fifo_xfer.p_rx = m_ppg.rx[idx];
+    (void)bus_submit(&m_ppg.fifo_xfer);
+}
+
+/**
+ * FIFO read complete: the block is in RAM
+ */
+static void ppg_fifo_done(bus_xfer_t *p_xfer, int result)
+{
+    (void)p_xfer;
+    uint8_t idx = m_ppg.dma_idx;
 
-void ppg_init(void) {}
+    if (result != 0) {
+        m_ppg.overruns++;
+        return;
+    }
 
-// Ingest a single PPG sample and forward to the peak detector
-void ppg_on_sample(float sample, uint32_t timestamp_ms) {
-	float rr_ms = 0.0f;
-	(void)wellness_process_sample(sample, timestamp_ms, &rr_ms);
+    m_ppg.ready[idx] = true;
+    m_ppg.dma_idx = (uint8_t)(idx ^ 1U);
 }
 
-// Retrieve next RR interval (ms) from detector buffer
-int ppg_get_rr(float *out_rr_ms) {
-	return wellness_pop_rr(out_rr_ms);
-}
\ No newline at end of file
+/*******************************************************************************
+ * HOST REPLAY BACKEND
+ ******************************************************************************/
+
+#ifdef HOST_TEST
+
+static bool ppg_replay_read_line(void)
+{
+    char line[128];
+
+    while (m_ppg.replay && fgets(line, sizeof(line), m_ppg.replay)) {
+        unsigned int t;
+        float ch[PPG_CHANNELS] = {0};
+        int n = sscanf(line, "%u %f %f", &t, &ch[0], &ch[1]);
+
+        if (line[0] == '#' || n < 2) continue;
+
+        if (m_ppg.replay_channels == 0U) {
+            m_ppg.replay_channels = (uint8_t)(n - 1);
+        }
+        for (uint8_t c = 0; c < PPG_CHANNELS; c++) {
+            /* Single-column files: mirror green into IR so fusion sees twins */
+            m_ppg.pending[c] = (c < m_ppg.replay_channels) ? ch[c] : ch[0];
+        }
+        m_ppg.pending_ms = (uint32_t)t;
+        m_ppg.pending_valid = true;
+        return true;
+    }
+
+    m_ppg.pending_valid = false;
+    return false;
+}
+
+int ppg_replay_open(const char *path)
+{
+    ppg_replay_close();
+
+    m_ppg.replay = path ? fopen(path, "r") : NULL;
+    if (!m_ppg.replay) return -1;
+
+    m_ppg.replay_channels = 0;
+    m_ppg.have_last_frame = false;
+    (void)ppg_replay_read_line();
+    return 0;
+}
+
+void ppg_replay_close(void)
+{
+    if (m_ppg.replay) {
+        fclose(m_ppg.replay);
+        m_ppg.replay = NULL;
+    }
+    m_ppg.pending_valid = false;
+}
+
+int ppg_replay_seek(uint32_t after_ms)
+{
+    if (!m_ppg.replay) return -1;
+
+    /* Skipped frames count as delivered, so timing continues from them */
+    while (m_ppg.pending_valid && (int32_t)(m_ppg.pending_ms - after_ms) <= 0) {
+        m_ppg.last_frame_ms = m_ppg.pending_ms;
+        m_ppg.have_last_frame = true;
+        (void)ppg_replay_read_line();
+    }
+    return 0;
+}
+
+bool ppg_replay_done(void)
+{
+    return !m_ppg.pending_valid;
+}
+
+static uint16_t ppg_replay_process(uint32_t now_ms)
+{
+    uint16_t total = 0;
+
+    while (m_ppg.pending_valid && (int32_t)(m_ppg.pending_ms - now_ms) <= 0) {
+        uint16_t n = 0;
+        uint32_t t0 = m_ppg.pending_ms;
+
+        /* Blocks as the FIFO would deliver them, timed by the file */
+        while (n < PPG_BLOCK_FRAMES && m_ppg.pending_valid &&
+               (int32_t)(m_ppg.pending_ms - now_ms) <= 0) {
+            memcpy(&m_frames[n * PPG_CHANNELS], m_ppg.pending, sizeof(m_ppg.pending));
+            n++;
+            (void)ppg_replay_read_line();
+        }
+
+        ppg_deliver(m_frames, n, t0 + (uint32_t)(n - 1U) * PPG_FRAME_PERIOD_MS);
+        total = (uint16_t)(total + n);
+    }
+
+    return total;
+}
+
+#endif /* HOST_TEST */
+
+/*******************************************************************************
+ * PUBLIC API
+ ******************************************************************************/
+
+void ppg_init(void)
+{
+    memset(&m_ppg, 0, sizeof(m_ppg));
+
+    m_ppg.fifo_xfer = (bus_xfer_t){
+        .bus = BUS_SPI0,
+        .address = HAL_PIN_PPG_CS,
+        .priority = BUS_PRIO_HIGH,
+        .p_tx = PPG_FIFO_READ_CMD,
+        .tx_len = PPG_SPI_HDR_BYTES,
+        .rx_len = PPG_RX_BYTES,
+        .done = ppg_fifo_done,
+    };
+
+    for (uint8_t c = 0; c < PPG_CHANNELS; c++) {
+        m_ppg.led_pa[c] = PPG_LED_PA_DEFAULT;
+        m_ppg.led_on[c] = true;
+        m_ppg.led_tx[c][0] = (c == 0U) ? MAX86141_REG_LED1_PA : MAX86141_REG_LED2_PA;
+        m_ppg.led_tx[c][1] = MAX86141_SPI_WRITE;
+        m_ppg.led_tx[c][2] = PPG_LED_PA_DEFAULT;
+        m_ppg.led_xfer[c] = (bus_xfer_t){
+            .bus = BUS_SPI0,
+            .address = HAL_PIN_PPG_CS,
+            .priority = BUS_PRIO_NORMAL,
+            .p_tx = m_ppg.led_tx[c],
+            .tx_len = sizeof(m_ppg.led_tx[c]),
+            .done = ppg_led_done,
+        };
+    }
+
+    /* One chain so no other transfer lands mid-configuration */
+    for (uint8_t i = 0; i < PPG_INIT_STEPS; i++) {
+        m_init_xfer[i] = (bus_xfer_t){
+            .bus = BUS_SPI0,
+            .address = HAL_PIN_PPG_CS,
+            .priority = BUS_PRIO_LOW,
+            .p_tx = PPG_INIT_SEQ[i],
+            .tx_len = sizeof(PPG_INIT_SEQ[i]),
+            .next = (i + 1U < PPG_INIT_STEPS) ? &m_init_xfer[i + 1U] : NULL,
+        };
+    }
+    (void)bus_submit(&m_init_xfer[0]);
+
+    hal_gpio_irq_enable(HAL_PIN_PPG_INT, ppg_afe_irq_handler);
+
+    wellness_set_led_callback(hw_led_enable);
+}
+
+uint16_t ppg_process(uint32_t now_ms)
+{
+    uint16_t total = 0;
+
+#ifdef HOST_TEST
+    total = ppg_replay_process(now_ms);
+#else
+    (void)now_ms;
+#endif
+
+    /* Consume in fill order so frame time never runs backwards */
+    for (uint8_t n = 0; n < 2U; n++) {
+        uint8_t idx = m_ppg.proc_idx;
+        if (!m_ppg.ready[idx]) break;
+
+        uint16_t frames = ppg_decode_fifo(&m_ppg.rx[idx][PPG_SPI_HDR_BYTES],
+                                          (uint16_t)PPG_BLOCK_SAMPLES, m_frames);
+        ppg_deliver(m_frames, frames, m_ppg.block_ms[idx]);
+
+        m_ppg.ready[idx] = false;
+        m_ppg.proc_idx = (uint8_t)(idx ^ 1U);
+        total = (uint16_t)(total + frames);
+    }
+
+    return total;
+}
+
+uint32_t ppg_get_overruns(void)
+{
+    return m_ppg.overruns;
+}
+
+void ppg_on_sample(float sample, uint32_t timestamp_ms)
+{
+    float rr_ms = 0.0f;
+    (void)wellness_process_sample(sample, timestamp_ms, &rr_ms);
+}
+
+void ppg_on_frame(const float *channels, uint32_t timestamp_ms)
+{
+    if (ppg_capture_active()) {
+        ppg_capture_frames(channels, 1U, timestamp_ms);
+    }
+    (void)wellness_process_frames(channels, 1U, (uint8_t)PPG_CHANNELS,
+                                  timestamp_ms, PPG_FRAME_PERIOD_MS);
+}
+
+int ppg_get_rr(float *out_rr_ms)
+{
+    return wellness_pop_rr(out_rr_ms);
+}
+
+int ppg_get_rr_us(uint32_t *out_rr_us)
+{
+    return wellness_pop_rr_us(out_rr_us);
+}
@@ -1,11 +1,115 @@
-// ppg_driver.h
+/**
+ * @file ppg_driver.h
+ * @brief Neural Load Ring MAX86141 PPG Acquisition Driver
+ *
+ * The AFE samples on its own clock into its 128-entry FIFO and raises
+ * PPG_INT when a block of PPG_BLOCK_FRAMES frames (250 ms) is waiting.
+ * The interrupt only timestamps the block from the RTC and starts an SPIM
+ * EasyDMA read into one of two ping-pong buffers; decoding and beat
+ * detection run later in thread context from ppg_process(). The CPU wakes
+ * four times a second instead of once per sample.
+ *
+ * Host builds (HOST_TEST) replace the SPIM backend with a file replay:
+ * ppg_replay_open() a text file with one frame per line,
+ *   <t_ms> <green> [<ir>]
+ * and ppg_process(now_ms) hands over every frame up to now_ms.
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef PPG_DRIVER_H
+#define PPG_DRIVER_H
+
 #include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
 
+#define PPG_CHANNELS            2U      /**< AFE channels per frame (LED1 green, LED2 IR) */
+#define PPG_FRAME_PERIOD_MS     10U     /**< 100 Hz frame rate */
+#define PPG_BLOCK_FRAMES        25U     /**< FIFO watermark: frames per wakeup */
+#define PPG_ADC_FULL_SCALE      524288.0f   /**< 2^19: frame values are counts / full scale */
+
+/*******************************************************************************
+ * PUBLIC API
+ ******************************************************************************/
+
+/**
+ * @brief Configure the AFE, SPIM and PPG_INT and start sampling
+ */
 void ppg_init(void);
 
-// Called by ISR or sampling loop with raw PPG sample (100Hz) and timestamp in ms.
+/**
+ * @brief Hand completed blocks to the detector (thread context)
+ *
+ * Call from the main loop. On target, drains every ping-pong buffer filled
+ * by DMA since the last call. On host, replays frames with t <= now_ms.
+ *
+ * @param now_ms Current time (used by the host replay backend)
+ * @return Number of frames handed over
+ */
+uint16_t ppg_process(uint32_t now_ms);
+
+/**
+ * @brief Blocks dropped because both ping-pong buffers were still full
+ */
+uint32_t ppg_get_overruns(void);
+
+/**
+ * @brief Feed a single PPG sample directly (bypasses the AFE path)
+ */
 void ppg_on_sample(float sample, uint32_t timestamp_ms);
 
-// Pop next RR interval (ms) computed by the PPG peak detector. Returns 1 if a
-// value was read, 0 otherwise.
-int ppg_get_rr(float *out_rr_ms);
\ No newline at end of file
+/**
+ * @brief Feed one multi-channel frame directly (PPG_CHANNELS samples: green, IR)
+ */
+void ppg_on_frame(const float *channels, uint32_t timestamp_ms);
+
+/**
+ * @brief Pop next RR interval (ms) computed by the PPG peak detector
+ * @return 1 if a value was read, 0 otherwise
+ */
+int ppg_get_rr(float *out_rr_ms);
+
+/**
+ * @brief Pop next RR interval in integer microseconds
+ * @return 1 if a value was read, 0 otherwise
+ */
+int ppg_get_rr_us(uint32_t *out_rr_us);
+
+#ifdef HOST_TEST
+/**
+ * @brief Open a replay file for the host backend
+ * @return 0 on success, -1 if the file cannot be opened
+ */
+int ppg_replay_open(const char *path);
+
+/**
+ * @brief Close the replay file
+ */
+void ppg_replay_close(void);
+
+/**
+ * @brief Skip replay frames with t <= after_ms (resuming from a checkpoint)
+ * @return 0 on success, -1 if no file is open
+ */
+int ppg_replay_seek(uint32_t after_ms);
+
+/**
+ * @brief True once the replay file is exhausted (or none is open)
+ */
+bool ppg_replay_done(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PPG_DRIVER_H */
@@ -13,6 +13,7 @@
  */
 
 #include "temperature_sensor.h"
+#include "../hal/hal.h"
 #include <math.h>
 
 /*******************************************************************************
@@ -39,33 +40,6 @@ static struct {
     .last_temp_c = 25,  /* Default room temp */
 };
 
-/*******************************************************************************
- * ADC HARDWARE ABSTRACTION
- ******************************************************************************/
-
-/**
- * Read ADC value from NTC channel (AIN0 = P0.02)
- * Returns 12-bit value (0-4095)
- */
-static uint16_t hw_adc_read(void)
-{
-    /*
-     * nRF52833 SAADC configuration:
-     *   - Resolution: 12-bit
-     *   - Reference: Internal 0.6V with 1/6 gain (3.6V full scale)
-     *   - Acquisition time: 10µs
-     *   - Input: AIN0 (P0.02)
-     *
-     * Example (nRF SDK):
-     *   nrf_saadc_value_t value;
-     *   nrf_drv_saadc_sample_convert(0, &value);
-     *   return (uint16_t)value;
-     */
-    
-    /* Placeholder: return mid-scale (~1.65V = ~25°C with our divider) */
-    return 2048;
-}
-
 /*******************************************************************************
  * TEMPERATURE CALCULATION
  ******************************************************************************/
@@ -112,17 +86,7 @@ static float adc_to_celsius(uint16_t adc_value)
 
 void temperature_init(void)
 {
-    /*
-     * Initialize SAADC for single-channel NTC reading
-     *
-     * Example (nRF SDK):
-     *   nrf_drv_saadc_config_t saadc_config = NRFX_SAADC_DEFAULT_CONFIG;
-     *   nrf_drv_saadc_init(&saadc_config, saadc_event_handler);
-     *
-     *   nrf_saadc_channel_config_t channel_config = 
-     *       NRFX_SAADC_DEFAULT_CHANNEL_CONFIG_SE(NRF_SAADC_INPUT_AIN0);
-     *   nrf_drv_saadc_channel_init(0, &channel_config);
-     */
+    hal_adc_init(HAL_ADC_NTC);
     
     m_temp.sample_count = 0;
     m_temp.sample_sum = 0;
@@ -131,7 +95,7 @@ void temperature_init(void)
 int8_t temperature_read_skin(void)
 {
     /* Read and average multiple samples for noise reduction */
-    uint16_t raw = hw_adc_read();
+    uint16_t raw = hal_adc_read(HAL_ADC_NTC);
     
     /* Simple moving average (4 samples) */
     m_temp.sample_sum += raw;
@@ -0,0 +1,478 @@
+/**
+ * @file bus_manager.c
+ * @brief Neural Load Ring Shared Serial Bus Scheduler Implementation
+ *
+ * Per bus: one intrusive FIFO per priority, the link currently on the wire
+ * and at most one PPI-armed transfer. Scheduling runs whenever the bus may
+ * have gone idle (submit, END interrupt, arm) under a short critical
+ * section; completion callbacks run after it is released.
+ *
+ * Armed transfers: the PPI channel is only enabled while the bus is idle.
+ * Before software uses the bus the channel is disabled and the peripheral
+ * checked for a triggered start; an event that arrives while the channel is
+ * off stays latched in its EVENTS register and is replayed at the next idle.
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "bus_manager.h"
+#include <stddef.h>
+#include <string.h>
+
+#ifdef NRF_SDK_PRESENT
+#include "nrfx_spim.h"
+#include "nrfx_twim.h"
+#include "nrfx_ppi.h"
+#include "nrf_gpio.h"
+#endif
+
+/*******************************************************************************
+ * PRIVATE DATA
+ ******************************************************************************/
+
+typedef struct {
+    bus_xfer_t *head[BUS_PRIO_COUNT];
+    bus_xfer_t *tail[BUS_PRIO_COUNT];
+    bus_xfer_t *active;             /**< Link on the wire (software started) */
+    bus_xfer_t *armed;              /**< Waiting for its PPI trigger */
+    uint32_t event_addr;
+    bool ppi_enabled;
+    bool active_triggered;          /**< Active link was started by the PPI */
+#ifdef HOST_TEST
+    bus_mock_device_fn_t device;
+    const bus_xfer_t *last;
+    uint32_t started;
+    bool event;                     /**< Latched EVENTS register */
+    bool hw_started;                /**< PPI started the armed transfer */
+#endif
+} bus_state_t;
+
+static bus_state_t m_bus[BUS_COUNT];
+
+#ifdef NRF_SDK_PRESENT
+static const nrfx_spim_t m_spim = NRFX_SPIM_INSTANCE(0);
+static const nrfx_twim_t m_twim = NRFX_TWIM_INSTANCE(1);   /* TWIM0 shares its ID with SPIM0 */
+static nrf_ppi_channel_t m_ppi_ch[BUS_COUNT];
+#endif
+
+/*******************************************************************************
+ * HARDWARE ABSTRACTION
+ ******************************************************************************/
+
+/**
+ * Put one link on the wire; END arrives through spim_evt_handler() /
+ * twim_evt_handler(), which release CS (SPIM) and call bus_on_end()
+ */
+static void hw_bus_start(bus_id_t bus, bus_xfer_t *p_xfer)
+{
+    hal_bus_start((hal_bus_t)bus, p_xfer->address, p_xfer->p_tx, p_xfer->tx_len,
+                  p_xfer->p_rx, p_xfer->rx_len);
+#ifdef HOST_TEST
+    m_bus[bus].started++;
+    m_bus[bus].last = p_xfer;
+#endif
+}
+
+/**
+ * Load the armed transfer into the peripheral and route the event to START
+ */
+static void hw_ppi_assign(bus_id_t bus, bus_xfer_t *p_xfer, uint32_t event_addr)
+{
+    (void)bus;
+    (void)p_xfer;
+    (void)event_addr;
+    /*
+     * Example (SPIM; TWIM is the same with nrfx_twim_*):
+     *   nrfx_spim_xfer(&m_spim, &d, NRFX_SPIM_FLAG_HOLD_XFER);
+     *   nrfx_ppi_channel_assign(m_ppi_ch[bus], event_addr,
+     *                           nrfx_spim_start_task_get(&m_spim));
+     */
+}
+
+static void hw_ppi_enable(bus_id_t bus, bool enable)
+{
+    (void)bus;
+    (void)enable;
+    /*
+     * Example (STARTED is cleared first so hw_trigger_started() only sees
+     * a start caused by the PPI):
+     *   if (enable) {
+     *       nrf_spim_event_clear(NRF_SPIM0, NRF_SPIM_EVENT_STARTED);
+     *       nrfx_ppi_channel_enable(m_ppi_ch[bus]);
+     *   } else {
+     *       nrfx_ppi_channel_disable(m_ppi_ch[bus]);
+     *   }
+     */
+}
+
+/** Did the PPI start the armed transfer (peripheral EVENTS_STARTED)? */
+static bool hw_trigger_started(bus_id_t bus)
+{
+    /*
+     * Example:
+     *   return nrf_spim_event_check(NRF_SPIM0, NRF_SPIM_EVENT_STARTED);
+     */
+#ifdef HOST_TEST
+    return m_bus[bus].hw_started;
+#else
+    (void)bus;
+    return false;
+#endif
+}
+
+/** Trigger event latched while the PPI channel was off? */
+static bool hw_event_pending(bus_id_t bus)
+{
+    /*
+     * Example:
+     *   return *(volatile uint32_t *)m_bus[bus].event_addr != 0;
+     */
+#ifdef HOST_TEST
+    return m_bus[bus].event;
+#else
+    (void)bus;
+    return false;
+#endif
+}
+
+static void hw_event_clear(bus_id_t bus)
+{
+    /*
+     * Example:
+     *   *(volatile uint32_t *)m_bus[bus].event_addr = 0;
+     */
+#ifdef HOST_TEST
+    m_bus[bus].event = false;
+    m_bus[bus].hw_started = false;
+#else
+    (void)bus;
+#endif
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+static void bus_start(bus_id_t bus, bus_xfer_t *p_xfer)
+{
+    p_xfer->state = BUS_XFER_ACTIVE;
+    m_bus[bus].active = p_xfer;
+    hw_bus_start(bus, p_xfer);
+}
+
+/**
+ * Take the bus back from the PPI. Returns true if the armed transfer
+ * already went out in hardware (it now counts as active).
+ */
+static bool bus_reclaim(bus_id_t bus)
+{
+    bus_state_t *b = &m_bus[bus];
+
+    if (!b->ppi_enabled) return false;
+
+    hw_ppi_enable(bus, false);
+    b->ppi_enabled = false;
+    if (hw_trigger_started(bus)) {
+        b->active = b->armed;
+        b->armed = NULL;
+        b->active->state = BUS_XFER_ACTIVE;
+        b->active_triggered = true;
+        return true;
+    }
+    return false;
+}
+
+/** Start the armed transfer by hand for a trigger the PPI did not see */
+static void bus_fire_armed(bus_id_t bus)
+{
+    bus_xfer_t *p_xfer = m_bus[bus].armed;
+
+    m_bus[bus].armed = NULL;
+    hw_event_clear(bus);
+    bus_start(bus, p_xfer);
+}
+
+/** Start the next transfer if the bus is free (lock held) */
+static void bus_schedule(bus_id_t bus)
+{
+    bus_state_t *b = &m_bus[bus];
+
+    if (b->active || bus_reclaim(bus)) return;
+
+    /* A trigger that arrived while the bus was busy goes first */
+    if (b->armed && hw_event_pending(bus)) {
+        bus_fire_armed(bus);
+        return;
+    }
+
+    for (uint8_t p = 0; p < BUS_PRIO_COUNT; p++) {
+        bus_xfer_t *p_xfer = b->head[p];
+        if (p_xfer) {
+            b->head[p] = p_xfer->q_next;
+            if (!b->head[p]) b->tail[p] = NULL;
+            p_xfer->q_next = NULL;
+            bus_start(bus, p_xfer);
+            return;
+        }
+    }
+
+    /* Idle: hand the bus to the PPI */
+    if (b->armed) {
+        hw_ppi_enable(bus, true);
+        b->ppi_enabled = true;
+        /* Event latched between the check above and the enable */
+        if (hw_event_pending(bus) && !bus_reclaim(bus)) {
+            bus_fire_armed(bus);
+        }
+    }
+}
+
+static bool bus_xfer_valid(const bus_xfer_t *p_xfer)
+{
+    if (!p_xfer || p_xfer->bus >= BUS_COUNT || p_xfer->priority >= BUS_PRIO_COUNT) {
+        return false;
+    }
+    for (const bus_xfer_t *l = p_xfer; l; l = l->next) {
+        if (l->bus != p_xfer->bus) return false;
+        if (l->tx_len == 0U && l->rx_len == 0U) return false;
+        if ((l->tx_len && !l->p_tx) || (l->rx_len && !l->p_rx)) return false;
+        if (l->state != BUS_XFER_IDLE) return false;
+    }
+    return true;
+}
+
+static void bus_set_chain_state(bus_xfer_t *p_xfer, bus_xfer_state_t state)
+{
+    for (bus_xfer_t *l = p_xfer; l; l = l->next) {
+        l->state = state;
+    }
+}
+
+/*******************************************************************************
+ * BUS EVENT HANDLERS
+ ******************************************************************************/
+
+#ifdef NRF_SDK_PRESENT
+static void spim_evt_handler(nrfx_spim_evt_t const *p_event, void *p_context)
+{
+    const bus_xfer_t *p_xfer = m_bus[BUS_SPI0].active ? m_bus[BUS_SPI0].active : m_bus[BUS_SPI0].armed;
+
+    (void)p_context;
+    /* Software CS: deselect before the next link selects its device */
+    if (p_xfer != NULL) {
+        nrf_gpio_pin_set(p_xfer->address);
+    }
+    bus_on_end(BUS_SPI0, (p_event->type == NRFX_SPIM_EVENT_DONE) ? 0 : -1);
+}
+
+static void twim_evt_handler(nrfx_twim_evt_t const *p_event, void *p_context)
+{
+    (void)p_context;
+    bus_on_end(BUS_I2C0, (p_event->type == NRFX_TWIM_EVT_DONE) ? 0 : -1);
+}
+#endif
+
+/*******************************************************************************
+ * PUBLIC API
+ ******************************************************************************/
+
+void bus_manager_init(void)
+{
+    memset(m_bus, 0, sizeof(m_bus));
+
+#ifdef NRF_SDK_PRESENT
+    /* Pins per system_init.c; CS is driven per transfer (bus_xfer_t.address) */
+    nrfx_spim_config_t spim = NRFX_SPIM_DEFAULT_CONFIG(13, 11, 12, NRFX_SPIM_PIN_NOT_USED);
+    spim.frequency = NRF_SPIM_FREQ_8M;
+    nrfx_spim_init(&m_spim, &spim, spim_evt_handler, NULL);
+
+    nrfx_twim_config_t twim = NRFX_TWIM_DEFAULT_CONFIG(27, 26);
+    twim.frequency = NRF_TWIM_FREQ_400K;
+    nrfx_twim_init(&m_twim, &twim, twim_evt_handler, NULL);
+    nrfx_twim_enable(&m_twim);
+
+    nrfx_ppi_channel_alloc(&m_ppi_ch[BUS_SPI0]);
+    nrfx_ppi_channel_alloc(&m_ppi_ch[BUS_I2C0]);
+#endif
+}
+
+int bus_submit(bus_xfer_t *p_xfer)
+{
+    if (!p_xfer || p_xfer->state != BUS_XFER_IDLE) {
+        return p_xfer ? -2 : -1;
+    }
+    if (!bus_xfer_valid(p_xfer)) return -1;
+
+    bus_state_t *b = &m_bus[p_xfer->bus];
+    uint32_t key = hal_irq_lock();
+
+    bus_set_chain_state(p_xfer, BUS_XFER_QUEUED);
+    p_xfer->q_next = NULL;
+    if (b->tail[p_xfer->priority]) {
+        b->tail[p_xfer->priority]->q_next = p_xfer;
+    } else {
+        b->head[p_xfer->priority] = p_xfer;
+    }
+    b->tail[p_xfer->priority] = p_xfer;
+
+    bus_schedule(p_xfer->bus);
+    hal_irq_unlock(key);
+    return 0;
+}
+
+int bus_arm_on_event(bus_xfer_t *p_xfer, uint32_t event_addr)
+{
+    if (!p_xfer || p_xfer->state != BUS_XFER_IDLE) {
+        return p_xfer ? -2 : -1;
+    }
+    if (!bus_xfer_valid(p_xfer)) return -1;
+
+    bus_state_t *b = &m_bus[p_xfer->bus];
+    uint32_t key = hal_irq_lock();
+
+    if (b->armed) {
+        hal_irq_unlock(key);
+        return -2;
+    }
+
+    bus_set_chain_state(p_xfer, BUS_XFER_ARMED);
+    b->armed = p_xfer;
+    b->event_addr = event_addr;
+    hw_event_clear(p_xfer->bus);
+    hw_ppi_assign(p_xfer->bus, p_xfer, event_addr);
+    bus_schedule(p_xfer->bus);
+
+    hal_irq_unlock(key);
+    return 0;
+}
+
+void bus_disarm(bus_id_t bus)
+{
+    if (bus >= BUS_COUNT) return;
+
+    bus_state_t *b = &m_bus[bus];
+    uint32_t key = hal_irq_lock();
+
+    if (b->armed && !bus_reclaim(bus)) {
+        bus_set_chain_state(b->armed, BUS_XFER_IDLE);
+        b->armed = NULL;
+    }
+    hal_irq_unlock(key);
+}
+
+bool bus_manager_idle(void)
+{
+    for (uint8_t i = 0; i < BUS_COUNT; i++) {
+        if (m_bus[i].active) return false;
+        for (uint8_t p = 0; p < BUS_PRIO_COUNT; p++) {
+            if (m_bus[i].head[p]) return false;
+        }
+    }
+    return true;
+}
+
+void bus_on_end(bus_id_t bus, int result)
+{
+    if (bus >= BUS_COUNT) return;
+
+    bus_state_t *b = &m_bus[bus];
+    uint32_t key = hal_irq_lock();
+
+    bus_xfer_t *p_xfer = b->active;
+    bool triggered = b->active_triggered;
+    if (!p_xfer && b->ppi_enabled && hw_trigger_started(bus)) {
+        /* Triggered transfer ran without the CPU */
+        p_xfer = b->armed;
+        b->armed = NULL;
+        hw_ppi_enable(bus, false);
+        b->ppi_enabled = false;
+        triggered = true;
+    }
+    if (!p_xfer) {
+        hal_irq_unlock(key);
+        return;
+    }
+    if (triggered) {
+        hw_event_clear(bus);
+    }
+
+    b->active = NULL;
+    b->active_triggered = false;
+    p_xfer->state = BUS_XFER_IDLE;
+
+    bus_xfer_t *p_next = p_xfer->next;
+    bus_xfer_t *p_aborted = NULL;
+    if (p_next && result == 0) {
+        bus_start(bus, p_next);     /* Chain keeps the bus */
+    } else {
+        if (p_next) {
+            bus_set_chain_state(p_next, BUS_XFER_IDLE);
+            p_aborted = p_next;
+        }
+        bus_schedule(bus);
+    }
+    hal_irq_unlock(key);
+
+    if (p_xfer->done) p_xfer->done(p_xfer, result);
+    for (bus_xfer_t *l = p_aborted; l; l = l->next) {
+        if (l->done) l->done(l, -3);
+    }
+}
+
+/*******************************************************************************
+ * HOST MOCK
+ ******************************************************************************/
+
+#ifdef HOST_TEST
+
+void bus_mock_set_device(bus_id_t bus, bus_mock_device_fn_t fn)
+{
+    if (bus < BUS_COUNT) m_bus[bus].device = fn;
+}
+
+bool bus_mock_complete(bus_id_t bus)
+{
+    if (bus >= BUS_COUNT) return false;
+
+    bus_state_t *b = &m_bus[bus];
+    const bus_xfer_t *p_xfer = b->active;
+    if (!p_xfer && b->ppi_enabled && b->hw_started) p_xfer = b->armed;
+    if (!p_xfer) return false;
+
+    int result = b->device ? b->device(p_xfer) : 0;
+    bus_on_end(bus, result);
+    return true;
+}
+
+uint16_t bus_mock_drain(bus_id_t bus)
+{
+    uint16_t n = 0;
+    while (bus_mock_complete(bus)) n++;
+    return n;
+}
+
+void bus_mock_trigger(bus_id_t bus)
+{
+    if (bus >= BUS_COUNT) return;
+
+    bus_state_t *b = &m_bus[bus];
+    b->event = true;
+    if (b->ppi_enabled && b->armed && !b->hw_started) {
+        b->hw_started = true;
+        b->started++;
+        b->last = b->armed;
+    }
+}
+
+uint32_t bus_mock_started(bus_id_t bus)
+{
+    return (bus < BUS_COUNT) ? m_bus[bus].started : 0;
+}
+
+const bus_xfer_t *bus_mock_last(bus_id_t bus)
+{
+    return (bus < BUS_COUNT) ? m_bus[bus].last : NULL;
+}
+
+#endif /* HOST_TEST */
@@ -0,0 +1,169 @@
+/**
+ * @file bus_manager.h
+ * @brief Neural Load Ring Shared Serial Bus Scheduler
+ *
+ * One owner for each serial bus (SPIM for the PPG AFE, TWIM for the charger,
+ * accelerometer and haptic driver). Drivers describe transfers with
+ * caller-owned bus_xfer_t descriptors and submit them without waiting:
+ *
+ *   - Priorities: a queued high-priority transfer (e.g. a PPG FIFO drain)
+ *     overtakes queued housekeeping; the transfer on the wire finishes first.
+ *   - Chains: xfer->next links run back-to-back while the bus stays held,
+ *     so a multi-register sequence cannot be split by another driver.
+ *   - Completion: xfer->done runs from the bus interrupt, once per link.
+ *   - Triggers: a transfer can be armed on a hardware event (PPI), starting
+ *     with no CPU wakeup; while the bus is busy the trigger is held off and
+ *     replayed as soon as the bus goes idle.
+ *
+ * The bus driver does the DMA (EasyDMA reads tx/rx in place), so descriptors
+ * and their buffers must stay valid in RAM until done is called.
+ *
+ * On target the SPIM/TWIM event handlers in bus_manager.c report END
+ * through bus_on_end(). Host builds (HOST_TEST) complete transfers through
+ * a mock: an optional device model fills rx and returns a result, and
+ * bus_mock_complete() plays the END interrupt.
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef BUS_MANAGER_H
+#define BUS_MANAGER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../hal/hal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+ * TYPES
+ ******************************************************************************/
+
+typedef enum {
+    BUS_SPI0 = HAL_BUS_SPIM0,       /**< SPIM: PPG AFE */
+    BUS_I2C0 = HAL_BUS_TWIM0,       /**< TWIM: charger, accelerometer, haptics */
+    BUS_COUNT = HAL_BUS_COUNT
+} bus_id_t;
+
+typedef enum {
+    BUS_PRIO_HIGH = 0,              /**< Sensor FIFOs (data loss if late) */
+    BUS_PRIO_NORMAL,                /**< Control writes (LED current, haptics) */
+    BUS_PRIO_LOW,                   /**< Housekeeping (fuel gauge, init) */
+    BUS_PRIO_COUNT
+} bus_priority_t;
+
+typedef enum {
+    BUS_XFER_IDLE = 0,
+    BUS_XFER_QUEUED,
+    BUS_XFER_ARMED,                 /**< Waiting for its hardware trigger */
+    BUS_XFER_ACTIVE,
+} bus_xfer_state_t;
+
+struct bus_xfer;
+
+/** Completion hook (interrupt context): result 0 ok, -1 NACK/error, -3 aborted */
+typedef void (*bus_done_fn_t)(struct bus_xfer *p_xfer, int result);
+
+/**
+ * Transfer descriptor. SPI: full duplex, rx_len bytes clocked in while tx
+ * goes out (the longer length wins). I2C: write tx, repeated start, read rx.
+ */
+typedef struct bus_xfer {
+    bus_id_t bus;
+    uint8_t address;                /**< I2C 7-bit address / SPI CS pin */
+    bus_priority_t priority;
+    const uint8_t *p_tx;
+    uint16_t tx_len;
+    uint8_t *p_rx;
+    uint16_t rx_len;
+    struct bus_xfer *next;          /**< Chained link (same bus), or NULL */
+    bus_done_fn_t done;
+    void *p_context;
+
+    /* Owned by the bus manager */
+    volatile bus_xfer_state_t state;
+    struct bus_xfer *q_next;
+} bus_xfer_t;
+
+/*******************************************************************************
+ * PUBLIC API
+ ******************************************************************************/
+
+/**
+ * @brief Reset queues and bring up the bus peripherals
+ */
+void bus_manager_init(void);
+
+/**
+ * @brief Queue a transfer (or chain) and start it if the bus is free
+ *
+ * Safe from interrupt context.
+ *
+ * @return 0 on success, -1 invalid descriptor, -2 already queued/active
+ */
+int bus_submit(bus_xfer_t *p_xfer);
+
+/**
+ * @brief Arm a transfer to start on a hardware event through PPI
+ *
+ * Fires once; re-arm from done for a periodic transfer.
+ *
+ * @param event_addr Address of the event register (e.g. GPIOTE or RTC compare)
+ * @return 0 on success, -1 invalid, -2 bus already has an armed transfer
+ */
+int bus_arm_on_event(bus_xfer_t *p_xfer, uint32_t event_addr);
+
+/**
+ * @brief Disarm the triggered transfer on a bus
+ */
+void bus_disarm(bus_id_t bus);
+
+/**
+ * @brief END interrupt for a bus: completes the link on the wire
+ *
+ * Called from the bus peripheral's event handler (interrupt context),
+ * also for a transfer the PPI started. Runs the next chain link or the
+ * next queued transfer, then the done hooks.
+ *
+ * @param result 0 on success, -1 NACK/error
+ */
+void bus_on_end(bus_id_t bus, int result);
+
+/**
+ * @brief True when no bus has a transfer queued or on the wire
+ *
+ * The main loop may sleep (WFE) whenever this holds; armed transfers
+ * do not need the CPU.
+ */
+bool bus_manager_idle(void);
+
+#ifdef HOST_TEST
+/** Device model: inspect tx, fill rx, return 0 or -1 (NACK) */
+typedef int (*bus_mock_device_fn_t)(const bus_xfer_t *p_xfer);
+
+void bus_mock_set_device(bus_id_t bus, bus_mock_device_fn_t fn);
+
+/** Complete the transfer on the wire (plays the END interrupt) */
+bool bus_mock_complete(bus_id_t bus);
+
+/** Complete transfers until the bus is idle; returns how many ran */
+uint16_t bus_mock_drain(bus_id_t bus);
+
+/** Fire the armed transfer's hardware event */
+void bus_mock_trigger(bus_id_t bus);
+
+/** Transfers started on a bus since init (in wire order) */
+uint32_t bus_mock_started(bus_id_t bus);
+
+/** Last transfer put on the wire */
+const bus_xfer_t *bus_mock_last(bus_id_t bus);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BUS_MANAGER_H */
@@ -0,0 +1,149 @@
+/**
+ * @file checkpoint.c
+ * @brief Neural Load Ring Whole-Pipeline Checkpoint / Restore
+ *
+ * Each module copies its own file-scope state and repairs the pointers in
+ * it (engine and pattern tables) on load; this file only frames, checks and
+ * dispatches the sections. Headers are copied as structs, so the image is
+ * little-endian on the ring and on the host alike.
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "checkpoint.h"
+#include "ota_update.h"
+#include "../core/wellness_processor.h"
+#include "../core/wellness_manager.h"
+#include "../wellness_feedback/cue_processor.h"
+#include "../wellness_feedback/actuator_controller.h"
+#include "../wellness_feedback/thermal_feature.h"
+#include "../wellness_feedback/vibration_feature.h"
+#include "../wellness_feedback/signature_feel.h"
+#include <stddef.h>
+#include <string.h>
+
+/*******************************************************************************
+ * SECTIONS
+ ******************************************************************************/
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t sections;
+    uint32_t time_ms;
+    uint32_t payload;               /**< Bytes between header and CRC */
+} checkpoint_hdr_t;
+
+typedef struct {
+    uint16_t id;
+    uint16_t reserved;
+    uint32_t len;
+} checkpoint_sec_hdr_t;
+
+typedef struct {
+    checkpoint_section_id_t id;
+    uint32_t (*save)(void *p_buf, uint32_t cap);
+    int (*load)(const void *p_buf, uint32_t len);
+} checkpoint_section_t;
+
+/* Load order: outputs first, so the sequencers above them see live drivers */
+static const checkpoint_section_t SECTIONS[] = {
+    { CHECKPOINT_SEC_VIBRATION, vibration_feature_state_save, vibration_feature_state_load },
+    { CHECKPOINT_SEC_THERMAL,   thermal_feature_state_save,   thermal_feature_state_load },
+    { CHECKPOINT_SEC_SIGNATURE, signature_state_save,         signature_state_load },
+    { CHECKPOINT_SEC_ACTUATOR,  actuator_state_save,          actuator_state_load },
+    { CHECKPOINT_SEC_CUE,       cue_processor_state_save,     cue_processor_state_load },
+    { CHECKPOINT_SEC_MANAGER,   wellness_manager_state_save,  wellness_manager_state_load },
+    { CHECKPOINT_SEC_WELLNESS,  wellness_state_save,          wellness_state_load },
+};
+
+#define SECTION_COUNT   (sizeof(SECTIONS) / sizeof(SECTIONS[0]))
+
+/*******************************************************************************
+ * PUBLIC API
+ ******************************************************************************/
+
+uint32_t checkpoint_size(void)
+{
+    uint32_t size = CHECKPOINT_HEADER_BYTES + sizeof(uint32_t);
+
+    for (uint32_t i = 0; i < SECTION_COUNT; i++) {
+        size += CHECKPOINT_SECTION_BYTES + SECTIONS[i].save(NULL, 0);
+    }
+    return size;
+}
+
+int checkpoint_save(uint32_t now_ms, uint8_t *p_buf, uint32_t cap, uint32_t *p_len)
+{
+    uint32_t size = checkpoint_size();
+    uint32_t off = CHECKPOINT_HEADER_BYTES;
+
+    if (p_buf == NULL || p_len == NULL || cap < size) return -1;
+
+    for (uint32_t i = 0; i < SECTION_COUNT; i++) {
+        checkpoint_sec_hdr_t sec = { .id = (uint16_t)SECTIONS[i].id };
+        sec.len = SECTIONS[i].save(&p_buf[off + CHECKPOINT_SECTION_BYTES], cap - off - CHECKPOINT_SECTION_BYTES);
+        memcpy(&p_buf[off], &sec, sizeof(sec));
+        off += CHECKPOINT_SECTION_BYTES + sec.len;
+    }
+
+    checkpoint_hdr_t hdr = {
+        .magic = CHECKPOINT_MAGIC,
+        .version = CHECKPOINT_VERSION,
+        .sections = (uint16_t)SECTION_COUNT,
+        .time_ms = now_ms,
+        .payload = off - CHECKPOINT_HEADER_BYTES,
+    };
+    memcpy(p_buf, &hdr, sizeof(hdr));
+
+    uint32_t crc = ota_crc32(0, p_buf, off);
+    memcpy(&p_buf[off], &crc, sizeof(crc));
+    *p_len = off + sizeof(crc);
+    return 0;
+}
+
+int checkpoint_restore(const uint8_t *p_buf, uint32_t len, uint32_t *p_now_ms)
+{
+    const uint8_t *p_data[SECTION_COUNT] = { NULL };
+    checkpoint_hdr_t hdr;
+    uint32_t crc;
+
+    if (p_buf == NULL || len < CHECKPOINT_HEADER_BYTES + sizeof(crc)) return -1;
+
+    memcpy(&hdr, p_buf, sizeof(hdr));
+    if (hdr.magic != CHECKPOINT_MAGIC || hdr.version != CHECKPOINT_VERSION ||
+        hdr.payload != len - CHECKPOINT_HEADER_BYTES - sizeof(crc)) {
+        return -2;
+    }
+    memcpy(&crc, &p_buf[len - sizeof(crc)], sizeof(crc));
+    if (ota_crc32(0, p_buf, len - sizeof(crc)) != crc) return -2;
+
+    /* Every section this build has, once, at the size it expects */
+    uint32_t off = CHECKPOINT_HEADER_BYTES;
+    uint32_t end = len - sizeof(crc);
+    for (uint16_t n = 0; n < hdr.sections; n++) {
+        checkpoint_sec_hdr_t sec;
+        uint32_t i;
+
+        if (end - off < CHECKPOINT_SECTION_BYTES) return -3;
+        memcpy(&sec, &p_buf[off], sizeof(sec));
+        off += CHECKPOINT_SECTION_BYTES;
+        if (sec.len > end - off) return -3;
+
+        for (i = 0; i < SECTION_COUNT && (uint16_t)SECTIONS[i].id != sec.id; i++) {}
+        if (i == SECTION_COUNT || p_data[i] != NULL || sec.len != SECTIONS[i].save(NULL, 0)) return -3;
+        p_data[i] = &p_buf[off];
+        off += sec.len;
+    }
+    if (off != end) return -3;
+    for (uint32_t i = 0; i < SECTION_COUNT; i++) {
+        if (p_data[i] == NULL) return -3;
+    }
+
+    for (uint32_t i = 0; i < SECTION_COUNT; i++) {
+        (void)SECTIONS[i].load(p_data[i], SECTIONS[i].save(NULL, 0));
+    }
+    if (p_now_ms) *p_now_ms = hdr.time_ms;
+    return 0;
+}
@@ -0,0 +1,101 @@
+/**
+ * @file checkpoint.h
+ * @brief Neural Load Ring Whole-Pipeline Checkpoint / Restore
+ *
+ * Serializes the state of every stage between the PPG samples and the
+ * actuators, so a replay can resume at a saved virtual time instead of
+ * re-running the recording from the start:
+ *
+ *   wellness_processor   detectors, fusion, RR ring
+ *   wellness_manager     metrics, stress calibration, HRV windows, tuning
+ *   cue_processor        preferences, cooldown / rate limit, history
+ *   actuator_controller  active command, heater energy budget
+ *   thermal_feature      heater state machine and pattern position
+ *   vibration_feature    motor pattern position, rotor estimate
+ *   signature_feel       signature player
+ *
+ * Drivers, HAL, BLE, the main loop's own timers and flash (NVM records,
+ * see nvm_store.h) are not included. Sections are raw copies of each
+ * module's state, so an image only restores into a build with the same
+ * layout; a size mismatch is rejected before anything is touched.
+ *
+ * Image (little-endian):
+ *
+ *   header    magic "NLCP", u16 version, u16 sections, u32 time_ms, u32 payload
+ *   section   u16 id, u16 reserved, u32 length, state bytes   (x sections)
+ *   trailer   u32 CRC32 (ota_crc32) of everything before it
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
+
+#define CHECKPOINT_MAGIC            0x50434C4EU     /**< "NLCP" */
+#define CHECKPOINT_VERSION          1U
+#define CHECKPOINT_HEADER_BYTES     16U
+#define CHECKPOINT_SECTION_BYTES    8U              /**< Section header */
+
+/** Section IDs (never reuse a retired ID) */
+typedef enum {
+    CHECKPOINT_SEC_WELLNESS    = 0x0001,
+    CHECKPOINT_SEC_MANAGER     = 0x0002,
+    CHECKPOINT_SEC_CUE         = 0x0003,
+    CHECKPOINT_SEC_ACTUATOR    = 0x0004,
+    CHECKPOINT_SEC_THERMAL     = 0x0005,
+    CHECKPOINT_SEC_VIBRATION   = 0x0006,
+    CHECKPOINT_SEC_SIGNATURE   = 0x0007,
+} checkpoint_section_id_t;
+
+/*******************************************************************************
+ * PUBLIC API
+ ******************************************************************************/
+
+/**
+ * @brief Image size for this build
+ */
+uint32_t checkpoint_size(void);
+
+/**
+ * @brief Serialize the pipeline
+ *
+ * Call between main loop passes (not from an ISR or mid-tick).
+ *
+ * @param now_ms  Time the image is taken at (returned by restore)
+ * @param p_buf   Output buffer
+ * @param cap     Buffer size
+ * @param p_len   Image length written
+ * @return 0 on success, -1 invalid args or buffer too small
+ */
+int checkpoint_save(uint32_t now_ms, uint8_t *p_buf, uint32_t cap, uint32_t *p_len);
+
+/**
+ * @brief Replace the pipeline state with an image
+ *
+ * The image is checked in full first; on error no module is changed.
+ *
+ * @param p_buf     Image
+ * @param len       Image length
+ * @param p_now_ms  Time the image was taken at (may be NULL)
+ * @return 0 on success, -1 invalid args, -2 bad magic/version/CRC,
+ *         -3 sections do not match this build
+ */
+int checkpoint_restore(const uint8_t *p_buf, uint32_t len, uint32_t *p_now_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CHECKPOINT_H */
@@ -15,17 +15,28 @@
  */
 
 #include "system_init.h"
+#include "nvm_store.h"
+#include "bus_manager.h"
+#include "ota_update.h"
+#include "../hal/hal.h"
 #include "../bluetooth/ble_stack.h"
+#include "../bluetooth/ble_packets.h"
+#include "../bluetooth/ble_l2cap.h"
+#include "../bluetooth/stream_ctrl.h"
+#include "../bluetooth/stream_partition.h"
 #include "../sensors/ppg_driver.h"
+#include "../sensors/ppg_capture.h"
 #include "../sensors/temperature_sensor.h"
 #include "../core/wellness_processor.h"
 #include "../core/wellness_manager.h"
+#include "../core/ts_codec.h"
 #include "../wellness_feedback/actuator_controller.h"
 #include "../wellness_feedback/thermal_feature.h"
 #include "../wellness_feedback/vibration_feature.h"
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 
 /*******************************************************************************
  * CONFIGURATION
@@ -36,6 +47,9 @@
 #define COHERENCE_UPDATE_MS         15000   /**< Coherence update interval */
 #define DEVICE_STATE_UPDATE_MS      5000    /**< Device state update interval */
 #define RR_BUFFER_SIZE              16      /**< RR intervals to batch */
+#define RR_BATCH_MAX_MS             5000    /**< BATCHED: send a short batch after this long */
+#define RR_LOG_HDR_BYTES            4U      /**< u32 sample count ahead of the stream */
+#define RR_LOG_BYTES                (NLR_L2CAP_SDU_MAX - 1U - RR_LOG_HDR_BYTES) /**< One bulk SDU */
 
 /*******************************************************************************
  * PRIVATE DATA
@@ -48,6 +62,13 @@ static struct {
     uint16_t rr_buffer[RR_BUFFER_SIZE];
     uint8_t  rr_count;
     bool     streaming_enabled;
+    bool     stream_reset;          /**< New connection: restart at FULL, raw beats */
+    bool     summary_now;           /**< Partition switched: bridge it with a summary */
+    uint8_t  central_caps;          /**< NLR_CENTRAL_CAP_* from the config */
+    stream_ctrl_t stream;
+    stream_partition_t partition;
+    ts_encoder_t rr_log;            /**< RR not streamed, until the bulk channel takes them */
+    uint8_t  rr_log_sdu[RR_LOG_HDR_BYTES + RR_LOG_BYTES];
 } m_app = {0};
 
 /*******************************************************************************
@@ -58,15 +79,21 @@ static void on_ble_event(const nlr_ble_evt_t *p_evt)
 {
     switch (p_evt->type) {
         case NLR_BLE_EVT_CONNECTED:
-            /* Reset streaming state on new connection */
-            m_app.rr_count = 0;
-            m_app.streaming_enabled = false;
+            /* Reset streaming state on the first connection; later centrals join the stream */
+            if (nlr_ble_get_link_count() == 1) {
+                m_app.rr_count = 0;
+                m_app.streaming_enabled = false;
+                m_app.stream_reset = true;
+            }
             break;
             
         case NLR_BLE_EVT_DISCONNECTED:
-            /* Stop any active actuators on disconnect */
-            actuator_stop_all();
-            m_app.streaming_enabled = false;
+            /* Stop any active actuators once the last central is gone */
+            if (!nlr_ble_is_connected()) {
+                actuator_stop_all();
+            }
+            m_app.streaming_enabled = (nlr_ble_get_subscribers(NLR_UUID_CHAR_RR_INTERVAL) +
+                                       nlr_ble_get_subscribers(NLR_UUID_CHAR_COHERENCE)) > 0;
             break;
             
         case NLR_BLE_EVT_ACTUATOR_CMD:
@@ -87,14 +114,29 @@ static void on_ble_event(const nlr_ble_evt_t *p_evt)
         
         case NLR_BLE_EVT_CONFIG_CHANGED:
             /* Configuration updated via BLE - could adjust timers here */
+            wellness_set_detector(p_evt->data.config.config.detector_id);
+            m_app.central_caps = p_evt->data.config.config.central_caps;
             break;
             
         case NLR_BLE_EVT_NOTIFICATIONS_ENABLED:
-            m_app.streaming_enabled = true;
+        case NLR_BLE_EVT_NOTIFICATIONS_DISABLED:
+            /* Stream while any central wants it */
+            m_app.streaming_enabled = (nlr_ble_get_subscribers(NLR_UUID_CHAR_RR_INTERVAL) +
+                                       nlr_ble_get_subscribers(NLR_UUID_CHAR_COHERENCE)) > 0;
             break;
             
-        case NLR_BLE_EVT_NOTIFICATIONS_DISABLED:
-            m_app.streaming_enabled = false;
+        case NLR_BLE_EVT_OTA_READY:
+            /* ota_update resets into the bootloader once the FINISH response is out */
+            actuator_stop_all();
+            break;
+            
+        case NLR_BLE_EVT_PPG_CAPTURE:
+            /* Research session: raw PPG on the bulk channel */
+            if (p_evt->data.capture.enable) {
+                ppg_capture_start();
+            } else {
+                ppg_capture_stop();
+            }
             break;
             
         default:
@@ -106,66 +148,179 @@ static void on_ble_event(const nlr_ble_evt_t *p_evt)
  * MAIN LOOP TASKS
  ******************************************************************************/
 
+static uint8_t read_battery_pct(void)
+{
+    return 85;  /* TODO: Read from BQ25125 */
+}
+
+/**
+ * Keep an RR interval on the ring (level SUMMARY and below, or buffer full)
+ */
+static void rr_log_append(uint32_t now_ms, uint16_t rr_ms)
+{
+    /* Full log: the interval is lost (the log empties once the link recovers) */
+    (void)ts_encoder_append(&m_app.rr_log, now_ms, rr_ms);
+}
+
+/**
+ * Raw beats go out (phone computes) rather than to the log (ring computes,
+ * or the link only carries summaries)
+ */
+static bool rr_streamed(void)
+{
+    return stream_ctrl_level(&m_app.stream) <= STREAM_LEVEL_BATCHED &&
+           stream_partition_side(&m_app.partition) == PARTITION_PHONE;
+}
+
+static void rr_buffer_to_log(uint32_t now_ms)
+{
+    for (uint8_t i = 0; i < m_app.rr_count; i++) {
+        rr_log_append(now_ms, m_app.rr_buffer[i]);
+    }
+    m_app.rr_count = 0;
+}
+
 /**
  * Collect RR intervals from PPG processor and buffer for transmission
  */
-static void task_collect_rr(void)
+static void task_collect_rr(uint32_t now_ms)
 {
-    float rr_ms;
+    uint16_t rr_ms;
     while (wellness_manager_pop_rr(&rr_ms)) {
-        if (m_app.rr_count < RR_BUFFER_SIZE) {
-            /* Store as u16 for BLE characteristic */
-            m_app.rr_buffer[m_app.rr_count++] = (uint16_t)rr_ms;
+        bool logged = m_app.streaming_enabled && !rr_streamed();
+        
+        if (!logged && m_app.rr_count < RR_BUFFER_SIZE) {
+            m_app.rr_buffer[m_app.rr_count++] = rr_ms;
+        } else if (m_app.streaming_enabled) {
+            rr_log_append(now_ms, rr_ms);
         }
     }
 }
 
 /**
- * Send buffered RR intervals via BLE if interval elapsed
+ * Send buffered RR intervals via BLE: every interval at FULL, a full
+ * notification at a time at BATCHED. A batch no subscriber could take
+ * stays in the buffer for the next attempt.
  */
 static void task_send_rr(uint32_t now_ms)
 {
-    if (!m_app.streaming_enabled || m_app.rr_count == 0) {
+    stream_level_t level = stream_ctrl_level(&m_app.stream);
+    
+    if (!m_app.streaming_enabled || m_app.rr_count == 0 || !rr_streamed()) {
         return;
     }
     
-    if ((now_ms - m_app.last_rr_send_ms) >= RR_SEND_INTERVAL_MS) {
+    uint32_t elapsed = now_ms - m_app.last_rr_send_ms;
+    bool due = (level == STREAM_LEVEL_FULL) ?
+               (elapsed >= RR_SEND_INTERVAL_MS) :
+               (m_app.rr_count >= NLR_RR_PER_NOTIFY_MAX || elapsed >= RR_BATCH_MAX_MS);
+    
+    if (due) {
         m_app.last_rr_send_ms = now_ms;
         
-        int err = nlr_ble_send_rr(m_app.rr_buffer, m_app.rr_count);
-        if (err == 0 || err == -4) {
-            /* Success or queue full - clear buffer either way */
-            m_app.rr_count = 0;
+        uint8_t n = (m_app.rr_count > NLR_RR_PER_NOTIFY_MAX) ? NLR_RR_PER_NOTIFY_MAX : m_app.rr_count;
+        int err = nlr_ble_send_rr(m_app.rr_buffer, n);
+        stream_ctrl_on_send(&m_app.stream, err);
+        if (err == 0) {
+            m_app.rr_count = (uint8_t)(m_app.rr_count - n);
+            memmove(m_app.rr_buffer, &m_app.rr_buffer[n], m_app.rr_count * sizeof(uint16_t));
         }
     }
 }
 
 /**
- * Compute and send coherence metrics periodically
+ * Compute and send coherence metrics periodically (every level but OFFLINE):
+ * alongside raw beats, or once a minute as the summary when the ring computes
  */
 static void task_send_coherence(uint32_t now_ms)
 {
-    if (!m_app.streaming_enabled) {
+    if (!m_app.streaming_enabled || stream_ctrl_level(&m_app.stream) == STREAM_LEVEL_OFFLINE) {
         return;
     }
     
-    if ((now_ms - m_app.last_coherence_ms) >= COHERENCE_UPDATE_MS) {
+    uint32_t period_ms = (stream_partition_side(&m_app.partition) == PARTITION_RING) ?
+                         PARTITION_SUMMARY_MS : COHERENCE_UPDATE_MS;
+    
+    if (m_app.summary_now || (now_ms - m_app.last_coherence_ms) >= period_ms) {
+        m_app.summary_now = false;
         m_app.last_coherence_ms = now_ms;
         
-        const hr_metrics_t *p_metrics = wellness_manager_get_metrics();
-        
-        nlr_coherence_packet_t packet = {
-            .stress_level = (uint8_t)(p_metrics->stress_score * 100.0f),
-            .coherence_pct = (uint8_t)((1.0f - p_metrics->stress_score) * 100.0f),
-            .confidence_pct = (p_metrics->valid_samples > 30) ? 90 : 50,
-            .variability_level = (uint8_t)(p_metrics->rmssd > 100 ? 100 : p_metrics->rmssd),
-            .mean_rr_ms = (uint16_t)p_metrics->mean_rr_ms,
-            .rmssd_ms = (uint16_t)p_metrics->rmssd,
-            .respiratory_rate_cpm = 0, /* TODO: Implement resp rate detection */
-            .reserved = 0,
-        };
+        nlr_coherence_packet_t packet;
+        nlr_ble_coherence_from_metrics(wellness_manager_get_metrics(), &packet);
         
-        nlr_ble_send_coherence(&packet);
+        stream_ctrl_on_send(&m_app.stream, nlr_ble_send_coherence(&packet));
+    }
+}
+
+/**
+ * Pick the streaming level from link backpressure and battery, and which
+ * side computes; report changes right away, and hand the RR log to the
+ * central once raw beats flow again
+ */
+static void task_stream_level(uint32_t now_ms)
+{
+    uint8_t battery_pct = read_battery_pct();
+    bool changed;
+    
+    if (m_app.stream_reset) {
+        m_app.stream_reset = false;
+        stream_ctrl_init(&m_app.stream, now_ms);
+        stream_partition_init(&m_app.partition);
+    }
+    if (!m_app.streaming_enabled) {
+        return;
+    }
+    
+    changed = stream_ctrl_update(&m_app.stream, now_ms, nlr_ble_get_tx_room(), battery_pct);
+    
+    partition_inputs_t in = {
+        .rr_subscribers = nlr_ble_get_subscribers(NLR_UUID_CHAR_RR_INTERVAL),
+        .stream_level = (uint8_t)stream_ctrl_level(&m_app.stream),
+        .battery_pct = battery_pct,
+        .central_caps = m_app.central_caps,
+    };
+    if (stream_partition_update(&m_app.partition, now_ms, &in)) {
+        /* The ring's metrics never stopped: a summary now bridges the switch */
+        m_app.summary_now = true;
+        changed = true;
+    }
+    
+    if (changed) {
+        /* No raw beats any more: what was waiting to stream goes to the log */
+        if (!rr_streamed()) {
+            rr_buffer_to_log(now_ms);
+        }
+        m_app.last_state_ms = now_ms - DEVICE_STATE_UPDATE_MS;
+    }
+    
+    if (rr_streamed() && m_app.rr_log.count > 0) {
+        uint16_t len = (uint16_t)(RR_LOG_HDR_BYTES + ts_encoder_bytes(&m_app.rr_log));
+        memcpy(m_app.rr_log_sdu, &m_app.rr_log.count, RR_LOG_HDR_BYTES);
+        if (nlr_ble_bulk_send(NLR_BULK_STREAM_RR_LOG, m_app.rr_log_sdu, len) == 0) {
+            ts_encoder_init(&m_app.rr_log, TS_CODEC_DELTA, &m_app.rr_log_sdu[RR_LOG_HDR_BYTES], RR_LOG_BYTES);
+        }
+    }
+}
+
+/**
+ * Send coded raw PPG blocks, including the tail queued by a stop; the
+ * capture ends with the bulk channel
+ */
+static void task_ppg_capture(void)
+{
+    const uint8_t *p_sdu;
+    uint16_t len;
+    
+    while (ppg_capture_peek(&p_sdu, &len)) {
+        int err = nlr_ble_bulk_send(NLR_BULK_STREAM_PPG_RAW, p_sdu, len);
+        if (err == -1) {
+            ppg_capture_abort();
+            return;
+        }
+        if (err == -2) {
+            return;     /* Previous SDU still going out */
+        }
+        ppg_capture_pop();  /* Sent, or over the central's SDU size: skip it */
     }
 }
 
@@ -177,6 +332,10 @@ static void task_update_device_state(uint32_t now_ms)
     if ((now_ms - m_app.last_state_ms) >= DEVICE_STATE_UPDATE_MS) {
         m_app.last_state_ms = now_ms;
         
+        /* Heater budget and cue logic follow the battery */
+        uint8_t battery_pct = read_battery_pct();
+        wellness_manager_set_battery(battery_pct);
+        
         /* Read skin temperature */
         int8_t skin_temp = temperature_read_skin();
         
@@ -189,11 +348,19 @@ static void task_update_device_state(uint32_t now_ms)
             error_flags |= 0x08;  /* Bit 3: thermal fault */
         }
         
+        /* What is streaming, and the level it runs at */
+        static const uint8_t level_streams[] = { 0x03, 0x03, 0x02, 0x00 };
+        stream_level_t level = stream_ctrl_level(&m_app.stream);
+        uint8_t streaming = m_app.streaming_enabled ? level_streams[level] : 0x00;
+        if (m_app.streaming_enabled && stream_partition_side(&m_app.partition) == PARTITION_RING) {
+            streaming = (uint8_t)((streaming & ~0x01) | NLR_STREAM_RING_COMPUTED);
+        }
+        
         nlr_device_state_t state = {
-            .battery_pct = 85,  /* TODO: Read from BQ25125 */
+            .battery_pct = battery_pct,
             .charging_state = 0,
             .connection_state = nlr_ble_is_connected() ? 2 : 1,
-            .streaming_active = m_app.streaming_enabled ? 0x03 : 0x00,
+            .streaming_active = (uint8_t)(streaming | (level << NLR_STREAM_LEVEL_SHIFT)),
             .skin_temp_c = skin_temp,
             .error_flags = error_flags,
             .uptime_min = (uint16_t)(now_ms / 60000),
@@ -212,13 +379,24 @@ int main(void)
     /* Initialize system clocks, GPIO, power management */
     system_init();
     
+    /* Mount persistent storage (calibration, settings) */
+    nvm_store_init();
+    
+    /* Pick up an interrupted delta OTA transfer */
+    ota_update_init();
+    
+    /* Shared SPI/I2C scheduler (before any driver touches a bus) */
+    bus_manager_init();
+    
     /* Initialize BLE stack with event handler */
     int err = nlr_ble_init(on_ble_event);
     if (err != 0) {
         /* BLE init failed - enter error state */
-        while (1) {
+        while (hal_running()) {
             /* TODO: Blink error LED */
+            hal_sleep_ms(MAIN_LOOP_PERIOD_MS);
         }
+        return err;
     }
     
     /* Initialize sensors */
@@ -231,23 +409,33 @@ int main(void)
     /* Initialize actuators */
     actuator_init();
     
+    /* Streaming levels and the RR log behind them */
+    stream_ctrl_init(&m_app.stream, 0);
+    stream_partition_init(&m_app.partition);
+    ts_encoder_init(&m_app.rr_log, TS_CODEC_DELTA, &m_app.rr_log_sdu[RR_LOG_HDR_BYTES], RR_LOG_BYTES);
+    
     /* Start advertising */
     nlr_ble_advertising_start();
     
     /* Main processing loop */
-    uint32_t now_ms = 0;
+    uint32_t now_ms = hal_loop_start_ms(MAIN_LOOP_PERIOD_MS);
     
-    while (1) {
+    while (hal_running()) {
         /* Process BLE events */
         nlr_ble_process();
         
+        /* Hand completed PPG FIFO blocks to the beat detector */
+        ppg_process(now_ms);
+        
         /* Run wellness analysis */
         wellness_manager_tick(now_ms);
         
         /* Run periodic tasks */
-        task_collect_rr();
+        task_collect_rr(now_ms);
+        task_stream_level(now_ms);
         task_send_rr(now_ms);
         task_send_coherence(now_ms);
+        task_ppg_capture();
         task_update_device_state(now_ms);
         
         /* Update actuator state machines */
@@ -255,8 +443,8 @@ int main(void)
         thermal_feature_tick(now_ms);
         vibration_feature_tick(now_ms);
         
-        /* Wait for next tick (in real firmware: WFE or app_scheduler) */
-        /* nrf_delay_ms(MAIN_LOOP_PERIOD_MS); */
+        /* Sleep until the next tick (WFE on target, virtual time on host) */
+        hal_sleep_ms(MAIN_LOOP_PERIOD_MS);
         now_ms += MAIN_LOOP_PERIOD_MS;
     }
     
@@ -0,0 +1,301 @@
+/**
+ * @file nvm_store.c
+ * @brief Neural Load Ring Non-Volatile Record Store
+ *
+ * Page layout:
+ *   [magic u32][sequence u32][record][record]...[erased 0xFF]
+ *
+ * Record layout (word aligned):
+ *   [id u16][len u16][crc16 u16][valid marker u16][data, padded to 4]
+ *
+ * The id/len word is programmed first, then the data, then the CRC/marker
+ * word, so a record cut short by a reset is skipped on the next mount. A
+ * compacted page only gets its header (and becomes active) after all live
+ * records and the record being written have been copied, and the old page
+ * is erased only after that, so a reset at any point leaves one page that
+ * holds either the old or the new copy.
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "nvm_store.h"
+#include "../hal/hal.h"
+#include <string.h>
+
+/*******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
+
+#define NVM_PAGE_MAGIC          0x31524C4EU     /**< "NLR1" */
+#define NVM_PAGE_HDR_SIZE       8U
+#define NVM_REC_HDR_SIZE        8U
+#define NVM_REC_VALID           0x5AA5U
+#define NVM_ERASED_U16          0xFFFFU
+
+typedef struct {
+    uint16_t id;
+    uint16_t len;
+    uint16_t crc;
+    uint16_t marker;
+} nvm_rec_hdr_t;
+
+/*******************************************************************************
+ * PRIVATE DATA
+ ******************************************************************************/
+
+static struct {
+    uint8_t active_page;
+    uint32_t sequence;
+    uint32_t write_offset;
+    bool mounted;
+} m_nvm;
+
+/*******************************************************************************
+ * FLASH ACCESS
+ ******************************************************************************/
+
+static inline uint32_t nvm_addr(uint8_t page, uint32_t offset)
+{
+    return NVM_FLASH_BASE + (uint32_t)page * NVM_PAGE_SIZE + offset;
+}
+
+static inline const uint8_t *nvm_flash_ptr(uint8_t page, uint32_t offset)
+{
+    return hal_flash_ptr(nvm_addr(page, offset));
+}
+
+static inline void nvm_flash_write(uint8_t page, uint32_t offset, const uint32_t *p_words, uint16_t count)
+{
+    hal_flash_write_words(nvm_addr(page, offset), p_words, count);
+}
+
+static inline void nvm_flash_erase(uint8_t page)
+{
+    hal_flash_erase_page(nvm_addr(page, 0));
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+static uint16_t nvm_crc16(const uint8_t *p_data, uint16_t len)
+{
+    uint16_t crc = 0xFFFFU;
+
+    for (uint16_t i = 0; i < len; i++) {
+        crc ^= (uint16_t)p_data[i] << 8;
+        for (uint8_t b = 0; b < 8; b++) {
+            crc = (crc & 0x8000U) ? (uint16_t)((crc << 1) ^ 0x1021U) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static inline uint32_t nvm_record_size(uint16_t len)
+{
+    return NVM_REC_HDR_SIZE + (((uint32_t)len + 3U) & ~3U);
+}
+
+static void nvm_read_hdr(uint8_t page, uint32_t offset, nvm_rec_hdr_t *p_hdr)
+{
+    memcpy(p_hdr, nvm_flash_ptr(page, offset), sizeof(nvm_rec_hdr_t));
+}
+
+static bool nvm_page_valid(uint8_t page, uint32_t *p_seq)
+{
+    uint32_t hdr[2];
+    memcpy(hdr, nvm_flash_ptr(page, 0), sizeof(hdr));
+    if (hdr[0] != NVM_PAGE_MAGIC || hdr[1] == 0xFFFFFFFFU) return false;
+    if (p_seq) *p_seq = hdr[1];
+    return true;
+}
+
+static bool nvm_record_ok(uint8_t page, uint32_t offset, const nvm_rec_hdr_t *p_hdr)
+{
+    return (p_hdr->marker == NVM_REC_VALID) &&
+           (p_hdr->crc == nvm_crc16(nvm_flash_ptr(page, offset + NVM_REC_HDR_SIZE), p_hdr->len));
+}
+
+/**
+ * Iterate records; returns false at the end of the log or on a corrupt length.
+ */
+static bool nvm_next(uint8_t page, uint32_t *p_offset, nvm_rec_hdr_t *p_hdr)
+{
+    if (*p_offset + NVM_REC_HDR_SIZE > NVM_PAGE_SIZE) return false;
+
+    nvm_read_hdr(page, *p_offset, p_hdr);
+    if (p_hdr->id == NVM_ERASED_U16 && p_hdr->len == NVM_ERASED_U16) return false;
+    if (p_hdr->len == 0U || p_hdr->len > NVM_MAX_RECORD_LEN) return false;
+    if (*p_offset + nvm_record_size(p_hdr->len) > NVM_PAGE_SIZE) return false;
+    return true;
+}
+
+static uint32_t nvm_scan_end(uint8_t page)
+{
+    uint32_t offset = NVM_PAGE_HDR_SIZE;
+    nvm_rec_hdr_t hdr;
+
+    while (nvm_next(page, &offset, &hdr)) {
+        offset += nvm_record_size(hdr.len);
+    }
+    return offset;
+}
+
+static bool nvm_find(uint8_t page, uint16_t record_id, uint32_t *p_found, nvm_rec_hdr_t *p_found_hdr)
+{
+    uint32_t offset = NVM_PAGE_HDR_SIZE;
+    nvm_rec_hdr_t hdr;
+    bool found = false;
+
+    while (nvm_next(page, &offset, &hdr)) {
+        if (hdr.id == record_id && nvm_record_ok(page, offset, &hdr)) {
+            *p_found = offset;
+            if (p_found_hdr) *p_found_hdr = hdr;
+            found = true;
+        }
+        offset += nvm_record_size(hdr.len);
+    }
+    return found;
+}
+
+static void nvm_append(uint8_t page, uint32_t offset, uint16_t record_id, const uint8_t *p_data, uint16_t len)
+{
+    static uint32_t words[NVM_MAX_RECORD_LEN / 4U];
+    nvm_rec_hdr_t hdr = {
+        .id = record_id,
+        .len = len,
+        .crc = nvm_crc16(p_data, len),
+        .marker = NVM_REC_VALID,
+    };
+    uint32_t hdr_words[2];
+    uint16_t n_words = (uint16_t)((len + 3U) / 4U);
+
+    memcpy(hdr_words, &hdr, sizeof(hdr_words));
+    memset(words, 0xFF, n_words * 4U);
+    memcpy(words, p_data, len);
+
+    nvm_flash_write(page, offset, &hdr_words[0], 1);
+    nvm_flash_write(page, offset + NVM_REC_HDR_SIZE, words, n_words);
+    nvm_flash_write(page, offset + 4U, &hdr_words[1], 1);
+}
+
+static void nvm_write_page_header(uint8_t page, uint32_t sequence)
+{
+    uint32_t hdr[2] = { NVM_PAGE_MAGIC, sequence };
+    nvm_flash_write(page, 0, hdr, 2);
+}
+
+/**
+ * Copy the newest copy of each other record, then the new one, to the
+ * spare page. Returns -2 (active page untouched) if they do not fit.
+ */
+static int nvm_compact(uint16_t record_id, const uint8_t *p_data, uint16_t len)
+{
+    uint8_t src = m_nvm.active_page;
+    uint8_t dst = (uint8_t)((src + 1U) % NVM_PAGE_COUNT);
+    uint32_t offset = NVM_PAGE_HDR_SIZE;
+    uint32_t dst_offset = NVM_PAGE_HDR_SIZE;
+    nvm_rec_hdr_t hdr;
+
+    nvm_flash_erase(dst);
+
+    while (nvm_next(src, &offset, &hdr)) {
+        uint32_t newest;
+        if (hdr.id != record_id &&
+            nvm_find(src, hdr.id, &newest, NULL) && newest == offset) {
+            nvm_append(dst, dst_offset, hdr.id, nvm_flash_ptr(src, offset + NVM_REC_HDR_SIZE), hdr.len);
+            dst_offset += nvm_record_size(hdr.len);
+        }
+        offset += nvm_record_size(hdr.len);
+    }
+
+    if (dst_offset + nvm_record_size(len) > NVM_PAGE_SIZE) {
+        return -2;      /* Spare page has no header, so it never mounts */
+    }
+    nvm_append(dst, dst_offset, record_id, p_data, len);
+    dst_offset += nvm_record_size(len);
+
+    /* Commit: new page becomes valid only now */
+    m_nvm.sequence++;
+    nvm_write_page_header(dst, m_nvm.sequence);
+    nvm_flash_erase(src);
+
+    m_nvm.active_page = dst;
+    m_nvm.write_offset = dst_offset;
+    return 0;
+}
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+void nvm_store_format(void)
+{
+    for (uint8_t page = 0; page < NVM_PAGE_COUNT; page++) {
+        nvm_flash_erase(page);
+    }
+    m_nvm.active_page = 0;
+    m_nvm.sequence = 1;
+    nvm_write_page_header(0, m_nvm.sequence);
+    m_nvm.write_offset = NVM_PAGE_HDR_SIZE;
+    m_nvm.mounted = true;
+}
+
+int nvm_store_init(void)
+{
+    bool found = false;
+
+    for (uint8_t page = 0; page < NVM_PAGE_COUNT; page++) {
+        uint32_t seq;
+        if (nvm_page_valid(page, &seq) && (!found || seq > m_nvm.sequence)) {
+            m_nvm.active_page = page;
+            m_nvm.sequence = seq;
+            found = true;
+        }
+    }
+
+    if (!found) {
+        nvm_store_format();
+        return 0;
+    }
+
+    m_nvm.write_offset = nvm_scan_end(m_nvm.active_page);
+    m_nvm.mounted = true;
+    return 0;
+}
+
+int nvm_store_write(uint16_t record_id, const void *p_data, uint16_t len)
+{
+    if (!p_data || len == 0U || len > NVM_MAX_RECORD_LEN || record_id == NVM_ERASED_U16) {
+        return -1;
+    }
+    if (!m_nvm.mounted) {
+        nvm_store_init();
+    }
+
+    uint32_t size = nvm_record_size(len);
+    if (m_nvm.write_offset + size > NVM_PAGE_SIZE) {
+        return nvm_compact(record_id, (const uint8_t *)p_data, len);
+    }
+
+    nvm_append(m_nvm.active_page, m_nvm.write_offset, record_id, (const uint8_t *)p_data, len);
+    m_nvm.write_offset += size;
+    return 0;
+}
+
+int nvm_store_read(uint16_t record_id, void *p_data, uint16_t len)
+{
+    if (!p_data || len == 0U) return -1;
+    if (!m_nvm.mounted) {
+        nvm_store_init();
+    }
+
+    uint32_t offset;
+    nvm_rec_hdr_t hdr;
+    if (!nvm_find(m_nvm.active_page, record_id, &offset, &hdr)) return -3;
+    if (hdr.len != len) return -4;
+
+    memcpy(p_data, nvm_flash_ptr(m_nvm.active_page, offset + NVM_REC_HDR_SIZE), len);
+    return 0;
+}
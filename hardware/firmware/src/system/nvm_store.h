@@ -0,0 +1,88 @@
+/**
+ * @file nvm_store.h
+ * @brief Neural Load Ring Non-Volatile Record Store
+ *
+ * Small log-structured key/record store on two internal flash pages.
+ * Records are appended with a CRC; reading returns the newest valid copy.
+ * When the active page fills, the latest copy of every record is compacted
+ * into the other page and the old page is erased, so each page sees one
+ * erase per fill rather than one per write.
+ *
+ * Flash goes through the HAL; host backends keep the pages in RAM (the
+ * simulator can persist them to a file with --flash).
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef NVM_STORE_H
+#define NVM_STORE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
+
+#define NVM_PAGE_SIZE               4096U       /**< nRF52833 flash page */
+#define NVM_PAGE_COUNT              2U
+#define NVM_FLASH_BASE              0x0006E000U /**< Below bootloader */
+#define NVM_MAX_RECORD_LEN          256U
+
+/** Record IDs (never reuse a retired ID) */
+typedef enum {
+    NVM_RECORD_STRESS_CALIBRATION = 0x0001,
+    NVM_RECORD_OTA_PROGRESS       = 0x0002,   /**< Interrupted OTA transfer */
+    NVM_RECORD_OTA_PENDING        = 0x0003,   /**< Verified image in bank B (read by the bootloader) */
+    NVM_RECORD_BLE_BOND           = 0x0004,   /**< + slot: bonded central (0x0004..0x0007, ble_bond.h) */
+} nvm_record_id_t;
+
+/*******************************************************************************
+ * PUBLIC API
+ ******************************************************************************/
+
+/**
+ * @brief Mount the store (select active page, find write offset)
+ *
+ * Formats the area if no valid page is found.
+ *
+ * @return 0 on success
+ */
+int nvm_store_init(void);
+
+/**
+ * @brief Write (replace) a record
+ *
+ * @param record_id Record ID
+ * @param p_data    Data
+ * @param len       Length in bytes (1..NVM_MAX_RECORD_LEN)
+ * @return 0 on success, -1 invalid args, -2 no space after compaction
+ *         (the previous copy of the record is kept)
+ */
+int nvm_store_write(uint16_t record_id, const void *p_data, uint16_t len);
+
+/**
+ * @brief Read the newest copy of a record
+ *
+ * @param record_id Record ID
+ * @param p_data    Output buffer
+ * @param len       Expected length; must match the stored length
+ * @return 0 on success, -1 invalid args, -3 not found, -4 length mismatch
+ */
+int nvm_store_read(uint16_t record_id, void *p_data, uint16_t len);
+
+/**
+ * @brief Erase all records
+ */
+void nvm_store_format(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NVM_STORE_H */
@@ -0,0 +1,475 @@
+/**
+ * @file ota_update.c
+ * @brief Neural Load Ring Delta OTA Update Implementation
+ *
+ * Bank B is written in order, one word at a time, and each page is erased
+ * when the first byte lands in it. A checkpoint records the decoder with
+ * its pending partial word, so resuming replays at most OTA_CHECKPOINT_BLOCKS
+ * blocks: words after the checkpoint in the current page are rewritten with
+ * the same value (two writes per word, within the nRF52 nWRITE limit) and
+ * later pages are erased again on entry.
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "ota_update.h"
+#include "nvm_store.h"
+#include "../hal/hal.h"
+#include <stddef.h>
+#include <string.h>
+
+#ifdef NRF_SDK_PRESENT
+#include "app_timer.h"
+#include "nrf.h"
+#endif
+
+/*******************************************************************************
+ * PRIVATE DATA
+ ******************************************************************************/
+
+enum {
+    OTA_PH_HEADER,
+    OTA_PH_SEEK,
+    OTA_PH_DIFF_LEN,
+    OTA_PH_EXTRA_LEN,
+    OTA_PH_DIFF,
+    OTA_PH_EXTRA,
+    OTA_PH_DONE,
+};
+
+/** Checkpoint record (NVM_RECORD_OTA_PROGRESS); patch_size 0 = none */
+typedef struct {
+    uint32_t patch_size;
+    uint32_t patch_crc;
+    uint32_t rx_crc;            /**< CRC32 of the blocks applied so far */
+    uint16_t next_block;
+    uint16_t reserved;
+    ota_patch_t patch;
+} ota_progress_t;
+
+/** Image waiting for the bootloader (NVM_RECORD_OTA_PENDING); size 0 = none */
+typedef struct {
+    uint32_t target_size;
+    uint32_t target_crc;
+} ota_pending_t;
+
+static struct {
+    ota_progress_t xfer;
+    bool active;
+    bool pending;
+    bool reset_scheduled;
+} m_ota;
+
+#ifdef NRF_SDK_PRESENT
+APP_TIMER_DEF(m_ota_reset_timer);
+
+static void ota_reset_timeout(void *p_context)
+{
+    (void)p_context;
+    NVIC_SystemReset();
+}
+#endif
+
+/** CRC32 nibble table (reflected 0xEDB88320) */
+static const uint32_t m_crc32_nibble[16] = {
+    0x00000000U, 0x1DB71064U, 0x3B6E20C8U, 0x26D930ACU,
+    0x76DC4190U, 0x6B6B51F4U, 0x4DB26158U, 0x5005713CU,
+    0xEDB88320U, 0xF00F9344U, 0xD6D6A3E8U, 0xCB61B38CU,
+    0x9B64C2B0U, 0x86D3D2D4U, 0xA00AE278U, 0xBDBDF21CU,
+};
+
+/*******************************************************************************
+ * PATCH DECODER
+ ******************************************************************************/
+
+static inline uint32_t ota_rd32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void ota_flush_word(ota_patch_t *p_patch)
+{
+    uint32_t word;
+
+    if (p_patch->word_len == 0U) return;
+    memset(&p_patch->word[p_patch->word_len], 0xFF, 4U - p_patch->word_len);
+    memcpy(&word, p_patch->word, 4);
+    hal_flash_write_words(OTA_BANK_B_ADDR + ((p_patch->out_pos - 1U) & ~3U), &word, 1);
+    p_patch->word_len = 0;
+}
+
+static int ota_emit(ota_patch_t *p_patch, uint8_t byte)
+{
+    if (p_patch->out_pos >= p_patch->target_size) return -4;
+
+    if ((p_patch->out_pos % HAL_FLASH_PAGE_SIZE) == 0U) {
+        hal_flash_erase_page(OTA_BANK_B_ADDR + p_patch->out_pos);
+    }
+    p_patch->word[p_patch->word_len++] = byte;
+    p_patch->out_pos++;
+    if (p_patch->word_len == 4U) {
+        ota_flush_word(p_patch);
+    }
+    return 0;
+}
+
+static int ota_emit_from_source(ota_patch_t *p_patch, uint8_t delta)
+{
+    if (p_patch->src_pos < 0 || (uint32_t)p_patch->src_pos >= p_patch->source_size) return -4;
+
+    uint8_t src = *hal_flash_ptr(OTA_BANK_A_ADDR + (uint32_t)p_patch->src_pos);
+    p_patch->src_pos++;
+    return ota_emit(p_patch, (uint8_t)(src + delta));
+}
+
+/** Accumulate a LEB128 varint; returns 1 when complete */
+static int ota_varint(ota_patch_t *p_patch, uint8_t byte)
+{
+    if (p_patch->varint_shift > 28U) return -4;
+
+    p_patch->varint |= (uint32_t)(byte & 0x7FU) << p_patch->varint_shift;
+    p_patch->varint_shift = (uint8_t)(p_patch->varint_shift + 7U);
+    return (byte & 0x80U) ? 0 : 1;
+}
+
+static int ota_parse_header(ota_patch_t *p_patch)
+{
+    if (ota_rd32(&p_patch->hdr[0]) != OTA_PATCH_MAGIC) return -4;
+
+    p_patch->source_size = ota_rd32(&p_patch->hdr[4]);
+    p_patch->source_crc = ota_rd32(&p_patch->hdr[8]);
+    p_patch->target_size = ota_rd32(&p_patch->hdr[12]);
+    p_patch->target_crc = ota_rd32(&p_patch->hdr[16]);
+
+    if (p_patch->source_size > OTA_BANK_SIZE ||
+        p_patch->target_size == 0U || p_patch->target_size > OTA_BANK_SIZE) {
+        return -4;
+    }
+    if (ota_crc32(0, hal_flash_ptr(OTA_BANK_A_ADDR), p_patch->source_size) != p_patch->source_crc) {
+        return -5;
+    }
+    p_patch->phase = OTA_PH_SEEK;
+    return 0;
+}
+
+static void ota_end_entry(ota_patch_t *p_patch)
+{
+    p_patch->phase = (p_patch->out_pos == p_patch->target_size) ? OTA_PH_DONE : OTA_PH_SEEK;
+}
+
+static void ota_start_data(ota_patch_t *p_patch)
+{
+    if (p_patch->diff_left) {
+        p_patch->phase = OTA_PH_DIFF;
+    } else if (p_patch->extra_left) {
+        p_patch->phase = OTA_PH_EXTRA;
+    } else {
+        ota_end_entry(p_patch);
+    }
+}
+
+static int ota_patch_byte(ota_patch_t *p_patch, uint8_t byte)
+{
+    int err = 0;
+
+    switch (p_patch->phase) {
+        case OTA_PH_HEADER:
+            p_patch->hdr[p_patch->hdr_len++] = byte;
+            if (p_patch->hdr_len == OTA_PATCH_HDR_SIZE) {
+                err = ota_parse_header(p_patch);
+            }
+            break;
+
+        case OTA_PH_SEEK:
+        case OTA_PH_DIFF_LEN:
+        case OTA_PH_EXTRA_LEN:
+            err = ota_varint(p_patch, byte);
+            if (err <= 0) break;
+            err = 0;
+            if (p_patch->phase == OTA_PH_SEEK) {
+                uint32_t zz = p_patch->varint;
+                p_patch->src_pos += (int32_t)(zz >> 1) ^ -(int32_t)(zz & 1U);
+                p_patch->phase = OTA_PH_DIFF_LEN;
+            } else if (p_patch->phase == OTA_PH_DIFF_LEN) {
+                p_patch->diff_left = p_patch->varint;
+                p_patch->phase = OTA_PH_EXTRA_LEN;
+            } else {
+                p_patch->extra_left = p_patch->varint;
+                if (p_patch->diff_left + p_patch->extra_left > p_patch->target_size - p_patch->out_pos) {
+                    return -4;
+                }
+                ota_start_data(p_patch);
+            }
+            p_patch->varint = 0;
+            p_patch->varint_shift = 0;
+            break;
+
+        case OTA_PH_DIFF:
+            if (p_patch->run_left == 0U) {
+                p_patch->run_zero = (byte & 0x80U) ? 1U : 0U;
+                p_patch->run_left = (uint8_t)((byte & 0x7FU) + 1U);
+                if (p_patch->run_left > p_patch->diff_left) return -4;
+                p_patch->diff_left -= p_patch->run_left;
+                if (!p_patch->run_zero) break;
+
+                /* Unchanged bytes: copy the whole run now */
+                while (p_patch->run_left && err == 0) {
+                    err = ota_emit_from_source(p_patch, 0);
+                    p_patch->run_left--;
+                }
+            } else {
+                err = ota_emit_from_source(p_patch, byte);
+                p_patch->run_left--;
+            }
+            if (err == 0 && p_patch->run_left == 0U && p_patch->diff_left == 0U) {
+                if (p_patch->extra_left) {
+                    p_patch->phase = OTA_PH_EXTRA;
+                } else {
+                    ota_end_entry(p_patch);
+                }
+            }
+            break;
+
+        case OTA_PH_EXTRA:
+            err = ota_emit(p_patch, byte);
+            if (err == 0 && --p_patch->extra_left == 0U) {
+                ota_end_entry(p_patch);
+            }
+            break;
+
+        default:
+            err = -4;   /* Bytes after the image is complete */
+            break;
+    }
+    return err;
+}
+
+/*******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+
+static void ota_save_progress(void)
+{
+    (void)nvm_store_write(NVM_RECORD_OTA_PROGRESS, &m_ota.xfer, sizeof(m_ota.xfer));
+}
+
+static void ota_clear_progress(void)
+{
+    ota_progress_t none;
+
+    memset(&none, 0, sizeof(none));
+    (void)nvm_store_write(NVM_RECORD_OTA_PROGRESS, &none, sizeof(none));
+    m_ota.active = false;
+}
+
+static void ota_set_pending(uint32_t target_size, uint32_t target_crc)
+{
+    ota_pending_t pending = { .target_size = target_size, .target_crc = target_crc };
+
+    (void)nvm_store_write(NVM_RECORD_OTA_PENDING, &pending, sizeof(pending));
+    m_ota.pending = (target_size != 0U);
+}
+
+static inline uint16_t ota_block_count(uint32_t patch_size)
+{
+    return (uint16_t)((patch_size + OTA_BLOCK_SIZE - 1U) / OTA_BLOCK_SIZE);
+}
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+uint32_t ota_crc32(uint32_t crc, const void *p_data, uint32_t len)
+{
+    const uint8_t *p = (const uint8_t *)p_data;
+
+    crc = ~crc;
+    for (uint32_t i = 0; i < len; i++) {
+        crc = (crc >> 4) ^ m_crc32_nibble[(crc ^ p[i]) & 0x0FU];
+        crc = (crc >> 4) ^ m_crc32_nibble[(crc ^ (uint32_t)(p[i] >> 4)) & 0x0FU];
+    }
+    return ~crc;
+}
+
+void ota_update_init(void)
+{
+    ota_pending_t pending;
+
+    memset(&m_ota, 0, sizeof(m_ota));
+
+    if (nvm_store_read(NVM_RECORD_OTA_PROGRESS, &m_ota.xfer, sizeof(m_ota.xfer)) == 0 &&
+        m_ota.xfer.patch_size != 0U) {
+        m_ota.active = true;
+    } else {
+        memset(&m_ota.xfer, 0, sizeof(m_ota.xfer));
+    }
+    if (nvm_store_read(NVM_RECORD_OTA_PENDING, &pending, sizeof(pending)) == 0) {
+        m_ota.pending = (pending.target_size != 0U);
+    }
+
+#ifdef NRF_SDK_PRESENT
+    (void)app_timer_create(&m_ota_reset_timer, APP_TIMER_MODE_SINGLE_SHOT, ota_reset_timeout);
+#endif
+}
+
+int ota_update_start(uint32_t patch_size, uint32_t patch_crc)
+{
+    if (patch_size <= OTA_PATCH_HDR_SIZE || patch_size > 2U * OTA_BANK_SIZE) {
+        return -1;
+    }
+
+    if (m_ota.active && m_ota.xfer.patch_size == patch_size && m_ota.xfer.patch_crc == patch_crc) {
+        return m_ota.xfer.next_block;
+    }
+
+    /* New image: a finished but not yet installed one is overwritten */
+    if (m_ota.pending) {
+        ota_set_pending(0, 0);
+    }
+    memset(&m_ota.xfer, 0, sizeof(m_ota.xfer));
+    m_ota.xfer.patch_size = patch_size;
+    m_ota.xfer.patch_crc = patch_crc;
+    m_ota.active = true;
+    return 0;
+}
+
+int ota_update_block(uint16_t index, const uint8_t *p_data, uint16_t len, uint32_t crc)
+{
+    if (!m_ota.active || p_data == NULL) return -1;
+    if (index != m_ota.xfer.next_block) return -3;
+
+    uint16_t last = (uint16_t)(ota_block_count(m_ota.xfer.patch_size) - 1U);
+    uint32_t expect = (index < last) ? OTA_BLOCK_SIZE :
+                      m_ota.xfer.patch_size - (uint32_t)last * OTA_BLOCK_SIZE;
+    if (index > last || len != expect) return -1;
+    if (ota_crc32(0, p_data, len) != crc) return -2;
+
+    for (uint16_t i = 0; i < len; i++) {
+        int err = ota_patch_byte(&m_ota.xfer.patch, p_data[i]);
+        if (err != 0) {
+            ota_clear_progress();
+            return err;
+        }
+    }
+
+    m_ota.xfer.rx_crc = ota_crc32(m_ota.xfer.rx_crc, p_data, len);
+    m_ota.xfer.next_block++;
+    if ((m_ota.xfer.next_block % OTA_CHECKPOINT_BLOCKS) == 0U) {
+        ota_save_progress();
+    }
+    return 0;
+}
+
+int ota_update_finish(void)
+{
+    ota_patch_t *p_patch = &m_ota.xfer.patch;
+
+    if (!m_ota.active) return -1;
+    if (m_ota.xfer.next_block != ota_block_count(m_ota.xfer.patch_size) ||
+        p_patch->phase != OTA_PH_DONE) {
+        return -6;
+    }
+
+    ota_flush_word(p_patch);
+
+    bool ok = (m_ota.xfer.rx_crc == m_ota.xfer.patch_crc) &&
+              (ota_crc32(0, hal_flash_ptr(OTA_BANK_B_ADDR), p_patch->target_size) == p_patch->target_crc);
+
+    ota_clear_progress();
+    if (!ok) return -7;
+
+    /* Bootloader copies bank B over bank A on the next reset, then clears this */
+    ota_set_pending(p_patch->target_size, p_patch->target_crc);
+    return 0;
+}
+
+void ota_update_abort(void)
+{
+    if (m_ota.active) {
+        ota_clear_progress();
+    }
+}
+
+uint16_t ota_update_next_block(void)
+{
+    return m_ota.active ? m_ota.xfer.next_block : 0U;
+}
+
+bool ota_update_pending(void)
+{
+    return m_ota.pending;
+}
+
+void ota_update_schedule_reset(void)
+{
+    if (m_ota.reset_scheduled) return;
+
+    m_ota.reset_scheduled = true;
+#ifdef NRF_SDK_PRESENT
+    if (app_timer_start(m_ota_reset_timer, APP_TIMER_TICKS(OTA_RESET_DELAY_MS), NULL) != NRF_SUCCESS) {
+        NVIC_SystemReset();     /* No timer: reset now rather than never */
+    }
+#endif
+}
+
+bool ota_update_reset_scheduled(void)
+{
+    return m_ota.reset_scheduled;
+}
+
+uint16_t ota_update_on_write(const uint8_t *p_data, uint16_t len, uint8_t *p_rsp)
+{
+    int err = -1;
+
+    if (p_data == NULL || len == 0U || p_rsp == NULL) return 0;
+
+    p_rsp[0] = p_data[0];
+
+    switch (p_data[0]) {
+        case OTA_OP_START:
+            if (len == 9U) {
+                err = ota_update_start(ota_rd32(&p_data[1]), ota_rd32(&p_data[5]));
+            }
+            if (err >= 0) {
+                p_rsp[1] = 0;
+                p_rsp[2] = (uint8_t)(err & 0xFF);
+                p_rsp[3] = (uint8_t)(err >> 8);
+                return 4;
+            }
+            break;
+
+        case OTA_OP_DATA:
+            if (len > 7U) {
+                uint16_t index = (uint16_t)(p_data[1] | (p_data[2] << 8));
+                err = ota_update_block(index, &p_data[7], (uint16_t)(len - 7U), ota_rd32(&p_data[3]));
+            }
+            /* Acknowledge checkpoints and errors only; data goes as write-without-response */
+            if (err == 0 && (m_ota.xfer.next_block % OTA_CHECKPOINT_BLOCKS) != 0U) {
+                return 0;
+            }
+            p_rsp[1] = (uint8_t)(int8_t)err;
+            p_rsp[2] = (uint8_t)(ota_update_next_block() & 0xFF);
+            p_rsp[3] = (uint8_t)(ota_update_next_block() >> 8);
+            return 4;
+
+        case OTA_OP_FINISH:
+            err = (len == 1U) ? ota_update_finish() : -1;
+            if (err == 0) {
+                /* Bootloader installs bank B on reset */
+                ota_update_schedule_reset();
+            }
+            break;
+
+        case OTA_OP_ABORT:
+            ota_update_abort();
+            err = 0;
+            break;
+
+        default:
+            break;
+    }
+
+    p_rsp[1] = (uint8_t)(int8_t)err;
+    return 2;
+}
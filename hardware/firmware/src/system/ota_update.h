@@ -0,0 +1,184 @@
+/**
+ * @file ota_update.h
+ * @brief Neural Load Ring Delta OTA Update
+ *
+ * Dual-bank update fed by a binary delta instead of a full image. The
+ * running application always lives in bank A; the bootloader copies a
+ * verified bank B over it on the next reset. A patch describes the new
+ * image in terms of bank A, bsdiff-style:
+ *
+ *   header   magic, source size/CRC32, target size/CRC32 (5 x u32, LE)
+ *   entries  zigzag varint seek (moves the source position), varint
+ *            diff_len, varint extra_len, then diff_len delta bytes (added
+ *            to the source bytes) and extra_len new bytes
+ *
+ * Delta bytes are run-length coded (token < 0x80: token + 1 literal deltas
+ * follow; token >= 0x80: (token & 0x7F) + 1 zero deltas, i.e. unchanged
+ * bytes), which is where recompiled code compresses: moved functions turn
+ * into long zero runs around a few changed addresses. The decoder is a
+ * byte-at-a-time state machine, so the patch is applied straight into bank
+ * B as blocks arrive, one word buffer deep.
+ *
+ * Transfer is in OTA_BLOCK_SIZE blocks, each with its own CRC32. Decoder
+ * state is checkpointed in nvm_store every OTA_CHECKPOINT_BLOCKS blocks;
+ * after a disconnect or reset, START with the same patch returns the block
+ * to resume from.
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef OTA_UPDATE_H
+#define OTA_UPDATE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
+
+/** Flash map (nRF52833, 512 KB): MBR + S140 below bank A, nvm_store above bank B */
+#define OTA_BANK_A_ADDR             0x00027000U /**< Running application */
+#define OTA_BANK_B_ADDR             0x0004A000U /**< Update target */
+#define OTA_BANK_SIZE               0x00023000U /**< 140 KB each */
+
+#define OTA_BLOCK_SIZE              128U    /**< Patch bytes per DATA packet (GATT path needs ATT MTU >= 138) */
+#define OTA_CHECKPOINT_BLOCKS       16U     /**< Blocks between persisted checkpoints */
+#define OTA_RESET_DELAY_MS          500U    /**< FINISH response goes out before the reset */
+
+#define OTA_PATCH_MAGIC             0x44524C4EU /**< "NLRD" */
+#define OTA_PATCH_HDR_SIZE          20U
+
+/** Packets on the OTA characteristic (central writes, ring notifies) */
+typedef enum {
+    OTA_OP_START  = 0x01,   /**< u32 patch size, u32 patch CRC32 -> status, u16 next block */
+    OTA_OP_DATA   = 0x02,   /**< u16 block, u32 block CRC32, data -> status, u16 next block */
+    OTA_OP_FINISH = 0x03,   /**< -> status */
+    OTA_OP_ABORT  = 0x04,   /**< -> status */
+} ota_op_t;
+
+#define OTA_RSP_MAX_LEN             4U
+
+/** Status ble_stack.c answers with, without running the packet: the link is not bonded and encrypted */
+#define OTA_STATUS_INSECURE_LINK    (-8)
+
+/*******************************************************************************
+ * TYPES
+ ******************************************************************************/
+
+/** Streaming patch decoder (persisted as-is in checkpoints) */
+typedef struct {
+    uint32_t source_size;
+    uint32_t source_crc;
+    uint32_t target_size;
+    uint32_t target_crc;
+    uint32_t out_pos;           /**< Bytes of bank B produced */
+    int32_t  src_pos;           /**< Read position in bank A */
+    uint32_t diff_left;
+    uint32_t extra_left;
+    uint32_t varint;
+    uint8_t  varint_shift;
+    uint8_t  phase;
+    uint8_t  run_left;          /**< Remaining bytes of the current delta token */
+    uint8_t  run_zero;          /**< Current token is a zero run */
+    uint8_t  hdr[OTA_PATCH_HDR_SIZE];
+    uint8_t  hdr_len;
+    uint8_t  word_len;          /**< Bytes pending in word */
+    uint8_t  word[4];
+} ota_patch_t;
+
+/*******************************************************************************
+ * PUBLIC API
+ ******************************************************************************/
+
+/**
+ * @brief Load any interrupted transfer from nvm_store (after nvm_store_init)
+ */
+void ota_update_init(void);
+
+/**
+ * @brief Begin or resume a transfer
+ *
+ * A patch with the same size and CRC as an interrupted one resumes from its
+ * last checkpoint (or from where it stopped, if the ring did not reset).
+ *
+ * @param patch_size  Patch length in bytes
+ * @param patch_crc   CRC32 of the whole patch
+ * @return Next block expected (>= 0), -1 invalid size
+ */
+int ota_update_start(uint32_t patch_size, uint32_t patch_crc);
+
+/**
+ * @brief Apply one block
+ *
+ * @param index   Block number (must be the next one expected)
+ * @param p_data  Block data (OTA_BLOCK_SIZE, shorter for the last block)
+ * @param len     Length
+ * @param crc     CRC32 of the block
+ * @return 0 on success, -1 no transfer / bad length, -2 CRC mismatch,
+ *         -3 out of order, -4 malformed patch, -5 patch not for this image
+ */
+int ota_update_block(uint16_t index, const uint8_t *p_data, uint16_t len, uint32_t crc);
+
+/**
+ * @brief Verify bank B and mark it for the bootloader
+ *
+ * The application resets once the response has been sent.
+ *
+ * @return 0 on success, -1 no transfer, -6 incomplete, -7 verification failed
+ */
+int ota_update_finish(void);
+
+/**
+ * @brief Drop the transfer and its checkpoint
+ */
+void ota_update_abort(void);
+
+/**
+ * @brief Next block expected by the current transfer
+ */
+uint16_t ota_update_next_block(void);
+
+/**
+ * @brief True once a verified image is waiting in bank B
+ */
+bool ota_update_pending(void);
+
+/**
+ * @brief Reset into the bootloader OTA_RESET_DELAY_MS from now
+ *
+ * A successful FINISH packet calls this. One-shot app_timer on target;
+ * host builds only record the request.
+ */
+void ota_update_schedule_reset(void);
+
+/**
+ * @brief True once a reset into the bootloader is scheduled
+ */
+bool ota_update_reset_scheduled(void);
+
+/**
+ * @brief Handle a write to the OTA characteristic
+ *
+ * @param[in]  p_data  Packet (see ota_op_t)
+ * @param[in]  len     Length
+ * @param[out] p_rsp   Response, OTA_RSP_MAX_LEN bytes
+ * @return Response length (0: nothing to notify)
+ */
+uint16_t ota_update_on_write(const uint8_t *p_data, uint16_t len, uint8_t *p_rsp);
+
+/**
+ * @brief CRC32 (IEEE 802.3), chainable: pass the previous result, 0 to start
+ */
+uint32_t ota_crc32(uint32_t crc, const void *p_data, uint32_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OTA_UPDATE_H */
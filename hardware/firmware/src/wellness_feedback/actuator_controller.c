@@ -12,6 +12,8 @@
 #include "actuator_controller.h"
 #include "thermal_feature.h"
 #include "vibration_feature.h"
+#include <stddef.h>
+#include <string.h>
 
 /*******************************************************************************
  * CONFIGURATION
@@ -22,6 +24,13 @@
 #define MAX_DURATION_MS         60000U      /**< 60s max for any single command */
 #define COMBINED_VIB_CAP        60U         /**< Cap vibration when combined with thermal */
 
+/** Heater budget windows: hour in 5 min slots, day in 1 h slots */
+#define HEAT_HOUR_SLOTS         12U
+#define HEAT_HOUR_SLOT_MS       300000U
+#define HEAT_DAY_SLOTS          24U
+#define HEAT_DAY_SLOT_MS        3600000U
+#define HEAT_UNITS_PER_DS       100000U     /**< Duty-% x ms in one duty-second */
+
 /*******************************************************************************
  * PRIVATE STATE
  ******************************************************************************/
@@ -32,8 +41,18 @@ static struct {
     bool thermal_running;
     bool vibration_running;
     int8_t skin_temp_c;
+
+    /* Heater energy (duty-% x ms) per slot; slots are absolute indices */
+    uint32_t heat_hour[HEAT_HOUR_SLOTS];
+    uint32_t heat_day[HEAT_DAY_SLOTS];
+    uint32_t hour_slot;
+    uint32_t day_slot;
+    uint32_t last_tick_ms;
+    bool ticked;
+    uint8_t battery_soc_pct;
 } m_ctrl = {
     .active.type = ACTUATOR_NONE,
+    .battery_soc_pct = 100,
 };
 
 /*******************************************************************************
@@ -134,6 +153,75 @@ static void stop_outputs(void)
     m_ctrl.vibration_running = false;
 }
 
+/**
+ * Clear slots that fell out of a window since it last advanced
+ */
+static void heat_roll(uint32_t *p_slots, uint32_t count, uint32_t *p_current, uint32_t slot)
+{
+    if (slot < *p_current || slot - *p_current >= count) {
+        /* Long gap (or timer wrap): whole window is stale */
+        for (uint32_t i = 0; i < count; i++) p_slots[i] = 0;
+    } else {
+        for (uint32_t n = *p_current + 1U; n <= slot; n++) p_slots[n % count] = 0;
+    }
+    *p_current = slot;
+}
+
+/**
+ * Charge the heater output since the last tick to both windows
+ */
+static void heat_account(uint32_t now_ms)
+{
+    uint32_t used = 0;
+
+    if (m_ctrl.ticked && now_ms >= m_ctrl.last_tick_ms) {
+        uint32_t dt = now_ms - m_ctrl.last_tick_ms;
+        if (dt > HEAT_HOUR_SLOT_MS) dt = HEAT_HOUR_SLOT_MS;  /* Missed ticks */
+        used = thermal_feature_get_duty() * dt;
+    }
+    m_ctrl.last_tick_ms = now_ms;
+    m_ctrl.ticked = true;
+
+    heat_roll(m_ctrl.heat_hour, HEAT_HOUR_SLOTS, &m_ctrl.hour_slot, now_ms / HEAT_HOUR_SLOT_MS);
+    heat_roll(m_ctrl.heat_day, HEAT_DAY_SLOTS, &m_ctrl.day_slot, now_ms / HEAT_DAY_SLOT_MS);
+    m_ctrl.heat_hour[m_ctrl.hour_slot % HEAT_HOUR_SLOTS] += used;
+    m_ctrl.heat_day[m_ctrl.day_slot % HEAT_DAY_SLOTS] += used;
+}
+
+/**
+ * Remaining energy in one window, budget scaled by SoC
+ */
+static uint64_t heat_left(const uint32_t *p_slots, uint32_t count, uint32_t budget_ds, uint32_t soc_scale)
+{
+    uint64_t budget = (uint64_t)budget_ds * HEAT_UNITS_PER_DS * soc_scale / 100U;
+    uint64_t used = 0;
+
+    for (uint32_t i = 0; i < count; i++) used += p_slots[i];
+    return (used < budget) ? budget - used : 0U;
+}
+
+/**
+ * Remaining heater energy (duty-% x ms), tighter of the two windows
+ */
+static uint64_t heat_remaining(void)
+{
+    uint32_t soc = m_ctrl.battery_soc_pct;
+    uint32_t scale;
+
+    if (soc >= ACTUATOR_HEAT_SOC_FULL_PCT) {
+        scale = 100U;
+    } else if (soc <= ACTUATOR_HEAT_SOC_CUTOFF_PCT) {
+        scale = 0U;
+    } else {
+        scale = (100U * (soc - ACTUATOR_HEAT_SOC_CUTOFF_PCT)) /
+                (ACTUATOR_HEAT_SOC_FULL_PCT - ACTUATOR_HEAT_SOC_CUTOFF_PCT);
+    }
+
+    uint64_t hour = heat_left(m_ctrl.heat_hour, HEAT_HOUR_SLOTS, ACTUATOR_HEAT_BUDGET_HOUR_DS, scale);
+    uint64_t day = heat_left(m_ctrl.heat_day, HEAT_DAY_SLOTS, ACTUATOR_HEAT_BUDGET_DAY_DS, scale);
+    return (hour < day) ? hour : day;
+}
+
 /*******************************************************************************
  * PUBLIC API
  ******************************************************************************/
@@ -143,6 +231,7 @@ void actuator_init(void)
     /* Initialize drivers */
     thermal_feature_init();
     vibration_feature_init();
+    vibration_feature_set_drive(VIB_DRIVE_OVERDRIVE);  /* ERM: kick + coast-aware timing */
     
     /* Clear state */
     m_ctrl.active.type = ACTUATOR_NONE;
@@ -155,6 +244,14 @@ void actuator_init(void)
     m_ctrl.vibration_running = false;
     m_ctrl.skin_temp_c = 25;
     
+    /* Fresh heater budget; SoC is kept until the next battery update */
+    memset(m_ctrl.heat_hour, 0, sizeof(m_ctrl.heat_hour));
+    memset(m_ctrl.heat_day, 0, sizeof(m_ctrl.heat_day));
+    m_ctrl.hour_slot = 0;
+    m_ctrl.day_slot = 0;
+    m_ctrl.last_tick_ms = 0;
+    m_ctrl.ticked = false;
+    
     stop_outputs();
 }
 
@@ -180,6 +277,25 @@ int actuator_apply(actuator_cmd_t cmd, uint32_t now_ms)
         }
     }
     
+    /* Heater budget: shorten thermal output, or drop it when nothing fits */
+    if ((cmd.type == ACTUATOR_THERMAL || cmd.type == ACTUATOR_COMBINED) && cmd.intensity_pct > 0) {
+        uint8_t intensity = cmd.intensity_pct;
+        uint8_t duration_s = (uint8_t)((cmd.duration_ms + 999U) / 1000U);
+        
+        if (actuator_heat_fit(&intensity, &duration_s, cmd.intensity_pct)) {
+            if (duration_s * 1000U < cmd.duration_ms) {
+                cmd.duration_ms = duration_s * 1000U;
+            }
+        } else if (cmd.type == ACTUATOR_COMBINED) {
+            cmd.type = ACTUATOR_VIBRATION;
+            if (cmd.intensity_pct > COMBINED_VIB_CAP) {
+                cmd.intensity_pct = COMBINED_VIB_CAP;
+            }
+        } else {
+            return 0;  /* Budget exhausted */
+        }
+    }
+    
     /* Accept command */
     m_ctrl.active = cmd;
     m_ctrl.active.timestamp_ms = now_ms;
@@ -241,6 +357,12 @@ void actuator_tick(uint32_t now_ms)
     /* Update skin temperature for safety monitoring */
     thermal_feature_update_skin_temp(m_ctrl.skin_temp_c);
     
+    /* Charge the heater budget; cut the heater once it runs out */
+    heat_account(now_ms);
+    if (thermal_feature_is_active() && heat_remaining() == 0U) {
+        thermal_feature_stop();
+    }
+    
     /* Process driver state machines */
     thermal_feature_tick(now_ms);
     vibration_feature_tick(now_ms);
@@ -300,4 +422,68 @@ void actuator_update_skin_temp(int8_t temp_c)
 {
     m_ctrl.skin_temp_c = temp_c;
     thermal_feature_update_skin_temp(temp_c);
-}
\ No newline at end of file
+}
+
+void actuator_set_battery_soc(uint8_t soc_pct)
+{
+    m_ctrl.battery_soc_pct = (soc_pct > 100U) ? 100U : soc_pct;
+}
+
+uint16_t actuator_heat_budget_ds(void)
+{
+    return (uint16_t)(heat_remaining() / HEAT_UNITS_PER_DS);
+}
+
+bool actuator_heat_fit(uint8_t *p_intensity, uint8_t *p_duration_s, uint8_t min_intensity)
+{
+    if (p_intensity == NULL || p_duration_s == NULL) return false;
+    if (*p_intensity == 0 || *p_duration_s == 0) return true;  /* No heat requested */
+    
+    /* Budget in intensity-% x seconds */
+    uint64_t left = heat_remaining() / 1000U;
+    uint32_t intensity = *p_intensity;
+    uint32_t duration = *p_duration_s;
+    uint32_t floor_i = (min_intensity < MIN_INTENSITY) ? MIN_INTENSITY : min_intensity;
+    uint32_t half = duration / 2U;
+    
+    if (floor_i > intensity) floor_i = intensity;
+    if (half < ACTUATOR_HEAT_MIN_S) half = ACTUATOR_HEAT_MIN_S;
+    
+    if ((uint64_t)intensity * duration <= left) return true;
+    
+    /* Shorter at the same intensity */
+    if (left / intensity >= half) {
+        *p_duration_s = (uint8_t)(left / intensity);
+        return true;
+    }
+    
+    /* Gentler at half duration */
+    if (half <= duration && left / half >= floor_i) {
+        *p_intensity = (uint8_t)(left / half);
+        *p_duration_s = (uint8_t)half;
+        return true;
+    }
+    
+    /* Gentlest, as long as it lasts */
+    if (left / floor_i >= ACTUATOR_HEAT_MIN_S) {
+        *p_intensity = (uint8_t)floor_i;
+        *p_duration_s = (uint8_t)((left / floor_i < duration) ? left / floor_i : duration);
+        return true;
+    }
+    return false;
+}
+
+uint32_t actuator_state_save(void *p_buf, uint32_t cap)
+{
+    if (p_buf != NULL && cap >= sizeof(m_ctrl)) {
+        memcpy(p_buf, &m_ctrl, sizeof(m_ctrl));
+    }
+    return (uint32_t)sizeof(m_ctrl);
+}
+
+int actuator_state_load(const void *p_buf, uint32_t len)
+{
+    if (p_buf == NULL || len != sizeof(m_ctrl)) return -1;
+    memcpy(&m_ctrl, p_buf, sizeof(m_ctrl));
+    return 0;
+}
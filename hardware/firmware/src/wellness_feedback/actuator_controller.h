@@ -10,6 +10,12 @@
  *   - Safety limit enforcement
  *   - Coordinated thermal/vibration output
  *   - Pattern synchronization
+ *   - Rolling heater energy budget (per hour and per day, scaled by SoC)
+ *
+ * Heater energy is counted in duty-seconds: one second at 100 % duty. The
+ * budget is enforced here, so every source of thermal commands (BLE,
+ * autonomous cues) draws from the same account; cue builders query it with
+ * actuator_heat_fit() to pick a variant that still fits.
  *
  * Copyright (c) 2024-2026 Neural Load Ring Project
  * SPDX-License-Identifier: MIT
@@ -25,6 +31,16 @@
 extern "C" {
 #endif
 
+/*******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
+
+#define ACTUATOR_HEAT_BUDGET_HOUR_DS    60U     /**< Duty-seconds per rolling hour */
+#define ACTUATOR_HEAT_BUDGET_DAY_DS     240U    /**< Duty-seconds per rolling day */
+#define ACTUATOR_HEAT_SOC_FULL_PCT      50U     /**< Full budget at or above this SoC */
+#define ACTUATOR_HEAT_SOC_CUTOFF_PCT    15U     /**< No heating at or below this SoC */
+#define ACTUATOR_HEAT_MIN_S             3U      /**< Shortest thermal output worth running */
+
 /*******************************************************************************
  * TYPES
  ******************************************************************************/
@@ -136,6 +152,53 @@ bool actuator_is_active(void);
  */
 void actuator_update_skin_temp(int8_t temp_c);
 
+/**
+ * @brief Update battery state of charge for the heater budget
+ *
+ * The budget is full at ACTUATOR_HEAT_SOC_FULL_PCT and above and shrinks
+ * linearly to nothing at ACTUATOR_HEAT_SOC_CUTOFF_PCT.
+ *
+ * @param soc_pct Battery state of charge 0-100
+ */
+void actuator_set_battery_soc(uint8_t soc_pct);
+
+/**
+ * @brief Heater energy still available
+ * @return Duty-seconds left (the tighter of the hourly and daily windows)
+ */
+uint16_t actuator_heat_budget_ds(void);
+
+/**
+ * @brief Fit a thermal output into the remaining heater budget
+ *
+ * Leaves the request alone if it fits. Otherwise tries, in order: a
+ * shorter output (down to half the requested duration), a lower intensity
+ * (down to min_intensity) at half duration, then min_intensity for as long
+ * as the budget allows (at least ACTUATOR_HEAT_MIN_S).
+ *
+ * @param[in,out] p_intensity    Intensity 0-100
+ * @param[in,out] p_duration_s   Duration in seconds
+ * @param[in]     min_intensity  Lowest acceptable intensity
+ * @return true if the (possibly reduced) output fits, false if nothing does
+ */
+bool actuator_heat_fit(uint8_t *p_intensity, uint8_t *p_duration_s, uint8_t min_intensity);
+
+/*******************************************************************************
+ * CHECKPOINT (see system/checkpoint.h)
+ ******************************************************************************/
+
+/**
+ * @brief Copy the actuator controller state to p_buf if it fits in cap
+ * @return State size in bytes (p_buf NULL queries the size)
+ */
+uint32_t actuator_state_save(void *p_buf, uint32_t cap);
+
+/**
+ * @brief Replace the actuator controller state with a saved copy
+ * @return 0 on success, -1 if len does not match this build
+ */
+int actuator_state_load(const void *p_buf, uint32_t len);
+
 #ifdef __cplusplus
 }
 #endif
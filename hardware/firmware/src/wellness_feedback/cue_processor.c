@@ -180,6 +180,20 @@ static void build_no_cue(cue_output_t *output)
  * CUE GENERATION FUNCTIONS
  ******************************************************************************/
 
+/**
+ * Trim the thermal part of a cue to the heater budget (actuator_controller).
+ * A cue whose warmth cannot fit at all loses it; returns false in that case.
+ */
+static bool fit_heat(cue_output_t *output, uint8_t min_intensity)
+{
+    if (actuator_heat_fit(&output->thermal_intensity, &output->thermal_duration_s, min_intensity)) {
+        return true;
+    }
+    output->thermal_intensity = 0;
+    output->thermal_duration_s = 0;
+    return false;
+}
+
 static void build_alert_cue(cue_output_t *output, uint32_t now_ms)
 {
     const intensity_profile_t *p = &PROFILES[s_state.prefs.sensitivity];
@@ -191,6 +205,7 @@ static void build_alert_cue(cue_output_t *output, uint32_t now_ms)
     output->vib_pattern = VIB_PATTERN_ALERT;
     output->vib_intensity = clamp_intensity(p->vib_max, s_state.prefs.max_vib_pct);
     output->cooldown_ms = CUE_COOLDOWN_ALERT_MS;
+    fit_heat(output, p->thermal_base);
     
     record_cue(CUE_TYPE_COMBINED, now_ms);
 }
@@ -221,6 +236,7 @@ static void build_combined_cue(cue_output_t *output, const cue_input_t *input, u
         s_state.prefs.max_vib_pct
     );
     output->cooldown_ms = CUE_COOLDOWN_COMBINED_MS;
+    fit_heat(output, p->thermal_base);
     
     record_cue(CUE_TYPE_COMBINED, now_ms);
 }
@@ -272,7 +288,7 @@ static void build_vibration_cue(cue_output_t *output, const cue_input_t *input,
     record_cue(CUE_TYPE_VIBRATION, now_ms);
 }
 
-static void build_thermal_cue(cue_output_t *output, const cue_input_t *input, uint32_t now_ms)
+static bool build_thermal_cue(cue_output_t *output, const cue_input_t *input, uint32_t now_ms)
 {
     const intensity_profile_t *p = &PROFILES[s_state.prefs.sensitivity];
     
@@ -294,11 +310,15 @@ static void build_thermal_cue(cue_output_t *output, const cue_input_t *input, ui
     output->vib_pattern = VIB_PATTERN_OFF;
     output->vib_intensity = 0;
     output->cooldown_ms = CUE_COOLDOWN_THERMAL_MS;
+    if (!fit_heat(output, p->thermal_base)) {
+        return false;
+    }
     
     record_cue(CUE_TYPE_THERMAL, now_ms);
+    return true;
 }
 
-static void build_preventive_cue(cue_output_t *output, uint32_t now_ms)
+static bool build_preventive_cue(cue_output_t *output, uint32_t now_ms)
 {
     const intensity_profile_t *p = &PROFILES[s_state.prefs.sensitivity];
     
@@ -309,8 +329,12 @@ static void build_preventive_cue(cue_output_t *output, uint32_t now_ms)
     output->vib_pattern = VIB_PATTERN_OFF;
     output->vib_intensity = 0;
     output->cooldown_ms = (CUE_COOLDOWN_THERMAL_MS * 3) / 2;
+    if (!fit_heat(output, output->thermal_intensity)) {
+        return false;  /* Preventive warmth is never worth less than base */
+    }
     
     record_cue(CUE_TYPE_THERMAL, now_ms);
+    return true;
 }
 
 static void build_check_fit_cue(cue_output_t *output, uint32_t now_ms)
@@ -466,16 +490,16 @@ bool cue_processor_generate(const cue_input_t *input, cue_output_t *output)
     
     /* 5. THERMAL: Medium-low coherence */
     if (input->coherence_pct < CUE_COHERENCE_MEDIUM && s_state.prefs.thermal_enabled) {
-        if (can_trigger(CUE_TYPE_THERMAL, now_ms, CUE_COOLDOWN_THERMAL_MS)) {
-            build_thermal_cue(output, input, now_ms);
+        if (can_trigger(CUE_TYPE_THERMAL, now_ms, CUE_COOLDOWN_THERMAL_MS) &&
+            build_thermal_cue(output, input, now_ms)) {
             return true;
         }
     }
     
     /* 6. PREVENTIVE: Deteriorating trend */
     if (detect_deteriorating_trend() && s_state.prefs.thermal_enabled) {
-        if (can_trigger(CUE_TYPE_THERMAL, now_ms, CUE_COOLDOWN_THERMAL_MS * 2)) {
-            build_preventive_cue(output, now_ms);
+        if (can_trigger(CUE_TYPE_THERMAL, now_ms, CUE_COOLDOWN_THERMAL_MS * 2) &&
+            build_preventive_cue(output, now_ms)) {
             return true;
         }
     }
@@ -520,3 +544,18 @@ void cue_processor_get_stats(
     if (last_cue_type) *last_cue_type = s_state.last_cue_type;
     if (last_cue_ms) *last_cue_ms = s_state.last_cue_ms;
 }
+
+uint32_t cue_processor_state_save(void *p_buf, uint32_t cap)
+{
+    if (p_buf != NULL && cap >= sizeof(s_state)) {
+        memcpy(p_buf, &s_state, sizeof(s_state));
+    }
+    return (uint32_t)sizeof(s_state);
+}
+
+int cue_processor_state_load(const void *p_buf, uint32_t len)
+{
+    if (p_buf == NULL || len != sizeof(s_state)) return -1;
+    memcpy(&s_state, p_buf, sizeof(s_state));
+    return 0;
+}
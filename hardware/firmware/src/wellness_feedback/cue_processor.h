@@ -188,6 +188,22 @@ void cue_processor_get_stats(
     uint32_t *last_cue_ms
 );
 
+/*******************************************************************************
+ * CHECKPOINT (see system/checkpoint.h)
+ ******************************************************************************/
+
+/**
+ * @brief Copy the cue processor state to p_buf if it fits in cap
+ * @return State size in bytes (p_buf NULL queries the size)
+ */
+uint32_t cue_processor_state_save(void *p_buf, uint32_t cap);
+
+/**
+ * @brief Replace the cue processor state with a saved copy
+ * @return 0 on success, -1 if len does not match this build
+ */
+int cue_processor_state_load(const void *p_buf, uint32_t len);
+
 #ifdef __cplusplus
 }
 #endif
@@ -591,3 +591,24 @@ uint8_t signature_safe_thermal(uint8_t requested)
     }
     return requested;
 }
+
+uint32_t signature_state_save(void *p_buf, uint32_t cap)
+{
+    if (p_buf != NULL && cap >= sizeof(s_sig)) {
+        memcpy(p_buf, &s_sig, sizeof(s_sig));
+    }
+    return (uint32_t)sizeof(s_sig);
+}
+
+int signature_state_load(const void *p_buf, uint32_t len)
+{
+    if (p_buf == NULL || len != sizeof(s_sig)) return -1;
+    memcpy(&s_sig, p_buf, sizeof(s_sig));
+
+    /* Outputs belong to the vibration and thermal modules' own state */
+    if (s_sig.steps != NULL) {
+        s_sig.steps = ((uint32_t)s_sig.current_pattern < SIG_PATTERN_COUNT)
+                          ? PATTERNS[s_sig.current_pattern] : NULL;
+    }
+    return 0;
+}
@@ -237,6 +237,22 @@ uint8_t signature_safe_vibration(uint8_t requested);
  */
 uint8_t signature_safe_thermal(uint8_t requested);
 
+/*******************************************************************************
+ * CHECKPOINT (see system/checkpoint.h)
+ ******************************************************************************/
+
+/**
+ * @brief Copy the signature player state to p_buf if it fits in cap
+ * @return State size in bytes (p_buf NULL queries the size)
+ */
+uint32_t signature_state_save(void *p_buf, uint32_t cap);
+
+/**
+ * @brief Replace the signature player state with a saved copy
+ * @return 0 on success, -1 if len does not match this build
+ */
+int signature_state_load(const void *p_buf, uint32_t len);
+
 #ifdef __cplusplus
 }
 #endif
@@ -17,14 +17,13 @@
 
 #include "thermal_feature.h"
 #include "../sensors/temperature_sensor.h"
+#include "../hal/hal.h"
 #include <string.h>
 
 /*******************************************************************************
  * CONFIGURATION
  ******************************************************************************/
 
-#define PWM_FREQUENCY_HZ        1000    /**< PWM frequency */
-#define PWM_TOP_VALUE           1000    /**< PWM counter top (1000 = 0.1% resolution) */
 #define TEMP_CHECK_INTERVAL_MS  500     /**< Skin temp check interval */
 #define RUNAWAY_RATE_C_PER_S    2       /**< Max safe temp rise rate */
 
@@ -53,7 +52,7 @@ static const thermal_step_t PATTERN_BURST[] = {
     {500, 100}, {500, 90}, {500, 70}, {1000, 50}, {1500, 30}, {1000, 10}, {0, 0}
 };
 
-static const thermal_step_t* PATTERNS[] = {
+static const thermal_step_t* THERMAL_PATTERNS[] = {
     NULL,           /* OFF */
     NULL,           /* CONSTANT (no pattern) */
     PATTERN_PULSE,
@@ -61,7 +60,7 @@ static const thermal_step_t* PATTERNS[] = {
     PATTERN_BURST,
 };
 
-#define NUM_PATTERNS (sizeof(PATTERNS) / sizeof(PATTERNS[0]))
+#define NUM_THERMAL_PATTERNS (sizeof(THERMAL_PATTERNS) / sizeof(THERMAL_PATTERNS[0]))
 
 /*******************************************************************************
  * PRIVATE STATE
@@ -102,68 +101,29 @@ static struct {
 };
 
 /*******************************************************************************
- * HARDWARE ABSTRACTION
+ * HEATER OUTPUT
  ******************************************************************************/
 
 /**
- * Initialize PWM peripheral for thermal control
+ * Set heater duty cycle (0-100%), clamped to the burn-prevention limit
  */
-static void hw_pwm_init(void)
-{
-    /*
-     * nRF52833 PWM configuration:
-     *   - PWM1 instance (PWM0 used by vibration)
-     *   - 1kHz frequency
-     *   - Pin: P0.23
-     *   - Polarity: Active high (MOSFET gate)
-     *
-     * Example (nRF SDK):
-     *   nrf_drv_pwm_config_t config = {
-     *       .output_pins = { PIN_THERMAL_PWM, NRF_DRV_PWM_PIN_NOT_USED, ... },
-     *       .base_clock = NRF_PWM_CLK_1MHz,
-     *       .count_mode = NRF_PWM_MODE_UP,
-     *       .top_value = PWM_TOP_VALUE,
-     *       .load_mode = NRF_PWM_LOAD_INDIVIDUAL,
-     *   };
-     *   nrf_drv_pwm_init(&m_pwm1, &config, NULL);
-     */
-}
-
-/**
- * Set PWM duty cycle (0-100%)
- */
-static void hw_set_pwm(uint8_t duty_pct)
+static void heater_set_duty(uint8_t duty_pct)
 {
     if (duty_pct > THERMAL_MAX_INTENSITY_PCT) {
         duty_pct = THERMAL_MAX_INTENSITY_PCT;
     }
-    
-    /*
-     * Convert percentage to PWM compare value
-     * duty_value = (duty_pct * PWM_TOP_VALUE) / 100
-     *
-     * Example:
-     *   nrf_pwm_values_individual_t values = {
-     *       .channel_0 = (duty_pct * PWM_TOP_VALUE) / 100
-     *   };
-     *   nrf_drv_pwm_simple_playback(&m_pwm1, &seq, 1, 0);
-     */
-    (void)duty_pct;
+    hal_pwm_set(HAL_PWM_HEATER, duty_pct);
 }
 
 /**
- * Enable/disable heater MOSFET gate driver
+ * Enable/disable the heater; disabling forces the gate low. There is no
+ * separate MOSFET driver enable on this board.
  */
-static void hw_enable(bool enable)
+static void heater_enable(bool enable)
 {
     if (!enable) {
-        hw_set_pwm(0);
+        heater_set_duty(0);
     }
-    /*
-     * Optional: separate enable pin for MOSFET driver
-     * nrf_gpio_pin_write(PIN_THERMAL_EN, enable ? 1 : 0);
-     */
-    (void)enable;
 }
 
 /*******************************************************************************
@@ -217,7 +177,7 @@ static void enter_fault(thermal_fault_t fault)
     m_thermal.fault = fault;
     m_thermal.state = THERMAL_STATE_FAULT;
     m_thermal.current_duty = 0;
-    hw_enable(false);
+    heater_enable(false);
 }
 
 /*******************************************************************************
@@ -296,8 +256,8 @@ void thermal_feature_init(void)
     m_thermal.state = THERMAL_STATE_OFF;
     m_thermal.skin_temp_c = 25;
     
-    hw_pwm_init();
-    hw_enable(false);
+    hal_pwm_init(HAL_PWM_HEATER);
+    heater_enable(false);
 }
 
 void thermal_feature_set(uint8_t intensity_pct)
@@ -355,12 +315,12 @@ void thermal_feature_set_timed(uint8_t intensity_pct, uint8_t duration_s)
     m_thermal.state = THERMAL_STATE_RAMPING;
     m_thermal.current_duty = 0;
     
-    hw_enable(true);
+    heater_enable(true);
 }
 
 void thermal_feature_play(thermal_pattern_t pattern, uint8_t intensity_pct, uint8_t duration_s)
 {
-    if (pattern >= NUM_PATTERNS || pattern == THERMAL_PATTERN_OFF) {
+    if (pattern >= NUM_THERMAL_PATTERNS || pattern == THERMAL_PATTERN_OFF) {
         thermal_feature_stop();
         return;
     }
@@ -374,7 +334,7 @@ void thermal_feature_play(thermal_pattern_t pattern, uint8_t intensity_pct, uint
     thermal_feature_set_timed(intensity_pct, duration_s);
     
     m_thermal.pattern = pattern;
-    m_thermal.pattern_steps = PATTERNS[pattern];
+    m_thermal.pattern_steps = THERMAL_PATTERNS[pattern];
     m_thermal.step_index = 0;
     m_thermal.step_start_ms = 0;
     m_thermal.pattern_looping = true;  /* Patterns loop until duration expires */
@@ -388,8 +348,8 @@ void thermal_feature_stop(void)
     m_thermal.current_duty = 0;
     m_thermal.pattern_steps = NULL;
     
-    hw_set_pwm(0);
-    hw_enable(false);
+    heater_set_duty(0);
+    heater_enable(false);
     
     /* Enter cooldown if we were active */
     if (m_thermal.state == THERMAL_STATE_ACTIVE || 
@@ -421,7 +381,7 @@ void thermal_feature_tick(uint32_t now_ms)
         {
             /* Soft-start ramp */
             m_thermal.current_duty = calculate_ramp_duty(now_ms);
-            hw_set_pwm(m_thermal.current_duty);
+            heater_set_duty(m_thermal.current_duty);
             
             /* Check if ramp complete */
             if (now_ms >= m_thermal.ramp_start_ms + THERMAL_RAMP_TIME_MS) {
@@ -442,7 +402,7 @@ void thermal_feature_tick(uint32_t now_ms)
             
             /* Apply current intensity */
             m_thermal.current_duty = m_thermal.target_intensity;
-            hw_set_pwm(m_thermal.current_duty);
+            heater_set_duty(m_thermal.current_duty);
             
             /* Check auto-shutoff */
             if (now_ms >= m_thermal.end_ms) {
@@ -471,7 +431,7 @@ void thermal_feature_tick(uint32_t now_ms)
             
         case THERMAL_STATE_FAULT:
             /* Stay in fault until cleared */
-            hw_enable(false);
+            heater_enable(false);
             break;
     }
 }
@@ -512,4 +472,26 @@ void thermal_feature_clear_fault(void)
             m_thermal.prev_temp_ms = 0;  /* Reset runaway detection */
         }
     }
-}
\ No newline at end of file
+}
+
+uint32_t thermal_feature_state_save(void *p_buf, uint32_t cap)
+{
+    if (p_buf != NULL && cap >= sizeof(m_thermal)) {
+        memcpy(p_buf, &m_thermal, sizeof(m_thermal));
+    }
+    return (uint32_t)sizeof(m_thermal);
+}
+
+int thermal_feature_state_load(const void *p_buf, uint32_t len)
+{
+    if (p_buf == NULL || len != sizeof(m_thermal)) return -1;
+    memcpy(&m_thermal, p_buf, sizeof(m_thermal));
+
+    /* Step tables are addresses in this image; the gate follows the saved duty */
+    if (m_thermal.pattern_steps != NULL) {
+        m_thermal.pattern_steps = ((uint32_t)m_thermal.pattern < NUM_THERMAL_PATTERNS)
+                                      ? THERMAL_PATTERNS[m_thermal.pattern] : NULL;
+    }
+    heater_set_duty(m_thermal.current_duty);
+    return 0;
+}
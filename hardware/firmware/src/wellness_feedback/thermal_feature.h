@@ -147,6 +147,22 @@ bool thermal_feature_is_active(void);
  */
 void thermal_feature_clear_fault(void);
 
+/*******************************************************************************
+ * CHECKPOINT (see system/checkpoint.h)
+ ******************************************************************************/
+
+/**
+ * @brief Copy the heater state to p_buf if it fits in cap
+ * @return State size in bytes (p_buf NULL queries the size)
+ */
+uint32_t thermal_feature_state_save(void *p_buf, uint32_t cap);
+
+/**
+ * @brief Replace the heater state with a saved copy
+ * @return 0 on success, -1 if len does not match this build
+ */
+int thermal_feature_state_load(const void *p_buf, uint32_t len);
+
 #ifdef __cplusplus
 }
 #endif
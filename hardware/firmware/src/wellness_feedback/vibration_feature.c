@@ -10,6 +10,23 @@
  */
 
 #include "vibration_feature.h"
+#include "../hal/hal.h"
+#include <math.h>
+#include <string.h>
+
+/*******************************************************************************
+ * ERM MODEL (overdrive mode)
+ * Rotor speed in % of the full-duty no-load speed. Under drive it settles
+ * toward the duty with the mechanical time constant; with the switch open
+ * it only coasts down on friction, more slowly.
+ ******************************************************************************/
+
+#define VIB_ERM_TAU_DRIVE_MS    30.0f   /**< Mechanical time constant, driven */
+#define VIB_ERM_TAU_COAST_MS    45.0f   /**< Coast-down time constant, open circuit */
+#define VIB_ERM_FEEL_PCT        25.0f   /**< Rotor speed at which vibration is felt */
+#define VIB_KICK_DUTY           100U
+#define VIB_KICK_MAX_MS         60U
+#define VIB_EDGE_NONE           0xFFFFU
 
 /*******************************************************************************
  * PATTERN DEFINITIONS
@@ -23,29 +40,29 @@ typedef struct {
 } pattern_step_t;
 
 /* Single pulse: 100ms on */
-static const pattern_step_t PATTERN_SINGLE[] = {
+static const pattern_step_t VIB_STEPS_SINGLE[] = {
     {100, 100}, {0, 0}
 };
 
 /* Double pulse: 100ms on, 100ms off, 100ms on */
-static const pattern_step_t PATTERN_DOUBLE[] = {
+static const pattern_step_t VIB_STEPS_DOUBLE[] = {
     {100, 100}, {100, 0}, {100, 100}, {0, 0}
 };
 
 /* Triple pulse */
-static const pattern_step_t PATTERN_TRIPLE[] = {
+static const pattern_step_t VIB_STEPS_TRIPLE[] = {
     {80, 100}, {80, 0}, {80, 100}, {80, 0}, {80, 100}, {0, 0}
 };
 
 /* Heartbeat: lub-dub pattern */
-static const pattern_step_t PATTERN_HEARTBEAT[] = {
+static const pattern_step_t VIB_STEPS_HEARTBEAT[] = {
     {80, 100}, {60, 0}, {100, 80}, {760, 0},  /* ~75 BPM rhythm */
     {80, 100}, {60, 0}, {100, 80}, {760, 0},
     {80, 100}, {60, 0}, {100, 80}, {0, 0}
 };
 
 /* Breathing guide: slow sine-ish wave (4s inhale, 6s exhale) */
-static const pattern_step_t PATTERN_BREATHING[] = {
+static const pattern_step_t VIB_STEPS_BREATHING[] = {
     /* Inhale ramp up (4s) */
     {500, 20}, {500, 35}, {500, 50}, {500, 65}, {500, 80}, {500, 90}, {500, 95}, {500, 100},
     /* Exhale ramp down (6s) */
@@ -55,24 +72,24 @@ static const pattern_step_t PATTERN_BREATHING[] = {
 };
 
 /* Alert: rapid attention-getting */
-static const pattern_step_t PATTERN_ALERT[] = {
+static const pattern_step_t VIB_STEPS_ALERT[] = {
     {50, 100}, {50, 0}, {50, 100}, {50, 0}, {50, 100}, {50, 0},
     {150, 0},
     {50, 100}, {50, 0}, {50, 100}, {50, 0}, {50, 100}, {50, 0},
     {0, 0}
 };
 
-static const pattern_step_t* PATTERNS[] = {
+static const pattern_step_t* VIB_STEP_TABLES[] = {
     NULL,               /* OFF */
-    PATTERN_SINGLE,
-    PATTERN_DOUBLE,
-    PATTERN_TRIPLE,
-    PATTERN_HEARTBEAT,
-    PATTERN_BREATHING,
-    PATTERN_ALERT,
+    VIB_STEPS_SINGLE,
+    VIB_STEPS_DOUBLE,
+    VIB_STEPS_TRIPLE,
+    VIB_STEPS_HEARTBEAT,
+    VIB_STEPS_BREATHING,
+    VIB_STEPS_ALERT,
 };
 
-#define NUM_PATTERNS (sizeof(PATTERNS) / sizeof(PATTERNS[0]))
+#define NUM_VIB_STEP_TABLES (sizeof(VIB_STEP_TABLES) / sizeof(VIB_STEP_TABLES[0]))
 
 /*******************************************************************************
  * PRIVATE STATE
@@ -80,53 +97,146 @@ static const pattern_step_t* PATTERNS[] = {
 
 static struct {
     const pattern_step_t *pattern;
+    uint8_t  pattern_id;        /* VIB_STEP_TABLES index of pattern */
     uint8_t  step_index;
     uint8_t  base_intensity;    /* User-requested intensity (scaled) */
     uint8_t  current_intensity; /* Actual PWM output */
     uint32_t step_start_ms;
     bool     active;
     bool     looping;           /* For continuous patterns like breathing */
+    
+    /* Overdrive: rotor estimate and edges within the step (ms from start) */
+    vib_drive_t drive;
+    uint8_t  step_target;       /* Sustain duty of the current step */
+    uint16_t kick_ms;           /* Full duty until here */
+    uint16_t release_ms;        /* Drive off from here (coast to the step end) */
+    uint16_t lead_ms;           /* Off-step: kick for the next onset from here */
+    float    rotor_pct;
+    uint32_t rotor_ms;
 } m_vib = {0};
 
 /*******************************************************************************
- * HARDWARE ABSTRACTION
+ * PRIVATE FUNCTIONS
  ******************************************************************************/
 
-/**
- * Set motor PWM duty cycle (0-100%)
- * In real firmware: Configure nRF52 PWM peripheral
- */
-static void hw_set_pwm(uint8_t duty_pct)
-{
-    /* 
-     * nRF52833 PWM setup:
-     *   - PWM0 instance
-     *   - 200Hz frequency (5ms period) - optimal for LRA
-     *   - Pin: P0.xx (motor driver IN1 or IN2)
-     *
-     * Example (using nRF SDK):
-     *   nrf_pwm_values_individual_t pwm_values = {
-     *       .channel_0 = (duty_pct * PWM_MAX) / 100
-     *   };
-     *   nrf_drv_pwm_simple_playback(&m_pwm, &pwm_seq, 1, 0);
-     */
-    (void)duty_pct;
+/** Rotor speed after dt_ms at the given duty */
+static float erm_settle(float rotor, uint8_t duty, float dt_ms)
+{
+    float tau = (duty > 0U) ? VIB_ERM_TAU_DRIVE_MS : VIB_ERM_TAU_COAST_MS;
+    return (float)duty + (rotor - (float)duty) * expf(-dt_ms / tau);
+}
+
+/** Time at full duty to spin up from one speed to another */
+static float erm_spin_up_ms(float from, float to)
+{
+    if (from >= to) return 0.0f;
+    return VIB_ERM_TAU_DRIVE_MS * logf((100.0f - from) / (100.0f - to));
+}
+
+/** Speed reached after drive_ms of kick then sustain, from rotor */
+static float erm_after(float rotor, uint16_t kick_ms, uint8_t target, float drive_ms)
+{
+    if (drive_ms <= (float)kick_ms) {
+        return erm_settle(rotor, VIB_KICK_DUTY, drive_ms);
+    }
+    return erm_settle(erm_settle(rotor, VIB_KICK_DUTY, (float)kick_ms), target, drive_ms - (float)kick_ms);
+}
+
+/** Coast time until the vibration is no longer felt */
+static float erm_tail_ms(float rotor)
+{
+    if (rotor <= VIB_ERM_FEEL_PCT) return 0.0f;
+    return VIB_ERM_TAU_COAST_MS * logf(rotor / VIB_ERM_FEEL_PCT);
+}
+
+/** Bring the rotor estimate up to now under the current duty */
+static void erm_advance(uint32_t now_ms)
+{
+    m_vib.rotor_pct = erm_settle(m_vib.rotor_pct, m_vib.current_intensity, (float)(now_ms - m_vib.rotor_ms));
+    m_vib.rotor_ms = now_ms;
+}
+
+static void vib_output(uint8_t duty)
+{
+    m_vib.current_intensity = duty;
+    hal_pwm_set(HAL_PWM_MOTOR, duty);
+}
+
+/** Step after the current one, NULL at the end of a one-shot pattern */
+static const pattern_step_t *vib_next_step(void)
+{
+    const pattern_step_t *next = &m_vib.pattern[m_vib.step_index + 1U];
+    if (next->duration_ms == 0 && next->intensity_pct == 0) {
+        return m_vib.looping ? &m_vib.pattern[0] : NULL;
+    }
+    return next;
+}
+
+/** Kick length to bring the rotor from its estimate up to target */
+static uint16_t vib_kick_ms(uint8_t target, uint16_t limit_ms)
+{
+    if (m_vib.drive != VIB_DRIVE_OVERDRIVE || target >= VIB_KICK_DUTY) return 0;
+    
+    float kick = erm_spin_up_ms(m_vib.rotor_pct, (float)target);
+    if (kick > (float)VIB_KICK_MAX_MS) kick = (float)VIB_KICK_MAX_MS;
+    if (kick > (float)limit_ms) kick = (float)limit_ms;
+    return (uint16_t)(kick + 0.5f);
 }
 
 /**
- * Enable/disable motor driver (DRV8837 nSLEEP pin)
+ * Plan the drive edges of the step just entered (overdrive only):
+ *   on-step before an off-step: earliest release whose coast is still felt
+ *     up to the step end, so the tap ends on the authored edge
+ *   off-step before an on-step: start the next kick early enough to be felt
+ *     at the authored onset, from the speed the rotor will have coasted to
  */
-static void hw_enable_driver(bool enable)
+static void vib_plan_step(const pattern_step_t *step)
+{
+    const pattern_step_t *next = vib_next_step();
+    uint16_t duration = step->duration_ms;
+    
+    m_vib.step_target = (uint8_t)((step->intensity_pct * m_vib.base_intensity) / 100);
+    m_vib.kick_ms = vib_kick_ms(m_vib.step_target, duration);
+    m_vib.release_ms = VIB_EDGE_NONE;
+    m_vib.lead_ms = VIB_EDGE_NONE;
+    
+    if (m_vib.drive != VIB_DRIVE_OVERDRIVE) return;
+    
+    if (m_vib.step_target > 0) {
+        if (next != NULL && next->intensity_pct > 0) return;
+        
+        /* r + tail(speed at r) grows with r: bisect for the step end */
+        uint16_t lo = 1U, hi = duration;
+        while (lo < hi) {
+            uint16_t mid = (uint16_t)((lo + hi) / 2U);
+            float speed = erm_after(m_vib.rotor_pct, m_vib.kick_ms, m_vib.step_target, (float)mid);
+            if ((float)mid + erm_tail_ms(speed) >= (float)duration) {
+                hi = mid;
+            } else {
+                lo = (uint16_t)(mid + 1U);
+            }
+        }
+        if (lo < duration) m_vib.release_ms = lo;
+    } else if (next != NULL) {
+        float next_target = (float)((next->intensity_pct * m_vib.base_intensity) / 100);
+        float coasted = erm_settle(m_vib.rotor_pct, 0, (float)duration);
+        float feel = (next_target < VIB_ERM_FEEL_PCT) ? next_target : VIB_ERM_FEEL_PCT;
+        float lead = erm_spin_up_ms(coasted, feel);
+        
+        if (lead > (float)(duration / 2U)) lead = (float)(duration / 2U);
+        if (lead >= 1.0f) m_vib.lead_ms = (uint16_t)(duration - (uint16_t)lead);
+    }
+}
+
+/** Duty for the current point in the step */
+static uint8_t vib_step_duty(uint32_t elapsed)
 {
-    /*
-     * DRV8837 control:
-     *   - nSLEEP pin: HIGH = active, LOW = sleep mode
-     *   - IN1/IN2: PWM drive signals
-     *
-     * Example:
-     *   nrf_gpio_pin_write(PIN_DRV_NSLEEP, enable ? 1 : 0);
-     */
-    (void)enable;
+    if (m_vib.step_target == 0) {
+        return (elapsed >= m_vib.lead_ms) ? VIB_KICK_DUTY : 0;
+    }
+    if (elapsed >= m_vib.release_ms) return 0;
+    if (elapsed < m_vib.kick_ms) return VIB_KICK_DUTY;
+    return m_vib.step_target;
 }
 
 /*******************************************************************************
@@ -137,27 +247,37 @@ void vibration_feature_init(void)
 {
     m_vib.active = false;
     m_vib.current_intensity = 0;
-    hw_enable_driver(false);
-    hw_set_pwm(0);
+    m_vib.drive = VIB_DRIVE_PLAIN;
+    m_vib.rotor_pct = 0.0f;
+    hal_pwm_init(HAL_PWM_MOTOR);
+    hal_gpio_output(HAL_PIN_MOTOR_NSLEEP);
+    hal_gpio_write(HAL_PIN_MOTOR_NSLEEP, false);
+    hal_pwm_set(HAL_PWM_MOTOR, 0);
+}
+
+void vibration_feature_set_drive(vib_drive_t drive)
+{
+    m_vib.drive = drive;
 }
 
 void vibration_feature_play(vibration_pattern_t pattern, uint8_t intensity_pct)
 {
-    if (pattern >= NUM_PATTERNS || PATTERNS[pattern] == NULL) {
+    if (pattern >= NUM_VIB_STEP_TABLES || VIB_STEP_TABLES[pattern] == NULL) {
         vibration_feature_stop();
         return;
     }
     
     if (intensity_pct > 100) intensity_pct = 100;
     
-    m_vib.pattern = PATTERNS[pattern];
+    m_vib.pattern = VIB_STEP_TABLES[pattern];
+    m_vib.pattern_id = (uint8_t)pattern;
     m_vib.step_index = 0;
     m_vib.base_intensity = intensity_pct;
     m_vib.step_start_ms = 0;  /* Will be set on first tick */
     m_vib.active = true;
     m_vib.looping = (pattern == VIB_PATTERN_BREATHING); /* Breathing loops */
     
-    hw_enable_driver(true);
+    hal_gpio_write(HAL_PIN_MOTOR_NSLEEP, true);
 }
 
 void vibration_feature_stop(void)
@@ -165,8 +285,8 @@ void vibration_feature_stop(void)
     m_vib.active = false;
     m_vib.pattern = NULL;
     m_vib.current_intensity = 0;
-    hw_set_pwm(0);
-    hw_enable_driver(false);
+    hal_pwm_set(HAL_PWM_MOTOR, 0);
+    hal_gpio_write(HAL_PIN_MOTOR_NSLEEP, false);
 }
 
 void vibration_feature_on(uint8_t intensity_pct)
@@ -180,10 +300,12 @@ void vibration_feature_on(uint8_t intensity_pct)
     m_vib.pattern = NULL;  /* No pattern, constant output */
     m_vib.active = true;
     m_vib.base_intensity = intensity_pct;
-    m_vib.current_intensity = intensity_pct;
+    m_vib.step_target = intensity_pct;
+    m_vib.step_start_ms = 0;  /* Kick timed from the first tick */
+    m_vib.kick_ms = vib_kick_ms(intensity_pct, VIB_KICK_MAX_MS);
     
-    hw_enable_driver(true);
-    hw_set_pwm(intensity_pct);
+    hal_gpio_write(HAL_PIN_MOTOR_NSLEEP, true);
+    vib_output((m_vib.kick_ms > 0) ? VIB_KICK_DUTY : intensity_pct);
 }
 
 void vibration_feature_off(void)
@@ -193,10 +315,20 @@ void vibration_feature_off(void)
 
 void vibration_feature_tick(uint32_t now_ms)
 {
+    erm_advance(now_ms);
     if (!m_vib.active) return;
     
-    /* Constant intensity mode (no pattern) */
+    /* Constant intensity mode (no pattern): end of the onset kick */
     if (m_vib.pattern == NULL) {
+        if (m_vib.kick_ms > 0) {
+            if (m_vib.step_start_ms == 0) {
+                m_vib.step_start_ms = now_ms;
+            }
+            if (now_ms - m_vib.step_start_ms >= m_vib.kick_ms) {
+                m_vib.kick_ms = 0;
+                vib_output(m_vib.step_target);
+            }
+        }
         return;
     }
     
@@ -205,10 +337,8 @@ void vibration_feature_tick(uint32_t now_ms)
         m_vib.step_start_ms = now_ms;
         
         /* Apply first step immediately */
-        const pattern_step_t *step = &m_vib.pattern[m_vib.step_index];
-        uint8_t scaled = (uint8_t)((step->intensity_pct * m_vib.base_intensity) / 100);
-        m_vib.current_intensity = scaled;
-        hw_set_pwm(scaled);
+        vib_plan_step(&m_vib.pattern[m_vib.step_index]);
+        vib_output(vib_step_duty(0));
     }
     
     /* Check if current step duration elapsed */
@@ -235,14 +365,41 @@ void vibration_feature_tick(uint32_t now_ms)
             }
         }
         
-        /* Apply new step intensity (scaled by user intensity) */
-        uint8_t scaled = (uint8_t)((next->intensity_pct * m_vib.base_intensity) / 100);
-        m_vib.current_intensity = scaled;
-        hw_set_pwm(scaled);
+        /* Apply new step (intensity scaled by user intensity) */
+        vib_plan_step(next);
+        vib_output(vib_step_duty(0));
+    } else {
+        /* Overdrive edges within the step */
+        uint8_t duty = vib_step_duty(elapsed);
+        if (duty != m_vib.current_intensity) {
+            vib_output(duty);
+        }
     }
 }
 
 bool vibration_feature_is_active(void)
 {
     return m_vib.active;
-}
\ No newline at end of file
+}
+
+uint32_t vibration_feature_state_save(void *p_buf, uint32_t cap)
+{
+    if (p_buf != NULL && cap >= sizeof(m_vib)) {
+        memcpy(p_buf, &m_vib, sizeof(m_vib));
+    }
+    return (uint32_t)sizeof(m_vib);
+}
+
+int vibration_feature_state_load(const void *p_buf, uint32_t len)
+{
+    if (p_buf == NULL || len != sizeof(m_vib)) return -1;
+    memcpy(&m_vib, p_buf, sizeof(m_vib));
+
+    /* Step tables are addresses in this image; drive the saved output */
+    if (m_vib.pattern != NULL) {
+        m_vib.pattern = (m_vib.pattern_id < NUM_VIB_STEP_TABLES) ? VIB_STEP_TABLES[m_vib.pattern_id] : NULL;
+    }
+    hal_gpio_write(HAL_PIN_MOTOR_NSLEEP, m_vib.active);
+    hal_pwm_set(HAL_PWM_MOTOR, m_vib.current_intensity);
+    return 0;
+}
@@ -5,6 +5,13 @@
  * Controls the LRA/ERM motor via DRV8837 H-bridge for haptic feedback.
  * Supports multiple patterns for different wellness cues.
  *
+ * In VIB_DRIVE_OVERDRIVE the driver keeps a first-order estimate of rotor
+ * speed and shapes the duty around it: a full-duty kick at each onset until
+ * the rotor reaches the sustain speed, drive released early so the coast
+ * ends on the authored step edge, and the next kick started inside the
+ * preceding off-step so the rotor is felt at the authored onset. Pattern
+ * timing is then the timing the wearer feels, at less on-time.
+ *
  * Copyright (c) 2024-2026 Neural Load Ring Project
  * SPDX-License-Identifier: MIT
  */
@@ -30,8 +37,14 @@ typedef enum {
     VIB_PATTERN_ALERT = 6,      /**< Rapid attention-getting */
 } vibration_pattern_t;
 
+/** Motor drive mode */
+typedef enum {
+    VIB_DRIVE_PLAIN = 0,        /**< Duty = requested intensity */
+    VIB_DRIVE_OVERDRIVE,        /**< Onset kick + coast-aware step timing (ERM) */
+} vib_drive_t;
+
 /**
- * @brief Initialize vibration driver (PWM + GPIO)
+ * @brief Initialize vibration driver (PWM + GPIO), plain drive
  */
 void vibration_feature_init(void);
 
@@ -64,12 +77,34 @@ void vibration_feature_off(void);
  */
 void vibration_feature_tick(uint32_t now_ms);
 
+/**
+ * @brief Select the motor drive mode (takes effect at the next onset)
+ * @param drive Drive mode
+ */
+void vibration_feature_set_drive(vib_drive_t drive);
+
 /**
  * @brief Check if vibration is currently active
  * @return true if motor is running
  */
 bool vibration_feature_is_active(void);
 
+/*******************************************************************************
+ * CHECKPOINT (see system/checkpoint.h)
+ ******************************************************************************/
+
+/**
+ * @brief Copy the motor state to p_buf if it fits in cap
+ * @return State size in bytes (p_buf NULL queries the size)
+ */
+uint32_t vibration_feature_state_save(void *p_buf, uint32_t cap);
+
+/**
+ * @brief Replace the motor state with a saved copy
+ * @return 0 on success, -1 if len does not match this build
+ */
+int vibration_feature_state_load(const void *p_buf, uint32_t len);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,43 @@
+/**
+ * @file bench_common.h
+ * @brief Shared Helpers for Host Benchmarks
+ *
+ * Cycle counter (TSC on x86, monotonic clock elsewhere) and formatting used
+ * by the bench_*.c programs. Host-only.
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef BENCH_COMMON_H
+#define BENCH_COMMON_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_UNIT "cyc"
+static inline uint64_t bench_now(void)
+{
+    return __rdtsc();
+}
+#else
+#define BENCH_UNIT "ns"
+static inline uint64_t bench_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+#endif
+
+static inline void bench_header(const char *title)
+{
+    printf("╔══════════════════════════════════════════════════════════════╗\n");
+    printf("║  %-60s║\n", title);
+    printf("╚══════════════════════════════════════════════════════════════╝\n");
+}
+
+#endif /* BENCH_COMMON_H */
@@ -0,0 +1,252 @@
+/**
+ * @file bench_cue_latency.c
+ * @brief Stress-Onset-to-Cue Latency vs False Cues, per Tuning
+ *
+ * Drives the on-ring autonomous loop end to end on scripted 6 h sessions:
+ *
+ *   ppg_synth (100 Hz PPG)  ->  wellness_process_block()   beat detection
+ *   wellness_manager_tick()  ->  biometrics_process_rr()    RMSSD / stress EMAs
+ *                            ->  cue_processor_generate()   every check interval
+ *                            ->  actuator_apply_ble()
+ *
+ * The script holds calm wear with stress episodes (HR up, variability down),
+ * recoveries, motion bursts and noisy-contact stretches, replayed with
+ * BENCH_SESSIONS different seeds. For each tuning
+ * (wellness_tuning_t: check interval, RMSSD and stress EMA weights) it
+ * reports the latency from episode onset to the first cue, episodes missed
+ * (no cue before the episode ends + CUE_GRACE), and cues outside any
+ * episode window per hour. Fit nudges (CUE_TYPE_CHECK_FIT) are counted
+ * apart. Beats go through the SSF detector, as in the host smoke run.
+ *
+ * make bench also builds this with -DBIOMETRICS_FIXED_POINT
+ * (bench_cue_latency_fixed): the integer biometrics must reproduce the
+ * float table row for row.
+ *
+ * Build & run:  make bench
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "bench_common.h"
+#include "ppg_synth.h"
+
+#include "../src/hal/hal_host.c"
+#include "../src/system/nvm_store.c"
+#include "../src/system/bus_manager.c"
+#include "../src/wellness_feedback/vibration_feature.c"
+#include "../src/wellness_feedback/thermal_feature.c"
+#include "../src/wellness_feedback/cue_processor.c"
+#include "../src/wellness_feedback/actuator_controller.c"
+#include "../src/core/rr_quantile.c"
+#include "../src/core/stress_calibration.c"
+#include "../src/core/biometric_algorithms.c"
+#include "../src/core/peak_detector.c"
+#include "../src/core/detector_pan_tompkins.c"
+#include "../src/core/detector_ssf.c"
+#include "../src/core/detector_elgendi.c"
+#include "../src/core/ppg_fusion.c"
+#include "../src/core/wellness_processor.c"
+#include "../src/core/hrv_nonlinear.c"
+#include "../src/core/ppg_codec.c"
+#include "../src/sensors/ppg_capture.c"
+#include "../src/sensors/ppg_driver.c"
+#include "../src/core/wellness_manager.c"
+
+/*******************************************************************************
+ * SCENARIO
+ ******************************************************************************/
+
+#define BENCH_SESSION_MIN       360U
+#define BENCH_WARMUP_MIN        30U         /**< Baseline / calibration, not scored */
+#define BENCH_TICK_MS           250U        /**< Main loop period (25 PPG samples) */
+#define BENCH_BLOCK             (BENCH_TICK_MS / PPG_SYNTH_PERIOD_MS)
+#define BENCH_SESSIONS          3U          /**< Seeds per tuning */
+#define CUE_GRACE_MS            120000U     /**< A cue this soon after an episode still counts */
+
+#ifdef BIOMETRICS_FIXED_POINT
+#define BENCH_TITLE "STRESS ONSET -> CUE (3 x 6 H, FIXED-POINT BIOMETRICS)"
+#else
+#define BENCH_TITLE "STRESS ONSET -> CUE (3 x 6 H SCRIPTED SESSIONS)"
+#endif
+
+typedef enum { SEG_STRESS, SEG_MOTION, SEG_NOISY } seg_kind_t;
+
+typedef struct {
+    uint16_t start_min;
+    uint16_t end_min;
+    seg_kind_t kind;
+} segment_t;
+
+/* Episodes of 5-10 min with recoveries of 20+ min; motion and bad contact
+ * land both in calm stretches and on top of an episode */
+static const segment_t SCRIPT[] = {
+    {  40,  46, SEG_STRESS }, {  60,  65, SEG_MOTION }, {  80,  88, SEG_STRESS },
+    { 100, 104, SEG_NOISY  }, { 120, 125, SEG_STRESS }, { 140, 145, SEG_MOTION },
+    { 165, 175, SEG_STRESS }, { 168, 171, SEG_MOTION }, { 190, 195, SEG_NOISY  },
+    { 210, 216, SEG_STRESS }, { 230, 236, SEG_MOTION }, { 250, 258, SEG_STRESS },
+    { 275, 280, SEG_NOISY  }, { 295, 300, SEG_STRESS }, { 315, 320, SEG_MOTION },
+    { 330, 340, SEG_STRESS },
+};
+#define SCRIPT_LEN  (sizeof(SCRIPT) / sizeof(SCRIPT[0]))
+
+static bool script_active(seg_kind_t kind, uint32_t now_ms, uint32_t grace_ms, uint8_t *p_idx)
+{
+    for (uint8_t i = 0; i < SCRIPT_LEN; i++) {
+        if (SCRIPT[i].kind == kind && now_ms >= SCRIPT[i].start_min * 60000U &&
+            now_ms < SCRIPT[i].end_min * 60000U + grace_ms) {
+            if (p_idx) *p_idx = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*******************************************************************************
+ * RUNNER
+ ******************************************************************************/
+
+typedef struct {
+    uint32_t episodes;
+    uint32_t detected;
+    uint64_t latency_sum_ms;
+    uint32_t latency_max_ms;
+    uint32_t false_cues;
+    uint32_t fit_nudges;
+    uint32_t scored_calm_ms;
+} result_t;
+
+/* One seeded session; adds into p_res */
+static void run_session(const wellness_tuning_t *p_tuning, uint32_t seed, result_t *p_res)
+{
+    ppg_synth_params_t params = ppg_synth_defaults();
+    ppg_synth_t syn;
+    float block[BENCH_BLOCK];
+    uint32_t first_cue_ms[SCRIPT_LEN];
+    uint32_t seen = 0;
+
+    memset(first_cue_ms, 0, sizeof(first_cue_ms));
+
+    params.seed = seed;
+    params.motion_amp = 0.8f;
+    ppg_synth_init(&syn, &params);
+
+    hal_host_reset();
+    nvm_store_format();
+    nvm_store_init();
+    wellness_reset();
+    (void)wellness_set_detector(PEAK_DETECTOR_SSF);
+    wellness_manager_init();
+    wellness_manager_set_tuning(p_tuning);
+    cue_processor_init();
+    actuator_init();
+
+    for (uint32_t now = BENCH_TICK_MS; now <= BENCH_SESSION_MIN * 60000U; now += BENCH_TICK_MS) {
+        uint32_t t0 = now - BENCH_TICK_MS;
+        bool stress = script_active(SEG_STRESS, t0, 0, NULL);
+        bool motion = script_active(SEG_MOTION, t0, 0, NULL);
+        bool noisy = script_active(SEG_NOISY, t0, 0, NULL);
+
+        /* Calm: resting RMSSD ~36 ms; stressed: ~12 ms */
+        ppg_synth_set_physiology(&syn, stress ? 88.0f : 64.0f, stress ? 8.0f : 18.0f,
+                                 stress ? 8.0f : 25.0f);
+        syn.p.motion_per_min = motion ? 6.0f : 0.0f;
+        syn.p.noise = noisy ? 0.15f : 0.01f;
+
+        for (uint32_t i = 0; i < BENCH_BLOCK; i++) {
+            block[i] = ppg_synth_next(&syn, NULL, NULL);
+        }
+        (void)wellness_process_block(block, (uint16_t)BENCH_BLOCK, t0, PPG_SYNTH_PERIOD_MS);
+        wellness_manager_tick(now);
+        actuator_tick(now);
+
+        if (now <= BENCH_WARMUP_MIN * 60000U) {
+            cue_processor_get_stats(&seen, NULL, NULL, NULL);
+            continue;
+        }
+
+        uint8_t ep;
+        bool in_window = script_active(SEG_STRESS, now, CUE_GRACE_MS, &ep);
+        if (!in_window) p_res->scored_calm_ms += BENCH_TICK_MS;
+
+        /* Did this tick apply a cue? */
+        uint32_t generated;
+        cue_type_t type;
+        cue_processor_get_stats(&generated, NULL, &type, NULL);
+        if (generated == seen) continue;
+        seen = generated;
+
+        if (type == CUE_TYPE_CHECK_FIT) {
+            p_res->fit_nudges++;
+        } else if (!in_window) {
+            p_res->false_cues++;
+        } else if (first_cue_ms[ep] == 0U) {
+            first_cue_ms[ep] = now;
+        }
+    }
+
+    for (uint8_t i = 0; i < SCRIPT_LEN; i++) {
+        if (SCRIPT[i].kind != SEG_STRESS) continue;
+        p_res->episodes++;
+        if (first_cue_ms[i] == 0U) continue;
+        uint32_t latency = first_cue_ms[i] - SCRIPT[i].start_min * 60000U;
+        p_res->detected++;
+        p_res->latency_sum_ms += latency;
+        if (latency > p_res->latency_max_ms) p_res->latency_max_ms = latency;
+    }
+}
+
+static void report(const wellness_tuning_t *p_tuning, const result_t *p_res, bool is_default)
+{
+    double hours = (double)p_res->scored_calm_ms / 3600000.0;
+
+    printf("%7.0f %8.2f %8.2f  %8.0f %8.0f %5u/%-3u %9.2f %6u%s\n",
+           (double)p_tuning->check_interval_ms / 1000.0, (double)p_tuning->rmssd_alpha,
+           (double)p_tuning->stress_alpha,
+           p_res->detected ? (double)p_res->latency_sum_ms / p_res->detected / 1000.0 : -1.0,
+           p_res->detected ? (double)p_res->latency_max_ms / 1000.0 : -1.0,
+           (unsigned)(p_res->episodes - p_res->detected), (unsigned)p_res->episodes,
+           hours > 0.0 ? p_res->false_cues / hours : 0.0, (unsigned)p_res->fit_nudges,
+           is_default ? "  <- default" : "");
+}
+
+int main(void)
+{
+    static const uint32_t INTERVALS_MS[] = { 5000U, 15000U, 30000U };
+    static const float RMSSD_ALPHAS[] = { 0.05f, 0.1f, 0.2f };
+    static const float STRESS_ALPHAS[] = { 0.1f, 0.2f, 0.4f };
+    wellness_tuning_t defaults;
+    result_t res;
+
+    wellness_manager_init();
+    wellness_manager_get_tuning(&defaults);
+
+    bench_header(BENCH_TITLE);
+    printf("\n%7s %8s %8s  %8s %8s %9s %9s %6s\n", "check s", "rmssd a", "stress a",
+           "mean s", "max s", "missed", "false/h", "fit");
+    printf("------------------------------------------------------------------------\n");
+
+    for (uint8_t i = 0; i < 3U; i++) {
+        for (uint8_t r = 0; r < 3U; r++) {
+            for (uint8_t s = 0; s < 3U; s++) {
+                wellness_tuning_t t = {
+                    .check_interval_ms = INTERVALS_MS[i],
+                    .rmssd_alpha = RMSSD_ALPHAS[r],
+                    .stress_alpha = STRESS_ALPHAS[s],
+                };
+                memset(&res, 0, sizeof(res));
+                for (uint32_t k = 0; k < BENCH_SESSIONS; k++) {
+                    run_session(&t, 12345U + 7919U * k, &res);
+                }
+                report(&t, &res, t.check_interval_ms == defaults.check_interval_ms &&
+                                 t.rmssd_alpha == defaults.rmssd_alpha &&
+                                 t.stress_alpha == defaults.stress_alpha);
+            }
+        }
+    }
+    printf("\n");
+    return 0;
+}
@@ -0,0 +1,211 @@
+/**
+ * @file bench_detectors.c
+ * @brief Side-by-side Benchmark of PPG Peak Detector Engines
+ *
+ * Runs every engine behind peak_detector.h over the same synthetic
+ * scenarios and reports beat sensitivity / positive predictive value,
+ * RR error and cost per sample, so the cheapest engine that is accurate
+ * enough can be chosen per user / activity level.
+ *
+ * Build & run:  make bench
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench_common.h"
+#include "ppg_synth.h"
+
+#include "../src/core/peak_detector.c"
+#include "../src/core/detector_pan_tompkins.c"
+#include "../src/core/detector_ssf.c"
+#include "../src/core/detector_elgendi.c"
+
+/*******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
+
+#define BENCH_DURATION_S        300U
+#define BENCH_BLOCK             25U         /**< Samples per block (250 ms) */
+#define BENCH_MAX_BEATS         1024U
+#define BENCH_MATCH_TOL_MS      80          /**< Window around median lag */
+#define BENCH_LAG_SEARCH_MS     300
+
+typedef struct {
+    const char *name;
+    ppg_synth_params_t params;
+} scenario_t;
+
+typedef struct {
+    uint32_t truth[BENCH_MAX_BEATS];
+    uint32_t n_truth;
+    uint32_t det[BENCH_MAX_BEATS];
+    uint32_t n_det;
+    uint64_t ticks;
+    uint32_t samples;
+} run_t;
+
+/*******************************************************************************
+ * SCORING
+ ******************************************************************************/
+
+static int cmp_i32(const void *a, const void *b)
+{
+    int32_t x = *(const int32_t *)a, y = *(const int32_t *)b;
+    return (x > y) - (x < y);
+}
+
+/* Each engine marks a different fiducial point; estimate its lag first */
+static int32_t median_lag(const run_t *r)
+{
+    static int32_t lags[BENCH_MAX_BEATS];
+    uint32_t n = 0, j = 0;
+
+    for (uint32_t i = 0; i < r->n_det; i++) {
+        while (j + 1 < r->n_truth &&
+               labs((long)r->truth[j + 1] - (long)r->det[i]) <= labs((long)r->truth[j] - (long)r->det[i])) {
+            j++;
+        }
+        if (r->n_truth == 0) break;
+        int32_t d = (int32_t)r->det[i] - (int32_t)r->truth[j];
+        if (d > -BENCH_LAG_SEARCH_MS && d < BENCH_LAG_SEARCH_MS) {
+            lags[n++] = d;
+        }
+    }
+    if (n == 0) return 0;
+    qsort(lags, n, sizeof(lags[0]), cmp_i32);
+    return lags[n / 2];
+}
+
+static void score(const run_t *r, float *se, float *ppv, float *rr_mae)
+{
+    int32_t lag = median_lag(r);
+    static int32_t match_of_det[BENCH_MAX_BEATS];
+    uint32_t tp = 0, i = 0, j = 0;
+
+    for (uint32_t k = 0; k < r->n_det; k++) match_of_det[k] = -1;
+
+    /* Greedy in-order matching */
+    while (i < r->n_det && j < r->n_truth) {
+        int32_t d = (int32_t)r->det[i] - lag - (int32_t)r->truth[j];
+        if (d < -BENCH_MATCH_TOL_MS) {
+            i++;
+        } else if (d > BENCH_MATCH_TOL_MS) {
+            j++;
+        } else {
+            match_of_det[i] = (int32_t)j;
+            tp++;
+            i++;
+            j++;
+        }
+    }
+
+    /* RR error over consecutive detections matched to consecutive truths */
+    double err = 0.0;
+    uint32_t n_rr = 0;
+    for (uint32_t k = 1; k < r->n_det; k++) {
+        int32_t a = match_of_det[k - 1], b = match_of_det[k];
+        if (a >= 0 && b == a + 1) {
+            int32_t rr_det = (int32_t)(r->det[k] - r->det[k - 1]);
+            int32_t rr_true = (int32_t)(r->truth[b] - r->truth[a]);
+            err += fabs((double)(rr_det - rr_true));
+            n_rr++;
+        }
+    }
+
+    *se = r->n_truth ? 100.0f * (float)tp / (float)r->n_truth : 0.0f;
+    *ppv = r->n_det ? 100.0f * (float)tp / (float)r->n_det : 0.0f;
+    *rr_mae = n_rr ? (float)(err / n_rr) : -1.0f;
+}
+
+/*******************************************************************************
+ * RUNNER
+ ******************************************************************************/
+
+static void run_detector(peak_detector_id_t id, const ppg_synth_params_t *params, run_t *r)
+{
+    ppg_synth_t synth;
+    peak_detector_t det;
+    float block[BENCH_BLOCK];
+
+    memset(r, 0, sizeof(*r));
+    ppg_synth_init(&synth, params);
+    peak_detector_init(&det, id);
+
+    uint32_t total = BENCH_DURATION_S * PPG_SYNTH_FS_HZ;
+    for (uint32_t n = 0; n < total; n += BENCH_BLOCK) {
+        uint32_t t0 = synth.t_ms;
+        for (uint32_t k = 0; k < BENCH_BLOCK; k++) {
+            uint32_t peak_ms;
+            bool has_peak;
+            block[k] = ppg_synth_next(&synth, &peak_ms, &has_peak);
+            if (has_peak && r->n_truth < BENCH_MAX_BEATS) {
+                r->truth[r->n_truth++] = peak_ms;
+            }
+        }
+
+        uint64_t start = bench_now();
+        peak_detector_process_block(&det, block, BENCH_BLOCK, t0, PPG_SYNTH_PERIOD_MS);
+        r->ticks += bench_now() - start;
+        r->samples += BENCH_BLOCK;
+
+        ppg_beat_t beat;
+        while (peak_detector_pop(&det, &beat)) {
+            if (r->n_det < BENCH_MAX_BEATS) {
+                r->det[r->n_det++] = beat.peak_ms;
+            }
+        }
+    }
+}
+
+int main(void)
+{
+    scenario_t scenarios[5];
+    scenarios[0].name = "rest";
+    scenarios[0].params = ppg_synth_defaults();
+
+    scenarios[1].name = "noisy";
+    scenarios[1].params = ppg_synth_defaults();
+    scenarios[1].params.noise = 0.08f;
+
+    scenarios[2].name = "wander";
+    scenarios[2].params = ppg_synth_defaults();
+    scenarios[2].params.wander = 1.5f;
+
+    scenarios[3].name = "motion";
+    scenarios[3].params = ppg_synth_defaults();
+    scenarios[3].params.noise = 0.03f;
+    scenarios[3].params.motion_per_min = 3.0f;
+    scenarios[3].params.motion_amp = 0.8f;
+
+    scenarios[4].name = "exercise";
+    scenarios[4].params = ppg_synth_defaults();
+    scenarios[4].params.hr_bpm = 140.0f;
+    scenarios[4].params.hrv_sd_ms = 6.0f;
+    scenarios[4].params.rsa_ms = 5.0f;
+    scenarios[4].params.amplitude = 0.6f;
+    scenarios[4].params.noise = 0.03f;
+
+    bench_header("PPG PEAK DETECTOR BENCHMARK (300 s per scenario)");
+    printf("\n%-10s %-14s %7s %7s %9s %12s\n",
+           "scenario", "detector", "Se[%]", "PPV[%]", "RR MAE", BENCH_UNIT "/sample");
+    printf("------------------------------------------------------------------\n");
+
+    static run_t run;
+    for (size_t s = 0; s < sizeof(scenarios) / sizeof(scenarios[0]); s++) {
+        for (int id = 0; id < PEAK_DETECTOR_COUNT; id++) {
+            float se, ppv, mae;
+            run_detector((peak_detector_id_t)id, &scenarios[s].params, &run);
+            score(&run, &se, &ppv, &mae);
+            printf("%-10s %-14s %7.1f %7.1f %7.1fms %12.1f\n",
+                   scenarios[s].name, peak_detector_name((peak_detector_id_t)id),
+                   se, ppv, mae, (double)run.ticks / (double)run.samples);
+        }
+    }
+    printf("\n");
+    return 0;
+}
@@ -0,0 +1,86 @@
+/**
+ * @file bench_rr_quantile.c
+ * @brief Sliding Median / IQR: Fenwick Filter vs Sort-per-Beat
+ *
+ * Replays a long RR stream (bulk host replay case) and times median + IQR
+ * per beat with rr_quantile against copying and sorting the window.
+ *
+ * Build & run:  make bench
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "bench_common.h"
+#include "../src/core/rr_quantile.c"
+
+#define BENCH_BEATS     1000000U
+
+static uint16_t s_rr[BENCH_BEATS];
+
+static void sort_window(uint16_t *v, uint8_t n)
+{
+    for (uint8_t i = 1; i < n; i++) {
+        uint16_t x = v[i];
+        int j = i - 1;
+        while (j >= 0 && v[j] > x) {
+            v[j + 1] = v[j];
+            j--;
+        }
+        v[j + 1] = x;
+    }
+}
+
+static void run_window(uint8_t window)
+{
+    static rr_quantile_t q;
+    uint16_t tmp[RR_QUANTILE_CAPACITY];
+    uint64_t check_a = 0, check_b = 0;
+
+    rr_quantile_init(&q, window);
+    uint64_t t0 = bench_now();
+    for (uint32_t i = 0; i < BENCH_BEATS; i++) {
+        rr_quantile_push(&q, s_rr[i]);
+        check_a += rr_quantile_median(&q);
+        check_a += (uint16_t)(rr_quantile_get(&q, 75) - rr_quantile_get(&q, 25));
+    }
+    uint64_t t_fenwick = bench_now() - t0;
+
+    t0 = bench_now();
+    for (uint32_t i = 0; i < BENCH_BEATS; i++) {
+        uint8_t n = (i + 1U < window) ? (uint8_t)(i + 1U) : window;
+        memcpy(tmp, &s_rr[i + 1U - n], n * sizeof(uint16_t));
+        sort_window(tmp, n);
+        uint8_t r50 = (uint8_t)((50U * (n - 1U) + 50U) / 100U);
+        uint8_t r25 = (uint8_t)((25U * (n - 1U) + 50U) / 100U);
+        uint8_t r75 = (uint8_t)((75U * (n - 1U) + 50U) / 100U);
+        check_b += tmp[r50];
+        check_b += (uint16_t)(tmp[r75] - tmp[r25]);
+    }
+    uint64_t t_sort = bench_now() - t0;
+
+    printf("%6u %14.1f %14.1f %9.1fx %s\n", window,
+           (double)t_fenwick / BENCH_BEATS, (double)t_sort / BENCH_BEATS,
+           (double)t_sort / (double)t_fenwick, (check_a == check_b) ? "ok" : "MISMATCH");
+}
+
+int main(void)
+{
+    uint32_t rng = 12345U;
+    for (uint32_t i = 0; i < BENCH_BEATS; i++) {
+        rng = rng * 1664525U + 1013904223U;
+        s_rr[i] = (uint16_t)(700U + (rng >> 16) % 400U);
+    }
+
+    bench_header("RR SLIDING MEDIAN + IQR (1M beats)");
+    printf("\n%6s %14s %14s %10s\n", "window", "fenwick " BENCH_UNIT, "sort " BENCH_UNIT, "speedup");
+    printf("--------------------------------------------------------\n");
+    run_window(15);
+    run_window(31);
+    run_window(63);
+    printf("\n");
+    return 0;
+}
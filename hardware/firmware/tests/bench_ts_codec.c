@@ -0,0 +1,171 @@
+/**
+ * @file bench_ts_codec.c
+ * @brief On-Ring Log Compression: ts_codec over Replayed Sessions
+ *
+ * Replays an 8 h wear session (RR from the ppg_synth physiology model with
+ * stress episodes, 1 Hz skin temperature, 15 s metric snapshots) into
+ * ts_codec streams cut at flash-page size, and reports bytes against the
+ * raw 8-byte (u32 timestamp, u32 value) record, encode cost per append and
+ * decode cost per sample. Every stream is decoded and checked.
+ *
+ * Build & run:  make bench
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "bench_common.h"
+#include "ppg_synth.h"
+
+#include "../src/core/ts_codec.c"
+
+/*******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
+
+#define BENCH_SESSION_S         (8U * 3600U)
+#define BENCH_MAX_SAMPLES       65536U
+#define BENCH_PAGE_BYTES        4096U       /**< One nvm/flash page per stream block */
+#define BENCH_SNAPSHOT_MS       15000U
+
+typedef struct {
+    const char *name;
+    ts_codec_mode_t mode;
+    uint32_t n;
+    uint32_t ts[BENCH_MAX_SAMPLES];
+    uint32_t val[BENCH_MAX_SAMPLES];
+} bench_series_t;
+
+static bench_series_t s_rr, s_temp, s_stress, s_rmssd_f, s_rmssd_q;
+static uint8_t s_pages[BENCH_MAX_SAMPLES * 8U];
+
+/*******************************************************************************
+ * SESSION REPLAY
+ ******************************************************************************/
+
+static void series_add(bench_series_t *p_s, uint32_t ts, uint32_t val)
+{
+    if (p_s->n < BENCH_MAX_SAMPLES) {
+        p_s->ts[p_s->n] = ts;
+        p_s->val[p_s->n] = val;
+        p_s->n++;
+    }
+}
+
+static void build_session(void)
+{
+    ppg_synth_params_t p = ppg_synth_defaults();
+    ppg_synth_t syn;
+    double t_s = 0.0;
+    float rr_win[30] = {0};
+    uint32_t rr_n = 0, next_snap = BENCH_SNAPSHOT_MS, next_temp = 0;
+    float skin = 33.2f, stress = 0.35f;
+
+    ppg_synth_init(&syn, &p);
+    s_rr = (bench_series_t){ .name = "RR (ms)", .mode = TS_CODEC_DELTA };
+    s_temp = (bench_series_t){ .name = "skin temp (0.01 C)", .mode = TS_CODEC_DELTA };
+    s_stress = (bench_series_t){ .name = "stress (float)", .mode = TS_CODEC_XOR };
+    s_rmssd_f = (bench_series_t){ .name = "RMSSD (float)", .mode = TS_CODEC_XOR };
+    s_rmssd_q = (bench_series_t){ .name = "RMSSD (0.1 ms)", .mode = TS_CODEC_DELTA };
+
+    while (t_s < (double)BENCH_SESSION_S) {
+        /* Two stress episodes: higher HR, lower variability */
+        bool episode = (t_s > 7200.0 && t_s < 9000.0) || (t_s > 18000.0 && t_s < 19800.0);
+        ppg_synth_set_physiology(&syn, episode ? 88.0f : 64.0f, episode ? 12.0f : 28.0f,
+                                 episode ? 15.0f : 40.0f);
+
+        float rr = ppg_synth_next_rr(&syn, t_s);
+        t_s += rr / 1000.0;
+        uint32_t now = (uint32_t)(t_s * 1000.0);
+        series_add(&s_rr, now, (uint32_t)(rr + 0.5f));
+        rr_win[rr_n++ % 30U] = rr;
+
+        /* Skin temperature at 1 Hz: slow drift, ADC-level noise */
+        while (next_temp <= now) {
+            skin += 0.0002f * (episode ? 1.0f : -0.3f) + 0.01f * (float)ppg_synth_gauss(&syn);
+            series_add(&s_temp, next_temp, (uint32_t)(int32_t)(skin * 100.0f + 0.5f));
+            next_temp += 1000U;
+        }
+
+        /* Metric snapshots */
+        if (now >= next_snap && rr_n >= 30U) {
+            float ss = 0.0f;
+            for (uint32_t i = 1; i < 30U; i++) {
+                float d = rr_win[(rr_n + i) % 30U] - rr_win[(rr_n + i - 1U) % 30U];
+                ss += d * d;
+            }
+            float rmssd = sqrtf(ss / 29.0f);
+            stress += 0.05f * ((episode ? 0.8f : 0.35f) - stress);
+            float stress_q = (float)(int)(stress * 100.0f + 0.5f) / 100.0f;   /* As reported (%) */
+
+            series_add(&s_stress, now, ts_codec_float_bits(stress_q));
+            series_add(&s_rmssd_f, now, ts_codec_float_bits(rmssd));
+            series_add(&s_rmssd_q, now, (uint32_t)(rmssd * 10.0f + 0.5f));
+            next_snap += BENCH_SNAPSHOT_MS;
+        }
+    }
+}
+
+/*******************************************************************************
+ * BENCH
+ ******************************************************************************/
+
+static void run_series(const bench_series_t *p_s)
+{
+    ts_encoder_t enc;
+    uint32_t bytes = 0, pages = 0, page_counts[BENCH_MAX_SAMPLES / 8U];
+    uint16_t page_bytes[BENCH_MAX_SAMPLES / 8U];
+
+    /* Encode, opening a new page whenever the current one is full */
+    uint64_t t0 = bench_now();
+    ts_encoder_init(&enc, p_s->mode, s_pages, BENCH_PAGE_BYTES);
+    for (uint32_t i = 0; i < p_s->n; i++) {
+        if (ts_encoder_append(&enc, p_s->ts[i], p_s->val[i]) != 0) {
+            page_counts[pages] = enc.count;
+            page_bytes[pages++] = ts_encoder_bytes(&enc);
+            ts_encoder_init(&enc, p_s->mode, &s_pages[pages * BENCH_PAGE_BYTES], BENCH_PAGE_BYTES);
+            (void)ts_encoder_append(&enc, p_s->ts[i], p_s->val[i]);
+        }
+    }
+    page_counts[pages] = enc.count;
+    page_bytes[pages++] = ts_encoder_bytes(&enc);
+    uint64_t t_enc = bench_now() - t0;
+
+    /* Decode everything back */
+    uint32_t k = 0, ok = 0, ts, val;
+    t0 = bench_now();
+    for (uint32_t pg = 0; pg < pages; pg++) {
+        ts_decoder_t dec;
+        ts_decoder_init(&dec, p_s->mode, &s_pages[pg * BENCH_PAGE_BYTES], page_bytes[pg], page_counts[pg]);
+        while (ts_decoder_next(&dec, &ts, &val)) {
+            ok += (ts == p_s->ts[k] && val == p_s->val[k]);
+            k++;
+        }
+        bytes += page_bytes[pg];
+    }
+    uint64_t t_dec = bench_now() - t0;
+
+    printf("%-20s %7u %9u %8u %7.2fx %9.1f %9.1f  %s\n", p_s->name, (unsigned)p_s->n,
+           (unsigned)(p_s->n * 8U), (unsigned)bytes, (double)(p_s->n * 8U) / (double)bytes,
+           (double)t_enc / p_s->n, (double)t_dec / p_s->n, (ok == p_s->n) ? "ok" : "MISMATCH");
+}
+
+int main(void)
+{
+    build_session();
+
+    bench_header("TS_CODEC: 8 H SESSION, 4 KB PAGES");
+    printf("\n%-20s %7s %9s %8s %8s %9s %9s\n", "series", "samples", "raw B", "coded B", "ratio",
+           "enc " BENCH_UNIT, "dec " BENCH_UNIT);
+    printf("------------------------------------------------------------------------------\n");
+    run_series(&s_rr);
+    run_series(&s_temp);
+    run_series(&s_stress);
+    run_series(&s_rmssd_f);
+    run_series(&s_rmssd_q);
+    printf("\n");
+    return 0;
+}
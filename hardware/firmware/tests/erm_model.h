@@ -0,0 +1,81 @@
+/**
+ * @file erm_model.h
+ * @brief ERM Motor Model for Host Tests and the Simulator
+ *
+ * Electromechanical model of the coin ERM behind the motor PWM, driven
+ * through a low-side switch with a flyback diode. Rotor speed w is in units
+ * of the full-duty no-load speed:
+ *
+ *   driven (duty d > 0)   dw/dt = (d - w) / tau_m      torque from (dV - e*w)/R
+ *   switch open           dw/dt = -w / tau_coast       friction only, no braking
+ *
+ * The motor current (d - w, continuous through the diode) is drawn from the
+ * battery for the on-fraction d, so battery energy is the integral of
+ * d * (d - w). Vibration force goes with w^2 and is felt once w passes
+ * feel_pct; the felt on/off edges are recorded for timing checks.
+ *
+ * Header-only like ppg_synth.h; integrates in 1 ms substeps.
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef ERM_MODEL_H
+#define ERM_MODEL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+
+#define ERM_MODEL_TAU_M_MS      30.0f   /**< Mechanical time constant under drive */
+#define ERM_MODEL_TAU_COAST_MS  45.0f   /**< Coast-down time constant */
+#define ERM_MODEL_FEEL_PCT      25.0f   /**< Felt above this speed (% of full) */
+#define ERM_MODEL_MAX_EDGES     64U
+
+typedef struct {
+    float speed_pct;            /**< Rotor speed, % of full-duty speed */
+    float energy;               /**< Battery energy, duty-% x current-% x ms / 100 */
+    uint32_t t_ms;
+    uint32_t on_ms;             /**< Time with the switch driven */
+    uint32_t felt_ms;           /**< Time above the feel threshold */
+    bool felt;
+    uint32_t edges[ERM_MODEL_MAX_EDGES]; /**< Felt edges: rising, falling, ... */
+    uint8_t n_edges;
+} erm_model_t;
+
+static inline void erm_model_reset(erm_model_t *p_m)
+{
+    memset(p_m, 0, sizeof(*p_m));
+}
+
+/**
+ * @brief Advance the motor by dt_ms at a constant duty
+ */
+static inline void erm_model_step(erm_model_t *p_m, uint8_t duty_pct, uint32_t dt_ms)
+{
+    const float d = (float)duty_pct;
+    const float a_drive = 1.0f - expf(-1.0f / ERM_MODEL_TAU_M_MS);
+    const float a_coast = 1.0f - expf(-1.0f / ERM_MODEL_TAU_COAST_MS);
+
+    for (uint32_t i = 0; i < dt_ms; i++) {
+        if (duty_pct > 0U) {
+            float current = d - p_m->speed_pct;
+            if (current > 0.0f) p_m->energy += d * current / 100.0f;
+            p_m->speed_pct += (d - p_m->speed_pct) * a_drive;
+            p_m->on_ms++;
+        } else {
+            p_m->speed_pct -= p_m->speed_pct * a_coast;
+        }
+        p_m->t_ms++;
+
+        bool felt = p_m->speed_pct >= ERM_MODEL_FEEL_PCT;
+        if (felt) p_m->felt_ms++;
+        if (felt != p_m->felt && p_m->n_edges < ERM_MODEL_MAX_EDGES) {
+            p_m->edges[p_m->n_edges++] = p_m->t_ms;
+        }
+        p_m->felt = felt;
+    }
+}
+
+#endif /* ERM_MODEL_H */
@@ -0,0 +1,182 @@
+/**
+ * @file ota_delta.h
+ * @brief Delta Patch Encoder for OTA Tests and the Host Patch Tool
+ *
+ * Produces the patch format applied by system/ota_update.c from an old and
+ * a new image. Matching is a simplified bsdiff: a hash of the next
+ * OTA_DELTA_MIN_MATCH bytes proposes a source position (the position that
+ * continues the previous match is always tried too), and the match is
+ * extended while at least half of the bytes agree, so relinked code with
+ * shifted addresses still lands in the diff stream as mostly zero runs.
+ *
+ * Header-only like ppg_synth.h; needs ota_crc32() from ota_update.c.
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef OTA_DELTA_H
+#define OTA_DELTA_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include "system/ota_update.h"
+
+#define OTA_DELTA_MIN_MATCH     6U
+#define OTA_DELTA_HASH_BITS     16U
+#define OTA_DELTA_MAX_GAP       32U     /**< Mismatch stretch that ends an extension */
+
+typedef struct {
+    uint8_t *p;
+    size_t len;
+    size_t cap;
+    int overflow;
+} ota_delta_out_t;
+
+static void ota_delta_put(ota_delta_out_t *p_out, uint8_t byte)
+{
+    if (p_out->len >= p_out->cap) {
+        p_out->overflow = 1;
+        return;
+    }
+    p_out->p[p_out->len++] = byte;
+}
+
+static void ota_delta_put32(ota_delta_out_t *p_out, uint32_t v)
+{
+    for (int i = 0; i < 4; i++) ota_delta_put(p_out, (uint8_t)(v >> (8 * i)));
+}
+
+static void ota_delta_varint(ota_delta_out_t *p_out, uint32_t v)
+{
+    while (v >= 0x80U) {
+        ota_delta_put(p_out, (uint8_t)(v | 0x80U));
+        v >>= 7;
+    }
+    ota_delta_put(p_out, (uint8_t)v);
+}
+
+static inline uint32_t ota_delta_hash(const uint8_t *p)
+{
+    uint32_t h = 2166136261U;
+    for (uint32_t i = 0; i < OTA_DELTA_MIN_MATCH; i++) h = (h ^ p[i]) * 16777619U;
+    return h >> (32U - OTA_DELTA_HASH_BITS);
+}
+
+/** Approximate match length: longest prefix with the best (matches - mismatches) */
+static uint32_t ota_delta_extend(const uint8_t *p_old, uint32_t old_len, uint32_t o,
+                                 const uint8_t *p_new, uint32_t new_len, uint32_t n)
+{
+    int32_t score = 0, best_score = 0;
+    uint32_t best_len = 0;
+
+    for (uint32_t i = 0; o + i < old_len && n + i < new_len; i++) {
+        score += (p_old[o + i] == p_new[n + i]) ? 1 : -1;
+        if (score > best_score) {
+            best_score = score;
+            best_len = i + 1U;
+        }
+        if (i + 1U - best_len > OTA_DELTA_MAX_GAP) break;
+    }
+    return best_len;
+}
+
+/** Entry: seek to o, len delta bytes against p_old[o..], then extra bytes */
+static void ota_delta_entry(ota_delta_out_t *p_out, int32_t seek,
+                            const uint8_t *p_old, uint32_t o, const uint8_t *p_new, uint32_t n,
+                            uint32_t len, uint32_t extra_len)
+{
+    uint32_t i = 0;
+
+    ota_delta_varint(p_out, ((uint32_t)seek << 1) ^ (uint32_t)(seek >> 31));
+    ota_delta_varint(p_out, len);
+    ota_delta_varint(p_out, extra_len);
+
+    while (i < len) {
+        uint32_t run = 0;
+        if (p_new[n + i] == p_old[o + i]) {
+            while (i + run < len && run < 128U && p_new[n + i + run] == p_old[o + i + run]) run++;
+            ota_delta_put(p_out, (uint8_t)(0x80U | (run - 1U)));
+        } else {
+            /* Literal run; a single equal byte is cheaper inline than a token */
+            while (i + run < len && run < 128U &&
+                   (p_new[n + i + run] != p_old[o + i + run] ||
+                    (i + run + 1U < len && p_new[n + i + run + 1U] != p_old[o + i + run + 1U]))) {
+                run++;
+            }
+            ota_delta_put(p_out, (uint8_t)(run - 1U));
+            for (uint32_t k = 0; k < run; k++) {
+                ota_delta_put(p_out, (uint8_t)(p_new[n + i + k] - p_old[o + i + k]));
+            }
+        }
+        i += run;
+    }
+    for (uint32_t k = 0; k < extra_len; k++) {
+        ota_delta_put(p_out, p_new[n + len + k]);
+    }
+}
+
+/**
+ * @brief Encode a patch turning p_old into p_new
+ * @return Patch length, 0 if it does not fit in out_cap
+ */
+static size_t ota_delta_encode(const uint8_t *p_old, uint32_t old_len,
+                               const uint8_t *p_new, uint32_t new_len,
+                               uint8_t *p_patch, size_t out_cap)
+{
+    ota_delta_out_t out = { .p = p_patch, .cap = out_cap };
+    int32_t *p_table = malloc(sizeof(int32_t) << OTA_DELTA_HASH_BITS);
+    if (p_table == NULL) return 0;
+
+    for (uint32_t i = 0; i < (1U << OTA_DELTA_HASH_BITS); i++) p_table[i] = -1;
+    for (uint32_t o = 0; o + OTA_DELTA_MIN_MATCH <= old_len; o++) {
+        p_table[ota_delta_hash(&p_old[o])] = (int32_t)o;
+    }
+
+    ota_delta_put32(&out, OTA_PATCH_MAGIC);
+    ota_delta_put32(&out, old_len);
+    ota_delta_put32(&out, ota_crc32(0, p_old, old_len));
+    ota_delta_put32(&out, new_len);
+    ota_delta_put32(&out, ota_crc32(0, p_new, new_len));
+
+    /* Pending entry: match (prev_o, prev_n, prev_len), extra until the next match */
+    uint32_t prev_o = 0, prev_n = 0, prev_len = 0, src = 0;
+    uint32_t pos = 0;
+
+    while (pos + OTA_DELTA_MIN_MATCH <= new_len) {
+        uint32_t best_o = 0, best_len = 0;
+        int32_t cand[2] = {
+            p_table[ota_delta_hash(&p_new[pos])],
+            (int32_t)(prev_o + (pos - prev_n)),     /* Same alignment as the last match */
+        };
+
+        for (int c = 0; c < 2; c++) {
+            if (cand[c] < 0 || (uint32_t)cand[c] + OTA_DELTA_MIN_MATCH > old_len) continue;
+            uint32_t len = ota_delta_extend(p_old, old_len, (uint32_t)cand[c], p_new, new_len, pos);
+            if (len > best_len) {
+                best_len = len;
+                best_o = (uint32_t)cand[c];
+            }
+        }
+        if (best_len < OTA_DELTA_MIN_MATCH) {
+            pos++;
+            continue;
+        }
+
+        ota_delta_entry(&out, (int32_t)(prev_o - src), p_old, prev_o, p_new, prev_n,
+                        prev_len, pos - prev_n - prev_len);
+        src = prev_o + prev_len;
+        prev_o = best_o;
+        prev_n = pos;
+        prev_len = best_len;
+        pos += best_len;
+    }
+    ota_delta_entry(&out, (int32_t)(prev_o - src), p_old, prev_o, p_new, prev_n,
+                    prev_len, new_len - prev_n - prev_len);
+
+    free(p_table);
+    return out.overflow ? 0 : out.len;
+}
+
+#endif /* OTA_DELTA_H */
@@ -0,0 +1,210 @@
+/**
+ * @file ppg_synth.h
+ * @brief Synthetic PPG / RR Generator for Host Tests and Benchmarks
+ *
+ * Produces a 100 Hz PPG waveform (systolic + dicrotic Gaussian pulses) from
+ * an RR series with respiratory sinus arrhythmia and random variability,
+ * plus optional baseline wander, white noise and motion bursts. The true
+ * systolic peak times are reported so detectors can be scored.
+ *
+ * Header-only and deterministic (seeded xorshift), like test_framework.h.
+ *
+ * Copyright (c) 2024-2026 Neural Load Ring Project
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef PPG_SYNTH_H
+#define PPG_SYNTH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/*******************************************************************************
+ * TYPES
+ ******************************************************************************/
+
+#define PPG_SYNTH_FS_HZ         100U
+#define PPG_SYNTH_PERIOD_MS     10U
+#define PPG_SYNTH_PULSES        4U      /**< Overlapping pulses tracked */
+
+typedef struct {
+    /* Physiology */
+    float hr_bpm;               /**< Mean heart rate */
+    float hrv_sd_ms;            /**< Random beat-to-beat variation (SD) */
+    float rsa_ms;               /**< Respiratory sinus arrhythmia amplitude */
+    float resp_hz;              /**< Breathing rate */
+
+    /* Signal */
+    float amplitude;            /**< Systolic pulse amplitude */
+    float dc;                   /**< DC level */
+    float noise;                /**< White noise SD */
+    float wander;               /**< Baseline wander amplitude (0.1-0.3 Hz) */
+    float motion_per_min;       /**< Motion bursts per minute */
+    float motion_amp;           /**< Motion burst amplitude */
+    uint32_t seed;
+} ppg_synth_params_t;
+
+typedef struct {
+    ppg_synth_params_t p;
+    uint32_t rng;
+    uint32_t t_ms;              /**< Timestamp of next sample */
+    double next_onset_s;
+    double onsets_s[PPG_SYNTH_PULSES];
+    uint8_t onset_idx;
+    double motion_end_s;
+    double motion_phase;
+    uint32_t pending_peak_ms;   /**< True peak not yet reported */
+    bool pending_peak;
+    float last_rr_ms;
+} ppg_synth_t;
+
+/*******************************************************************************
+ * HELPERS
+ ******************************************************************************/
+
+static inline uint32_t ppg_synth_rand(ppg_synth_t *s)
+{
+    uint32_t x = s->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    s->rng = x;
+    return x;
+}
+
+static inline double ppg_synth_uniform(ppg_synth_t *s)
+{
+    return ((double)ppg_synth_rand(s) + 1.0) / 4294967297.0;
+}
+
+static inline double ppg_synth_gauss(ppg_synth_t *s)
+{
+    double u1 = ppg_synth_uniform(s);
+    double u2 = ppg_synth_uniform(s);
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+static inline ppg_synth_params_t ppg_synth_defaults(void)
+{
+    ppg_synth_params_t p = {
+        .hr_bpm = 65.0f,
+        .hrv_sd_ms = 25.0f,
+        .rsa_ms = 40.0f,
+        .resp_hz = 0.25f,
+        .amplitude = 1.0f,
+        .dc = 10.0f,
+        .noise = 0.01f,
+        .wander = 0.0f,
+        .motion_per_min = 0.0f,
+        .motion_amp = 0.0f,
+        .seed = 12345U,
+    };
+    return p;
+}
+
+static inline void ppg_synth_init(ppg_synth_t *s, const ppg_synth_params_t *p)
+{
+    *s = (ppg_synth_t){0};
+    s->p = *p;
+    s->rng = p->seed ? p->seed : 1U;
+    s->next_onset_s = 0.3;
+    for (uint8_t i = 0; i < PPG_SYNTH_PULSES; i++) {
+        s->onsets_s[i] = -10.0;
+    }
+}
+
+/** Change heart rate / variability mid-stream (e.g. scripted stress onset) */
+static inline void ppg_synth_set_physiology(ppg_synth_t *s, float hr_bpm, float hrv_sd_ms, float rsa_ms)
+{
+    s->p.hr_bpm = hr_bpm;
+    s->p.hrv_sd_ms = hrv_sd_ms;
+    s->p.rsa_ms = rsa_ms;
+}
+
+/** Draw the next RR interval (ms) from the physiology model */
+static inline float ppg_synth_next_rr(ppg_synth_t *s, double t_s)
+{
+    double mean_rr = 60000.0 / (double)s->p.hr_bpm;
+    double rr = mean_rr +
+                (double)s->p.rsa_ms * sin(2.0 * M_PI * (double)s->p.resp_hz * t_s) +
+                (double)s->p.hrv_sd_ms * ppg_synth_gauss(s);
+    if (rr < 320.0) rr = 320.0;
+    if (rr > 1900.0) rr = 1900.0;
+    return (float)rr;
+}
+
+/**
+ * Generate the next 100 Hz sample.
+ *
+ * @param s        Generator
+ * @param out_peak Set to the true systolic peak timestamp when one falls in
+ *                 this sample period (may be NULL)
+ * @param has_peak Set true when out_peak was written (may be NULL)
+ * @return Sample value
+ */
+static inline float ppg_synth_next(ppg_synth_t *s, uint32_t *out_peak, bool *has_peak)
+{
+    double t = (double)s->t_ms / 1000.0;
+    const double sys_delay = 0.15, sys_w = 0.05;
+    const double dic_delay = 0.40, dic_w = 0.07;
+
+    /* Schedule new beat onsets */
+    while (s->next_onset_s <= t) {
+        s->onsets_s[s->onset_idx] = s->next_onset_s;
+        s->onset_idx = (uint8_t)((s->onset_idx + 1U) % PPG_SYNTH_PULSES);
+        s->pending_peak_ms = (uint32_t)((s->next_onset_s + sys_delay) * 1000.0 + 0.5);
+        s->pending_peak = true;
+        s->last_rr_ms = ppg_synth_next_rr(s, s->next_onset_s);
+        s->next_onset_s += (double)s->last_rr_ms / 1000.0;
+    }
+
+    /* Sum overlapping pulses */
+    double v = 0.0;
+    for (uint8_t i = 0; i < PPG_SYNTH_PULSES; i++) {
+        double dt = t - s->onsets_s[i];
+        if (dt < 0.0 || dt > 1.2) continue;
+        double a = (dt - sys_delay) / sys_w;
+        double b = (dt - dic_delay) / dic_w;
+        v += exp(-0.5 * a * a) + 0.35 * exp(-0.5 * b * b);
+    }
+    v *= (double)s->p.amplitude;
+
+    /* Baseline wander (two slow sinusoids) */
+    if (s->p.wander > 0.0f) {
+        v += (double)s->p.wander * (0.7 * sin(2.0 * M_PI * 0.12 * t) + 0.3 * sin(2.0 * M_PI * 0.31 * t + 1.0));
+    }
+
+    /* Motion bursts: ~2 s of 1-3 Hz oscillation */
+    if (s->p.motion_per_min > 0.0f) {
+        if (t >= s->motion_end_s &&
+            ppg_synth_uniform(s) < (double)s->p.motion_per_min / (60.0 * PPG_SYNTH_FS_HZ)) {
+            s->motion_end_s = t + 2.0;
+            s->motion_phase = 1.0 + 2.0 * ppg_synth_uniform(s);
+        }
+        if (t < s->motion_end_s) {
+            v += (double)s->p.motion_amp * sin(2.0 * M_PI * s->motion_phase * t);
+        }
+    }
+
+    v += (double)s->p.noise * ppg_synth_gauss(s);
+    v += (double)s->p.dc;
+
+    if (has_peak) {
+        *has_peak = false;
+        if (s->pending_peak && s->pending_peak_ms <= s->t_ms) {
+            *has_peak = true;
+            if (out_peak) *out_peak = s->pending_peak_ms;
+            s->pending_peak = false;
+        }
+    }
+
+    s->t_ms += PPG_SYNTH_PERIOD_MS;
+    return (float)v;
+}
+
+#endif /* PPG_SYNTH_H */
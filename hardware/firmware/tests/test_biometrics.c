@@ -5,6 +5,7 @@
 
 #include "test_framework.h"
 #include "../src/core/biometric_algorithms.h"
+#include "../src/wellness_feedback/cue_processor.h"
 #include <math.h>
 
 TEST(biometrics_reset) {
@@ -28,6 +29,7 @@ TEST(biometrics_artifact_rejection_low) {
 
 TEST(biometrics_normal_sequence) {
     hr_metrics_t metrics;
+    hr_readout_t readout;
     biometrics_reset(&metrics);
     
     /* Simulating 800ms base RR with some variability */
@@ -35,9 +37,10 @@ TEST(biometrics_normal_sequence) {
     biometrics_process_rr(&metrics, 820.0f); /* diff = 20 */
     biometrics_process_rr(&metrics, 780.0f); /* diff = 40 */
     
+    biometrics_readout(&metrics, &readout);
     ASSERT_EQ(3, metrics.valid_samples);
-    ASSERT_TRUE(metrics.rmssd > 0.0f);
-    ASSERT_TRUE(metrics.mean_rr_ms > 700.0f && metrics.mean_rr_ms < 900.0f);
+    ASSERT_TRUE(readout.rmssd_ms > 0.0f);
+    ASSERT_TRUE(readout.mean_rr_ms > 700.0f && readout.mean_rr_ms < 900.0f);
 }
 
 TEST(biometrics_relative_artifact) {
@@ -49,9 +52,160 @@ TEST(biometrics_relative_artifact) {
     ASSERT_EQ(1, metrics.valid_samples);
 }
 
+TEST(biometrics_median_reference_recovers_after_artifact) {
+    hr_metrics_t metrics;
+    biometrics_reset(&metrics);
+    for (int i = 0; i < 10; i++) {
+        biometrics_process_rr(&metrics, (i % 2) ? 820.0f : 800.0f);
+    }
+    ASSERT_IN_RANGE(metrics.rr_median_ms, 800, 820);
+
+    /* Missed beat (double interval) is rejected ... */
+    ASSERT_FALSE(biometrics_process_rr(&metrics, 1620.0f));
+    /* ... and the next normal beat is still judged against the median */
+    ASSERT_TRUE(biometrics_process_rr(&metrics, 805.0f));
+    ASSERT_TRUE(metrics.quality_pct > 80);
+}
+
+TEST(biometrics_rmssd_smoothing_tunable) {
+    hr_metrics_t metrics;
+    hr_readout_t readout;
+    biometrics_reset(&metrics);
+    ASSERT_FLOAT_EQ(0.1f, metrics.rmssd_alpha, 0.0001f);
+    ASSERT_FLOAT_EQ(0.2f, metrics.stress_alpha, 0.0001f);
+
+    /* Default: second difference weighted 0.1 -> sqrt(0.1*1600 + 0.9*400) */
+    biometrics_process_rr(&metrics, 800.0f);
+    biometrics_process_rr(&metrics, 820.0f);
+    biometrics_process_rr(&metrics, 780.0f);
+    biometrics_readout(&metrics, &readout);
+    ASSERT_FLOAT_EQ(sqrtf(520.0f), readout.rmssd_ms, 0.01f);
+
+    /* Weight 1: RMSSD follows the latest difference only */
+    biometrics_reset(&metrics);
+    biometrics_set_smoothing(&metrics, 1.0f, 0.2f);
+    biometrics_process_rr(&metrics, 800.0f);
+    biometrics_process_rr(&metrics, 820.0f);
+    biometrics_process_rr(&metrics, 780.0f);
+    biometrics_readout(&metrics, &readout);
+    ASSERT_FLOAT_EQ(40.0f, readout.rmssd_ms, 0.01f);
+}
+
+TEST(biometrics_us_entry_matches_ms) {
+    hr_metrics_t by_ms, by_us;
+    biometrics_reset(&by_ms);
+    biometrics_reset(&by_us);
+
+    /* Detector path hands over integer us; same result as the ms entry */
+    static const uint16_t rr[] = { 800, 820, 780, 1600, 810, 790 };
+    for (uint8_t i = 0; i < sizeof(rr) / sizeof(rr[0]); i++) {
+        ASSERT_EQ(biometrics_process_rr(&by_ms, (float)rr[i]),
+                  biometrics_process_rr_us(&by_us, (uint32_t)rr[i] * 1000U));
+    }
+    ASSERT_FALSE(biometrics_process_rr_us(&by_us, 250000U));
+    ASSERT_EQ(by_ms.valid_samples, by_us.valid_samples);
+    ASSERT_EQ(by_ms.rmssd_us, by_us.rmssd_us);
+    ASSERT_EQ(by_ms.mean_rr_us, by_us.mean_rr_us);
+}
+
+TEST(biometrics_fixed_point_sequence) {
+    hr_metrics_t metrics;
+    biometrics_reset(&metrics);
+    ASSERT_EQ(6554U, metrics.rmssd_alpha_q16);
+    ASSERT_EQ(13107U, metrics.stress_alpha_q16);
+
+    ASSERT_FALSE(biometrics_process_rr_fixed(&metrics, 250000U));
+    ASSERT_TRUE(biometrics_process_rr_fixed(&metrics, 800000U));
+    ASSERT_FALSE(biometrics_process_rr_fixed(&metrics, 1200000U)); /* 50% jump */
+    ASSERT_TRUE(biometrics_process_rr_fixed(&metrics, 820000U));
+    ASSERT_TRUE(biometrics_process_rr_fixed(&metrics, 780000U));
+
+    /* sqrt(0.1*1600 + 0.9*400) ms, as the float path */
+    ASSERT_IN_RANGE(metrics.rmssd_us, 22802U, 22804U);
+    ASSERT_IN_RANGE(metrics.mean_rr_us, 798000U, 800000U);
+    ASSERT_EQ(780000U, metrics.last_rr_us);
+    ASSERT_EQ(3, metrics.valid_samples);
+
+    /* Host tools read the per-beat metrics through the integer view */
+    hr_readout_t readout;
+    biometrics_readout(&metrics, &readout);
+    ASSERT_FLOAT_EQ(22.803f, readout.rmssd_ms, 0.01f);
+    ASSERT_FLOAT_EQ((float)metrics.mean_rr_us * 0.001f, readout.mean_rr_ms, 0.001f);
+    ASSERT_FLOAT_EQ(0.0f, metrics.rmssd, 0.0f);   /* Float field left untouched */
+
+    /* Weight 1 via the setter */
+    biometrics_reset(&metrics);
+    biometrics_set_smoothing(&metrics, 1.0f, 0.2f);
+    biometrics_process_rr_fixed(&metrics, 800000U);
+    biometrics_process_rr_fixed(&metrics, 820000U);
+    biometrics_process_rr_fixed(&metrics, 780000U);
+    ASSERT_EQ(40000U, metrics.rmssd_us);
+}
+
+/* Calm / stressed RR with jitter and the odd missed beat */
+static float bio_replay_rr(uint32_t beat, uint32_t *p_rng)
+{
+    bool stressed = (beat / 400U) % 3U == 2U;
+    *p_rng = *p_rng * 1664525U + 1013904223U;
+    float jitter = (float)((*p_rng >> 16) % 1000U) / 1000.0f - 0.5f;
+
+    if (beat % 97U == 50U) return 1850.0f;
+    return stressed ? 700.0f + 20.0f * jitter : 920.0f + 80.0f * jitter;
+}
+
+TEST(biometrics_fixed_point_matches_float_cues) {
+    static hr_metrics_t m_float, m_fixed;
+    static bool cued[2][250];
+    static cue_type_t type[2][250];
+    uint32_t rng[2] = { 4242U, 4242U };
+
+    /* Long enough to run on the calibrated percentile, not just the ratio map */
+    for (uint8_t pass = 0; pass < 2U; pass++) {
+        hr_metrics_t *p_m = pass ? &m_fixed : &m_float;
+        biometrics_reset(p_m);
+        cue_processor_init();
+
+        for (uint32_t beat = 0; beat < 3750U; beat++) {
+            float rr = bio_replay_rr(beat, &rng[pass]);
+            if (pass) {
+                biometrics_process_rr_fixed(p_m, (uint32_t)(rr * 1000.0f + 0.5f));
+            } else {
+                biometrics_process_rr_float(p_m, rr);
+            }
+            if (beat % 15U != 14U) continue;
+
+            cue_input_t in = {
+                .timestamp_ms = beat * 1000U,
+                .stress_level = biometrics_stress_pct(p_m),
+                .coherence_pct = biometrics_coherence_pct(p_m),
+                .confidence_pct = 90,
+                .micro_var_pct100 = (uint16_t)(p_m->rmssd_us / 100U),
+                .stability_pct = 80,
+            };
+            cue_output_t out;
+            uint32_t check = beat / 15U;
+            cued[pass][check] = cue_processor_generate(&in, &out);
+            type[pass][check] = out.type;
+        }
+    }
+
+    ASSERT_TRUE(stress_calibration_ready(&m_fixed.calibration));
+    ASSERT_IN_RANGE(m_fixed.rmssd_us, (uint32_t)(m_float.rmssd * 1000.0f) - 50U,
+                    (uint32_t)(m_float.rmssd * 1000.0f) + 50U);
+    ASSERT_EQ(0, memcmp(cued[0], cued[1], sizeof(cued[0])));
+    for (uint32_t i = 0; i < 250U; i++) {
+        if (cued[0][i]) ASSERT_EQ(type[0][i], type[1][i]);
+    }
+}
+
 void run_biometric_tests(void) {
     RUN_TEST(biometrics_reset);
     RUN_TEST(biometrics_artifact_rejection_low);
     RUN_TEST(biometrics_normal_sequence);
     RUN_TEST(biometrics_relative_artifact);
+    RUN_TEST(biometrics_median_reference_recovers_after_artifact);
+    RUN_TEST(biometrics_rmssd_smoothing_tunable);
+    RUN_TEST(biometrics_us_entry_matches_ms);
+    RUN_TEST(biometrics_fixed_point_sequence);
+    RUN_TEST(biometrics_fixed_point_matches_float_cues);
 }
@@ -0,0 +1,104 @@
+/**
+ * @file test_ble_bond.c
+ * @brief Unit tests for bonded-peer storage
+ */
+
+#include "test_framework.h"
+#include "../src/bluetooth/ble_bond.h"
+#include "../src/system/nvm_store.h"
+
+static void bond_test_boot(void)
+{
+    hal_host_reset();
+    nvm_store_format();
+    nvm_store_init();
+    ble_bond_init();
+}
+
+static void bond_test_addr(uint8_t addr[6], uint8_t n)
+{
+    for (uint8_t i = 0; i < 6; i++) addr[i] = (uint8_t)(0xC0 + n + i);
+}
+
+TEST(bond_store_survives_reboot_and_replaces_oldest) {
+    uint8_t addr[NLR_BOND_MAX_PEERS + 1][6];
+    nlr_bond_keys_t keys = { .ediv = 0x1234 };
+
+    bond_test_boot();
+    for (uint8_t i = 0; i <= NLR_BOND_MAX_PEERS; i++) bond_test_addr(addr[i], (uint8_t)(i * 8));
+    memset(keys.rand, 0xA5, sizeof(keys.rand));
+    memset(keys.irk, 0x5A, sizeof(keys.irk));
+
+    ASSERT_EQ(-1, ble_bond_find(addr[0]));
+    ASSERT_EQ(0, ble_bond_store(addr[0], 1, &keys, 0x05, 0xCAFEF00D));
+    for (uint8_t i = 1; i < NLR_BOND_MAX_PEERS; i++) {
+        ASSERT_EQ(i, ble_bond_store(addr[i], 0, NULL, 0, 0xCAFEF00D));
+    }
+    ASSERT_EQ(NLR_BOND_MAX_PEERS, ble_bond_count());
+
+    /* Power cycle: everything comes back from flash */
+    nvm_store_init();
+    ble_bond_init();
+    ASSERT_EQ(NLR_BOND_MAX_PEERS, ble_bond_count());
+    const nlr_bond_t *p_bond = ble_bond_get(0);
+    ASSERT_NOT_NULL(p_bond);
+    ASSERT_EQ(0x05, p_bond->cccd);
+    ASSERT_EQ(0xCAFEF00D, p_bond->db_hash);
+    ASSERT_EQ(1, p_bond->addr_type);
+    ASSERT_TRUE(p_bond->flags & NLR_BOND_FLAG_IRK);
+    ASSERT_FALSE(ble_bond_get(1)->flags & NLR_BOND_FLAG_IRK);
+    ASSERT_EQ(0, ble_bond_find_master_id(0x1234, keys.rand));
+    ASSERT_EQ(-1, ble_bond_find_master_id(0x1235, keys.rand));
+
+    /* Slot 0 reconnected and dropped, then a reboot: slot 1 is now the
+       least recent and gets replaced */
+    ble_bond_touch(0);
+    ASSERT_EQ(0, ble_bond_update(0, 0x05, 0xCAFEF00D));
+    nvm_store_init();
+    ble_bond_init();
+    ASSERT_EQ(1, ble_bond_store(addr[NLR_BOND_MAX_PEERS], 0, NULL, 0, 0));
+    ASSERT_EQ(-1, ble_bond_find(addr[1]));
+    ASSERT_EQ(0, ble_bond_find(addr[0]));
+
+    /* Re-pairing the same central reuses its slot */
+    ASSERT_EQ(2, ble_bond_store(addr[2], 0, NULL, 0x01, 0));
+    ASSERT_EQ(NLR_BOND_MAX_PEERS, ble_bond_count());
+}
+
+TEST(bond_update_writes_only_on_change) {
+    uint8_t addr[6];
+
+    bond_test_boot();
+    bond_test_addr(addr, 0);
+    ASSERT_EQ(0, ble_bond_store(addr, 0, NULL, 0x01, 7));
+
+    uint32_t writes = g_hal_host.flash_writes;
+    ASSERT_EQ(0, ble_bond_update(0, 0x01, 7));
+    ASSERT_EQ(writes, g_hal_host.flash_writes);
+
+    /* A reconnect is kept in RAM, then saved once when the link drops */
+    ble_bond_touch(0);
+    ASSERT_EQ(writes, g_hal_host.flash_writes);
+    ASSERT_EQ(0, ble_bond_update(0, 0x01, 7));
+    ASSERT_GT(g_hal_host.flash_writes, writes);
+    writes = g_hal_host.flash_writes;
+    ASSERT_EQ(0, ble_bond_update(0, 0x01, 7));
+    ASSERT_EQ(writes, g_hal_host.flash_writes);
+
+    ASSERT_EQ(0, ble_bond_update(0, 0x07, 7));
+    ASSERT_GT(g_hal_host.flash_writes, writes);
+    ASSERT_EQ(-1, ble_bond_update(3, 0x07, 7));
+
+    /* Forgetting a bond survives a reboot too */
+    ble_bond_delete(0);
+    ASSERT_NULL(ble_bond_get(0));
+    nvm_store_init();
+    ble_bond_init();
+    ASSERT_EQ(0, ble_bond_count());
+    ASSERT_EQ(-1, ble_bond_find(addr));
+}
+
+void run_ble_bond_tests(void) {
+    RUN_TEST(bond_store_survives_reboot_and_replaces_oldest);
+    RUN_TEST(bond_update_writes_only_on_change);
+}
@@ -0,0 +1,101 @@
+/**
+ * @file test_ble_l2cap.c
+ * @brief Unit tests for the L2CAP bulk channel (credit flow, segmentation)
+ */
+
+#include "test_framework.h"
+#include "../src/bluetooth/ble_l2cap.h"
+
+static uint8_t s_l2cap_ring_rx[NLR_L2CAP_SDU_MAX];
+static uint8_t s_l2cap_phone_rx[NLR_L2CAP_SDU_MAX];
+
+TEST(l2cap_sdu_segmented_and_paced_by_credits) {
+    nlr_l2cap_chan_t ring, phone;
+    uint8_t sdu[500], frame[NLR_L2CAP_MPS_MAX];
+    uint16_t n, sdu_len = 0, sent = 0;
+    int rc = 0;
+
+    for (uint16_t i = 0; i < sizeof(sdu); i++) sdu[i] = (uint8_t)(i * 7U + 3U);
+
+    /* Phone sends with a minimum MPS: 500 + 2 bytes is 22 K-frames */
+    nlr_l2cap_init(&ring, s_l2cap_ring_rx, NLR_L2CAP_SDU_MAX, NLR_L2CAP_MPS_MIN);
+    nlr_l2cap_init(&phone, s_l2cap_phone_rx, NLR_L2CAP_SDU_MAX, NLR_L2CAP_MPS_MIN);
+    uint16_t to_phone = nlr_l2cap_open(&ring, NLR_L2CAP_SDU_MAX, NLR_L2CAP_MPS_MIN, 0);
+    uint16_t to_ring = nlr_l2cap_open(&phone, NLR_L2CAP_SDU_MAX, NLR_L2CAP_MPS_MIN, 0);
+    ASSERT_EQ(0, nlr_l2cap_tx_credit(&phone, to_phone));
+    ASSERT_EQ(0, nlr_l2cap_tx_credit(&ring, to_ring));
+
+    ASSERT_EQ(0, nlr_l2cap_tx_start(&phone, sdu, sizeof(sdu)));
+    ASSERT_EQ(-2, nlr_l2cap_tx_start(&phone, sdu, 10));
+
+    while (phone.tx_busy) {
+        /* Never more frames in flight than the ring granted */
+        uint16_t burst = 0;
+        while ((n = nlr_l2cap_tx_frame(&phone, frame)) > 0) {
+            ASSERT_LE(n, NLR_L2CAP_MPS_MIN);
+            rc = nlr_l2cap_rx_frame(&ring, frame, n, &sdu_len);
+            ASSERT_GE(rc, 0);
+            burst++;
+            sent++;
+        }
+        ASSERT_LE(burst, NLR_L2CAP_RX_CREDITS);
+        ASSERT_EQ(0, nlr_l2cap_tx_credit(&phone, nlr_l2cap_rx_grant(&ring)));
+    }
+
+    ASSERT_EQ(22, sent);
+    ASSERT_EQ(1, rc);
+    ASSERT_EQ(sizeof(sdu), sdu_len);
+    ASSERT_EQ(0, memcmp(sdu, s_l2cap_ring_rx, sizeof(sdu)));
+
+    /* Short SDU back fits one frame */
+    ASSERT_EQ(0, nlr_l2cap_tx_start(&ring, sdu, 5));
+    n = nlr_l2cap_tx_frame(&ring, frame);
+    ASSERT_EQ(7, n);
+    ASSERT_FALSE(ring.tx_busy);
+    ASSERT_EQ(1, nlr_l2cap_rx_frame(&phone, frame, n, &sdu_len));
+    ASSERT_EQ(5, sdu_len);
+    ASSERT_EQ(0, memcmp(sdu, s_l2cap_phone_rx, 5));
+}
+
+TEST(l2cap_protocol_errors) {
+    nlr_l2cap_chan_t ch;
+    uint8_t frame[NLR_L2CAP_MPS_MAX + 1] = {0};
+    uint16_t sdu_len;
+
+    nlr_l2cap_init(&ch, s_l2cap_ring_rx, 64, 32);
+    ASSERT_EQ(-1, nlr_l2cap_rx_frame(&ch, frame, 4, &sdu_len));     /* Closed */
+    ASSERT_EQ(-3, nlr_l2cap_tx_start(&ch, frame, 4));
+
+    nlr_l2cap_open(&ch, 100, 50, 0);
+    ASSERT_EQ(-1, nlr_l2cap_tx_start(&ch, frame, 101));               /* Over peer MTU */
+    ASSERT_EQ(0, nlr_l2cap_tx_start(&ch, frame, 10));
+    ASSERT_EQ(0, nlr_l2cap_tx_frame(&ch, frame));                     /* No credit */
+    ASSERT_EQ(0, nlr_l2cap_tx_credit(&ch, 0xFFFF));
+    ASSERT_EQ(-1, nlr_l2cap_tx_credit(&ch, 1));                       /* Overflow */
+
+    ASSERT_EQ(-1, nlr_l2cap_rx_frame(&ch, frame, 33, &sdu_len));    /* Over MPS */
+
+    frame[0] = 65;                                                    /* Over MTU */
+    nlr_l2cap_open(&ch, 100, 50, 0);
+    ASSERT_EQ(-2, nlr_l2cap_rx_frame(&ch, frame, 10, &sdu_len));
+
+    frame[0] = 4;                                                     /* Overrun */
+    nlr_l2cap_open(&ch, 100, 50, 0);
+    ASSERT_EQ(-2, nlr_l2cap_rx_frame(&ch, frame, 8, &sdu_len));
+
+    /* Peer ignores credits */
+    frame[0] = 60;
+    nlr_l2cap_open(&ch, 100, 50, 0);
+    for (uint8_t i = 0; i < NLR_L2CAP_RX_CREDITS; i++) {
+        ASSERT_EQ(0, nlr_l2cap_rx_frame(&ch, frame, 4, &sdu_len));
+        frame[0] = 0;
+    }
+    ASSERT_EQ(-1, nlr_l2cap_rx_frame(&ch, frame, 4, &sdu_len));
+    ASSERT_EQ(NLR_L2CAP_RX_CREDITS, nlr_l2cap_rx_grant(&ch));
+    ASSERT_EQ(0, nlr_l2cap_rx_grant(&ch));
+}
+
+void run_ble_l2cap_tests(void) {
+    RUN_TEST(l2cap_sdu_segmented_and_paced_by_credits);
+    RUN_TEST(l2cap_protocol_errors);
+}
@@ -0,0 +1,64 @@
+/**
+ * @file test_ble_packets.c
+ * @brief Unit tests for BLE notification payload encoding
+ */
+
+#include "test_framework.h"
+#include "../src/bluetooth/ble_packets.h"
+
+TEST(ble_rr_encoding_little_endian) {
+    const uint16_t rr[3] = { 850, 0x1234, 1002 };
+    uint8_t out[NLR_RR_PER_NOTIFY_MAX * 2];
+
+    ASSERT_EQ(6, nlr_ble_encode_rr(out, rr, 3, 247));
+    ASSERT_EQ(0x52, out[0]);
+    ASSERT_EQ(0x03, out[1]);
+    ASSERT_EQ(0x34, out[2]);
+    ASSERT_EQ(0x12, out[3]);
+}
+
+TEST(ble_rr_encoding_bounded_by_mtu) {
+    uint16_t rr[16];
+    uint8_t out[NLR_RR_PER_NOTIFY_MAX * 2];
+
+    for (uint8_t i = 0; i < 16; i++) rr[i] = (uint16_t)(800 + i);
+
+    /* Characteristic holds 10 values even with a large MTU */
+    ASSERT_EQ(20, nlr_ble_encode_rr(out, rr, 16, 247));
+    /* Minimum MTU: 20 byte payload; MTU 12 leaves room for 4 values */
+    ASSERT_EQ(20, nlr_ble_encode_rr(out, rr, 10, 23));
+    ASSERT_EQ(8, nlr_ble_encode_rr(out, rr, 10, 12));
+    ASSERT_EQ(0, nlr_ble_encode_rr(out, rr, 10, 3));
+}
+
+TEST(ble_coherence_from_metrics) {
+    hr_metrics_t m;
+    nlr_coherence_packet_t pkt;
+
+    biometrics_reset(&m);
+    m.stress_q16 = BIOMETRICS_Q16_ONE / 4U;
+    m.rmssd_us = 142000;
+    m.mean_rr_us = 912600;
+    m.valid_samples = 10;
+    m.quality_pct = 95;
+    biometrics_set_dfa_alpha1(&m, 1.05f);
+
+    nlr_ble_coherence_from_metrics(&m, &pkt);
+    ASSERT_EQ(25, pkt.stress_level);
+    ASSERT_EQ(75, pkt.coherence_pct);
+    ASSERT_EQ(50, pkt.confidence_pct);      /* Too few beats to trust quality */
+    ASSERT_EQ(100, pkt.variability_level);
+    ASSERT_EQ(912, pkt.mean_rr_ms);
+    ASSERT_EQ(142, pkt.rmssd_ms);
+    ASSERT_IN_RANGE(pkt.dfa_alpha1_x1000, 1049, 1050);
+
+    m.valid_samples = 40;
+    nlr_ble_coherence_from_metrics(&m, &pkt);
+    ASSERT_EQ(90, pkt.confidence_pct);
+}
+
+void run_ble_packet_tests(void) {
+    RUN_TEST(ble_rr_encoding_little_endian);
+    RUN_TEST(ble_rr_encoding_bounded_by_mtu);
+    RUN_TEST(ble_coherence_from_metrics);
+}
@@ -0,0 +1,237 @@
+/**
+ * @file test_bus_manager.c
+ * @brief Unit tests for the shared serial bus scheduler (host mock backend)
+ */
+
+#include "test_framework.h"
+#include "../src/system/bus_manager.h"
+
+#define BUS_TEST_LOG_MAX    16
+
+static uint8_t s_bus_tx[4] = { 0x10, 0x20, 0x30, 0x40 };
+static char s_bus_log[BUS_TEST_LOG_MAX];
+static int s_bus_result[BUS_TEST_LOG_MAX];
+static uint8_t s_bus_log_len;
+static const bus_xfer_t *s_bus_nack;
+
+static void bus_log_done(bus_xfer_t *p_xfer, int result)
+{
+    if (s_bus_log_len < BUS_TEST_LOG_MAX) {
+        s_bus_log[s_bus_log_len] = *(const char *)p_xfer->p_context;
+        s_bus_result[s_bus_log_len] = result;
+        s_bus_log_len++;
+    }
+}
+
+/* Device model: NACKs one chosen link, answers reads with 0xA0 + index */
+static int bus_test_device(const bus_xfer_t *p_xfer)
+{
+    for (uint16_t i = 0; i < p_xfer->rx_len; i++) {
+        p_xfer->p_rx[i] = (uint8_t)(0xA0U + i);
+    }
+    return (p_xfer == s_bus_nack) ? -1 : 0;
+}
+
+static bus_xfer_t bus_test_xfer(bus_id_t bus, bus_priority_t prio, const char *tag)
+{
+    return (bus_xfer_t){
+        .bus = bus,
+        .address = 0x6A,
+        .priority = prio,
+        .p_tx = s_bus_tx,
+        .tx_len = sizeof(s_bus_tx),
+        .done = bus_log_done,
+        .p_context = (void *)tag,
+    };
+}
+
+static void bus_test_reset(void)
+{
+    bus_manager_init();
+    bus_mock_set_device(BUS_I2C0, bus_test_device);
+    s_bus_log_len = 0;
+    s_bus_nack = NULL;
+    memset(s_bus_log, 0, sizeof(s_bus_log));
+}
+
+TEST(bus_priority_order) {
+    bus_xfer_t a = bus_test_xfer(BUS_I2C0, BUS_PRIO_LOW, "a");
+    bus_xfer_t b = bus_test_xfer(BUS_I2C0, BUS_PRIO_LOW, "b");
+    bus_xfer_t c = bus_test_xfer(BUS_I2C0, BUS_PRIO_NORMAL, "c");
+    bus_xfer_t d = bus_test_xfer(BUS_I2C0, BUS_PRIO_HIGH, "d");
+    bus_test_reset();
+
+    /* a goes straight to the wire; the rest queue behind it */
+    ASSERT_EQ(0, bus_submit(&a));
+    ASSERT_EQ(BUS_XFER_ACTIVE, a.state);
+    ASSERT_EQ(0, bus_submit(&b));
+    ASSERT_EQ(0, bus_submit(&c));
+    ASSERT_EQ(0, bus_submit(&d));
+    ASSERT_EQ(BUS_XFER_QUEUED, b.state);
+    ASSERT_FALSE(bus_manager_idle());
+
+    ASSERT_EQ(4, bus_mock_drain(BUS_I2C0));
+    ASSERT_TRUE(memcmp(s_bus_log, "adcb", 4) == 0);
+    ASSERT_TRUE(bus_manager_idle());
+    ASSERT_EQ(BUS_XFER_IDLE, b.state);
+}
+
+TEST(bus_chain_holds_bus) {
+    bus_xfer_t x[3] = {
+        bus_test_xfer(BUS_I2C0, BUS_PRIO_LOW, "1"),
+        bus_test_xfer(BUS_I2C0, BUS_PRIO_LOW, "2"),
+        bus_test_xfer(BUS_I2C0, BUS_PRIO_LOW, "3"),
+    };
+    bus_xfer_t h = bus_test_xfer(BUS_I2C0, BUS_PRIO_HIGH, "h");
+    bus_test_reset();
+    x[0].next = &x[1];
+    x[1].next = &x[2];
+
+    ASSERT_EQ(0, bus_submit(&x[0]));
+    ASSERT_EQ(0, bus_submit(&h));
+    ASSERT_EQ(4, bus_mock_drain(BUS_I2C0));
+    ASSERT_TRUE(memcmp(s_bus_log, "123h", 4) == 0);
+    ASSERT_EQ(4, bus_mock_started(BUS_I2C0));
+}
+
+TEST(bus_chain_error_aborts_rest) {
+    bus_xfer_t x[3] = {
+        bus_test_xfer(BUS_I2C0, BUS_PRIO_NORMAL, "1"),
+        bus_test_xfer(BUS_I2C0, BUS_PRIO_NORMAL, "2"),
+        bus_test_xfer(BUS_I2C0, BUS_PRIO_NORMAL, "3"),
+    };
+    bus_test_reset();
+    x[0].next = &x[1];
+    x[1].next = &x[2];
+    s_bus_nack = &x[1];
+
+    ASSERT_EQ(0, bus_submit(&x[0]));
+    ASSERT_EQ(2, bus_mock_drain(BUS_I2C0));
+    ASSERT_EQ(3, s_bus_log_len);
+    ASSERT_EQ(0, s_bus_result[0]);
+    ASSERT_EQ(-1, s_bus_result[1]);
+    ASSERT_EQ(-3, s_bus_result[2]);
+    ASSERT_EQ(BUS_XFER_IDLE, x[2].state);
+
+    /* The chain can be resubmitted once it has unwound */
+    s_bus_nack = NULL;
+    ASSERT_EQ(0, bus_submit(&x[0]));
+    ASSERT_EQ(3, bus_mock_drain(BUS_I2C0));
+}
+
+TEST(bus_write_then_read) {
+    uint8_t rx[3] = {0};
+    bus_xfer_t r = bus_test_xfer(BUS_I2C0, BUS_PRIO_NORMAL, "r");
+    bus_test_reset();
+    r.tx_len = 1;
+    r.p_rx = rx;
+    r.rx_len = sizeof(rx);
+
+    ASSERT_EQ(0, bus_submit(&r));
+    ASSERT_TRUE(bus_mock_complete(BUS_I2C0));
+    ASSERT_EQ(0xA0, rx[0]);
+    ASSERT_EQ(0xA2, rx[2]);
+    ASSERT_FALSE(bus_mock_complete(BUS_I2C0));
+}
+
+/* What the SPIM/TWIM handlers do on target: END straight into the scheduler */
+TEST(bus_end_entry_point_completes_and_starts_next) {
+    bus_xfer_t a = bus_test_xfer(BUS_SPI0, BUS_PRIO_HIGH, "a");
+    bus_xfer_t b = bus_test_xfer(BUS_SPI0, BUS_PRIO_HIGH, "b");
+    bus_test_reset();
+
+    ASSERT_EQ(0, bus_submit(&a));
+    ASSERT_EQ(0, bus_submit(&b));
+    bus_on_end(BUS_SPI0, -1);
+    ASSERT_EQ(BUS_XFER_IDLE, a.state);
+    ASSERT_EQ(BUS_XFER_ACTIVE, b.state);
+    bus_on_end(BUS_SPI0, 0);
+    bus_on_end(BUS_SPI0, 0);        /* Spurious END: nothing on the wire */
+    bus_on_end(BUS_COUNT, 0);
+    ASSERT_EQ(2, s_bus_log_len);
+    ASSERT_EQ(-1, s_bus_result[0]);
+    ASSERT_EQ(0, s_bus_result[1]);
+    ASSERT_TRUE(bus_manager_idle());
+}
+
+TEST(bus_rejects_bad_descriptors) {
+    bus_xfer_t a = bus_test_xfer(BUS_I2C0, BUS_PRIO_LOW, "a");
+    bus_xfer_t s = bus_test_xfer(BUS_SPI0, BUS_PRIO_LOW, "s");
+    bus_xfer_t e = bus_test_xfer(BUS_I2C0, BUS_PRIO_LOW, "e");
+    bus_test_reset();
+
+    ASSERT_EQ(-1, bus_submit(NULL));
+    e.tx_len = 0;
+    ASSERT_EQ(-1, bus_submit(&e));
+    a.next = &s;                    /* Chains cannot cross buses */
+    ASSERT_EQ(-1, bus_submit(&a));
+    a.next = NULL;
+    ASSERT_EQ(0, bus_submit(&a));
+    ASSERT_EQ(-2, bus_submit(&a));
+    bus_mock_drain(BUS_I2C0);
+}
+
+TEST(bus_armed_transfer_runs_without_cpu) {
+    bus_xfer_t t = bus_test_xfer(BUS_I2C0, BUS_PRIO_HIGH, "t");
+    bus_xfer_t t2 = bus_test_xfer(BUS_I2C0, BUS_PRIO_HIGH, "u");
+    bus_test_reset();
+
+    ASSERT_EQ(0, bus_arm_on_event(&t, 0x40006100U));
+    ASSERT_EQ(-2, bus_arm_on_event(&t2, 0x40006100U));
+    ASSERT_EQ(BUS_XFER_ARMED, t.state);
+    ASSERT_TRUE(bus_manager_idle());
+    ASSERT_EQ(0, bus_mock_started(BUS_I2C0));
+
+    bus_mock_trigger(BUS_I2C0);
+    ASSERT_EQ(1, bus_mock_started(BUS_I2C0));
+    ASSERT_TRUE(bus_mock_complete(BUS_I2C0));
+    ASSERT_EQ(1, s_bus_log_len);
+    ASSERT_EQ('t', s_bus_log[0]);
+    ASSERT_EQ(BUS_XFER_IDLE, t.state);
+
+    /* One-shot: re-arm for the next event, then disarm */
+    ASSERT_EQ(0, bus_arm_on_event(&t, 0x40006100U));
+    bus_disarm(BUS_I2C0);
+    ASSERT_EQ(BUS_XFER_IDLE, t.state);
+    bus_mock_trigger(BUS_I2C0);
+    ASSERT_EQ(1, bus_mock_started(BUS_I2C0));
+}
+
+TEST(bus_armed_trigger_waits_for_busy_bus) {
+    bus_xfer_t y = bus_test_xfer(BUS_I2C0, BUS_PRIO_LOW, "y");
+    bus_xfer_t z = bus_test_xfer(BUS_I2C0, BUS_PRIO_HIGH, "z");
+    bus_xfer_t t = bus_test_xfer(BUS_I2C0, BUS_PRIO_HIGH, "t");
+    bus_test_reset();
+
+    ASSERT_EQ(0, bus_submit(&y));
+    ASSERT_EQ(0, bus_submit(&z));
+    ASSERT_EQ(0, bus_arm_on_event(&t, 0x40006100U));
+
+    /* Event lands mid-transfer: held off, then replayed before the queue */
+    bus_mock_trigger(BUS_I2C0);
+    ASSERT_EQ(1, bus_mock_started(BUS_I2C0));
+    ASSERT_TRUE(bus_mock_complete(BUS_I2C0));
+    ASSERT_TRUE(bus_mock_last(BUS_I2C0) == &t);
+    ASSERT_EQ(2, bus_mock_drain(BUS_I2C0));
+    ASSERT_TRUE(memcmp(s_bus_log, "ytz", 3) == 0);
+
+    /* Trigger fired while idle, then software claims the bus */
+    ASSERT_EQ(0, bus_arm_on_event(&t, 0x40006100U));
+    bus_mock_trigger(BUS_I2C0);
+    ASSERT_EQ(0, bus_submit(&y));
+    ASSERT_EQ(BUS_XFER_ACTIVE, t.state);
+    ASSERT_EQ(BUS_XFER_QUEUED, y.state);
+    ASSERT_EQ(2, bus_mock_drain(BUS_I2C0));
+    ASSERT_TRUE(memcmp(s_bus_log, "ytzty", 5) == 0);
+}
+
+void run_bus_manager_tests(void) {
+    RUN_TEST(bus_priority_order);
+    RUN_TEST(bus_chain_holds_bus);
+    RUN_TEST(bus_chain_error_aborts_rest);
+    RUN_TEST(bus_write_then_read);
+    RUN_TEST(bus_end_entry_point_completes_and_starts_next);
+    RUN_TEST(bus_rejects_bad_descriptors);
+    RUN_TEST(bus_armed_transfer_runs_without_cpu);
+    RUN_TEST(bus_armed_trigger_waits_for_busy_bus);
+}
@@ -0,0 +1,137 @@
+/**
+ * @file test_checkpoint.c
+ * @brief Unit tests for whole-pipeline checkpoint / restore
+ */
+
+#include "test_framework.h"
+#include "ppg_synth.h"
+#include "../src/system/checkpoint.h"
+#include "../src/core/wellness_manager.h"
+
+#define CKPT_TEST_TICK_MS       250U
+#define CKPT_TEST_BLOCK         (CKPT_TEST_TICK_MS / PPG_SYNTH_PERIOD_MS)
+#define CKPT_TEST_SAVE_MS       (12U * 60000U)
+#define CKPT_TEST_END_MS        (24U * 60000U)
+#define CKPT_TEST_IMAGE_MAX     16384U
+
+/* What the replay would show: outputs folded tick by tick, plus end state */
+typedef struct {
+    uint32_t pwm_hash;
+    uint32_t cues;
+    uint32_t suppressed;
+    hr_metrics_t metrics;
+} ckpt_trace_t;
+
+static uint8_t s_ckpt_image[CKPT_TEST_IMAGE_MAX];
+
+static void ckpt_boot(void)
+{
+    hal_host_reset();
+    nvm_store_format();
+    nvm_store_init();
+    wellness_reset();
+    (void)wellness_set_detector(PEAK_DETECTOR_SSF);
+    wellness_manager_init();
+    cue_processor_init();
+    actuator_init();
+    signature_init();
+}
+
+/* Calm, then stressed from minute 8 so cues fire on both sides of the save */
+static void ckpt_run(ppg_synth_t *p_syn, uint32_t from_ms, uint32_t to_ms, ckpt_trace_t *p_trace)
+{
+    float block[CKPT_TEST_BLOCK];
+
+    for (uint32_t now = from_ms + CKPT_TEST_TICK_MS; now <= to_ms; now += CKPT_TEST_TICK_MS) {
+        bool stress = now > 8U * 60000U;
+        ppg_synth_set_physiology(p_syn, stress ? 92.0f : 64.0f, stress ? 6.0f : 30.0f,
+                                 stress ? 5.0f : 30.0f);
+        for (uint32_t i = 0; i < CKPT_TEST_BLOCK; i++) {
+            block[i] = ppg_synth_next(p_syn, NULL, NULL);
+        }
+        hal_host_set_time_ms(now);
+        (void)wellness_process_block(block, (uint16_t)CKPT_TEST_BLOCK, now - CKPT_TEST_TICK_MS,
+                                     PPG_SYNTH_PERIOD_MS);
+        wellness_manager_tick(now);
+        actuator_tick(now);
+        signature_tick(now);
+        thermal_feature_tick(now);
+        vibration_feature_tick(now);
+
+        p_trace->pwm_hash = p_trace->pwm_hash * 31U + g_hal_host.pwm_duty[HAL_PWM_MOTOR];
+        p_trace->pwm_hash = p_trace->pwm_hash * 31U + g_hal_host.pwm_duty[HAL_PWM_HEATER];
+    }
+    cue_processor_get_stats(&p_trace->cues, &p_trace->suppressed, NULL, NULL);
+    p_trace->metrics = *wellness_manager_get_metrics();
+}
+
+TEST(checkpoint_resume_matches_straight_run) {
+    ppg_synth_params_t p = ppg_synth_defaults();
+    ppg_synth_t syn, syn_at_save;
+    ckpt_trace_t straight = {0}, resumed = {0};
+    uint32_t len, t_ms = 0;
+
+    ppg_synth_init(&syn, &p);
+    ckpt_boot();
+    ckpt_run(&syn, 0, CKPT_TEST_SAVE_MS - 30000U, &straight);
+    signature_play(SIG_BREATHING_GUIDE, 60);     /* Mid-pattern at the save */
+    ckpt_run(&syn, CKPT_TEST_SAVE_MS - 30000U, CKPT_TEST_SAVE_MS, &straight);
+
+    ASSERT_LE(checkpoint_size(), CKPT_TEST_IMAGE_MAX);
+    ASSERT_EQ(0, checkpoint_save(CKPT_TEST_SAVE_MS, s_ckpt_image, sizeof(s_ckpt_image), &len));
+    ASSERT_EQ(checkpoint_size(), len);
+    syn_at_save = syn;
+    resumed.pwm_hash = straight.pwm_hash;
+
+    ckpt_run(&syn, CKPT_TEST_SAVE_MS, CKPT_TEST_END_MS, &straight);
+    ASSERT_GT(straight.cues, 0U);
+
+    /* Fresh boot on another engine, then jump straight to the save point */
+    ckpt_boot();
+    (void)wellness_set_detector(PEAK_DETECTOR_ELGENDI);
+    ASSERT_EQ(0, checkpoint_restore(s_ckpt_image, len, &t_ms));
+    ASSERT_EQ(CKPT_TEST_SAVE_MS, t_ms);
+    ASSERT_EQ(PEAK_DETECTOR_SSF, wellness_get_detector());
+    ASSERT_TRUE(signature_is_playing());
+
+    ckpt_run(&syn_at_save, CKPT_TEST_SAVE_MS, CKPT_TEST_END_MS, &resumed);
+    ASSERT_EQ(straight.pwm_hash, resumed.pwm_hash);
+    ASSERT_EQ(straight.cues, resumed.cues);
+    ASSERT_EQ(straight.suppressed, resumed.suppressed);
+    ASSERT_EQ(0, memcmp(&straight.metrics, &resumed.metrics, sizeof(hr_metrics_t)));
+}
+
+TEST(checkpoint_rejects_bad_image) {
+    uint32_t len, t_ms = 0;
+    float rr;
+
+    ckpt_boot();
+    ASSERT_EQ(-1, checkpoint_save(0, s_ckpt_image, checkpoint_size() - 1U, &len));
+    ASSERT_EQ(0, checkpoint_save(1000U, s_ckpt_image, sizeof(s_ckpt_image), &len));
+
+    /* Pipeline moves on; failed restores must not touch it */
+    ASSERT_EQ(0, wellness_set_detector(PEAK_DETECTOR_ELGENDI));
+
+    s_ckpt_image[len / 2U] ^= 0x01U;
+    ASSERT_EQ(-2, checkpoint_restore(s_ckpt_image, len, &t_ms));
+    s_ckpt_image[len / 2U] ^= 0x01U;
+    ASSERT_EQ(-2, checkpoint_restore(s_ckpt_image, len - 1U, &t_ms));
+
+    /* First section one byte short (CRC fixed up): not this build's layout */
+    uint32_t sec_len, crc;
+    memcpy(&sec_len, &s_ckpt_image[CHECKPOINT_HEADER_BYTES + 4U], sizeof(sec_len));
+    sec_len--;
+    memcpy(&s_ckpt_image[CHECKPOINT_HEADER_BYTES + 4U], &sec_len, sizeof(sec_len));
+    crc = ota_crc32(0, s_ckpt_image, len - 4U);
+    memcpy(&s_ckpt_image[len - 4U], &crc, sizeof(crc));
+    ASSERT_EQ(-3, checkpoint_restore(s_ckpt_image, len, &t_ms));
+
+    ASSERT_EQ(0U, t_ms);
+    ASSERT_EQ(PEAK_DETECTOR_ELGENDI, wellness_get_detector());
+    ASSERT_FALSE(wellness_pop_rr(&rr));
+}
+
+void run_checkpoint_tests(void) {
+    RUN_TEST(checkpoint_resume_matches_straight_run);
+    RUN_TEST(checkpoint_rejects_bad_image);
+}
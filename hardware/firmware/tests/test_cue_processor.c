@@ -15,6 +15,7 @@
 
 #include "test_framework.h"
 #include "../src/wellness_feedback/cue_processor.h"
+#include "../src/wellness_feedback/actuator_controller.h"
 
 /*******************************************************************************
  * TEST HELPERS
@@ -437,6 +438,46 @@ TEST(intensity_respects_max)
     ASSERT_LE(output.vib_intensity, 30);
 }
 
+TEST(thermal_cue_fits_heater_budget)
+{
+    cue_preferences_t prefs;
+    cue_output_t full, reduced, none;
+    
+    /* Full budget: the regular thermal cue */
+    actuator_init();
+    actuator_set_battery_soc(100);
+    cue_processor_init();
+    cue_processor_get_preferences(&prefs);
+    prefs.quiet_start_hour = 0;
+    prefs.quiet_end_hour = 0;
+    cue_processor_set_preferences(&prefs);
+    cue_input_t input = make_input(1000, 40, 300, 60, 85);
+    ASSERT_TRUE(cue_processor_generate(&input, &full));
+    ASSERT_EQ(CUE_TYPE_THERMAL, full.type);
+    
+    /* Low SoC shrinks the budget: shorter or gentler variant */
+    actuator_set_battery_soc(ACTUATOR_HEAT_SOC_CUTOFF_PCT + 2U);
+    uint16_t budget_ds = actuator_heat_budget_ds();
+    ASSERT_LT(budget_ds, ACTUATOR_HEAT_BUDGET_HOUR_DS / 4U);
+    cue_processor_init();
+    cue_processor_set_preferences(&prefs);
+    ASSERT_TRUE(cue_processor_generate(&input, &reduced));
+    ASSERT_EQ(CUE_TYPE_THERMAL, reduced.type);
+    ASSERT_GT(reduced.thermal_intensity, 0);
+    ASSERT_LE(reduced.thermal_intensity * reduced.thermal_duration_s, (budget_ds + 1) * 100);
+    ASSERT_TRUE(reduced.thermal_intensity < full.thermal_intensity ||
+                reduced.thermal_duration_s < full.thermal_duration_s);
+    
+    /* No budget: the cascade moves past thermal */
+    actuator_set_battery_soc(ACTUATOR_HEAT_SOC_CUTOFF_PCT);
+    cue_processor_init();
+    cue_processor_set_preferences(&prefs);
+    cue_processor_generate(&input, &none);
+    ASSERT_EQ(0, none.thermal_intensity);
+    
+    actuator_set_battery_soc(100);
+}
+
 /*******************************************************************************
  * STATISTICS TESTS
  ******************************************************************************/
@@ -530,6 +571,7 @@ static void run_preference_tests(void)
     RUN_TEST(disabled_suppresses_all);
     RUN_TEST(thermal_disabled_uses_vibration);
     RUN_TEST(intensity_respects_max);
+    RUN_TEST(thermal_cue_fits_heater_budget);
 }
 
 static void run_stats_tests(void)
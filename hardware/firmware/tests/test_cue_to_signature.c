@@ -11,12 +11,7 @@
 #include "test_framework.h"
 #include "../src/wellness_feedback/cue_to_signature.h"
 
-/* External mock state from unit_tests.c */
-extern uint8_t g_mock_vib_intensity;
-extern uint8_t g_mock_thermal_intensity;
-extern bool g_mock_vib_on;
-extern bool g_mock_thermal_on;
-extern void mocks_reset(void);
+#include "../src/hal/hal.h"
 
 /*******************************************************************************
  * MAPPING TESTS
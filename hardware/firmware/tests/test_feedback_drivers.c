@@ -0,0 +1,295 @@
+/**
+ * @file test_feedback_drivers.c
+ * @brief Unit tests for the actuator and NTC drivers on the HAL recorder
+ */
+
+#include "test_framework.h"
+#include "../src/hal/hal.h"
+#include "../src/sensors/temperature_sensor.h"
+#include "vibration_feature.h"
+#include "thermal_feature.h"
+#include "actuator_controller.h"
+#include "erm_model.h"
+#include "../src/core/wellness_manager.h"
+
+TEST(hal_vibration_on_drives_motor) {
+    hal_rec_clear();
+    vibration_feature_init();
+    ASSERT_FALSE(hal_host_gpio_out(HAL_PIN_MOTOR_NSLEEP));
+
+    vibration_feature_on(60);
+    ASSERT_TRUE(hal_host_gpio_out(HAL_PIN_MOTOR_NSLEEP));
+    ASSERT_EQ(60, g_hal_host.pwm_duty[HAL_PWM_MOTOR]);
+
+    vibration_feature_off();
+    ASSERT_FALSE(hal_host_gpio_out(HAL_PIN_MOTOR_NSLEEP));
+    ASSERT_EQ(0, g_hal_host.pwm_duty[HAL_PWM_MOTOR]);
+}
+
+TEST(hal_vibration_pattern_steps) {
+    hal_rec_clear();
+    vibration_feature_init();
+
+    /* Double pulse at half strength: on, off, on, then sleep */
+    vibration_feature_play(VIB_PATTERN_DOUBLE, 50);
+    vibration_feature_tick(1000);
+    ASSERT_EQ(50, g_hal_host.pwm_duty[HAL_PWM_MOTOR]);
+    vibration_feature_tick(1100);
+    ASSERT_EQ(0, g_hal_host.pwm_duty[HAL_PWM_MOTOR]);
+    ASSERT_TRUE(vibration_feature_is_active());
+    vibration_feature_tick(1200);
+    ASSERT_EQ(50, g_hal_host.pwm_duty[HAL_PWM_MOTOR]);
+    vibration_feature_tick(1300);
+    ASSERT_FALSE(vibration_feature_is_active());
+    ASSERT_FALSE(hal_host_gpio_out(HAL_PIN_MOTOR_NSLEEP));
+    ASSERT_GE(hal_rec_count(HAL_REC_PWM, HAL_PWM_MOTOR), 4);
+}
+
+TEST(hal_thermal_ramp_and_clamp) {
+    hal_rec_clear();
+    thermal_feature_init();
+
+    /* Request above the burn limit: ramps up, never exceeds 80 % */
+    thermal_feature_set(100);
+    thermal_feature_tick(5000);
+    ASSERT_EQ(0, g_hal_host.pwm_duty[HAL_PWM_HEATER]);
+    thermal_feature_tick(5000 + THERMAL_RAMP_TIME_MS / 2);
+    ASSERT_IN_RANGE(g_hal_host.pwm_duty[HAL_PWM_HEATER], 39, 41);
+    thermal_feature_tick(5000 + THERMAL_RAMP_TIME_MS);
+    thermal_feature_tick(5000 + THERMAL_RAMP_TIME_MS + 100);
+    ASSERT_EQ(THERMAL_STATE_ACTIVE, thermal_feature_get_state());
+    ASSERT_EQ(THERMAL_MAX_INTENSITY_PCT, g_hal_host.pwm_duty[HAL_PWM_HEATER]);
+
+    thermal_feature_stop();
+    ASSERT_EQ(0, g_hal_host.pwm_duty[HAL_PWM_HEATER]);
+}
+
+TEST(hal_thermal_over_temp_cuts_heater) {
+    hal_rec_clear();
+    thermal_feature_init();
+
+    thermal_feature_set(50);
+    thermal_feature_tick(1000);
+    thermal_feature_tick(1500);
+    ASSERT_GT(g_hal_host.pwm_duty[HAL_PWM_HEATER], 0);
+
+    thermal_feature_update_skin_temp(THERMAL_MAX_SKIN_TEMP_C);
+    thermal_feature_tick(1600);
+    ASSERT_EQ(THERMAL_STATE_FAULT, thermal_feature_get_state());
+    ASSERT_EQ(THERMAL_FAULT_OVER_TEMP, thermal_feature_get_fault());
+    ASSERT_EQ(0, g_hal_host.pwm_duty[HAL_PWM_HEATER]);
+}
+
+TEST(hal_ntc_reads_adc) {
+    temperature_init();
+
+    /* Mid-scale: NTC equals the series resistor, 25 C */
+    g_hal_host.adc[HAL_ADC_NTC] = 2048;
+    int8_t temp = 0;
+    for (int i = 0; i < 4; i++) {
+        temp = temperature_read_skin();
+    }
+    ASSERT_EQ(25, temp);
+
+    /* Higher divider voltage: lower NTC resistance, hotter skin */
+    g_hal_host.adc[HAL_ADC_NTC] = 2800;
+    for (int i = 0; i < 4; i++) {
+        temp = temperature_read_skin();
+    }
+    ASSERT_GT(temp, 42);
+    ASSERT_EQ(2800, temperature_read_raw());
+}
+
+/** Play a pattern through the driver at 1 ms ticks into the ERM model */
+static void erm_test_play(vib_drive_t drive, vibration_pattern_t pattern, uint8_t intensity, erm_model_t *p_m)
+{
+    hal_rec_clear();
+    vibration_feature_init();
+    vibration_feature_set_drive(drive);
+    erm_model_reset(p_m);
+
+    vibration_feature_play(pattern, intensity);
+    for (uint32_t t = 1000; t < 6000U; t++) {
+        vibration_feature_tick(t);
+        erm_model_step(p_m, g_hal_host.pwm_duty[HAL_PWM_MOTOR], 1);
+        if (!vibration_feature_is_active() && t > 1300U) break;
+    }
+    erm_model_step(p_m, 0, 300);
+}
+
+/** Shortest felt gap between pulses */
+static uint32_t erm_test_min_gap(const erm_model_t *p_m)
+{
+    uint32_t gap = UINT32_MAX;
+    for (uint8_t i = 2; i + 1U < p_m->n_edges; i += 2U) {
+        if (p_m->edges[i] - p_m->edges[i - 1U] < gap) gap = p_m->edges[i] - p_m->edges[i - 1U];
+    }
+    return gap;
+}
+
+TEST(erm_overdrive_alert_felt_on_authored_edges) {
+    /* VIB_STEPS_ALERT on/off edges, ms from the first tick */
+    static const uint32_t authored[12] = { 0, 50, 100, 150, 200, 250, 450, 500, 550, 600, 650, 700 };
+    erm_model_t plain, kick;
+
+    erm_test_play(VIB_DRIVE_PLAIN, VIB_PATTERN_ALERT, 70, &plain);
+    erm_test_play(VIB_DRIVE_OVERDRIVE, VIB_PATTERN_ALERT, 70, &kick);
+
+    /* Plain duty: taps start late and coast into the gaps */
+    ASSERT_EQ(12, plain.n_edges);
+    ASSERT_LT(erm_test_min_gap(&plain), 25);
+
+    /* Overdrive: felt within a few ms of every authored edge (the first
+     * onset has no preceding off-step to kick from) */
+    ASSERT_EQ(12, kick.n_edges);
+    ASSERT_LE(kick.edges[0], 12);
+    for (int i = 1; i < 12; i++) {
+        ASSERT_IN_RANGE(kick.edges[i], authored[i] - 5U, authored[i] + 5U);
+    }
+    ASSERT_GE(erm_test_min_gap(&kick), 40);
+    ASSERT_LT(kick.on_ms, plain.on_ms / 2U);
+}
+
+TEST(erm_overdrive_kick_then_sustain) {
+    hal_rec_clear();
+    vibration_feature_init();
+    vibration_feature_set_drive(VIB_DRIVE_OVERDRIVE);
+
+    /* Full duty at onset, sustain once the rotor is up to speed */
+    vibration_feature_on(50);
+    ASSERT_EQ(100, g_hal_host.pwm_duty[HAL_PWM_MOTOR]);
+    vibration_feature_tick(1000);
+    vibration_feature_tick(1010);
+    ASSERT_EQ(100, g_hal_host.pwm_duty[HAL_PWM_MOTOR]);
+    vibration_feature_tick(1030);
+    ASSERT_EQ(50, g_hal_host.pwm_duty[HAL_PWM_MOTOR]);
+
+    /* Already spinning: no second kick */
+    vibration_feature_tick(1500);
+    vibration_feature_on(45);
+    ASSERT_EQ(45, g_hal_host.pwm_duty[HAL_PWM_MOTOR]);
+    vibration_feature_stop();
+}
+
+/** Tick the actuator controller every 100 ms over [from, to) */
+static void actuator_test_run(uint32_t from_ms, uint32_t to_ms)
+{
+    for (uint32_t t = from_ms; t < to_ms; t += 100U) {
+        actuator_tick(t);
+    }
+}
+
+TEST(actuator_heat_budget_trims_and_rejects) {
+    hal_rec_clear();
+    actuator_init();
+    actuator_set_battery_soc(100);
+    ASSERT_EQ(ACTUATOR_HEAT_BUDGET_HOUR_DS, actuator_heat_budget_ds());
+
+    /* 80 % for 60 s fits, and costs just under 48 duty-seconds (ramp) */
+    ASSERT_EQ(1, actuator_apply_ble(80, 60, 0, 0, 1000));
+    actuator_test_run(1000, 62000);
+    ASSERT_FALSE(actuator_is_active());
+    ASSERT_IN_RANGE(actuator_heat_budget_ds(), 12, 16);
+
+    /* Same request again: accepted, but cut short to what is left */
+    ASSERT_EQ(1, actuator_apply_ble(80, 60, 0, 0, 62000));
+    actuator_test_run(62000, 67000);
+    ASSERT_TRUE(actuator_is_active());
+    actuator_test_run(67000, 82000);
+    ASSERT_FALSE(actuator_is_active());
+
+    /* Budget gone: heat refused, combined falls back to vibration */
+    actuator_set_battery_soc(20);
+    ASSERT_EQ(0, actuator_heat_budget_ds());
+    ASSERT_EQ(0, actuator_apply_ble(80, 20, 0, 0, 82000));
+    ASSERT_EQ(1, actuator_apply_ble(80, 20, 2, 50, 82000));
+    actuator_status_t status;
+    actuator_get_status(&status);
+    ASSERT_EQ(ACTUATOR_VIBRATION, status.current_type);
+    ASSERT_EQ(0, g_hal_host.pwm_duty[HAL_PWM_HEATER]);
+
+    actuator_stop_all();
+    actuator_set_battery_soc(100);
+}
+
+TEST(actuator_heat_budget_cuts_running_heater) {
+    hal_rec_clear();
+    actuator_init();
+    actuator_set_battery_soc(100);
+
+    ASSERT_EQ(1, actuator_apply_ble(80, 60, 0, 0, 1000));
+    actuator_test_run(1000, 11000);
+    ASSERT_GT(g_hal_host.pwm_duty[HAL_PWM_HEATER], 0);
+
+    /* SoC drop leaves less budget than already spent: heater off now */
+    actuator_set_battery_soc(ACTUATOR_HEAT_SOC_CUTOFF_PCT + 1U);
+    actuator_tick(11000);
+    ASSERT_EQ(0, g_hal_host.pwm_duty[HAL_PWM_HEATER]);
+    ASSERT_FALSE(thermal_feature_is_active());
+
+    actuator_set_battery_soc(100);
+}
+
+TEST(actuator_heat_budget_rolls_over) {
+    hal_rec_clear();
+    actuator_init();
+    actuator_set_battery_soc(100);
+
+    ASSERT_EQ(1, actuator_apply_ble(80, 60, 0, 0, 1000));
+    actuator_test_run(1000, 62000);
+    uint16_t left = actuator_heat_budget_ds();
+    ASSERT_LT(left, ACTUATOR_HEAT_BUDGET_HOUR_DS);
+
+    /* An hour later the hourly window is clear; the daily one still counts */
+    actuator_tick(62000 + 3600000U);
+    ASSERT_EQ(ACTUATOR_HEAT_BUDGET_HOUR_DS, actuator_heat_budget_ds());
+
+    /* Gentler variant when only the floor intensity fits */
+    uint8_t intensity = 80, duration = 60;
+    actuator_set_battery_soc(25);
+    ASSERT_TRUE(actuator_heat_fit(&intensity, &duration, 20));
+    ASSERT_LT(intensity, 80);
+    ASSERT_LE(intensity * duration, actuator_heat_budget_ds() * 100 + 100);
+
+    actuator_set_battery_soc(100);
+}
+
+TEST(wellness_battery_shrinks_heat_budget) {
+    hal_rec_clear();
+    actuator_init();
+    wellness_manager_init();
+    wellness_manager_set_battery(100);
+    ASSERT_EQ(ACTUATOR_HEAT_BUDGET_HOUR_DS, actuator_heat_budget_ds());
+
+    /* Halfway between cutoff and full: about half the budget */
+    wellness_manager_set_battery((ACTUATOR_HEAT_SOC_CUTOFF_PCT + ACTUATOR_HEAT_SOC_FULL_PCT) / 2U);
+    uint16_t half = actuator_heat_budget_ds();
+    ASSERT_IN_RANGE(half, ACTUATOR_HEAT_BUDGET_HOUR_DS / 3U, ACTUATOR_HEAT_BUDGET_HOUR_DS * 2U / 3U);
+
+    /* A long warm cue no longer fits as asked */
+    uint8_t intensity = 80, duration = 60;
+    ASSERT_TRUE(actuator_heat_fit(&intensity, &duration, 20));
+    ASSERT_LT(intensity * duration, 80 * 60);
+
+    /* At the cutoff the heater is refused outright */
+    wellness_manager_set_battery(ACTUATOR_HEAT_SOC_CUTOFF_PCT);
+    ASSERT_EQ(0, actuator_heat_budget_ds());
+    ASSERT_EQ(0, actuator_apply_ble(80, 20, 0, 0, 1000));
+    ASSERT_EQ(0, g_hal_host.pwm_duty[HAL_PWM_HEATER]);
+
+    wellness_manager_set_battery(100);
+}
+
+void run_feedback_driver_tests(void) {
+    RUN_TEST(hal_vibration_on_drives_motor);
+    RUN_TEST(hal_vibration_pattern_steps);
+    RUN_TEST(hal_thermal_ramp_and_clamp);
+    RUN_TEST(hal_thermal_over_temp_cuts_heater);
+    RUN_TEST(hal_ntc_reads_adc);
+    RUN_TEST(erm_overdrive_alert_felt_on_authored_edges);
+    RUN_TEST(erm_overdrive_kick_then_sustain);
+    RUN_TEST(actuator_heat_budget_trims_and_rejects);
+    RUN_TEST(actuator_heat_budget_cuts_running_heater);
+    RUN_TEST(actuator_heat_budget_rolls_over);
+    RUN_TEST(wellness_battery_shrinks_heat_budget);
+}
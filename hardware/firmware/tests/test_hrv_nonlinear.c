@@ -0,0 +1,205 @@
+/**
+ * @file test_hrv_nonlinear.c
+ * @brief Unit tests for incremental Poincaré SD1/SD2, DFA alpha1 and SampEn/ApEn
+ */
+
+#include "test_framework.h"
+#include "../src/core/hrv_nonlinear.h"
+#include <math.h>
+
+static uint32_t s_nl_rng = 2463534242U;
+
+static float nl_gauss(void)
+{
+    /* Sum of uniforms: cheap, deterministic approximate normal */
+    float acc = 0.0f;
+    for (int i = 0; i < 12; i++) {
+        s_nl_rng ^= s_nl_rng << 13;
+        s_nl_rng ^= s_nl_rng >> 17;
+        s_nl_rng ^= s_nl_rng << 5;
+        acc += (float)(s_nl_rng & 0xFFFFU) / 65535.0f;
+    }
+    return acc - 6.0f;
+}
+
+static float nl_run_dfa(hrv_nonlinear_t *ctx)
+{
+    for (int i = 0; i < 64; i++) {
+        if (hrv_nonlinear_step(ctx)) break;
+    }
+    return ctx->dfa_alpha1;
+}
+
+/* Steps until an entropy pass publishes; returns the number of calls */
+static int nl_run_entropy(hrv_nonlinear_t *ctx)
+{
+    int calls = 0;
+    ctx->entropy_valid = false;
+    while (calls < 1000 && !ctx->entropy_valid) {
+        hrv_nonlinear_step(ctx);
+        calls++;
+    }
+    return calls;
+}
+
+/* Naive O(n²) SampEn / ApEn (m = 2) over integer RR */
+static void nl_entropy_ref(const int *x, int n, int r, double *sampen, double *apen)
+{
+    const int m = 2;
+    double b = 0, a = 0, phi_m = 0, phi_m1 = 0;
+
+    for (int len = m; len <= m + 1; len++) {
+        int t = n - len + 1;
+        double phi = 0;
+        for (int i = 0; i < t; i++) {
+            int c = 0;
+            for (int j = 0; j < t; j++) {
+                int ok = 1;
+                for (int k = 0; k < len && ok; k++) ok = abs(x[i + k] - x[j + k]) <= r;
+                c += ok;
+            }
+            phi += log((double)c / t);
+        }
+        if (len == m) phi_m = phi / t; else phi_m1 = phi / t;
+    }
+    for (int i = 0; i < n - m; i++) {
+        for (int j = i + 1; j < n - m; j++) {
+            if (abs(x[i] - x[j]) > r || abs(x[i + 1] - x[j + 1]) > r) continue;
+            b++;
+            if (abs(x[i + 2] - x[j + 2]) <= r) a++;
+        }
+    }
+    *sampen = log(b / a);
+    *apen = phi_m - phi_m1;
+}
+
+TEST(hrv_nl_constant_rr_has_no_variability) {
+    hrv_nonlinear_t ctx;
+    hrv_nonlinear_reset(&ctx);
+    for (int i = 0; i < 50; i++) hrv_nonlinear_add_rr(&ctx, 800.0f);
+    ASSERT_EQ(0U, ctx.sd1_us);
+    ASSERT_EQ(0U, ctx.sd2_us);
+}
+
+TEST(hrv_nl_poincare_matches_batch) {
+    hrv_nonlinear_t ctx;
+    static float rr[300];
+    hrv_nonlinear_reset(&ctx);
+
+    for (int i = 0; i < 300; i++) {
+        rr[i] = 850.0f + 40.0f * sinf((float)i * 0.4f) + 15.0f * nl_gauss();
+        hrv_nonlinear_add_rr(&ctx, rr[i]);
+    }
+
+    /* Batch reference over the beats still in the window */
+    int n = ctx.count, start = 300 - n;
+    double sd = 0, sdd = 0, ss = 0, sss = 0, sx = 0, sxx = 0;
+    for (int i = start; i < 300; i++) {
+        double x = floor(rr[i] + 0.5);
+        sx += x; sxx += x * x;
+    }
+    for (int i = start; i < 299; i++) {
+        double x = floor(rr[i] + 0.5), y = floor(rr[i + 1] + 0.5);
+        sd += y - x; sdd += (y - x) * (y - x);
+        ss += y + x; sss += (y + x) * (y + x);
+    }
+    double m = n - 1;
+    double sd1 = sqrt((sdd / m - (sd / m) * (sd / m)) / 2.0);
+    double sd2 = sqrt((sss / m - (ss / m) * (ss / m)) / 2.0);
+    double sdnn = sqrt((sxx - sx * sx / n) / (n - 1));
+
+    ASSERT_TRUE(ctx.window_ms <= HRV_NL_WINDOW_MS);
+    ASSERT_FLOAT_EQ((float)sd1, (float)ctx.sd1_us * 0.001f, 0.05f);
+    ASSERT_FLOAT_EQ((float)sd2, (float)ctx.sd2_us * 0.001f, 0.05f);
+    ASSERT_FLOAT_EQ((float)sdnn, (float)ctx.sdnn_us * 0.001f, 0.05f);
+    ASSERT_GT(ctx.sdnn_us, 0U);
+}
+
+TEST(hrv_nl_dfa_waits_for_min_beats) {
+    hrv_nonlinear_t ctx;
+    hrv_nonlinear_reset(&ctx);
+    for (int i = 0; i < HRV_NL_DFA_MIN_BEATS - 1; i++) hrv_nonlinear_add_rr(&ctx, 800.0f + 20.0f * nl_gauss());
+    nl_run_dfa(&ctx);
+    ASSERT_FALSE(ctx.dfa_valid);
+}
+
+TEST(hrv_nl_dfa_white_noise_near_half) {
+    hrv_nonlinear_t ctx;
+    hrv_nonlinear_reset(&ctx);
+    for (int i = 0; i < 160; i++) hrv_nonlinear_add_rr(&ctx, 800.0f + 30.0f * nl_gauss());
+    float alpha = nl_run_dfa(&ctx);
+    ASSERT_TRUE(ctx.dfa_valid);
+    ASSERT_IN_RANGE(alpha, 0.3f, 0.75f);
+}
+
+TEST(hrv_nl_dfa_correlated_series_high) {
+    hrv_nonlinear_t ctx;
+    float rr = 800.0f;
+    hrv_nonlinear_reset(&ctx);
+    /* Random walk around the mean: strongly correlated, alpha1 ~1.5 */
+    for (int i = 0; i < 160; i++) {
+        rr += 8.0f * nl_gauss();
+        hrv_nonlinear_add_rr(&ctx, rr);
+    }
+    float alpha = nl_run_dfa(&ctx);
+    ASSERT_TRUE(ctx.dfa_valid);
+    ASSERT_GT(alpha, 1.2f);
+}
+
+TEST(hrv_nl_entropy_matches_naive_scan) {
+    hrv_nonlinear_t ctx;
+    static int x[400];
+    float drift = 0.0f;
+    hrv_nonlinear_reset(&ctx);
+
+    /* Wide walk plus beat noise: many buckets, many near-boundary pairs */
+    for (int i = 0; i < 400; i++) {
+        drift += 6.0f * nl_gauss();
+        float rr = 780.0f + drift + 25.0f * nl_gauss();
+        x[i] = (int)(rr + 0.5f);
+        hrv_nonlinear_add_rr(&ctx, rr);
+    }
+
+    int calls = nl_run_entropy(&ctx);
+    ASSERT_TRUE(ctx.entropy_valid);
+    ASSERT_GT(calls, 4);    /* Spread over ticks, not one call */
+
+    int n = ctx.count;
+    double mean = 0, var = 0, sampen, apen;
+    for (int i = 400 - n; i < 400; i++) mean += x[i];
+    mean /= n;
+    for (int i = 400 - n; i < 400; i++) var += (x[i] - mean) * (x[i] - mean);
+    ASSERT_IN_RANGE((float)ctx.ent_r, (float)(0.2 * sqrt(var / n)) - 1.0f, (float)(0.2 * sqrt(var / n)) + 1.0f);
+
+    nl_entropy_ref(&x[400 - n], n, ctx.ent_r, &sampen, &apen);
+    ASSERT_FLOAT_EQ((float)sampen, ctx.sampen, 0.0001f);
+    ASSERT_FLOAT_EQ((float)apen, ctx.apen, 0.0005f);
+}
+
+TEST(hrv_nl_entropy_regular_below_irregular) {
+    hrv_nonlinear_t reg, irr;
+    hrv_nonlinear_reset(&reg);
+    hrv_nonlinear_reset(&irr);
+
+    for (int i = 0; i < 160; i++) {
+        hrv_nonlinear_add_rr(&reg, 800.0f + 40.0f * sinf((float)i * 0.5f));
+        hrv_nonlinear_add_rr(&irr, 800.0f + 40.0f * nl_gauss());
+    }
+    nl_run_entropy(&reg);
+    nl_run_entropy(&irr);
+
+    ASSERT_TRUE(reg.entropy_valid && irr.entropy_valid);
+    ASSERT_LT(reg.sampen, 0.5f * irr.sampen);
+    ASSERT_LT(reg.apen, irr.apen);
+    ASSERT_GT(irr.sampen, 1.5f);    /* White noise at r = 0.2 SD: ~2.2 */
+}
+
+void run_hrv_nonlinear_tests(void) {
+    RUN_TEST(hrv_nl_constant_rr_has_no_variability);
+    RUN_TEST(hrv_nl_poincare_matches_batch);
+    RUN_TEST(hrv_nl_dfa_waits_for_min_beats);
+    RUN_TEST(hrv_nl_dfa_white_noise_near_half);
+    RUN_TEST(hrv_nl_dfa_correlated_series_high);
+    RUN_TEST(hrv_nl_entropy_matches_naive_scan);
+    RUN_TEST(hrv_nl_entropy_regular_below_irregular);
+}
@@ -0,0 +1,110 @@
+/**
+ * @file test_nvm_store.c
+ * @brief Unit tests for the flash record store (host RAM flash)
+ */
+
+#include "test_framework.h"
+#include "../src/system/nvm_store.h"
+
+TEST(nvm_read_missing_record) {
+    uint32_t v;
+    nvm_store_format();
+    ASSERT_EQ(-3, nvm_store_read(0x0042, &v, sizeof(v)));
+}
+
+TEST(nvm_write_read_latest) {
+    uint32_t v = 1, out = 0;
+    nvm_store_format();
+    ASSERT_EQ(0, nvm_store_write(0x0042, &v, sizeof(v)));
+    v = 2;
+    ASSERT_EQ(0, nvm_store_write(0x0042, &v, sizeof(v)));
+    ASSERT_EQ(0, nvm_store_read(0x0042, &out, sizeof(out)));
+    ASSERT_EQ(2, out);
+
+    uint16_t wrong;
+    ASSERT_EQ(-4, nvm_store_read(0x0042, &wrong, sizeof(wrong)));
+}
+
+TEST(nvm_survives_remount_and_compaction) {
+    uint8_t blob[100];
+    uint32_t a = 0xA5A5A5A5U, out = 0;
+    nvm_store_format();
+    ASSERT_EQ(0, nvm_store_write(0x0001, &a, sizeof(a)));
+
+    /* Enough rewrites of another record to force several compactions */
+    for (uint16_t i = 0; i < 200; i++) {
+        for (uint8_t k = 0; k < sizeof(blob); k++) blob[k] = (uint8_t)(i + k);
+        ASSERT_EQ(0, nvm_store_write(0x0002, blob, sizeof(blob)));
+    }
+
+    /* Simulated reboot */
+    nvm_store_init();
+    ASSERT_EQ(0, nvm_store_read(0x0001, &out, sizeof(out)));
+    ASSERT_EQ(0xA5A5A5A5U, out);
+    ASSERT_EQ(0, nvm_store_read(0x0002, blob, sizeof(blob)));
+    ASSERT_EQ(199, blob[0]);
+}
+
+TEST(nvm_keeps_record_across_reset_in_compaction) {
+    uint8_t blob[200], out[200];
+    uint32_t a = 0xC0FFEE00U, got = 0;
+
+    hal_host_reset();
+    nvm_store_format();
+    ASSERT_EQ(0, nvm_store_write(0x0001, &a, sizeof(a)));
+
+    /* Rewrite until a compaction; power fails right after it erases the old page */
+    uint32_t erases = g_hal_host.flash_erases;
+    g_hal_host.flash_cut_erases = 2;            /* Spare page, then the old page */
+    for (uint8_t i = 1; g_hal_host.flash_erases == erases; i++) {
+        memset(blob, i, sizeof(blob));
+        ASSERT_EQ(0, nvm_store_write(0x0002, blob, sizeof(blob)));
+    }
+    ASSERT_TRUE(g_hal_host.flash_cut);
+
+    /* Reboot: the record being replaced is still there, as are the others */
+    g_hal_host.flash_cut = false;
+    nvm_store_init();
+    ASSERT_EQ(0, nvm_store_read(0x0002, out, sizeof(out)));
+    ASSERT_EQ(blob[0], out[0]);
+    ASSERT_EQ(0, nvm_store_read(0x0001, &got, sizeof(got)));
+    ASSERT_EQ(0xC0FFEE00U, got);
+}
+
+TEST(nvm_full_page_keeps_old_copy) {
+    uint8_t blob[NVM_MAX_RECORD_LEN], small[100], out[NVM_MAX_RECORD_LEN];
+
+    nvm_store_format();
+    memset(blob, 0x33, sizeof(blob));
+    memset(small, 0x55, sizeof(small));
+    for (uint16_t id = 0x0010; id < 0x001E; id++) {
+        ASSERT_EQ(0, nvm_store_write(id, blob, sizeof(blob)));
+    }
+    ASSERT_EQ(0, nvm_store_write(0x0001, small, sizeof(small)));
+    ASSERT_EQ(0, nvm_store_write(0x0002, blob, 160));
+
+    /* Growing 0x0001 to a full record does not fit even after compaction */
+    ASSERT_EQ(-2, nvm_store_write(0x0001, blob, sizeof(blob)));
+    ASSERT_EQ(0, nvm_store_read(0x0001, out, sizeof(small)));
+    ASSERT_EQ(0x55, out[0]);
+
+    nvm_store_init();
+    ASSERT_EQ(0, nvm_store_read(0x0001, out, sizeof(small)));
+    ASSERT_EQ(0x55, out[0]);
+    ASSERT_EQ(0, nvm_store_read(0x001D, out, sizeof(blob)));
+}
+
+TEST(nvm_rejects_bad_args) {
+    uint8_t big[NVM_MAX_RECORD_LEN + 1];
+    ASSERT_EQ(-1, nvm_store_write(0x0001, NULL, 4));
+    ASSERT_EQ(-1, nvm_store_write(0x0001, big, sizeof(big)));
+}
+
+void run_nvm_store_tests(void) {
+    RUN_TEST(nvm_read_missing_record);
+    RUN_TEST(nvm_write_read_latest);
+    RUN_TEST(nvm_survives_remount_and_compaction);
+    RUN_TEST(nvm_keeps_record_across_reset_in_compaction);
+    RUN_TEST(nvm_full_page_keeps_old_copy);
+    RUN_TEST(nvm_rejects_bad_args);
+}
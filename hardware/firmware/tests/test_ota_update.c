@@ -0,0 +1,207 @@
+/**
+ * @file test_ota_update.c
+ * @brief Unit tests for delta OTA (patches applied to bank images in host RAM flash)
+ */
+
+#include "test_framework.h"
+#include "../src/system/ota_update.h"
+#include "../src/system/nvm_store.h"
+#include "ota_delta.h"
+#include <string.h>
+
+#define OTA_TEST_IMAGE_MAX  (64U * 1024U)
+
+static uint8_t m_ota_old[OTA_TEST_IMAGE_MAX];
+static uint8_t m_ota_new[OTA_TEST_IMAGE_MAX];
+static uint8_t m_ota_patch[OTA_TEST_IMAGE_MAX];
+
+/** Old image: pseudo-random code; new image: relinked with edits and a new feature */
+static void ota_test_images(uint32_t *p_old_len, uint32_t *p_new_len)
+{
+    uint32_t x = 0x1234567U;
+    uint32_t old_len = 48U * 1024U, n = 0;
+
+    for (uint32_t i = 0; i < old_len; i++) {
+        x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+        m_ota_old[i] = (uint8_t)x;
+    }
+
+    /* 10 KB unchanged, 6 KB new code, rest shifted with every 64th word relocated */
+    memcpy(&m_ota_new[n], m_ota_old, 10240U);
+    n += 10240U;
+    for (uint32_t i = 0; i < 6144U; i++) {
+        x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+        m_ota_new[n++] = (uint8_t)x;
+    }
+    for (uint32_t i = 10240U; i < old_len; i++) {
+        uint8_t b = m_ota_old[i];
+        if ((i % 256U) == 0U) b = (uint8_t)(b + 0x18U);    /* Pointer low byte + 6144 */
+        m_ota_new[n++] = b;
+    }
+    m_ota_new[20000] ^= 0x5A;                               /* Patched constant */
+
+    *p_old_len = old_len;
+    *p_new_len = n;
+}
+
+static void ota_test_load_bank_a(const uint8_t *p_img, uint32_t len)
+{
+    uint32_t words[HAL_FLASH_PAGE_SIZE / 4U];
+
+    for (uint32_t off = 0; off < len; off += HAL_FLASH_PAGE_SIZE) {
+        uint32_t chunk = (len - off < HAL_FLASH_PAGE_SIZE) ? len - off : HAL_FLASH_PAGE_SIZE;
+        memset(words, 0xFF, sizeof(words));
+        memcpy(words, &p_img[off], chunk);
+        hal_flash_erase_page(OTA_BANK_A_ADDR + off);
+        hal_flash_write_words(OTA_BANK_A_ADDR + off, words, (uint16_t)((chunk + 3U) / 4U));
+    }
+}
+
+/** Send blocks [from, to) as DATA packets; returns the last response status */
+static int8_t ota_test_send(const uint8_t *p_patch, uint32_t patch_len, uint16_t from, uint16_t to)
+{
+    uint8_t pkt[7 + OTA_BLOCK_SIZE];
+    uint8_t rsp[OTA_RSP_MAX_LEN];
+    int8_t status = 0;
+
+    for (uint16_t b = from; b < to; b++) {
+        uint32_t off = (uint32_t)b * OTA_BLOCK_SIZE;
+        uint16_t len = (uint16_t)((patch_len - off < OTA_BLOCK_SIZE) ? patch_len - off : OTA_BLOCK_SIZE);
+        uint32_t crc = ota_crc32(0, &p_patch[off], len);
+
+        pkt[0] = OTA_OP_DATA;
+        pkt[1] = (uint8_t)b;
+        pkt[2] = (uint8_t)(b >> 8);
+        memcpy(&pkt[3], &crc, 4);
+        memcpy(&pkt[7], &p_patch[off], len);
+        if (ota_update_on_write(pkt, (uint16_t)(7U + len), rsp) > 0U) {
+            status = (int8_t)rsp[1];
+            if (status != 0) break;
+        }
+    }
+    return status;
+}
+
+static int ota_test_start(const uint8_t *p_patch, uint32_t patch_len)
+{
+    uint8_t pkt[9] = { OTA_OP_START };
+    uint8_t rsp[OTA_RSP_MAX_LEN];
+    uint32_t crc = ota_crc32(0, p_patch, patch_len);
+
+    memcpy(&pkt[1], &patch_len, 4);
+    memcpy(&pkt[5], &crc, 4);
+    if (ota_update_on_write(pkt, sizeof(pkt), rsp) != 4U || rsp[1] != 0U) return -1;
+    return rsp[2] | (rsp[3] << 8);
+}
+
+static int8_t ota_test_finish(void)
+{
+    uint8_t pkt[1] = { OTA_OP_FINISH };
+    uint8_t rsp[OTA_RSP_MAX_LEN];
+
+    if (ota_update_on_write(pkt, sizeof(pkt), rsp) != 2U) return -128;
+    return (int8_t)rsp[1];
+}
+
+TEST(ota_crc32_check_value) {
+    const char *s = "123456789";
+    ASSERT_EQ(0xCBF43926U, ota_crc32(0, s, 9));
+    ASSERT_EQ(0xCBF43926U, ota_crc32(ota_crc32(0, s, 4), s + 4, 5));
+}
+
+TEST(ota_delta_patch_applies_to_bank_b) {
+    uint32_t old_len, new_len;
+    ota_test_images(&old_len, &new_len);
+
+    nvm_store_format();
+    ota_update_init();
+    ota_test_load_bank_a(m_ota_old, old_len);
+
+    uint32_t patch_len = (uint32_t)ota_delta_encode(m_ota_old, old_len, m_ota_new, new_len,
+                                                     m_ota_patch, sizeof(m_ota_patch));
+    ASSERT_GT(patch_len, 0);
+    /* New code dominates; the relocated 42 KB costs little */
+    ASSERT_LT(patch_len, new_len / 6U);
+
+    uint16_t blocks = (uint16_t)((patch_len + OTA_BLOCK_SIZE - 1U) / OTA_BLOCK_SIZE);
+    ASSERT_EQ(0, ota_test_start(m_ota_patch, patch_len));
+    ASSERT_EQ(0, ota_test_send(m_ota_patch, patch_len, 0, blocks));
+    ASSERT_FALSE(ota_update_reset_scheduled());
+    ASSERT_EQ(0, ota_test_finish());
+
+    ASSERT_TRUE(memcmp(hal_flash_ptr(OTA_BANK_B_ADDR), m_ota_new, new_len) == 0);
+    ASSERT_TRUE(ota_update_pending());
+    ASSERT_TRUE(ota_update_reset_scheduled());
+
+    /* Pending flag survives a reset */
+    ota_update_init();
+    ASSERT_TRUE(ota_update_pending());
+    ASSERT_FALSE(ota_update_reset_scheduled());
+}
+
+TEST(ota_resumes_from_checkpoint_after_reset) {
+    uint32_t old_len, new_len;
+    ota_test_images(&old_len, &new_len);
+
+    nvm_store_format();
+    ota_update_init();
+    ota_test_load_bank_a(m_ota_old, old_len);
+
+    uint32_t patch_len = (uint32_t)ota_delta_encode(m_ota_old, old_len, m_ota_new, new_len,
+                                                     m_ota_patch, sizeof(m_ota_patch));
+    uint16_t blocks = (uint16_t)((patch_len + OTA_BLOCK_SIZE - 1U) / OTA_BLOCK_SIZE);
+    uint16_t cut = (uint16_t)(2U * OTA_CHECKPOINT_BLOCKS + 5U);
+    ASSERT_GT(blocks, cut);
+
+    ASSERT_EQ(0, ota_test_start(m_ota_patch, patch_len));
+    ASSERT_EQ(0, ota_test_send(m_ota_patch, patch_len, 0, cut));
+
+    /* Reconnect without reset: continue where it stopped */
+    ASSERT_EQ(cut, ota_test_start(m_ota_patch, patch_len));
+
+    /* Reset: RAM state lost, back to the last checkpoint */
+    ota_update_init();
+    int next = ota_test_start(m_ota_patch, patch_len);
+    ASSERT_EQ(2 * OTA_CHECKPOINT_BLOCKS, next);
+
+    ASSERT_EQ(0, ota_test_send(m_ota_patch, patch_len, (uint16_t)next, blocks));
+    ASSERT_EQ(0, ota_test_finish());
+    ASSERT_TRUE(memcmp(hal_flash_ptr(OTA_BANK_B_ADDR), m_ota_new, new_len) == 0);
+}
+
+TEST(ota_rejects_bad_blocks_and_wrong_base) {
+    uint32_t old_len, new_len;
+    uint8_t saved;
+    ota_test_images(&old_len, &new_len);
+
+    nvm_store_format();
+    ota_update_init();
+    ota_test_load_bank_a(m_ota_old, old_len);
+
+    uint32_t patch_len = (uint32_t)ota_delta_encode(m_ota_old, old_len, m_ota_new, new_len,
+                                                     m_ota_patch, sizeof(m_ota_patch));
+    ASSERT_EQ(0, ota_test_start(m_ota_patch, patch_len));
+
+    /* Corrupted in flight: CRC fails, block not consumed */
+    ASSERT_EQ(-2, ota_update_block(0, m_ota_patch, OTA_BLOCK_SIZE, ota_crc32(0, m_ota_patch, OTA_BLOCK_SIZE) ^ 1U));
+    ASSERT_EQ(0, ota_update_next_block());
+    ASSERT_EQ(-3, ota_test_send(m_ota_patch, patch_len, 1, 2));
+    ASSERT_EQ(-6, ota_test_finish());
+
+    /* Patch built for another image: refused once the header is in */
+    saved = m_ota_old[100];
+    m_ota_old[100] ^= 0xFF;
+    ota_test_load_bank_a(m_ota_old, old_len);
+    m_ota_old[100] = saved;
+    ASSERT_EQ(-5, ota_test_send(m_ota_patch, patch_len, 0, 1));
+    ASSERT_EQ(-1, ota_test_finish());
+    ASSERT_FALSE(ota_update_pending());
+    ASSERT_FALSE(ota_update_reset_scheduled());
+}
+
+void run_ota_update_tests(void) {
+    RUN_TEST(ota_crc32_check_value);
+    RUN_TEST(ota_delta_patch_applies_to_bank_b);
+    RUN_TEST(ota_resumes_from_checkpoint_after_reset);
+    RUN_TEST(ota_rejects_bad_blocks_and_wrong_base);
+}
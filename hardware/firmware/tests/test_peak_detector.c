@@ -0,0 +1,114 @@
+/**
+ * @file test_peak_detector.c
+ * @brief Unit tests for the pluggable PPG peak detector engines
+ */
+
+#include "test_framework.h"
+#include "ppg_synth.h"
+#include "../src/core/peak_detector.h"
+#include "../src/core/wellness_processor.h"
+
+/* Feed a clean 65 bpm signal; return detected beats, mean and shortest RR */
+static uint16_t pd_run_clean(peak_detector_id_t id, uint32_t seconds, float *mean_rr, uint32_t *min_rr)
+{
+    ppg_synth_params_t p = ppg_synth_defaults();
+    ppg_synth_t synth;
+    peak_detector_t det;
+    float block[25];
+    uint16_t beats = 0;
+    uint32_t first = 0, last = 0;
+
+    *min_rr = UINT32_MAX;
+
+    p.hrv_sd_ms = 0.0f;
+    p.rsa_ms = 0.0f;
+    ppg_synth_init(&synth, &p);
+    peak_detector_init(&det, id);
+
+    for (uint32_t n = 0; n < seconds * PPG_SYNTH_FS_HZ; n += 25U) {
+        uint32_t t0 = synth.t_ms;
+        for (uint8_t k = 0; k < 25U; k++) {
+            block[k] = ppg_synth_next(&synth, NULL, NULL);
+        }
+        peak_detector_process_block(&det, block, 25U, t0, PPG_SYNTH_PERIOD_MS);
+
+        ppg_beat_t beat;
+        while (peak_detector_pop(&det, &beat)) {
+            if (beats == 0) first = beat.peak_ms;
+            else if (beat.peak_ms - last < *min_rr) *min_rr = beat.peak_ms - last;
+            last = beat.peak_ms;
+            beats++;
+        }
+    }
+
+    *mean_rr = (beats > 1) ? (float)(last - first) / (float)(beats - 1) : 0.0f;
+    return beats;
+}
+
+/* Legacy engine: its decaying threshold also fires on the dicrotic wave,
+ * so only check that no beat is missed and the refractory guard holds. */
+TEST(peak_detector_pan_tompkins_clean) {
+    float mean_rr;
+    uint32_t min_rr;
+    uint16_t beats = pd_run_clean(PEAK_DETECTOR_PAN_TOMPKINS, 30, &mean_rr, &min_rr);
+    ASSERT_GE(beats, 28);
+    ASSERT_GT(min_rr, 300);
+}
+
+TEST(peak_detector_ssf_clean) {
+    float mean_rr;
+    uint32_t min_rr;
+    uint16_t beats = pd_run_clean(PEAK_DETECTOR_SSF, 30, &mean_rr, &min_rr);
+    ASSERT_TRUE(beats >= 28 && beats <= 34);
+    ASSERT_FLOAT_EQ(923.0f, mean_rr, 20.0f);
+    ASSERT_GT(min_rr, 800);
+}
+
+TEST(peak_detector_elgendi_clean) {
+    float mean_rr;
+    uint32_t min_rr;
+    uint16_t beats = pd_run_clean(PEAK_DETECTOR_ELGENDI, 30, &mean_rr, &min_rr);
+    ASSERT_TRUE(beats >= 28 && beats <= 34);
+    ASSERT_FLOAT_EQ(923.0f, mean_rr, 20.0f);
+    ASSERT_GT(min_rr, 800);
+}
+
+TEST(peak_detector_invalid_id_falls_back) {
+    peak_detector_t det;
+    peak_detector_init(&det, (peak_detector_id_t)99);
+    ASSERT_EQ(PPG_DETECTOR_DEFAULT, det.id);
+    ASSERT_NOT_NULL(peak_detector_name(PEAK_DETECTOR_SSF));
+}
+
+TEST(peak_detector_queue_drops_oldest) {
+    peak_detector_t det;
+    ppg_beat_t beat;
+    peak_detector_init(&det, PEAK_DETECTOR_SSF);
+
+    for (uint32_t i = 0; i < PEAK_DETECTOR_BEAT_QUEUE + 2U; i++) {
+        peak_detector_emit(&det, 1000U * i, 1.0f);
+    }
+    ASSERT_EQ(2, det.beats_dropped);
+    ASSERT_TRUE(peak_detector_pop(&det, &beat));
+    ASSERT_EQ(2000, beat.peak_ms);
+
+    peak_detector_reset(&det);
+    ASSERT_FALSE(peak_detector_pop(&det, &beat));
+}
+
+TEST(wellness_detector_selection) {
+    ASSERT_EQ(-1, wellness_set_detector(PEAK_DETECTOR_COUNT));
+    ASSERT_EQ(0, wellness_set_detector(PEAK_DETECTOR_ELGENDI));
+    ASSERT_EQ(PEAK_DETECTOR_ELGENDI, wellness_get_detector());
+    ASSERT_EQ(0, wellness_set_detector(PEAK_DETECTOR_PAN_TOMPKINS));
+    wellness_reset();
+}
+
+void run_peak_detector_tests(void) {
+    RUN_TEST(peak_detector_pan_tompkins_clean);
+    RUN_TEST(peak_detector_ssf_clean);
+    RUN_TEST(peak_detector_elgendi_clean);
+    RUN_TEST(peak_detector_invalid_id_falls_back);
+    RUN_TEST(peak_detector_queue_drops_oldest);
+    RUN_TEST(wellness_detector_selection);
+}
@@ -0,0 +1,85 @@
+/**
+ * @file test_ppg_codec.c
+ * @brief Unit tests for the lossless raw PPG block codec
+ */
+
+#include "test_framework.h"
+#include "ppg_synth.h"
+#include "../src/core/ppg_codec.h"
+
+#define PPG_CODEC_TEST_FRAMES   50U
+
+TEST(ppg_codec_round_trip_waveform) {
+    ppg_synth_params_t p = ppg_synth_defaults();
+    ppg_synth_t synth;
+    static int32_t frames[PPG_CODEC_TEST_FRAMES * 2U], out[PPG_CODEC_TEST_FRAMES * 2U];
+    static uint8_t buf[PPG_CODEC_MAX_BYTES(PPG_CODEC_TEST_FRAMES, 2U)];
+    uint32_t coded = 0;
+
+    /* ~1% perfusion around half scale, AFE-level noise, as the ring sees it */
+    p.dc = 100.0f;
+    p.noise = 0.005f;
+    ppg_synth_init(&synth, &p);
+
+    for (uint32_t b = 0; b < 20U; b++) {
+        for (uint32_t i = 0; i < PPG_CODEC_TEST_FRAMES; i++) {
+            float v = ppg_synth_next(&synth, NULL, NULL);
+            frames[2U * i] = (int32_t)(v * 2621.44f);
+            frames[2U * i + 1U] = (int32_t)((0.5f * v + 60.0f) * 2621.44f);
+        }
+        int n = ppg_codec_encode(frames, PPG_CODEC_TEST_FRAMES, 2, buf, sizeof(buf));
+        ASSERT_GT(n, 0);
+        ASSERT_EQ(n, ppg_codec_decode(buf, (uint16_t)n, PPG_CODEC_TEST_FRAMES, 2, out));
+        ASSERT_EQ(0, memcmp(frames, out, sizeof(frames)));
+        coded += (uint32_t)n;
+    }
+
+    /* At least 2x against 16-bit samples */
+    ASSERT_LT(coded, 20U * PPG_CODEC_TEST_FRAMES * 2U * 2U / 2U);
+
+    /* Single frame, odd channel count */
+    static const int32_t one[3] = { 0, -1, 262143 };
+    int32_t one_out[3];
+    int n = ppg_codec_encode(one, 1, 3, buf, sizeof(buf));
+    ASSERT_EQ((int)PPG_CODEC_MAX_BYTES(1, 3), n);
+    ASSERT_EQ(n, ppg_codec_decode(buf, (uint16_t)n, 1, 3, one_out));
+    ASSERT_EQ(0, memcmp(one, one_out, sizeof(one)));
+}
+
+TEST(ppg_codec_extremes_and_errors) {
+    static int32_t frames[PPG_CODEC_TEST_FRAMES], out[PPG_CODEC_TEST_FRAMES];
+    static uint8_t buf[PPG_CODEC_MAX_BYTES(PPG_CODEC_TEST_FRAMES, 1U) + 8U];
+    uint32_t rng = 99U;
+
+    /* Full-scale white noise: verbatim, never over the bound */
+    for (uint32_t i = 0; i < PPG_CODEC_TEST_FRAMES; i++) {
+        rng = rng * 1664525U + 1013904223U;
+        frames[i] = (int32_t)(rng >> 12) - 524288;
+    }
+    int n = ppg_codec_encode(frames, PPG_CODEC_TEST_FRAMES, 1, buf, sizeof(buf));
+    ASSERT_GT(n, 0);
+    ASSERT_LE(n, (int)PPG_CODEC_MAX_BYTES(PPG_CODEC_TEST_FRAMES, 1U));
+    ASSERT_EQ(n, ppg_codec_decode(buf, (uint16_t)n, PPG_CODEC_TEST_FRAMES, 1, out));
+    ASSERT_EQ(0, memcmp(frames, out, sizeof(frames)));
+
+    /* Flat signal with rail-to-rail steps: escaped residuals */
+    for (uint32_t i = 0; i < PPG_CODEC_TEST_FRAMES; i++) {
+        frames[i] = (i == 20U || i == 21U) ? 524287 : ((i == 35U) ? -524288 : 1000);
+    }
+    n = ppg_codec_encode(frames, PPG_CODEC_TEST_FRAMES, 1, buf, sizeof(buf));
+    ASSERT_GT(n, 0);
+    ASSERT_LT(n, (int)PPG_CODEC_MAX_BYTES(PPG_CODEC_TEST_FRAMES, 1U) / 2);
+    ASSERT_EQ(n, ppg_codec_decode(buf, (uint16_t)n, PPG_CODEC_TEST_FRAMES, 1, out));
+    ASSERT_EQ(0, memcmp(frames, out, sizeof(frames)));
+
+    /* Truncated block, short buffer, out-of-range sample */
+    ASSERT_EQ(-1, ppg_codec_decode(buf, (uint16_t)(n - 1), PPG_CODEC_TEST_FRAMES, 1, out));
+    ASSERT_EQ(-1, ppg_codec_encode(frames, PPG_CODEC_TEST_FRAMES, 1, buf, (uint16_t)(n - 1)));
+    frames[7] = 524288;
+    ASSERT_EQ(-1, ppg_codec_encode(frames, PPG_CODEC_TEST_FRAMES, 1, buf, sizeof(buf)));
+}
+
+void run_ppg_codec_tests(void) {
+    RUN_TEST(ppg_codec_round_trip_waveform);
+    RUN_TEST(ppg_codec_extremes_and_errors);
+}
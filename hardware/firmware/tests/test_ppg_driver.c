@@ -0,0 +1,256 @@
+/**
+ * @file test_ppg_driver.c
+ * @brief Unit tests for the PPG acquisition driver (FIFO decode, ping-pong, replay, capture)
+ */
+
+#include "test_framework.h"
+#include "ppg_synth.h"
+#include "../src/sensors/ppg_driver.h"
+#include "../src/sensors/ppg_capture.h"
+#include "../src/system/bus_manager.h"
+
+#define PPG_DRV_TEST_SCALE      16.0f   /* Synth peaks stay below this */
+#define PPG_DRV_TEST_FILE       "ppg_replay_test.tmp"
+
+static void drv_put_sample(uint8_t *p, uint8_t tag, uint32_t count)
+{
+    p[0] = (uint8_t)((tag << 3) | ((count >> 16) & 0x07U));
+    p[1] = (uint8_t)(count >> 8);
+    p[2] = (uint8_t)count;
+}
+
+/* Encode one FIFO block (green, IR = green * 0.5) as the AFE would send it */
+static void drv_fill_block(uint8_t *p_raw, ppg_synth_t *p_synth)
+{
+    for (uint16_t k = 0; k < PPG_BLOCK_FRAMES; k++) {
+        float v = ppg_synth_next(p_synth, NULL, NULL) / PPG_DRV_TEST_SCALE;
+        uint32_t count = (uint32_t)(v * PPG_ADC_FULL_SCALE);
+        drv_put_sample(&p_raw[(2U * k) * PPG_SAMPLE_BYTES], 1, count);
+        drv_put_sample(&p_raw[(2U * k + 1U) * PPG_SAMPLE_BYTES], 2, count / 2U);
+    }
+}
+
+/* One PPG_INT + DMA completion at the given RTC time */
+static void drv_dma_block(ppg_synth_t *p_synth, uint32_t rtc_ms)
+{
+    hal_host_set_time_ms(rtc_ms);
+    (void)hal_host_gpio_fire(HAL_PIN_PPG_INT);
+    drv_fill_block(&m_ppg.rx[m_ppg.dma_idx][PPG_SPI_HDR_BYTES], p_synth);
+    bus_mock_drain(BUS_SPI0);
+}
+
+TEST(ppg_driver_decode_fifo) {
+    uint8_t raw[5 * PPG_SAMPLE_BYTES];
+    float frames[2 * PPG_CHANNELS];
+
+    drv_put_sample(&raw[0], 1, 0x40000U);                       /* LEDC1 */
+    drv_put_sample(&raw[3], MAX86141_TAG_INVALID, 0x7FFFFU);    /* skipped */
+    drv_put_sample(&raw[6], 2, 0x7FFFFU);                       /* LEDC2 */
+    drv_put_sample(&raw[9], 1, 0);
+    drv_put_sample(&raw[12], 1, 0x10000U);                      /* no LEDC2: incomplete */
+
+    ASSERT_EQ(1, ppg_decode_fifo(raw, 5, frames));
+    ASSERT_FLOAT_EQ(0.5f, frames[0], 1e-6f);
+    ASSERT_FLOAT_EQ(1.0f, frames[1], 1e-5f);
+}
+
+TEST(ppg_driver_ping_pong_blocks) {
+    ppg_synth_params_t p = ppg_synth_defaults();
+    ppg_synth_t synth;
+    float rr;
+    uint16_t n_rr = 0;
+
+    bus_manager_init();
+    ppg_init();
+    ASSERT_EQ(PPG_INIT_STEPS, bus_mock_drain(BUS_SPI0));
+    wellness_reset();
+    ASSERT_EQ(0, wellness_set_detector(PEAK_DETECTOR_SSF));
+    ppg_synth_init(&synth, &p);
+
+    /* Both buffers fill before the thread runs; a third INT is an overrun */
+    drv_dma_block(&synth, 240);
+    drv_dma_block(&synth, 490);
+    g_hal_host.rtc_ticks += 100U;
+    ASSERT_TRUE(hal_host_gpio_fire(HAL_PIN_PPG_INT));
+    ASSERT_EQ(1, ppg_get_overruns());
+    ASSERT_EQ(2 * PPG_BLOCK_FRAMES, ppg_process(0));
+    ASSERT_EQ(0, ppg_process(0));
+
+    /* Frame times are laid out backwards from each INT */
+    ASSERT_EQ(490, m_ppg.last_frame_ms);
+
+    /* INT latency jitter must not overlap frames */
+    drv_dma_block(&synth, 735);
+    ASSERT_EQ(PPG_BLOCK_FRAMES, ppg_process(0));
+    ASSERT_EQ(740, m_ppg.last_frame_ms);
+
+    for (uint32_t t = 990; t < 40000U; t += 250U) {
+        drv_dma_block(&synth, t);
+        ppg_process(0);
+    }
+    while (ppg_get_rr(&rr)) {
+        ASSERT_IN_RANGE(rr, 700.0f, 1150.0f);
+        n_rr++;
+    }
+    ASSERT_GT(n_rr, 30);
+    ASSERT_EQ(1, ppg_get_overruns());
+
+    wellness_reset();
+    ASSERT_EQ(0, wellness_set_detector(PEAK_DETECTOR_PAN_TOMPKINS));
+}
+
+TEST(ppg_driver_replay_file) {
+    ppg_synth_params_t p = ppg_synth_defaults();
+    ppg_synth_t synth;
+    FILE *f = fopen(PPG_DRV_TEST_FILE, "w");
+    float rr;
+    uint16_t n_rr = 0;
+
+    ASSERT_NOT_NULL(f);
+    ppg_synth_init(&synth, &p);
+    fprintf(f, "# t_ms green ir\n");
+    for (uint32_t n = 0; n < 40U * PPG_SYNTH_FS_HZ; n++) {
+        uint32_t t = synth.t_ms;
+        float v = ppg_synth_next(&synth, NULL, NULL);
+        fprintf(f, "%u %.5f %.5f\n", (unsigned)t, v, 0.5f * v);
+    }
+    fclose(f);
+
+    bus_manager_init();
+    ppg_init();
+    ASSERT_EQ(PPG_INIT_STEPS, bus_mock_drain(BUS_SPI0));
+    wellness_reset();
+    ASSERT_EQ(0, wellness_set_detector(PEAK_DETECTOR_SSF));
+    ASSERT_EQ(-1, ppg_replay_open("does/not/exist.txt"));
+    ASSERT_EQ(0, ppg_replay_open(PPG_DRV_TEST_FILE));
+
+    /* Only frames up to now are handed over */
+    ASSERT_EQ(11, ppg_process(100));
+    ASSERT_FALSE(ppg_replay_done());
+
+    for (uint32_t now = 110; now <= 40000U; now += 10U) {
+        ppg_process(now);
+    }
+    ASSERT_TRUE(ppg_replay_done());
+    ppg_replay_close();
+    remove(PPG_DRV_TEST_FILE);
+
+    while (ppg_get_rr(&rr)) {
+        ASSERT_IN_RANGE(rr, 700.0f, 1150.0f);
+        n_rr++;
+    }
+    ASSERT_GT(n_rr, 30);
+
+    wellness_reset();
+    ASSERT_EQ(0, wellness_set_detector(PEAK_DETECTOR_PAN_TOMPKINS));
+}
+
+/* Next capture SDU: header fields, decoded counts; false if none queued */
+static bool drv_capture_next(uint16_t *p_seq, uint32_t *p_t0, uint8_t *p_frames, int32_t *p_counts)
+{
+    const uint8_t *p_sdu;
+    uint16_t len;
+
+    if (!ppg_capture_peek(&p_sdu, &len)) return false;
+    memcpy(p_seq, &p_sdu[0], 2);
+    memcpy(p_t0, &p_sdu[2], 4);
+    *p_frames = p_sdu[6];
+    bool ok = p_sdu[7] == PPG_CHANNELS &&
+              ppg_codec_decode(&p_sdu[PPG_CAPTURE_HDR_BYTES], (uint16_t)(len - PPG_CAPTURE_HDR_BYTES),
+                               *p_frames, PPG_CHANNELS, p_counts) == (int)(len - PPG_CAPTURE_HDR_BYTES);
+    ppg_capture_pop();
+    return ok;
+}
+
+TEST(ppg_driver_capture_blocks) {
+    ppg_synth_params_t p = ppg_synth_defaults();
+    ppg_synth_t synth, expect;
+    static int32_t counts[PPG_CAPTURE_BLOCK_FRAMES * PPG_CHANNELS];
+    ppg_capture_stats_t stats;
+    uint16_t seq;
+    uint32_t t0;
+    uint8_t frames;
+
+    bus_manager_init();
+    ppg_init();
+    ASSERT_EQ(PPG_INIT_STEPS, bus_mock_drain(BUS_SPI0));
+    wellness_reset();
+    ppg_synth_init(&synth, &p);
+    ppg_synth_init(&expect, &p);
+    ppg_capture_start();
+
+    /* 1 s of FIFO blocks: two full capture blocks, exactly the AFE counts */
+    for (uint32_t t = 240; t <= 990U; t += 250U) {
+        drv_dma_block(&synth, t);
+        ppg_process(0);
+    }
+    for (uint16_t b = 0; b < 2U; b++) {
+        ASSERT_TRUE(drv_capture_next(&seq, &t0, &frames, counts));
+        ASSERT_EQ(b, seq);
+        ASSERT_EQ(b * 500U, t0);
+        ASSERT_EQ(PPG_CAPTURE_BLOCK_FRAMES, frames);
+        for (uint32_t k = 0; k < PPG_CAPTURE_BLOCK_FRAMES; k++) {
+            float v = ppg_synth_next(&expect, NULL, NULL) / PPG_DRV_TEST_SCALE;
+            uint32_t count = (uint32_t)(v * PPG_ADC_FULL_SCALE);
+            ASSERT_EQ((int32_t)count, counts[k * PPG_CHANNELS]);
+            ASSERT_EQ((int32_t)(count / 2U), counts[k * PPG_CHANNELS + 1U]);
+        }
+    }
+    ASSERT_FALSE(drv_capture_next(&seq, &t0, &frames, counts));
+
+    /* A jump in the frame timeline closes the block early */
+    drv_dma_block(&synth, 1240);
+    ppg_process(0);
+    drv_dma_block(&synth, 2490);
+    ppg_process(0);
+    ASSERT_TRUE(drv_capture_next(&seq, &t0, &frames, counts));
+    ASSERT_EQ(2, seq);
+    ASSERT_EQ(1000, t0);
+    ASSERT_EQ(PPG_BLOCK_FRAMES, frames);
+
+    /* A link that cannot keep up loses whole blocks, numbered */
+    for (uint32_t t = 2740; t <= 2490U + 250U * 2U * (PPG_CAPTURE_QUEUE + 2U); t += 250U) {
+        drv_dma_block(&synth, t);
+        ppg_process(0);
+    }
+    ppg_capture_get_stats(&stats);
+    ASSERT_EQ(2U + 1U + PPG_CAPTURE_QUEUE, stats.blocks);
+    ASSERT_EQ(2U, stats.dropped);
+    ASSERT_LT(stats.coded_bytes, stats.blocks * PPG_CAPTURE_BLOCK_FRAMES * PPG_CHANNELS * 2U);
+    ASSERT_TRUE(drv_capture_next(&seq, &t0, &frames, counts));
+    ASSERT_EQ(3, seq);
+    while (drv_capture_next(&seq, &t0, &frames, counts)) {}
+
+    /* Stopping mid-block still emits the tail */
+    drv_dma_block(&synth, 7740);
+    ppg_process(0);
+    drv_dma_block(&synth, 7990);
+    ppg_process(0);
+    ppg_capture_stop();
+    ASSERT_FALSE(ppg_capture_active());
+    ASSERT_TRUE(drv_capture_next(&seq, &t0, &frames, counts));
+    ASSERT_EQ(7250, t0);
+    ASSERT_EQ(PPG_CAPTURE_BLOCK_FRAMES, frames);
+    ASSERT_TRUE(drv_capture_next(&seq, &t0, &frames, counts));
+    ASSERT_EQ(7750, t0);
+    ASSERT_EQ(PPG_BLOCK_FRAMES, frames);
+    ASSERT_FALSE(drv_capture_next(&seq, &t0, &frames, counts));
+
+    /* Abort (link gone) drops the partial block and the queue */
+    ppg_capture_start();
+    for (uint32_t t = 8240; t <= 8740U; t += 250U) {
+        drv_dma_block(&synth, t);
+        ppg_process(0);
+    }
+    ppg_capture_abort();
+    ASSERT_FALSE(ppg_capture_active());
+    ASSERT_FALSE(drv_capture_next(&seq, &t0, &frames, counts));
+    wellness_reset();
+}
+
+void run_ppg_driver_tests(void) {
+    RUN_TEST(ppg_driver_decode_fifo);
+    RUN_TEST(ppg_driver_ping_pong_blocks);
+    RUN_TEST(ppg_driver_replay_file);
+    RUN_TEST(ppg_driver_capture_blocks);
+}
@@ -0,0 +1,155 @@
+/**
+ * @file test_ppg_fusion.c
+ * @brief Unit tests for multi-channel PPG beat fusion
+ */
+
+#include "test_framework.h"
+#include "ppg_synth.h"
+#include "../src/core/ppg_fusion.h"
+
+#define FUSION_TEST_IR_DELAY    4       /* IR fiducial 40 ms after green */
+
+static uint32_t s_fu_rng = 424242U;
+static uint8_t s_fu_led_calls;
+static bool s_fu_led_state[PPG_FUSION_MAX_CHANNELS];
+
+static float fu_noise(float sd)
+{
+    s_fu_rng ^= s_fu_rng << 13;
+    s_fu_rng ^= s_fu_rng >> 17;
+    s_fu_rng ^= s_fu_rng << 5;
+    return sd * (((float)(s_fu_rng & 0xFFFFU) / 32768.0f) - 1.0f) * 1.7f;
+}
+
+static void fu_led(uint8_t channel, bool enabled)
+{
+    s_fu_led_calls++;
+    s_fu_led_state[channel] = enabled;
+}
+
+/**
+ * Run two channels from one constant-RR beat train: green as generated, IR
+ * delayed and attenuated. Green noise changes at switch_s. Reports the worst
+ * fused RR error from measure_s on.
+ */
+static void fu_run(ppg_fusion_t *f, uint32_t seconds, float green_sd, float ir_sd,
+                   uint32_t switch_s, float green_sd_after, uint32_t measure_s,
+                   float *max_rr_err, uint16_t *n_rr)
+{
+    ppg_synth_params_t p = ppg_synth_defaults();
+    ppg_synth_t synth;
+    float delay[FUSION_TEST_IR_DELAY] = {0};
+    float frames[2 * 25];
+    uint32_t out_prev = 0;
+    bool have_out = false;
+    const float true_rr = 60000.0f / p.hr_bpm;
+
+    p.noise = 0.0f;
+    p.hrv_sd_ms = 0.0f;
+    p.rsa_ms = 0.0f;
+    ppg_synth_init(&synth, &p);
+    for (uint8_t i = 0; i < FUSION_TEST_IR_DELAY; i++) delay[i] = p.dc;
+
+    *max_rr_err = 0.0f;
+    *n_rr = 0;
+
+    for (uint32_t n = 0; n < seconds * PPG_SYNTH_FS_HZ; n += 25U) {
+        uint32_t t0 = synth.t_ms;
+        for (uint8_t k = 0; k < 25U; k++) {
+            float v = ppg_synth_next(&synth, NULL, NULL);
+            float sd = (synth.t_ms / 1000U >= switch_s) ? green_sd_after : green_sd;
+
+            frames[2 * k] = v + fu_noise(sd);
+            frames[2 * k + 1] = 0.5f * delay[0] + fu_noise(ir_sd);
+            for (uint8_t d = 0; d + 1 < FUSION_TEST_IR_DELAY; d++) delay[d] = delay[d + 1];
+            delay[FUSION_TEST_IR_DELAY - 1] = v;
+        }
+        ppg_fusion_process(f, frames, 25U, t0, PPG_SYNTH_PERIOD_MS);
+
+        ppg_beat_t beat;
+        while (ppg_fusion_pop(f, &beat)) {
+            if (have_out && n >= measure_s * PPG_SYNTH_FS_HZ) {
+                float err = fabsf((float)(beat.peak_ms - out_prev) - true_rr);
+                if (err > *max_rr_err) *max_rr_err = err;
+                (*n_rr)++;
+            }
+            out_prev = beat.peak_ms;
+            have_out = true;
+        }
+    }
+}
+
+TEST(ppg_fusion_single_channel_passthrough) {
+    ppg_fusion_t f;
+    ppg_fusion_init(&f, 1, PEAK_DETECTOR_SSF);
+
+    /* One channel: interleaved layout degenerates to plain samples */
+    ppg_synth_params_t p = ppg_synth_defaults();
+    ppg_synth_t synth;
+    float block[25];
+    uint16_t beats = 0;
+    ppg_synth_init(&synth, &p);
+    for (uint32_t n = 0; n < 30U * PPG_SYNTH_FS_HZ; n += 25U) {
+        uint32_t t0 = synth.t_ms;
+        for (uint8_t k = 0; k < 25U; k++) block[k] = ppg_synth_next(&synth, NULL, NULL);
+        ppg_fusion_process(&f, block, 25U, t0, PPG_SYNTH_PERIOD_MS);
+        ppg_beat_t beat;
+        while (ppg_fusion_pop(&f, &beat)) beats++;
+    }
+    ASSERT_TRUE(beats >= 28 && beats <= 34);
+}
+
+TEST(ppg_fusion_keeps_clean_channel) {
+    ppg_fusion_t f;
+    float max_err;
+    uint16_t n_rr;
+    ppg_fusion_init(&f, 2, PEAK_DETECTOR_SSF);
+
+    fu_run(&f, 90, 0.01f, 0.6f, 1000, 0.01f, 20, &max_err, &n_rr);
+    ASSERT_EQ(PPG_CHANNEL_GREEN, f.primary);
+    ASSERT_TRUE(f.ch[PPG_CHANNEL_GREEN].sqi > f.ch[PPG_CHANNEL_IR].sqi);
+    ASSERT_GT(n_rr, 50);
+    ASSERT_LT(max_err, 25.0f);
+}
+
+TEST(ppg_fusion_switches_with_aligned_rr) {
+    ppg_fusion_t f;
+    float max_err;
+    uint16_t n_rr;
+    ppg_fusion_init(&f, 2, PEAK_DETECTOR_SSF);
+
+    /* Green turns to noise at 60 s; IR (delayed 40 ms) must take over */
+    fu_run(&f, 150, 0.01f, 0.01f, 60, 0.9f, 100, &max_err, &n_rr);
+    ASSERT_EQ(PPG_CHANNEL_IR, f.primary);
+    ASSERT_GE(f.switches, 1);
+    ASSERT_FLOAT_EQ(40.0f, f.ch[PPG_CHANNEL_IR].lag_ms, 15.0f);
+    ASSERT_GT(n_rr, 40);
+    ASSERT_LT(max_err, 25.0f);
+}
+
+TEST(ppg_fusion_led_power_saving) {
+    ppg_fusion_t f;
+    float max_err;
+    uint16_t n_rr;
+    s_fu_led_calls = 0;
+    s_fu_led_state[0] = s_fu_led_state[1] = true;
+    ppg_fusion_init(&f, 2, PEAK_DETECTOR_SSF);
+    ppg_fusion_set_led_callback(&f, fu_led);
+
+    /* Both clean: after the hold time the secondary LED goes off */
+    fu_run(&f, 120, 0.01f, 0.01f, 1000, 0.01f, 20, &max_err, &n_rr);
+    ASSERT_FALSE(s_fu_led_state[PPG_CHANNEL_IR]);
+    ASSERT_FALSE(f.ch[PPG_CHANNEL_IR].led_on);
+    ASSERT_LT(max_err, 25.0f);
+
+    /* Reset turns it back on */
+    ppg_fusion_reset(&f);
+    ASSERT_TRUE(s_fu_led_state[PPG_CHANNEL_IR]);
+}
+
+void run_ppg_fusion_tests(void) {
+    RUN_TEST(ppg_fusion_single_channel_passthrough);
+    RUN_TEST(ppg_fusion_keeps_clean_channel);
+    RUN_TEST(ppg_fusion_switches_with_aligned_rr);
+    RUN_TEST(ppg_fusion_led_power_saving);
+}
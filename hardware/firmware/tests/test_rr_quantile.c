@@ -0,0 +1,83 @@
+/**
+ * @file test_rr_quantile.c
+ * @brief Unit tests for the sliding-window RR median / quantile filter
+ */
+
+#include "test_framework.h"
+#include "../src/core/rr_quantile.h"
+#include <stdlib.h>
+
+static int rq_cmp_u16(const void *a, const void *b)
+{
+    return (int)*(const uint16_t *)a - (int)*(const uint16_t *)b;
+}
+
+TEST(rr_quantile_empty_returns_zero) {
+    rr_quantile_t q;
+    rr_quantile_init(&q, 9);
+    ASSERT_EQ(0, rr_quantile_count(&q));
+    ASSERT_EQ(0, rr_quantile_median(&q));
+}
+
+TEST(rr_quantile_median_odd_window) {
+    rr_quantile_t q;
+    rr_quantile_init(&q, 5);
+    rr_quantile_push(&q, 900);
+    rr_quantile_push(&q, 700);
+    rr_quantile_push(&q, 1500);
+    rr_quantile_push(&q, 800);
+    rr_quantile_push(&q, 850);
+    ASSERT_EQ(850, rr_quantile_median(&q));
+    ASSERT_EQ(700, rr_quantile_get(&q, 0));
+    ASSERT_EQ(1500, rr_quantile_get(&q, 100));
+}
+
+TEST(rr_quantile_evicts_oldest) {
+    rr_quantile_t q;
+    rr_quantile_init(&q, 3);
+    rr_quantile_push(&q, 100);
+    rr_quantile_push(&q, 200);
+    rr_quantile_push(&q, 300);
+    rr_quantile_push(&q, 400);  /* 100 leaves */
+    ASSERT_EQ(3, rr_quantile_count(&q));
+    ASSERT_EQ(200, rr_quantile_select(&q, 0));
+    ASSERT_EQ(400, rr_quantile_select(&q, 2));
+}
+
+TEST(rr_quantile_clamps_to_domain) {
+    rr_quantile_t q;
+    rr_quantile_init(&q, 4);
+    rr_quantile_push(&q, 60000);
+    ASSERT_EQ(RR_QUANTILE_DOMAIN - 1, rr_quantile_median(&q));
+}
+
+TEST(rr_quantile_matches_sorted_window) {
+    rr_quantile_t q;
+    uint16_t history[500];
+    uint16_t sorted[RR_QUANTILE_CAPACITY];
+    uint32_t rng = 99991U;
+    const uint8_t window = 31;
+
+    rr_quantile_init(&q, window);
+    for (int i = 0; i < 500; i++) {
+        rng = rng * 1664525U + 1013904223U;
+        history[i] = (uint16_t)(600U + (rng >> 16) % 800U);
+        rr_quantile_push(&q, history[i]);
+
+        int n = (i + 1 < window) ? i + 1 : window;
+        for (int k = 0; k < n; k++) sorted[k] = history[i - n + 1 + k];
+        qsort(sorted, (size_t)n, sizeof(sorted[0]), rq_cmp_u16);
+
+        for (int k = 0; k < n; k++) {
+            ASSERT_EQ(sorted[k], rr_quantile_select(&q, (uint8_t)k));
+        }
+    }
+}
+
+void run_rr_quantile_tests(void) {
+    RUN_TEST(rr_quantile_empty_returns_zero);
+    RUN_TEST(rr_quantile_median_odd_window);
+    RUN_TEST(rr_quantile_evicts_oldest);
+    RUN_TEST(rr_quantile_clamps_to_domain);
+    RUN_TEST(rr_quantile_matches_sorted_window);
+}
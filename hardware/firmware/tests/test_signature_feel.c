@@ -15,19 +15,11 @@
 #include "test_framework.h"
 #include "../src/wellness_feedback/signature_feel.h"
 
-/* External mock state from unit_tests.c */
-extern uint8_t g_mock_vib_intensity;
-extern uint8_t g_mock_thermal_intensity;
-extern bool g_mock_vib_on;
-extern bool g_mock_thermal_on;
-extern void mocks_reset(void);
-
-/* Alias for local usage */
-#define mock_vib_intensity   g_mock_vib_intensity
-#define mock_thermal_intensity g_mock_thermal_intensity
-#define mock_vib_on          g_mock_vib_on
-#define mock_thermal_on      g_mock_thermal_on
-#define reset_mocks()        mocks_reset()
+#include "../src/hal/hal.h"
+
+/* Motor output as recorded by the HAL (real vibration driver underneath) */
+#define mock_vib_intensity   g_hal_host.pwm_duty[HAL_PWM_MOTOR]
+#define reset_mocks()        hal_rec_clear()
 
 /*******************************************************************************
  * EASING CURVE TESTS
@@ -0,0 +1,123 @@
+/**
+ * @file test_stream_ctrl.c
+ * @brief Unit tests for adaptive streaming levels
+ */
+
+#include "test_framework.h"
+#include "../src/bluetooth/stream_ctrl.h"
+
+#define STREAM_TEST_ROOM    8U
+#define STREAM_TEST_BATT    85U
+
+static void stream_test_sends(stream_ctrl_t *p_ctrl, uint16_t ok, uint16_t full)
+{
+    for (uint16_t i = 0; i < ok; i++) stream_ctrl_on_send(p_ctrl, 0);
+    for (uint16_t i = 0; i < full; i++) stream_ctrl_on_send(p_ctrl, -4);
+}
+
+TEST(stream_ctrl_degrades_and_recovers) {
+    stream_ctrl_t c;
+    uint32_t t = 1000;
+
+    stream_ctrl_init(&c, t);
+    ASSERT_EQ(STREAM_LEVEL_FULL, stream_ctrl_level(&c));
+
+    /* Not a link measurement: no subscriber, not connected */
+    stream_ctrl_on_send(&c, -2);
+    stream_ctrl_on_send(&c, -1);
+    ASSERT_FALSE(stream_ctrl_update(&c, t += 10, STREAM_TEST_ROOM, STREAM_TEST_BATT));
+
+    /* Saturated link: one step per burst of drops, down to OFFLINE */
+    stream_test_sends(&c, 1, 3);
+    ASSERT_TRUE(stream_ctrl_update(&c, t += 10, 0, STREAM_TEST_BATT));
+    ASSERT_EQ(STREAM_LEVEL_BATCHED, stream_ctrl_level(&c));
+    ASSERT_FALSE(stream_ctrl_update(&c, t += 10, 0, STREAM_TEST_BATT));
+    stream_test_sends(&c, 0, 3);
+    ASSERT_TRUE(stream_ctrl_update(&c, t += 10, 0, STREAM_TEST_BATT));
+    ASSERT_EQ(STREAM_LEVEL_SUMMARY, stream_ctrl_level(&c));
+    stream_test_sends(&c, 0, 3);
+    ASSERT_TRUE(stream_ctrl_update(&c, t += 10, 0, STREAM_TEST_BATT));
+    ASSERT_EQ(STREAM_LEVEL_OFFLINE, stream_ctrl_level(&c));
+    stream_test_sends(&c, 0, 3);
+    ASSERT_FALSE(stream_ctrl_update(&c, t += 10, 0, STREAM_TEST_BATT));
+
+    /* No room, no probe; room and a drop-free hold step up one level at a time */
+    t += STREAM_UPGRADE_HOLD_MS;
+    ASSERT_FALSE(stream_ctrl_update(&c, t, STREAM_UPGRADE_ROOM - 1U, STREAM_TEST_BATT));
+    ASSERT_TRUE(stream_ctrl_update(&c, t, STREAM_UPGRADE_ROOM, STREAM_TEST_BATT));
+    ASSERT_EQ(STREAM_LEVEL_SUMMARY, stream_ctrl_level(&c));
+    ASSERT_FALSE(stream_ctrl_update(&c, t + STREAM_UPGRADE_HOLD_MS - 10U, STREAM_TEST_ROOM, STREAM_TEST_BATT));
+
+    /* A drop restarts the hold */
+    t += STREAM_UPGRADE_HOLD_MS / 2U;
+    stream_test_sends(&c, 5, 1);
+    ASSERT_FALSE(stream_ctrl_update(&c, t, STREAM_TEST_ROOM, STREAM_TEST_BATT));
+    ASSERT_FALSE(stream_ctrl_update(&c, t + STREAM_UPGRADE_HOLD_MS - 10U, STREAM_TEST_ROOM, STREAM_TEST_BATT));
+    t += STREAM_UPGRADE_HOLD_MS;
+    ASSERT_TRUE(stream_ctrl_update(&c, t, STREAM_TEST_ROOM, STREAM_TEST_BATT));
+    ASSERT_EQ(STREAM_LEVEL_BATCHED, stream_ctrl_level(&c));
+    t += STREAM_UPGRADE_HOLD_MS;
+    ASSERT_TRUE(stream_ctrl_update(&c, t, STREAM_TEST_ROOM, STREAM_TEST_BATT));
+    ASSERT_EQ(STREAM_LEVEL_FULL, stream_ctrl_level(&c));
+    ASSERT_EQ(6U, c.changes);
+}
+
+TEST(stream_ctrl_ignores_stray_drops) {
+    stream_ctrl_t c;
+    uint32_t t = 0;
+
+    stream_ctrl_init(&c, t);
+
+    /* A few drops among many sends is a busy link, not a bad one */
+    stream_test_sends(&c, 40, 3);
+    ASSERT_FALSE(stream_ctrl_update(&c, t += 1000, STREAM_TEST_ROOM, STREAM_TEST_BATT));
+
+    /* The window rolls over, so old sends do not mask a link going bad */
+    for (uint32_t i = 0; i < 200U; i++) {
+        stream_test_sends(&c, 1, 0);
+        ASSERT_FALSE(stream_ctrl_update(&c, t += 250, STREAM_TEST_ROOM, STREAM_TEST_BATT));
+    }
+    t += STREAM_WINDOW_MS;
+    ASSERT_FALSE(stream_ctrl_update(&c, t, STREAM_TEST_ROOM, STREAM_TEST_BATT));
+    stream_test_sends(&c, 4, 3);
+    ASSERT_TRUE(stream_ctrl_update(&c, t += 250, 0, STREAM_TEST_BATT));
+    ASSERT_EQ(STREAM_LEVEL_BATCHED, stream_ctrl_level(&c));
+}
+
+TEST(stream_ctrl_battery_floor) {
+    stream_ctrl_t c;
+    uint32_t t = 0;
+
+    stream_ctrl_init(&c, t);
+    ASSERT_FALSE(stream_ctrl_update(&c, t += 10, STREAM_TEST_ROOM, STREAM_BATTERY_LOW_PCT + 1U));
+    ASSERT_TRUE(stream_ctrl_update(&c, t += 10, STREAM_TEST_ROOM, STREAM_BATTERY_LOW_PCT));
+    ASSERT_EQ(STREAM_LEVEL_SUMMARY, stream_ctrl_level(&c));
+
+    /* Hysteresis: charging a little does not flap back */
+    ASSERT_FALSE(stream_ctrl_update(&c, t += 10, STREAM_TEST_ROOM,
+                                    STREAM_BATTERY_LOW_PCT + STREAM_BATTERY_HYST_PCT));
+    ASSERT_TRUE(stream_ctrl_update(&c, t += 10, STREAM_TEST_ROOM,
+                                   STREAM_BATTERY_LOW_PCT + STREAM_BATTERY_HYST_PCT + 1U));
+    ASSERT_EQ(STREAM_LEVEL_FULL, stream_ctrl_level(&c));
+
+    ASSERT_TRUE(stream_ctrl_update(&c, t += 10, STREAM_TEST_ROOM, STREAM_BATTERY_CRITICAL_PCT));
+    ASSERT_EQ(STREAM_LEVEL_OFFLINE, stream_ctrl_level(&c));
+    ASSERT_FALSE(stream_ctrl_update(&c, t += 10, STREAM_TEST_ROOM,
+                                    STREAM_BATTERY_CRITICAL_PCT + STREAM_BATTERY_HYST_PCT));
+    ASSERT_TRUE(stream_ctrl_update(&c, t += 10, STREAM_TEST_ROOM,
+                                   STREAM_BATTERY_CRITICAL_PCT + STREAM_BATTERY_HYST_PCT + 1U));
+    ASSERT_EQ(STREAM_LEVEL_SUMMARY, stream_ctrl_level(&c));
+
+    /* The link keeps its own level under the floor */
+    stream_test_sends(&c, 0, 3);
+    ASSERT_FALSE(stream_ctrl_update(&c, t += 10, 0, STREAM_BATTERY_LOW_PCT));
+    ASSERT_EQ(STREAM_LEVEL_BATCHED, c.link_level);
+    ASSERT_TRUE(stream_ctrl_update(&c, t += 10, 0, STREAM_TEST_BATT));
+    ASSERT_EQ(STREAM_LEVEL_BATCHED, stream_ctrl_level(&c));
+}
+
+void run_stream_ctrl_tests(void) {
+    RUN_TEST(stream_ctrl_degrades_and_recovers);
+    RUN_TEST(stream_ctrl_ignores_stray_drops);
+    RUN_TEST(stream_ctrl_battery_floor);
+}
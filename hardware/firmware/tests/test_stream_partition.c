@@ -0,0 +1,68 @@
+/**
+ * @file test_stream_partition.c
+ * @brief Unit tests for compute / stream partitioning
+ */
+
+#include "test_framework.h"
+#include "../src/bluetooth/stream_partition.h"
+
+TEST(partition_follows_central_and_link) {
+    stream_partition_t p;
+    partition_inputs_t in = { .rr_subscribers = 1, .stream_level = STREAM_LEVEL_FULL,
+                              .battery_pct = 85, .central_caps = 0 };
+    uint32_t t = 0;
+
+    stream_partition_init(&p);
+    ASSERT_FALSE(stream_partition_update(&p, t, &in));
+    ASSERT_EQ(PARTITION_PHONE, stream_partition_side(&p));
+
+    /* A central that declared nothing keeps raw beats on a poor link and low battery */
+    in.stream_level = STREAM_LEVEL_BATCHED;
+    in.battery_pct = 30;
+    ASSERT_FALSE(stream_partition_update(&p, t += 1000, &in));
+
+    /* One that can live on summaries gets them at once */
+    in.central_caps = NLR_CENTRAL_CAP_SUMMARIES;
+    ASSERT_TRUE(stream_partition_update(&p, t += 1000, &in));
+    ASSERT_EQ(PARTITION_RING, stream_partition_side(&p));
+
+    /* Back to raw beats only after the hold, and battery needs the hysteresis */
+    in.stream_level = STREAM_LEVEL_FULL;
+    in.battery_pct = PARTITION_BATTERY_PCT + PARTITION_BATTERY_HYST_PCT;
+    ASSERT_FALSE(stream_partition_update(&p, t += PARTITION_HOLD_MS, &in));
+    in.battery_pct = 85;
+    ASSERT_FALSE(stream_partition_update(&p, t += 1000, &in));
+    ASSERT_FALSE(stream_partition_update(&p, t + PARTITION_HOLD_MS - 1U, &in));
+
+    /* A blip back to RING conditions restarts the hold */
+    in.stream_level = STREAM_LEVEL_BATCHED;
+    ASSERT_FALSE(stream_partition_update(&p, t += PARTITION_HOLD_MS / 2U, &in));
+    in.stream_level = STREAM_LEVEL_FULL;
+    ASSERT_FALSE(stream_partition_update(&p, t += 1000, &in));
+    ASSERT_FALSE(stream_partition_update(&p, t + PARTITION_HOLD_MS - 1U, &in));
+    ASSERT_TRUE(stream_partition_update(&p, t + PARTITION_HOLD_MS, &in));
+    ASSERT_EQ(PARTITION_PHONE, stream_partition_side(&p));
+    ASSERT_EQ(2U, p.switches);
+}
+
+TEST(partition_ring_without_raw_consumer) {
+    stream_partition_t p;
+    partition_inputs_t in = { .rr_subscribers = 0, .stream_level = STREAM_LEVEL_FULL,
+                              .battery_pct = 85, .central_caps = 0 };
+
+    /* Only coherence subscribers (watch, hub): nobody would read raw beats */
+    stream_partition_init(&p);
+    ASSERT_TRUE(stream_partition_update(&p, 0, &in));
+    ASSERT_EQ(PARTITION_RING, stream_partition_side(&p));
+
+    /* A central that cannot analyse them is the same, whatever the link */
+    in.rr_subscribers = 2;
+    in.central_caps = NLR_CENTRAL_CAP_NO_ANALYTICS;
+    ASSERT_FALSE(stream_partition_update(&p, 2U * PARTITION_HOLD_MS, &in));
+    ASSERT_EQ(PARTITION_RING, stream_partition_side(&p));
+}
+
+void run_stream_partition_tests(void) {
+    RUN_TEST(partition_follows_central_and_link);
+    RUN_TEST(partition_ring_without_raw_consumer);
+}
@@ -0,0 +1,101 @@
+/**
+ * @file test_stress_calibration.c
+ * @brief Unit tests for the per-user RMSSD quantile sketch
+ */
+
+#include "test_framework.h"
+#include "../src/core/stress_calibration.h"
+#include "../src/system/nvm_store.h"
+
+static uint32_t s_sc_rng = 7777U;
+
+static float sc_uniform(void)
+{
+    s_sc_rng = s_sc_rng * 1664525U + 1013904223U;
+    return (float)(s_sc_rng >> 8) / 16777216.0f;
+}
+
+TEST(stress_cal_not_ready_initially) {
+    stress_calibration_t cal;
+    stress_calibration_reset(&cal);
+    ASSERT_FALSE(stress_calibration_ready(&cal));
+    ASSERT_FLOAT_EQ(0.5f, stress_calibration_percentile(&cal, 40.0f), 0.001f);
+}
+
+TEST(stress_cal_tracks_uniform_quantiles) {
+    stress_calibration_t cal;
+    stress_calibration_reset(&cal);
+
+    /* RMSSD uniformly spread over 20..80 ms */
+    for (int i = 0; i < 2000; i++) {
+        stress_calibration_add(&cal, 20.0f + 60.0f * sc_uniform());
+    }
+    ASSERT_TRUE(stress_calibration_ready(&cal));
+    ASSERT_FLOAT_EQ(50.0f, stress_calibration_quantile(&cal, 0.5f), 2.0f);
+    ASSERT_FLOAT_EQ(23.0f, stress_calibration_quantile(&cal, 0.05f), 2.0f);
+    ASSERT_FLOAT_EQ(74.0f, stress_calibration_quantile(&cal, 0.9f), 2.0f);
+    ASSERT_FLOAT_EQ(0.25f, stress_calibration_percentile(&cal, 35.0f), 0.04f);
+}
+
+TEST(stress_cal_percentile_monotonic) {
+    stress_calibration_t cal;
+    stress_calibration_reset(&cal);
+    for (int i = 0; i < 500; i++) {
+        float u = sc_uniform();
+        stress_calibration_add(&cal, 15.0f + 100.0f * u * u);  /* Skewed */
+    }
+    float prev = -1.0f;
+    for (float v = 0.0f; v < 130.0f; v += 2.5f) {
+        float p = stress_calibration_percentile(&cal, v);
+        ASSERT_TRUE(p >= prev);
+        prev = p;
+    }
+}
+
+TEST(stress_cal_table_matches_float_percentile) {
+    stress_calibration_t cal;
+    stress_calibration_table_t table;
+    stress_calibration_reset(&cal);
+
+    stress_calibration_table(&cal, 1000.0f, &table);
+    ASSERT_EQ(32768U, stress_calibration_percentile_q16(&table, 40000U));
+
+    for (int i = 0; i < 500; i++) {
+        stress_calibration_add(&cal, 20.0f + 60.0f * sc_uniform());
+    }
+    stress_calibration_table(&cal, 1000.0f, &table);
+    ASSERT_EQ(cal.count, table.count);
+
+    /* Same curve as the float lookup, ms -> us */
+    for (uint32_t us = 10000U; us <= 90000U; us += 1500U) {
+        float p = stress_calibration_percentile(&cal, (float)us / 1000.0f);
+        float q = (float)stress_calibration_percentile_q16(&table, us) / 65536.0f;
+        ASSERT_FLOAT_EQ(p, q, 0.001f);
+    }
+    ASSERT_EQ(0U, stress_calibration_percentile_q16(&table, 0U));
+    ASSERT_EQ(65536U, stress_calibration_percentile_q16(&table, 1000000U));
+}
+
+TEST(stress_cal_persists_across_reboot) {
+    stress_calibration_t cal, restored;
+    stress_calibration_reset(&cal);
+    for (int i = 0; i < 100; i++) stress_calibration_add(&cal, 30.0f + 20.0f * sc_uniform());
+
+    nvm_store_format();
+    ASSERT_EQ(0, stress_calibration_save(&cal));
+    nvm_store_init();
+
+    stress_calibration_reset(&restored);
+    ASSERT_EQ(0, stress_calibration_load(&restored));
+    ASSERT_EQ(cal.count, restored.count);
+    ASSERT_FLOAT_EQ(stress_calibration_quantile(&cal, 0.5f),
+                    stress_calibration_quantile(&restored, 0.5f), 0.0001f);
+}
+
+void run_stress_calibration_tests(void) {
+    RUN_TEST(stress_cal_not_ready_initially);
+    RUN_TEST(stress_cal_tracks_uniform_quantiles);
+    RUN_TEST(stress_cal_percentile_monotonic);
+    RUN_TEST(stress_cal_table_matches_float_percentile);
+    RUN_TEST(stress_cal_persists_across_reboot);
+}
@@ -0,0 +1,118 @@
+/**
+ * @file test_ts_codec.c
+ * @brief Unit tests for the streaming time-series codec
+ */
+
+#include "test_framework.h"
+#include "../src/core/ts_codec.h"
+
+/** Encode n samples and decode them back; number that matched */
+static uint32_t tsc_round_trip(ts_codec_mode_t mode, const uint32_t *p_ts, const uint32_t *p_val,
+                               uint32_t n, uint8_t *p_buf, uint16_t cap, uint16_t *p_bytes)
+{
+    ts_encoder_t enc;
+    ts_decoder_t dec;
+    uint32_t ts, val, ok = 0;
+
+    ts_encoder_init(&enc, mode, p_buf, cap);
+    for (uint32_t i = 0; i < n; i++) {
+        if (ts_encoder_append(&enc, p_ts[i], p_val[i]) != 0) break;
+    }
+    *p_bytes = ts_encoder_bytes(&enc);
+
+    ts_decoder_init(&dec, mode, p_buf, *p_bytes, enc.count);
+    while (ts_decoder_next(&dec, &ts, &val)) {
+        if (ts == p_ts[ok] && val == p_val[ok]) ok++;
+    }
+    return ok;
+}
+
+TEST(ts_codec_delta_round_trip_rr) {
+    static uint32_t ts[400], val[400];
+    static uint8_t buf[2048];
+    uint32_t t = 123456U, rng = 7U, rr = 850U;
+    uint16_t bytes;
+
+    /* RR stream (successive differences within +-30 ms); timestamps are the beats */
+    for (uint32_t i = 0; i < 400U; i++) {
+        rng = rng * 1664525U + 1013904223U;
+        rr = rr + (rng >> 24) % 61U - 30U;
+        if (rr < 600U || rr > 1100U) rr = 850U;
+        val[i] = rr;
+        t += val[i];
+        ts[i] = t;
+    }
+    ASSERT_EQ(400, tsc_round_trip(TS_CODEC_DELTA, ts, val, 400, buf, sizeof(buf), &bytes));
+    /* 8 raw bytes per sample -> under 2.7 */
+    ASSERT_LT(bytes, 400U * 8U / 3U);
+}
+
+TEST(ts_codec_delta_handles_extremes) {
+    static const uint32_t ts[6] = { 0xFFFFFF00U, 0xFFFFFFFFU, 0x00000010U, 0x00000010U, 0x7FFFFFFFU, 5U };
+    static const uint32_t val[6] = { 0U, 0x80000000U, 0xFFFFFFFFU, 1U, (uint32_t)-2000, 2000U };
+    uint8_t buf[128];
+    uint16_t bytes;
+
+    /* Wrapping and backwards timestamps, full-range value jumps */
+    ASSERT_EQ(6, tsc_round_trip(TS_CODEC_DELTA, ts, val, 6, buf, sizeof(buf), &bytes));
+}
+
+TEST(ts_codec_xor_round_trip_metrics) {
+    static uint32_t ts[300], val[300];
+    static uint8_t buf[2048];
+    uint16_t bytes;
+
+    /* Stress score snapshots every 15 s: slow changes, repeats, a NaN */
+    for (uint32_t i = 0; i < 300U; i++) {
+        float stress = 0.4f + 0.01f * (float)((i / 10U) % 7U);
+        ts[i] = 15000U * i;
+        val[i] = ts_codec_float_bits(stress);
+    }
+    val[150] = 0x7FC00000U;
+    ASSERT_EQ(300, tsc_round_trip(TS_CODEC_XOR, ts, val, 300, buf, sizeof(buf), &bytes));
+    ASSERT_LT(bytes, 300U * 8U / 4U);
+    ASSERT_FLOAT_EQ(0.42f, ts_codec_bits_float(val[25]), 1e-6f);
+}
+
+TEST(ts_codec_full_buffer_keeps_stream) {
+    uint32_t ts[64], val[64];
+    uint8_t buf[24];
+    ts_encoder_t enc;
+    ts_decoder_t dec;
+    uint32_t t, v, n = 0;
+
+    for (uint32_t i = 0; i < 64U; i++) {
+        ts[i] = 1000U * i + (i * 37U) % 300U;
+        val[i] = 2500U + (i * 977U) % 4000U;    /* Temperature, 0.01 C */
+    }
+
+    ts_encoder_init(&enc, TS_CODEC_DELTA, buf, sizeof(buf));
+    while (n < 64U && ts_encoder_append(&enc, ts[n], val[n]) == 0) n++;
+    ASSERT_GT(n, 2);
+    ASSERT_LT(n, 64);
+
+    /* Rejected appends leave the count and stream as they were */
+    uint32_t bits = enc.bits;
+    ASSERT_EQ(-1, ts_encoder_append(&enc, ts[n], val[n]));
+    ASSERT_EQ(bits, enc.bits);
+    ASSERT_EQ(n, enc.count);
+
+    ts_decoder_init(&dec, TS_CODEC_DELTA, buf, ts_encoder_bytes(&enc), enc.count);
+    for (uint32_t i = 0; i < n; i++) {
+        ASSERT_TRUE(ts_decoder_next(&dec, &t, &v));
+        ASSERT_EQ(ts[i], t);
+        ASSERT_EQ(val[i], v);
+    }
+    ASSERT_FALSE(ts_decoder_next(&dec, &t, &v));
+
+    /* Claiming more samples than the stream holds stops at the end */
+    ts_decoder_init(&dec, TS_CODEC_DELTA, buf, 4, 3);
+    ASSERT_FALSE(ts_decoder_next(&dec, &t, &v));
+}
+
+void run_ts_codec_tests(void) {
+    RUN_TEST(ts_codec_delta_round_trip_rr);
+    RUN_TEST(ts_codec_delta_handles_extremes);
+    RUN_TEST(ts_codec_xor_round_trip_metrics);
+    RUN_TEST(ts_codec_full_buffer_keeps_stream);
+}
@@ -5,7 +5,7 @@
  * Compiles and runs all unit tests for the wellness feedback system.
  *
  * Build (host simulation):
- *   gcc -o run_tests unit_tests.c mock_drivers.c -I../src -I../src/wellness_feedback -lm
+ *   gcc -DHOST_TEST -o run_tests unit_tests.c -I../src -I../src/wellness_feedback -lm
  *   ./run_tests
  *
  * Copyright (c) 2024-2026 Neural Load Ring Project
@@ -19,37 +19,87 @@
 /* Test framework */
 #include "test_framework.h"
 
-/* Mock tracking variables - defined here, externed everywhere else */
-uint8_t g_mock_vib_intensity = 0;
-uint8_t g_mock_thermal_intensity = 0;
-bool g_mock_vib_on = false;
-bool g_mock_thermal_on = false;
-
-void mocks_reset(void)
-{
-    g_mock_vib_intensity = 0;
-    g_mock_thermal_intensity = 0;
-    g_mock_vib_on = false;
-    g_mock_thermal_on = false;
-}
-
-/* Source files (compiled together for testing) */
+/* Source files (compiled together for testing, real drivers on the HAL recorder) */
+#include "../src/hal/hal_host.c"
+#include "../src/sensors/temperature_sensor.c"
+#include "../src/wellness_feedback/vibration_feature.c"
+#include "../src/wellness_feedback/thermal_feature.c"
 #include "../src/wellness_feedback/signature_feel.c"
 #include "../src/wellness_feedback/cue_processor.c"
+#include "../src/wellness_feedback/actuator_controller.c"
 #include "../src/wellness_feedback/cue_to_signature.c"
+#include "../src/system/nvm_store.c"
+#include "../src/system/bus_manager.c"
+#include "../src/system/ota_update.c"
+#include "../src/core/rr_quantile.c"
+#include "../src/core/ts_codec.c"
+#include "../src/core/ppg_codec.c"
+#include "../src/core/stress_calibration.c"
 #include "../src/core/biometric_algorithms.c"
+#include "../src/core/peak_detector.c"
+#include "../src/core/detector_pan_tompkins.c"
+#include "../src/core/detector_ssf.c"
+#include "../src/core/detector_elgendi.c"
+#include "../src/core/ppg_fusion.c"
+#include "../src/core/wellness_processor.c"
+#include "../src/core/hrv_nonlinear.c"
+#include "../src/sensors/ppg_driver.c"
+#include "../src/sensors/ppg_capture.c"
+#include "../src/core/wellness_manager.c"
+#include "../src/system/checkpoint.c"
+#include "../src/bluetooth/ble_packets.c"
+#include "../src/bluetooth/ble_l2cap.c"
+#include "../src/bluetooth/ble_bond.c"
+#include "../src/bluetooth/stream_ctrl.c"
+#include "../src/bluetooth/stream_partition.c"
 
 /* Test suites */
 extern void run_signature_feel_tests(void);
 extern void run_cue_processor_tests(void);
 extern void run_cue_to_signature_tests(void);
 extern void run_biometric_tests(void);
+extern void run_peak_detector_tests(void);
+extern void run_hrv_nonlinear_tests(void);
+extern void run_rr_quantile_tests(void);
+extern void run_ts_codec_tests(void);
+extern void run_ppg_codec_tests(void);
+extern void run_nvm_store_tests(void);
+extern void run_stress_calibration_tests(void);
+extern void run_ppg_fusion_tests(void);
+extern void run_ppg_driver_tests(void);
+extern void run_bus_manager_tests(void);
+extern void run_feedback_driver_tests(void);
+extern void run_ble_packet_tests(void);
+extern void run_ble_l2cap_tests(void);
+extern void run_ble_bond_tests(void);
+extern void run_stream_ctrl_tests(void);
+extern void run_stream_partition_tests(void);
+extern void run_ota_update_tests(void);
+extern void run_checkpoint_tests(void);
 
 /* Include test implementations */
 #include "test_signature_feel.c"
 #include "test_cue_processor.c"
 #include "test_cue_to_signature.c"
 #include "test_biometrics.c"
+#include "test_peak_detector.c"
+#include "test_hrv_nonlinear.c"
+#include "test_rr_quantile.c"
+#include "test_ts_codec.c"
+#include "test_ppg_codec.c"
+#include "test_nvm_store.c"
+#include "test_stress_calibration.c"
+#include "test_ppg_fusion.c"
+#include "test_ppg_driver.c"
+#include "test_bus_manager.c"
+#include "test_feedback_drivers.c"
+#include "test_ble_packets.c"
+#include "test_ble_l2cap.c"
+#include "test_ble_bond.c"
+#include "test_stream_ctrl.c"
+#include "test_stream_partition.c"
+#include "test_ota_update.c"
+#include "test_checkpoint.c"
 
 /*******************************************************************************
  * MAIN
@@ -62,15 +112,34 @@ int main(void)
     printf("║     Wellness Feedback System                                 ║\n");
     printf("╚══════════════════════════════════════════════════════════════╝\n");
     
-    /* Reset counters */
+    /* Reset counters and the recorded hardware */
     g_tests_passed = 0;
     g_tests_failed = 0;
+    hal_host_reset();
     
     /* Run all test suites */
     run_signature_feel_tests();
     run_cue_processor_tests();
     run_cue_to_signature_tests();
     run_biometric_tests();
+    run_peak_detector_tests();
+    run_hrv_nonlinear_tests();
+    run_rr_quantile_tests();
+    run_ts_codec_tests();
+    run_ppg_codec_tests();
+    run_nvm_store_tests();
+    run_stress_calibration_tests();
+    run_ppg_fusion_tests();
+    run_ppg_driver_tests();
+    run_bus_manager_tests();
+    run_feedback_driver_tests();
+    run_ble_packet_tests();
+    run_ble_l2cap_tests();
+    run_ble_bond_tests();
+    run_stream_ctrl_tests();
+    run_stream_partition_tests();
+    run_ota_update_tests();
+    run_checkpoint_tests();
     
     /* Print summary */
     test_print_summary();